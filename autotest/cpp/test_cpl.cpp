@@ -47,6 +47,7 @@
 
 #include <fstream>
 #include <string>
+#include <vector>
 
 static bool gbGotError = false;
 static void CPL_STDCALL myErrorHandler(CPLErr, CPLErrorNum, const char*)
@@ -2812,4 +2813,236 @@ namespace tut
             ensure_equals( x.GetString(), std::string("[1, 2]") );
         }
     }
+
+    // Test VSIFReadMultiRangeAsyncL()
+    template<>
+    template<>
+    void object::test<40>()
+    {
+        std::vector<GByte> abyRef(100000);
+        for( size_t i = 0; i < abyRef.size(); i++ )
+            abyRef[i] = static_cast<GByte>((i * 37) % 251);
+
+        const CPLString osTmpFile(
+            CPLGenerateTempFilename("test_async_read"));
+        VSILFILE* fp = VSIFOpenL(osTmpFile, "wb");
+        ensure( fp != nullptr );
+        VSIFWriteL(abyRef.data(), 1, abyRef.size(), fp);
+        VSIFCloseL(fp);
+        fp = VSIFileFromMemBuffer("/vsimem/test_async_read.bin",
+                                  abyRef.data(), abyRef.size(), FALSE);
+        VSIFCloseL(fp);
+
+        const std::vector<CPLString> aosFilenames = {
+            osTmpFile,
+            "/vsimem/test_async_read.bin",
+            "/vsisubfile/1000_50000," + osTmpFile };
+        for( const auto& osFilename: aosFilenames )
+        {
+            const vsi_l_offset nBase =
+                STARTS_WITH(osFilename, "/vsisubfile/") ? 1000 : 0;
+            fp = VSIFOpenL(osFilename, "rb");
+            ensure( fp != nullptr );
+
+            const vsi_l_offset anOffsets[] = { 0, 100, 150, 3000, 7 };
+            const size_t anSizes[] = { 10, 50, 30, 0, 20000 };
+            std::vector<std::vector<GByte>> aabyBuffers(5);
+            void* apData[5];
+            for( int i = 0; i < 5; i++ )
+            {
+                aabyBuffers[i].resize(anSizes[i] + 1);
+                apData[i] = aabyBuffers[i].data();
+            }
+            VSIAsyncRead* psRequest =
+                VSIFReadMultiRangeAsyncL(5, apData, anOffsets, anSizes, fp);
+            ensure( psRequest != nullptr );
+
+            // The handle can be used while the request is in flight
+            GByte abyTmp[4];
+            ensure_equals( VSIFSeekL(fp, 20, SEEK_SET), 0 );
+            ensure_equals( VSIFReadL(abyTmp, 1, 4, fp), 4U );
+            ensure( memcmp(abyTmp, &abyRef[nBase + 20], 4) == 0 );
+
+            ensure_equals( VSIAsyncReadWait(psRequest), 0 );
+            ensure( VSIAsyncReadIsDone(psRequest) != FALSE );
+            VSIAsyncReadFree(psRequest);
+            for( int i = 0; i < 5; i++ )
+            {
+                ensure( memcmp(apData[i], &abyRef[nBase + anOffsets[i]],
+                               anSizes[i]) == 0 );
+            }
+
+            // Range beyond end of file
+            const vsi_l_offset anOffsets2[] = { 0, 60000 };
+            const size_t anSizes2[] = { 10, 100000 };
+            std::vector<GByte> abyLarge(anSizes2[1]);
+            void* apData2[] = { apData[0], abyLarge.data() };
+            psRequest =
+                VSIFReadMultiRangeAsyncL(2, apData2, anOffsets2, anSizes2, fp);
+            ensure( psRequest != nullptr );
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            ensure_equals( VSIAsyncReadWait(psRequest), -1 );
+            CPLPopErrorHandler();
+            VSIAsyncReadFree(psRequest);
+
+            // Freeing a pending request waits for it
+            VSIAsyncReadFree(
+                VSIFReadMultiRangeAsyncL(5, apData, anOffsets, anSizes, fp));
+
+            VSIFCloseL(fp);
+        }
+
+        VSIUnlink(osTmpFile);
+        VSIUnlink("/vsimem/test_async_read.bin");
+    }
+    // Test /vsitrace/
+    template<>
+    template<>
+    void object::test<41>()
+    {
+        std::vector<GByte> abyData(10000);
+        for( size_t i = 0; i < abyData.size(); i++ )
+            abyData[i] = static_cast<GByte>(i);
+        VSILFILE* fp = VSIFileFromMemBuffer("/vsimem/test_vsitrace.bin",
+                                            abyData.data(), abyData.size(),
+                                            FALSE);
+        ensure( fp != nullptr );
+        VSIFCloseL(fp);
+
+        VSITraceResetStatistics();
+        ensure( VSITraceGetStatistics("/vsimem/test_vsitrace.bin") == nullptr );
+
+        VSIStatBufL sStat;
+        ensure_equals( VSIStatL("/vsitrace//vsimem/test_vsitrace.bin",
+                                &sStat), 0 );
+        ensure_equals( sStat.st_size, static_cast<GIntBig>(abyData.size()) );
+
+        fp = VSIFOpenL("/vsitrace//vsimem/test_vsitrace.bin", "rb");
+        ensure( fp != nullptr );
+        GByte abyBuffer[2000];
+        ensure_equals( VSIFReadL(abyBuffer, 1, 100, fp), 100U );
+        // Sequential read: not a seek
+        ensure_equals( VSIFSeekL(fp, 100, SEEK_SET), 0 );
+        ensure_equals( VSIFReadL(abyBuffer, 1, 1000, fp), 1000U );
+        ensure_equals( VSIFSeekL(fp, 5000, SEEK_SET), 0 );
+        ensure_equals( VSIFReadL(abyBuffer, 1, 2000, fp), 2000U );
+        ensure( memcmp(abyBuffer, &abyData[5000], 2000) == 0 );
+        ensure_equals( VSIFSeekL(fp, 0, SEEK_END), 0 );
+        ensure_equals( VSIFTellL(fp), static_cast<vsi_l_offset>(abyData.size()) );
+        void* apData[] = { abyBuffer, abyBuffer + 10 };
+        const vsi_l_offset anOffsets[] = { 10, 9000 };
+        const size_t anSizes[] = { 10, 600 };
+        ensure_equals( VSIFReadMultiRangeL(2, apData, anOffsets, anSizes, fp),
+                       0 );
+        ensure( memcmp(abyBuffer + 10, &abyData[9000], 600) == 0 );
+        VSIFCloseL(fp);
+
+        // Statistics of a handle are available once it is closed.
+        fp = VSIFOpenL("/vsitrace//vsimem/test_vsitrace.bin", "rb");
+        ensure( fp != nullptr );
+        ensure_equals( VSIFReadL(abyBuffer, 1, 10, fp), 10U );
+
+        char* pszStats = VSITraceGetStatistics("/vsimem/test_vsitrace.bin");
+        ensure( pszStats != nullptr );
+        CPLJSONDocument oDoc;
+        ensure( oDoc.LoadMemory(pszStats) );
+        CPLFree(pszStats);
+        CPLJSONObject oRoot = oDoc.GetRoot();
+        ensure_equals( oRoot.GetLong("opens"), 1 );
+        ensure_equals( oRoot.GetLong("stats"), 1 );
+        ensure_equals( oRoot.GetLong("reads"), 3 );
+        ensure_equals( oRoot.GetLong("bytes_read"), 3100 );
+        ensure_equals( oRoot.GetLong("seeks"), 2 );
+        ensure_equals( oRoot.GetLong("read_multi_range/calls"), 1 );
+        ensure_equals( oRoot.GetLong("read_multi_range/ranges"), 2 );
+        ensure_equals( oRoot.GetLong("read_multi_range/bytes"), 610 );
+        ensure_equals( oRoot.GetLong("writes"), 0 );
+        ensure_equals( oRoot.GetLong("request_size_histogram/0-511"), 2 );
+        ensure_equals( oRoot.GetLong("request_size_histogram/512-1023"), 2 );
+        ensure_equals( oRoot.GetLong("request_size_histogram/1024-2047"), 1 );
+
+        VSIFCloseL(fp);
+
+        // Statistics of all files, with the /vsitrace/ prefix removed
+        pszStats = VSITraceGetStatistics(nullptr);
+        ensure( pszStats != nullptr );
+        ensure( oDoc.LoadMemory(pszStats) );
+        CPLFree(pszStats);
+        ensure_equals( oDoc.GetRoot().GetChildren().size(), 1U );
+        pszStats = VSITraceGetStatistics(
+                            "/vsitrace//vsimem/test_vsitrace.bin");
+        ensure( pszStats != nullptr );
+        ensure( oDoc.LoadMemory(pszStats) );
+        CPLFree(pszStats);
+        ensure_equals( oDoc.GetRoot().GetLong("opens"), 2 );
+        ensure_equals( oDoc.GetRoot().GetLong("reads"), 4 );
+
+        // Writing
+        fp = VSIFOpenL("/vsitrace//vsimem/test_vsitrace_write.bin", "wb");
+        ensure( fp != nullptr );
+        ensure_equals( VSIFWriteL(abyData.data(), 1, 1000, fp), 1000U );
+        VSIFCloseL(fp);
+        pszStats = VSITraceGetStatistics("/vsimem/test_vsitrace_write.bin");
+        ensure( pszStats != nullptr );
+        ensure( oDoc.LoadMemory(pszStats) );
+        CPLFree(pszStats);
+        ensure_equals( oDoc.GetRoot().GetLong("writes"), 1 );
+        ensure_equals( oDoc.GetRoot().GetLong("bytes_written"), 1000 );
+
+        VSITraceResetStatistics();
+        ensure( VSITraceGetStatistics("/vsimem/test_vsitrace.bin") == nullptr );
+        VSIUnlink("/vsimem/test_vsitrace.bin");
+        VSIUnlink("/vsimem/test_vsitrace_write.bin");
+    }
+
+    // Test that a mapped region of a /vsimem/ file stays valid when the
+    // file is written through another handle
+    template<>
+    template<>
+    void object::test<42>()
+    {
+        std::vector<GByte> abyData(1000);
+        for( size_t i = 0; i < abyData.size(); i++ )
+            abyData[i] = static_cast<GByte>(i % 251);
+        VSILFILE* fp = VSIFOpenL("/vsimem/test_map_region.bin", "wb+");
+        ensure( fp != nullptr );
+        ensure_equals( VSIFWriteL(abyData.data(), 1, abyData.size(), fp),
+                       abyData.size() );
+
+        VSIMappedRegion* psRegion = VSIFMapRegionL(fp, 0, 0,
+                                            VSI_MAP_REGION_ZERO_COPY_ONLY);
+        ensure( psRegion != nullptr );
+        ensure_equals( VSIMappedRegionGetSize(psRegion), abyData.size() );
+
+        // Growing the file would reallocate the buffer pointed by the region
+        VSILFILE* fp2 = VSIFOpenL("/vsimem/test_map_region.bin", "rb+");
+        ensure( fp2 != nullptr );
+        std::vector<GByte> abyLarge(10 * 1000 * 1000, 1);
+        ensure_equals( VSIFSeekL(fp2, 0, SEEK_END), 0 );
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        ensure_equals( VSIFWriteL(abyLarge.data(), 1, abyLarge.size(), fp2),
+                       0U );
+        ensure( VSIGetMemFileBuffer("/vsimem/test_map_region.bin",
+                                    nullptr, TRUE) == nullptr );
+        CPLPopErrorHandler();
+        ensure( memcmp(VSIMappedRegionGetData(psRegion), abyData.data(),
+                       abyData.size()) == 0 );
+
+        // The region remains valid after the file is unlinked
+        VSIFCloseL(fp2);
+        VSIFCloseL(fp);
+        VSIUnlink("/vsimem/test_map_region.bin");
+        ensure( memcmp(VSIMappedRegionGetData(psRegion), abyData.data(),
+                       abyData.size()) == 0 );
+        VSIMappedRegionFree(psRegion);
+
+        // Once the region is freed, the file can grow again
+        fp = VSIFOpenL("/vsimem/test_map_region.bin", "wb+");
+        ensure( fp != nullptr );
+        ensure_equals( VSIFWriteL(abyLarge.data(), 1, abyLarge.size(), fp),
+                       abyLarge.size() );
+        VSIFCloseL(fp);
+        VSIUnlink("/vsimem/test_map_region.bin");
+    }
+
 } // namespace tut
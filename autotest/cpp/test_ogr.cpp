@@ -25,11 +25,13 @@
 
 #include "gdal_unit_test.h"
 
+#include "cpl_multiproc.h"
 #include "ogr_p.h"
 #include "ogrsf_frmts.h"
 #include "../../gdal/ogr/ogrsf_frmts/osm/gpb.h"
 
 #include <string>
+#include <vector>
 
 namespace tut
 {
@@ -1542,4 +1544,154 @@ namespace tut
         }
     }
 
+    // Test that a feature with a lazy geometry can be read concurrently
+    // through its const accessors, which instantiate it only once.
+    struct LazyGeomReaderData
+    {
+        const OGRFeature* poFeature;
+        const OGRGeometry* poGeom;
+        bool bOK;
+    };
+
+    static void LazyGeomReader(void* pData)
+    {
+        LazyGeomReaderData* psData = static_cast<LazyGeomReaderData*>(pData);
+        const OGRFeature* poFeature = psData->poFeature;
+        const int iWKTField = poFeature->GetFieldCount() + SPF_OGR_GEOM_WKT;
+        for( int i = 0; i < 100; i++ )
+        {
+            OGREnvelope sEnvelope;
+            const OGRGeometry* poGeom = poFeature->GetGeomFieldRef(0);
+            if( poGeom == nullptr ||
+                (psData->poGeom != nullptr && poGeom != psData->poGeom) ||
+                poFeature->GetGeomFieldEnvelope(0, &sEnvelope) != OGRERR_NONE ||
+                sEnvelope.MinX != 1 || sEnvelope.MaxY != 4 ||
+                !poFeature->IsFieldSet(iWKTField) )
+            {
+                psData->bOK = false;
+            }
+            psData->poGeom = poGeom;
+        }
+    }
+
+    template<>
+    template<>
+    void object::test<17>()
+    {
+        OGRFeatureDefn* poFeatureDefn = new OGRFeatureDefn();
+        poFeatureDefn->Reference();
+        {
+            OGRFeature oFeature(poFeatureDefn);
+            const OGRFeature& oConstFeature = oFeature;
+            OGRLineString oLS;
+            oLS.addPoint(1, 2);
+            oLS.addPoint(3, 4);
+            std::vector<GByte> abyWKB(oLS.WkbSize());
+            oLS.exportToWkb(wkbNDR, &abyWKB[0]);
+
+            for( int iRound = 0; iRound < 50; iRound++ )
+            {
+                ensure_equals(oFeature.SetGeomFieldLazyWKB(0, &abyWKB[0],
+                                                          abyWKB.size()),
+                              OGRERR_NONE);
+                ensure(oFeature.GetGeomFieldLazyWKB(0, nullptr) != nullptr);
+
+                LazyGeomReaderData asData[2];
+                CPLJoinableThread* ahThreads[2];
+                for( int i = 0; i < 2; i++ )
+                {
+                    asData[i].poFeature = &oFeature;
+                    asData[i].poGeom = nullptr;
+                    asData[i].bOK = true;
+                    ahThreads[i] =
+                        CPLCreateJoinableThread(LazyGeomReader, &asData[i]);
+                }
+                for( int i = 0; i < 2; i++ )
+                {
+                    CPLJoinThread(ahThreads[i]);
+                    ensure(asData[i].bOK);
+                }
+                ensure(asData[0].poGeom == asData[1].poGeom);
+                ensure(oConstFeature.GetGeomFieldRef(0) == asData[0].poGeom);
+                ensure(oFeature.GetGeomFieldLazyWKB(0, nullptr) == nullptr);
+            }
+
+            ensure_equals(std::string(oConstFeature.GetFieldAsString(
+                              oFeature.GetFieldCount() + SPF_OGR_GEOM_WKT)),
+                          std::string("LINESTRING (1 2,3 4)"));
+            ensure(oFeature.GetGeometryRef() != nullptr);
+        }
+        poFeatureDefn->Release();
+    }
+
+    // Test that OGRFeatureQuery::EvaluateBatch() gives the same results as
+    // Evaluate() called on each feature
+    template<>
+    template<>
+    void object::test<18>()
+    {
+        OGRFeatureDefn* poFeatureDefn = new OGRFeatureDefn();
+        poFeatureDefn->Reference();
+        {
+            OGRFieldDefn oFieldInt("int_field", OFTInteger);
+            poFeatureDefn->AddFieldDefn(&oFieldInt);
+            OGRFieldDefn oFieldReal("real_field", OFTReal);
+            poFeatureDefn->AddFieldDefn(&oFieldReal);
+            OGRFieldDefn oFieldStr("str_field", OFTString);
+            poFeatureDefn->AddFieldDefn(&oFieldStr);
+
+            const char* const apszStrings[] = { "foo", "bar", nullptr, "baz" };
+            std::vector<OGRFeature*> apoFeatures;
+            for( int i = 0; i < 300; i++ )
+            {
+                OGRFeature* poFeature = new OGRFeature(poFeatureDefn);
+                poFeature->SetFID(i);
+                if( i % 7 == 6 )
+                    poFeature->SetFieldNull(0);
+                else
+                    poFeature->SetField(0, i % 10);
+                poFeature->SetField(1, i * 0.5);
+                if( apszStrings[i % 4] != nullptr )
+                    poFeature->SetField(2, apszStrings[i % 4]);
+                apoFeatures.push_back(poFeature);
+            }
+
+            // Compiled and generic expressions
+            const char* const apszWhere[] = {
+                "int_field = 3",
+                "int_field BETWEEN 2 AND 5 OR str_field IS NULL",
+                "int_field IN (1, 3, 5) AND NOT str_field = 'bar'",
+                "real_field > 100.25",
+                "FID IN (0, 299)",
+                "int_field * 2 = 6",
+                "str_field LIKE 'b%'" };
+            for( const char* pszWhere : apszWhere )
+            {
+                OGRFeatureQuery oQuery;
+                ensure_equals(oQuery.Compile(poFeatureDefn, pszWhere),
+                              OGRERR_NONE);
+
+                std::vector<int> abResults(apoFeatures.size());
+                const int nMatches = oQuery.EvaluateBatch(
+                    &apoFeatures[0], static_cast<int>(apoFeatures.size()),
+                    &abResults[0]);
+
+                int nExpectedMatches = 0;
+                for( size_t i = 0; i < apoFeatures.size(); i++ )
+                {
+                    const int bExpected = oQuery.Evaluate(apoFeatures[i]);
+                    ensure_equals(pszWhere, abResults[i], bExpected);
+                    if( bExpected )
+                        nExpectedMatches++;
+                }
+                ensure_equals(pszWhere, nMatches, nExpectedMatches);
+                ensure(pszWhere, nMatches > 0);
+            }
+
+            for( auto poFeature : apoFeatures )
+                delete poFeature;
+        }
+        poFeatureDefn->Release();
+    }
+
 } // namespace tut
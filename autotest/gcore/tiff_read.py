@@ -3434,3 +3434,30 @@ def test_tiff_read_bigtiff_invalid_slong8_for_stripoffsets():
         ds = gdal.Open('data/byte_bigtiff_invalid_slong8_for_stripoffsets.tif')
     cs = ds.GetRasterBand(1).Checksum()
     assert cs == 4672
+
+
+###############################################################################
+# Test that reading uncompressed pixel-interleaved data through a zero-copy
+# view of the file gives the same results as the regular read path
+
+
+def test_tiff_read_zero_copy():
+
+    src_ds = gdal.Open('data/rgbsmall.tif')
+    for filename in ('tmp/tiff_read_zero_copy.tif', '/vsimem/tiff_read_zero_copy.tif'):
+        for options in (['INTERLEAVE=PIXEL'],
+                        ['INTERLEAVE=PIXEL', 'TILED=YES', 'BLOCKXSIZE=16', 'BLOCKYSIZE=16'],
+                        ['INTERLEAVE=PIXEL', 'BLOCKYSIZE=7'],
+                        ['INTERLEAVE=PIXEL', 'ENDIANNESS=INVERTED']):
+            for dt in (gdal.GDT_Byte, gdal.GDT_Int16):
+                gdal.Translate(filename, src_ds, outputType=dt,
+                               creationOptions=options)
+                res = {}
+                for mmap in ('YES', 'NO'):
+                    with gdaltest.config_option('CPL_VSIL_MMAP_READ', mmap):
+                        ds = gdal.Open(filename)
+                        res[mmap] = [ds.GetRasterBand(i + 1).Checksum() for i in range(3)]
+                        ds = None
+                assert res['YES'] == res['NO'], (filename, options, dt)
+                assert res['YES'] == [src_ds.GetRasterBand(i + 1).Checksum() for i in range(3)], (filename, options, dt)
+                gdal.GetDriverByName('GTiff').Delete(filename)
@@ -465,6 +465,107 @@ def test_vsicurl_no_size_in_HEAD():
 ###############################################################################
 
 
+def test_vsicurl_test_disk_cache():
+
+    if gdaltest.webserver_port == 0:
+        pytest.skip()
+
+    cache_dir = 'tmp/vsicurl_disk_cache'
+    gdal.RmdirRecursive(cache_dir)
+    filename = '/vsicurl/http://localhost:%d/test_disk_cache/test.bin' % gdaltest.webserver_port
+
+    def read(etag, expect_get):
+        gdal.VSICurlClearCache()
+        handler = webserver.SequentialHandler()
+        handler.add('GET', '/test_disk_cache/', 404)
+        handler.add('HEAD', '/test_disk_cache/test.bin', 200,
+                    {'Content-Length': '3', 'ETag': '"%s"' % etag})
+        if expect_get:
+            handler.add('GET', '/test_disk_cache/test.bin', 200,
+                        {'ETag': '"%s"' % etag}, etag[0:3])
+        with webserver.install_http_handler(handler):
+            with gdaltest.config_option('CPL_VSIL_CURL_DISK_CACHE_DIR', cache_dir):
+                f = gdal.VSIFOpenL(filename, 'rb')
+                assert f is not None
+                data = gdal.VSIFReadL(1, 3, f).decode('ascii')
+                gdal.VSIFCloseL(f)
+        return data
+
+    # Downloaded and put in the disk cache
+    assert read('foo1', True) == 'foo'
+    # Read from the disk cache, although the in-memory cache has been cleared
+    assert read('foo1', False) == 'foo'
+    # The remote file has changed
+    assert read('bar1', True) == 'bar'
+    assert read('bar1', False) == 'bar'
+
+    gdal.VSICurlClearCache()
+    gdal.RmdirRecursive(cache_dir)
+
+###############################################################################
+# Test that sequential reading ends up issuing parallel range requests
+
+
+def test_vsicurl_test_parallel_read_ahead():
+
+    if gdaltest.webserver_port == 0:
+        pytest.skip()
+
+    gdal.VSICurlClearCache()
+
+    chunk_size = 16384
+    # Offset at which the sequential download window reaches 128 chunks
+    sequential_end = chunk_size * (1 + 2 + 4 + 8 + 16 + 32 + 64)
+    window_size = 128 * chunk_size
+    filedata = bytes(bytearray([i % 251 for i in range(sequential_end + 3 * window_size)]))
+
+    class RangeHandler(webserver.FileHandler):
+        def __init__(self):
+            webserver.FileHandler.__init__(self, {'/test_read_ahead/test.bin': filedata})
+            self.ranges = []
+
+        def do_GET(self, request):
+            if 'Range' not in request.headers:
+                request.send_response(404)
+                request.send_header('Content-Length', 0)
+                request.end_headers()
+                return
+            import re
+            res = re.search(r'bytes=(\d+)\-(\d+)', request.headers['Range'])
+            start = int(res.group(1))
+            end = min(int(res.group(2)) + 1, len(filedata))
+            self.ranges.append((start, end))
+            request.send_response(206)
+            request.send_header('Content-Range', 'bytes %d-%d/%d' % (start, end - 1, len(filedata)))
+            request.send_header('Content-Length', end - start)
+            request.end_headers()
+            request.wfile.write(filedata[start:end])
+
+    handler = RangeHandler()
+    with webserver.install_http_handler(handler):
+        with gdaltest.config_option('CPL_VSIL_CURL_READ_AHEAD_REQUESTS', '3'):
+            f = gdal.VSIFOpenL('/vsicurl/http://127.0.0.1:%d/test_read_ahead/test.bin' % gdaltest.webserver_port, 'rb')
+            assert f is not None
+            data = b''
+            while True:
+                buf = gdal.VSIFReadL(1, 4000, f)
+                if not buf:
+                    break
+                data += buf
+            gdal.VSIFCloseL(f)
+
+    assert data == filedata
+    for i in range(3):
+        start = sequential_end + i * window_size
+        assert (start, start + window_size) in handler.ranges
+    # The whole file is downloaded only once
+    assert sum(end - start for (start, end) in handler.ranges) == len(filedata)
+
+    gdal.VSICurlClearCache()
+
+###############################################################################
+
+
 def test_vsicurl_stop_webserver():
 
     if gdaltest.webserver_port == 0:
@@ -29,6 +29,7 @@
 # DEALINGS IN THE SOFTWARE.
 ###############################################################################
 
+import struct
 import sys
 import time
 from osgeo import gdal
@@ -714,6 +715,195 @@ def test_vsigzip_multi_thread():
         pytest.fail()
 
     
+###############################################################################
+# Returns data compressed as BGZF (the format of the bgzip utility), that is
+# a concatenation of gzip members with the BC extra field.
+
+
+def bgzf_compress(data, chunk_size=60000):
+
+    import zlib
+
+    bgzf_data = b''
+    for i in range(0, len(data), chunk_size):
+        chunk = data[i:i + chunk_size]
+        c = zlib.compressobj(6, zlib.DEFLATED, -15)
+        deflated = c.compress(chunk) + c.flush()
+        bgzf_data += struct.pack('<BBBBIBBHBBHH', 0x1f, 0x8b, 8, 4, 0, 0, 255, 6, ord('B'), ord('C'), 2, len(deflated) + 25)
+        bgzf_data += deflated + struct.pack('<II', zlib.crc32(chunk) & 0xffffffff, len(chunk))
+    return bgzf_data
+
+###############################################################################
+# Test multithreaded decompression
+
+
+def test_vsigzip_multi_thread_read():
+
+    import gzip
+
+    data = ''.join('%d,%d\n' % (i, (i * 7919) % 10007) for i in range(200000)).encode('ascii')
+
+    with gdaltest.config_options({'GDAL_NUM_THREADS': '4',
+                                  'CPL_VSIL_DEFLATE_CHUNK_SIZE': '32K'}):
+        f = gdal.VSIFOpenL('/vsigzip//vsimem/vsigzip_multi_thread_read.gz', 'wb')
+        gdal.VSIFWriteL(data, 1, len(data), f)
+        gdal.VSIFCloseL(f)
+
+    gdal.FileFromMemBuffer('/vsimem/vsigzip_multi_thread_read_bgzf.gz', bgzf_compress(data))
+
+    for filename in ('/vsimem/vsigzip_multi_thread_read.gz',
+                     '/vsimem/vsigzip_multi_thread_read_bgzf.gz'):
+        with gdaltest.config_option('GDAL_NUM_THREADS', '4'):
+            f = gdal.VSIFOpenL('/vsigzip/' + filename, 'rb')
+            got = b''
+            while True:
+                chunk = gdal.VSIFReadL(1, 100000, f)
+                got += chunk
+                if len(chunk) < 100000:
+                    break
+            assert got == data
+            for offset in (len(data) // 2, 10, len(data) - 10, len(data) // 3):
+                assert gdal.VSIFSeekL(f, offset, 0) == 0
+                assert gdal.VSIFReadL(1, 10, f) == data[offset:offset + 10]
+            assert gdal.VSIFSeekL(f, 0, 2) == 0
+            assert gdal.VSIFTellL(f) == len(data)
+            gdal.VSIFCloseL(f)
+
+        # Truncated file: same result as serial decompression
+        gdal.FileFromMemBuffer('/vsimem/truncated.gz', gdal.VSIGetMemFileBuffer_unsafe(filename)[0:100000])
+        with gdaltest.error_handler():
+            with gdaltest.config_option('GDAL_NUM_THREADS', '4'):
+                f = gdal.VSIFOpenL('/vsigzip//vsimem/truncated.gz', 'rb')
+                got = gdal.VSIFReadL(1, len(data), f)
+                gdal.VSIFCloseL(f)
+        assert len(got) < len(data)
+        assert got == data[0:len(got)]
+        gdal.Unlink('/vsimem/truncated.gz')
+
+        # Seeks through the seek index
+        gdal.FileFromMemBuffer('/vsimem/other.gz', gzip.compress(b'x'))
+        f = gdal.VSIFOpenL('/vsigzip//vsimem/other.gz', 'rb')
+        gdal.VSIFCloseL(f)
+        gdal.Unlink(filename + '.properties')
+        with gdaltest.config_options({'CPL_VSIL_GZIP_WRITE_SEEK_INDEX': 'YES',
+                                      'CPL_VSIL_GZIP_SEEK_INDEX_SPACING': '1'}):
+            assert gdal.VSIStatL('/vsigzip/' + filename).size == len(data)
+        assert gdal.VSIStatL(filename + '.idx') is not None
+        with gdaltest.config_option('GDAL_NUM_THREADS', '4'):
+            f = gdal.VSIFOpenL('/vsigzip/' + filename, 'rb')
+            assert gdal.VSIFReadL(1, 10, f) == data[0:10]
+            for offset in (len(data) - 1000000, 10, len(data) // 2):
+                assert gdal.VSIFSeekL(f, offset, 0) == 0
+                assert gdal.VSIFReadL(1, 1000000, f) == data[offset:offset + 1000000]
+            gdal.VSIFCloseL(f)
+
+        gdal.Unlink(filename)
+        gdal.Unlink(filename + '.idx')
+        gdal.Unlink(filename + '.properties')
+        gdal.Unlink('/vsimem/other.gz')
+
+###############################################################################
+# Test the persistent seek index of /vsigzip/
+
+
+def test_vsigzip_seek_index():
+
+    import gzip
+
+    data = ''.join('%d,%d\n' % (i, (i * 7919) % 10007) for i in range(300000)).encode('ascii')
+    half = len(data) // 2
+    # Concatenation of a plain gzip member and of BGZF members
+    gz_data = gzip.compress(data[0:half])
+    bgzf_data = bgzf_compress(data[half:])
+
+    for filename, content in [('/vsimem/seek_index.gz', gz_data + bgzf_data),
+                              ('/vsimem/seek_index_bgzf.gz', bgzf_data)]:
+        expected = data if content != bgzf_data else data[half:]
+        gdal.FileFromMemBuffer(filename, content)
+
+        with gdaltest.config_options({'CPL_VSIL_GZIP_WRITE_SEEK_INDEX': 'YES',
+                                      'CPL_VSIL_GZIP_SEEK_INDEX_SPACING': '1'}):
+            assert gdal.VSIStatL('/vsigzip/' + filename).size == len(expected)
+        assert gdal.VSIStatL(filename + '.idx') is not None
+
+        # Force the index to be read from the side-car file
+        gdal.FileFromMemBuffer('/vsimem/other.gz', gzip.compress(b'x'))
+        f = gdal.VSIFOpenL('/vsigzip//vsimem/other.gz', 'rb')
+        gdal.VSIFCloseL(f)
+
+        f = gdal.VSIFOpenL('/vsigzip/' + filename, 'rb')
+        for offset in (len(expected) - 10, 10, len(expected) // 2, len(expected) - 1500000):
+            assert gdal.VSIFSeekL(f, offset, 0) == 0
+            assert gdal.VSIFReadL(1, 10, f) == expected[offset:offset + 10]
+        # Read until the end, which checks the CRC of the last member
+        gdal.ErrorReset()
+        assert gdal.VSIFSeekL(f, len(expected) - 1500000, 0) == 0
+        assert gdal.VSIFReadL(1, 1500001, f) == expected[len(expected) - 1500000:]
+        assert gdal.GetLastErrorMsg() == ''
+        gdal.VSIFCloseL(f)
+
+        gdal.Unlink(filename)
+        gdal.Unlink(filename + '.idx')
+        gdal.Unlink(filename + '.properties')
+        gdal.Unlink('/vsimem/other.gz')
+
+###############################################################################
+# Test that an outdated or corrupted seek index of /vsigzip/ is not trusted
+
+
+def test_vsigzip_seek_index_invalid():
+
+    import gzip
+
+    data = ''.join('%d\n' % i for i in range(500000)).encode('ascii')
+    # Stored deflate blocks, so that a content of the same size has a
+    # compressed stream of the same size.
+    content = gzip.compress(data, compresslevel=0)
+    filename = '/vsimem/seek_index_invalid.gz'
+    gdal.FileFromMemBuffer(filename, content)
+
+    def reopen_and_stat():
+        # Evict the cached handle
+        gdal.FileFromMemBuffer('/vsimem/other.gz', gzip.compress(b'x'))
+        f = gdal.VSIFOpenL('/vsigzip//vsimem/other.gz', 'rb')
+        gdal.VSIFCloseL(f)
+        gdal.Unlink(filename + '.properties')
+        with gdaltest.config_options({'CPL_VSIL_GZIP_WRITE_SEEK_INDEX': 'YES',
+                                      'CPL_VSIL_GZIP_SEEK_INDEX_SPACING': '1'}):
+            assert gdal.VSIStatL('/vsigzip/' + filename).size == len(data)
+
+    reopen_and_stat()
+    idx = gdal.VSIGetMemFileBuffer_unsafe(filename + '.idx')
+    assert idx[0:8] == b'GDALGZI2'
+    assert idx[32:40] == content[-8:]
+
+    # Same size, but different content: the index must be rebuilt
+    data = data[0:-2] + b'X\n'
+    content = gzip.compress(data, compresslevel=0)
+    gdal.FileFromMemBuffer(filename, content)
+    reopen_and_stat()
+    idx = gdal.VSIGetMemFileBuffer_unsafe(filename + '.idx')
+    assert idx[32:40] == content[-8:]
+
+    # Corrupt the compressed window of the first seek point: seeking must
+    # fall back to decompressing from the start of the stream.
+    idx = bytearray(idx)
+    idx[44 + 21 + 10] ^= 0xFF
+    gdal.FileFromMemBuffer(filename + '.idx', bytes(idx))
+    gdal.FileFromMemBuffer('/vsimem/other.gz', gzip.compress(b'x'))
+    f = gdal.VSIFOpenL('/vsigzip//vsimem/other.gz', 'rb')
+    gdal.VSIFCloseL(f)
+    f = gdal.VSIFOpenL('/vsigzip/' + filename, 'rb')
+    for offset in (len(data) - 10, 10, len(data) // 2):
+        assert gdal.VSIFSeekL(f, offset, 0) == 0
+        assert gdal.VSIFReadL(1, 10, f) == data[offset:offset + 10]
+    gdal.VSIFCloseL(f)
+
+    gdal.Unlink(filename)
+    gdal.Unlink(filename + '.idx')
+    gdal.Unlink(filename + '.properties')
+    gdal.Unlink('/vsimem/other.gz')
+
 ###############################################################################
 # Test vsisync()
 
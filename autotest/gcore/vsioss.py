@@ -876,6 +876,42 @@ def test_visoss_6():
             assert gdal.GetLastErrorMsg() != '', filename
 
     
+###############################################################################
+# Test that VSIS3_CHUNK_SIZE_BYTES is used when VSIOSS_CHUNK_SIZE_BYTES is
+# not set
+
+
+def test_visoss_chunk_size_fallback():
+
+    if gdaltest.webserver_port == 0:
+        pytest.skip()
+
+    with gdaltest.config_option('VSIS3_CHUNK_SIZE_BYTES', '10'):
+        with webserver.install_http_handler(webserver.SequentialHandler()):
+            f = gdal.VSIFOpenL('/vsioss/oss_fake_bucket4/chunk_size_fallback.bin', 'wb')
+    assert f is not None
+
+    handler = webserver.SequentialHandler()
+    response = '<?xml version="1.0" encoding="UTF-8"?><InitiateMultipartUploadResult><UploadId>my_id</UploadId></InitiateMultipartUploadResult>'
+    handler.add('POST', '/oss_fake_bucket4/chunk_size_fallback.bin?uploads', 200,
+                {'Content-type': 'application/xml',
+                 'Content-Length': len(response)},
+                response)
+    handler.add('PUT', '/oss_fake_bucket4/chunk_size_fallback.bin?partNumber=1&uploadId=my_id',
+                200, {'ETag': '"first_etag"'},
+                expected_body=b'a' * 10)
+    handler.add('PUT', '/oss_fake_bucket4/chunk_size_fallback.bin?partNumber=2&uploadId=my_id',
+                200, {'ETag': '"second_etag"'},
+                expected_body=b'a' * 5)
+    handler.add('POST', '/oss_fake_bucket4/chunk_size_fallback.bin?uploadId=my_id', 200)
+
+    gdal.ErrorReset()
+    with webserver.install_http_handler(handler):
+        assert gdal.VSIFWriteL('a' * 15, 1, 15, f) == 15
+        assert gdal.VSIFCloseL(f) == 0
+    assert gdal.GetLastErrorMsg() == ''
+
+
 ###############################################################################
 # Test Mkdir() / Rmdir()
 
@@ -1870,6 +1870,85 @@ def test_vsis3_write_multipart_retry():
                 gdal.VSIFCloseL(f)
 
 
+###############################################################################
+# Test multipart upload with parts uploaded by worker threads
+
+
+def test_vsis3_write_multipart_multithreaded():
+
+    if gdaltest.webserver_port == 0:
+        pytest.skip()
+
+    nparts = 5
+    part_size = 10
+    with gdaltest.config_options({'VSIS3_CHUNK_SIZE_BYTES': str(part_size),
+                                  'VSIS3_UPLOAD_NUM_THREADS': '3'}):
+        with webserver.install_http_handler(webserver.SequentialHandler()):
+            f = gdal.VSIFOpenL('/vsis3/s3_fake_bucket4/large_file_mt.bin', 'wb')
+    assert f is not None
+
+    handler = webserver.SequentialHandler()
+    response = '<?xml version="1.0" encoding="UTF-8"?><InitiateMultipartUploadResult><UploadId>my_id</UploadId></InitiateMultipartUploadResult>'
+    handler.add('POST', '/s3_fake_bucket4/large_file_mt.bin?uploads', 200,
+                {'Content-type': 'application/xml',
+                 'Content-Length': len(response)},
+                response)
+    expected_complete = '<CompleteMultipartUpload>\n'
+    for i in range(nparts):
+        handler.add_unordered('PUT', '/s3_fake_bucket4/large_file_mt.bin?partNumber=%d&uploadId=my_id' % (i + 1),
+                              200, {'ETag': '"etag%d"' % (i + 1)},
+                              expected_body=(chr(ord('a') + i) * part_size).encode('ascii'))
+        expected_complete += '<Part>\n<PartNumber>%d</PartNumber><ETag>"etag%d"</ETag></Part>\n' % (i + 1, i + 1)
+    expected_complete += '</CompleteMultipartUpload>\n'
+    handler.add_unordered('POST', '/s3_fake_bucket4/large_file_mt.bin?uploadId=my_id', 200,
+                          expected_body=expected_complete.encode('ascii'))
+
+    gdal.ErrorReset()
+    with webserver.install_http_handler(handler):
+        for i in range(nparts):
+            assert gdal.VSIFWriteL(chr(ord('a') + i) * part_size, 1, part_size, f) == part_size
+        assert gdal.VSIFCloseL(f) == 0
+    assert gdal.GetLastErrorMsg() == ''
+
+    # The error of a part uploaded by a worker thread must be reported to the
+    # caller of Close()
+    with gdaltest.config_options({'VSIS3_CHUNK_SIZE_BYTES': str(part_size),
+                                  'VSIS3_UPLOAD_NUM_THREADS': '3'}):
+        with webserver.install_http_handler(webserver.SequentialHandler()):
+            f = gdal.VSIFOpenL('/vsis3/s3_fake_bucket4/large_file_mt.bin', 'wb')
+    assert f is not None
+
+    handler = webserver.SequentialHandler()
+    handler.add('POST', '/s3_fake_bucket4/large_file_mt.bin?uploads', 200,
+                {'Content-type': 'application/xml',
+                 'Content-Length': len(response)},
+                response)
+    handler.add('PUT', '/s3_fake_bucket4/large_file_mt.bin?partNumber=1&uploadId=my_id', 400)
+    handler.add('DELETE', '/s3_fake_bucket4/large_file_mt.bin?uploadId=my_id', 204)
+
+    gdal.ErrorReset()
+    with webserver.install_http_handler(handler):
+        assert gdal.VSIFWriteL('a' * part_size, 1, part_size, f) == part_size
+        with gdaltest.error_handler():
+            assert gdal.VSIFCloseL(f) != 0
+    assert 'UploadPart(1) of /vsis3/s3_fake_bucket4/large_file_mt.bin failed' in gdal.GetLastErrorMsg()
+
+    # The upload options of other S3-like file systems are ignored, and the
+    # chunk size of this one takes precedence over theirs
+    with gdaltest.config_options({'VSIS3_CHUNK_SIZE_BYTES': str(part_size * 4),
+                                  'VSIOSS_CHUNK_SIZE_BYTES': str(part_size),
+                                  'VSIOSS_UPLOAD_NUM_THREADS': '3'}):
+        with webserver.install_http_handler(webserver.SequentialHandler()):
+            f = gdal.VSIFOpenL('/vsis3/s3_fake_bucket4/large_file_mt.bin', 'wb')
+    assert f is not None
+    handler = webserver.SequentialHandler()
+    handler.add('PUT', '/s3_fake_bucket4/large_file_mt.bin', 200,
+                expected_body=('a' * part_size * 2).encode('ascii'))
+    with webserver.install_http_handler(handler):
+        assert gdal.VSIFWriteL('a' * part_size * 2, 1, part_size * 2, f) == part_size * 2
+        assert gdal.VSIFCloseL(f) == 0
+
+
 ###############################################################################
 # Test Mkdir() / Rmdir()
 
@@ -2186,6 +2265,56 @@ def test_vsis3_sync_etag():
         assert gdal.Sync('/vsimem/subdir/', '/vsis3/out', options=options)
     gdal.RmdirRecursive('/vsimem/subdir')
 
+###############################################################################
+# Test vsisync() of a directory with SYNC_STRATEGY=ETAG and NUM_THREADS
+
+
+def test_vsis3_sync_etag_multithreaded():
+
+    if gdaltest.webserver_port == 0:
+        pytest.skip()
+
+    gdal.VSICurlClearCache()
+
+    gdal.Mkdir('/vsimem/subdir', 0)
+    gdal.Mkdir('/vsimem/subdir/d', 0)
+    gdal.FileFromMemBuffer('/vsimem/subdir/a.txt', 'foo')
+    gdal.FileFromMemBuffer('/vsimem/subdir/b.txt', 'bar')
+    gdal.FileFromMemBuffer('/vsimem/subdir/c.txt', 'baz')
+    gdal.FileFromMemBuffer('/vsimem/subdir/d/e.txt', 'qux')
+
+    handler = webserver.SequentialHandler()
+    handler.add('GET', '/out/', 200, {},
+                """<?xml version="1.0" encoding="UTF-8"?>
+                    <ListBucketResult>
+                        <Prefix/>
+                        <Marker/>
+                        <IsTruncated>false</IsTruncated>
+                        <Contents>
+                            <Key>a.txt</Key>
+                            <LastModified>1970-01-01T00:00:01.000Z</LastModified>
+                            <Size>3</Size>
+                            <ETag>"acbd18db4cc2f85cedef654fccc4a4d8"</ETag>
+                        </Contents>
+                        <Contents>
+                            <Key>b.txt</Key>
+                            <LastModified>1970-01-01T00:00:01.000Z</LastModified>
+                            <Size>3</Size>
+                            <ETag>"acbd18db4cc2f85cedef654fccc4a4d8"</ETag>
+                        </Contents>
+                    </ListBucketResult>
+                """)
+    # a.txt has the same MD5 as the remote file: not uploaded
+    handler.add_unordered('PUT', '/out/d/', 200)
+    handler.add_unordered('PUT', '/out/b.txt', 200, expected_body=b'bar')
+    handler.add_unordered('PUT', '/out/c.txt', 200, expected_body=b'baz')
+    handler.add_unordered('PUT', '/out/d/e.txt', 200, expected_body=b'qux')
+    with webserver.install_http_handler(handler):
+        assert gdal.Sync('/vsimem/subdir/', '/vsis3/out',
+                         options=['SYNC_STRATEGY=ETAG', 'NUM_THREADS=4'])
+
+    gdal.RmdirRecursive('/vsimem/subdir')
+
 ###############################################################################
 # Test vsisync() with SYNC_STRATEGY=TIMESTAMP
 
@@ -660,3 +660,62 @@ def test_vsizip_byte_zip64_local_header_zeroed():
 
 
 
+
+###############################################################################
+# Test opening many members of an archive whose central directory is already
+# indexed, with several handles opened at the same time, and from several
+# threads
+
+
+def test_vsizip_many_members_concurrent_handles():
+
+    zip_name = '/vsimem/vsizip_many_members.zip'
+    nmembers = 500
+
+    fmain = gdal.VSIFOpenL('/vsizip/' + zip_name, 'wb')
+    for i in range(nmembers):
+        f = gdal.VSIFOpenL('/vsizip/%s/subdir/%d.txt' % (zip_name, i), 'wb')
+        gdal.VSIFWriteL('member %d ' % i * (i % 10 + 1), 1,
+                        len('member %d ' % i) * (i % 10 + 1), f)
+        gdal.VSIFCloseL(f)
+    gdal.VSIFCloseL(fmain)
+
+    assert len(gdal.ReadDir('/vsizip/' + zip_name + '/subdir')) == nmembers
+
+    handles = []
+    for i in range(nmembers):
+        f = gdal.VSIFOpenL('/vsizip/%s/subdir/%d.txt' % (zip_name, i), 'rb')
+        assert f is not None
+        handles.append(f)
+    for i in range(nmembers - 1, -1, -1):
+        expected = 'member %d ' % i * (i % 10 + 1)
+        assert gdal.VSIFReadL(1, 1000, handles[i]).decode('ascii') == expected
+        gdal.VSIFCloseL(handles[i])
+
+    assert gdal.VSIFOpenL('/vsizip/%s/subdir/%d.txt' % (zip_name, nmembers), 'rb') is None
+    assert gdal.VSIFOpenL('/vsizip/%s/subdir' % zip_name, 'rb') is None
+
+    import threading
+
+    errors = []
+
+    def read_members(start):
+        for i in range(start, nmembers, 4):
+            expected = 'member %d ' % i * (i % 10 + 1)
+            f = gdal.VSIFOpenL('/vsizip/%s/subdir/%d.txt' % (zip_name, i), 'rb')
+            if f is None:
+                errors.append(i)
+                continue
+            if gdal.VSIFReadL(1, 1000, f).decode('ascii') != expected:
+                errors.append(i)
+            gdal.VSIFCloseL(f)
+
+    threads = [threading.Thread(target=read_members, args=(i,)) for i in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    gdal.Unlink(zip_name)
+
+    assert not errors
@@ -420,3 +420,36 @@ def test_envi_interleaving():
         assert ds.GetRasterBand(2).Checksum() == 20669, filename
         assert ds.GetRasterBand(3).Checksum() == 20895, filename
         ds = None
+
+###############################################################################
+# Test that reading through a zero-copy view of the file gives the same
+# results as the regular read path
+
+
+def test_envi_zero_copy_read():
+
+    for filename in ('data/envi_rgbsmall_bip.img', 'data/envi_rgbsmall_bil.img',
+                     'data/envi_rgbsmall_bsq.img', 'data/uint16_envi_bigendian.dat'):
+        for prefix in ('', '/vsimem/'):
+            if prefix:
+                gdal.FileFromMemBuffer(prefix + filename,
+                                       open(filename, 'rb').read())
+                hdr_filename = filename[0:filename.rfind('.')] + '.hdr'
+                gdal.FileFromMemBuffer(prefix + hdr_filename,
+                                       open(hdr_filename, 'rb').read())
+
+            res = {}
+            for mmap in ('YES', 'NO'):
+                with gdaltest.config_option('CPL_VSIL_MMAP_READ', mmap):
+                    ds = gdal.Open(prefix + filename)
+                    full = ds.ReadRaster()
+                    with gdaltest.config_option('GDAL_ONE_BIG_READ', 'YES'):
+                        sub = ds.GetRasterBand(1).ReadRaster(
+                            1, 2, 18, 16, 9, 8)
+                    ds = None
+                res[mmap] = (full, sub)
+            assert res['YES'] == res['NO'], prefix + filename
+
+            if prefix:
+                gdal.Unlink(prefix + filename)
+                gdal.Unlink(prefix + hdr_filename)
@@ -3280,6 +3280,75 @@ def test_gpkg_wkt2():
 
     gdal.Unlink(filename)
 
+###############################################################################
+# Test NUM_THREADS for tile compression and decompression
+
+
+def test_gpkg_num_threads():
+
+    if gdaltest.gpkg_dr is None or gdaltest.png_dr is None:
+        pytest.skip()
+
+    src_ds = gdal.Translate('', 'data/small_world.tif', format='MEM',
+                            width=1000, height=700)
+    src_ds.AddBand(gdal.GDT_Byte)
+    src_ds.GetRasterBand(4).Fill(255)
+    src_ds.GetRasterBand(4).WriteRaster(100, 100, 50, 50, b'\x00' * 2500)
+
+    for num_threads in ('1', '4'):
+        filename = '/vsimem/gpkg_num_threads_%s.gpkg' % num_threads
+        ds = gdaltest.gpkg_dr.CreateCopy(filename, src_ds,
+                                         options=['TILE_FORMAT=PNG',
+                                                  'NUM_THREADS=' + num_threads])
+        assert ds is not None
+        ds.BuildOverviews('AVERAGE', [2, 4])
+        # Rewrite some tiles, possibly while their previous content is still
+        # being compressed
+        ds.WriteRaster(200, 50, 300, 300, b'\x7f' * (300 * 300 * 4))
+        ds.FlushCache()
+        ds.WriteRaster(400, 300, 300, 300, b'\xc0' * (300 * 300 * 4))
+        assert ds.ReadRaster(0, 0, 1000, 700) is not None
+        ds = None
+
+    def get_tiles(num_threads):
+        ds = gdal.Open('/vsimem/gpkg_num_threads_%s.gpkg' % num_threads)
+        sql_lyr = ds.ExecuteSQL('SELECT zoom_level, tile_row, tile_column, '
+                                'tile_data FROM gpkg_num_threads_%s ORDER BY '
+                                'zoom_level, tile_row, tile_column' %
+                                num_threads)
+        ret = [(f.GetField(0), f.GetField(1), f.GetField(2),
+                f.GetFieldAsBinary(3)) for f in sql_lyr]
+        ds.ReleaseResultSet(sql_lyr)
+        return ret
+
+    # Compressing on worker threads must not change the content
+    assert get_tiles('1') == get_tiles('4')
+
+    ref_ds = gdal.Open('/vsimem/gpkg_num_threads_1.gpkg')
+    ref_data = ref_ds.ReadRaster(0, 0, 1000, 700)
+    ref_band_data = ref_ds.GetRasterBand(2).ReadRaster(0, 0, 1000, 700)
+    ref_ds = None
+
+    ds = gdal.OpenEx('/vsimem/gpkg_num_threads_4.gpkg',
+                     open_options=['NUM_THREADS=ALL_CPUS'])
+    assert ds.ReadRaster(0, 0, 1000, 700) == ref_data
+    ds = None
+
+    ds = gdal.OpenEx('/vsimem/gpkg_num_threads_4.gpkg',
+                     open_options=['NUM_THREADS=4'])
+    assert ds.GetRasterBand(2).ReadRaster(0, 0, 1000, 700) == ref_band_data
+    ds = None
+
+    with gdaltest.error_handler():
+        ds = gdal.OpenEx('/vsimem/gpkg_num_threads_4.gpkg',
+                         open_options=['NUM_THREADS=invalid'])
+    assert gdal.GetLastErrorMsg() == 'Invalid value for NUM_THREADS: invalid'
+    assert ds.ReadRaster(0, 0, 1000, 700) == ref_data
+    ds = None
+
+    gdal.Unlink('/vsimem/gpkg_num_threads_1.gpkg')
+    gdal.Unlink('/vsimem/gpkg_num_threads_4.gpkg')
+
 ###############################################################################
 # Test reading a 50000x25000 block uint16
 
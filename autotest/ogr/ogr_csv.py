@@ -2197,6 +2197,146 @@ def test_ogr_csv_iter_and_set_feature():
 
     assert count == 2
 
+###############################################################################
+# Test the .idx line-offset index
+
+
+def test_ogr_csv_line_index():
+
+    filename = '/vsimem/ogr_csv_line_index.csv'
+    content = 'id,str\n'
+    for i in range(1, 101):
+        if i % 10 == 0:
+            content += '%d,"multi\nline ""%d"""\n\n' % (i, i)
+        else:
+            content += '%d,str%d\r\n' % (i, i)
+    gdal.FileFromMemBuffer(filename, content)
+
+    def check(lyr):
+        for fid in (100, 1, 10, 55, 2):
+            f = lyr.GetFeature(fid)
+            assert f.GetFID() == fid
+            assert f['id'] == str(fid)
+            if fid % 10 == 0:
+                assert f['str'] == 'multi\nline "%d"' % fid
+            else:
+                assert f['str'] == 'str%d' % fid
+        assert lyr.GetFeature(101) is None
+        f = lyr.GetFeature(55)
+        assert lyr.GetNextFeature().GetFID() == 56
+
+    ds = gdal.OpenEx(filename, open_options=['LINE_INDEX=YES'])
+    lyr = ds.GetLayer(0)
+    assert lyr.TestCapability(ogr.OLCRandomRead)
+    check(lyr)
+    assert lyr.GetFeatureCount() == 100
+    ds = None
+    assert gdal.VSIStatL(filename + '.idx') is not None
+
+    # The existing index is used by default
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    assert lyr.TestCapability(ogr.OLCFastFeatureCount)
+    assert lyr.GetFeatureCount() == 100
+    check(lyr)
+    ds = None
+
+    ds = gdal.OpenEx(filename, open_options=['LINE_INDEX=NO'])
+    lyr = ds.GetLayer(0)
+    assert not lyr.TestCapability(ogr.OLCFastFeatureCount)
+    ds = None
+
+    # A stale index is ignored
+    gdal.FileFromMemBuffer(filename, content + '101,str101\n')
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    assert not lyr.TestCapability(ogr.OLCFastFeatureCount)
+    assert lyr.GetFeatureCount() == 101
+    ds = None
+
+    # A rewrite of the file with the same size, within the resolution of
+    # the modification time, is also detected
+    gdal.Unlink(filename + '.idx')
+    ds = gdal.OpenEx(filename, open_options=['LINE_INDEX=YES'])
+    assert ds.GetLayer(0).GetFeatureCount() == 101
+    ds = None
+    assert gdal.VSIStatL(filename + '.idx') is not None
+    gdal.FileFromMemBuffer(filename, content + '101,str102\n')
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    assert not lyr.TestCapability(ogr.OLCFastFeatureCount)
+    assert lyr.GetFeature(101)['str'] == 'str102'
+    ds = None
+
+    gdal.Unlink(filename)
+    gdal.Unlink(filename + '.idx')
+
+###############################################################################
+# Test parsing of chunks of records by worker threads
+
+
+@pytest.mark.parametrize('num_threads,chunk_size', [('1', '1048576'),
+                                                     ('4', '1048576'),
+                                                     ('1', '1000'),
+                                                     ('4', '1000')])
+def test_ogr_csv_num_threads(num_threads, chunk_size):
+
+    filename = '/vsimem/ogr_csv_num_threads.csv'
+    # Some records span several lines
+    data = 'id,str,val\n' + ''.join(
+        '%d,"str %d%s",%d.5\n' % (i, i, '\nline' if (i % 37) == 0 else '', i)
+        for i in range(1000))
+    gdal.FileFromMemBuffer(filename, data)
+
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    expected = [(f.GetFID(), f['id'], f['str'], f['val']) for f in lyr]
+    ds = None
+    assert len(expected) == 1000
+
+    # Small chunks give several jobs per batch, and several batches
+    with gdaltest.config_option('OGR_CSV_CHUNK_SIZE', chunk_size):
+        ds = gdal.OpenEx(filename, open_options=['NUM_THREADS=' + num_threads])
+        lyr = ds.GetLayer(0)
+        for _ in range(2):
+            got = [(f.GetFID(), f['id'], f['str'], f['val']) for f in lyr]
+            assert got == expected
+
+        lyr.SetAttributeFilter("id = '500'")
+        assert lyr.GetFeatureCount() == 1
+        ds = None
+
+    gdal.Unlink(filename)
+
+###############################################################################
+# Test quoting corner cases of the record tokenizer
+
+
+@pytest.mark.parametrize('num_threads,chunk_size', [('1', '1048576'),
+                                                     ('2', '1048576'),
+                                                     ('2', '8')])
+def test_ogr_csv_tokenizer_quoting(num_threads, chunk_size):
+
+    filename = '/vsimem/ogr_csv_tokenizer_quoting.csv'
+    gdal.FileFromMemBuffer(filename,
+                           b'\xef\xbb\xbfid,str\r\n' +
+                           b'1,"a ""quoted"" value"\r\n\r\n' +
+                           b'2,"multi\r\nline"\n' +
+                           b'3,x"y,z"w\n' +
+                           b'4,"unterminated,')
+
+    with gdaltest.config_option('OGR_CSV_CHUNK_SIZE', chunk_size):
+        ds = gdal.OpenEx(filename, open_options=['NUM_THREADS=' + num_threads])
+        lyr = ds.GetLayer(0)
+        got = [(f.GetFID(), f['id'], f['str']) for f in lyr]
+        ds = None
+    gdal.Unlink(filename)
+
+    assert got == [(1, '1', 'a "quoted" value'),
+                   (2, '2', 'multi\nline'),
+                   (3, '3', 'xy,zw'),
+                   (4, '4', 'unterminated,')]
+
 ###############################################################################
 #
 
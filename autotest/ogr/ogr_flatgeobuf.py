@@ -646,3 +646,81 @@ def test_ogr_flatgeobuf_huge_number_of_columns():
     ds = None
 
     ogr.GetDriverByName('FlatGeobuf').DeleteDataSource('/vsimem/test.fgb')
+
+
+@pytest.mark.parametrize("num_threads", ['1', '4'])
+def test_ogr_flatgeobuf_spatial_filter_batched_reads(num_threads):
+    ds = ogr.GetDriverByName('FlatGeobuf').CreateDataSource('/vsimem/test.fgb')
+    lyr = ds.CreateLayer('test', geom_type = ogr.wkbPoint)
+    lyr.CreateField(ogr.FieldDefn('str', ogr.OFTString))
+    for i in range(5000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        # Some features larger than the average one
+        f.SetField(0, 'x' * 100000 if (i % 97) == 0 else str(i))
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT (%d %d)' % (i % 100, i // 100)))
+        lyr.CreateFeature(f)
+    ds = None
+
+    # More features than the maximum batch size (1000) match the filter
+    def get_features(ds, spatial_filter):
+        lyr = ds.GetLayer(0)
+        if spatial_filter:
+            lyr.SetSpatialFilterRect(10.5, 5.5, 60.5, 40.5)
+        ret = {}
+        for f in lyr:
+            x, y = f.GetGeometryRef().GetX(), f.GetGeometryRef().GetY()
+            if 10.5 <= x <= 60.5 and 5.5 <= y <= 40.5:
+                ret[f.GetFID()] = (f.GetField(0), x, y)
+        return ret
+
+    ds = ogr.Open('/vsimem/test.fgb')
+    expected = get_features(ds, False)
+    assert len(expected) == 50 * 35
+
+    ds = gdal.OpenEx('/vsimem/test.fgb', open_options=['NUM_THREADS=' + num_threads])
+    lyr = ds.GetLayer(0)
+    assert get_features(ds, True) == expected
+    lyr.ResetReading()
+    assert get_features(ds, True) == expected
+    f = lyr.GetFeature(97)
+    assert f.GetField(0) == 'x' * 100000
+    ds = None
+
+    ogr.GetDriverByName('FlatGeobuf').DeleteDataSource('/vsimem/test.fgb')
+
+
+@pytest.mark.parametrize("num_threads", ['1', '4'])
+def test_ogr_flatgeobuf_spatial_index_external_sort(num_threads):
+
+    def create(filename, options):
+        ds = ogr.GetDriverByName('FlatGeobuf').CreateDataSource(filename)
+        lyr = ds.CreateLayer('test', geom_type = ogr.wkbPoint, options = options)
+        lyr.CreateField(ogr.FieldDefn('str', ogr.OFTString))
+        for i in range(20000):
+            f = ogr.Feature(lyr.GetLayerDefn())
+            f.SetField(0, 'x' * 10000 if (i % 997) == 0 else str(i))
+            f.SetGeometry(ogr.CreateGeometryFromWkt('POINT (%d %d)' % ((i * 7919) % 1000, (i * 104729) % 1000)))
+            lyr.CreateFeature(f)
+        ds = None
+        f = gdal.VSIFOpenL(filename, 'rb')
+        data = gdal.VSIFReadL(1, 100000000, f)
+        gdal.VSIFCloseL(f)
+        return data
+
+    # Temporary file in /vsimem/: features are directly copied
+    expected = create('/vsimem/test.fgb', ['TEMPORARY_DIR=/vsimem/'])
+    ogr.GetDriverByName('FlatGeobuf').DeleteDataSource('/vsimem/test.fgb')
+
+    # Temporary file on disk, with several sort runs
+    with gdaltest.config_option('OGR_FLATGEOBUF_SORT_RUN_SIZE', '50000'):
+        got = create('tmp/test.fgb', ['NUM_THREADS=' + num_threads])
+    assert got == expected
+
+    ds = ogr.Open('tmp/test.fgb')
+    lyr = ds.GetLayer(0)
+    assert lyr.GetFeatureCount() == 20000
+    values = set(f.GetField(0) for f in lyr)
+    assert values == set('x' * 10000 if (i % 997) == 0 else str(i) for i in range(20000))
+    ds = None
+
+    ogr.GetDriverByName('FlatGeobuf').DeleteDataSource('tmp/test.fgb')
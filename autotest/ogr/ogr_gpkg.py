@@ -3938,6 +3938,137 @@ def test_ogr_gpkg_mixed_dimensionality_unknown_layer_geometry_type():
     gdal.Unlink(filename)
 
 
+###############################################################################
+# Test that geometries are copied without being instantiated by
+# ogr2ogr when possible (OGR_GPKG_LAZY_GEOMETRY)
+
+
+@pytest.mark.parametrize('lazy', ['YES', 'NO'])
+def test_ogr_gpkg_lazy_geometry(lazy):
+
+    src_filename = '/vsimem/test_ogr_gpkg_lazy_geometry_src.gpkg'
+    dst_filename = '/vsimem/test_ogr_gpkg_lazy_geometry_dst.gpkg'
+    ds = gdaltest.gpkg_dr.CreateDataSource(src_filename)
+    lyr = ds.CreateLayer('test', geom_type=ogr.wkbUnknown)
+    lyr.CreateField(ogr.FieldDefn('id', ogr.OFTInteger))
+    wkts = ['POINT (1 2)',
+            'POINT (1 2 3)',
+            'LINESTRING (0 0,10 -5)',
+            'POLYGON ((0 0,0 1,1 1,0 0))',
+            'MULTIPOLYGON Z (((0 0 -1,0 1 2,1 1 3,0 0 -1)))',
+            'LINESTRING EMPTY',
+            'CIRCULARSTRING (0 0,1 1,2 0)',
+            None]
+    for i, wkt in enumerate(wkts):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f['id'] = i
+        if wkt:
+            f.SetGeometry(ogr.CreateGeometryFromWkt(wkt))
+        lyr.CreateFeature(f)
+    ds = None
+
+    with gdaltest.config_option('OGR_GPKG_LAZY_GEOMETRY', lazy):
+        ds = gdal.VectorTranslate(dst_filename, src_filename)
+        ds = None
+
+    assert validate(dst_filename), 'validation failed'
+
+    ds = ogr.Open(dst_filename)
+    lyr = ds.GetLayer(0)
+    for i, wkt in enumerate(wkts):
+        f = lyr.GetNextFeature()
+        assert f['id'] == i
+        g = f.GetGeometryRef()
+        if wkt is None:
+            assert g is None
+        else:
+            assert g.ExportToIsoWkt() == wkt
+    assert lyr.GetExtent() == (0, 10, -5, 2)
+    sql_lyr = ds.ExecuteSQL(
+        'SELECT MIN(ST_MinX(geom)), MAX(ST_MaxX(geom)), '
+        'MIN(ST_MinY(geom)), MAX(ST_MaxY(geom)) FROM test')
+    f = sql_lyr.GetNextFeature()
+    assert [f.GetField(i) for i in range(4)] == [0, 10, -5, 2]
+    ds.ReleaseResultSet(sql_lyr)
+    ds = None
+
+    gdal.Unlink(src_filename)
+    gdal.Unlink(dst_filename)
+
+
+###############################################################################
+# Test bulk loading of the RTree at the end of ogr2ogr
+
+
+@pytest.mark.parametrize('bulk_load,num_threads', [('YES', '1'),
+                                                   ('YES', '4'),
+                                                   ('NO', '1')])
+def test_ogr_gpkg_rtree_bulk_load(bulk_load, num_threads):
+
+    src_filename = '/vsimem/test_ogr_gpkg_rtree_bulk_load_src.gpkg'
+    dst_filename = '/vsimem/test_ogr_gpkg_rtree_bulk_load_dst.gpkg'
+    ds = gdaltest.gpkg_dr.CreateDataSource(src_filename)
+    lyr = ds.CreateLayer('test', geom_type=ogr.wkbUnknown,
+                         options=['SPATIAL_INDEX=NO'])
+    ds.StartTransaction()
+    # More than 51 * 51 features, so that the tree has several levels
+    for i in range(3000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        x = (i * 37) % 1000
+        y = (i * 91) % 1000
+        if i % 100 == 1:
+            wkt = 'POLYGON ((%d %d,%d %d,%d %d,%d %d,%d %d))' % (
+                x, y, x, y + 5, x + 5, y + 5, x + 5, y, x, y)
+            f.SetGeometry(ogr.CreateGeometryFromWkt(wkt))
+        elif i % 100 == 2:
+            f.SetGeometry(ogr.CreateGeometryFromWkt('POINT EMPTY'))
+        elif i % 100 != 3:
+            f.SetGeometry(ogr.CreateGeometryFromWkt('POINT (%d %d)' % (x, y)))
+        lyr.CreateFeature(f)
+    ds.CommitTransaction()
+    ds = None
+
+    with gdaltest.config_options({'OGR_GPKG_RTREE_BULK_LOAD': bulk_load,
+                                  'GDAL_NUM_THREADS': num_threads}):
+        ds = gdal.VectorTranslate(dst_filename, src_filename)
+        ds = None
+
+    assert validate(dst_filename), 'validation failed'
+
+    ds = ogr.Open(dst_filename)
+    sql_lyr = ds.ExecuteSQL('SELECT COUNT(*) FROM rtree_test_geom')
+    f = sql_lyr.GetNextFeature()
+    assert f.GetField(0) == 3000 - 30 - 30
+    ds.ReleaseResultSet(sql_lyr)
+
+    with gdaltest.error_handler():
+        sql_lyr = ds.ExecuteSQL("SELECT rtreecheck('rtree_test_geom')")
+    if sql_lyr:
+        f = sql_lyr.GetNextFeature()
+        assert f.GetField(0) == 'ok'
+        ds.ReleaseResultSet(sql_lyr)
+
+    lyr = ds.GetLayer(0)
+    for (minx, miny, maxx, maxy) in [(0, 0, 1000, 1000), (100, 200, 150, 260),
+                                     (998, 998, 1000, 1000), (-10, -10, -1, -1)]:
+        lyr.SetSpatialFilterRect(minx, miny, maxx, maxy)
+        got = sorted([f.GetFID() for f in lyr])
+        expected = []
+        for i in range(3000):
+            x = (i * 37) % 1000
+            y = (i * 91) % 1000
+            size = 5 if i % 100 == 1 else 0
+            if i % 100 in (2, 3):
+                continue
+            if x <= maxx and x + size >= minx and y <= maxy and y + size >= miny:
+                expected.append(i + 1)
+        assert got == expected
+    ds = None
+
+    gdal.Unlink(src_filename)
+    gdal.Unlink(dst_filename)
+
+
 ###############################################################################
 # Remove the test db from the tmp directory
 
@@ -30,6 +30,7 @@ import os
 
 
 import gdaltest
+from osgeo import gdal
 from osgeo import ogr
 import ogrtest
 import pytest
@@ -409,6 +410,168 @@ def test_ogr_index_11():
     ds = None
 
 ###############################################################################
+# Test attribute indexes stored in a .ogridx sidecar file, as used by drivers
+# such as CSV, GeoJSON and FlatGeobuf that have no native attribute index.
+
+
+def ogr_index_sidecar_check(lyr, expected_fids):
+
+    lyr.ResetReading()
+    got_fids = [f.GetFID() for f in lyr]
+    assert got_fids == expected_fids
+    assert lyr.GetFeatureCount() == len(expected_fids)
+
+
+def test_ogr_index_sidecar_csv():
+
+    filename = 'tmp/ogr_index_sidecar.csv'
+    with open(filename, 'wt') as f:
+        f.write('id,val,name\n')
+        f.write('1,1.5,foo\n')
+        f.write('2,-3.25,BAR\n')
+        f.write('3,,baz\n')
+        f.write('4,10,bar\n')
+        f.write('5,2.5,Foo\n')
+    with open('tmp/ogr_index_sidecar.csvt', 'wt') as f:
+        f.write('Integer,Real,String\n')
+
+    filters = [("id = 3", [3]),
+               ("id IN (1, 4, 7)", [1, 4]),
+               ("id > 2.5", [3, 4, 5]),
+               ("id BETWEEN 2 AND 4", [2, 3, 4]),
+               ("val <= 2.5", [1, 2, 5]),
+               ("val > 2.5 OR id < 2", [1, 4]),
+               ("name = 'bar'", [2, 4]),
+               ("name >= 'FOO'", [1, 5]),
+               ("name BETWEEN 'bar' AND 'baz' AND id > 2", [3, 4])]
+
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    for field in ('id', 'val', 'name'):
+        ds.ExecuteSQL('CREATE INDEX ON ogr_index_sidecar USING ' + field)
+    assert os.path.exists(filename + '.ogridx')
+    for attr_filter, expected_fids in filters:
+        lyr.SetAttributeFilter(attr_filter)
+        ogr_index_sidecar_check(lyr, expected_fids)
+    ds = None
+
+    # Indexes are reloaded when reopening the file
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    for attr_filter, expected_fids in filters:
+        lyr.SetAttributeFilter(attr_filter)
+        ogr_index_sidecar_check(lyr, expected_fids)
+    ds = None
+
+    # A stale index must be ignored
+    with open(filename, 'at') as f:
+        f.write('6,0,bar\n')
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    lyr.SetAttributeFilter("name = 'bar'")
+    ogr_index_sidecar_check(lyr, [2, 4, 6])
+
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_sidecar USING name')
+    lyr.SetAttributeFilter("name = 'bar'")
+    ogr_index_sidecar_check(lyr, [2, 4, 6])
+    ds = None
+
+    # A rewrite that keeps the size and the modification time must also be
+    # detected
+    st = os.stat(filename)
+    with open(filename, 'rt') as f:
+        content = f.read()
+    with open(filename, 'wt') as f:
+        f.write(content.replace('6,0,bar', '6,0,baz'))
+    os.utime(filename, (st.st_atime, st.st_mtime))
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    lyr.SetAttributeFilter("name = 'bar'")
+    ogr_index_sidecar_check(lyr, [2, 4])
+
+    ds.ExecuteSQL('DROP INDEX ON ogr_index_sidecar')
+    ds = None
+    assert not os.path.exists(filename + '.ogridx')
+
+    os.unlink(filename)
+    os.unlink('tmp/ogr_index_sidecar.csvt')
+
+###############################################################################
+
+
+def test_ogr_index_sidecar_geojson():
+
+    filename = 'tmp/ogr_index_sidecar.geojson'
+    with open(filename, 'wt') as f:
+        f.write('{"type": "FeatureCollection", "features": [\n')
+        f.write(',\n'.join(['{"type": "Feature", "properties": {"i": %d, "s": "%s"}, "geometry": null}' % (i % 7, 'aBc'[i % 3]) for i in range(100)]))
+        f.write(']}\n')
+
+    filters = ['i = 3', 'i IN (0, 6)', 'i > 4', "s = 'B'", "s >= 'b' AND i < 2"]
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    expected = []
+    for attr_filter in filters:
+        lyr.SetAttributeFilter(attr_filter)
+        expected.append([f.GetFID() for f in lyr])
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_sidecar USING i')
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_sidecar USING s')
+    ds = None
+    assert os.path.exists(filename + '.ogridx')
+
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    for attr_filter, expected_fids in zip(filters, expected):
+        lyr.SetAttributeFilter(attr_filter)
+        ogr_index_sidecar_check(lyr, sorted(expected_fids))
+    ds.ExecuteSQL('DROP INDEX ON ogr_index_sidecar')
+    ds = None
+    assert not os.path.exists(filename + '.ogridx')
+
+    os.unlink(filename)
+
+###############################################################################
+
+
+def test_ogr_index_sidecar_flatgeobuf():
+
+    if ogr.GetDriverByName('FlatGeobuf') is None:
+        pytest.skip()
+
+    filename = 'tmp/ogr_index_sidecar.fgb'
+    ds = ogr.GetDriverByName('FlatGeobuf').CreateDataSource(filename)
+    lyr = ds.CreateLayer('ogr_index_sidecar', geom_type=ogr.wkbPoint)
+    lyr.CreateField(ogr.FieldDefn('intfield', ogr.OFTInteger))
+    for i in range(10):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f['intfield'] = i % 5
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT (%d %d)' % (i, i)))
+        lyr.CreateFeature(f)
+    ds = None
+
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    lyr.SetAttributeFilter('intfield >= 3')
+    expected_fids = sorted([f.GetFID() for f in lyr])
+    assert len(expected_fids) == 4
+
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_sidecar USING intfield')
+    assert os.path.exists(filename + '.ogridx')
+    lyr.SetAttributeFilter('intfield >= 3')
+    ogr_index_sidecar_check(lyr, expected_fids)
+    for f in lyr:
+        assert f['intfield'] >= 3
+
+    lyr.SetSpatialFilterRect(0, 0, 4.5, 4.5)
+    lyr.SetAttributeFilter('intfield >= 3')
+    lyr.ResetReading()
+    assert sorted([f['intfield'] for f in lyr]) == [3, 4]
+    ds = None
+
+    ogr.GetDriverByName('FlatGeobuf').DeleteDataSource(filename)
+    gdal.Unlink(filename + '.ogridx')
+
+###############################################################################
 
 
 def test_ogr_index_cleanup():
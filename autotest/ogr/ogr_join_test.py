@@ -494,6 +494,122 @@ def test_ogr_join_23():
 
     ds = None
 
+###############################################################################
+# Test that hash joins give the same results as per-feature attribute filters
+
+
+@pytest.mark.parametrize("primary_type,secondary_type", [
+    (ogr.OFTInteger, ogr.OFTInteger),
+    (ogr.OFTInteger, ogr.OFTInteger64),
+    (ogr.OFTInteger, ogr.OFTReal),
+    (ogr.OFTReal, ogr.OFTReal),
+    (ogr.OFTString, ogr.OFTString),
+])
+def test_ogr_join_hash(primary_type, secondary_type):
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('first', geom_type=ogr.wkbNone)
+    lyr.CreateField(ogr.FieldDefn('key', primary_type))
+    for i in range(20):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if i != 5:
+            f['key'] = ('Key%d' % (i % 7)) if primary_type == ogr.OFTString else i % 7
+        lyr.CreateFeature(f)
+
+    lyr = ds.CreateLayer('second', geom_type=ogr.wkbNone)
+    lyr.CreateField(ogr.FieldDefn('key', secondary_type))
+    lyr.CreateField(ogr.FieldDefn('val', ogr.OFTInteger))
+    for i in range(10):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if i != 3:
+            # Duplicated keys: the first one must be used
+            f['key'] = ('KEY%d' % (i % 5)) if secondary_type == ogr.OFTString else i % 5
+        f['val'] = i
+        lyr.CreateFeature(f)
+
+    def get_values():
+        sql_lyr = ds.ExecuteSQL("SELECT * FROM first LEFT JOIN second ON first.key = second.key")
+        ret = [(f['key'], f['second.val']) for f in sql_lyr]
+        ds.ReleaseResultSet(sql_lyr)
+        return ret
+
+    got = get_values()
+    with gdaltest.config_option('OGR_SQL_HASH_JOIN', 'NO'):
+        expected = get_values()
+    assert got == expected
+    assert got[1][1] == 1
+    assert got[5][1] is None
+    assert got[6][1] is None
+
+    # Too small memory limit: fallback to attribute filters
+    with gdaltest.config_option('OGR_SQL_HASH_JOIN_MAX_MEMORY', '0'):
+        assert get_values() == expected
+
+###############################################################################
+# Test that hash joins follow the comparison semantics of the attribute
+# filters of drivers (case sensitive strings for GPKG, large 64 bit integers)
+
+
+@pytest.mark.parametrize("driver_name,filename", [
+    ('GPKG', '/vsimem/ogr_join_hash.gpkg'),
+    ('CSV', '/vsimem/ogr_join_hash'),
+])
+@pytest.mark.parametrize("primary_type,secondary_type", [
+    (ogr.OFTString, ogr.OFTString),
+    (ogr.OFTInteger64, ogr.OFTInteger64),
+    (ogr.OFTInteger64, ogr.OFTReal),
+])
+def test_ogr_join_hash_driver_semantics(driver_name, filename,
+                                        primary_type, secondary_type):
+
+    drv = ogr.GetDriverByName(driver_name)
+    if drv is None:
+        pytest.skip()
+
+    ds = drv.CreateDataSource(filename)
+    lyr = ds.CreateLayer('first', geom_type=ogr.wkbNone)
+    lyr.CreateField(ogr.FieldDefn('key', primary_type))
+    if primary_type == ogr.OFTString:
+        keys = ['abc', 'ABC', 'Abc', 'def', 'xyz']
+    else:
+        keys = [(1 << 53) + 1, 1 << 53, 5, (1 << 53) + 3, -((1 << 53) + 1)]
+    for key in keys:
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f['key'] = key
+        lyr.CreateFeature(f)
+
+    lyr = ds.CreateLayer('second', geom_type=ogr.wkbNone)
+    lyr.CreateField(ogr.FieldDefn('key', secondary_type))
+    lyr.CreateField(ogr.FieldDefn('val', ogr.OFTInteger))
+    if secondary_type == ogr.OFTString:
+        keys = ['ABC', 'abc', 'DEF', 'xyz']
+    else:
+        keys = [1 << 53, (1 << 53) + 1, 5, -((1 << 53) + 1)]
+    for i, key in enumerate(keys):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f['key'] = float(key) if secondary_type == ogr.OFTReal else key
+        f['val'] = i
+        lyr.CreateFeature(f)
+    ds = None
+
+    ds = ogr.Open(filename)
+
+    def get_values():
+        sql_lyr = ds.ExecuteSQL("SELECT * FROM first LEFT JOIN second ON first.key = second.key",
+                                dialect='OGRSQL')
+        ret = [(f['key'], f['second.val']) for f in sql_lyr]
+        ds.ReleaseResultSet(sql_lyr)
+        return ret
+
+    got = get_values()
+    with gdaltest.config_option('OGR_SQL_HASH_JOIN', 'NO'):
+        expected = get_values()
+    assert got == expected
+    ds = None
+
+    drv.DeleteDataSource(filename)
+
+
 ###############################################################################
 
 
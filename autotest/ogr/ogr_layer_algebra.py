@@ -574,6 +574,90 @@ def test_algebra_erase():
     recreate_layer_C()
 
 
+def test_algebra_spatialjoin():
+    if not ogrtest.have_geos():
+        pytest.skip()
+
+    recreate_layer_C()
+
+    # Both polygons of A intersect the polygon of B
+
+    err = A.SpatialJoin(B, C)
+
+    assert err == 0, ('got non-zero result code ' + str(err) + ' from Layer.SpatialJoin')
+
+    assert C.GetFeatureCount() == 2, \
+        ('Layer.SpatialJoin returned ' + str(C.GetFeatureCount()) + ' features')
+    for feat_c in C:
+        assert feat_c.GetField('B') == 'first'
+    C.ResetReading()
+    feat_c = C.GetNextFeature()
+    assert feat_c.GetField('A') == 1
+    assert feat_c.GetGeometryRef().Equals(ogr.CreateGeometryFromWkt('POLYGON((1 2, 1 3, 3 3, 3 2, 1 2))'))
+
+    recreate_layer_C()
+
+    err = A.SpatialJoin(B, C, options=['NUM_THREADS=2', 'USE_PREPARED_GEOMETRIES=NO'])
+
+    assert err == 0, ('got non-zero result code ' + str(err) + ' from Layer.SpatialJoin')
+
+    assert C.GetFeatureCount() == 2, \
+        ('Layer.SpatialJoin returned ' + str(C.GetFeatureCount()) + ' features')
+
+    recreate_layer_C()
+
+    # The point is on the boundary of a1: it intersects it, but is not within it
+
+    err = pointInB.SpatialJoin(A, C)
+
+    assert err == 0, ('got non-zero result code ' + str(err) + ' from Layer.SpatialJoin')
+
+    assert C.GetFeatureCount() == 1, \
+        ('Layer.SpatialJoin returned ' + str(C.GetFeatureCount()) + ' features')
+
+    recreate_layer_C()
+
+    err = pointInB.SpatialJoin(A, C, options=['PREDICATE=WITHIN'])
+
+    assert err == 0, ('got non-zero result code ' + str(err) + ' from Layer.SpatialJoin')
+
+    assert C.GetFeatureCount() == 0, \
+        ('Layer.SpatialJoin returned ' + str(C.GetFeatureCount()) + ' features')
+
+    recreate_layer_C()
+
+    err = pointInB.SpatialJoin(A, C, options=['PREDICATE=WITHIN', 'KEEP_UNMATCHED=YES'])
+
+    assert err == 0, ('got non-zero result code ' + str(err) + ' from Layer.SpatialJoin')
+
+    assert C.GetFeatureCount() == 1, \
+        ('Layer.SpatialJoin returned ' + str(C.GetFeatureCount()) + ' features')
+    feat_c = C.GetNextFeature()
+    assert not feat_c.IsFieldSet('A')
+
+    recreate_layer_C()
+
+    err = pointInB.SpatialJoin(B, C, options=['PREDICATE=WITHIN'])
+
+    assert err == 0, ('got non-zero result code ' + str(err) + ' from Layer.SpatialJoin')
+
+    assert C.GetFeatureCount() == 1, \
+        ('Layer.SpatialJoin returned ' + str(C.GetFeatureCount()) + ' features')
+
+    recreate_layer_C()
+
+    # Join with empty layer
+
+    err = A.SpatialJoin(empty, C)
+
+    assert err == 0, ('got non-zero result code ' + str(err) + ' from Layer.SpatialJoin')
+
+    assert C.GetFeatureCount() == 0, \
+        ('Layer.SpatialJoin returned ' + str(C.GetFeatureCount()) + ' features')
+
+    recreate_layer_C()
+
+
 def test_algebra_cleanup():
     if not ogrtest.have_geos():
         pytest.skip()
@@ -29,6 +29,7 @@
 ###############################################################################
 
 import json
+import struct
 import sys
 
 
@@ -1479,7 +1480,8 @@ def test_ogr_mvt_write_errors():
     # Test failure in writing in temp db (multi-threaded)
     gdal.RmdirRecursive('/vsimem/foo')
     with gdaltest.config_option('OGR_MVT_REMOVE_TEMP_FILE', 'NO'):
-        ds = ogr.GetDriverByName('MVT').CreateDataSource('/vsimem/foo')
+        ds = ogr.GetDriverByName('MVT').CreateDataSource('/vsimem/foo',
+                                                         options=['TEMPORARY_DB=/vsimem/foo.temp.db'])
     temp_ds = ogr.Open('/vsimem/foo.temp.db', update=1)
     temp_ds.ExecuteSQL('DROP TABLE temp')
     temp_ds = None
@@ -1497,7 +1499,8 @@ def test_ogr_mvt_write_errors():
     gdal.RmdirRecursive('/vsimem/foo')
     with gdaltest.config_option('OGR_MVT_REMOVE_TEMP_FILE', 'NO'):
         with gdaltest.config_option('GDAL_NUM_THREADS', '1'):
-            ds = ogr.GetDriverByName('MVT').CreateDataSource('/vsimem/foo')
+            ds = ogr.GetDriverByName('MVT').CreateDataSource('/vsimem/foo',
+                                                             options=['TEMPORARY_DB=/vsimem/foo.temp.db'])
     temp_ds = ogr.Open('/vsimem/foo.temp.db', update=1)
     temp_ds.ExecuteSQL('DROP TABLE temp')
     temp_ds = None
@@ -1540,7 +1543,8 @@ def test_ogr_mvt_write_reuse_temp_db():
     lyr.CreateFeature(f)
 
     with gdaltest.config_option('OGR_MVT_REMOVE_TEMP_FILE', 'NO'):
-        gdal.VectorTranslate('/vsimem/out', src_ds, format='MVT')
+        gdal.VectorTranslate('/vsimem/out', src_ds, format='MVT',
+                             datasetCreationOptions=['TEMPORARY_DB=/vsimem/out.temp.db'])
 
     assert gdal.VSIStatL('/vsimem/out.temp.db') is not None
 
@@ -1559,6 +1563,120 @@ def test_ogr_mvt_write_reuse_temp_db():
     gdal.RmdirRecursive('/vsimem/out')
     gdal.Unlink('/vsimem/out.temp.db')
 
+###############################################################################
+# Test that the external sort of pre-generated features (with spilled runs)
+# produces the same tiles as the temporary SQLite database
+
+
+def test_ogr_mvt_write_external_sort():
+
+    if not ogrtest.have_geos() or ogr.GetDriverByName('SQLITE') is None:
+        pytest.skip()
+
+    src_ds = gdal.GetDriverByName('Memory').Create('', 0, 0, 0, gdal.GDT_Unknown)
+    for lyr_name in ('mylayer', 'another_layer'):
+        lyr = src_ds.CreateLayer(lyr_name)
+        lyr.CreateField(ogr.FieldDefn('val', ogr.OFTInteger))
+        for i in range(50):
+            f = ogr.Feature(lyr.GetLayerDefn())
+            f['val'] = i
+            x = (i % 7) * 100000
+            y = (i // 7) * 100000
+            if i % 2:
+                f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (x, y)))
+            else:
+                f.SetGeometry(ogr.CreateGeometryFromWkt(
+                    'LINESTRING(%d %d,%d %d)' % (x, y, x + 1000 * (i + 1), y + 500)))
+            lyr.CreateFeature(f)
+
+    for options in (['MAX_FEATURES=3'], ['MAX_SIZE=200'], []):
+        options = options + ['NAME=out', 'MAXZOOM=3']
+
+        gdal.VectorTranslate('/vsimem/out_sqlite', src_ds, format='MVT',
+                             datasetCreationOptions=options + ['TEMPORARY_DB=/vsimem/out.temp.db'])
+        with gdaltest.config_option('OGR_MVT_SORT_RUN_SIZE', '1000'):
+            gdal.VectorTranslate('/vsimem/out_sort', src_ds, format='MVT',
+                                 datasetCreationOptions=options)
+        assert gdal.VSIStatL('/vsimem/out_sort.temp.sort') is None
+
+        filenames = gdal.ReadDirRecursive('/vsimem/out_sqlite')
+        assert 'metadata.json' in filenames
+        assert gdal.ReadDirRecursive('/vsimem/out_sort') == filenames
+        for filename in filenames:
+            if filename.endswith('/'):
+                continue
+            f = gdal.VSIFOpenL('/vsimem/out_sqlite/' + filename, 'rb')
+            data_sqlite = gdal.VSIFReadL(1, 1000000, f)
+            gdal.VSIFCloseL(f)
+            f = gdal.VSIFOpenL('/vsimem/out_sort/' + filename, 'rb')
+            data_sort = gdal.VSIFReadL(1, 1000000, f)
+            gdal.VSIFCloseL(f)
+            assert data_sort == data_sqlite, (options, filename)
+
+        gdal.RmdirRecursive('/vsimem/out_sqlite')
+        gdal.RmdirRecursive('/vsimem/out_sort')
+
+
+###############################################################################
+# Test I/O errors on the temporary file of the external sort
+
+
+def test_ogr_mvt_write_external_sort_errors():
+
+    if not ogrtest.have_geos():
+        pytest.skip()
+
+    def create(filename):
+        ds = ogr.GetDriverByName('MVT').CreateDataSource(filename, options=['MAXZOOM=3'])
+        lyr = ds.CreateLayer('test')
+        ret = ogr.OGRERR_NONE
+        for i in range(200):
+            f = ogr.Feature(lyr.GetLayerDefn())
+            f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (i * 10000, i * 5000)))
+            if lyr.CreateFeature(f) != ogr.OGRERR_NONE:
+                ret = ogr.OGRERR_FAILURE
+        return ds, ret
+
+    options = {'GDAL_NUM_THREADS': '1', 'OGR_MVT_SORT_RUN_SIZE': '1000'}
+
+    # Failure when writing a run: the temporary file cannot grow beyond
+    # 1000 bytes
+    gdal.FileFromMemBuffer('/vsimem/sort_backing', '')
+    with gdaltest.config_options(dict(options, OGR_MVT_SORT_TEMP_FILE='/vsisubfile/0_1000,/vsimem/sort_backing')):
+        with gdaltest.error_handler():
+            ds, ret = create('/vsimem/out')
+            msg = gdal.GetLastErrorMsg()
+            ds = None
+    assert ret != ogr.OGRERR_NONE
+    assert msg.startswith('Failure writing')
+    gdal.Unlink('/vsimem/sort_backing')
+    gdal.RmdirRecursive('/vsimem/out')
+
+    # Failure when reading a run: corrupt the size of the first feature of
+    # the first run (read when starting the merge), then of its second
+    # feature (read during the merge)
+    for record_idx in (0, 1):
+        with gdaltest.config_options(dict(options, OGR_MVT_REMOVE_TEMP_FILE='NO')):
+            ds, ret = create('/vsimem/out')
+        assert ret == ogr.OGRERR_NONE
+
+        f = gdal.VSIFOpenL('/vsimem/out.temp.sort', 'rb+')
+        offset = 0
+        for _ in range(record_idx):
+            gdal.VSIFSeekL(f, offset + 40, 0)
+            offset += 44 + struct.unpack('=I', gdal.VSIFReadL(1, 4, f))[0]
+        gdal.VSIFSeekL(f, offset + 40, 0)
+        gdal.VSIFWriteL(struct.pack('=I', 0x7FFFFFFF), 1, 4, f)
+        gdal.VSIFCloseL(f)
+
+        gdal.ErrorReset()
+        with gdaltest.error_handler():
+            ds = None
+        assert gdal.GetLastErrorMsg().startswith('Failure reading'), record_idx
+        assert gdal.VSIStatL('/vsimem/out.temp.sort') is None
+
+        gdal.RmdirRecursive('/vsimem/out')
+
 
 ###############################################################################
 #
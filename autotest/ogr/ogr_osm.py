@@ -30,6 +30,8 @@
 ###############################################################################
 
 import os
+import struct
+import zlib
 from osgeo import ogr
 from osgeo import gdal
 
@@ -833,3 +835,133 @@ def test_ogr_osm_18():
 
 
 
+
+###############################################################################
+# Generate a .pbf file with several compressed data blocks of nodes and ways
+
+
+def _pbf_varint(v):
+    out = bytearray()
+    while True:
+        b = v & 0x7F
+        v >>= 7
+        if v:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return bytes(out)
+
+
+def _pbf_zigzag(v):
+    return (v << 1) ^ (v >> 63)
+
+
+def _pbf_field(num, payload):
+    if isinstance(payload, int):
+        return _pbf_varint(num << 3) + _pbf_varint(payload)
+    return _pbf_varint((num << 3) | 2) + _pbf_varint(len(payload)) + payload
+
+
+def _pbf_packed(values):
+    return b''.join(_pbf_varint(v) for v in values)
+
+
+def _pbf_blob(blob_type, data):
+    blob = _pbf_field(2, len(data)) + _pbf_field(3, zlib.compress(data))
+    header = _pbf_field(1, blob_type) + _pbf_field(3, len(blob))
+    return struct.pack('>I', len(header)) + header + blob
+
+
+def _pbf_primitive_block(strings, group):
+    stringtable = b''.join(_pbf_field(1, x) for x in [b''] + strings)
+    return _pbf_field(1, stringtable) + _pbf_field(2, group)
+
+
+def generate_pbf_with_many_blocks(nodes_per_block, node_blocks, way_blocks):
+
+    out = _pbf_blob(b'OSMHeader', _pbf_field(4, b'OsmSchema-V0.6'))
+
+    # Nodes on a grid, every 10th one with a name tag
+    strings = [b'name', b'highway', b'residential', b'building', b'yes']
+    node_id = 1
+    for _ in range(node_blocks):
+        group = b''
+        for _ in range(nodes_per_block):
+            node = _pbf_field(1, _pbf_zigzag(node_id))
+            if node_id % 10 == 0:
+                strings.append(('node%d' % node_id).encode('ascii'))
+                node += _pbf_field(2, _pbf_packed([1]))
+                node += _pbf_field(3, _pbf_packed([len(strings)]))
+            node += _pbf_field(8, _pbf_zigzag((node_id % 100) * 1000000))
+            node += _pbf_field(9, _pbf_zigzag((node_id // 100) * 1000000))
+            group += _pbf_field(1, node)
+            node_id += 1
+        out += _pbf_blob(b'OSMData', _pbf_primitive_block(strings, group))
+        strings = strings[0:5]
+
+    # Open ways, and every 5th one a closed building
+    nodes = nodes_per_block * node_blocks
+    ways_per_block = nodes_per_block // 2
+    way_id = 1
+    for _ in range(way_blocks):
+        group = b''
+        for _ in range(ways_per_block):
+            first = 1 + (way_id * 7) % (nodes - 3)
+            if way_id % 5 == 0:
+                refs = [first, first + 1, first + 2, first]
+                tags = [4, 5]
+            else:
+                refs = [first, first + 1, first + 2]
+                tags = [2, 3]
+            deltas = [_pbf_zigzag(refs[0])] + \
+                [_pbf_zigzag(refs[i] - refs[i - 1]) for i in range(1, len(refs))]
+            way = _pbf_field(1, way_id)
+            way += _pbf_field(2, _pbf_packed(tags[0:1]))
+            way += _pbf_field(3, _pbf_packed(tags[1:2]))
+            way += _pbf_field(8, _pbf_packed(deltas))
+            group += _pbf_field(3, way)
+            way_id += 1
+        out += _pbf_blob(b'OSMData', _pbf_primitive_block(strings, group))
+
+    return out
+
+###############################################################################
+# Test that multi-threaded decoding and way resolution give the same result,
+# in the same order, as single-threaded reading
+
+
+@pytest.mark.parametrize('filename', ['data/test.pbf', '/vsimem/many_blocks.pbf'])
+def test_ogr_osm_num_threads(filename):
+
+    if ogrtest.osm_drv is None:
+        pytest.skip()
+
+    if filename.startswith('/vsimem/'):
+        # More blocks than worker threads, so that they are decoded by
+        # several waves
+        gdal.FileFromMemBuffer(filename,
+                               generate_pbf_with_many_blocks(200, 6, 6))
+
+    def get_features(num_threads):
+        # Resolve the nodes of ways with threads even for small batches
+        with gdaltest.config_options({'GDAL_NUM_THREADS': num_threads,
+                                      'OSM_MIN_WAYS_FOR_THREADED_RESOLUTION': '2'}):
+            ds = gdal.OpenEx(filename)
+            ret = []
+            while True:
+                f, lyr = ds.GetNextFeature()
+                if f is None:
+                    break
+                ret.append((lyr.GetName(), f.GetFID(), f.DumpReadableAsString()))
+            ds = None
+        return ret
+
+    ref = get_features('1')
+    assert ref
+    if filename.startswith('/vsimem/'):
+        assert len([x for x in ref if x[0] == 'lines']) == 480
+        assert len([x for x in ref if x[0] == 'multipolygons']) == 120
+    assert get_features('4') == ref
+
+    if filename.startswith('/vsimem/'):
+        gdal.Unlink(filename)
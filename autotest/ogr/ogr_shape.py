@@ -4819,6 +4819,117 @@ def test_ogr_shape_ldid_and_cpg():
     gdal.Unlink('/vsimem/tmp.cpg')
 
 ###############################################################################
+# Test batched reading, with and without worker threads
+
+
+@pytest.mark.parametrize('num_threads', ['1', '4'])
+def test_ogr_shape_batched_reading(num_threads):
+
+    for ext in ('shp', 'shx', 'dbf'):
+        gdal.FileFromMemBuffer('/vsimem/ogr_shape_batched.' + ext,
+                               open('data/poly.' + ext, 'rb').read())
+    ds = gdal.OpenEx('/vsimem/ogr_shape_batched.shp', gdal.OF_UPDATE,
+                     open_options=['AUTO_REPACK=NO'])
+    ds.GetLayer(0).DeleteFeature(3)
+    ds = None
+
+    def read_features(lyr):
+        return [(f.GetFID(), f.GetField('EAS_ID'),
+                 f.GetGeometryRef().ExportToWkt()) for f in lyr]
+
+    def read_all(open_options):
+        ds = gdal.OpenEx('/vsimem/ogr_shape_batched.shp',
+                         open_options=open_options)
+        lyr = ds.GetLayer(0)
+        ret = [read_features(lyr)]
+        lyr.SetSpatialFilterRect(479750, 4764000, 480500, 4765000)
+        ret.append(read_features(lyr))
+        lyr.SetSpatialFilter(None)
+        lyr.SetAttributeFilter('EAS_ID > 170')
+        ret.append(read_features(lyr))
+        return ret
+
+    with gdaltest.config_option('SHAPE_READ_CHUNK_SIZE', '0'):
+        expected = read_all([])
+    assert len(expected[0]) == 9
+    assert 3 not in [fid for fid, _, _ in expected[0]]
+
+    # Small chunks so that features are read by several batches
+    with gdaltest.config_option('SHAPE_READ_CHUNK_SIZE', '500'):
+        got = read_all(['NUM_THREADS=' + num_threads])
+    assert got == expected
+
+    gdal.Unlink('/vsimem/ogr_shape_batched.shp')
+    gdal.Unlink('/vsimem/ogr_shape_batched.shx')
+    gdal.Unlink('/vsimem/ogr_shape_batched.dbf')
+
+###############################################################################
+# Test that buffered writing produces the same files as unbuffered writing
+
+
+@pytest.mark.parametrize('buffer_size', ['1', '100', None])
+def test_ogr_shape_buffered_writing(buffer_size):
+
+    def write(dirname):
+        ds = ogr.GetDriverByName('ESRI Shapefile').CreateDataSource(dirname)
+        lyr = ds.CreateLayer('test', geom_type=ogr.wkbLineString,
+                             options=['ENCODING=ISO-8859-1'])
+        fld_defn = ogr.FieldDefn('str', ogr.OFTString)
+        fld_defn.SetWidth(5)
+        lyr.CreateField(fld_defn)
+        lyr.CreateField(ogr.FieldDefn('int', ogr.OFTInteger))
+        fld_defn = ogr.FieldDefn('real', ogr.OFTReal)
+        fld_defn.SetWidth(10)
+        fld_defn.SetPrecision(3)
+        lyr.CreateField(fld_defn)
+        lyr.CreateField(ogr.FieldDefn('date', ogr.OFTDate))
+        for i in range(100):
+            f = ogr.Feature(lyr.GetLayerDefn())
+            if i % 10 != 0:
+                # Field 'str' is extended by features 6 and 51
+                f.SetField('str', ('x' if i % 2 else '\u00e9') * (i % 7) if i != 51 else 'x' * 20)
+                f.SetField('int', i * 1000 - 12345)
+                f.SetField('real', (i - 50) / 3.0)
+                f.SetField('date', '2019/12/%02d' % (i % 28 + 1))
+            f.SetGeometry(ogr.CreateGeometryFromWkt(
+                'LINESTRING (%d 0,%d %d)' % (i, i + 1, i % 13)))
+            lyr.CreateFeature(f)
+            if i == 60:
+                # Interleave reads and updates of previous features
+                f = lyr.GetFeature(25)
+                f.SetField('str', 'y')
+                lyr.SetFeature(f)
+                lyr.DeleteFeature(30)
+        ds = None
+
+        ret = []
+        for ext in ('shp', 'shx', 'dbf'):
+            f = gdal.VSIFOpenL(dirname + '/test.' + ext, 'rb')
+            ret.append(gdal.VSIFReadL(1, 100000, f))
+            gdal.VSIFCloseL(f)
+        return ret
+
+    # Reference written without buffering, and with one
+    # DBFWriteXXXAttribute() call per field
+    with gdaltest.config_options({'SHAPE_WRITE_BUFFER_SIZE': '0',
+                                  'SHAPE_WRITE_WHOLE_DBF_RECORD': 'NO'}):
+        expected = write('/vsimem/ogr_shape_buffered_writing_ref')
+    with gdaltest.config_option('SHAPE_WRITE_BUFFER_SIZE', buffer_size):
+        got = write('/vsimem/ogr_shape_buffered_writing')
+    assert got == expected
+
+    ds = ogr.Open('/vsimem/ogr_shape_buffered_writing')
+    lyr = ds.GetLayer(0)
+    assert lyr.GetFeatureCount() == 99
+    values = [f['str'] for f in lyr]
+    assert values.count('x' * 20) == 1
+    assert values.count('\u00e9' * 6) == 5
+    ds = None
+
+    gdal.RmdirRecursive('/vsimem/ogr_shape_buffered_writing_ref')
+    gdal.RmdirRecursive('/vsimem/ogr_shape_buffered_writing')
+
+###############################################################################
 
 
 def test_ogr_shape_cleanup():
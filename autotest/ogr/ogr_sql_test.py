@@ -1407,6 +1407,75 @@ def test_ogr_sql_48():
     assert i == 1001
 
 
+###############################################################################
+# Test that the compiled evaluation of WHERE clauses gives the same results
+# as the generic expression evaluator
+
+
+@pytest.mark.parametrize("where", [
+    "int_field = 3",
+    "int_field <> 3",
+    "int_field >= 3 AND int_field < 7",
+    "int_field BETWEEN 2 AND 5",
+    "int_field IN (1, 3, 5, 7, 9, 11, 13, 15, 17, 19)",
+    "int_field IN (1, 3)",
+    "int_field = 3.0",
+    "int_field > 2.5",
+    "int64_field > 1234567890123",
+    "int64_field IN (1234567890124, 0)",
+    "real_field < 4.5",
+    "real_field IN (1.5, 2.5)",
+    "real_field BETWEEN 1 AND 3",
+    "str_field = 'FOO'",
+    "str_field <> 'foo'",
+    "str_field > 'bar'",
+    "str_field IN ('foo', 'baz')",
+    "str_field BETWEEN 'a' AND 'c'",
+    "str_field IS NULL",
+    "str_field IS NOT NULL",
+    "NOT (int_field = 3 OR str_field = 'foo')",
+    "int_field = 3 OR (real_field > 2 AND NOT str_field = 'baz')",
+    "FID = 2",
+    "FID IN (0, 4)",
+    "int_field * 2 = 6",
+    "str_field LIKE 'f%'",
+])
+def test_ogr_sql_compiled_where(where):
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('test', geom_type=ogr.wkbNone)
+    lyr.CreateField(ogr.FieldDefn('int_field', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('int64_field', ogr.OFTInteger64))
+    lyr.CreateField(ogr.FieldDefn('real_field', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('str_field', ogr.OFTString))
+    strings = ['foo', 'bar', None, 'baz', 'FOO']
+    for i in range(10):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if i != 6:
+            f['int_field'] = i
+        f['int64_field'] = 1234567890120 + i
+        f['real_field'] = i * 0.5 + 0.5
+        if strings[i % 5] is not None:
+            f['str_field'] = strings[i % 5]
+        lyr.CreateFeature(f)
+    f = ogr.Feature(lyr.GetLayerDefn())
+    f.SetFieldNull('int_field')
+    f.SetFieldNull('str_field')
+    lyr.CreateFeature(f)
+
+    def get_fids():
+        assert lyr.SetAttributeFilter(where) == 0
+        return [f.GetFID() for f in lyr]
+
+    got = get_fids()
+    # Evaluated with OGRFeatureQuery::EvaluateBatch()
+    assert lyr.GetFeatureCount() == len(got)
+    with gdaltest.config_option('OGR_SQL_COMPILE_WHERE', 'NO'):
+        expected = get_fids()
+        assert lyr.GetFeatureCount() == len(expected)
+    assert got == expected
+
+
 def test_ogr_sql_cleanup():
     gdaltest.lyr = None
     gdaltest.ds = None
@@ -4487,6 +4487,16 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
     const bool bExplodeCollections = m_bExplodeCollections && nDstGeomFieldCount <= 1;
     const int iRequestedSrcGeomField = psInfo->m_iRequestedSrcGeomField;
 
+    // Whether geometries are copied without being modified (except for a
+    // reprojection, checked per feature), in which case a geometry whose
+    // instantiation has been deferred by the source driver (see
+    // OGRFeature::SetGeomFieldLazyWKB()) is passed as it is to the target.
+    const bool bGeomCanBePassedThrough =
+        !bExplodeCollections && iSrcZField == -1 &&
+        m_nCoordDim == COORD_DIM_UNCHANGED && m_eGeomOp == GEOMOP_NONE &&
+        m_poClipSrc == nullptr && m_poClipDst == nullptr &&
+        eGType == GEOMTYPE_UNCHANGED && m_eGeomTypeConversion == GTC_DEFAULT;
+
     if( poOutputSRS == nullptr && !m_bNullifyOutputSRS )
     {
         if( nSrcGeomFieldCount == 1 )
@@ -4613,12 +4623,18 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
 
             /* Optimization to avoid duplicating the source geometry in the */
             /* target feature : we steal it from the source feature for now... */
+            /* (unless it is a lazy geometry that SetFrom() can copy without */
+            /* instantiating it) */
             OGRGeometry* poStolenGeometry = nullptr;
             if( !bExplodeCollections && nSrcGeomFieldCount == 1 &&
                 (nDstGeomFieldCount == 1 ||
                  (nDstGeomFieldCount == 0 && m_poClipSrc)) )
             {
-                poStolenGeometry = poFeature->StealGeometry();
+                if( !(bGeomCanBePassedThrough &&
+                      poFeature->GetGeomFieldLazyWKB(0, nullptr) != nullptr) )
+                {
+                    poStolenGeometry = poFeature->StealGeometry();
+                }
             }
             else if( !bExplodeCollections &&
                      iRequestedSrcGeomField >= 0 )
@@ -4698,6 +4714,13 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
                 }
                 else
                 {
+                    if( bGeomCanBePassedThrough &&
+                        psInfo->m_apoCT[iGeom] == nullptr &&
+                        psInfo->m_aosTransformOptions[iGeom].List() == nullptr &&
+                        poDstFeature->GetGeomFieldLazyWKB(iGeom, nullptr) != nullptr )
+                    {
+                        continue;
+                    }
                     poDstGeometry = poDstFeature->StealGeometry(iGeom);
                     if (poDstGeometry == nullptr)
                         continue;
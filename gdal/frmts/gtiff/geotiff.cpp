@@ -307,6 +307,7 @@ private:
     CPLVirtualMem        *m_pBaseMapping = nullptr;
     GByte                *m_pTempBufferForCommonDirectIO = nullptr;
     CPLVirtualMem        *m_psVirtualMemIOMapping = nullptr;
+    VSIMappedRegion      *m_psMappedFile = nullptr;
     CPLWorkerThreadPool  *m_poCompressThreadPool = nullptr;
     CPLMutex             *m_hCompressThreadPoolMutex = nullptr;
 
@@ -442,11 +443,15 @@ private:
     bool        m_bWriteKnownIncompatibleEdition:1;
     bool        m_bHasUsedReadEncodedAPI:1; // for debugging
     bool        m_bWriteCOGLayout:1;
+    bool        m_bMappedFileTried:1;
+    bool        m_bMappedStrileChecked:1;
+    bool        m_bCanUseMappedStrile:1;
 
     void        ScanDirectories();
     bool        ReadStrile(int nBlockId,
                            void* pOutputBuffer, GPtrDiff_t nBlockReqSize);
     CPLErr      LoadBlockBuf( int nBlockId, bool bReadFromDisk = true );
+    const GByte *GetMappedStrile( int nBlockId, GPtrDiff_t nBlockReqSize );
     CPLErr      FlushBlockBuf();
 
     void        LoadMDAreaOrPoint();
@@ -4755,6 +4760,66 @@ bool GTiffDataset::ReadStrile(int nBlockId,
     return true;
 }
 
+/************************************************************************/
+/*                          GetMappedStrile()                           */
+/*                                                                      */
+/*      Return a pointer to the content of an uncompressed strile in    */
+/*      a zero-copy view of the file, or nullptr if this is not         */
+/*      possible and the strile must be read through libtiff.           */
+/************************************************************************/
+
+const GByte *GTiffDataset::GetMappedStrile( int nBlockId,
+                                            GPtrDiff_t nBlockReqSize )
+{
+    // The mapping of the whole file is owned by the root dataset, while
+    // the layout checks are done per IFD.
+    GTiffDataset* poRootDS = m_poBaseDS ? m_poBaseDS : this;
+    if( !m_bMappedStrileChecked )
+    {
+        m_bMappedStrileChecked = true;
+
+        // libtiff would apply bit reversal and byte swapping after reading.
+        uint16 nFillOrder = 0;
+        if( eAccess != GA_ReadOnly || m_bStreamingIn ||
+            m_nCompression != COMPRESSION_NONE ||
+            (m_nBitsPerSample % 8) != 0 ||
+            (m_nBitsPerSample != 8 && TIFFIsByteSwapped(m_hTIFF)) ||
+            !TIFFGetFieldDefaulted(m_hTIFF, TIFFTAG_FILLORDER, &nFillOrder) ||
+            nFillOrder != FILLORDER_MSB2LSB )
+        {
+            return nullptr;
+        }
+        if( !poRootDS->m_bMappedFileTried )
+        {
+            poRootDS->m_bMappedFileTried = true;
+            poRootDS->m_psMappedFile = VSIFMapRegionL(
+                VSI_TIFFGetVSILFile(TIFFClientdata( m_hTIFF )), 0, 0,
+                VSI_MAP_REGION_ZERO_COPY_ONLY);
+            if( poRootDS->m_psMappedFile )
+                CPLDebug("GTiff", "Using zero-copy read path");
+        }
+        m_bCanUseMappedStrile = poRootDS->m_psMappedFile != nullptr;
+    }
+    if( !m_bCanUseMappedStrile )
+        return nullptr;
+
+    vsi_l_offset nOffset = 0;
+    vsi_l_offset nSize = 0;
+    if( !IsBlockAvailable(nBlockId, &nOffset, &nSize) ||
+        nSize < static_cast<vsi_l_offset>(nBlockReqSize) )
+    {
+        return nullptr;
+    }
+    const size_t nMappedSize = VSIMappedRegionGetSize(poRootDS->m_psMappedFile);
+    if( nOffset > nMappedSize ||
+        static_cast<size_t>(nBlockReqSize) > nMappedSize - nOffset )
+    {
+        return nullptr;
+    }
+    return static_cast<const GByte *>(
+        VSIMappedRegionGetData(poRootDS->m_psMappedFile)) + nOffset;
+}
+
 /************************************************************************/
 /*                             IReadBlock()                             */
 /************************************************************************/
@@ -4848,24 +4913,52 @@ CPLErr GTiffRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
     }
     else
     {
+        const int nWordBytes = m_poGDS->m_nBitsPerSample / 8;
+        const GPtrDiff_t nBlockPixels =
+            static_cast<GPtrDiff_t>(nBlockXSize) * nBlockYSize;
+
 /* -------------------------------------------------------------------- */
-/*      Load desired block                                              */
+/*      For uncompressed data, deinterleave directly from the file      */
+/*      content when it is mapped, rather than through the block        */
+/*      buffer.                                                         */
 /* -------------------------------------------------------------------- */
-        eErr = m_poGDS->LoadBlockBuf( nBlockId );
-        if( eErr != CE_None )
+        const GByte* pabyMapped = nullptr;
+        if( nBlockId != m_poGDS->m_nLoadedBlock )
+            pabyMapped = m_poGDS->GetMappedStrile(nBlockId, nBlockReqSize);
+        if( pabyMapped != nullptr )
         {
-            memset( pImage, 0,
-                    static_cast<GPtrDiff_t>(nBlockXSize) * nBlockYSize
-                    * GDALGetDataTypeSizeBytes(eDataType) );
-            return eErr;
+            const GPtrDiff_t nValues = std::min(nBlockPixels,
+                nBlockReqSize / (m_poGDS->nBands * nWordBytes));
+            GDALCopyWords64(pabyMapped + (nBand - 1) * nWordBytes, eDataType,
+                            m_poGDS->nBands * nWordBytes,
+                            pImage, eDataType, nWordBytes,
+                            nValues);
+            if( nValues < nBlockPixels )
+            {
+                memset( static_cast<GByte*>(pImage) + nValues * nWordBytes,
+                        0, (nBlockPixels - nValues) * nWordBytes );
+            }
         }
+        else
+        {
+/* -------------------------------------------------------------------- */
+/*      Load desired block                                              */
+/* -------------------------------------------------------------------- */
+            eErr = m_poGDS->LoadBlockBuf( nBlockId );
+            if( eErr != CE_None )
+            {
+                memset( pImage, 0,
+                        nBlockPixels * GDALGetDataTypeSizeBytes(eDataType) );
+                return eErr;
+            }
 
-        const int nWordBytes = m_poGDS->m_nBitsPerSample / 8;
-        GByte* pabyImage = m_poGDS->m_pabyBlockBuf + (nBand - 1) * nWordBytes;
+            GByte* pabyImage =
+                m_poGDS->m_pabyBlockBuf + (nBand - 1) * nWordBytes;
 
-        GDALCopyWords64(pabyImage, eDataType, m_poGDS->nBands * nWordBytes,
-                    pImage, eDataType, nWordBytes,
-                    static_cast<GPtrDiff_t>(nBlockXSize) * nBlockYSize);
+            GDALCopyWords64(pabyImage, eDataType, m_poGDS->nBands * nWordBytes,
+                        pImage, eDataType, nWordBytes,
+                        nBlockPixels);
+        }
 
         eErr = FillCacheForOtherBands(nBlockXOff, nBlockYOff);
     }
@@ -7689,7 +7782,10 @@ GTiffDataset::GTiffDataset():
     m_bKnownIncompatibleEdition(false),
     m_bWriteKnownIncompatibleEdition(false),
     m_bHasUsedReadEncodedAPI(false),
-    m_bWriteCOGLayout(false)
+    m_bWriteCOGLayout(false),
+    m_bMappedFileTried(false),
+    m_bMappedStrileChecked(false),
+    m_bCanUseMappedStrile(false)
 {
     //CPLDebug("GDAL", "sizeof(GTiffDataset) = %d bytes", static_cast<int>(
     //    sizeof(GTiffDataset)));
@@ -7858,6 +7954,10 @@ int GTiffDataset::Finalize()
         m_hTIFF = nullptr;
     }
 
+    if( m_psMappedFile )
+        VSIMappedRegionFree( m_psMappedFile );
+    m_psMappedFile = nullptr;
+
     if( m_bBase || m_bCloseFile )
     {
         if( m_fpL != nullptr )
@@ -121,6 +121,11 @@ class MBTilesDataset final: public GDALPamDataset, public GDALGPKGMBTilesLikePse
                         int nOverviews, int * panOverviewList,
                         int nBandsIn, CPL_UNUSED int * panBandList,
                         GDALProgressFunc pfnProgress, void * pProgressData ) override;
+    virtual CPLErr    IRasterIO( GDALRWFlag, int, int, int, int,
+                                 void *, int, int, GDALDataType,
+                                 int, int *,
+                                 GSpacing, GSpacing, GSpacing,
+                                 GDALRasterIOExtraArg* psExtraArg ) override;
 
     virtual int                 GetLayerCount() override
                         { return static_cast<int>(m_apoLayers.size()); }
@@ -2827,6 +2832,8 @@ GDALDataset* MBTilesDataset::Open(GDALOpenInfo* poOpenInfo)
             poDS->ParseCompressionOptions(poOpenInfo->papszOpenOptions);
         }
 
+        poDS->InitWorkerThreadPool(poOpenInfo->papszOpenOptions);
+
 /* -------------------------------------------------------------------- */
 /*      Add overview levels as internal datasets                        */
 /* -------------------------------------------------------------------- */
@@ -3031,6 +3038,7 @@ bool MBTilesDataset::CreateInternal( const char * pszFilename,
         SetBand( i, new MBTilesBand(this, nBlockSize) );
 
     ParseCompressionOptions(papszOptions);
+    InitWorkerThreadPool(papszOptions);
 
     return true;
 }
@@ -3363,6 +3371,31 @@ void MBTilesDataset::ParseCompressionOptions(char** papszOptions)
         m_bDither = CPLTestBool(pszDither);
 }
 
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr MBTilesDataset::IRasterIO( GDALRWFlag eRWFlag,
+                                  int nXOff, int nYOff, int nXSize, int nYSize,
+                                  void * pData, int nBufXSize, int nBufYSize,
+                                  GDALDataType eBufType,
+                                  int nBandCount, int *panBandMap,
+                                  GSpacing nPixelSpace, GSpacing nLineSpace,
+                                  GSpacing nBandSpace,
+                                  GDALRasterIOExtraArg* psExtraArg )
+{
+    if( eRWFlag == GF_Read )
+    {
+        DecodeTilesConcurrently(nXOff, nYOff, nXSize, nYSize,
+                                nBufXSize, nBufYSize);
+    }
+    return GDALPamDataset::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                     pData, nBufXSize, nBufYSize, eBufType,
+                                     nBandCount, panBandMap,
+                                     nPixelSpace, nLineSpace, nBandSpace,
+                                     psExtraArg);
+}
+
 /************************************************************************/
 /*                          IBuildOverviews()                           */
 /************************************************************************/
@@ -3556,6 +3589,7 @@ void GDALRegister_MBTiles()
 "  <Option name='QUALITY' scope='raster' type='int' min='1' max='100' description='Quality for JPEG tiles' default='75'/>" \
 "  <Option name='ZLEVEL' scope='raster' type='int' min='1' max='9' description='DEFLATE compression level for PNG tiles' default='6'/>" \
 "  <Option name='DITHER' scope='raster' type='boolean' description='Whether to apply Floyd-Steinberg dithering (for TILE_FORMAT=PNG8)' default='NO'/>" \
+"  <Option name='NUM_THREADS' scope='raster' type='string' description='Number of worker threads for tile compression and decompression. Can be set to ALL_CPUS' default='1'/>" \
 
     poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST, "<OpenOptionList>"
 "  <Option name='ZOOM_LEVEL' scope='raster,vector' type='integer' description='Zoom level of full resolution. If not specified, maximum non-empty zoom level'/>"
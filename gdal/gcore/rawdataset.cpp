@@ -302,6 +302,8 @@ RawRasterBand::~RawRasterBand()
 
     RawRasterBand::FlushCache();
 
+    ReleaseMappedRegion();
+
     if (bOwnsFP)
     {
         if( VSIFCloseL(fpRawL) != 0 )
@@ -317,7 +319,12 @@ RawRasterBand::~RawRasterBand()
 /*                             SetAccess()                              */
 /************************************************************************/
 
-void RawRasterBand::SetAccess(GDALAccess eAccessIn) { eAccess = eAccessIn; }
+void RawRasterBand::SetAccess(GDALAccess eAccessIn)
+{
+    eAccess = eAccessIn;
+    if( eAccess != GA_ReadOnly )
+        ReleaseMappedRegion();
+}
 
 /************************************************************************/
 /*                             FlushCache()                             */
@@ -441,36 +448,122 @@ void RawRasterBand::DoByteSwap(void* pBuffer, size_t nValues, bool bDiskToCPU) c
 }
 
 /************************************************************************/
-/*                             AccessLine()                             */
+/*                         ComputeLineOffset()                          */
+/*                                                                      */
+/*      Return the file offset of the lowest addressed byte of a line.  */
 /************************************************************************/
 
-CPLErr RawRasterBand::AccessLine( int iLine )
-
+vsi_l_offset RawRasterBand::ComputeLineOffset( int iLine ) const
 {
-    if (pLineBuffer == nullptr)
-        return CE_Failure;
-
-    if( nLoadedScanline == iLine )
-        return CE_None;
-
-    // Figure out where to start reading.
     // Write formulas such that unsigned int overflow doesn't occur
-    vsi_l_offset nReadStart = nImgOffset;
+    vsi_l_offset nLineStart = nImgOffset;
     if( nLineOffset >= 0 )
     {
-        nReadStart += static_cast<GUIntBig>(nLineOffset) * iLine;
+        nLineStart += static_cast<GUIntBig>(nLineOffset) * iLine;
     }
     else
     {
-        nReadStart -= static_cast<GUIntBig>(-static_cast<GIntBig>(nLineOffset)) * iLine;
+        nLineStart -= static_cast<GUIntBig>(-static_cast<GIntBig>(nLineOffset)) * iLine;
     }
     if( nPixelOffset < 0 )
     {
         const GUIntBig nPixelOffsetToSubtract =
             static_cast<GUIntBig>(-static_cast<GIntBig>(nPixelOffset)) * (nBlockXSize - 1);
-        nReadStart -= nPixelOffsetToSubtract;
+        nLineStart -= nPixelOffsetToSubtract;
+    }
+    return nLineStart;
+}
+
+/************************************************************************/
+/*                           GetMappedData()                            */
+/*                                                                      */
+/*      Return a pointer to the file content at nOffset when the band   */
+/*      extent could be mapped without copy (see VSIFMapRegionL()),     */
+/*      or nullptr when the regular read path must be used.             */
+/************************************************************************/
+
+const GByte *RawRasterBand::GetMappedData( vsi_l_offset nOffset, size_t nSize )
+{
+    if( !m_bMappedRegionTried )
+    {
+        m_bMappedRegionTried = true;
+
+        // Byte swapping is done in place on the line buffer, so only
+        // native order data can be served from a read-only view.
+        if( pLineBuffer == nullptr ||
+            eAccess != GA_ReadOnly ||
+            (poDS != nullptr && poDS->GetAccess() != GA_ReadOnly) ||
+            NeedsByteOrderChange() )
+        {
+            return nullptr;
+        }
+
+        const vsi_l_offset nStart =
+            ComputeLineOffset(nLineOffset >= 0 ? 0 : nRasterYSize - 1);
+        const vsi_l_offset nEnd =
+            ComputeLineOffset(nLineOffset >= 0 ? nRasterYSize - 1 : 0) +
+            nLineSize;
+        if( nEnd - nStart >
+                static_cast<vsi_l_offset>(std::numeric_limits<size_t>::max()) )
+        {
+            return nullptr;
+        }
+
+        // Will fail if the file is shorter than the band extent (e.g.
+        // sparse ENVI files), in which case AccessLine() deals with it.
+        m_psMappedRegion =
+            VSIFMapRegionL(fpRawL, nStart, static_cast<size_t>(nEnd - nStart),
+                           VSI_MAP_REGION_ZERO_COPY_ONLY);
+        if( m_psMappedRegion == nullptr )
+            return nullptr;
+        m_nMappedRegionOffset = nStart;
+        CPLDebug("GDALRaw", "Using zero-copy read path");
+    }
+
+    if( m_psMappedRegion == nullptr ||
+        nOffset < m_nMappedRegionOffset ||
+        nSize > VSIMappedRegionGetSize(m_psMappedRegion) ||
+        nOffset - m_nMappedRegionOffset >
+            VSIMappedRegionGetSize(m_psMappedRegion) - nSize )
+    {
+        return nullptr;
     }
 
+    return static_cast<const GByte *>(
+               VSIMappedRegionGetData(m_psMappedRegion)) +
+           static_cast<size_t>(nOffset - m_nMappedRegionOffset);
+}
+
+/************************************************************************/
+/*                        ReleaseMappedRegion()                         */
+/************************************************************************/
+
+void RawRasterBand::ReleaseMappedRegion()
+{
+    if( m_psMappedRegion != nullptr )
+    {
+        VSIMappedRegionFree(m_psMappedRegion);
+        m_psMappedRegion = nullptr;
+    }
+    m_bMappedRegionTried = false;
+}
+
+/************************************************************************/
+/*                             AccessLine()                             */
+/************************************************************************/
+
+CPLErr RawRasterBand::AccessLine( int iLine )
+
+{
+    if (pLineBuffer == nullptr)
+        return CE_Failure;
+
+    if( nLoadedScanline == iLine )
+        return CE_None;
+
+    // Figure out where to start reading.
+    const vsi_l_offset nReadStart = ComputeLineOffset(iLine);
+
     // Seek to the correct line.
     if( Seek(nReadStart, SEEK_SET) == -1 )
     {
@@ -536,6 +629,21 @@ CPLErr RawRasterBand::IReadBlock(CPL_UNUSED int nBlockXOff,
     if (pLineBuffer == nullptr)
         return CE_Failure;
 
+    // Copy directly from the file content when it is mapped, to avoid
+    // going through the line buffer.
+    const GByte* pabyMapped =
+        GetMappedData(ComputeLineOffset(nBlockYOff), nLineSize);
+    if( pabyMapped != nullptr )
+    {
+        if( nPixelOffset < 0 )
+            pabyMapped += static_cast<std::ptrdiff_t>(
+                std::abs(nPixelOffset)) * (nBlockXSize - 1);
+        GDALCopyWords(pabyMapped, eDataType, nPixelOffset,
+                      pImage, eDataType, GDALGetDataTypeSizeBytes(eDataType),
+                      nBlockXSize);
+        return CE_None;
+    }
+
     const CPLErr eErr = AccessLine(nBlockYOff);
     if( eErr == CE_Failure )
         return eErr;
@@ -829,22 +937,27 @@ CPLErr RawRasterBand::IRasterIO( GDALRWFlag eRWFlag,
                     nOffset += nXOff * nPixelOffset;
                 else
                     nOffset -= nXOff * static_cast<vsi_l_offset>(-nPixelOffset);
-                if ( AccessBlock(nOffset,
-                                 nBytesToRW, pabyData) != CE_None )
+                const GByte* pabySrc = GetMappedData(nOffset, nBytesToRW);
+                if( pabySrc == nullptr )
                 {
-                    CPLError(CE_Failure, CPLE_FileIO,
-                             "Failed to read " CPL_FRMT_GUIB
-                             " bytes at " CPL_FRMT_GUIB ".",
-                             static_cast<GUIntBig>(nBytesToRW), nOffset);
-                    CPLFree(pabyData);
-                    return CE_Failure;
+                    if ( AccessBlock(nOffset,
+                                     nBytesToRW, pabyData) != CE_None )
+                    {
+                        CPLError(CE_Failure, CPLE_FileIO,
+                                 "Failed to read " CPL_FRMT_GUIB
+                                 " bytes at " CPL_FRMT_GUIB ".",
+                                 static_cast<GUIntBig>(nBytesToRW), nOffset);
+                        CPLFree(pabyData);
+                        return CE_Failure;
+                    }
+                    pabySrc = pabyData;
                 }
                 // Copy data from disk buffer to user block buffer and
                 // subsample, if needed.
                 if ( nXSize == nBufXSize && nYSize == nBufYSize )
                 {
                     GDALCopyWords(
-                        pabyData, eDataType, nPixelOffset,
+                        pabySrc, eDataType, nPixelOffset,
                         static_cast<GByte *>(pData) +
                             static_cast<vsi_l_offset>(iLine) * nLineSpace,
                         eBufType, static_cast<int>(nPixelSpace), nXSize);
@@ -854,7 +967,7 @@ CPLErr RawRasterBand::IRasterIO( GDALRWFlag eRWFlag,
                     for ( int iPixel = 0; iPixel < nBufXSize; iPixel++ )
                     {
                         GDALCopyWords(
-                            pabyData +
+                            pabySrc +
                                 static_cast<vsi_l_offset>(iPixel * dfSrcXInc) *
                                     nPixelOffset,
                             eDataType, nPixelOffset,
@@ -203,8 +203,16 @@ public:
   private:
     CPL_DISALLOW_COPY_ASSIGN(RawRasterBand)
 
+    // Read-only zero-copy view of the band extent, if available.
+    VSIMappedRegion *m_psMappedRegion = nullptr;
+    vsi_l_offset     m_nMappedRegionOffset = 0;
+    bool             m_bMappedRegionTried = false;
+
     bool         NeedsByteOrderChange() const;
     void         DoByteSwap(void* pBuffer, size_t nValues, bool bDiskToCPU) const;
+    vsi_l_offset ComputeLineOffset( int iLine ) const;
+    const GByte *GetMappedData( vsi_l_offset nOffset, size_t nSize );
+    void         ReleaseMappedRegion();
 };
 
 #ifdef GDAL_COMPILATION
@@ -362,7 +362,18 @@ class CPL_DLL OGRFeature
     char                *m_pszNativeData;
     char                *m_pszNativeMediaType;
 
+//! @cond Doxygen_Suppress
+    struct LazyGeometry;
+    LazyGeometry        *m_pasLazyGeometries = nullptr;
+//! @endcond
+
     bool                SetFieldInternal( int i, OGRField * puValue );
+    bool                IsGeomFieldLazy( int iField ) const;
+    void                MaterializeGeomField( int iField ) const;
+    void                DiscardLazyGeomField( int iField );
+    OGRErr              SetGeomFieldFrom( int iField,
+                                          const OGRFeature* poSrcFeature,
+                                          int iSrcField );
 
   protected:
 //! @cond Doxygen_Suppress
@@ -594,6 +605,17 @@ class CPL_DLL OGRFeature
     OGRErr              SetGeomFieldDirectly( int iField, OGRGeometry * );
     OGRErr              SetGeomField( int iField, const OGRGeometry * );
 
+    OGRErr              SetGeomFieldLazyWKB( int iField,
+                                             const GByte* pabyWKB,
+                                             size_t nWKBSize,
+                                             const OGREnvelope* psEnvelope = nullptr );
+    const GByte*        GetGeomFieldLazyWKB( int iField,
+                                             size_t* pnWKBSize ) const;
+    OGRErr              GetGeomFieldEnvelope( int iField,
+                                              OGREnvelope* psEnvelope ) const;
+    OGRErr              GetGeomFieldEnvelope( int iField,
+                                              OGREnvelope3D* psEnvelope ) const;
+
     OGRFeature         *Clone() const CPL_WARN_UNUSED_RESULT;
     virtual OGRBoolean  Equal( const OGRFeature * poFeature ) const;
 
@@ -800,12 +822,14 @@ inline OGRFeature::ConstFieldIterator end(const OGRFeatureUniquePtr& poFeature)
 class OGRLayer;
 class swq_expr_node;
 class swq_custom_func_registrar;
+class OGRFeatureQueryProgram;
 
 class CPL_DLL OGRFeatureQuery
 {
   private:
     OGRFeatureDefn *poTargetDefn;
     void           *pSWQExpr;
+    OGRFeatureQueryProgram *poProgram;
 
     char      **FieldCollector( void *, char ** );
 
@@ -833,6 +857,8 @@ class CPL_DLL OGRFeatureQuery
                          swq_custom_func_registrar*
                          poCustomFuncRegistrar = nullptr );
     int         Evaluate( OGRFeature * );
+    int         EvaluateBatch( OGRFeature **papoFeatures, int nFeatureCount,
+                               int *pabResults );
 
     GIntBig    *EvaluateAgainstIndices( OGRLayer *, OGRErr * );
 
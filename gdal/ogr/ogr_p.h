@@ -174,6 +174,10 @@ OGRErr OGRReadWKBGeometryType( const unsigned char * pabyData,
                                OGRwkbVariant wkbVariant,
                                OGRwkbGeometryType *eGeometryType );
 
+bool CPL_DLL OGRWKBGetEnvelope( const GByte* pabyWKB, size_t nWKBSize,
+                                OGREnvelope3D& sEnvelope,
+                                bool* pbHasZ = nullptr );
+
 /************************************************************************/
 /*                            Other                                     */
 /************************************************************************/
@@ -182,4 +186,9 @@ void CPL_DLL OGRUpdateFieldType( OGRFieldDefn* poFDefn,
                                  OGRFieldType eNewType,
                                  OGRFieldSubType eNewSubType );
 
+bool CPL_DLL OGRGetFileStamp( const char* pszFilename, GUInt64& nSize,
+                              GInt64& nMTime, GUInt32& nChecksum );
+
+int CPL_DLL OGRGetNumThreads( CSLConstList papszOptions );
+
 #endif /* ndef OGR_P_H_INCLUDED */
@@ -38,8 +38,10 @@
 #include <cstring>
 #include <ctime>
 
+#include <atomic>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <new>
 #include <vector>
 
@@ -58,6 +60,25 @@
 
 CPL_CVSID("$Id$")
 
+/************************************************************************/
+/*                       OGRFeature::LazyGeometry                       */
+/*                                                                      */
+/*      WKB blob of a geometry field whose OGRGeometry has not been     */
+/*      instantiated yet. bPending is cleared, under oMutex, once the   */
+/*      geometry has been stored in papoGeometries, so that const       */
+/*      accessors can instantiate it from several threads.              */
+/************************************************************************/
+
+struct OGRFeature::LazyGeometry
+{
+    GByte       *pabyWKB = nullptr;
+    size_t       nWKBSize = 0;
+    bool         bHasEnvelope = false;
+    OGREnvelope  sEnvelope{};
+    std::atomic<bool> bPending{false};
+    std::mutex   oMutex{};
+};
+
 /************************************************************************/
 /*                             OGRFeature()                             */
 /************************************************************************/
@@ -187,8 +208,11 @@ OGRFeature::~OGRFeature()
         for( int i = 0; i < nGeomFieldCount; i++ )
         {
             delete papoGeometries[i];
+            if( m_pasLazyGeometries )
+                CPLFree(m_pasLazyGeometries[i].pabyWKB);
         }
     }
+    delete[] m_pasLazyGeometries;
 
     poDefn->Release();
 
@@ -500,6 +524,11 @@ OGRGeometry *OGRFeature::StealGeometry()
 {
     if( GetGeomFieldCount() > 0 )
     {
+        if( IsGeomFieldLazy(0) )
+        {
+            MaterializeGeomField(0);
+            DiscardLazyGeomField(0);
+        }
         OGRGeometry *poReturn = papoGeometries[0];
         papoGeometries[0] = nullptr;
         return poReturn;
@@ -528,6 +557,11 @@ OGRGeometry *OGRFeature::StealGeometry( int iGeomField )
 {
     if( iGeomField >= 0 && iGeomField < GetGeomFieldCount() )
     {
+        if( IsGeomFieldLazy(iGeomField) )
+        {
+            MaterializeGeomField(iGeomField);
+            DiscardLazyGeomField(iGeomField);
+        }
         OGRGeometry *poReturn = papoGeometries[iGeomField];
         papoGeometries[iGeomField] = nullptr;
         return poReturn;
@@ -668,8 +702,12 @@ OGRGeometry *OGRFeature::GetGeomFieldRef( int iField )
 {
     if( iField < 0 || iField >= GetGeomFieldCount() )
         return nullptr;
-    else
-        return papoGeometries[iField];
+    if( IsGeomFieldLazy(iField) )
+    {
+        MaterializeGeomField(iField);
+        DiscardLazyGeomField(iField);
+    }
+    return papoGeometries[iField];
 }
 
 /**
@@ -677,6 +715,10 @@ OGRGeometry *OGRFeature::GetGeomFieldRef( int iField )
  *
  * This method is the same as the C function OGR_F_GetGeomFieldRef().
  *
+ * A geometry set with SetGeomFieldLazyWKB() is instantiated on the first
+ * call. This is done under a lock, so that the feature can be read from
+ * several threads.
+ *
  * @param iField geometry field to get.
  *
  * @return pointer to internal feature geometry.  This object should
@@ -688,8 +730,9 @@ const OGRGeometry *OGRFeature::GetGeomFieldRef( int iField ) const
 {
     if( iField < 0 || iField >= GetGeomFieldCount() )
         return nullptr;
-    else
-        return papoGeometries[iField];
+    if( IsGeomFieldLazy(iField) )
+        MaterializeGeomField(iField);
+    return papoGeometries[iField];
 }
 
 /************************************************************************/
@@ -713,7 +756,7 @@ OGRGeometry *OGRFeature::GetGeomFieldRef( const char* pszFName )
     if( iField < 0 )
         return nullptr;
 
-    return papoGeometries[iField];
+    return GetGeomFieldRef(iField);
 }
 
 /**
@@ -732,7 +775,7 @@ const OGRGeometry *OGRFeature::GetGeomFieldRef( const char* pszFName ) const
     if( iField < 0 )
         return nullptr;
 
-    return papoGeometries[iField];
+    return GetGeomFieldRef(iField);
 }
 
 /************************************************************************/
@@ -808,6 +851,8 @@ OGRErr OGRFeature::SetGeomFieldDirectly( int iField, OGRGeometry * poGeomIn )
         return OGRERR_FAILURE;
     }
 
+    DiscardLazyGeomField(iField);
+
     if( papoGeometries[iField] != poGeomIn )
     {
         delete papoGeometries[iField];
@@ -883,6 +928,8 @@ OGRErr OGRFeature::SetGeomField( int iField, const OGRGeometry * poGeomIn )
     if( iField < 0 || iField >= GetGeomFieldCount() )
         return OGRERR_FAILURE;
 
+    DiscardLazyGeomField(iField);
+
     if( papoGeometries[iField] != poGeomIn )
     {
         delete papoGeometries[iField];
@@ -929,6 +976,283 @@ OGRErr OGR_F_SetGeomField( OGRFeatureH hFeat, int iField, OGRGeometryH hGeom )
         SetGeomField(iField, OGRGeometry::FromHandle(hGeom));
 }
 
+/************************************************************************/
+/*                        SetGeomFieldLazyWKB()                         */
+/************************************************************************/
+
+/**
+ * \brief Set feature geometry of a specified geometry field from WKB,
+ * without instantiating it.
+ *
+ * The WKB is copied in the feature, and only turned into a OGRGeometry
+ * when it is requested through GetGeomFieldRef(), StealGeometry() and
+ * similar methods. This is intended for drivers whose native geometry
+ * encoding is WKB, so that features whose geometry is just passed through
+ * to another WKB-based driver, or whose envelope is the only thing needed,
+ * do not pay for the construction of a geometry object tree. See
+ * GetGeomFieldLazyWKB() and GetGeomFieldEnvelope().
+ *
+ * The const accessors instantiate the geometry under a lock, so that a
+ * feature can still be read from several threads.
+ *
+ * The geometry, once instantiated, is assigned the spatial reference
+ * system of the geometry field definition.
+ *
+ * @param iField geometry field to set.
+ * @param pabyWKB WKB geometry (ISO or old-style OGC variant). Must not
+ * be NULL.
+ * @param nWKBSize size in bytes of pabyWKB.
+ * @param psEnvelope envelope of the geometry if it is already known, or
+ * NULL.
+ *
+ * @return OGRERR_NONE if successful, or OGRERR_FAILURE if the index is
+ * invalid or in case of memory allocation failure.
+ *
+ * @since GDAL 3.1
+ */
+
+OGRErr OGRFeature::SetGeomFieldLazyWKB( int iField,
+                                        const GByte* pabyWKB,
+                                        size_t nWKBSize,
+                                        const OGREnvelope* psEnvelope )
+
+{
+    if( iField < 0 || iField >= GetGeomFieldCount() || pabyWKB == nullptr )
+        return OGRERR_FAILURE;
+
+    if( m_pasLazyGeometries == nullptr )
+    {
+        m_pasLazyGeometries =
+            new (std::nothrow) LazyGeometry[GetGeomFieldCount()];
+        if( m_pasLazyGeometries == nullptr )
+            return OGRERR_FAILURE;
+    }
+
+    GByte* pabyCopy = static_cast<GByte*>(VSI_MALLOC_VERBOSE(nWKBSize));
+    if( pabyCopy == nullptr )
+        return OGRERR_FAILURE;
+    memcpy(pabyCopy, pabyWKB, nWKBSize);
+
+    delete papoGeometries[iField];
+    papoGeometries[iField] = nullptr;
+
+    LazyGeometry& sLazy = m_pasLazyGeometries[iField];
+    CPLFree(sLazy.pabyWKB);
+    sLazy.pabyWKB = pabyCopy;
+    sLazy.nWKBSize = nWKBSize;
+    sLazy.bHasEnvelope = psEnvelope != nullptr;
+    if( psEnvelope )
+        sLazy.sEnvelope = *psEnvelope;
+    sLazy.bPending = true;
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                        GetGeomFieldLazyWKB()                         */
+/************************************************************************/
+
+/**
+ * \brief Fetch the WKB of a geometry field that has not been instantiated.
+ *
+ * @param iField geometry field to get.
+ * @param pnWKBSize pointer to the variable receiving the WKB size. May be
+ * NULL.
+ *
+ * @return the WKB set with SetGeomFieldLazyWKB(), owned by the feature, or
+ * NULL if the field is NULL or holds an instantiated geometry.
+ *
+ * @since GDAL 3.1
+ */
+
+const GByte* OGRFeature::GetGeomFieldLazyWKB( int iField,
+                                              size_t* pnWKBSize ) const
+
+{
+    if( iField < 0 || iField >= GetGeomFieldCount() ||
+        !IsGeomFieldLazy(iField) )
+    {
+        if( pnWKBSize )
+            *pnWKBSize = 0;
+        return nullptr;
+    }
+
+    if( pnWKBSize )
+        *pnWKBSize = m_pasLazyGeometries[iField].nWKBSize;
+    return m_pasLazyGeometries[iField].pabyWKB;
+}
+
+/************************************************************************/
+/*                        GetGeomFieldEnvelope()                        */
+/************************************************************************/
+
+/**
+ * \brief Compute the envelope of a geometry field.
+ *
+ * Contrary to GetGeomFieldRef(iField)->getEnvelope(), this does not
+ * instantiate a geometry set with SetGeomFieldLazyWKB().
+ *
+ * @param iField geometry field.
+ * @param psEnvelope the structure in which to place the results.
+ *
+ * @return OGRERR_NONE if successful, or OGRERR_FAILURE if the index is
+ * invalid, the field is NULL or its geometry is empty or corrupted.
+ *
+ * @since GDAL 3.1
+ */
+
+OGRErr OGRFeature::GetGeomFieldEnvelope( int iField,
+                                         OGREnvelope* psEnvelope ) const
+
+{
+    if( iField < 0 || iField >= GetGeomFieldCount() )
+        return OGRERR_FAILURE;
+
+    if( IsGeomFieldLazy(iField) )
+    {
+        const LazyGeometry& sLazy = m_pasLazyGeometries[iField];
+        if( sLazy.bHasEnvelope )
+        {
+            *psEnvelope = sLazy.sEnvelope;
+            return OGRERR_NONE;
+        }
+        OGREnvelope3D sEnvelope3D;
+        if( GetGeomFieldEnvelope(iField, &sEnvelope3D) != OGRERR_NONE )
+            return OGRERR_FAILURE;
+        *psEnvelope = sEnvelope3D;
+        return OGRERR_NONE;
+    }
+
+    if( papoGeometries[iField] == nullptr ||
+        papoGeometries[iField]->IsEmpty() )
+        return OGRERR_FAILURE;
+    papoGeometries[iField]->getEnvelope(psEnvelope);
+    return OGRERR_NONE;
+}
+
+/**
+ * \brief Compute the 3D envelope of a geometry field.
+ *
+ * Contrary to GetGeomFieldRef(iField)->getEnvelope(), this does not
+ * instantiate a geometry set with SetGeomFieldLazyWKB().
+ *
+ * @param iField geometry field.
+ * @param psEnvelope the structure in which to place the results.
+ *
+ * @return OGRERR_NONE if successful, or OGRERR_FAILURE if the index is
+ * invalid, the field is NULL or its geometry is empty or corrupted.
+ *
+ * @since GDAL 3.1
+ */
+
+OGRErr OGRFeature::GetGeomFieldEnvelope( int iField,
+                                         OGREnvelope3D* psEnvelope ) const
+
+{
+    if( iField < 0 || iField >= GetGeomFieldCount() )
+        return OGRERR_FAILURE;
+
+    if( IsGeomFieldLazy(iField) )
+    {
+        const LazyGeometry& sLazy = m_pasLazyGeometries[iField];
+        if( OGRWKBGetEnvelope(sLazy.pabyWKB, sLazy.nWKBSize, *psEnvelope) )
+            return psEnvelope->IsInit() ? OGRERR_NONE : OGRERR_FAILURE;
+        // Curves or unusual WKB: let the geometry classes deal with them.
+        MaterializeGeomField(iField);
+    }
+
+    if( papoGeometries[iField] == nullptr ||
+        papoGeometries[iField]->IsEmpty() )
+        return OGRERR_FAILURE;
+    papoGeometries[iField]->getEnvelope(psEnvelope);
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          IsGeomFieldLazy()                           */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+bool OGRFeature::IsGeomFieldLazy( int iField ) const
+
+{
+    return m_pasLazyGeometries != nullptr &&
+           m_pasLazyGeometries[iField].bPending;
+}
+
+/************************************************************************/
+/*                        MaterializeGeomField()                        */
+/*                                                                      */
+/*      Instantiate the geometry of a field set with                    */
+/*      SetGeomFieldLazyWKB(), and store it in the feature. This may    */
+/*      be called concurrently by const accessors, so the WKB is kept   */
+/*      until DiscardLazyGeomField() is called by a non-const method.   */
+/************************************************************************/
+
+void OGRFeature::MaterializeGeomField( int iField ) const
+
+{
+    LazyGeometry& sLazy = m_pasLazyGeometries[iField];
+    std::lock_guard<std::mutex> oLock(sLazy.oMutex);
+    if( !sLazy.bPending )
+        return;
+
+    OGRGeometry* poGeom = nullptr;
+    if( OGRGeometryFactory::createFromWkb(
+            sLazy.pabyWKB,
+            poDefn->GetGeomFieldDefn(iField)->GetSpatialRef(),
+            &poGeom, static_cast<int>(sLazy.nWKBSize) ) != OGRERR_NONE )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined, "Unable to read geometry");
+        poGeom = nullptr;
+    }
+    papoGeometries[iField] = poGeom;
+    sLazy.bPending = false;
+}
+
+/************************************************************************/
+/*                        DiscardLazyGeomField()                        */
+/************************************************************************/
+
+void OGRFeature::DiscardLazyGeomField( int iField )
+
+{
+    if( m_pasLazyGeometries != nullptr )
+    {
+        LazyGeometry& sLazy = m_pasLazyGeometries[iField];
+        CPLFree(sLazy.pabyWKB);
+        sLazy.pabyWKB = nullptr;
+        sLazy.nWKBSize = 0;
+        sLazy.bHasEnvelope = false;
+        sLazy.bPending = false;
+    }
+}
+
+/************************************************************************/
+/*                          SetGeomFieldFrom()                          */
+/*                                                                      */
+/*      Copy a geometry field of another feature, without               */
+/*      instantiating it if it is lazy.                                 */
+/************************************************************************/
+
+OGRErr OGRFeature::SetGeomFieldFrom( int iField,
+                                     const OGRFeature* poSrcFeature,
+                                     int iSrcField )
+
+{
+    if( iSrcField >= 0 && iSrcField < poSrcFeature->GetGeomFieldCount() &&
+        poSrcFeature->IsGeomFieldLazy(iSrcField) )
+    {
+        const LazyGeometry& sSrcLazy =
+            poSrcFeature->m_pasLazyGeometries[iSrcField];
+        return SetGeomFieldLazyWKB(
+            iField, sSrcLazy.pabyWKB, sSrcLazy.nWKBSize,
+            sSrcLazy.bHasEnvelope ? &sSrcLazy.sEnvelope : nullptr );
+    }
+    return SetGeomField( iField, poSrcFeature->GetGeomFieldRef(iSrcField) );
+}
+//! @endcond
+
 /************************************************************************/
 /*                               Clone()                                */
 /************************************************************************/
@@ -1013,7 +1337,14 @@ bool OGRFeature::CopySelfTo( OGRFeature* poNew ) const
     {
         for( int i = 0; i < poDefn->GetGeomFieldCount(); i++ )
         {
-            if( papoGeometries[i] != nullptr )
+            if( IsGeomFieldLazy(i) )
+            {
+                if( poNew->SetGeomFieldFrom(i, this, i) != OGRERR_NONE )
+                {
+                    return false;
+                }
+            }
+            else if( papoGeometries[i] != nullptr )
             {
                 poNew->papoGeometries[i] = papoGeometries[i]->clone();
                 if( poNew->papoGeometries[i] == nullptr )
@@ -1377,17 +1708,17 @@ int OGRFeature::IsFieldSet( int iField ) const
 
           case SPF_OGR_GEOM_WKT:
           case SPF_OGR_GEOMETRY:
-            return GetGeomFieldCount() > 0 && papoGeometries[0] != nullptr;
+            return GetGeomFieldRef(0) != nullptr;
 
           case SPF_OGR_STYLE:
             return GetStyleString() != nullptr;
 
           case SPF_OGR_GEOM_AREA:
-            if( GetGeomFieldCount() == 0 || papoGeometries[0] == nullptr )
+            if( GetGeomFieldRef(0) == nullptr )
                 return FALSE;
 
-            return OGR_G_Area(
-                OGRGeometry::ToHandle(papoGeometries[0])) != 0.0;
+            return OGR_G_Area(OGRGeometry::ToHandle(
+                const_cast<OGRGeometry*>(GetGeomFieldRef(0)))) != 0.0;
 
           default:
             return FALSE;
@@ -1881,10 +2212,11 @@ int OGRFeature::GetFieldAsInteger( int iField ) const
         }
 
         case SPF_OGR_GEOM_AREA:
-            if( GetGeomFieldCount() == 0 || papoGeometries[0] == nullptr )
+            if( GetGeomFieldRef(0) == nullptr )
                 return 0;
             return static_cast<int>(
-                OGR_G_Area(OGRGeometry::ToHandle(papoGeometries[0])));
+                OGR_G_Area(OGRGeometry::ToHandle(
+                    const_cast<OGRGeometry*>(GetGeomFieldRef(0)))));
 
         default:
             return 0;
@@ -2008,10 +2340,11 @@ GIntBig OGRFeature::GetFieldAsInteger64( int iField ) const
             return nFID;
 
         case SPF_OGR_GEOM_AREA:
-            if( GetGeomFieldCount() == 0 || papoGeometries[0] == nullptr )
+            if( GetGeomFieldRef(0) == nullptr )
                 return 0;
             return static_cast<int>(
-                OGR_G_Area(OGRGeometry::ToHandle(papoGeometries[0])));
+                OGR_G_Area(OGRGeometry::ToHandle(
+                    const_cast<OGRGeometry*>(GetGeomFieldRef(0)))));
 
         default:
             return 0;
@@ -2126,10 +2459,11 @@ double OGRFeature::GetFieldAsDouble( int iField ) const
             return static_cast<double>(GetFID());
 
         case SPF_OGR_GEOM_AREA:
-            if( GetGeomFieldCount() == 0 || papoGeometries[0] == nullptr )
+            if( GetGeomFieldRef(0) == nullptr )
                 return 0.0;
             return
-                OGR_G_Area(OGRGeometry::ToHandle(papoGeometries[0]));
+                OGR_G_Area(OGRGeometry::ToHandle(
+                    const_cast<OGRGeometry*>(GetGeomFieldRef(0))));
 
         default:
             return 0.0;
@@ -2316,8 +2650,8 @@ const char *OGRFeature::GetFieldAsString( int iField ) const
             return m_pszTmpFieldValue;
 
           case SPF_OGR_GEOMETRY:
-            if( GetGeomFieldCount() > 0 && papoGeometries[0] != nullptr )
-                return papoGeometries[0]->getGeometryName();
+            if( GetGeomFieldRef(0) != nullptr )
+                return GetGeomFieldRef(0)->getGeometryName();
             else
                 return "";
 
@@ -2329,10 +2663,10 @@ const char *OGRFeature::GetFieldAsString( int iField ) const
 
           case SPF_OGR_GEOM_WKT:
           {
-              if( GetGeomFieldCount() == 0 || papoGeometries[0] == nullptr )
+              if( GetGeomFieldRef(0) == nullptr )
                   return "";
 
-              if( papoGeometries[0]->exportToWkt( &m_pszTmpFieldValue ) ==
+              if( GetGeomFieldRef(0)->exportToWkt( &m_pszTmpFieldValue ) ==
                   OGRERR_NONE )
                   return m_pszTmpFieldValue;
               else
@@ -2340,12 +2674,13 @@ const char *OGRFeature::GetFieldAsString( int iField ) const
           }
 
           case SPF_OGR_GEOM_AREA:
-            if( GetGeomFieldCount() == 0 || papoGeometries[0] == nullptr )
+            if( GetGeomFieldRef(0) == nullptr )
                 return "";
 
             CPLsnprintf(
                 szTempBuffer, TEMP_BUFFER_SIZE, "%.16g",
-                OGR_G_Area(OGRGeometry::ToHandle(papoGeometries[0])));
+                OGR_G_Area(OGRGeometry::ToHandle(
+                    const_cast<OGRGeometry*>(GetGeomFieldRef(0)))));
             m_pszTmpFieldValue = VSI_STRDUP_VERBOSE( szTempBuffer );
             if( m_pszTmpFieldValue == nullptr )
                 return "";
@@ -5339,14 +5674,14 @@ void OGRFeature::DumpReadable( FILE * fpOut, char** papszOptions ) const
             {
                 OGRGeomFieldDefn *poFDefn = poDefn->GetGeomFieldDefn(iField);
 
-                if( papoGeometries[iField] != nullptr )
+                const OGRGeometry* poGeom = GetGeomFieldRef(iField);
+                if( poGeom != nullptr )
                 {
                     fprintf( fpOut, "  " );
                     if( strlen(poFDefn->GetNameRef()) > 0 &&
                         GetGeomFieldCount() > 1 )
                         fprintf( fpOut, "%s = ", poFDefn->GetNameRef() );
-                    papoGeometries[iField]->dumpReadable( fpOut, "",
-                                                          papszOptions );
+                    poGeom->dumpReadable( fpOut, "", papszOptions );
                 }
             }
         }
@@ -5839,11 +6174,11 @@ OGRErr OGRFeature::SetFrom( const OGRFeature * poSrcFeature,
         int iSrc = poSrcFeature->GetGeomFieldIndex(
                                     poGFieldDefn->GetNameRef());
         if( iSrc >= 0 )
-            SetGeomField( 0, poSrcFeature->GetGeomFieldRef(iSrc) );
+            SetGeomFieldFrom( 0, poSrcFeature, iSrc );
         else
             // Whatever the geometry field names are.  For backward
             // compatibility.
-            SetGeomField( 0, poSrcFeature->GetGeomFieldRef(0) );
+            SetGeomFieldFrom( 0, poSrcFeature, 0 );
     }
     else
     {
@@ -5854,7 +6189,7 @@ OGRErr OGRFeature::SetFrom( const OGRFeature * poSrcFeature,
             const int iSrc =
                 poSrcFeature->GetGeomFieldIndex(poGFieldDefn->GetNameRef());
             if( iSrc >= 0 )
-                SetGeomField( i, poSrcFeature->GetGeomFieldRef(iSrc) );
+                SetGeomFieldFrom( i, poSrcFeature, iSrc );
             else
                 SetGeomField( i, nullptr );
         }
@@ -6354,6 +6689,16 @@ OGRErr OGRFeature::RemapGeomFields( OGRFeatureDefn *poNewDefn,
     if( poNewDefn == nullptr )
         poNewDefn = poDefn;
 
+    // The lazy geometries are indexed like the current definition.
+    for( int i = 0; i < poDefn->GetGeomFieldCount(); i++ )
+    {
+        if( IsGeomFieldLazy(i) )
+            MaterializeGeomField(i);
+        DiscardLazyGeomField(i);
+    }
+    delete[] m_pasLazyGeometries;
+    m_pasLazyGeometries = nullptr;
+
     OGRGeometry** papoNewGeomFields = static_cast<OGRGeometry **>(
         CPLCalloc( poNewDefn->GetGeomFieldCount(), sizeof(OGRGeometry*) ) );
 
@@ -32,9 +32,14 @@
 #include "ogr_feature.h"
 #include "ogr_swq.h"
 
+#include <climits>
+#include <cmath>
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -57,13 +62,551 @@ const char *const SpecialFieldNames[SPECIAL_FIELD_COUNT] = {
 const swq_field_type SpecialFieldTypes[SPECIAL_FIELD_COUNT] = {
     SWQ_INTEGER, SWQ_STRING, SWQ_STRING, SWQ_STRING, SWQ_FLOAT};
 
+/************************************************************************/
+/*                        OGRFeatureQueryProgram                        */
+/*                                                                      */
+/*      Flattened form of the common subset of WHERE expressions        */
+/*      (comparisons of a column against constants, IS NULL, and        */
+/*      AND/OR/NOT combinations of them), evaluated directly against    */
+/*      the OGRField array of features without walking the             */
+/*      swq_expr_node tree nor allocating intermediate nodes.           */
+/*      Semantics must be kept identical to SWQGeneralEvaluator().      */
+/*      Expressions that use anything else are left to the generic     */
+/*      swq_expr_node::Evaluate() path.                                 */
+/************************************************************************/
+
+class OGRFeatureQueryProgram
+{
+    enum class Opcode
+    {
+        COMPARE,   // bResult = comparison of a column against constants
+        IS_NULL,   // bResult = column is unset or null
+        NOT,       // bResult = !bResult
+        AND_JUMP,  // if !bResult, jump to nTarget, else continue
+        OR_JUMP    // if bResult, jump to nTarget, else continue
+    };
+
+    enum class LoadType
+    {
+        INTEGER,        // OFTInteger, from the raw field
+        INTEGER64,      // OFTInteger64, from the raw field
+        REAL,           // OFTReal, from the raw field
+        STRING,         // OFTString, from the raw field
+        AS_INTEGER,     // through OGRFeature::GetFieldAsInteger()
+        AS_INTEGER64    // through OGRFeature::GetFieldAsInteger64()
+    };
+
+    enum class CompareMode
+    {
+        INTEGER,
+        REAL,
+        STRING
+    };
+
+    struct Instruction
+    {
+        Opcode       eOpcode = Opcode::NOT;
+        swq_op       eOp = SWQ_EQ;
+        int          iField = 0;
+        LoadType     eLoadType = LoadType::INTEGER;
+        CompareMode  eMode = CompareMode::INTEGER;
+        size_t       nTarget = 0;
+        bool         bSortedValues = false;
+        std::vector<GIntBig>   anValues{};
+        std::vector<double>    adfValues{};
+        std::vector<CPLString> aosValues{};
+    };
+
+    std::vector<Instruction> m_aoInstructions{};
+
+    // Fields (and their types at compile time) read from raw OGRField.
+    std::vector<std::pair<int, OGRFieldType>> m_aoRawFields{};
+    OGRFeatureDefn *m_poDefn = nullptr;
+
+    OGRFeatureQueryProgram() = default;
+
+    bool        CompileNode( const swq_expr_node *poNode, int nDepth );
+    bool        CompileComparison( const swq_expr_node *poNode );
+    bool        ResolveColumn( const swq_expr_node *poColumn,
+                               bool bRealMode,
+                               int &iField, LoadType &eLoadType );
+
+    static bool StringEqual( const char *pszA, const char *pszB );
+    static bool EvaluateComparison( const Instruction &oInstr,
+                                    OGRFeature *poFeature );
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRFeatureQueryProgram)
+
+  public:
+    static OGRFeatureQueryProgram *Build( const swq_expr_node *poExpr,
+                                          OGRFeatureDefn *poDefn );
+
+    bool        CanEvaluate( OGRFeature *poFeature ) const;
+    bool        Evaluate( OGRFeature *poFeature ) const;
+};
+
+/************************************************************************/
+/*                               Build()                                */
+/************************************************************************/
+
+OGRFeatureQueryProgram *
+OGRFeatureQueryProgram::Build( const swq_expr_node *poExpr,
+                               OGRFeatureDefn *poDefn )
+{
+    if( poExpr == nullptr || poDefn == nullptr )
+        return nullptr;
+
+    OGRFeatureQueryProgram *poProgram = new OGRFeatureQueryProgram();
+    poProgram->m_poDefn = poDefn;
+    if( !poProgram->CompileNode(poExpr, 0) )
+    {
+        delete poProgram;
+        return nullptr;
+    }
+    return poProgram;
+}
+
+/************************************************************************/
+/*                            CompileNode()                             */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::CompileNode( const swq_expr_node *poNode,
+                                          int nDepth )
+{
+    // Same recursion limit as swq_expr_node::Evaluate()
+    if( nDepth == 32 || poNode->eNodeType != SNT_OPERATION ||
+        poNode->field_type != SWQ_BOOLEAN )
+        return false;
+
+    switch( poNode->nOperation )
+    {
+        case SWQ_AND:
+        case SWQ_OR:
+        {
+            if( poNode->nSubExprCount != 2 ||
+                !CompileNode(poNode->papoSubExpr[0], nDepth + 1) )
+                return false;
+            const size_t iJump = m_aoInstructions.size();
+            Instruction oInstr;
+            oInstr.eOpcode = poNode->nOperation == SWQ_AND ?
+                                    Opcode::AND_JUMP : Opcode::OR_JUMP;
+            m_aoInstructions.push_back(oInstr);
+            if( !CompileNode(poNode->papoSubExpr[1], nDepth + 1) )
+                return false;
+            m_aoInstructions[iJump].nTarget = m_aoInstructions.size();
+            return true;
+        }
+
+        case SWQ_NOT:
+        {
+            if( poNode->nSubExprCount != 1 ||
+                !CompileNode(poNode->papoSubExpr[0], nDepth + 1) )
+                return false;
+            Instruction oInstr;
+            oInstr.eOpcode = Opcode::NOT;
+            m_aoInstructions.push_back(oInstr);
+            return true;
+        }
+
+        case SWQ_ISNULL:
+        {
+            if( poNode->nSubExprCount != 1 )
+                return false;
+            const swq_expr_node *poColumn = poNode->papoSubExpr[0];
+            if( poColumn->eNodeType != SNT_COLUMN ||
+                poColumn->table_index != 0 ||
+                poColumn->field_type == SWQ_GEOMETRY ||
+                poColumn->field_index < 0 )
+                return false;
+            Instruction oInstr;
+            oInstr.eOpcode = Opcode::IS_NULL;
+            oInstr.iField = poColumn->field_index;
+            const int nFieldCount = m_poDefn->GetFieldCount();
+            if( oInstr.iField == nFieldCount + SPECIAL_FIELD_COUNT +
+                                 m_poDefn->GetGeomFieldCount() )
+            {
+                // FID column added by OGRFeatureQuery::Compile()
+                oInstr.iField = nFieldCount + SPF_FID;
+            }
+            else if( oInstr.iField >= nFieldCount + SPECIAL_FIELD_COUNT )
+            {
+                return false;
+            }
+            m_aoInstructions.push_back(oInstr);
+            return true;
+        }
+
+        case SWQ_EQ:
+        case SWQ_NE:
+        case SWQ_GE:
+        case SWQ_LE:
+        case SWQ_LT:
+        case SWQ_GT:
+        case SWQ_IN:
+        case SWQ_BETWEEN:
+            return CompileComparison(poNode);
+
+        default:
+            return false;
+    }
+}
+
+/************************************************************************/
+/*                           ResolveColumn()                            */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::ResolveColumn( const swq_expr_node *poColumn,
+                                            bool bRealMode,
+                                            int &iField,
+                                            LoadType &eLoadType )
+{
+    if( poColumn->eNodeType != SNT_COLUMN || poColumn->table_index != 0 ||
+        poColumn->field_index < 0 )
+        return false;
+
+    const int nFieldCount = m_poDefn->GetFieldCount();
+    iField = poColumn->field_index;
+
+    if( iField >= nFieldCount )
+    {
+        // Only the FID among special fields, either under its own name
+        // or under the FID column name appended by Compile().
+        if( iField != nFieldCount + SPF_FID &&
+            iField != nFieldCount + SPECIAL_FIELD_COUNT +
+                      m_poDefn->GetGeomFieldCount() )
+            return false;
+        iField = nFieldCount + SPF_FID;
+        if( poColumn->field_type == SWQ_INTEGER64 )
+            eLoadType = LoadType::AS_INTEGER64;
+        else if( poColumn->field_type == SWQ_INTEGER )
+            eLoadType = LoadType::AS_INTEGER;
+        else
+            return false;
+        return true;
+    }
+
+    // The value must be the one OGRFeatureFetcher() would have produced
+    // for the (possibly promoted) column type.
+    const OGRFieldType eType = m_poDefn->GetFieldDefn(iField)->GetType();
+    const swq_field_type eColType = poColumn->field_type;
+    if( eColType == SWQ_BOOLEAN && bRealMode )
+        return false;
+    if( eType == OFTInteger &&
+        (SWQ_IS_INTEGER(eColType) || eColType == SWQ_BOOLEAN ||
+         eColType == SWQ_FLOAT) )
+        eLoadType = LoadType::INTEGER;
+    else if( eType == OFTInteger64 &&
+             (eColType == SWQ_INTEGER64 || eColType == SWQ_FLOAT) )
+        eLoadType = LoadType::INTEGER64;
+    else if( eType == OFTInteger64 &&
+             (eColType == SWQ_INTEGER || eColType == SWQ_BOOLEAN) )
+        eLoadType = LoadType::AS_INTEGER;
+    else if( eType == OFTReal && eColType == SWQ_FLOAT )
+        eLoadType = LoadType::REAL;
+    else if( eType == OFTString && eColType == SWQ_STRING )
+        eLoadType = LoadType::STRING;
+    else
+        return false;
+
+    m_aoRawFields.push_back(std::pair<int, OGRFieldType>(iField, eType));
+    return true;
+}
+
+/************************************************************************/
+/*                         CompileComparison()                          */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::CompileComparison( const swq_expr_node *poNode )
+{
+    const int nOp = poNode->nOperation;
+    if( poNode->nSubExprCount < 2 ||
+        (nOp == SWQ_BETWEEN && poNode->nSubExprCount != 3) ||
+        (nOp != SWQ_BETWEEN && nOp != SWQ_IN && poNode->nSubExprCount != 2) )
+        return false;
+
+    const swq_expr_node *poColumn = poNode->papoSubExpr[0];
+    const swq_field_type eConstType = poNode->papoSubExpr[1]->field_type;
+    for( int i = 1; i < poNode->nSubExprCount; i++ )
+    {
+        const swq_expr_node *poConst = poNode->papoSubExpr[i];
+        if( poConst->eNodeType != SNT_CONSTANT || poConst->is_null ||
+            poConst->field_type != eConstType )
+            return false;
+    }
+
+    // Pick the same branch as SWQGeneralEvaluator() would.
+    Instruction oInstr;
+    oInstr.eOpcode = Opcode::COMPARE;
+    oInstr.eOp = static_cast<swq_op>(nOp);
+    if( poColumn->field_type == SWQ_FLOAT || eConstType == SWQ_FLOAT )
+    {
+        if( !(SWQ_IS_INTEGER(eConstType) || eConstType == SWQ_FLOAT) )
+            return false;
+        oInstr.eMode = CompareMode::REAL;
+    }
+    else if( SWQ_IS_INTEGER(poColumn->field_type) ||
+             poColumn->field_type == SWQ_BOOLEAN )
+    {
+        if( !(SWQ_IS_INTEGER(eConstType) || eConstType == SWQ_BOOLEAN) )
+            return false;
+        oInstr.eMode = CompareMode::INTEGER;
+    }
+    else if( poColumn->field_type == SWQ_STRING )
+    {
+        if( eConstType != SWQ_STRING )
+            return false;
+        oInstr.eMode = CompareMode::STRING;
+    }
+    else
+    {
+        return false;
+    }
+
+    if( !ResolveColumn(poColumn, oInstr.eMode == CompareMode::REAL,
+                       oInstr.iField, oInstr.eLoadType) )
+        return false;
+
+    for( int i = 1; i < poNode->nSubExprCount; i++ )
+    {
+        const swq_expr_node *poConst = poNode->papoSubExpr[i];
+        switch( oInstr.eMode )
+        {
+            case CompareMode::INTEGER:
+                oInstr.anValues.push_back(poConst->int_value);
+                break;
+            case CompareMode::REAL:
+                // SWQGeneralEvaluator() only promotes the first two
+                // operands from integer to real.
+                oInstr.adfValues.push_back(
+                    i == 1 && SWQ_IS_INTEGER(poConst->field_type) ?
+                        static_cast<double>(poConst->int_value) :
+                        poConst->float_value);
+                break;
+            case CompareMode::STRING:
+                if( poConst->string_value == nullptr )
+                    return false;
+                oInstr.aosValues.push_back(poConst->string_value);
+                break;
+        }
+    }
+
+    if( nOp == SWQ_IN && oInstr.eMode == CompareMode::INTEGER &&
+        oInstr.anValues.size() > 8 )
+    {
+        std::sort(oInstr.anValues.begin(), oInstr.anValues.end());
+        oInstr.bSortedValues = true;
+    }
+
+    m_aoInstructions.push_back(oInstr);
+    return true;
+}
+
+/************************************************************************/
+/*                            StringEqual()                             */
+/*                                                                      */
+/*      Same as the SWQ_EQ string case of SWQGeneralEvaluator().        */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::StringEqual( const char *pszA, const char *pszB )
+{
+    const size_t nLenA = strlen(pszA);
+    const size_t nLenB = strlen(pszB);
+    if( nLenA > 3 && nLenB > 3 )
+    {
+        // When comparing timestamps, the +00 at the end might be discarded
+        // if the other member has no explicit timezone.
+        if( strcmp(pszA + nLenA - 3, "+00") == 0 && pszB[nLenB - 3] == ':' )
+            return EQUALN(pszA, pszB, nLenB);
+        if( pszA[nLenA - 3] == ':' && strcmp(pszB + nLenB - 3, "+00") == 0 )
+            return EQUALN(pszA, pszB, nLenA);
+    }
+    return strcasecmp(pszA, pszB) == 0;
+}
+
+/************************************************************************/
+/*                         EvaluateComparison()                         */
+/************************************************************************/
+
+template<class T> static bool OGRFeatureQueryCompare( swq_op eOp,
+                                                      const T &a,
+                                                      const T *b,
+                                                      size_t nValues )
+{
+    switch( eOp )
+    {
+        case SWQ_EQ: return a == b[0];
+        case SWQ_NE: return a != b[0];
+        case SWQ_GT: return a > b[0];
+        case SWQ_LT: return a < b[0];
+        case SWQ_GE: return a >= b[0];
+        case SWQ_LE: return a <= b[0];
+        case SWQ_BETWEEN: return a >= b[0] && a <= b[1];
+        case SWQ_IN:
+            for( size_t i = 0; i < nValues; i++ )
+            {
+                if( a == b[i] )
+                    return true;
+            }
+            return false;
+        default:
+            CPLAssert(false);
+            return false;
+    }
+}
+
+bool OGRFeatureQueryProgram::EvaluateComparison( const Instruction &oInstr,
+                                                 OGRFeature *poFeature )
+{
+    // A comparison involving a null operand is false.
+    if( !poFeature->IsFieldSetAndNotNull(oInstr.iField) )
+        return false;
+
+    if( oInstr.eMode == CompareMode::STRING )
+    {
+        const char *pszVal = poFeature->GetRawFieldRef(oInstr.iField)->String;
+        const CPLString *paosValues = oInstr.aosValues.data();
+        switch( oInstr.eOp )
+        {
+            case SWQ_EQ:
+                return StringEqual(pszVal, paosValues[0]);
+            case SWQ_NE:
+                return strcasecmp(pszVal, paosValues[0]) != 0;
+            case SWQ_GT:
+                return strcasecmp(pszVal, paosValues[0]) > 0;
+            case SWQ_LT:
+                return strcasecmp(pszVal, paosValues[0]) < 0;
+            case SWQ_GE:
+                return strcasecmp(pszVal, paosValues[0]) >= 0;
+            case SWQ_LE:
+                return strcasecmp(pszVal, paosValues[0]) <= 0;
+            case SWQ_BETWEEN:
+                return strcasecmp(pszVal, paosValues[0]) >= 0 &&
+                       strcasecmp(pszVal, paosValues[1]) <= 0;
+            case SWQ_IN:
+                for( const auto &osValue : oInstr.aosValues )
+                {
+                    if( strcasecmp(pszVal, osValue) == 0 )
+                        return true;
+                }
+                return false;
+            default:
+                CPLAssert(false);
+                return false;
+        }
+    }
+
+    GIntBig nVal = 0;
+    double dfVal = 0.0;
+    const OGRField *psField = poFeature->GetRawFieldRef(oInstr.iField);
+    switch( oInstr.eLoadType )
+    {
+        case LoadType::INTEGER:
+            nVal = psField->Integer;
+            dfVal = static_cast<double>(nVal);
+            break;
+        case LoadType::INTEGER64:
+            nVal = psField->Integer64;
+            dfVal = static_cast<double>(nVal);
+            break;
+        case LoadType::REAL:
+            dfVal = psField->Real;
+            break;
+        case LoadType::AS_INTEGER:
+            nVal = poFeature->GetFieldAsInteger(oInstr.iField);
+            dfVal = static_cast<double>(nVal);
+            break;
+        case LoadType::AS_INTEGER64:
+            nVal = poFeature->GetFieldAsInteger64(oInstr.iField);
+            dfVal = static_cast<double>(nVal);
+            break;
+        case LoadType::STRING:
+            CPLAssert(false);
+            return false;
+    }
+
+    if( oInstr.eMode == CompareMode::REAL )
+    {
+        return OGRFeatureQueryCompare(oInstr.eOp, dfVal,
+                                      oInstr.adfValues.data(),
+                                      oInstr.adfValues.size());
+    }
+    if( oInstr.bSortedValues )
+    {
+        return std::binary_search(oInstr.anValues.begin(),
+                                  oInstr.anValues.end(), nVal);
+    }
+    return OGRFeatureQueryCompare(oInstr.eOp, nVal,
+                                  oInstr.anValues.data(),
+                                  oInstr.anValues.size());
+}
+
+/************************************************************************/
+/*                            CanEvaluate()                             */
+/*                                                                      */
+/*      The program reads raw fields whose type was checked against     */
+/*      the layer definition at compile time, so make sure the          */
+/*      feature still matches it.                                       */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::CanEvaluate( OGRFeature *poFeature ) const
+{
+    OGRFeatureDefn *poDefn = poFeature->GetDefnRef();
+    if( poDefn != m_poDefn )
+        return false;
+    for( const auto &oField : m_aoRawFields )
+    {
+        if( oField.first >= poDefn->GetFieldCount() ||
+            poDefn->GetFieldDefn(oField.first)->GetType() != oField.second )
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                              Evaluate()                              */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::Evaluate( OGRFeature *poFeature ) const
+{
+    bool bResult = false;
+    const size_t nInstructions = m_aoInstructions.size();
+    size_t i = 0;
+    while( i < nInstructions )
+    {
+        const Instruction &oInstr = m_aoInstructions[i];
+        switch( oInstr.eOpcode )
+        {
+            case Opcode::COMPARE:
+                bResult = EvaluateComparison(oInstr, poFeature);
+                ++i;
+                break;
+            case Opcode::IS_NULL:
+                bResult = !poFeature->IsFieldSetAndNotNull(oInstr.iField);
+                ++i;
+                break;
+            case Opcode::NOT:
+                bResult = !bResult;
+                ++i;
+                break;
+            case Opcode::AND_JUMP:
+                i = bResult ? i + 1 : oInstr.nTarget;
+                break;
+            case Opcode::OR_JUMP:
+                i = bResult ? oInstr.nTarget : i + 1;
+                break;
+        }
+    }
+    return bResult;
+}
+
 /************************************************************************/
 /*                          OGRFeatureQuery()                           */
 /************************************************************************/
 
 OGRFeatureQuery::OGRFeatureQuery() :
     poTargetDefn(nullptr),
-    pSWQExpr(nullptr)
+    pSWQExpr(nullptr),
+    poProgram(nullptr)
 {}
 
 /************************************************************************/
@@ -73,6 +616,7 @@ OGRFeatureQuery::OGRFeatureQuery() :
 OGRFeatureQuery::~OGRFeatureQuery()
 
 {
+    delete poProgram;
     delete static_cast<swq_expr_node *>(pSWQExpr);
 }
 
@@ -117,6 +661,8 @@ OGRFeatureQuery::Compile( OGRLayer *poLayer,
                           swq_custom_func_registrar *poCustomFuncRegistrar )
 {
     // Clear any existing expression.
+    delete poProgram;
+    poProgram = nullptr;
     if( pSWQExpr != nullptr )
     {
         delete static_cast<swq_expr_node *>(pSWQExpr);
@@ -242,6 +788,11 @@ OGRFeatureQuery::Compile( OGRLayer *poLayer,
         eErr = OGRERR_CORRUPT_DATA;
         pSWQExpr = nullptr;
     }
+    else if( CPLTestBool(CPLGetConfigOption("OGR_SQL_COMPILE_WHERE", "YES")) )
+    {
+        poProgram = OGRFeatureQueryProgram::Build(
+            static_cast<swq_expr_node *>(pSWQExpr), poDefn);
+    }
 
     CPLFree(papszFieldNames);
     CPLFree(paeFieldTypes);
@@ -333,6 +884,9 @@ int OGRFeatureQuery::Evaluate( OGRFeature *poFeature )
     if( pSWQExpr == nullptr )
         return FALSE;
 
+    if( poProgram != nullptr && poProgram->CanEvaluate(poFeature) )
+        return poProgram->Evaluate(poFeature);
+
     swq_expr_node *poResult =
         static_cast<swq_expr_node *>(pSWQExpr)->
             Evaluate(OGRFeatureFetcher, poFeature);
@@ -351,6 +905,66 @@ int OGRFeatureQuery::Evaluate( OGRFeature *poFeature )
     return bLogicalResult;
 }
 
+/************************************************************************/
+/*                           EvaluateBatch()                            */
+/*                                                                      */
+/*      Evaluate the query against an array of features, storing       */
+/*      TRUE or FALSE for each of them in pabResults. Returns the       */
+/*      number of matching features. The results are the same as       */
+/*      calling Evaluate() on each feature, but the applicability of    */
+/*      the compiled program is only checked once per definition.       */
+/************************************************************************/
+
+int OGRFeatureQuery::EvaluateBatch( OGRFeature **papoFeatures,
+                                    int nFeatureCount,
+                                    int *pabResults )
+
+{
+    int nMatches = 0;
+    OGRFeatureDefn *poCheckedDefn = nullptr;
+    for( int i = 0; i < nFeatureCount; i++ )
+    {
+        OGRFeature *poFeature = papoFeatures[i];
+        // Features of a batch nearly always share the same definition, so
+        // only check the program applicability when it changes.
+        if( poProgram != nullptr &&
+            (poFeature->GetDefnRef() == poCheckedDefn ||
+             poProgram->CanEvaluate(poFeature)) )
+        {
+            poCheckedDefn = poFeature->GetDefnRef();
+            pabResults[i] = poProgram->Evaluate(poFeature);
+        }
+        else
+        {
+            pabResults[i] = Evaluate(poFeature);
+        }
+        if( pabResults[i] )
+            nMatches++;
+    }
+    return nMatches;
+}
+
+/************************************************************************/
+/*                   OGRFeatureQueryIsRangeOperation()                  */
+/************************************************************************/
+
+static bool OGRFeatureQueryIsRangeOperation( const swq_expr_node *psExpr )
+{
+    switch( psExpr->nOperation )
+    {
+        case SWQ_LT:
+        case SWQ_LE:
+        case SWQ_GT:
+        case SWQ_GE:
+            return psExpr->nSubExprCount == 2;
+        case SWQ_BETWEEN:
+            return psExpr->nSubExprCount == 3 &&
+                   psExpr->papoSubExpr[2]->eNodeType == SNT_CONSTANT;
+        default:
+            return false;
+    }
+}
+
 /************************************************************************/
 /*                            CanUseIndex()                             */
 /************************************************************************/
@@ -380,7 +994,9 @@ int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
                CanUseIndex(psExpr->papoSubExpr[1], poLayer);
     }
 
-    if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN)
+    const bool bRange = OGRFeatureQueryIsRangeOperation(psExpr);
+    if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN ||
+          bRange)
         || psExpr->nSubExprCount < 2 )
         return FALSE;
 
@@ -398,6 +1014,9 @@ int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
     if( poIndex == nullptr )
         return FALSE;
 
+    if( bRange && !poIndex->SupportsRangeQueries() )
+        return FALSE;
+
     // Have an index.
     return TRUE;
 }
@@ -411,9 +1030,9 @@ int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
 /*      available indices, or an "OGRNullFID" terminated list of        */
 /*      FIDs if it can.                                                 */
 /*                                                                      */
-/*      For now we only support equality tests on a single indexed      */
-/*      attribute field.  Eventually we should make this support        */
-/*      multi-part queries with ranges.                                 */
+/*      Equality and IN tests are supported on all indexes, and         */
+/*      range tests (<, <=, >, >=, BETWEEN) on indexes that implement   */
+/*      GetRangeMatches().  They can be combined with AND and OR.       */
 /************************************************************************/
 
 static int CompareGIntBig( const void *pa, const void *pb )
@@ -570,6 +1189,154 @@ GIntBig* OGRANDGIntBigArray( GIntBig panFIDList1[], GIntBig nFIDCount1,
     return panFIDList;
 }
 
+/************************************************************************/
+/*                      OGRFeatureQueryGetBound()                       */
+/*                                                                      */
+/*      Convert the constant of a range comparison to a key of the      */
+/*      type of the indexed field.  For integer fields compared to a    */
+/*      non-integral value, the bound is rounded towards the inside     */
+/*      of the range and becomes inclusive.  Returns false if the       */
+/*      bound cannot be expressed exactly.                              */
+/************************************************************************/
+
+static bool OGRFeatureQueryGetBound( const swq_expr_node *poValue,
+                                     OGRFieldType eType, bool bLowerBound,
+                                     OGRField &sBound, bool &bIncluded )
+{
+    if( poValue->eNodeType != SNT_CONSTANT || poValue->is_null )
+        return false;
+
+    const bool bNumericConstant =
+        poValue->field_type == SWQ_INTEGER ||
+        poValue->field_type == SWQ_INTEGER64 ||
+        poValue->field_type == SWQ_FLOAT;
+
+    switch( eType )
+    {
+      case OFTInteger:
+      case OFTInteger64:
+      {
+        if( !bNumericConstant )
+            return false;
+        GIntBig nVal = poValue->int_value;
+        if( poValue->field_type == SWQ_FLOAT )
+        {
+            const double dfVal = poValue->float_value;
+            const double dfRounded =
+                bLowerBound ? std::ceil(dfVal) : std::floor(dfVal);
+            // Also rejects NaN.
+            if( !(dfRounded >= -9007199254740992.0 &&
+                  dfRounded <= 9007199254740992.0) )
+                return false;
+            if( dfRounded != dfVal )
+                bIncluded = true;
+            nVal = static_cast<GIntBig>(dfRounded);
+        }
+        if( eType == OFTInteger )
+        {
+            if( nVal < INT_MIN || nVal > INT_MAX )
+                return false;
+            sBound.Integer = static_cast<int>(nVal);
+        }
+        else
+        {
+            sBound.Integer64 = nVal;
+        }
+        return true;
+      }
+
+      case OFTReal:
+        if( !bNumericConstant )
+            return false;
+        sBound.Real = poValue->field_type == SWQ_FLOAT ?
+            poValue->float_value : static_cast<double>(poValue->int_value);
+        return !std::isnan(sBound.Real);
+
+      case OFTString:
+        if( poValue->field_type != SWQ_STRING )
+            return false;
+        sBound.String = poValue->string_value;
+        return true;
+
+      default:
+        return false;
+    }
+}
+
+/************************************************************************/
+/*                 OGRFeatureQueryIsTimestampLikeString()               */
+/*                                                                      */
+/*      Equality of strings looking like timestamps is not a plain      */
+/*      case insensitive comparison (see SWQ_EQ in                      */
+/*      swq_op_general.cpp), so indexes cannot be used for them.        */
+/************************************************************************/
+
+static bool OGRFeatureQueryIsTimestampLikeString( const char *pszVal )
+{
+    const size_t nLen = strlen(pszVal);
+    return nLen > 3 &&
+           (strcmp(pszVal + nLen - 3, "+00") == 0 || pszVal[nLen-3] == ':');
+}
+
+/************************************************************************/
+/*                     OGRFeatureQueryEvaluateRange()                   */
+/************************************************************************/
+
+static GIntBig *OGRFeatureQueryEvaluateRange( swq_expr_node *psExpr,
+                                              OGRAttrIndex *poIndex,
+                                              OGRFieldType eType,
+                                              GIntBig& nFIDCount )
+{
+    if( !poIndex->SupportsRangeQueries() )
+        return nullptr;
+
+    OGRField sMin;
+    OGRField sMax;
+    bool bHasMin = false;
+    bool bHasMax = false;
+    bool bMinIncluded = false;
+    bool bMaxIncluded = false;
+    switch( psExpr->nOperation )
+    {
+        case SWQ_GT:
+        case SWQ_GE:
+            bHasMin = true;
+            bMinIncluded = psExpr->nOperation == SWQ_GE;
+            if( !OGRFeatureQueryGetBound(psExpr->papoSubExpr[1], eType, true,
+                                         sMin, bMinIncluded) )
+                return nullptr;
+            break;
+
+        case SWQ_LT:
+        case SWQ_LE:
+            bHasMax = true;
+            bMaxIncluded = psExpr->nOperation == SWQ_LE;
+            if( !OGRFeatureQueryGetBound(psExpr->papoSubExpr[1], eType, false,
+                                         sMax, bMaxIncluded) )
+                return nullptr;
+            break;
+
+        case SWQ_BETWEEN:
+            bHasMin = true;
+            bHasMax = true;
+            bMinIncluded = true;
+            bMaxIncluded = true;
+            if( !OGRFeatureQueryGetBound(psExpr->papoSubExpr[1], eType, true,
+                                         sMin, bMinIncluded) ||
+                !OGRFeatureQueryGetBound(psExpr->papoSubExpr[2], eType, false,
+                                         sMax, bMaxIncluded) )
+                return nullptr;
+            break;
+
+        default:
+            return nullptr;
+    }
+
+    return poIndex->GetRangeMatches(bHasMin ? &sMin : nullptr, bMinIncluded,
+                                    bHasMax ? &sMax : nullptr, bMaxIncluded,
+                                    nFIDCount);
+}
+
 GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
                                                   OGRLayer *poLayer,
                                                   GIntBig& nFIDCount )
@@ -604,7 +1371,9 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
         return panFIDList;
     }
 
-    if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN)
+    const bool bRange = OGRFeatureQueryIsRangeOperation(psExpr);
+    if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN ||
+          bRange)
         || psExpr->nSubExprCount < 2 )
         return nullptr;
 
@@ -628,6 +1397,24 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
     OGRFieldDefn *poFieldDefn =
         poLayer->GetLayerDefn()->GetFieldDefn(nIdx);
 
+    if( bRange )
+    {
+        return OGRFeatureQueryEvaluateRange(psExpr, poIndex,
+                                            poFieldDefn->GetType(), nFIDCount);
+    }
+
+    if( poFieldDefn->GetType() == OFTString )
+    {
+        for( int i = 1; i < psExpr->nSubExprCount; i++ )
+        {
+            if( psExpr->papoSubExpr[i]->eNodeType != SNT_CONSTANT ||
+                psExpr->papoSubExpr[i]->field_type != SWQ_STRING ||
+                OGRFeatureQueryIsTimestampLikeString(
+                    psExpr->papoSubExpr[i]->string_value) )
+                return nullptr;
+        }
+    }
+
     // Handle the case of an IN operation.
     if( psExpr->nOperation == SWQ_IN )
     {
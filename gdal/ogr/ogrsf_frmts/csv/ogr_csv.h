@@ -33,7 +33,11 @@
 
 #include "ogrsf_frmts.h"
 
+#include <deque>
+#include <memory>
 #include <set>
+#include <string>
+#include <vector>
 
 #if defined(_MSC_VER) && _MSC_VER <= 1600 // MSVC <= 2010
 # define GDAL_OVERRIDE
@@ -53,6 +57,7 @@ typedef enum
 } OGRCSVGeometryFormat;
 
 class OGRCSVDataSource;
+class CPLWorkerThreadPool;
 
 char **OGRCSVReadParseLineL( VSILFILE *fp, char chDelimiter,
                              bool bDontHonourStrings = false,
@@ -68,6 +73,57 @@ typedef enum
 
 void OGRCSVDriverRemoveFromMap(const char *pszName, GDALDataset *poDS);
 
+/************************************************************************/
+/*                          OGRCSVRecordReader                          */
+/*                                                                      */
+/*      Reads the records of a CSV file through a reusable buffer, and  */
+/*      splits them into fields in place, without per-field            */
+/*      allocations.  Records, fields and quoting are recognized as     */
+/*      OGRCSVReadParseLineL() does.                                    */
+/************************************************************************/
+
+class OGRCSVRecordReader
+{
+    CPL_DISALLOW_COPY_ASSIGN(OGRCSVRecordReader)
+
+    VSILFILE           *m_fp;
+    char                m_chDelimiter;
+    bool                m_bHonourStrings;
+    bool                m_bMergeDelimiter;
+
+    // Data is in [m_nPos, m_nEnd) of m_osBuffer, which has always at least
+    // one extra byte to nul-terminate the last field.
+    std::string         m_osBuffer{};
+    size_t              m_nPos = 0;
+    size_t              m_nEnd = 0;
+    bool                m_bEOF = false;
+    vsi_l_offset        m_nBufferOffset = 0;
+
+    vsi_l_offset        m_nRecordOffset = 0;
+    size_t              m_nRecordStart = 0;
+    size_t              m_nRecordEnd = 0;
+
+    std::vector<char *> m_apszFields{};
+    char                m_szEmptyField[1] = {'\0'};
+
+    void                FillBuffer();
+
+  public:
+    OGRCSVRecordReader( VSILFILE *fp, char chDelimiter, bool bHonourStrings,
+                        bool bMergeDelimiter );
+
+    void                SetData( std::string &osData );
+    void                TakeBufferedData( std::string &osData );
+
+    bool                NextRecord();
+    char              **SplitRecord();
+    vsi_l_offset        GetRecordOffset() const { return m_nRecordOffset; }
+
+    static size_t       GetCompleteRecordsSize( const char *pabyData,
+                                                size_t nSize,
+                                                bool bHonourStrings );
+};
+
 /************************************************************************/
 /*                             OGRCSVLayer                              */
 /************************************************************************/
@@ -83,7 +139,24 @@ class OGRCSVLayer final: public OGRLayer
         ALWAYS
     };
 
+    enum class LineIndexMode
+    {
+        NO,
+        AUTO,
+        YES
+    };
+
   private:
+    struct ParseJob;
+
+    // Warning detected while translating a record, reported by the
+    // thread that owns the layer.
+    struct TranslateWarning
+    {
+        const char     *pszFormat = nullptr;
+        int             iField = -1;
+    };
+
     OGRFeatureDefn     *poFeatureDefn;
     std::set<CPLString> m_oSetFields;
 
@@ -142,8 +215,46 @@ class OGRCSVLayer final: public OGRLayer
 
     StringQuoting       m_eStringQuoting = StringQuoting::IF_AMBIGUOUS;
 
+    // Record offsets stored in the <datafile>.idx sidecar.
+    LineIndexMode       m_eLineIndexMode = LineIndexMode::NO;
+    bool                m_bLineIndexChecked = false;
+    bool                m_bLineIndexIsTemporary = false;
+    VSILFILE           *m_fpLineIndex = nullptr;
+    CPLString           m_osLineIndexFilename{};
+    GIntBig             m_nLineIndexRecordCount = 0;
+
+    // Parallel parsing of chunks of records.
+    int                 m_nNumThreads = 1;
+    std::unique_ptr<CPLWorkerThreadPool> m_poWorkerThreadPool{};
+    bool                m_bReadAhead = false;
+    bool                m_bReadAheadEOF = false;
+    std::string         m_osPendingData{};
+    std::deque<std::unique_ptr<OGRFeature>> m_apoParsedFeatures{};
+
+    std::unique_ptr<OGRCSVRecordReader> m_poRecordReader{};
+
+    bool                HonourStrings() const
+                            { return !(chDelimiter == '\t' &&
+                                       bDontHonourStrings); }
+    OGRCSVRecordReader *GetRecordReader();
     char              **GetNextLineTokens();
 
+    OGRFeature         *TranslateFeature( char **papszTokens,
+                                          TranslateWarning *psWarning ) const;
+    void                ReportTranslateWarning(
+                                        const TranslateWarning &sWarning,
+                                        GIntBig nFID );
+
+    bool                OpenLineIndex();
+    bool                BuildLineIndex();
+    bool                HasLineIndex( bool bBuildIfNeeded );
+    bool                SeekToRecord( GIntBig nFID );
+
+    static void         ParseChunkJob( void *pData );
+    bool                ReadParsedFeatures();
+    OGRFeature         *GetNextParsedFeature();
+    void                ClearParsedFeatures();
+
     static bool         Matches( const char *pszFieldName,
                                  char **papszPossibleNames );
 
@@ -201,6 +312,9 @@ class OGRCSVLayer final: public OGRLayer
     void                SetStringQuoting( StringQuoting eVal ) { m_eStringQuoting = eVal; }
     StringQuoting       GetStringQuoting() const { return m_eStringQuoting; }
 
+    void                SetLineIndexMode( LineIndexMode eVal ) { m_eLineIndexMode = eVal; }
+    void                SetNumThreads( int nNumThreads ) { m_nNumThreads = nNumThreads; }
+
     virtual GIntBig     GetFeatureCount( int bForce = TRUE ) override;
     virtual OGRErr      SyncToDisk() override;
 
@@ -43,6 +43,7 @@
 #include "ogr_core.h"
 #include "ogr_feature.h"
 #include "ogr_geometry.h"
+#include "ogr_p.h"
 #include "ogr_spatialref.h"
 #include "ogreditablelayer.h"
 #include "ogrsf_frmts.h"
@@ -863,6 +864,22 @@ bool OGRCSVDataSource::OpenTable( const char *pszFilename,
     {
         poLayer = new OGRCSVEditableLayer(poCSVLayer, papszOpenOptionsIn);
     }
+    else
+    {
+        poCSVLayer->SetNumThreads(OGRGetNumThreads(papszOpenOptionsIn));
+        if( !EQUAL(pszFilename, "/vsistdin/") )
+        {
+            // Attach the attribute indexes created by CREATE INDEX, if any.
+            poCSVLayer->InitializeSidecarIndexSupport(pszFilename);
+
+            const char *pszLineIndex = CSLFetchNameValueDef(
+                papszOpenOptionsIn, "LINE_INDEX", "AUTO");
+            if( EQUAL(pszLineIndex, "AUTO") )
+                poCSVLayer->SetLineIndexMode(OGRCSVLayer::LineIndexMode::AUTO);
+            else if( CPLTestBool(pszLineIndex) )
+                poCSVLayer->SetLineIndexMode(OGRCSVLayer::LineIndexMode::YES);
+        }
+    }
     papoLayers[nLayers - 1] = poLayer;
 
     return true;
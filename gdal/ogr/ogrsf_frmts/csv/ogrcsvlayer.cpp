@@ -49,6 +49,7 @@
 #include "cpl_error.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "ogr_api.h"
 #include "ogr_core.h"
 #include "ogr_feature.h"
@@ -1374,6 +1375,13 @@ OGRCSVLayer::~OGRCSVLayer()
 
     if( fpCSV )
         VSIFCloseL(fpCSV);
+
+    if( m_fpLineIndex )
+    {
+        VSIFCloseL(m_fpLineIndex);
+        if( m_bLineIndexIsTemporary )
+            VSIUnlink(m_osLineIndexFilename);
+    }
 }
 
 /************************************************************************/
@@ -1393,28 +1401,315 @@ void OGRCSVLayer::ResetReading()
     bNeedRewindBeforeRead = false;
 
     nNextFID = 1;
+
+    ClearParsedFeatures();
+    m_poRecordReader.reset();
+
+    ResetAttrIndexReading();
+}
+
+/************************************************************************/
+/*                          GetRecordReader()                           */
+/*                                                                      */
+/*      The reader is discarded whenever the file is repositioned, and  */
+/*      then recreated at the current position.                         */
+/************************************************************************/
+
+OGRCSVRecordReader *OGRCSVLayer::GetRecordReader()
+{
+    if( m_poRecordReader == nullptr )
+    {
+        m_poRecordReader.reset(new OGRCSVRecordReader(
+            fpCSV, chDelimiter, HonourStrings(), bMergeDelimiter));
+    }
+    return m_poRecordReader.get();
 }
 
 /************************************************************************/
 /*                        GetNextLineTokens()                           */
+/*                                                                      */
+/*      The returned tokens are owned by the record reader, and valid   */
+/*      until the next read.                                            */
 /************************************************************************/
 
 char **OGRCSVLayer::GetNextLineTokens()
 {
-    while( true )
+    OGRCSVRecordReader *poReader = GetRecordReader();
+    if( !poReader->NextRecord() )
+        return nullptr;
+    return poReader->SplitRecord();
+}
+
+/*
+ * The line-offset index, named <datafile>.idx, is made of (all values being
+ * little-endian):
+ *
+ *  - the 8 byte signature "OGRCSVL2"
+ *  - the size (uint64) and modification time (int64) of the data file at
+ *    the time the index was written, used to detect stale indexes
+ *  - the offset (uint64) of the first record, i.e. after the header line
+ *    if there is one
+ *  - flags (uint32): bit 0 set if the index was built with quotes not
+ *    honoured, in which case each line is a record
+ *  - the checksum (uint32) of the first and last blocks of the data file,
+ *    as computed by OGRGetFileStamp()
+ *  - the number of records (uint64)
+ *  - the offset (uint64) of each record, in FID order.
+ *
+ * Empty lines are not records, and a record may span several lines when
+ * a quoted value contains new lines.
+ */
+
+constexpr const char LINE_INDEX_SIGNATURE[] = "OGRCSVL2";
+constexpr size_t LINE_INDEX_SIGNATURE_SIZE = 8;
+constexpr vsi_l_offset LINE_INDEX_HEADER_SIZE = 48;
+
+/************************************************************************/
+/*                        GetFirstRecordOffset()                        */
+/************************************************************************/
+
+static vsi_l_offset GetFirstRecordOffset( VSILFILE *fp, bool bHasFieldNames,
+                                          char chDelimiter,
+                                          bool bDontHonourStrings )
+{
+    const vsi_l_offset nCurPos = VSIFTellL(fp);
+    VSIRewindL(fp);
+    if( bHasFieldNames )
+        CSLDestroy(OGRCSVReadParseLineL(fp, chDelimiter, bDontHonourStrings));
+    const vsi_l_offset nOffset = VSIFTellL(fp);
+    VSIFSeekL(fp, nCurPos, SEEK_SET);
+    return nOffset;
+}
+
+/************************************************************************/
+/*                           OpenLineIndex()                            */
+/*                                                                      */
+/*      Open the <datafile>.idx line-offset index if it exists and      */
+/*      matches the current state of the data file.                     */
+/************************************************************************/
+
+bool OGRCSVLayer::OpenLineIndex()
+{
+    const CPLString osIdxFilename(CPLString(pszFilename) + ".idx");
+    VSILFILE *fp = VSIFOpenL(osIdxFilename, "rb");
+    if( fp == nullptr )
+        return false;
+
+    GByte abyHeader[LINE_INDEX_HEADER_SIZE] = {};
+    GUInt64 nCurSize = 0;
+    GInt64 nCurMTime = 0;
+    GUInt32 nCurChecksum = 0;
+    bool bValid =
+        VSIFReadL(abyHeader, sizeof(abyHeader), 1, fp) == 1 &&
+        memcmp(abyHeader, LINE_INDEX_SIGNATURE,
+               LINE_INDEX_SIGNATURE_SIZE) == 0 &&
+        OGRGetFileStamp(pszFilename, nCurSize, nCurMTime, nCurChecksum);
+    if( bValid )
     {
-        // Read the CSV record.
-        char **papszTokens = OGRCSVReadParseLineL(
-            fpCSV, chDelimiter, bDontHonourStrings, false, bMergeDelimiter);
+        GUInt64 nSize = 0;
+        GInt64 nMTime = 0;
+        GUInt64 nFirstRecordOffset = 0;
+        GUInt32 nIndexFlags = 0;
+        GUInt32 nChecksum = 0;
+        GUInt64 nCount = 0;
+        memcpy(&nSize, abyHeader + 8, 8);
+        memcpy(&nMTime, abyHeader + 16, 8);
+        memcpy(&nFirstRecordOffset, abyHeader + 24, 8);
+        memcpy(&nIndexFlags, abyHeader + 32, 4);
+        memcpy(&nChecksum, abyHeader + 36, 4);
+        memcpy(&nCount, abyHeader + 40, 8);
+        CPL_LSBPTR64(&nSize);
+        CPL_LSBPTR64(&nMTime);
+        CPL_LSBPTR64(&nFirstRecordOffset);
+        CPL_LSBPTR32(&nIndexFlags);
+        CPL_LSBPTR32(&nChecksum);
+        CPL_LSBPTR64(&nCount);
+
+        const bool bNoQuotes = !HonourStrings();
+        VSIFSeekL(fp, 0, SEEK_END);
+        bValid =
+            nSize == nCurSize &&
+            nMTime == nCurMTime &&
+            nChecksum == nCurChecksum &&
+            (nIndexFlags & 1) == (bNoQuotes ? 1U : 0U) &&
+            nCount <= static_cast<GUInt64>(
+                        std::numeric_limits<GIntBig>::max() / 8) &&
+            VSIFTellL(fp) == LINE_INDEX_HEADER_SIZE + nCount * 8 &&
+            nFirstRecordOffset == GetFirstRecordOffset(
+                fpCSV, bHasFieldNames, chDelimiter, bDontHonourStrings);
+        if( bValid )
+            m_nLineIndexRecordCount = static_cast<GIntBig>(nCount);
+    }
+    if( !bValid )
+    {
+        CPLDebug("CSV", "Ignoring %s, which is invalid or out of date",
+                 osIdxFilename.c_str());
+        VSIFCloseL(fp);
+        return false;
+    }
 
-        if( papszTokens == nullptr )
-            return nullptr;
+    m_fpLineIndex = fp;
+    m_osLineIndexFilename = osIdxFilename;
+    return true;
+}
 
-        if( papszTokens[0] != nullptr )
-            return papszTokens;
+/************************************************************************/
+/*                           BuildLineIndex()                           */
+/*                                                                      */
+/*      Scan the whole file to write the <datafile>.idx line-offset     */
+/*      index.  If it cannot be created next to the data file, it is    */
+/*      kept in /vsimem/ for the lifetime of the layer.                 */
+/************************************************************************/
 
-        CSLDestroy(papszTokens);
+bool OGRCSVLayer::BuildLineIndex()
+{
+    GUInt64 nSize = 0;
+    GInt64 nMTime = 0;
+    GUInt32 nChecksum = 0;
+    if( !OGRGetFileStamp(pszFilename, nSize, nMTime, nChecksum) )
+        return false;
+
+    CPLString osIdxFilename(CPLString(pszFilename) + ".idx");
+    VSILFILE *fp = VSIFOpenL(osIdxFilename, "wb+");
+    if( fp == nullptr )
+    {
+        CPLDebug("CSV", "Cannot create %s. Using a temporary index instead",
+                 osIdxFilename.c_str());
+        osIdxFilename.Printf("/vsimem/ogrcsv_%p.idx", this);
+        fp = VSIFOpenL(osIdxFilename, "wb+");
+        if( fp == nullptr )
+            return false;
+        m_bLineIndexIsTemporary = true;
     }
+
+    ResetReading();
+    const bool bNoQuotes = !HonourStrings();
+
+    GUInt64 nFirstRecordOffset = VSIFTellL(fpCSV);
+    GUInt32 nIndexFlags = bNoQuotes ? 1 : 0;
+    GUInt64 nCount = 0;
+
+    // The header is written once the records have been counted.
+    GByte abyHeader[LINE_INDEX_HEADER_SIZE] = {};
+    bool bOK = VSIFWriteL(abyHeader, sizeof(abyHeader), 1, fp) == 1;
+
+    std::vector<GUInt64> anOffsets;
+    constexpr size_t OFFSET_BUFFER_SIZE = 8192;
+    anOffsets.reserve(OFFSET_BUFFER_SIZE);
+    OGRCSVRecordReader *poReader = GetRecordReader();
+    while( bOK )
+    {
+        const bool bHasRecord = poReader->NextRecord();
+        if( !bHasRecord || anOffsets.size() == OFFSET_BUFFER_SIZE )
+        {
+            for( auto &nVal: anOffsets )
+                CPL_LSBPTR64(&nVal);
+            bOK = anOffsets.empty() ||
+                  VSIFWriteL(anOffsets.data(), sizeof(GUInt64),
+                             anOffsets.size(), fp) == anOffsets.size();
+            anOffsets.clear();
+        }
+        if( !bHasRecord )
+            break;
+        anOffsets.push_back(poReader->GetRecordOffset());
+        nCount++;
+    }
+
+    if( bOK )
+    {
+        memcpy(abyHeader, LINE_INDEX_SIGNATURE, LINE_INDEX_SIGNATURE_SIZE);
+        CPL_LSBPTR64(&nSize);
+        CPL_LSBPTR64(&nMTime);
+        CPL_LSBPTR64(&nFirstRecordOffset);
+        CPL_LSBPTR32(&nIndexFlags);
+        CPL_LSBPTR32(&nChecksum);
+        memcpy(abyHeader + 8, &nSize, 8);
+        memcpy(abyHeader + 16, &nMTime, 8);
+        memcpy(abyHeader + 24, &nFirstRecordOffset, 8);
+        memcpy(abyHeader + 32, &nIndexFlags, 4);
+        memcpy(abyHeader + 36, &nChecksum, 4);
+        GUInt64 nCountLSB = nCount;
+        CPL_LSBPTR64(&nCountLSB);
+        memcpy(abyHeader + 40, &nCountLSB, 8);
+        bOK = VSIFSeekL(fp, 0, SEEK_SET) == 0 &&
+              VSIFWriteL(abyHeader, sizeof(abyHeader), 1, fp) == 1 &&
+              VSIFFlushL(fp) == 0;
+    }
+
+    ResetReading();
+
+    if( !bOK )
+    {
+        CPLError(CE_Warning, CPLE_FileIO, "Cannot write %s",
+                 osIdxFilename.c_str());
+        VSIFCloseL(fp);
+        VSIUnlink(osIdxFilename);
+        m_bLineIndexIsTemporary = false;
+        return false;
+    }
+
+    m_fpLineIndex = fp;
+    m_osLineIndexFilename = osIdxFilename;
+    m_nLineIndexRecordCount = static_cast<GIntBig>(nCount);
+    return true;
+}
+
+/************************************************************************/
+/*                            HasLineIndex()                            */
+/************************************************************************/
+
+bool OGRCSVLayer::HasLineIndex( bool bBuildIfNeeded )
+{
+    if( m_fpLineIndex != nullptr )
+        return true;
+    if( m_eLineIndexMode == LineIndexMode::NO || fpCSV == nullptr )
+        return false;
+
+    if( !m_bLineIndexChecked )
+    {
+        m_bLineIndexChecked = true;
+        if( OpenLineIndex() )
+            return true;
+        if( m_eLineIndexMode == LineIndexMode::AUTO )
+            m_eLineIndexMode = LineIndexMode::NO;
+    }
+
+    if( !bBuildIfNeeded || m_eLineIndexMode != LineIndexMode::YES )
+        return false;
+
+    // Only attempt the build once.
+    m_eLineIndexMode = LineIndexMode::NO;
+    return BuildLineIndex();
+}
+
+/************************************************************************/
+/*                            SeekToRecord()                            */
+/*                                                                      */
+/*      Position the file on a record using the line-offset index.      */
+/************************************************************************/
+
+bool OGRCSVLayer::SeekToRecord( GIntBig nFID )
+{
+    if( nFID > m_nLineIndexRecordCount )
+        return false;
+
+    GUInt64 nOffset = 0;
+    if( VSIFSeekL(m_fpLineIndex,
+                  LINE_INDEX_HEADER_SIZE +
+                      static_cast<vsi_l_offset>(nFID - 1) * 8,
+                  SEEK_SET) != 0 ||
+        VSIFReadL(&nOffset, sizeof(nOffset), 1, m_fpLineIndex) != 1 )
+    {
+        return false;
+    }
+    CPL_LSBPTR64(&nOffset);
+
+    ClearParsedFeatures();
+    m_poRecordReader.reset();
+    if( VSIFSeekL(fpCSV, nOffset, SEEK_SET) != 0 )
+        return false;
+    nNextFID = static_cast<int>(nFID);
+    return true;
 }
 
 /************************************************************************/
@@ -1425,33 +1720,37 @@ OGRFeature *OGRCSVLayer::GetFeature(GIntBig nFID)
 {
     if( nFID < 1 || fpCSV == nullptr )
         return nullptr;
-    if( nFID < nNextFID || bNeedRewindBeforeRead )
+    if( !bNeedRewindBeforeRead && HasLineIndex(true) )
+    {
+        if( !SeekToRecord(nFID) )
+            return nullptr;
+        return GetNextUnfilteredFeature();
+    }
+    if( nFID < nNextFID || bNeedRewindBeforeRead || m_bReadAhead )
         ResetReading();
     while( nNextFID < nFID )
     {
-        char **papszTokens = GetNextLineTokens();
-        if( papszTokens == nullptr )
+        if( !GetRecordReader()->NextRecord() )
             return nullptr;
-        CSLDestroy(papszTokens);
         nNextFID++;
     }
     return GetNextUnfilteredFeature();
 }
 
 /************************************************************************/
-/*                      GetNextUnfilteredFeature()                      */
+/*                          TranslateFeature()                          */
+/*                                                                      */
+/*      Build a feature from the tokens of a record.  This does not     */
+/*      modify the layer state, so that it can be called from worker    */
+/*      threads.  The first value inconsistent with the field           */
+/*      definition is reported in psWarning, unless it is null.         */
 /************************************************************************/
 
-OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
+OGRFeature *OGRCSVLayer::TranslateFeature( char **papszTokens,
+                                           TranslateWarning *psWarning ) const
 
 {
-    if( fpCSV == nullptr )
-        return nullptr;
-
-    // Read the CSV record.
-    char **papszTokens = GetNextLineTokens();
-    if( papszTokens == nullptr )
-        return nullptr;
+    bool bCheckWarning = psWarning != nullptr;
 
     // Create the OGR feature.
     OGRFeature *poFeature = new OGRFeature(poFeatureDefn);
@@ -1536,14 +1835,13 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
                 {
                     poFeature->SetField(iOGRField, 0);
                 }
-                else if( !bWarningBadTypeOrWidth )
+                else if( bCheckWarning )
                 {
-                    bWarningBadTypeOrWidth = true;
-                    CPLError(
-                        CE_Warning, CPLE_AppDefined,
+                    bCheckWarning = false;
+                    psWarning->pszFormat =
                         "Invalid value type found in record %d for field %s. "
-                        "This warning will no longer be emitted",
-                        nNextFID, poFieldDefn->GetNameRef());
+                        "This warning will no longer be emitted";
+                    psWarning->iField = iOGRField;
                 }
             }
         }
@@ -1562,31 +1860,31 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
                 if( eType == CPL_VALUE_INTEGER || eType == CPL_VALUE_REAL )
                 {
                     poFeature->SetField(iOGRField, papszTokens[iAttr]);
-                    if( !bWarningBadTypeOrWidth &&
+                    if( bCheckWarning &&
                         (eFieldType == OFTInteger ||
                          eFieldType == OFTInteger64) &&
                         eType == CPL_VALUE_REAL )
                     {
-                        bWarningBadTypeOrWidth = true;
-                        CPLError(CE_Warning, CPLE_AppDefined,
-                                 "Invalid value type found in record %d for "
-                                 "field %s. "
-                                 "This warning will no longer be emitted",
-                                 nNextFID, poFieldDefn->GetNameRef());
+                        bCheckWarning = false;
+                        psWarning->pszFormat =
+                            "Invalid value type found in record %d for "
+                            "field %s. "
+                            "This warning will no longer be emitted";
+                        psWarning->iField = iOGRField;
                     }
-                    else if( !bWarningBadTypeOrWidth &&
+                    else if( bCheckWarning &&
                              poFieldDefn->GetWidth() > 0 &&
                              static_cast<int>(strlen(papszTokens[iAttr])) >
                                  poFieldDefn->GetWidth() )
                     {
-                        bWarningBadTypeOrWidth = true;
-                        CPLError(CE_Warning, CPLE_AppDefined,
-                                 "Value with a width greater than field width "
-                                 "found in record %d for field %s. "
-                                 "This warning will no longer be emitted",
-                                 nNextFID, poFieldDefn->GetNameRef());
+                        bCheckWarning = false;
+                        psWarning->pszFormat =
+                            "Value with a width greater than field width "
+                            "found in record %d for field %s. "
+                            "This warning will no longer be emitted";
+                        psWarning->iField = iOGRField;
                     }
-                    else if( !bWarningBadTypeOrWidth &&
+                    else if( bCheckWarning &&
                              eType == CPL_VALUE_REAL &&
                              poFieldDefn->GetWidth() > 0)
                     {
@@ -1597,26 +1895,25 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
                                 : 0;
                         if( nPrecision > poFieldDefn->GetPrecision() )
                         {
-                            bWarningBadTypeOrWidth = true;
-                            CPLError(CE_Warning, CPLE_AppDefined,
-                                     "Value with a precision greater than "
-                                     "field precision found in record %d for "
-                                     "field %s. "
-                                     "This warning will no longer be emitted",
-                                     nNextFID, poFieldDefn->GetNameRef());
+                            bCheckWarning = false;
+                            psWarning->pszFormat =
+                                "Value with a precision greater than "
+                                "field precision found in record %d for "
+                                "field %s. "
+                                "This warning will no longer be emitted";
+                            psWarning->iField = iOGRField;
                         }
                     }
                 }
                 else
                 {
-                    if( !bWarningBadTypeOrWidth )
+                    if( bCheckWarning )
                     {
-                        bWarningBadTypeOrWidth = true;
-                        CPLError(
-                            CE_Warning, CPLE_AppDefined,
+                        bCheckWarning = false;
+                        psWarning->pszFormat =
                             "Invalid value type found in record %d for field "
-                            "%s. This warning will no longer be emitted.",
-                            nNextFID, poFieldDefn->GetNameRef());
+                            "%s. This warning will no longer be emitted.";
+                        psWarning->iField = iOGRField;
                     }
                 }
             }
@@ -1626,15 +1923,14 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
             if( papszTokens[iAttr][0] != '\0' && !poFieldDefn->IsIgnored() )
             {
                 poFeature->SetField(iOGRField, papszTokens[iAttr]);
-                if( !bWarningBadTypeOrWidth &&
+                if( bCheckWarning &&
                     !poFeature->IsFieldSetAndNotNull(iOGRField) )
                 {
-                    bWarningBadTypeOrWidth = true;
-                    CPLError(
-                        CE_Warning, CPLE_AppDefined,
+                    bCheckWarning = false;
+                    psWarning->pszFormat =
                         "Invalid value type found in record %d for field %s. "
-                        "This warning will no longer be emitted",
-                        nNextFID, poFieldDefn->GetNameRef());
+                        "This warning will no longer be emitted";
+                    psWarning->iField = iOGRField;
                 }
             }
         }
@@ -1647,16 +1943,16 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
             else
             {
                 poFeature->SetField(iOGRField, papszTokens[iAttr]);
-                if( !bWarningBadTypeOrWidth && poFieldDefn->GetWidth() > 0 &&
+                if( bCheckWarning && poFieldDefn->GetWidth() > 0 &&
                     static_cast<int>(strlen(papszTokens[iAttr])) >
                         poFieldDefn->GetWidth() )
                 {
-                    bWarningBadTypeOrWidth = true;
-                    CPLError(CE_Warning, CPLE_AppDefined,
-                             "Value with a width greater than field width "
-                             "found in record %d for field %s. "
-                             "This warning will no longer be emitted",
-                             nNextFID, poFieldDefn->GetNameRef());
+                    bCheckWarning = false;
+                    psWarning->pszFormat =
+                        "Value with a width greater than field width "
+                        "found in record %d for field %s. "
+                        "This warning will no longer be emitted";
+                    psWarning->iField = iOGRField;
                 }
             }
         }
@@ -1765,7 +2061,44 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
         }
     }
 
-    CSLDestroy(papszTokens);
+    return poFeature;
+}
+
+/************************************************************************/
+/*                       ReportTranslateWarning()                       */
+/************************************************************************/
+
+void OGRCSVLayer::ReportTranslateWarning( const TranslateWarning &sWarning,
+                                          GIntBig nFID )
+{
+    if( sWarning.pszFormat == nullptr || bWarningBadTypeOrWidth )
+        return;
+    bWarningBadTypeOrWidth = true;
+    CPLError(CE_Warning, CPLE_AppDefined, sWarning.pszFormat,
+             static_cast<int>(nFID),
+             poFeatureDefn->GetFieldDefn(sWarning.iField)->GetNameRef());
+}
+
+/************************************************************************/
+/*                      GetNextUnfilteredFeature()                      */
+/************************************************************************/
+
+OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
+
+{
+    if( fpCSV == nullptr )
+        return nullptr;
+
+    // Read the CSV record.
+    char **papszTokens = GetNextLineTokens();
+    if( papszTokens == nullptr )
+        return nullptr;
+
+    TranslateWarning sWarning;
+    OGRFeature *poFeature = TranslateFeature(
+        papszTokens, bWarningBadTypeOrWidth ? nullptr : &sWarning);
+
+    ReportTranslateWarning(sWarning, nNextFID);
 
     // Translate the record id.
     poFeature->SetFID(nNextFID++);
@@ -1775,6 +2108,200 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
     return poFeature;
 }
 
+/************************************************************************/
+/*                              ParseJob                                */
+/************************************************************************/
+
+struct OGRCSVLayer::ParseJob
+{
+    const OGRCSVLayer *poLayer = nullptr;
+    std::string        osData{};
+    bool               bCheckWarnings = false;
+    std::vector<std::unique_ptr<OGRFeature>> apoFeatures{};
+    TranslateWarning   sWarning{};
+    size_t             nWarningFeatureIdx = 0;
+};
+
+/************************************************************************/
+/*                           ParseChunkJob()                            */
+/************************************************************************/
+
+void OGRCSVLayer::ParseChunkJob( void *pData )
+{
+    ParseJob *psJob = static_cast<ParseJob *>(pData);
+    const OGRCSVLayer *poLayer = psJob->poLayer;
+
+    OGRCSVRecordReader oReader(nullptr, poLayer->chDelimiter,
+                               poLayer->HonourStrings(),
+                               poLayer->bMergeDelimiter);
+    oReader.SetData(psJob->osData);
+
+    // Warnings are reported by the thread that owns the layer.
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    bool bCheckWarnings = psJob->bCheckWarnings;
+    while( oReader.NextRecord() )
+    {
+        TranslateWarning sWarning;
+        psJob->apoFeatures.emplace_back(poLayer->TranslateFeature(
+            oReader.SplitRecord(), bCheckWarnings ? &sWarning : nullptr));
+        if( sWarning.pszFormat != nullptr )
+        {
+            bCheckWarnings = false;
+            psJob->sWarning = sWarning;
+            psJob->nWarningFeatureIdx = psJob->apoFeatures.size() - 1;
+        }
+    }
+    CPLPopErrorHandler();
+}
+
+/************************************************************************/
+/*                         ReadParsedFeatures()                         */
+/*                                                                      */
+/*      Read the next chunks of the file, split at record boundaries,   */
+/*      and translate their records into features on worker threads.    */
+/*      Returns false once the end of file has been reached.            */
+/************************************************************************/
+
+bool OGRCSVLayer::ReadParsedFeatures()
+{
+    if( m_bReadAheadEOF )
+        return false;
+
+    // If the pool cannot be set up, SubmitJobs() fails and chunks are
+    // parsed by this thread.
+    if( m_poWorkerThreadPool == nullptr )
+    {
+        m_poWorkerThreadPool.reset(new CPLWorkerThreadPool());
+        m_poWorkerThreadPool->Setup(m_nNumThreads, nullptr, nullptr);
+    }
+
+    const size_t nChunkSize = static_cast<size_t>(std::max(1, atoi(
+        CPLGetConfigOption("OGR_CSV_CHUNK_SIZE", "1048576"))));
+
+    // Two chunks per thread, so that threads do not remain idle when
+    // chunks take uneven times to process.
+    std::vector<ParseJob> asJobs(2 * std::max(1, m_nNumThreads));
+    size_t nJobs = 0;
+    if( !m_bReadAhead && m_poRecordReader != nullptr )
+    {
+        // Start from the data already read by the sequential reader.
+        m_poRecordReader->TakeBufferedData(m_osPendingData);
+        m_poRecordReader.reset();
+    }
+    m_bReadAhead = true;
+    while( nJobs < asJobs.size() && !m_bReadAheadEOF )
+    {
+        std::string osData;
+        osData.swap(m_osPendingData);
+        while( true )
+        {
+            const size_t nOldSize = osData.size();
+            osData.resize(nOldSize + nChunkSize);
+            const size_t nRead =
+                VSIFReadL(&osData[nOldSize], 1, nChunkSize, fpCSV);
+            osData.resize(nOldSize + nRead);
+            m_bReadAheadEOF = nRead < nChunkSize;
+            const size_t nRecordsSize =
+                m_bReadAheadEOF
+                    ? osData.size()
+                    : OGRCSVRecordReader::GetCompleteRecordsSize(
+                          osData.data(), osData.size(), HonourStrings());
+            if( nRecordsSize > 0 || m_bReadAheadEOF )
+            {
+                m_osPendingData.assign(osData, nRecordsSize,
+                                       std::string::npos);
+                osData.resize(nRecordsSize);
+                break;
+            }
+        }
+        if( osData.empty() )
+            continue;
+
+        ParseJob &sJob = asJobs[nJobs++];
+        sJob.poLayer = this;
+        sJob.osData.swap(osData);
+        sJob.bCheckWarnings = !bWarningBadTypeOrWidth;
+    }
+    if( nJobs == 0 )
+        return false;
+
+    if( nJobs == 1 )
+    {
+        for( size_t i = 0; i < nJobs; i++ )
+            ParseChunkJob(&asJobs[i]);
+    }
+    else
+    {
+        std::vector<void *> apData;
+        for( size_t i = 0; i < nJobs; i++ )
+            apData.push_back(&asJobs[i]);
+        if( m_poWorkerThreadPool->SubmitJobs(ParseChunkJob, apData) )
+        {
+            m_poWorkerThreadPool->WaitCompletion();
+        }
+        else
+        {
+            for( size_t i = 0; i < nJobs; i++ )
+                ParseChunkJob(&asJobs[i]);
+        }
+    }
+
+    // FIDs are assigned in record order.
+    GIntBig nFID = nNextFID + static_cast<GIntBig>(m_apoParsedFeatures.size());
+    for( size_t i = 0; i < nJobs; i++ )
+    {
+        ParseJob &sJob = asJobs[i];
+        if( sJob.sWarning.pszFormat != nullptr )
+        {
+            ReportTranslateWarning(sJob.sWarning,
+                                   nFID + sJob.nWarningFeatureIdx);
+        }
+        for( auto &poFeature: sJob.apoFeatures )
+        {
+            poFeature->SetFID(nFID++);
+            m_apoParsedFeatures.emplace_back(std::move(poFeature));
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                        GetNextParsedFeature()                        */
+/************************************************************************/
+
+OGRFeature *OGRCSVLayer::GetNextParsedFeature()
+{
+    if( fpCSV == nullptr )
+        return nullptr;
+
+    while( m_apoParsedFeatures.empty() )
+    {
+        if( !ReadParsedFeatures() )
+            return nullptr;
+    }
+
+    OGRFeature *poFeature = m_apoParsedFeatures.front().release();
+    m_apoParsedFeatures.pop_front();
+    nNextFID = static_cast<int>(poFeature->GetFID()) + 1;
+    m_nFeaturesRead++;
+    return poFeature;
+}
+
+/************************************************************************/
+/*                        ClearParsedFeatures()                         */
+/*                                                                      */
+/*      Discard the features read ahead by the parallel reader.  The    */
+/*      caller is responsible for repositioning the file.               */
+/************************************************************************/
+
+void OGRCSVLayer::ClearParsedFeatures()
+{
+    m_apoParsedFeatures.clear();
+    m_osPendingData.clear();
+    m_bReadAhead = false;
+    m_bReadAheadEOF = false;
+}
+
 /************************************************************************/
 /*                           GetNextFeature()                           */
 /************************************************************************/
@@ -1785,11 +2312,19 @@ OGRFeature *OGRCSVLayer::GetNextFeature()
     if( bNeedRewindBeforeRead )
         ResetReading();
 
+    // Fetch directly the matching features if the attribute filter
+    // can be resolved with the attribute indexes.
+    OGRFeature *poIndexedFeature = nullptr;
+    if( GetNextFeatureFromAttrIndex(poIndexedFeature) )
+        return poIndexedFeature;
+
     // Read features till we find one that satisfies our current
     // spatial criteria.
     while( true )
     {
-        OGRFeature *poFeature = GetNextUnfilteredFeature();
+        OGRFeature *poFeature = m_nNumThreads > 1
+                                    ? GetNextParsedFeature()
+                                    : GetNextUnfilteredFeature();
         if( poFeature == nullptr )
             return nullptr;
 
@@ -1822,6 +2357,13 @@ int OGRCSVLayer::TestCapability( const char *pszCap )
         return TRUE;
     else if( EQUAL(pszCap, OLCMeasuredGeometries) )
         return TRUE;
+    else if( EQUAL(pszCap, OLCRandomRead) )
+        return !bInWriteMode &&
+               (HasLineIndex(false) ||
+                m_eLineIndexMode == LineIndexMode::YES);
+    else if( EQUAL(pszCap, OLCFastFeatureCount) )
+        return m_poFilterGeom == nullptr && m_poAttrQuery == nullptr &&
+               !bInWriteMode && HasLineIndex(false);
     else
         return FALSE;
 }
@@ -2531,7 +3073,10 @@ GIntBig OGRCSVLayer::GetFeatureCount( int bForce )
     if( m_poFilterGeom != nullptr || m_poAttrQuery != nullptr )
     {
         GIntBig nRet = OGRLayer::GetFeatureCount(bForce);
-        if( nRet >= 0 )
+        // If the attribute indexes were used, we did not go through
+        // the whole file.
+        if( nRet >= 0 &&
+            !(m_poAttrQuery != nullptr && m_poAttrQuery->CanUseIndex(this)) )
         {
             nTotalFeatures = nNextFID - 1;
         }
@@ -2544,6 +3089,12 @@ GIntBig OGRCSVLayer::GetFeatureCount( int bForce )
     if( fpCSV == nullptr )
         return 0;
 
+    if( !bNeedRewindBeforeRead && HasLineIndex(CPL_TO_BOOL(bForce)) )
+    {
+        nTotalFeatures = m_nLineIndexRecordCount;
+        return nTotalFeatures;
+    }
+
     ResetReading();
 
     if( chDelimiter == '\t' && bDontHonourStrings )
@@ -2580,16 +3131,9 @@ GIntBig OGRCSVLayer::GetFeatureCount( int bForce )
     else
     {
         nTotalFeatures = 0;
-        while( true )
-        {
-            char **papszTokens = GetNextLineTokens();
-            if( papszTokens == nullptr )
-                break;
-
+        OGRCSVRecordReader *poReader = GetRecordReader();
+        while( poReader->NextRecord() )
             nTotalFeatures++;
-
-            CSLDestroy(papszTokens);
-        }
     }
 
     ResetReading();
@@ -0,0 +1,433 @@
+/******************************************************************************
+ *
+ * Project:  CSV Translator
+ * Purpose:  Implements OGRCSVRecordReader, an allocation-free tokenizer of
+ *           CSV records.
+ * Author:   GDAL project
+ *
+ ******************************************************************************
+ * Copyright (c) 2020, GDAL project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "ogr_csv.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "cpl_vsi.h"
+
+#if defined(__x86_64) || defined(_M_X64)
+#include <emmintrin.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+CPL_CVSID("$Id$")
+
+constexpr size_t RECORD_READER_BUFFER_SIZE = 65536;
+
+/************************************************************************/
+/*                             FindAnyOf4()                             */
+/*                                                                      */
+/*      Return a pointer to the first occurrence of any of 4 bytes in   */
+/*      [p, pEnd), or pEnd.  On x86_64, the bytes are compared 16 at a  */
+/*      time with SSE2, or 32 at a time when building with AVX2.        */
+/************************************************************************/
+
+#if defined(__x86_64) || defined(_M_X64)
+static inline int CountTrailingZeros( unsigned int nMask )
+{
+#ifdef _MSC_VER
+    unsigned long nIdx = 0;
+    _BitScanForward(&nIdx, nMask);
+    return static_cast<int>(nIdx);
+#else
+    return __builtin_ctz(nMask);
+#endif
+}
+#endif
+
+static inline const char *FindAnyOf4( const char *p, const char *pEnd,
+                                      char ch0, char ch1, char ch2, char ch3 )
+{
+#if defined(__x86_64) || defined(_M_X64)
+#ifdef __AVX2__
+    {
+        const __m256i v0 = _mm256_set1_epi8(ch0);
+        const __m256i v1 = _mm256_set1_epi8(ch1);
+        const __m256i v2 = _mm256_set1_epi8(ch2);
+        const __m256i v3 = _mm256_set1_epi8(ch3);
+        while( pEnd - p >= 32 )
+        {
+            const __m256i v =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            const __m256i vMatch = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, v0),
+                                _mm256_cmpeq_epi8(v, v1)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, v2),
+                                _mm256_cmpeq_epi8(v, v3)));
+            const unsigned int nMask =
+                static_cast<unsigned int>(_mm256_movemask_epi8(vMatch));
+            if( nMask != 0 )
+                return p + CountTrailingZeros(nMask);
+            p += 32;
+        }
+    }
+#endif
+    const __m128i v0 = _mm_set1_epi8(ch0);
+    const __m128i v1 = _mm_set1_epi8(ch1);
+    const __m128i v2 = _mm_set1_epi8(ch2);
+    const __m128i v3 = _mm_set1_epi8(ch3);
+    while( pEnd - p >= 16 )
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const __m128i vMatch = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, v0), _mm_cmpeq_epi8(v, v1)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, v2), _mm_cmpeq_epi8(v, v3)));
+        const unsigned int nMask =
+            static_cast<unsigned int>(_mm_movemask_epi8(vMatch));
+        if( nMask != 0 )
+            return p + CountTrailingZeros(nMask);
+        p += 16;
+    }
+#endif
+    for( ; p < pEnd; ++p )
+    {
+        const char ch = *p;
+        if( ch == ch0 || ch == ch1 || ch == ch2 || ch == ch3 )
+            return p;
+    }
+    return pEnd;
+}
+
+/************************************************************************/
+/*                           FindRecordEnd()                            */
+/*                                                                      */
+/*      Return the end of the record starting at p, i.e. the first      */
+/*      line ending out of a quoted value, and set nEOLSize to the      */
+/*      size of that line ending.  Line endings are LF, CR, CR/LF or    */
+/*      LF/CR, as for CPLReadLineL().  Return nullptr if the record is  */
+/*      not complete and more data may follow.                          */
+/************************************************************************/
+
+static const char *FindRecordEnd( const char *p, const char *pEnd,
+                                  bool bHonourStrings, bool bEOF,
+                                  size_t &nEOLSize )
+{
+    const char chQuote = bHonourStrings ? '"' : '\n';
+    bool bInString = false;
+    const char *pszLastEOL = nullptr;
+    size_t nLastEOLSize = 0;
+    while( true )
+    {
+        p = FindAnyOf4(p, pEnd, chQuote, '\r', '\n', chQuote);
+        if( p == pEnd )
+            break;
+        if( *p == '"' )
+        {
+            bInString = !bInString;
+            p++;
+            continue;
+        }
+
+        // We need the next byte to know if this is a CR/LF or LF/CR pair.
+        if( p + 1 == pEnd && !bEOF )
+            return nullptr;
+        const size_t nSize =
+            p + 1 < pEnd && (p[1] == '\r' || p[1] == '\n') && p[1] != *p
+                ? 2 : 1;
+        if( !bInString )
+        {
+            nEOLSize = nSize;
+            return p;
+        }
+        pszLastEOL = p;
+        nLastEOLSize = nSize;
+        p += nSize;
+    }
+
+    if( !bEOF )
+        return nullptr;
+
+    // Unterminated quoted value at end of file. As OGRCSVReadParseLineL()
+    // joins lines, the line ending of the last one is not part of the
+    // record.
+    if( pszLastEOL != nullptr && pszLastEOL + nLastEOLSize == pEnd )
+    {
+        nEOLSize = nLastEOLSize;
+        return pszLastEOL;
+    }
+    nEOLSize = 0;
+    return pEnd;
+}
+
+/************************************************************************/
+/*                         OGRCSVRecordReader()                         */
+/************************************************************************/
+
+OGRCSVRecordReader::OGRCSVRecordReader( VSILFILE *fp, char chDelimiter,
+                                        bool bHonourStrings,
+                                        bool bMergeDelimiter ) :
+    m_fp(fp),
+    m_chDelimiter(chDelimiter),
+    m_bHonourStrings(bHonourStrings),
+    // Consecutive tabs are never merged when quotes are not honoured.
+    m_bMergeDelimiter(bMergeDelimiter && bHonourStrings),
+    m_bEOF(fp == nullptr)
+{
+    if( fp != nullptr )
+        m_nBufferOffset = VSIFTellL(fp);
+}
+
+/************************************************************************/
+/*                              SetData()                               */
+/*                                                                      */
+/*      Read records from osData, which must start at a record          */
+/*      boundary, instead of a file.  The content of osData is taken.   */
+/************************************************************************/
+
+void OGRCSVRecordReader::SetData( std::string &osData )
+{
+    m_osBuffer.swap(osData);
+    m_nPos = 0;
+    m_nEnd = m_osBuffer.size();
+    m_osBuffer.push_back('\0');
+    m_bEOF = true;
+}
+
+/************************************************************************/
+/*                          TakeBufferedData()                          */
+/*                                                                      */
+/*      Return the data read from the file but not consumed yet, which  */
+/*      starts at the next record.                                      */
+/************************************************************************/
+
+void OGRCSVRecordReader::TakeBufferedData( std::string &osData )
+{
+    osData.assign(m_osBuffer, m_nPos, m_nEnd - m_nPos);
+    m_nPos = m_nEnd;
+}
+
+/************************************************************************/
+/*                             FillBuffer()                             */
+/************************************************************************/
+
+void OGRCSVRecordReader::FillBuffer()
+{
+    if( m_bEOF )
+        return;
+
+    // Move the unconsumed data to the start of the buffer, and grow it
+    // if it is full, which happens when a record is larger than it.
+    if( m_nPos > 0 )
+    {
+        memmove(&m_osBuffer[0], &m_osBuffer[m_nPos], m_nEnd - m_nPos);
+        m_nBufferOffset += m_nPos;
+        m_nEnd -= m_nPos;
+        m_nPos = 0;
+    }
+    if( m_osBuffer.empty() )
+        m_osBuffer.resize(RECORD_READER_BUFFER_SIZE + 1);
+    else if( m_nEnd + 1 == m_osBuffer.size() )
+        m_osBuffer.resize(2 * m_nEnd + 1);
+
+    const size_t nToRead = m_osBuffer.size() - 1 - m_nEnd;
+    const size_t nRead = VSIFReadL(&m_osBuffer[m_nEnd], 1, nToRead, m_fp);
+    m_nEnd += nRead;
+    if( nRead < nToRead )
+        m_bEOF = true;
+}
+
+/************************************************************************/
+/*                             NextRecord()                             */
+/*                                                                      */
+/*      Advance to the next record, skipping empty lines.  Return       */
+/*      false at end of file.                                           */
+/************************************************************************/
+
+bool OGRCSVRecordReader::NextRecord()
+{
+    while( true )
+    {
+        if( m_nPos == m_nEnd && m_bEOF )
+            return false;
+
+        const char *pszStart = m_osBuffer.data() + m_nPos;
+        size_t nEOLSize = 0;
+        const char *pszRecordEnd =
+            FindRecordEnd(pszStart, m_osBuffer.data() + m_nEnd,
+                          m_bHonourStrings, m_bEOF, nEOLSize);
+        if( pszRecordEnd == nullptr )
+        {
+            FillBuffer();
+            continue;
+        }
+
+        m_nRecordOffset = m_nBufferOffset + m_nPos;
+        size_t nRecordStart = m_nPos;
+        const size_t nRecordEnd =
+            static_cast<size_t>(pszRecordEnd - m_osBuffer.data());
+        m_nPos = nRecordEnd + nEOLSize;
+
+        // Skip BOM.
+        const GByte *pabyData =
+            reinterpret_cast<const GByte *>(pszStart);
+        if( nRecordEnd - nRecordStart >= 3 &&
+            pabyData[0] == 0xEF && pabyData[1] == 0xBB && pabyData[2] == 0xBF )
+        {
+            nRecordStart += 3;
+        }
+
+        if( nRecordStart < nRecordEnd )
+        {
+            m_nRecordStart = nRecordStart;
+            m_nRecordEnd = nRecordEnd;
+            return true;
+        }
+    }
+}
+
+/************************************************************************/
+/*                            SplitRecord()                             */
+/*                                                                      */
+/*      Split the current record into fields, with the semantics of     */
+/*      CSVSplitLine() in ogrcsvlayer.cpp: doubled quotes in a quoted   */
+/*      value resolve to one quote, and line endings in a quoted value  */
+/*      to a LF.  Fields are unescaped and nul-terminated in place in   */
+/*      the buffer.  The returned list is valid until the next call to  */
+/*      NextRecord(), and may be modified by the caller.                */
+/************************************************************************/
+
+char **OGRCSVRecordReader::SplitRecord()
+{
+    m_apszFields.clear();
+
+    char *p = &m_osBuffer[m_nRecordStart];
+    char *const pEnd = &m_osBuffer[m_nRecordEnd];
+    char *pszOut = p;
+    char *pszField = p;
+    bool bInString = false;
+    char chLast = '\0';
+
+    const char chDelimiter = m_chDelimiter;
+    const char chQuote = m_bHonourStrings ? '"' : chDelimiter;
+    while( true )
+    {
+        char *pszSpecial = const_cast<char *>(
+            FindAnyOf4(p, pEnd, chDelimiter, chQuote, '\r', '\n'));
+        if( pszSpecial != p )
+        {
+            const size_t nLen = static_cast<size_t>(pszSpecial - p);
+            if( pszOut != p )
+                memmove(pszOut, p, nLen);
+            pszOut += nLen;
+            chLast = pszSpecial[-1];
+            p = pszSpecial;
+        }
+        if( p == pEnd )
+            break;
+
+        const char ch = *p;
+        chLast = ch;
+        if( ch == chDelimiter && !bInString )
+        {
+            p++;
+            if( m_bMergeDelimiter )
+            {
+                while( p < pEnd && *p == chDelimiter )
+                    p++;
+            }
+            *pszOut = '\0';
+            m_apszFields.push_back(pszField);
+            pszOut++;
+            pszField = pszOut;
+        }
+        else if( ch == '"' && m_bHonourStrings )
+        {
+            if( bInString && p + 1 < pEnd && p[1] == '"' )
+            {
+                // Doubled quotes in string resolve to one quote.
+                *pszOut++ = '"';
+                p += 2;
+            }
+            else
+            {
+                bInString = !bInString;
+                p++;
+            }
+        }
+        else if( ch == '\r' || ch == '\n' )
+        {
+            // Can only be in a quoted value, whose lines are joined with
+            // a LF.
+            *pszOut++ = '\n';
+            chLast = '\n';
+            p += p + 1 < pEnd && (p[1] == '\r' || p[1] == '\n') &&
+                 p[1] != ch ? 2 : 1;
+        }
+        else
+        {
+            // Delimiter in a quoted value.
+            *pszOut++ = ch;
+            p++;
+        }
+    }
+
+    *pszOut = '\0';
+    m_apszFields.push_back(pszField);
+    // Like CSVSplitLine(), add an empty field if an unterminated quoted
+    // value ends with a delimiter.
+    if( bInString && chLast == chDelimiter )
+        m_apszFields.push_back(m_szEmptyField);
+    m_apszFields.push_back(nullptr);
+
+    return m_apszFields.data();
+}
+
+/************************************************************************/
+/*                       GetCompleteRecordsSize()                       */
+/*                                                                      */
+/*      Return the size of the longest prefix of a buffer starting at   */
+/*      a record boundary that is made of complete records.             */
+/************************************************************************/
+
+size_t OGRCSVRecordReader::GetCompleteRecordsSize( const char *pabyData,
+                                                   size_t nSize,
+                                                   bool bHonourStrings )
+{
+    const char *p = pabyData;
+    const char *const pEnd = pabyData + nSize;
+    while( true )
+    {
+        size_t nEOLSize = 0;
+        const char *pszRecordEnd =
+            FindRecordEnd(p, pEnd, bHonourStrings, false, nEOLSize);
+        if( pszRecordEnd == nullptr )
+            break;
+        p = pszRecordEnd + nEOLSize;
+    }
+    return static_cast<size_t>(p - pabyData);
+}
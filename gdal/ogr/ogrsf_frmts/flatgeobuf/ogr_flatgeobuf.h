@@ -36,7 +36,11 @@
 #include "feature_generated.h"
 #include "packedrtree.h"
 
+#include <deque>
 #include <limits>
+#include <memory>
+
+class CPLWorkerThreadPool;
 
 class OGRFlatGeobufDataset;
 
@@ -92,6 +96,16 @@ class OGRFlatGeobufLayer final : public OGRLayer
         bool m_ignoreSpatialFilter = false;
         bool m_ignoreAttributeFilter = false;
 
+        // batched reads of the features found in spatial index search
+        struct FeatureBatch;
+        struct FeatureDecodeJob;
+        int m_nNumThreads = 1;
+        std::unique_ptr<CPLWorkerThreadPool> m_poWorkerThreadPool;
+        std::unique_ptr<FeatureBatch> m_poPendingBatch; // batch being read
+        std::deque<std::unique_ptr<OGRFeature>> m_apoBatchFeatures; // decoded features not yet returned (nullptr on error)
+        std::string m_osBatchError; // error message of the failed decoded feature
+        size_t m_nextBatchItem = 0; // index in m_foundItems of the first item not yet submitted
+
         // creation
         bool m_create = false;
         std::vector<std::shared_ptr<FlatGeobuf::Item>> m_featureItems; // feature item description used to create spatial index
@@ -112,6 +126,13 @@ class OGRFlatGeobufLayer final : public OGRLayer
         void ensurePadfBuffers(size_t count);
         OGRErr ensureFeatureBuf(uint32_t featureSize);
         OGRErr parseFeature(OGRFeature *poFeature);
+        OGRErr decodeFeature(OGRFeature *poFeature, const GByte *featureBuf, uint32_t featureSize) const;
+        std::unique_ptr<FeatureBatch> submitFeatureBatch();
+        void decodeFeatureBatch(FeatureBatch &batch);
+        void readNextFeatureBatch();
+        void clearFeatureBatches();
+        static void decodeFeaturesJob(void *pData);
+        CPLWorkerThreadPool *getWorkerThreadPool();
         const std::vector<flatbuffers::Offset<FlatGeobuf::Column>> writeColumns(flatbuffers::FlatBufferBuilder &fbb);
         void readColumns();
         OGRErr readIndex();
@@ -119,6 +140,8 @@ class OGRFlatGeobufLayer final : public OGRLayer
 
         // serialize
         void Create();
+        void sortFeatureItems(const FlatGeobuf::NodeItem &extent);
+        bool writeSortedFeatures(uint64_t tempFileSize, size_t &written);
         void writeHeader(VSILFILE *poFp, uint64_t featuresCount, std::vector<double> *extentVector);
 
         OGRwkbGeometryType getOGRwkbGeometryType();
@@ -142,6 +165,7 @@ class OGRFlatGeobufLayer final : public OGRLayer
                 { return OGRLayer::GetExtent(iGeomField, psExtent, bForce); }
 
         void VerifyBuffers( int bFlag ) { m_bVerifyBuffers = CPL_TO_BOOL(bFlag); }
+        void SetNumThreads( int nNumThreads ) { m_nNumThreads = nNumThreads; }
 
         const std::string& GetFilename() const { return m_osFilename; }
 };
@@ -153,7 +177,7 @@ class OGRFlatGeobufDataset final: public GDALDataset
         bool m_bCreate = false;
         bool m_bIsDir = false;
 
-        bool OpenFile(const char* pszFilename, VSILFILE* fp, bool bVerifyBuffers);
+        bool OpenFile(const char* pszFilename, VSILFILE* fp, bool bVerifyBuffers, int nNumThreads);
 
     public:
         explicit OGRFlatGeobufDataset(const char *pszName, bool bIsDir, bool bCreate);
@@ -27,6 +27,7 @@
  ****************************************************************************/
 
 #include "ogr_flatgeobuf.h"
+#include "ogr_p.h"
 
 #include <memory>
 
@@ -137,10 +138,12 @@ void RegisterOGRFlatGeobuf()
 "<LayerCreationOptionList>"
 "  <Option name='SPATIAL_INDEX' type='boolean' description='Whether to create a spatial index' default='YES'/>"
 "  <Option name='TEMPORARY_DIR' type='string' description='Directory where temporary file should be created'/>"
+"  <Option name='NUM_THREADS' type='string' description='Number of worker threads used to sort features for the spatial index. Can be set to ALL_CPUS' default='1'/>"
 "</LayerCreationOptionList>");
     poDriver->SetMetadataItem(GDAL_DMD_OPENOPTIONLIST,
 "<OpenOptionList>"
 "  <Option name='VERIFY_BUFFERS' type='boolean' description='Verify flatbuffers integrity' default='YES'/>"
+"  <Option name='NUM_THREADS' type='string' description='Number of worker threads used to decode features found with the spatial index. Can be set to ALL_CPUS' default='1'/>"
 "</OpenOptionList>");
 
     poDriver->pfnOpen = OGRFlatGeobufDataset::Open;
@@ -187,6 +190,8 @@ GDALDataset *OGRFlatGeobufDataset::Open(GDALOpenInfo* poOpenInfo)
 
     const auto bVerifyBuffers = CPLFetchBool( poOpenInfo->papszOpenOptions, "VERIFY_BUFFERS", true );
 
+    const int nNumThreads = OGRGetNumThreads(poOpenInfo->papszOpenOptions);
+
     auto poDS = std::unique_ptr<OGRFlatGeobufDataset>(
         new OGRFlatGeobufDataset(poOpenInfo->pszFilename,
                                  CPL_TO_BOOL(poOpenInfo->bIsDirectory),
@@ -221,7 +226,7 @@ GDALDataset *OGRFlatGeobufDataset::Open(GDALOpenInfo* poOpenInfo)
                 VSILFILE* fp = VSIFOpenL(osFilename, "rb");
                 if( fp )
                 {
-                    if (!poDS->OpenFile(osFilename, fp, bVerifyBuffers))
+                    if (!poDS->OpenFile(osFilename, fp, bVerifyBuffers, nNumThreads))
                         VSIFCloseL(fp);
                 }
             }
@@ -230,7 +235,7 @@ GDALDataset *OGRFlatGeobufDataset::Open(GDALOpenInfo* poOpenInfo)
     else
     {
         if (poOpenInfo->fpL != nullptr) {
-            if (poDS->OpenFile(poOpenInfo->pszFilename, poOpenInfo->fpL, bVerifyBuffers))
+            if (poDS->OpenFile(poOpenInfo->pszFilename, poOpenInfo->fpL, bVerifyBuffers, nNumThreads))
                 poOpenInfo->fpL = nullptr;
         } else {
             return nullptr;
@@ -243,7 +248,7 @@ GDALDataset *OGRFlatGeobufDataset::Open(GDALOpenInfo* poOpenInfo)
 /*                           OpenFile()                                 */
 /************************************************************************/
 
-bool OGRFlatGeobufDataset::OpenFile(const char* pszFilename, VSILFILE* fp, bool bVerifyBuffers)
+bool OGRFlatGeobufDataset::OpenFile(const char* pszFilename, VSILFILE* fp, bool bVerifyBuffers, int nNumThreads)
 {
     uint64_t offset = sizeof(magicbytes);
     CPLDebug("FlatGeobuf", "Start at offset: %lu", static_cast<long unsigned int>(offset));
@@ -310,6 +315,10 @@ bool OGRFlatGeobufDataset::OpenFile(const char* pszFilename, VSILFILE* fp, bool
     auto poLayer = std::unique_ptr<OGRFlatGeobufLayer>(
         new OGRFlatGeobufLayer(header, buf.release(), pszFilename, fp, offset));
     poLayer->VerifyBuffers(bVerifyBuffers);
+    poLayer->SetNumThreads(nNumThreads);
+    // Attribute indexes rely on GetFeature(), which needs the spatial index
+    if (index_node_size > 0)
+        poLayer->InitializeSidecarIndexSupport(pszFilename);
 
     m_apoLayers.push_back(std::move(poLayer));
 
@@ -467,6 +476,7 @@ OGRLayer* OGRFlatGeobufDataset::ICreateLayer( const char *pszLayerName,
     // Create a layer.
     auto poLayer = std::unique_ptr<OGRFlatGeobufLayer>(
         new OGRFlatGeobufLayer(pszLayerName, osFilename, poSpatialRef, eGType, poFpWrite, osTempFile, bCreateSpatialIndexAtClose));
+    poLayer->SetNumThreads(OGRGetNumThreads(papszOptions));
 
     m_apoLayers.push_back(std::move(poLayer));
 
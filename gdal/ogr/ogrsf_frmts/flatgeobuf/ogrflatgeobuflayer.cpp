@@ -31,6 +31,7 @@
 #include "cpl_conv.h"
 #include "cpl_json.h"
 #include "cpl_http.h"
+#include "cpl_worker_thread_pool.h"
 #include "ogr_p.h"
 
 #include "ogr_flatgeobuf.h"
@@ -309,6 +310,360 @@ void OGRFlatGeobufLayer::writeHeader(VSILFILE *poFp, uint64_t featuresCount, std
     m_writeOffset += c;
 }
 
+CPLWorkerThreadPool *OGRFlatGeobufLayer::getWorkerThreadPool()
+{
+    if (m_nNumThreads > 1 && m_poWorkerThreadPool == nullptr) {
+        m_poWorkerThreadPool.reset(new CPLWorkerThreadPool());
+        if (!m_poWorkerThreadPool->Setup(m_nNumThreads, nullptr, nullptr)) {
+            m_poWorkerThreadPool.reset();
+            m_nNumThreads = 1;
+        }
+    }
+    return m_poWorkerThreadPool.get();
+}
+
+namespace {
+
+// Same as in packedrtree.cpp
+constexpr uint32_t hilbertMax = (1 << 16) - 1;
+
+struct HilbertSortKey {
+    uint32_t hilbert;
+    size_t index; // index in m_featureItems before sorting
+    bool operator< (const HilbertSortKey &other) const {
+        // decreasing Hilbert value, as hilbertSort()
+        return hilbert > other.hilbert ||
+               (hilbert == other.hilbert && index < other.index);
+    }
+};
+
+struct HilbertSortJob {
+    const std::vector<std::shared_ptr<Item>> *items;
+    const NodeItem *extent;
+    std::vector<HilbertSortKey> *keys;
+    size_t start;
+    size_t middle; // only for merge jobs
+    size_t end;
+};
+
+void sortHilbertKeysJob(void *pData)
+{
+    const auto psJob = static_cast<HilbertSortJob *>(pData);
+    auto &keys = *(psJob->keys);
+    for (size_t i = psJob->start; i < psJob->end; i++) {
+        keys[i].hilbert = hilbert((*psJob->items)[i]->nodeItem, hilbertMax, *(psJob->extent));
+        keys[i].index = i;
+    }
+    std::sort(keys.begin() + psJob->start, keys.begin() + psJob->end);
+}
+
+void mergeHilbertKeysJob(void *pData)
+{
+    const auto psJob = static_cast<HilbertSortJob *>(pData);
+    auto &keys = *(psJob->keys);
+    std::inplace_merge(keys.begin() + psJob->start,
+                       keys.begin() + psJob->middle,
+                       keys.begin() + psJob->end);
+}
+
+// Copy the feature buffers of a run of the temporary file in the order of
+// the sorted feature items
+struct SortRunJob {
+    const std::vector<std::shared_ptr<Item>> *items;
+    const size_t *itemIndices;
+    size_t itemCount;
+    const GByte *runData;
+    uint64_t runOffset; // offset of runData in the temporary file
+    GByte *sortedRunData;
+};
+
+void sortRunJob(void *pData)
+{
+    const auto psJob = static_cast<SortRunJob *>(pData);
+    size_t pos = 0;
+    for (size_t i = 0; i < psJob->itemCount; i++) {
+        const auto featureItem = static_cast<const FeatureItem *>(
+            (*psJob->items)[psJob->itemIndices[i]].get());
+        memcpy(psJob->sortedRunData + pos,
+               psJob->runData + static_cast<size_t>(featureItem->offset - psJob->runOffset),
+               featureItem->size);
+        pos += featureItem->size;
+    }
+}
+
+}
+
+// Sort m_featureItems by Hilbert value of the center of their bounding box.
+// With NUM_THREADS, slices are sorted in parallel and then merged.
+void OGRFlatGeobufLayer::sortFeatureItems(const NodeItem &extent)
+{
+    const size_t count = m_featureItems.size();
+    std::vector<HilbertSortKey> keys(count);
+    const auto poPool = count > 10000 ? getWorkerThreadPool() : nullptr;
+    const size_t jobCount = poPool ? static_cast<size_t>(poPool->GetThreadCount()) : 1;
+    std::vector<HilbertSortJob> jobs(jobCount);
+    std::vector<void *> jobData;
+    for (size_t i = 0; i < jobCount; i++) {
+        jobs[i].items = &m_featureItems;
+        jobs[i].extent = &extent;
+        jobs[i].keys = &keys;
+        jobs[i].start = i * count / jobCount;
+        jobs[i].middle = 0;
+        jobs[i].end = (i + 1) * count / jobCount;
+        jobData.push_back(&jobs[i]);
+    }
+    if (poPool && poPool->SubmitJobs(sortHilbertKeysJob, jobData)) {
+        poPool->WaitCompletion();
+        // Merge sorted slices pairwise
+        std::vector<size_t> bounds;
+        for (const auto &job : jobs)
+            bounds.push_back(job.start);
+        bounds.push_back(count);
+        while (bounds.size() > 2) {
+            std::vector<HilbertSortJob> mergeJobs;
+            std::vector<size_t> newBounds;
+            for (size_t i = 0; i + 2 < bounds.size(); i += 2) {
+                HilbertSortJob job = jobs[0];
+                job.start = bounds[i];
+                job.middle = bounds[i + 1];
+                job.end = bounds[i + 2];
+                mergeJobs.push_back(job);
+                newBounds.push_back(bounds[i]);
+            }
+            if ((bounds.size() - 1) % 2 == 1)
+                newBounds.push_back(bounds[bounds.size() - 2]);
+            newBounds.push_back(count);
+            jobData.clear();
+            for (auto &job : mergeJobs)
+                jobData.push_back(&job);
+            if (poPool->SubmitJobs(mergeHilbertKeysJob, jobData)) {
+                poPool->WaitCompletion();
+            } else {
+                for (auto pData : jobData)
+                    mergeHilbertKeysJob(pData);
+            }
+            bounds = std::move(newBounds);
+        }
+    } else {
+        for (auto pData : jobData)
+            sortHilbertKeysJob(pData);
+        for (size_t i = 1; i < jobCount; i++) {
+            jobs[i].start = 0;
+            jobs[i].middle = jobs[i - 1].end;
+            mergeHilbertKeysJob(&jobs[i]);
+        }
+    }
+
+    std::vector<std::shared_ptr<Item>> sortedItems;
+    sortedItems.reserve(count);
+    for (const auto &key : keys)
+        sortedItems.push_back(std::move(m_featureItems[key.index]));
+    m_featureItems = std::move(sortedItems);
+}
+
+// Copy the feature buffers from the temporary file to the final file, in the
+// order of m_featureItems, with an external sort: the temporary file is read
+// sequentially by runs of OGR_FLATGEOBUF_SORT_RUN_SIZE bytes, each run is
+// sorted in memory (by a worker thread with NUM_THREADS, while the next run is
+// read) and written to a second temporary file, and the sorted runs are then
+// merged into the final file, which is written sequentially.
+bool OGRFlatGeobufLayer::writeSortedFeatures(uint64_t tempFileSize, size_t &written)
+{
+    const uint64_t runSize = std::max(
+        static_cast<uint64_t>(std::max(m_maxFeatureSize, 1024U)),
+        static_cast<uint64_t>(std::min(
+            CPLScanUIntBig(CPLGetConfigOption("OGR_FLATGEOBUF_SORT_RUN_SIZE",
+                                              "67108864"), 20),
+            static_cast<GUIntBig>(std::numeric_limits<size_t>::max() / 4))));
+    const size_t runCount = static_cast<size_t>((tempFileSize + runSize - 1) / runSize);
+
+    // A feature belongs to the run in which it starts. Group the indices of
+    // the sorted feature items by run, preserving their order.
+    const size_t count = m_featureItems.size();
+    std::vector<uint64_t> runStart(runCount, tempFileSize);
+    std::vector<uint64_t> runEnd(runCount, tempFileSize);
+    std::vector<size_t> runFirstItem(runCount + 1, 0);
+    for (const auto &item : m_featureItems) {
+        const auto featureItem = static_cast<const FeatureItem *>(item.get());
+        const size_t run = static_cast<size_t>(featureItem->offset / runSize);
+        runStart[run] = std::min(runStart[run], featureItem->offset);
+        runFirstItem[run + 1]++;
+    }
+    for (size_t run = 0; run < runCount; run++)
+        runFirstItem[run + 1] += runFirstItem[run];
+    for (size_t run = runCount - 1; run > 0; run--)
+        runEnd[run - 1] = runFirstItem[run] < runFirstItem[run + 1] ? runStart[run] : runEnd[run];
+    std::vector<size_t> runItemIndices(count);
+    {
+        std::vector<size_t> runPos(runFirstItem.begin(), runFirstItem.end() - 1);
+        for (size_t i = 0; i < count; i++) {
+            const auto featureItem = static_cast<const FeatureItem *>(m_featureItems[i].get());
+            runItemIndices[runPos[static_cast<size_t>(featureItem->offset / runSize)]++] = i;
+        }
+    }
+
+    const bool singleRun = runCount == 1;
+    VSILFILE *fpRuns = nullptr;
+    const std::string osRunsFile = m_oTempFile + "_runs";
+    if (!singleRun) {
+        fpRuns = VSIFOpenL(osRunsFile.c_str(), "w+b");
+        if (fpRuns == nullptr) {
+            CPLError(CE_Failure, CPLE_OpenFailed, "Failed to create %s",
+                     osRunsFile.c_str());
+            return false;
+        }
+        // Unlink it now to avoid stale temporary file if killing the process
+        // (only works on Unix)
+        VSIUnlink(osRunsFile.c_str());
+    }
+    struct RunsFileCloser {
+        VSILFILE *fp;
+        std::string osFilename;
+        ~RunsFileCloser() {
+            if (fp) {
+                VSIFCloseL(fp);
+                VSIUnlink(osFilename.c_str());
+            }
+        }
+    } runsFileCloser { fpRuns, osRunsFile };
+
+    // Sort runs
+    CPLDebugOnly("FlatGeobuf", "Sorting %lu runs", static_cast<long unsigned int>(runCount));
+    const auto poPool = getWorkerThreadPool();
+    std::vector<GByte> runData[2];
+    std::vector<GByte> sortedRunData[2];
+    SortRunJob jobs[2];
+    struct PoolWaiter {
+        CPLWorkerThreadPool *poPool;
+        ~PoolWaiter() {
+            if (poPool)
+                poPool->WaitCompletion();
+        }
+    } poolWaiter { poPool };
+    size_t slot = 0; // index in the above arrays for the run being read
+    size_t pendingSlot = 0;
+    size_t pendingRun = runCount; // run being sorted
+    const auto writeSortedRun = [&]() {
+        if (pendingRun == runCount)
+            return true;
+        if (poPool)
+            poPool->WaitCompletion();
+        const auto &data = sortedRunData[pendingSlot];
+        const bool ok = singleRun ?
+            VSIFWriteL(data.data(), 1, data.size(), m_poFp) == data.size() :
+            VSIFSeekL(fpRuns, runStart[pendingRun], SEEK_SET) == 0 &&
+            VSIFWriteL(data.data(), 1, data.size(), fpRuns) == data.size();
+        if (!ok) {
+            CPLErrorIO("writing sorted features");
+            return false;
+        }
+        pendingRun = runCount;
+        return true;
+    };
+    for (size_t run = 0; run < runCount; run++) {
+        if (runFirstItem[run] == runFirstItem[run + 1])
+            continue;
+        const size_t size = static_cast<size_t>(runEnd[run] - runStart[run]);
+        auto &data = runData[slot];
+        auto &sortedData = sortedRunData[slot];
+        try {
+            data.resize(size);
+            sortedData.resize(size);
+        } catch (const std::bad_alloc &) {
+            CPLErrorMemoryAllocation("sort run");
+            return false;
+        }
+        if (VSIFSeekL(m_poFpWrite, runStart[run], SEEK_SET) == -1 ||
+            VSIFReadL(data.data(), 1, size, m_poFpWrite) != size) {
+            CPLErrorIO("reading temp features");
+            return false;
+        }
+        if (!writeSortedRun())
+            return false;
+        auto &job = jobs[slot];
+        job.items = &m_featureItems;
+        job.itemIndices = runItemIndices.data() + runFirstItem[run];
+        job.itemCount = runFirstItem[run + 1] - runFirstItem[run];
+        job.runData = data.data();
+        job.runOffset = runStart[run];
+        job.sortedRunData = sortedData.data();
+        if (poPool == nullptr || !poPool->SubmitJob(sortRunJob, &job)) {
+            sortRunJob(&job);
+        }
+        pendingRun = run;
+        pendingSlot = slot;
+        slot = 1 - slot;
+    }
+    if (!writeSortedRun())
+        return false;
+    for (auto &data : runData)
+        std::vector<GByte>().swap(data);
+    for (auto &data : sortedRunData)
+        std::vector<GByte>().swap(data);
+
+    if (singleRun) {
+        written = static_cast<size_t>(runEnd[0] - runStart[0]);
+        return true;
+    }
+
+    // Merge runs. Each run is read sequentially in the runs file, since its
+    // features are in the final order.
+    CPLDebugOnly("FlatGeobuf", "Merging %lu runs", static_cast<long unsigned int>(runCount));
+    struct RunReader {
+        uint64_t offset;
+        uint64_t end;
+        std::vector<GByte> buffer;
+        size_t pos;
+        size_t size;
+    };
+    const size_t readerBufferSize = static_cast<size_t>(
+        std::max(static_cast<uint64_t>(65536), 2 * runSize / runCount));
+    std::vector<RunReader> readers(runCount);
+    for (size_t run = 0; run < runCount; run++) {
+        readers[run].offset = runStart[run];
+        readers[run].end = runEnd[run];
+        readers[run].pos = 0;
+        readers[run].size = 0;
+    }
+    written = 0;
+    for (const auto &item : m_featureItems) {
+        const auto featureItem = static_cast<const FeatureItem *>(item.get());
+        auto &reader = readers[static_cast<size_t>(featureItem->offset / runSize)];
+        const size_t featureSize = featureItem->size;
+        if (reader.size - reader.pos < featureSize) {
+            // Refill the buffer of the run
+            const size_t remaining = reader.size - reader.pos;
+            try {
+                if (reader.buffer.size() < std::max(readerBufferSize, featureSize))
+                    reader.buffer.resize(std::max(readerBufferSize, featureSize));
+            } catch (const std::bad_alloc &) {
+                CPLErrorMemoryAllocation("merge buffer");
+                return false;
+            }
+            memmove(reader.buffer.data(), reader.buffer.data() + reader.pos, remaining);
+            const size_t toRead = static_cast<size_t>(std::min(
+                static_cast<uint64_t>(reader.buffer.size() - remaining),
+                reader.end - reader.offset));
+            if (toRead + remaining < featureSize ||
+                VSIFSeekL(fpRuns, reader.offset, SEEK_SET) == -1 ||
+                VSIFReadL(reader.buffer.data() + remaining, 1, toRead, fpRuns) != toRead) {
+                CPLErrorIO("reading sorted features");
+                return false;
+            }
+            reader.offset += toRead;
+            reader.pos = 0;
+            reader.size = remaining + toRead;
+        }
+        if (VSIFWriteL(reader.buffer.data() + reader.pos, 1, featureSize, m_poFp) != featureSize) {
+            CPLErrorIO("writing feature");
+            return false;
+        }
+        reader.pos += featureSize;
+        written += featureSize;
+    }
+    return true;
+}
+
 void OGRFlatGeobufLayer::Create() {
     // no spatial index requested, we are done
     if (!m_bCreateSpatialIndexAtClose)
@@ -348,7 +703,7 @@ void OGRFlatGeobufLayer::Create() {
     writeHeader(m_poFp, m_featuresCount, &extentVector);
 
     CPLDebugOnly("FlatGeobuf", "Sorting items for Packed R-tree");
-    hilbertSort(m_featureItems);
+    sortFeatureItems(extent);
     CPLDebugOnly("FlatGeobuf", "Calc new feature offsets");
     uint64_t featureOffset = 0;
     for (auto item : m_featureItems) {
@@ -373,94 +728,14 @@ void OGRFlatGeobufLayer::Create() {
 
     c = 0;
 
-    // For temporary files not in memory, we use a batch strategy to write the
-    // final file. That is to say we try to separate reads in the source temporary
-    // file and writes in the target file as much as possible, and by reading
-    // source features in increasing offset within a batch.
-    const bool bUseBatchStragegy = !STARTS_WITH(m_oTempFile.c_str(), "/vsimem/");
-    if( bUseBatchStragegy )
+    // For temporary files not in memory, the feature buffers are copied to the
+    // final file with an external sort, so that both files are accessed
+    // sequentially.
+    const bool bUseExternalSort = !STARTS_WITH(m_oTempFile.c_str(), "/vsimem/");
+    if( bUseExternalSort )
     {
-        const uint32_t nMaxBufferSize = std::max(m_maxFeatureSize,
-            static_cast<uint32_t>(std::min(
-                static_cast<uint64_t>(100 * 1024 * 1024), nTempFileSize)));
-        if( ensureFeatureBuf(nMaxBufferSize) != OGRERR_NONE )
-            return;
-        uint32_t offsetInBuffer = 0;
-        struct BatchItem
-        {
-            size_t   featureIdx; // index of m_featureItems[]
-            uint32_t offsetInBuffer;
-        };
-        std::vector<BatchItem> batch;
-
-        const auto flushBatch = [this, &batch, &offsetInBuffer]()
-        {
-            // Sort by increasing source offset
-            std::sort(
-                batch.begin(), batch.end(),
-                [this](const BatchItem& a, const BatchItem& b)
-                {
-                    return std::static_pointer_cast<FeatureItem>(
-                                m_featureItems[a.featureIdx])->offset
-                           < std::static_pointer_cast<FeatureItem>(
-                                m_featureItems[b.featureIdx])->offset;
-                }
-            );
-
-            // Read source features
-            for( const auto& batchItem: batch )
-            {
-                const auto item = std::static_pointer_cast<FeatureItem>(
-                    m_featureItems[batchItem.featureIdx]);
-                if (VSIFSeekL(m_poFpWrite, item->offset, SEEK_SET) == -1) {
-                    CPLErrorIO("seeking to temp feature location");
-                    return false;
-                }
-                if (VSIFReadL(m_featureBuf + batchItem.offsetInBuffer, 1,
-                              item->size, m_poFpWrite) != item->size) {
-                    CPLErrorIO("reading temp feature");
-                    return false;
-                }
-            }
-
-            // Write target features
-            if( offsetInBuffer > 0 &&
-                VSIFWriteL(m_featureBuf, 1, offsetInBuffer, m_poFp) !=
-                                                            offsetInBuffer ) {
-                CPLErrorIO("writing feature");
-                return false;
-            }
-
-            batch.clear();
-            offsetInBuffer = 0;
-            return true;
-        };
-
-        for (size_t i = 0; i < m_featuresCount; i++)
-        {
-            const auto featureItem = std::static_pointer_cast<FeatureItem>(m_featureItems[i]);
-            const auto featureSize = featureItem->size;
-
-            if( offsetInBuffer + featureSize > m_featureBufSize )
-            {
-                if( !flushBatch() )
-                {
-                    return;
-                }
-            }
-
-            BatchItem bachItem;
-            bachItem.offsetInBuffer = offsetInBuffer;
-            bachItem.featureIdx = i;
-            batch.emplace_back(bachItem);
-            offsetInBuffer += featureSize;
-            c += featureSize;
-        }
-
-        if( !flushBatch() )
-        {
+        if( !writeSortedFeatures(nTempFileSize, c) )
             return;
-        }
     }
     else
     {
@@ -501,6 +776,8 @@ OGRFlatGeobufLayer::~OGRFlatGeobufLayer()
     if (m_create)
         Create();
 
+    clearFeatureBatches();
+
     if (m_poFp)
         VSIFCloseL(m_poFp);
 
@@ -568,7 +845,7 @@ OGRFeature *OGRFlatGeobufLayer::GetFeature(GIntBig nFeatureId)
 
 OGRErr OGRFlatGeobufLayer::readIndex()
 {
-    if (m_queriedSpatialIndex || !m_poFilterGeom)
+    if (m_queriedSpatialIndex || !m_poFilterGeom || m_ignoreSpatialFilter)
         return OGRERR_NONE;
     if( m_sFilterEnvelope.IsInit() &&
         m_sExtent.IsInit() &&
@@ -633,6 +910,15 @@ OGRFeature *OGRFlatGeobufLayer::GetNextFeature()
     if (m_create)
         return nullptr;
 
+    // Fetch directly the features matching the attribute filter if it can
+    // be resolved with the attribute indexes (GetFeature() needs the
+    // spatial index to locate features)
+    if (!m_ignoreAttributeFilter && m_featuresCount > 0 && m_indexNodeSize > 0) {
+        OGRFeature *poIndexedFeature = nullptr;
+        if (GetNextFeatureFromAttrIndex(poIndexedFeature))
+            return poIndexedFeature;
+    }
+
     while( true ) {
         if (m_featuresCount > 0 && m_featuresPos >= m_featuresCount) {
             CPLDebugOnly("FlatGeobuf", "GetNextFeature: iteration end at %lu", static_cast<long unsigned int>(m_featuresPos));
@@ -648,15 +934,30 @@ OGRFeature *OGRFlatGeobufLayer::GetNextFeature()
             return nullptr;
         }
 
-        auto poFeature = std::unique_ptr<OGRFeature>(new OGRFeature(m_poFeatureDefn));
-        if (parseFeature(poFeature.get()) != OGRERR_NONE) {
-            CPLError(CE_Failure, CPLE_AppDefined, "Fatal error parsing feature");
-            return nullptr;
-        }
+        std::unique_ptr<OGRFeature> poFeature;
+        if (m_queriedSpatialIndex && !m_ignoreSpatialFilter) {
+            if (m_apoBatchFeatures.empty())
+                readNextFeatureBatch();
+            if (m_apoBatchFeatures.empty())
+                return nullptr;
+            if (m_apoBatchFeatures.front() == nullptr) {
+                CPLError(CE_Failure, CPLE_AppDefined, "%s", m_osBatchError.c_str());
+                CPLError(CE_Failure, CPLE_AppDefined, "Fatal error parsing feature");
+                return nullptr;
+            }
+            poFeature = std::move(m_apoBatchFeatures.front());
+            m_apoBatchFeatures.pop_front();
+        } else {
+            poFeature.reset(new OGRFeature(m_poFeatureDefn));
+            if (parseFeature(poFeature.get()) != OGRERR_NONE) {
+                CPLError(CE_Failure, CPLE_AppDefined, "Fatal error parsing feature");
+                return nullptr;
+            }
 
-        if (VSIFEofL(m_poFp)) {
-            CPLDebug("FlatGeobuf", "GetNextFeature: iteration end due to EOF");
-            return nullptr;
+            if (VSIFEofL(m_poFp)) {
+                CPLDebug("FlatGeobuf", "GetNextFeature: iteration end due to EOF");
+                return nullptr;
+            }
         }
 
         m_featuresPos++;
@@ -667,6 +968,296 @@ OGRFeature *OGRFlatGeobufLayer::GetNextFeature()
     }
 }
 
+// Maximum number of features, and of bytes, read in a single batch
+static constexpr size_t batch_max_features = 1000;
+static constexpr size_t batch_max_buffer_size = 16 * 1024 * 1024;
+
+// Features found in spatial index search, read with a single multi-range
+// request and decoded by worker threads
+struct OGRFlatGeobufLayer::FeatureBatch {
+    size_t nFirstItem = 0; // index in m_foundItems of the first feature
+    size_t nItemCount = 0;
+    std::vector<size_t> anItemRange; // range holding each feature
+    std::vector<vsi_l_offset> anRangeOffsets;
+    std::vector<size_t> anRangeSizes;
+    std::vector<std::vector<GByte>> aabyRanges;
+    std::vector<void*> apRangeData;
+    VSIAsyncRead *psRead = nullptr;
+    bool bReadFailed = false;
+
+    // filled by decodeFeatureBatch()
+    std::vector<const GByte*> apabyFeatures;
+    std::vector<uint32_t> anFeatureSizes;
+    std::vector<std::vector<GByte>> aabyLargeFeatures; // features not fully read with their range
+    std::vector<std::unique_ptr<OGRFeature>> apoFeatures;
+    std::vector<std::string> aosErrors;
+
+    FeatureBatch() = default;
+    FeatureBatch(const FeatureBatch&) = delete;
+    FeatureBatch& operator=(const FeatureBatch&) = delete;
+    ~FeatureBatch() {
+        if (psRead != nullptr)
+            VSIAsyncReadFree(psRead);
+    }
+};
+
+struct OGRFlatGeobufLayer::FeatureDecodeJob {
+    const OGRFlatGeobufLayer *poLayer;
+    FeatureBatch *poBatch;
+    size_t nStart;
+    size_t nEnd;
+};
+
+void OGRFlatGeobufLayer::clearFeatureBatches()
+{
+    m_poPendingBatch.reset();
+    m_apoBatchFeatures.clear();
+    m_osBatchError.clear();
+    m_nextBatchItem = 0;
+}
+
+// Start reading the next features found in spatial index search. Features
+// close to each other are coalesced into a single range, so that remote
+// files are read with a few requests instead of one per feature.
+std::unique_ptr<OGRFlatGeobufLayer::FeatureBatch> OGRFlatGeobufLayer::submitFeatureBatch()
+{
+    if (m_nextBatchItem >= m_foundItems.size())
+        return nullptr;
+
+    if (m_nFileSize == 0) {
+        if (VSIFSeekL(m_poFp, 0, SEEK_END) == 0)
+            m_nFileSize = VSIFTellL(m_poFp);
+    }
+
+    // The size of a feature is only known once its size prefix is read,
+    // so the range of the last feature of a group is estimated from the
+    // average feature size. Larger features are completed afterwards.
+    uint64_t estimatedSize = 64 * 1024;
+    const auto featuresCount = m_poHeader->features_count();
+    if (m_nFileSize > m_offsetFeatures && featuresCount > 0) {
+        const uint64_t averageSize = (m_nFileSize - m_offsetFeatures) / featuresCount;
+        estimatedSize = std::min(std::max(2 * averageSize, static_cast<uint64_t>(1024)),
+                                 static_cast<uint64_t>(1024 * 1024));
+    }
+    // Remote file systems favor less requests over less bytes read
+    const uint64_t maxGap = VSIHasOptimizedReadMultiRange(m_osFilename.c_str()) ?
+        1024 * 1024 : 16 * 1024;
+
+    auto batch = std::unique_ptr<FeatureBatch>(new FeatureBatch());
+    batch->nFirstItem = m_nextBatchItem;
+    uint64_t rangeStart = 0;
+    uint64_t rangeEnd = 0;
+    uint64_t totalSize = 0;
+    size_t i = m_nextBatchItem;
+    for (; i < m_foundItems.size() && i - m_nextBatchItem < batch_max_features; i++) {
+        const uint64_t start = m_offsetFeatures + m_foundItems[i].offset;
+        uint64_t end = start + estimatedSize;
+        if (i + 1 < m_foundItems.size()) {
+            // Features cannot overlap
+            const uint64_t nextStart = m_offsetFeatures + m_foundItems[i + 1].offset;
+            if (nextStart > start)
+                end = std::min(end, nextStart);
+        }
+        if (m_nFileSize > 0)
+            end = std::min(end, static_cast<uint64_t>(m_nFileSize));
+        end = std::max(end, start + sizeof(uint32_t));
+
+        const bool newRange = batch->anItemRange.empty() || start < rangeStart || start > rangeEnd + maxGap;
+        const uint64_t newTotalSize = newRange ?
+            totalSize + (rangeEnd - rangeStart) + (end - start) :
+            totalSize + (std::max(rangeEnd, end) - rangeStart);
+        if (!batch->anItemRange.empty() && newTotalSize > batch_max_buffer_size)
+            break;
+        if (newRange) {
+            if (!batch->anItemRange.empty()) {
+                totalSize += rangeEnd - rangeStart;
+                batch->anRangeOffsets.push_back(rangeStart);
+                batch->anRangeSizes.push_back(static_cast<size_t>(rangeEnd - rangeStart));
+            }
+            rangeStart = start;
+            rangeEnd = end;
+        } else {
+            rangeEnd = std::max(rangeEnd, end);
+        }
+        batch->anItemRange.push_back(batch->anRangeOffsets.size());
+    }
+    batch->anRangeOffsets.push_back(rangeStart);
+    batch->anRangeSizes.push_back(static_cast<size_t>(rangeEnd - rangeStart));
+    batch->nItemCount = batch->anItemRange.size();
+    m_nextBatchItem += batch->nItemCount;
+
+    const auto rangeCount = batch->anRangeOffsets.size();
+    CPLDebugOnly("FlatGeobuf", "Reading %lu features with %lu range requests",
+                 static_cast<long unsigned int>(batch->nItemCount),
+                 static_cast<long unsigned int>(rangeCount));
+    try {
+        batch->aabyRanges.resize(rangeCount);
+        for (size_t j = 0; j < rangeCount; j++) {
+            batch->aabyRanges[j].resize(batch->anRangeSizes[j]);
+            batch->apRangeData.push_back(batch->aabyRanges[j].data());
+        }
+    } catch (const std::bad_alloc &) {
+        CPLErrorMemoryAllocation("feature batch");
+        batch->bReadFailed = true;
+        return batch;
+    }
+    batch->psRead = VSIFReadMultiRangeAsyncL(static_cast<int>(rangeCount),
+                                             batch->apRangeData.data(),
+                                             batch->anRangeOffsets.data(),
+                                             batch->anRangeSizes.data(),
+                                             m_poFp);
+    if (batch->psRead == nullptr) {
+        batch->bReadFailed = VSIFReadMultiRangeL(static_cast<int>(rangeCount),
+                                                 batch->apRangeData.data(),
+                                                 batch->anRangeOffsets.data(),
+                                                 batch->anRangeSizes.data(),
+                                                 m_poFp) != 0;
+    }
+    return batch;
+}
+
+void OGRFlatGeobufLayer::decodeFeaturesJob(void *pData)
+{
+    const auto psJob = static_cast<FeatureDecodeJob *>(pData);
+    const auto poLayer = psJob->poLayer;
+    auto &batch = *(psJob->poBatch);
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    for (size_t i = psJob->nStart; i < psJob->nEnd; i++) {
+        auto poFeature = std::unique_ptr<OGRFeature>(new OGRFeature(poLayer->m_poFeatureDefn));
+        poFeature->SetFID(static_cast<GIntBig>(poLayer->m_foundItems[batch.nFirstItem + i].index));
+        CPLErrorReset();
+        if (poLayer->decodeFeature(poFeature.get(), batch.apabyFeatures[i], batch.anFeatureSizes[i]) != OGRERR_NONE) {
+            batch.aosErrors[i] = CPLGetLastErrorMsg();
+            break;
+        }
+        batch.apoFeatures[i] = std::move(poFeature);
+    }
+    CPLPopErrorHandler();
+}
+
+// Wait for the features of a batch to be read, and decode them (in parallel
+// when NUM_THREADS is set) into m_apoBatchFeatures. In case of error, a
+// null feature is queued after the valid ones.
+void OGRFlatGeobufLayer::decodeFeatureBatch(FeatureBatch &batch)
+{
+    size_t count = batch.nItemCount;
+    std::string osError;
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    CPLErrorReset();
+    if (batch.psRead != nullptr) {
+        if (VSIAsyncReadWait(batch.psRead) != 0)
+            batch.bReadFailed = true;
+        VSIAsyncReadFree(batch.psRead);
+        batch.psRead = nullptr;
+    }
+    if (batch.bReadFailed) {
+        if (CPLGetLastErrorType() == CE_None)
+            CPLErrorIO("reading features");
+        osError = CPLGetLastErrorMsg();
+        count = 0;
+    }
+
+    // Locate each feature in the range buffers
+    batch.apabyFeatures.resize(count);
+    batch.anFeatureSizes.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const uint64_t start = m_offsetFeatures + m_foundItems[batch.nFirstItem + i].offset;
+        const auto &range = batch.aabyRanges[batch.anItemRange[i]];
+        const size_t pos = static_cast<size_t>(start - batch.anRangeOffsets[batch.anItemRange[i]]);
+        uint32_t featureSize;
+        if (pos + sizeof(featureSize) > range.size()) {
+            CPLErrorIO("reading feature size");
+            count = i;
+            break;
+        }
+        memcpy(&featureSize, range.data() + pos, sizeof(featureSize));
+        CPL_LSBPTR32(&featureSize);
+        if (featureSize > feature_max_buffer_size) {
+            CPLErrorInvalidSize("feature");
+            count = i;
+            break;
+        }
+        if (m_nFileSize > 0 && start + sizeof(featureSize) + featureSize > m_nFileSize) {
+            CPLErrorIO("reading feature size");
+            count = i;
+            break;
+        }
+        const size_t available = range.size() - pos - sizeof(featureSize);
+        if (featureSize <= available) {
+            batch.apabyFeatures[i] = range.data() + pos + sizeof(featureSize);
+        } else {
+            // Read the remaining part of features larger than the estimate
+            try {
+                batch.aabyLargeFeatures.emplace_back(featureSize);
+            } catch (const std::bad_alloc &) {
+                CPLErrorMemoryAllocation("feature buffer");
+                count = i;
+                break;
+            }
+            auto &featureBuf = batch.aabyLargeFeatures.back();
+            memcpy(featureBuf.data(), range.data() + pos + sizeof(featureSize), available);
+            if (VSIFSeekL(m_poFp, start + sizeof(featureSize) + available, SEEK_SET) == -1 ||
+                VSIFReadL(featureBuf.data() + available, 1, featureSize - available, m_poFp) != featureSize - available) {
+                CPLErrorIO("reading feature");
+                count = i;
+                break;
+            }
+            batch.apabyFeatures[i] = featureBuf.data();
+        }
+        batch.anFeatureSizes[i] = featureSize;
+    }
+    if (count < batch.nItemCount && osError.empty())
+        osError = CPLGetLastErrorMsg();
+    CPLPopErrorHandler();
+
+    // Decode them
+    batch.apoFeatures.resize(count);
+    batch.aosErrors.resize(count);
+    const auto poPool = count > 1 ? getWorkerThreadPool() : nullptr;
+    const size_t jobCount = poPool ?
+        std::min(static_cast<size_t>(poPool->GetThreadCount()), count) : 1;
+    std::vector<FeatureDecodeJob> jobs(jobCount);
+    std::vector<void*> jobData;
+    for (size_t i = 0; i < jobCount; i++) {
+        jobs[i].poLayer = this;
+        jobs[i].poBatch = &batch;
+        jobs[i].nStart = i * count / jobCount;
+        jobs[i].nEnd = (i + 1) * count / jobCount;
+        jobData.push_back(&jobs[i]);
+    }
+    if (jobCount > 1 && poPool->SubmitJobs(decodeFeaturesJob, jobData)) {
+        poPool->WaitCompletion();
+    } else {
+        for (auto pData : jobData)
+            decodeFeaturesJob(pData);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (batch.apoFeatures[i] == nullptr) {
+            osError = batch.aosErrors[i];
+            count = i;
+            break;
+        }
+        m_apoBatchFeatures.push_back(std::move(batch.apoFeatures[i]));
+    }
+    if (count < batch.nItemCount) {
+        m_osBatchError = osError.empty() ? "Failed to decode feature" : osError;
+        m_apoBatchFeatures.push_back(nullptr);
+    }
+}
+
+void OGRFlatGeobufLayer::readNextFeatureBatch()
+{
+    auto batch = std::move(m_poPendingBatch);
+    if (batch == nullptr)
+        batch = submitFeatureBatch();
+    if (batch == nullptr)
+        return;
+    // Read the next batch while this one is decoded and consumed
+    m_poPendingBatch = submitFeatureBatch();
+    decodeFeatureBatch(*batch);
+}
+
 OGRErr OGRFlatGeobufLayer::ensureFeatureBuf(uint32_t featureSize) {
     if (m_featureBufSize == 0) {
         const auto newBufSize = std::max(1024U * 32U, featureSize);
@@ -689,17 +1280,11 @@ OGRErr OGRFlatGeobufLayer::ensureFeatureBuf(uint32_t featureSize) {
 }
 
 OGRErr OGRFlatGeobufLayer::parseFeature(OGRFeature *poFeature) {
-    GIntBig fid;
+    // Features found in spatial index search are read by
+    // readNextFeatureBatch()
+    CPLAssert(!m_queriedSpatialIndex || m_ignoreSpatialFilter);
     auto seek = false;
-    if (m_queriedSpatialIndex && !m_ignoreSpatialFilter) {
-        const auto item = m_foundItems[m_featuresPos];
-        m_offset = m_offsetFeatures + item.offset;
-        fid = item.index;
-        seek = true;
-    } else {
-        fid = m_featuresPos;
-    }
-    poFeature->SetFID(fid);
+    poFeature->SetFID(m_featuresPos);
 
 
     //CPLDebugOnly("FlatGeobuf", "m_featuresPos: %lu", static_cast<long unsigned int>(m_featuresPos));
@@ -748,8 +1333,12 @@ OGRErr OGRFlatGeobufLayer::parseFeature(OGRFeature *poFeature) {
         return CPLErrorIO("reading feature");
     m_offset += featureSize + sizeof(featureSize);
 
+    return decodeFeature(poFeature, m_featureBuf, featureSize);
+}
+
+OGRErr OGRFlatGeobufLayer::decodeFeature(OGRFeature *poFeature, const GByte *featureBuf, uint32_t featureSize) const {
     if (m_bVerifyBuffers) {
-        const auto vBuf = const_cast<const uint8_t *>(reinterpret_cast<uint8_t *>(m_featureBuf));
+        const auto vBuf = reinterpret_cast<const uint8_t *>(featureBuf);
         Verifier v(vBuf, featureSize);
         const auto ok = VerifyFeatureBuffer(v);
         if (!ok) {
@@ -761,7 +1350,7 @@ OGRErr OGRFlatGeobufLayer::parseFeature(OGRFeature *poFeature) {
         }
     }
 
-    const auto feature = GetRoot<Feature>(m_featureBuf);
+    const auto feature = GetRoot<Feature>(featureBuf);
     const auto geometry = feature->geometry();
     if (!m_poFeatureDefn->IsGeometryIgnored() && geometry != nullptr) {
         auto geometryType = m_geometryType;
@@ -1201,7 +1790,7 @@ OGRErr OGRFlatGeobufLayer::ICreateFeature(OGRFeature *poNewFeature)
         CPLDebugOnly("FlatGeobuf", "Writing first feature at offset: %lu", static_cast<long unsigned int>(m_writeOffset));
     }
 
-    m_maxFeatureSize = std::max(m_featureBufSize, static_cast<uint32_t>(fbb.GetSize()));
+    m_maxFeatureSize = std::max(m_maxFeatureSize, static_cast<uint32_t>(fbb.GetSize()));
     size_t c = VSIFWriteL(fbb.GetBufferPointer(), 1, fbb.GetSize(), m_poFpWrite);
     if (c == 0)
         return CPLErrorIO("writing feature");
@@ -1271,5 +1860,7 @@ void OGRFlatGeobufLayer::ResetReading()
     m_queriedSpatialIndex = false;
     m_ignoreSpatialFilter = false;
     m_ignoreAttributeFilter = false;
+    clearFeatureBatches();
+    ResetAttrIndexReading();
     return;
 }
@@ -77,4 +77,35 @@ OGRAttrIndex::OGRAttrIndex() {}
 
 OGRAttrIndex::~OGRAttrIndex() {}
 
+/************************************************************************/
+/*                        SupportsRangeQueries()                        */
+/*                                                                      */
+/*      Whether GetRangeMatches() can be used on this index.            */
+/************************************************************************/
+
+bool OGRAttrIndex::SupportsRangeQueries() const
+
+{
+    return false;
+}
+
+/************************************************************************/
+/*                          GetRangeMatches()                           */
+/*                                                                      */
+/*      Return the sorted, OGRNullFID terminated, list of FIDs whose    */
+/*      key falls between psMin and psMax.  A NULL bound means the      */
+/*      range is unbounded on that side.  Returns NULL if the index     */
+/*      does not support range queries.                                 */
+/************************************************************************/
+
+GIntBig *OGRAttrIndex::GetRangeMatches( const OGRField * /* psMin */,
+                                        bool /* bMinIncluded */,
+                                        const OGRField * /* psMax */,
+                                        bool /* bMaxIncluded */,
+                                        GIntBig & /* nFIDCount */ )
+
+{
+    return nullptr;
+}
+
 //! @endcond
@@ -34,6 +34,10 @@
 #include "ogr_api.h"
 #include "cpl_time.h"
 #include <algorithm>
+#include <cctype>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 //! @cond Doxygen_Suppress
@@ -53,6 +57,303 @@ class OGRGenSQLGeomFieldDefn final: public OGRGeomFieldDefn
         int bForceGeomType;
 };
 
+/************************************************************************/
+/*                          OGRGenSQLJoinHash                           */
+/*                                                                      */
+/*      In-memory hash table of the features of a secondary layer,      */
+/*      keyed by the join field, used instead of issuing one attribute  */
+/*      filter on the secondary layer per primary feature when the      */
+/*      JOIN condition is a simple equality between two fields.         */
+/*                                                                      */
+/*      Keys are the exact typed values. Lookups that could give a      */
+/*      different result depending on how the secondary layer           */
+/*      compares values (case sensitivity of strings, integers that     */
+/*      cannot be represented exactly as doubles, ...) are reported as  */
+/*      not possible, so that the attribute filter is used instead.     */
+/************************************************************************/
+
+class OGRGenSQLJoinHash
+{
+        CPL_DISALLOW_COPY_ASSIGN(OGRGenSQLJoinHash)
+
+    public:
+        enum class KeyType
+        {
+            INTEGER,
+            REAL,
+            STRING
+        };
+
+        KeyType  eKeyType = KeyType::INTEGER;
+        int      iPrimaryField = -1;
+        int      iSecondaryField = -1;
+        bool     bBuilt = false;
+        bool     bUsable = true;
+
+        OGRGenSQLJoinHash() = default;
+
+        bool        Build( OGRLayer *poJoinLayer );
+        bool        Lookup( OGRFeature *poSrcFeat,
+                            OGRFeature *&poJoinFeature ) const;
+
+    private:
+        struct StringEntry
+        {
+            OGRFeature *poFeature;
+            // Whether all the keys folded to this entry have the same case
+            bool        bSameCase;
+        };
+
+        std::unordered_map<GIntBig, OGRFeature*> oMapInteger{};
+        std::unordered_map<double, OGRFeature*> oMapReal{};
+        std::unordered_map<std::string, StringEntry> oMapString{};
+        std::vector<std::unique_ptr<OGRFeature>> apoFeatures{};
+
+        // Largest magnitude for which all integers are exactly representable
+        // as doubles.
+        static constexpr GIntBig knMaxExactInteger =
+            static_cast<GIntBig>(1) << 53;
+
+        static bool IsExactAsDouble( GIntBig nVal )
+            { return nVal >= -knMaxExactInteger && nVal <= knMaxExactInteger; }
+
+        static double NormalizeReal( double dfVal )
+            { return dfVal == 0.0 ? 0.0 : dfVal; } // -0 == +0
+
+        static std::string FoldString( const char *pszVal )
+        {
+            std::string osKey(pszVal);
+            for( auto &ch : osKey )
+                ch = static_cast<char>(
+                    ::toupper(static_cast<unsigned char>(ch)));
+            return osKey;
+        }
+};
+
+/************************************************************************/
+/*                               Build()                                */
+/************************************************************************/
+
+bool OGRGenSQLJoinHash::Build( OGRLayer *poJoinLayer )
+{
+    bBuilt = true;
+
+    const GIntBig nUsableRAM = CPLGetUsablePhysicalRAM();
+    const char* pszMaxMem =
+        CPLGetConfigOption("OGR_SQL_HASH_JOIN_MAX_MEMORY", nullptr);
+    const GIntBig nMaxMem =
+        pszMaxMem ? CPLAtoGIntBig(pszMaxMem) * 1024 * 1024 :
+        nUsableRAM > 0 ? nUsableRAM / 4 : static_cast<GIntBig>(256) * 1024 * 1024;
+
+    const int nFieldCount = poJoinLayer->GetLayerDefn()->GetFieldCount();
+    const OGRFieldType eSecondaryType = poJoinLayer->GetLayerDefn()->
+                            GetFieldDefn(iSecondaryField)->GetType();
+    const GIntBig nBaseFeatureSize =
+        sizeof(OGRFeature) + nFieldCount * sizeof(OGRField) +
+        sizeof(std::unique_ptr<OGRFeature>) + 4 * sizeof(void*);
+    GIntBig nMemUsage = 0;
+
+    poJoinLayer->SetAttributeFilter( nullptr );
+    poJoinLayer->ResetReading();
+    while( true )
+    {
+        OGRFeature *poFeature = poJoinLayer->GetNextFeature();
+        if( poFeature == nullptr )
+            break;
+        std::unique_ptr<OGRFeature> poFeatureHolder(poFeature);
+
+        if( !poFeature->IsFieldSetAndNotNull(iSecondaryField) )
+            continue;
+
+        // Only the first feature of a given key is ever returned.
+        const OGRField *psField = poFeature->GetRawFieldRef(iSecondaryField);
+        bool bInserted = false;
+        size_t nKeySize = sizeof(GIntBig);
+        switch( eKeyType )
+        {
+            case KeyType::INTEGER:
+                bInserted = oMapInteger.insert(std::make_pair(
+                    poFeature->GetFieldAsInteger64(iSecondaryField),
+                    poFeature)).second;
+                break;
+            case KeyType::REAL:
+            {
+                if( eSecondaryType != OFTReal &&
+                    !IsExactAsDouble(
+                        poFeature->GetFieldAsInteger64(iSecondaryField)) )
+                {
+                    // Whether such a value equals a real depends on the
+                    // driver.
+                    CPLDebug("GenSQL", "Integer key of layer %s not "
+                             "representable as a double. "
+                             "Using per-feature attribute filters instead",
+                             poJoinLayer->GetName());
+                    bUsable = false;
+                    break;
+                }
+                const double dfVal =
+                    poFeature->GetFieldAsDouble(iSecondaryField);
+                if( !CPLIsNan(dfVal) )
+                    bInserted = oMapReal.insert(std::make_pair(
+                        NormalizeReal(dfVal), poFeature)).second;
+                break;
+            }
+            case KeyType::STRING:
+            {
+                nKeySize = strlen(psField->String) + sizeof(std::string);
+                StringEntry sEntry;
+                sEntry.poFeature = poFeature;
+                sEntry.bSameCase = true;
+                auto oRes = oMapString.insert(std::make_pair(
+                    FoldString(psField->String), sEntry));
+                bInserted = oRes.second;
+                if( !bInserted &&
+                    strcmp(oRes.first->second.poFeature->
+                                GetRawFieldRef(iSecondaryField)->String,
+                           psField->String) != 0 )
+                {
+                    oRes.first->second.bSameCase = false;
+                }
+                break;
+            }
+        }
+        if( !bUsable )
+            break;
+        if( !bInserted )
+            continue;
+
+        nMemUsage += nBaseFeatureSize + 2 * nKeySize;
+        for( int i = 0; i < nFieldCount; i++ )
+        {
+            if( !poFeature->IsFieldSetAndNotNull(i) )
+                continue;
+            const OGRFieldType eType = poFeature->GetFieldDefnRef(i)->GetType();
+            if( eType == OFTString )
+                nMemUsage += strlen(poFeature->GetRawFieldRef(i)->String) + 1;
+            else if( eType == OFTBinary )
+                nMemUsage += poFeature->GetRawFieldRef(i)->Binary.nCount;
+        }
+        for( int i = 0; i < poFeature->GetGeomFieldCount(); i++ )
+        {
+            const OGRGeometry *poGeom = poFeature->GetGeomFieldRef(i);
+            if( poGeom )
+                nMemUsage += poGeom->WkbSize();
+        }
+        apoFeatures.push_back(std::move(poFeatureHolder));
+
+        if( nMemUsage > nMaxMem )
+        {
+            CPLDebug("GenSQL",
+                     "Secondary layer %s too large for hash join. "
+                     "Using per-feature attribute filters instead",
+                     poJoinLayer->GetName());
+            bUsable = false;
+            break;
+        }
+    }
+    poJoinLayer->ResetReading();
+
+    if( !bUsable )
+    {
+        oMapInteger.clear();
+        oMapReal.clear();
+        oMapString.clear();
+        apoFeatures.clear();
+    }
+
+    if( bUsable )
+    {
+        CPLDebug("GenSQL", "Hash join table of " CPL_FRMT_GIB " keys "
+                 "built for layer %s",
+                 static_cast<GIntBig>(apoFeatures.size()),
+                 poJoinLayer->GetName());
+    }
+    return bUsable;
+}
+
+/************************************************************************/
+/*                               Lookup()                               */
+/*                                                                      */
+/*      Returns false if the key of this primary feature cannot be      */
+/*      looked up in the hash table with the same semantics as the      */
+/*      attribute filter would have. Otherwise poJoinFeature is set to  */
+/*      the matching feature (owned by the hash table), or null.        */
+/************************************************************************/
+
+bool OGRGenSQLJoinHash::Lookup( OGRFeature *poSrcFeat,
+                                OGRFeature *&poJoinFeature ) const
+{
+    poJoinFeature = nullptr;
+    if( !poSrcFeat->IsFieldSetAndNotNull(iPrimaryField) )
+        return true;
+
+    switch( eKeyType )
+    {
+        case KeyType::INTEGER:
+        {
+            const auto oIter = oMapInteger.find(
+                poSrcFeat->GetFieldAsInteger64(iPrimaryField));
+            if( oIter != oMapInteger.end() )
+                poJoinFeature = oIter->second;
+            break;
+        }
+        case KeyType::REAL:
+        {
+            double dfVal;
+            if( poSrcFeat->GetFieldDefnRef(iPrimaryField)->GetType() ==
+                                                                    OFTReal )
+            {
+                // Use the value as it is formatted by GetFilterForJoin()
+                dfVal = CPLAtof(CPLSPrintf("%.16g",
+                            poSrcFeat->GetFieldAsDouble(iPrimaryField)));
+            }
+            else
+            {
+                const GIntBig nVal =
+                    poSrcFeat->GetFieldAsInteger64(iPrimaryField);
+                if( !IsExactAsDouble(nVal) )
+                    return false;
+                dfVal = static_cast<double>(nVal);
+            }
+            if( CPLIsNan(dfVal) )
+                break;
+            const auto oIter = oMapReal.find(NormalizeReal(dfVal));
+            if( oIter != oMapReal.end() )
+                poJoinFeature = oIter->second;
+            break;
+        }
+        case KeyType::STRING:
+        {
+            const char *pszVal =
+                poSrcFeat->GetRawFieldRef(iPrimaryField)->String;
+            // String equality in OGR SQL has special rules for timestamp
+            // like values ending with a +00 timezone.
+            const size_t nLen = strlen(pszVal);
+            if( nLen > 3 && (pszVal[nLen-3] == ':' ||
+                             strcmp(pszVal + nLen - 3, "+00") == 0) )
+                return false;
+            // If no key matches case insensitively, none matches either
+            // with a case sensitive comparison. Otherwise the result is
+            // the same with both comparisons only if the keys have the
+            // same case.
+            const auto oIter = oMapString.find(FoldString(pszVal));
+            if( oIter != oMapString.end() )
+            {
+                if( !oIter->second.bSameCase ||
+                    strcmp(oIter->second.poFeature->
+                                GetRawFieldRef(iSecondaryField)->String,
+                           pszVal) != 0 )
+                {
+                    return false;
+                }
+                poJoinFeature = oIter->second.poFeature;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
 /************************************************************************/
 /*               OGRGenSQLResultsLayerHasSpecialField()                 */
 /************************************************************************/
@@ -489,6 +790,8 @@ OGRGenSQLResultsLayer::OGRGenSQLResultsLayer( GDALDataset *poSrcDSIn,
 
     FindAndSetIgnoredFields();
 
+    PrepareJoinHashes();
+
     if( !bForwardWhereToSourceLayer )
         OGRGenSQLResultsLayer::SetAttributeFilter( pszWHEREIn );
 }
@@ -1269,6 +1572,105 @@ static CPLString GetFilterForJoin(swq_expr_node* poExpr, OGRFeature* poSrcFeat,
     return "";
 }
 
+/************************************************************************/
+/*                         PrepareJoinHashes()                          */
+/*                                                                      */
+/*      Determine which joins can be evaluated with a hash table of     */
+/*      the secondary layer. The tables themselves are only built when  */
+/*      the first feature is translated.                                */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::PrepareJoinHashes()
+{
+    swq_select *psSelectInfo = static_cast<swq_select*>(pSelectInfo);
+
+    m_apoJoinHash.clear();
+    m_apoJoinHash.resize(psSelectInfo->join_count);
+    if( !CPLTestBool(CPLGetConfigOption("OGR_SQL_HASH_JOIN", "YES")) )
+        return;
+
+    for( int iJoin = 0; iJoin < psSelectInfo->join_count; iJoin++ )
+    {
+        swq_join_def *psJoinInfo = psSelectInfo->join_defs + iJoin;
+        OGRLayer *poJoinLayer = papoTableLayers[psJoinInfo->secondary_table];
+        swq_expr_node *poExpr = psJoinInfo->poExpr;
+
+        // A self join would disturb the reading of the primary layer.
+        if( poJoinLayer == poSrcLayer ||
+            poExpr->eNodeType != SNT_OPERATION ||
+            poExpr->nOperation != SWQ_EQ || poExpr->nSubExprCount != 2 ||
+            poExpr->papoSubExpr[0]->eNodeType != SNT_COLUMN ||
+            poExpr->papoSubExpr[1]->eNodeType != SNT_COLUMN )
+            continue;
+
+        const swq_expr_node *poPrimary = poExpr->papoSubExpr[0];
+        const swq_expr_node *poSecondary = poExpr->papoSubExpr[1];
+        if( poPrimary->table_index != 0 )
+            std::swap(poPrimary, poSecondary);
+        if( poPrimary->table_index != 0 ||
+            poSecondary->table_index != psJoinInfo->secondary_table )
+            continue;
+
+        OGRFeatureDefn *poPrimaryDefn = poSrcLayer->GetLayerDefn();
+        OGRFeatureDefn *poSecondaryDefn = poJoinLayer->GetLayerDefn();
+        if( poPrimary->field_index < 0 ||
+            poPrimary->field_index >= poPrimaryDefn->GetFieldCount() ||
+            poSecondary->field_index < 0 ||
+            poSecondary->field_index >= poSecondaryDefn->GetFieldCount() )
+            continue;
+
+        const OGRFieldType ePrimaryType =
+            poPrimaryDefn->GetFieldDefn(poPrimary->field_index)->GetType();
+        const OGRFieldType eSecondaryType =
+            poSecondaryDefn->GetFieldDefn(poSecondary->field_index)->GetType();
+        const auto IsInteger = [](OGRFieldType eType)
+            { return eType == OFTInteger || eType == OFTInteger64; };
+
+        std::unique_ptr<OGRGenSQLJoinHash> poHash(new OGRGenSQLJoinHash());
+        if( IsInteger(ePrimaryType) && IsInteger(eSecondaryType) )
+            poHash->eKeyType = OGRGenSQLJoinHash::KeyType::INTEGER;
+        else if( (IsInteger(ePrimaryType) || ePrimaryType == OFTReal) &&
+                 (IsInteger(eSecondaryType) || eSecondaryType == OFTReal) )
+            poHash->eKeyType = OGRGenSQLJoinHash::KeyType::REAL;
+        else if( ePrimaryType == OFTString && eSecondaryType == OFTString )
+            poHash->eKeyType = OGRGenSQLJoinHash::KeyType::STRING;
+        else
+            continue;
+
+        poHash->iPrimaryField = poPrimary->field_index;
+        poHash->iSecondaryField = poSecondary->field_index;
+        m_apoJoinHash[iJoin] = std::move(poHash);
+    }
+}
+
+/************************************************************************/
+/*                      FetchJoinFeatureFromHash()                      */
+/*                                                                      */
+/*      Returns false if the join must be done through an attribute     */
+/*      filter on the secondary layer.                                  */
+/************************************************************************/
+
+bool OGRGenSQLResultsLayer::FetchJoinFeatureFromHash(
+                                        int iJoin, OGRFeature *poSrcFeat,
+                                        OGRFeature *&poJoinFeature )
+{
+    if( iJoin >= static_cast<int>(m_apoJoinHash.size()) )
+        return false;
+    OGRGenSQLJoinHash *poHash = m_apoJoinHash[iJoin].get();
+    if( poHash == nullptr || !poHash->bUsable )
+        return false;
+
+    if( !poHash->bBuilt )
+    {
+        swq_select *psSelectInfo = static_cast<swq_select*>(pSelectInfo);
+        swq_join_def *psJoinInfo = psSelectInfo->join_defs + iJoin;
+        if( !poHash->Build(papoTableLayers[psJoinInfo->secondary_table]) )
+            return false;
+    }
+
+    return poHash->Lookup(poSrcFeat, poJoinFeature);
+}
+
 /************************************************************************/
 /*                          TranslateFeature()                          */
 /************************************************************************/
@@ -1278,6 +1680,8 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
 {
     swq_select *psSelectInfo = static_cast<swq_select*>(pSelectInfo);
     std::vector<OGRFeature*> apoFeatures;
+    // Join features coming from a hash table must not be freed.
+    std::vector<bool> abJoinFeatureOwned;
 
     if( poSrcFeat == nullptr )
         return nullptr;
@@ -1302,6 +1706,14 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
 
         OGRLayer *poJoinLayer = papoTableLayers[psJoinInfo->secondary_table];
 
+        OGRFeature *poJoinFeature = nullptr;
+        if( FetchJoinFeatureFromHash(iJoin, poSrcFeat, poJoinFeature) )
+        {
+            apoFeatures.push_back( poJoinFeature );
+            abJoinFeatureOwned.push_back( false );
+            continue;
+        }
+
         osFilter = GetFilterForJoin(psJoinInfo->poExpr, poSrcFeat, poJoinLayer,
                                     psJoinInfo->secondary_table);
         //CPLDebug("OGR", "Filter = %s\n", osFilter.c_str());
@@ -1310,16 +1722,16 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
         if( osFilter.empty() )
         {
             apoFeatures.push_back( nullptr );
+            abJoinFeatureOwned.push_back( false );
             continue;
         }
 
-        OGRFeature *poJoinFeature = nullptr;
-
         poJoinLayer->ResetReading();
         if( poJoinLayer->SetAttributeFilter( osFilter.c_str() ) == OGRERR_NONE )
             poJoinFeature = poJoinLayer->GetNextFeature();
 
         apoFeatures.push_back( poJoinFeature );
+        abJoinFeatureOwned.push_back( true );
     }
 
 /* -------------------------------------------------------------------- */
@@ -1539,7 +1951,8 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
             iRegularField ++;
         }
 
-        delete poJoinFeature;
+        if( abJoinFeatureOwned[iJoin] )
+            delete poJoinFeature;
     }
 
     return poDstFeat;
@@ -36,6 +36,7 @@
 #include "cpl_hash_set.h"
 #include "cpl_string.h"
 
+#include <memory>
 #include <vector>
 
 /*! @cond Doxygen_Suppress */
@@ -50,6 +51,8 @@
 #define ALL_FIELD_INDEX_TO_GEOM_FIELD_INDEX(poFDefn, idx) \
     ((idx) - ((poFDefn)->GetFieldCount() + SPECIAL_FIELD_COUNT))
 
+class OGRGenSQLJoinHash;
+
 /************************************************************************/
 /*                        OGRGenSQLResultsLayer                         */
 /************************************************************************/
@@ -84,8 +87,15 @@ class OGRGenSQLResultsLayer final: public OGRLayer
     GIntBig     nIteratedFeatures;
     std::vector<CPLString> m_oDistinctList;
 
+    // One entry per join, null when the join cannot be done by hashing.
+    std::vector<std::unique_ptr<OGRGenSQLJoinHash>> m_apoJoinHash{};
+
     int         PrepareSummary();
 
+    void        PrepareJoinHashes();
+    bool        FetchJoinFeatureFromHash( int iJoin, OGRFeature *poSrcFeat,
+                                          OGRFeature *&poJoinFeature );
+
     OGRFeature *TranslateFeature( OGRFeature * );
     void        CreateOrderByIndex();
     void        ReadIndexFields( OGRFeature* poSrcFeat,
@@ -0,0 +1,1245 @@
+/******************************************************************************
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Implements generic attribute indexes stored in a .ogridx
+ *           sidecar file next to the indexed dataset.
+ * Author:   GDAL project
+ *
+ ******************************************************************************
+ * Copyright (c) 2020, GDAL project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_attrind.h"
+#include "ogr_p.h"
+#include "cpl_conv.h"
+#include "cpl_mem_cache.h"
+#include "cpl_vsi.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+CPL_CVSID("$Id$")
+
+//! @cond Doxygen_Suppress
+
+/*
+ * The sidecar file, named <datafile>.ogridx, is made of (all values being
+ * little-endian):
+ *
+ *  - the 8 byte signature "OGRAIDX2"
+ *  - the size (uint64), modification time (int64) and checksum (uint32) of
+ *    the data file at the time the index was written, as returned by
+ *    OGRGetFileStamp(), used to detect stale indexes
+ *  - the number of indexed fields (uint32)
+ *  - for each indexed field: the length of its name (uint32), its name,
+ *    its OGRFieldType (uint32), its number of entries (uint64), and the
+ *    offset (uint64) and size (uint64) of its payload.
+ *  - the payloads. For OFTInteger, OFTInteger64 and OFTReal fields, this is
+ *    an array of (key, FID) pairs of 2 x 8 bytes, sorted by key then FID.
+ *    For OFTString fields, this is an array of (key offset: uint64, key
+ *    length: uint32, FID: int64) records sorted by key then FID, followed
+ *    by the keys, whose offsets are relative to the end of the records.
+ *    String keys are stored lower-cased so that their order matches the
+ *    strcasecmp() semantics of the OGR SQL comparison operators.
+ *
+ * All records of a payload have the same size, so lookups are binary
+ * searches done directly in the file, through a cache of its pages.
+ *
+ * NULL and unset fields, as well as NaN values, are not indexed since no
+ * comparison can evaluate to true on them.
+ */
+
+constexpr const char SIDECAR_SIGNATURE[] = "OGRAIDX2";
+constexpr size_t SIDECAR_SIGNATURE_SIZE = 8;
+constexpr GUInt64 SIDECAR_HEADER_SIZE = SIDECAR_SIGNATURE_SIZE + 8 + 8 + 4 + 4;
+constexpr size_t SIDECAR_NUM_RECORD_SIZE = 16;
+constexpr size_t SIDECAR_STR_RECORD_SIZE = 20;
+constexpr size_t SIDECAR_PAGE_SIZE = 65536;
+constexpr size_t SIDECAR_MAX_CACHED_PAGES = 64;
+
+/************************************************************************/
+/*                         OGRSidecarFoldString()                       */
+/************************************************************************/
+
+static std::string OGRSidecarFoldString( const char *pszStr )
+{
+    std::string osRet(pszStr);
+    for( auto &ch: osRet )
+        ch = static_cast<char>(
+            tolower(static_cast<unsigned char>(ch)));
+    return osRet;
+}
+
+/************************************************************************/
+/*                          OGRSidecarAttrIndex                         */
+/*                                                                      */
+/*      Sorted array of (key, FID) for one field, read from the         */
+/*      sidecar file on demand.  It is only held in memory while it is  */
+/*      being built by IndexAllFeatures().                              */
+/************************************************************************/
+
+class OGRSidecarLayerAttrIndex;
+
+class OGRSidecarAttrIndex final: public OGRAttrIndex
+{
+    CPL_DISALLOW_COPY_ASSIGN(OGRSidecarAttrIndex)
+
+    friend class OGRSidecarLayerAttrIndex;
+
+    union NumKey
+    {
+        GIntBig nKey;
+        double  dfKey;
+    };
+
+    struct NumEntry
+    {
+        NumKey  uKey;
+        GIntBig nFID;
+    };
+
+    struct StrEntry
+    {
+        size_t  nOffset;
+        size_t  nLength;
+        GIntBig nFID;
+    };
+
+    OGRSidecarLayerAttrIndex *poOwner = nullptr;
+    CPLString           osFieldName{};
+    OGRFieldType        eType = OFTInteger;
+
+    // Location of the payload in the sidecar file.
+    GUInt64             nEntryCount = 0;
+    GUInt64             nPayloadOffset = 0;
+    GUInt64             nPayloadSize = 0;
+    bool                bBuilt = false;
+
+    // Entries being built, before they are written by Save().
+    bool                bInMemory = false;
+    std::vector<NumEntry> asNumEntries{};
+    std::vector<StrEntry> asStrEntries{};
+    std::string         osStrPool{};
+
+    size_t              RecordSize() const
+        { return eType == OFTString ? SIDECAR_STR_RECORD_SIZE :
+                                      SIDECAR_NUM_RECORD_SIZE; }
+    bool                ReadEntry( GUInt64 iEntry, GIntBig &nFID,
+                                   NumKey *puKey,
+                                   std::string *posKey ) const;
+    bool                CompareKey( GUInt64 iEntry, const OGRField *psKey,
+                                    const std::string &osFoldedKey,
+                                    int &nCmp ) const;
+    bool                LowerBound( const OGRField *psKey,
+                                    const std::string &osFoldedKey,
+                                    bool bStrict, GUInt64 &nRes ) const;
+    void                Sort();
+
+  public:
+    OGRSidecarAttrIndex() = default;
+
+    GIntBig     GetFirstMatch( OGRField *psKey ) override;
+    GIntBig    *GetAllMatches( OGRField *psKey ) override;
+    GIntBig    *GetAllMatches( OGRField *psKey, GIntBig* panFIDList,
+                               int* nFIDCount, int* nLength ) override;
+
+    OGRErr      AddEntry( OGRField *psKey, GIntBig nFID ) override;
+    OGRErr      RemoveEntry( OGRField *psKey, GIntBig nFID ) override;
+
+    OGRErr      Clear() override;
+
+    bool        SupportsRangeQueries() const override { return true; }
+    GIntBig    *GetRangeMatches( const OGRField *psMin, bool bMinIncluded,
+                                 const OGRField *psMax, bool bMaxIncluded,
+                                 GIntBig &nFIDCount ) override;
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                       OGRSidecarLayerAttrIndex                       */
+/* ==================================================================== */
+/************************************************************************/
+
+class OGRSidecarLayerAttrIndex final: public OGRLayerAttrIndex
+{
+    CPL_DISALLOW_COPY_ASSIGN(OGRSidecarLayerAttrIndex)
+
+    CPLString   osDataFilename{};
+    CPLString   osSidecarFilename{};
+    std::vector<std::unique_ptr<OGRSidecarAttrIndex>> apoIndexes{};
+
+    // Read-only handle on the sidecar file, and cache of its pages.
+    VSILFILE   *fpSidecar = nullptr;
+    bool        bReadError = false;
+    lru11::Cache<GUInt64, std::shared_ptr<std::vector<GByte>>> oPageCache{
+                                                SIDECAR_MAX_CACHED_PAGES};
+
+    OGRSidecarAttrIndex *FindIndex( int iField ) const;
+    bool        LoadDirectory();
+    void        CloseSidecar();
+    OGRErr      Save();
+
+  public:
+    OGRSidecarLayerAttrIndex() = default;
+    ~OGRSidecarLayerAttrIndex() override;
+
+    bool        ReadBytes( GUInt64 nOffset, size_t nSize, void *pDest );
+
+    OGRErr      Initialize( const char *pszDataFilename,
+                            OGRLayer *poLayerIn ) override;
+
+    OGRErr      CreateIndex( int iField ) override;
+    OGRErr      DropIndex( int iField ) override;
+    OGRErr      IndexAllFeatures( int iField = -1 ) override;
+
+    OGRErr      AddToIndex( OGRFeature *poFeature, int iField = -1 ) override;
+    OGRErr      RemoveFromIndex( OGRFeature *poFeature ) override;
+
+    OGRAttrIndex *GetFieldIndex( int iField ) override;
+};
+
+/************************************************************************/
+/*                             ReadEntry()                              */
+/*                                                                      */
+/*      Read the FID, and optionally the key, of entry iEntry.          */
+/************************************************************************/
+
+bool OGRSidecarAttrIndex::ReadEntry( GUInt64 iEntry, GIntBig &nFID,
+                                     NumKey *puKey,
+                                     std::string *posKey ) const
+
+{
+    GByte abyRecord[SIDECAR_STR_RECORD_SIZE];
+    if( !poOwner->ReadBytes(nPayloadOffset + iEntry * RecordSize(),
+                            RecordSize(), abyRecord) )
+        return false;
+
+    if( eType != OFTString )
+    {
+        if( puKey )
+        {
+            memcpy(puKey, abyRecord, 8);
+            CPL_LSBPTR64(puKey);
+        }
+        memcpy(&nFID, abyRecord + 8, 8);
+        CPL_LSBPTR64(&nFID);
+        return true;
+    }
+
+    GUInt64 nKeyOffset;
+    GUInt32 nKeyLength;
+    memcpy(&nKeyOffset, abyRecord, 8);
+    CPL_LSBPTR64(&nKeyOffset);
+    memcpy(&nKeyLength, abyRecord + 8, 4);
+    CPL_LSBPTR32(&nKeyLength);
+    memcpy(&nFID, abyRecord + 12, 8);
+    CPL_LSBPTR64(&nFID);
+    if( posKey == nullptr )
+        return true;
+
+    const GUInt64 nPoolOffset =
+        nPayloadOffset + nEntryCount * SIDECAR_STR_RECORD_SIZE;
+    const GUInt64 nPoolSize =
+        nPayloadSize - nEntryCount * SIDECAR_STR_RECORD_SIZE;
+    if( nKeyOffset > nPoolSize || nKeyLength > nPoolSize - nKeyOffset )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Corrupted attribute index for field %s",
+                 osFieldName.c_str());
+        return false;
+    }
+    posKey->resize(nKeyLength);
+    return nKeyLength == 0 ||
+           poOwner->ReadBytes(nPoolOffset + nKeyOffset, nKeyLength,
+                              &(*posKey)[0]);
+}
+
+/************************************************************************/
+/*                             CompareKey()                             */
+/*                                                                      */
+/*      Compare the key of entry iEntry with psKey (or osFoldedKey      */
+/*      for strings), setting nCmp to <0, 0 or >0.                      */
+/************************************************************************/
+
+bool OGRSidecarAttrIndex::CompareKey( GUInt64 iEntry, const OGRField *psKey,
+                                      const std::string &osFoldedKey,
+                                      int &nCmp ) const
+
+{
+    GIntBig nFID = 0;
+    switch( eType )
+    {
+        case OFTInteger:
+        case OFTInteger64:
+        {
+            NumKey uVal;
+            if( !ReadEntry(iEntry, nFID, &uVal, nullptr) )
+                return false;
+            const GIntBig nKey = eType == OFTInteger ?
+                psKey->Integer : psKey->Integer64;
+            nCmp = uVal.nKey < nKey ? -1 : uVal.nKey > nKey ? 1 : 0;
+            return true;
+        }
+
+        case OFTReal:
+        {
+            NumKey uVal;
+            if( !ReadEntry(iEntry, nFID, &uVal, nullptr) )
+                return false;
+            nCmp = uVal.dfKey < psKey->Real ? -1 :
+                   uVal.dfKey > psKey->Real ? 1 : 0;
+            return true;
+        }
+
+        default:
+        {
+            std::string osVal;
+            if( !ReadEntry(iEntry, nFID, nullptr, &osVal) )
+                return false;
+            nCmp = osVal.compare(osFoldedKey);
+            return true;
+        }
+    }
+}
+
+/************************************************************************/
+/*                             LowerBound()                             */
+/*                                                                      */
+/*      Set nRes to the index of the first entry whose key is >= psKey  */
+/*      (or > psKey if bStrict).                                        */
+/************************************************************************/
+
+bool OGRSidecarAttrIndex::LowerBound( const OGRField *psKey,
+                                      const std::string &osFoldedKey,
+                                      bool bStrict, GUInt64 &nRes ) const
+
+{
+    GUInt64 nLow = 0;
+    GUInt64 nHigh = nEntryCount;
+    while( nLow < nHigh )
+    {
+        const GUInt64 nMid = nLow + (nHigh - nLow) / 2;
+        int nCmp = 0;
+        if( !CompareKey(nMid, psKey, osFoldedKey, nCmp) )
+            return false;
+        if( nCmp < 0 || (bStrict && nCmp == 0) )
+            nLow = nMid + 1;
+        else
+            nHigh = nMid;
+    }
+    nRes = nLow;
+    return true;
+}
+
+/************************************************************************/
+/*                                Sort()                                */
+/************************************************************************/
+
+void OGRSidecarAttrIndex::Sort()
+
+{
+    if( eType == OFTString )
+    {
+        const char *pszPool = osStrPool.data();
+        std::sort(asStrEntries.begin(), asStrEntries.end(),
+            [pszPool](const StrEntry &a, const StrEntry &b)
+            {
+                const size_t nMin = std::min(a.nLength, b.nLength);
+                const int nRet = nMin == 0 ? 0 :
+                    memcmp(pszPool + a.nOffset, pszPool + b.nOffset, nMin);
+                if( nRet != 0 )
+                    return nRet < 0;
+                if( a.nLength != b.nLength )
+                    return a.nLength < b.nLength;
+                return a.nFID < b.nFID;
+            });
+    }
+    else if( eType == OFTReal )
+    {
+        std::sort(asNumEntries.begin(), asNumEntries.end(),
+            [](const NumEntry &a, const NumEntry &b)
+            {
+                if( a.uKey.dfKey != b.uKey.dfKey )
+                    return a.uKey.dfKey < b.uKey.dfKey;
+                return a.nFID < b.nFID;
+            });
+    }
+    else
+    {
+        std::sort(asNumEntries.begin(), asNumEntries.end(),
+            [](const NumEntry &a, const NumEntry &b)
+            {
+                if( a.uKey.nKey != b.uKey.nKey )
+                    return a.uKey.nKey < b.uKey.nKey;
+                return a.nFID < b.nFID;
+            });
+    }
+}
+
+/************************************************************************/
+/*                           GetFirstMatch()                            */
+/************************************************************************/
+
+GIntBig OGRSidecarAttrIndex::GetFirstMatch( OGRField *psKey )
+
+{
+    const std::string osFoldedKey(
+        eType == OFTString ? OGRSidecarFoldString(psKey->String) : "");
+    GUInt64 iEntry = 0;
+    int nCmp = 0;
+    GIntBig nFID = OGRNullFID;
+    if( LowerBound(psKey, osFoldedKey, false, iEntry) &&
+        iEntry < nEntryCount &&
+        CompareKey(iEntry, psKey, osFoldedKey, nCmp) && nCmp == 0 &&
+        ReadEntry(iEntry, nFID, nullptr, nullptr) )
+    {
+        return nFID;
+    }
+    return OGRNullFID;
+}
+
+/************************************************************************/
+/*                           GetAllMatches()                            */
+/************************************************************************/
+
+GIntBig *OGRSidecarAttrIndex::GetAllMatches( OGRField *psKey,
+                                             GIntBig* panFIDList,
+                                             int* nFIDCount, int* nLength )
+
+{
+    if( panFIDList == nullptr )
+    {
+        panFIDList = static_cast<GIntBig *>(CPLMalloc(sizeof(GIntBig) * 2));
+        *nFIDCount = 0;
+        *nLength = 2;
+    }
+
+    const std::string osFoldedKey(
+        eType == OFTString ? OGRSidecarFoldString(psKey->String) : "");
+    GUInt64 iEntry = 0;
+    if( LowerBound(psKey, osFoldedKey, false, iEntry) )
+    {
+        int nCmp = 0;
+        GIntBig nFID = 0;
+        for( ; iEntry < nEntryCount &&
+               CompareKey(iEntry, psKey, osFoldedKey, nCmp) && nCmp == 0 &&
+               ReadEntry(iEntry, nFID, nullptr, nullptr);
+             iEntry++ )
+        {
+            if( *nFIDCount >= *nLength-1 )
+            {
+                *nLength = (*nLength) * 2 + 10;
+                panFIDList = static_cast<GIntBig *>(
+                    CPLRealloc(panFIDList, sizeof(GIntBig)* (*nLength)));
+            }
+            panFIDList[(*nFIDCount)++] = nFID;
+        }
+    }
+
+    panFIDList[*nFIDCount] = OGRNullFID;
+
+    return panFIDList;
+}
+
+GIntBig *OGRSidecarAttrIndex::GetAllMatches( OGRField *psKey )
+
+{
+    int nFIDCount = 0;
+    int nLength = 0;
+    return GetAllMatches( psKey, nullptr, &nFIDCount, &nLength );
+}
+
+/************************************************************************/
+/*                          GetRangeMatches()                           */
+/************************************************************************/
+
+GIntBig *OGRSidecarAttrIndex::GetRangeMatches( const OGRField *psMin,
+                                               bool bMinIncluded,
+                                               const OGRField *psMax,
+                                               bool bMaxIncluded,
+                                               GIntBig &nFIDCount )
+
+{
+    nFIDCount = 0;
+    GUInt64 iStart = 0;
+    GUInt64 iEnd = nEntryCount;
+    if( psMin )
+    {
+        const std::string osFoldedKey(
+            eType == OFTString ? OGRSidecarFoldString(psMin->String) : "");
+        if( !LowerBound(psMin, osFoldedKey, !bMinIncluded, iStart) )
+            return nullptr;
+    }
+    if( psMax )
+    {
+        const std::string osFoldedKey(
+            eType == OFTString ? OGRSidecarFoldString(psMax->String) : "");
+        if( !LowerBound(psMax, osFoldedKey, bMaxIncluded, iEnd) )
+            return nullptr;
+    }
+    if( iEnd < iStart )
+        iEnd = iStart;
+    if( iEnd - iStart >= std::numeric_limits<size_t>::max() / sizeof(GIntBig) )
+        return nullptr;
+
+    const size_t nCount = static_cast<size_t>(iEnd - iStart);
+    GIntBig *panFIDList = static_cast<GIntBig *>(
+        VSI_MALLOC2_VERBOSE(nCount + 1, sizeof(GIntBig)));
+    if( panFIDList == nullptr )
+        return nullptr;
+    for( size_t i = 0; i < nCount; i++ )
+    {
+        if( !ReadEntry(iStart + i, panFIDList[i], nullptr, nullptr) )
+        {
+            CPLFree(panFIDList);
+            return nullptr;
+        }
+    }
+    std::sort(panFIDList, panFIDList + nCount);
+    panFIDList[nCount] = OGRNullFID;
+    nFIDCount = static_cast<GIntBig>(nCount);
+    return panFIDList;
+}
+
+/************************************************************************/
+/*                              AddEntry()                              */
+/*                                                                      */
+/*      Sidecar indexes are built in one go by IndexAllFeatures(), and  */
+/*      are not maintained incrementally.                               */
+/************************************************************************/
+
+OGRErr OGRSidecarAttrIndex::AddEntry( OGRField * /* psKey */,
+                                      GIntBig /* nFID */ )
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                            RemoveEntry()                             */
+/************************************************************************/
+
+OGRErr OGRSidecarAttrIndex::RemoveEntry( OGRField * /* psKey */,
+                                         GIntBig /* nFID */ )
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                               Clear()                                */
+/************************************************************************/
+
+OGRErr OGRSidecarAttrIndex::Clear()
+
+{
+    asNumEntries.clear();
+    asNumEntries.shrink_to_fit();
+    asStrEntries.clear();
+    asStrEntries.shrink_to_fit();
+    osStrPool.clear();
+    osStrPool.shrink_to_fit();
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                     ~OGRSidecarLayerAttrIndex()                      */
+/************************************************************************/
+
+OGRSidecarLayerAttrIndex::~OGRSidecarLayerAttrIndex()
+
+{
+    CloseSidecar();
+}
+
+/************************************************************************/
+/*                            CloseSidecar()                            */
+/************************************************************************/
+
+void OGRSidecarLayerAttrIndex::CloseSidecar()
+
+{
+    if( fpSidecar )
+        VSIFCloseL(fpSidecar);
+    fpSidecar = nullptr;
+    bReadError = false;
+    oPageCache.clear();
+}
+
+/************************************************************************/
+/*                             ReadBytes()                              */
+/*                                                                      */
+/*      Read nSize bytes at nOffset of the sidecar file, through the    */
+/*      page cache.                                                     */
+/************************************************************************/
+
+bool OGRSidecarLayerAttrIndex::ReadBytes( GUInt64 nOffset, size_t nSize,
+                                          void *pDest )
+
+{
+    if( fpSidecar == nullptr && !bReadError )
+    {
+        fpSidecar = VSIFOpenL(osSidecarFilename, "rb");
+        if( fpSidecar == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_OpenFailed, "Cannot open %s",
+                     osSidecarFilename.c_str());
+            bReadError = true;
+        }
+    }
+    if( bReadError )
+        return false;
+
+    GByte *pabyDest = static_cast<GByte *>(pDest);
+    while( nSize > 0 )
+    {
+        const GUInt64 nPage = nOffset / SIDECAR_PAGE_SIZE;
+        const size_t nOffsetInPage =
+            static_cast<size_t>(nOffset % SIDECAR_PAGE_SIZE);
+        std::shared_ptr<std::vector<GByte>> poPage;
+        if( !oPageCache.tryGet(nPage, poPage) )
+        {
+            poPage = std::make_shared<std::vector<GByte>>(SIDECAR_PAGE_SIZE);
+            size_t nRead = 0;
+            if( VSIFSeekL(fpSidecar, nPage * SIDECAR_PAGE_SIZE,
+                          SEEK_SET) == 0 )
+            {
+                nRead = VSIFReadL(poPage->data(), 1,
+                                  SIDECAR_PAGE_SIZE, fpSidecar);
+            }
+            poPage->resize(nRead);
+            oPageCache.insert(nPage, poPage);
+        }
+        if( nOffsetInPage >= poPage->size() )
+        {
+            CPLError(CE_Failure, CPLE_FileIO,
+                     "Cannot read attribute index %s",
+                     osSidecarFilename.c_str());
+            return false;
+        }
+        const size_t nChunk =
+            std::min(nSize, poPage->size() - nOffsetInPage);
+        memcpy(pabyDest, poPage->data() + nOffsetInPage, nChunk);
+        pabyDest += nChunk;
+        nOffset += nChunk;
+        nSize -= nChunk;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                             Initialize()                             */
+/************************************************************************/
+
+OGRErr OGRSidecarLayerAttrIndex::Initialize( const char *pszDataFilename,
+                                             OGRLayer *poLayerIn )
+
+{
+    if( poLayerIn == poLayer )
+        return OGRERR_NONE;
+
+    poLayer = poLayerIn;
+    pszIndexPath = CPLStrdup(pszDataFilename);
+    osDataFilename = pszDataFilename;
+    osSidecarFilename = CPLSPrintf("%s.ogridx", pszDataFilename);
+
+    VSIStatBufL sStat;
+    if( VSIStatL(osSidecarFilename, &sStat) == 0 && !LoadDirectory() )
+        apoIndexes.clear();
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                           LoadDirectory()                            */
+/************************************************************************/
+
+bool OGRSidecarLayerAttrIndex::LoadDirectory()
+
+{
+    VSILFILE *fp = VSIFOpenL(osSidecarFilename, "rb");
+    if( fp == nullptr )
+        return false;
+
+    bool bOK = true;
+    char achSignature[SIDECAR_SIGNATURE_SIZE] = {};
+    GUInt64 nDataSize = 0;
+    GInt64 nDataMTime = 0;
+    GUInt32 nDataChecksum = 0;
+    GUInt32 nFieldCount = 0;
+    if( VSIFReadL(achSignature, SIDECAR_SIGNATURE_SIZE, 1, fp) != 1 ||
+        memcmp(achSignature, SIDECAR_SIGNATURE,
+               SIDECAR_SIGNATURE_SIZE) != 0 ||
+        VSIFReadL(&nDataSize, sizeof(nDataSize), 1, fp) != 1 ||
+        VSIFReadL(&nDataMTime, sizeof(nDataMTime), 1, fp) != 1 ||
+        VSIFReadL(&nDataChecksum, sizeof(nDataChecksum), 1, fp) != 1 ||
+        VSIFReadL(&nFieldCount, sizeof(nFieldCount), 1, fp) != 1 )
+    {
+        CPLDebug("OGR", "%s is not a valid attribute index file",
+                 osSidecarFilename.c_str());
+        bOK = false;
+    }
+    CPL_LSBPTR64(&nDataSize);
+    CPL_LSBPTR64(&nDataMTime);
+    CPL_LSBPTR32(&nDataChecksum);
+    CPL_LSBPTR32(&nFieldCount);
+
+    GUInt64 nCurSize = 0;
+    GInt64 nCurMTime = 0;
+    GUInt32 nCurChecksum = 0;
+    if( bOK &&
+        (!OGRGetFileStamp(osDataFilename, nCurSize, nCurMTime,
+                          nCurChecksum) ||
+         nCurSize != nDataSize || nCurMTime != nDataMTime ||
+         nCurChecksum != nDataChecksum) )
+    {
+        CPLDebug("OGR", "%s is out of date regarding %s. Ignoring it",
+                 osSidecarFilename.c_str(), osDataFilename.c_str());
+        bOK = false;
+    }
+
+    VSIFSeekL(fp, 0, SEEK_END);
+    const GUInt64 nFileSize = VSIFTellL(fp);
+    VSIFSeekL(fp, SIDECAR_HEADER_SIZE, SEEK_SET);
+
+    for( GUInt32 i = 0; bOK && i < nFieldCount; i++ )
+    {
+        GUInt32 nNameLen = 0;
+        if( VSIFReadL(&nNameLen, sizeof(nNameLen), 1, fp) != 1 )
+        {
+            bOK = false;
+            break;
+        }
+        CPL_LSBPTR32(&nNameLen);
+        if( nNameLen > 10000 )
+        {
+            bOK = false;
+            break;
+        }
+
+        auto poIndex = std::unique_ptr<OGRSidecarAttrIndex>(
+            new OGRSidecarAttrIndex());
+        poIndex->poOwner = this;
+        poIndex->osFieldName.resize(nNameLen);
+        GUInt32 nType = 0;
+        if( (nNameLen > 0 &&
+             VSIFReadL(&poIndex->osFieldName[0], nNameLen, 1, fp) != 1) ||
+            VSIFReadL(&nType, sizeof(nType), 1, fp) != 1 ||
+            VSIFReadL(&poIndex->nEntryCount, sizeof(GUInt64), 1, fp) != 1 ||
+            VSIFReadL(&poIndex->nPayloadOffset, sizeof(GUInt64), 1, fp) != 1 ||
+            VSIFReadL(&poIndex->nPayloadSize, sizeof(GUInt64), 1, fp) != 1 )
+        {
+            bOK = false;
+            break;
+        }
+        CPL_LSBPTR32(&nType);
+        CPL_LSBPTR64(&poIndex->nEntryCount);
+        CPL_LSBPTR64(&poIndex->nPayloadOffset);
+        CPL_LSBPTR64(&poIndex->nPayloadSize);
+        if( nType != OFTInteger && nType != OFTInteger64 &&
+            nType != OFTReal && nType != OFTString )
+        {
+            bOK = false;
+            break;
+        }
+        poIndex->eType = static_cast<OGRFieldType>(nType);
+        if( poIndex->nPayloadOffset > nFileSize ||
+            poIndex->nPayloadSize > nFileSize - poIndex->nPayloadOffset ||
+            poIndex->nEntryCount >
+                poIndex->nPayloadSize / poIndex->RecordSize() ||
+            (poIndex->eType != OFTString &&
+             poIndex->nEntryCount * SIDECAR_NUM_RECORD_SIZE !=
+                                                poIndex->nPayloadSize) )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Corrupted attribute index %s",
+                     osSidecarFilename.c_str());
+            bOK = false;
+            break;
+        }
+        poIndex->bBuilt = true;
+        apoIndexes.push_back(std::move(poIndex));
+    }
+
+    VSIFCloseL(fp);
+    return bOK;
+}
+
+/************************************************************************/
+/*                                Save()                                */
+/*                                                                      */
+/*      Rewrite the sidecar file with the indexes being built, and the  */
+/*      payloads of the other ones copied from the current file.  The   */
+/*      new file is written aside and then renamed.                     */
+/************************************************************************/
+
+OGRErr OGRSidecarLayerAttrIndex::Save()
+
+{
+    std::vector<OGRSidecarAttrIndex*> apoToSave;
+    for( const auto &poIndex: apoIndexes )
+    {
+        if( poIndex->bBuilt )
+            apoToSave.push_back(poIndex.get());
+    }
+
+    if( apoToSave.empty() )
+    {
+        CloseSidecar();
+        VSIUnlink(osSidecarFilename);
+        return OGRERR_NONE;
+    }
+
+    GUInt64 nDataSize = 0;
+    GInt64 nDataMTime = 0;
+    GUInt32 nDataChecksum = 0;
+    if( !OGRGetFileStamp(osDataFilename, nDataSize, nDataMTime,
+                         nDataChecksum) )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot stat %s",
+                 osDataFilename.c_str());
+        return OGRERR_FAILURE;
+    }
+
+    const CPLString osTmpFilename(osSidecarFilename + ".tmp");
+    VSILFILE *fp = VSIFOpenL(osTmpFilename, "wb");
+    if( fp == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_OpenFailed, "Cannot create %s",
+                 osTmpFilename.c_str());
+        return OGRERR_FAILURE;
+    }
+
+    // Compute the size of the directory to locate the payloads.
+    GUInt64 nOffset = SIDECAR_HEADER_SIZE;
+    for( const auto poIndex: apoToSave )
+        nOffset += 4 + poIndex->osFieldName.size() + 4 + 8 + 8 + 8;
+
+    bool bOK = VSIFWriteL(SIDECAR_SIGNATURE, SIDECAR_SIGNATURE_SIZE,
+                          1, fp) == 1;
+    CPL_LSBPTR64(&nDataSize);
+    CPL_LSBPTR64(&nDataMTime);
+    CPL_LSBPTR32(&nDataChecksum);
+    GUInt32 nFieldCount = static_cast<GUInt32>(apoToSave.size());
+    CPL_LSBPTR32(&nFieldCount);
+    bOK &= VSIFWriteL(&nDataSize, sizeof(nDataSize), 1, fp) == 1;
+    bOK &= VSIFWriteL(&nDataMTime, sizeof(nDataMTime), 1, fp) == 1;
+    bOK &= VSIFWriteL(&nDataChecksum, sizeof(nDataChecksum), 1, fp) == 1;
+    bOK &= VSIFWriteL(&nFieldCount, sizeof(nFieldCount), 1, fp) == 1;
+
+    // New location of the payloads, only applied once the file is renamed.
+    std::vector<GUInt64> anNewOffsets;
+    std::vector<GUInt64> anNewSizes;
+    for( const auto poIndex: apoToSave )
+    {
+        GUInt64 nEntryCount = poIndex->nEntryCount;
+        GUInt64 nPayloadSize = poIndex->nPayloadSize;
+        if( poIndex->bInMemory )
+        {
+            nEntryCount = poIndex->eType == OFTString ?
+                poIndex->asStrEntries.size() : poIndex->asNumEntries.size();
+            nPayloadSize = poIndex->eType == OFTString ?
+                nEntryCount * SIDECAR_STR_RECORD_SIZE +
+                                            poIndex->osStrPool.size() :
+                nEntryCount * SIDECAR_NUM_RECORD_SIZE;
+        }
+        anNewOffsets.push_back(nOffset);
+        anNewSizes.push_back(nPayloadSize);
+
+        GUInt32 nNameLen = static_cast<GUInt32>(poIndex->osFieldName.size());
+        CPL_LSBPTR32(&nNameLen);
+        GUInt32 nType = static_cast<GUInt32>(poIndex->eType);
+        CPL_LSBPTR32(&nType);
+        GUInt64 anValues[3] = { nEntryCount, nOffset, nPayloadSize };
+        CPL_LSBPTR64(&anValues[0]);
+        CPL_LSBPTR64(&anValues[1]);
+        CPL_LSBPTR64(&anValues[2]);
+        bOK &= VSIFWriteL(&nNameLen, sizeof(nNameLen), 1, fp) == 1;
+        bOK &= VSIFWriteL(poIndex->osFieldName.c_str(), 1,
+                          poIndex->osFieldName.size(), fp) ==
+                                        poIndex->osFieldName.size();
+        bOK &= VSIFWriteL(&nType, sizeof(nType), 1, fp) == 1;
+        bOK &= VSIFWriteL(anValues, sizeof(anValues), 1, fp) == 1;
+        nOffset += nPayloadSize;
+    }
+
+    std::vector<GByte> abyBuffer;
+    for( size_t iIndex = 0; bOK && iIndex < apoToSave.size(); iIndex++ )
+    {
+        const auto poIndex = apoToSave[iIndex];
+        if( !poIndex->bInMemory )
+        {
+            // Copy the payload from the current sidecar file.
+            abyBuffer.resize(SIDECAR_PAGE_SIZE);
+            GUInt64 nRemaining = poIndex->nPayloadSize;
+            GUInt64 nSrcOffset = poIndex->nPayloadOffset;
+            while( bOK && nRemaining > 0 )
+            {
+                const size_t nChunk = static_cast<size_t>(
+                    std::min(nRemaining,
+                             static_cast<GUInt64>(SIDECAR_PAGE_SIZE)));
+                bOK = ReadBytes(nSrcOffset, nChunk, abyBuffer.data()) &&
+                      VSIFWriteL(abyBuffer.data(), 1, nChunk, fp) == nChunk;
+                nSrcOffset += nChunk;
+                nRemaining -= nChunk;
+            }
+        }
+        else if( poIndex->eType == OFTString )
+        {
+            // Write entries in key order, with their keys packed in the
+            // same order.
+            GUInt64 nKeyOffset = 0;
+            for( const auto &sEntry: poIndex->asStrEntries )
+            {
+                GByte abyRecord[SIDECAR_STR_RECORD_SIZE];
+                GUInt64 nKeyOffsetLSB = nKeyOffset;
+                CPL_LSBPTR64(&nKeyOffsetLSB);
+                GUInt32 nLen = static_cast<GUInt32>(sEntry.nLength);
+                CPL_LSBPTR32(&nLen);
+                GIntBig nFID = sEntry.nFID;
+                CPL_LSBPTR64(&nFID);
+                memcpy(abyRecord, &nKeyOffsetLSB, 8);
+                memcpy(abyRecord + 8, &nLen, 4);
+                memcpy(abyRecord + 12, &nFID, 8);
+                bOK &= VSIFWriteL(abyRecord, sizeof(abyRecord), 1, fp) == 1;
+                nKeyOffset += sEntry.nLength;
+            }
+            for( const auto &sEntry: poIndex->asStrEntries )
+            {
+                bOK &= VSIFWriteL(poIndex->osStrPool.data() + sEntry.nOffset,
+                                  1, sEntry.nLength, fp) == sEntry.nLength;
+            }
+        }
+        else
+        {
+            for( const auto &sEntry: poIndex->asNumEntries )
+            {
+                GByte abyRecord[SIDECAR_NUM_RECORD_SIZE];
+                memcpy(abyRecord, &sEntry.uKey, 8);
+                CPL_LSBPTR64(abyRecord);
+                GIntBig nFID = sEntry.nFID;
+                CPL_LSBPTR64(&nFID);
+                memcpy(abyRecord + 8, &nFID, 8);
+                bOK &= VSIFWriteL(abyRecord, sizeof(abyRecord), 1, fp) == 1;
+            }
+        }
+    }
+
+    if( VSIFCloseL(fp) != 0 )
+        bOK = false;
+    CloseSidecar();
+    if( bOK )
+    {
+        VSIUnlink(osSidecarFilename);
+        bOK = VSIRename(osTmpFilename, osSidecarFilename) == 0;
+    }
+    if( !bOK )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Error while writing %s",
+                 osSidecarFilename.c_str());
+        VSIUnlink(osTmpFilename);
+        return OGRERR_FAILURE;
+    }
+
+    for( size_t iIndex = 0; iIndex < apoToSave.size(); iIndex++ )
+    {
+        const auto poIndex = apoToSave[iIndex];
+        poIndex->nEntryCount = poIndex->bInMemory ?
+            (poIndex->eType == OFTString ? poIndex->asStrEntries.size() :
+                                           poIndex->asNumEntries.size()) :
+            poIndex->nEntryCount;
+        poIndex->nPayloadOffset = anNewOffsets[iIndex];
+        poIndex->nPayloadSize = anNewSizes[iIndex];
+        poIndex->bInMemory = false;
+        poIndex->Clear();
+    }
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                             FindIndex()                              */
+/************************************************************************/
+
+OGRSidecarAttrIndex *OGRSidecarLayerAttrIndex::FindIndex( int iField ) const
+
+{
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    if( iField < 0 || iField >= poDefn->GetFieldCount() )
+        return nullptr;
+    OGRFieldDefn *poFieldDefn = poDefn->GetFieldDefn(iField);
+    for( const auto &poIndex: apoIndexes )
+    {
+        if( poIndex->osFieldName == poFieldDefn->GetNameRef() &&
+            poIndex->eType == poFieldDefn->GetType() )
+            return poIndex.get();
+    }
+    return nullptr;
+}
+
+/************************************************************************/
+/*                            CreateIndex()                             */
+/************************************************************************/
+
+OGRErr OGRSidecarLayerAttrIndex::CreateIndex( int iField )
+
+{
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    if( iField < 0 || iField >= poDefn->GetFieldCount() )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Invalid field index %d",
+                 iField);
+        return OGRERR_FAILURE;
+    }
+    OGRFieldDefn *poFieldDefn = poDefn->GetFieldDefn(iField);
+
+    if( FindIndex(iField) != nullptr )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "It seems we already have an index for field %d/%s\n"
+                 "of layer %s.",
+                 iField, poFieldDefn->GetNameRef(), poDefn->GetName());
+        return OGRERR_FAILURE;
+    }
+
+    const OGRFieldType eType = poFieldDefn->GetType();
+    if( eType != OFTInteger && eType != OFTInteger64 &&
+        eType != OFTReal && eType != OFTString )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Indexing not support for the field type of field %s.",
+                 poFieldDefn->GetNameRef());
+        return OGRERR_FAILURE;
+    }
+
+    // Drop any index of the same name but obsolete type.
+    for( auto oIter = apoIndexes.begin(); oIter != apoIndexes.end(); ++oIter )
+    {
+        if( (*oIter)->osFieldName == poFieldDefn->GetNameRef() )
+        {
+            apoIndexes.erase(oIter);
+            break;
+        }
+    }
+
+    auto poIndex = std::unique_ptr<OGRSidecarAttrIndex>(
+        new OGRSidecarAttrIndex());
+    poIndex->poOwner = this;
+    poIndex->osFieldName = poFieldDefn->GetNameRef();
+    poIndex->eType = eType;
+    poIndex->bInMemory = true;
+    // Not usable until IndexAllFeatures() has populated it.
+    poIndex->bBuilt = false;
+    apoIndexes.push_back(std::move(poIndex));
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                             DropIndex()                              */
+/************************************************************************/
+
+OGRErr OGRSidecarLayerAttrIndex::DropIndex( int iField )
+
+{
+    OGRSidecarAttrIndex *poIndex = FindIndex(iField);
+    if( poIndex == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "DROP INDEX on field (%d) that doesn't have an index.",
+                 iField);
+        return OGRERR_FAILURE;
+    }
+
+    for( auto oIter = apoIndexes.begin(); oIter != apoIndexes.end(); ++oIter )
+    {
+        if( oIter->get() == poIndex )
+        {
+            apoIndexes.erase(oIter);
+            break;
+        }
+    }
+
+    return Save();
+}
+
+/************************************************************************/
+/*                          IndexAllFeatures()                          */
+/************************************************************************/
+
+OGRErr OGRSidecarLayerAttrIndex::IndexAllFeatures( int iField )
+
+{
+    std::vector<OGRSidecarAttrIndex*> apoToBuild;
+    std::vector<int> anFields;
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    for( int i = 0; i < poDefn->GetFieldCount(); i++ )
+    {
+        if( iField >= 0 && i != iField )
+            continue;
+        OGRSidecarAttrIndex *poIndex = FindIndex(i);
+        if( poIndex == nullptr )
+            continue;
+        poIndex->Clear();
+        poIndex->bInMemory = true;
+        poIndex->bBuilt = false;
+        apoToBuild.push_back(poIndex);
+        anFields.push_back(i);
+    }
+    if( apoToBuild.empty() )
+        return OGRERR_NONE;
+
+    // Index all features, regardless of the filters currently installed.
+    char *pszOldFilter = poLayer->GetAttrQueryString() ?
+        CPLStrdup(poLayer->GetAttrQueryString()) : nullptr;
+    OGRGeometry *poOldFilterGeom = poLayer->GetSpatialFilter() ?
+        poLayer->GetSpatialFilter()->clone() : nullptr;
+    const int iOldGeomFieldFilter = poLayer->GetGeomFieldFilter();
+    poLayer->SetAttributeFilter(nullptr);
+    poLayer->SetSpatialFilter(nullptr);
+
+    OGRErr eErr = OGRERR_NONE;
+    try
+    {
+        poLayer->ResetReading();
+        for( auto &&poFeature: poLayer )
+        {
+            const GIntBig nFID = poFeature->GetFID();
+            for( size_t i = 0; i < apoToBuild.size(); i++ )
+            {
+                const int iIdxField = anFields[i];
+                if( !poFeature->IsFieldSetAndNotNull(iIdxField) )
+                    continue;
+                OGRSidecarAttrIndex *poIndex = apoToBuild[i];
+                const OGRField *psField = poFeature->GetRawFieldRef(iIdxField);
+                if( poIndex->eType == OFTString )
+                {
+                    OGRSidecarAttrIndex::StrEntry sEntry;
+                    const std::string osKey(
+                        OGRSidecarFoldString(psField->String));
+                    sEntry.nOffset = poIndex->osStrPool.size();
+                    sEntry.nLength = osKey.size();
+                    sEntry.nFID = nFID;
+                    poIndex->osStrPool += osKey;
+                    poIndex->asStrEntries.push_back(sEntry);
+                }
+                else
+                {
+                    OGRSidecarAttrIndex::NumEntry sEntry;
+                    if( poIndex->eType == OFTReal )
+                    {
+                        if( std::isnan(psField->Real) )
+                            continue;
+                        // Normalize -0 so that its bit pattern matches +0.
+                        sEntry.uKey.dfKey =
+                            psField->Real == 0.0 ? 0.0 : psField->Real;
+                    }
+                    else if( poIndex->eType == OFTInteger )
+                        sEntry.uKey.nKey = psField->Integer;
+                    else
+                        sEntry.uKey.nKey = psField->Integer64;
+                    sEntry.nFID = nFID;
+                    poIndex->asNumEntries.push_back(sEntry);
+                }
+            }
+        }
+    }
+    catch( const std::exception& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate memory for attribute index");
+        eErr = OGRERR_NOT_ENOUGH_MEMORY;
+    }
+
+    poLayer->SetAttributeFilter(pszOldFilter);
+    CPLFree(pszOldFilter);
+    poLayer->SetSpatialFilter(iOldGeomFieldFilter, poOldFilterGeom);
+    delete poOldFilterGeom;
+
+    if( eErr == OGRERR_NONE )
+    {
+        for( auto poIndex: apoToBuild )
+        {
+            poIndex->Sort();
+            poIndex->bBuilt = true;
+        }
+        eErr = Save();
+    }
+
+    if( eErr != OGRERR_NONE )
+    {
+        for( auto poIndex: apoToBuild )
+        {
+            poIndex->Clear();
+            poIndex->bBuilt = false;
+        }
+    }
+    return eErr;
+}
+
+/************************************************************************/
+/*                             AddToIndex()                             */
+/************************************************************************/
+
+OGRErr OGRSidecarLayerAttrIndex::AddToIndex( OGRFeature * /* poFeature */,
+                                             int /* iField */ )
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                          RemoveFromIndex()                           */
+/************************************************************************/
+
+OGRErr OGRSidecarLayerAttrIndex::RemoveFromIndex( OGRFeature * /*poFeature*/ )
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                           GetFieldIndex()                            */
+/************************************************************************/
+
+OGRAttrIndex *OGRSidecarLayerAttrIndex::GetFieldIndex( int iField )
+
+{
+    OGRSidecarAttrIndex *poIndex = FindIndex(iField);
+    if( poIndex == nullptr || !poIndex->bBuilt || poIndex->bInMemory )
+        return nullptr;
+    return poIndex;
+}
+
+/************************************************************************/
+/*                     OGRCreateSidecarLayerIndex()                     */
+/************************************************************************/
+
+OGRLayerAttrIndex *OGRCreateSidecarLayerIndex()
+
+{
+    return new OGRSidecarLayerAttrIndex();
+}
+
+//! @endcond
@@ -33,12 +33,27 @@
 #include "ogr_attrind.h"
 #include "ogr_swq.h"
 #include "ograpispy.h"
+#include "cpl_quad_tree.h"
+#include "cpl_worker_thread_pool.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
 
 CPL_CVSID("$Id$")
 
 struct OGRLayer::Private
 {
     bool         m_bInFeatureIterator = false;
+
+    // State of GetNextFeatureFromAttrIndex()
+    bool         m_bAttrIndexEvaluated = false;
+    bool         m_bInAttrIndexFetch = false;
+    GIntBig     *m_panAttrIndexFIDs = nullptr;
+    size_t       m_iNextAttrIndexFID = 0;
+
+    ~Private() { CPLFree(m_panAttrIndexFIDs); }
 };
 
 /************************************************************************/
@@ -340,6 +355,7 @@ OGRErr OGRLayer::SetAttributeFilter( const char *pszQuery )
 {
     CPLFree(m_pszAttrQueryString);
     m_pszAttrQueryString = (pszQuery) ? CPLStrdup(pszQuery) : nullptr;
+    ResetAttrIndexReading();
 
 /* -------------------------------------------------------------------- */
 /*      Are we just clearing any existing query?                        */
@@ -1511,6 +1527,109 @@ OGRErr OGRLayer::InitializeIndexSupport( const char *pszFilename )
 
     return eErr;
 }
+
+/************************************************************************/
+/*                   InitializeSidecarIndexSupport()                    */
+/*                                                                      */
+/*      Same as InitializeIndexSupport(), but attaches the generic      */
+/*      attribute indexes stored in a <pszFilename>.ogridx sidecar      */
+/*      file. Drivers using it should call                              */
+/*      GetNextFeatureFromAttrIndex() from their GetNextFeature() and   */
+/*      ResetAttrIndexReading() from their ResetReading(), and must     */
+/*      have an efficient GetFeature() implementation.                  */
+/************************************************************************/
+
+OGRErr OGRLayer::InitializeSidecarIndexSupport( const char *pszFilename )
+
+{
+    if (m_poAttrIndex != nullptr)
+        return OGRERR_NONE;
+
+    m_poAttrIndex = OGRCreateSidecarLayerIndex();
+
+    const OGRErr eErr = m_poAttrIndex->Initialize( pszFilename, this );
+    if( eErr != OGRERR_NONE )
+    {
+        delete m_poAttrIndex;
+        m_poAttrIndex = nullptr;
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                    GetNextFeatureFromAttrIndex()                     */
+/*                                                                      */
+/*      Returns false if the current attribute filter cannot be         */
+/*      resolved with the attribute indexes, in which case the caller   */
+/*      should do a regular scan.  Otherwise returns true, and sets     */
+/*      poFeature to the next feature matching both the attribute and   */
+/*      the spatial filters, or nullptr when all have been returned.    */
+/************************************************************************/
+
+bool OGRLayer::GetNextFeatureFromAttrIndex( OGRFeature *&poFeature )
+
+{
+    poFeature = nullptr;
+
+    // GetFeature() implementations may call GetNextFeature().
+    if( m_poPrivate->m_bInAttrIndexFetch ||
+        m_poAttrQuery == nullptr || m_poAttrIndex == nullptr )
+        return false;
+
+    if( !m_poPrivate->m_bAttrIndexEvaluated )
+    {
+        m_poPrivate->m_bAttrIndexEvaluated = true;
+        m_poPrivate->m_iNextAttrIndexFID = 0;
+        if( m_poAttrQuery->CanUseIndex(this) )
+        {
+            m_poPrivate->m_panAttrIndexFIDs =
+                m_poAttrQuery->EvaluateAgainstIndices(this, nullptr);
+        }
+    }
+
+    GIntBig *panFIDs = m_poPrivate->m_panAttrIndexFIDs;
+    if( panFIDs == nullptr )
+        return false;
+
+    while( panFIDs[m_poPrivate->m_iNextAttrIndexFID] != OGRNullFID )
+    {
+        const GIntBig nFID = panFIDs[m_poPrivate->m_iNextAttrIndexFID++];
+
+        m_poPrivate->m_bInAttrIndexFetch = true;
+        OGRFeature *poCandidate = GetFeature(nFID);
+        m_poPrivate->m_bInAttrIndexFetch = false;
+        if( poCandidate == nullptr )
+            continue;
+
+        if( (m_poFilterGeom == nullptr ||
+             FilterGeometry(poCandidate->GetGeomFieldRef(m_iGeomFieldFilter)))
+            && m_poAttrQuery->Evaluate(poCandidate) )
+        {
+            m_nFeaturesRead++;
+            poFeature = poCandidate;
+            return true;
+        }
+        delete poCandidate;
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                       ResetAttrIndexReading()                        */
+/************************************************************************/
+
+void OGRLayer::ResetAttrIndexReading()
+
+{
+    if( m_poPrivate->m_bInAttrIndexFetch )
+        return;
+    m_poPrivate->m_bAttrIndexEvaluated = false;
+    m_poPrivate->m_iNextAttrIndexFID = 0;
+    CPLFree(m_poPrivate->m_panAttrIndexFIDs);
+    m_poPrivate->m_panAttrIndexFIDs = nullptr;
+}
 //! @endcond
 
 /************************************************************************/
@@ -4267,6 +4386,534 @@ OGRErr OGR_L_Erase( OGRLayerH pLayerInput,
         papszOptions, pfnProgress, pProgressArg );
 }
 
+/************************************************************************/
+/*                   helper structures for SpatialJoin()                */
+/************************************************************************/
+
+namespace {
+
+// A feature of the method layer, and its envelope in the quadtree.
+struct SpatialJoinMethodFeature
+{
+    OGRFeatureUniquePtr poFeature{};
+    CPLRectObj          sRect{};
+};
+
+// Prepared geometries of the method features, created lazily. Each job
+// slot owns one such cache, since a GEOS prepared geometry cannot be used
+// by several threads at the same time.
+struct SpatialJoinCache
+{
+    std::vector<OGRPreparedGeometry*> apoPrepared{};
+
+    SpatialJoinCache() = default;
+    ~SpatialJoinCache()
+    {
+        for( auto poPrepared: apoPrepared )
+            OGRDestroyPreparedGeometry(poPrepared);
+    }
+
+    CPL_DISALLOW_COPY_ASSIGN(SpatialJoinCache)
+};
+
+struct SpatialJoinJob
+{
+    const std::vector<SpatialJoinMethodFeature>* paoMethod = nullptr;
+    const CPLQuadTree*  hTree = nullptr;
+    SpatialJoinCache*   poCache = nullptr;
+    bool                bUsePreparedGeometries = false;
+    bool                bWithin = false;
+
+    // Input features handled by this job, and for each of them, the
+    // indices of the matching method features.
+    OGRFeature* const*  papoInput = nullptr;
+    std::vector<int>*   panMatches = nullptr;
+    size_t              nInputCount = 0;
+
+    int                 nFailures = 0;
+};
+
+} // namespace
+
+/************************************************************************/
+/*                        SpatialJoinJobFunc()                          */
+/************************************************************************/
+
+static void SpatialJoinJobFunc( void* pData )
+{
+    SpatialJoinJob* psJob = static_cast<SpatialJoinJob*>(pData);
+    const auto& aoMethod = *(psJob->paoMethod);
+    auto& apoPrepared = psJob->poCache->apoPrepared;
+
+    for( size_t i = 0; i < psJob->nInputCount; i++ )
+    {
+        auto& anMatches = psJob->panMatches[i];
+        anMatches.clear();
+        const OGRGeometry* x_geom = psJob->papoInput[i]->GetGeometryRef();
+        if( x_geom == nullptr || x_geom->IsEmpty() )
+            continue;
+
+        OGREnvelope x_env;
+        x_geom->getEnvelope(&x_env);
+        CPLRectObj sRect;
+        sRect.minx = x_env.MinX;
+        sRect.miny = x_env.MinY;
+        sRect.maxx = x_env.MaxX;
+        sRect.maxy = x_env.MaxY;
+        int nCandidates = 0;
+        void** pahCandidates =
+            CPLQuadTreeSearch(psJob->hTree, &sRect, &nCandidates);
+        for( int j = 0; j < nCandidates; j++ )
+        {
+            anMatches.push_back(static_cast<int>(
+                reinterpret_cast<GUIntptr_t>(pahCandidates[j])));
+        }
+        CPLFree(pahCandidates);
+        // Report matches in the order of the method layer.
+        std::sort(anMatches.begin(), anMatches.end());
+
+        size_t nKept = 0;
+        for( size_t j = 0; j < anMatches.size(); j++ )
+        {
+            const int iMethod = anMatches[j];
+            const OGRGeometry* y_geom =
+                aoMethod[iMethod].poFeature->GetGeometryRef();
+            CPLErrorReset();
+            bool bMatch = false;
+            if( psJob->bUsePreparedGeometries )
+            {
+                if( apoPrepared[iMethod] == nullptr )
+                    apoPrepared[iMethod] = OGRCreatePreparedGeometry(y_geom);
+                if( apoPrepared[iMethod] == nullptr )
+                {
+                    psJob->nFailures++;
+                    continue;
+                }
+                bMatch = psJob->bWithin ?
+                    CPL_TO_BOOL(OGRPreparedGeometryContains(
+                                    apoPrepared[iMethod], x_geom)) :
+                    CPL_TO_BOOL(OGRPreparedGeometryIntersects(
+                                    apoPrepared[iMethod], x_geom));
+            }
+            else
+            {
+                bMatch = psJob->bWithin ?
+                    CPL_TO_BOOL(x_geom->Within(y_geom)) :
+                    CPL_TO_BOOL(y_geom->Intersects(x_geom));
+            }
+            if( CPLGetLastErrorType() != CE_None )
+            {
+                psJob->nFailures++;
+                CPLErrorReset();
+                continue;
+            }
+            if( bMatch )
+                anMatches[nKept++] = iMethod;
+        }
+        anMatches.resize(nKept);
+    }
+}
+
+/************************************************************************/
+/*                           SpatialJoin()                              */
+/************************************************************************/
+/**
+ * \brief Spatial join of two layers.
+ *
+ * The result layer contains, for each pair made of a feature of the input
+ * layer and a feature of the method layer whose geometries satisfy the
+ * spatial predicate, a feature with the geometry of the input feature
+ * and the attributes of both features. This is typically used to assign
+ * a large number of points to the polygons containing them. The schema
+ * of the result layer can be set by the user or, if it is empty, is
+ * initialized to contain all fields in the input and method layers.
+ *
+ * The method layer is loaded in memory, indexed with a quadtree, and its
+ * geometries are prepared only once. The input layer is then read by
+ * batches whose predicates are evaluated by several threads. Result
+ * features are written in the order of the input layer, and then of the
+ * method layer.
+ *
+ * \note If the schema of the result is set by user and contains
+ * fields that have the same name as a field in input and in method
+ * layer, then the attribute in the result feature will get the value
+ * from the feature of the method layer.
+ *
+ * \note For best performance use the smallest layer as the method layer.
+ *
+ * \note This method relies on GEOS support. Do not use unless the
+ * GEOS support is compiled in.
+ *
+ * The recognized list of options is:
+ * <ul>
+ * <li>SKIP_FAILURES=YES/NO. Set to YES to go on, even when a
+ *     feature could not be inserted or a GEOS call failed.
+ * <li>PROMOTE_TO_MULTI=YES/NO. Set to YES to convert Polygons
+ *     into MultiPolygons, or LineStrings to MultiLineStrings.
+ * <li>INPUT_PREFIX=string. Set a prefix for the field names that
+ *     will be created from the fields of the input layer.
+ * <li>METHOD_PREFIX=string. Set a prefix for the field names that
+ *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries for the features of the method layer.
+ * <li>PREDICATE=INTERSECTS/WITHIN. Spatial relationship that features of
+ *     the input layer must have with features of the method layer.
+ *     Defaults to INTERSECTS.
+ * <li>KEEP_UNMATCHED=YES/NO. Set to YES to also add the features of the
+ *     input layer that match no feature of the method layer, with
+ *     unset method fields. Defaults to NO.
+ * <li>NUM_THREADS=number/ALL_CPUS. Number of threads used to evaluate
+ *     the predicates. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or ALL_CPUS if it is not set.
+ * </ul>
+ *
+ * This method is the same as the C function OGR_L_SpatialJoin().
+ *
+ * @param pLayerMethod the method layer. Should not be NULL.
+ *
+ * @param pLayerResult the layer where the features resulting from the
+ * operation are inserted. Should not be NULL. See above the note
+ * about the schema.
+ *
+ * @param papszOptions NULL terminated list of options (may be NULL).
+ *
+ * @param pfnProgress a GDALProgressFunc() compatible callback function for
+ * reporting progress or NULL.
+ *
+ * @param pProgressArg argument to be passed to pfnProgress. May be NULL.
+ *
+ * @return an error code if there was an error or the execution was
+ * interrupted, OGRERR_NONE otherwise.
+ *
+ * @note The first geometry field is always used.
+ *
+ * @since GDAL 3.1
+ */
+
+OGRErr OGRLayer::SpatialJoin( OGRLayer *pLayerMethod,
+                              OGRLayer *pLayerResult,
+                              char** papszOptions,
+                              GDALProgressFunc pfnProgress,
+                              void * pProgressArg )
+{
+    OGRFeatureDefn *poDefnInput = GetLayerDefn();
+    OGRFeatureDefn *poDefnMethod = pLayerMethod->GetLayerDefn();
+    OGRFeatureDefn *poDefnResult = nullptr;
+    int *mapInput = nullptr;
+    int *mapMethod = nullptr;
+    const bool bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
+    const bool bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
+    const bool bUsePreparedGeometries =
+        CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_PREPARED_GEOMETRIES", "YES")) &&
+        OGRHasPreparedGeometrySupport();
+    const bool bKeepUnmatched = CPLTestBool(CSLFetchNameValueDef(papszOptions, "KEEP_UNMATCHED", "NO"));
+    const char* pszPredicate = CSLFetchNameValueDef(papszOptions, "PREDICATE", "INTERSECTS");
+    const bool bWithin = EQUAL(pszPredicate, "WITHIN");
+    if (!bWithin && !EQUAL(pszPredicate, "INTERSECTS")) {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Unsupported value for PREDICATE: %s", pszPredicate);
+        return OGRERR_FAILURE;
+    }
+    const char* pszNumThreads = CSLFetchNameValueDef(papszOptions, "NUM_THREADS",
+        CPLGetConfigOption("GDAL_NUM_THREADS", "ALL_CPUS"));
+    int nThreads = CPLGetNumCPUs();
+    if (!EQUAL(pszNumThreads, "ALL_CPUS"))
+        nThreads = std::max(1, std::min(2 * nThreads, atoi(pszNumThreads)));
+
+    // check for GEOS
+    if (!OGRGeometryFactory::haveGEOS()) {
+        return OGRERR_UNSUPPORTED_OPERATION;
+    }
+
+    // get resources
+    OGRErr ret = create_field_map(poDefnInput, &mapInput);
+    if (ret != OGRERR_NONE) {
+        VSIFree(mapInput);
+        return ret;
+    }
+    ret = create_field_map(poDefnMethod, &mapMethod);
+    if (ret == OGRERR_NONE)
+        ret = set_result_schema(pLayerResult, poDefnInput, poDefnMethod, mapInput, mapMethod, true, papszOptions);
+    if (ret != OGRERR_NONE) {
+        VSIFree(mapInput);
+        VSIFree(mapMethod);
+        return ret;
+    }
+    poDefnResult = pLayerResult->GetLayerDefn();
+
+    // load and index the method layer
+    std::vector<SpatialJoinMethodFeature> aoMethod;
+    CPLRectObj sGlobalBounds;
+    sGlobalBounds.minx = std::numeric_limits<double>::max();
+    sGlobalBounds.miny = std::numeric_limits<double>::max();
+    sGlobalBounds.maxx = -std::numeric_limits<double>::max();
+    sGlobalBounds.maxy = -std::numeric_limits<double>::max();
+    for( auto&& y: pLayerMethod ) {
+        OGRGeometry *y_geom = y->GetGeometryRef();
+        if (!y_geom || y_geom->IsEmpty()) continue;
+        OGREnvelope y_env;
+        y_geom->getEnvelope(&y_env);
+        SpatialJoinMethodFeature oMethodFeature;
+        oMethodFeature.sRect.minx = y_env.MinX;
+        oMethodFeature.sRect.miny = y_env.MinY;
+        oMethodFeature.sRect.maxx = y_env.MaxX;
+        oMethodFeature.sRect.maxy = y_env.MaxY;
+        sGlobalBounds.minx = std::min(sGlobalBounds.minx, y_env.MinX);
+        sGlobalBounds.miny = std::min(sGlobalBounds.miny, y_env.MinY);
+        sGlobalBounds.maxx = std::max(sGlobalBounds.maxx, y_env.MaxX);
+        sGlobalBounds.maxy = std::max(sGlobalBounds.maxy, y_env.MaxY);
+        oMethodFeature.poFeature.reset(y.release());
+        aoMethod.push_back(std::move(oMethodFeature));
+    }
+
+    CPLQuadTree* hTree = nullptr;
+    if (!aoMethod.empty()) {
+        hTree = CPLQuadTreeCreate(&sGlobalBounds, nullptr);
+        CPLQuadTreeSetMaxDepth(hTree,
+            CPLQuadTreeGetAdvisedMaxDepth(static_cast<int>(aoMethod.size())));
+        for( size_t i = 0; i < aoMethod.size(); i++ ) {
+            CPLQuadTreeInsertWithBounds(hTree,
+                reinterpret_cast<void*>(static_cast<GUIntptr_t>(i)),
+                &aoMethod[i].sRect);
+        }
+    }
+    else if (!bKeepUnmatched) {
+        // nothing can match
+        VSIFree(mapInput);
+        VSIFree(mapMethod);
+        if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
+            CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+            return OGRERR_FAILURE;
+        }
+        return OGRERR_NONE;
+    }
+
+    // set up the worker threads. Each job of a batch handles a slice of
+    // the input features, with its own cache of prepared geometries.
+    std::unique_ptr<CPLWorkerThreadPool> poPool;
+    if (nThreads > 1 && hTree != nullptr) {
+        poPool.reset(new CPLWorkerThreadPool());
+        if (!poPool->Setup(nThreads, nullptr, nullptr)) {
+            poPool.reset();
+            nThreads = 1;
+        }
+    }
+    else {
+        nThreads = 1;
+    }
+    constexpr size_t BATCH_SIZE_PER_THREAD = 1000;
+    const size_t nBatchSize = BATCH_SIZE_PER_THREAD * nThreads;
+
+    std::vector<SpatialJoinCache> aoCaches(nThreads);
+    for( auto& oCache: aoCaches )
+        oCache.apoPrepared.resize(aoMethod.size());
+    std::vector<SpatialJoinJob> asJobs(nThreads);
+    std::vector<OGRFeatureUniquePtr> apoBatch;
+    std::vector<OGRFeature*> apoBatchRaw;
+    std::vector<std::vector<int>> aanMatches(nBatchSize);
+
+    const double progress_max = static_cast<double>(GetFeatureCount(FALSE));
+    double progress_counter = 0;
+
+    ResetReading();
+    bool bEOF = false;
+    while (ret == OGRERR_NONE && !bEOF) {
+        // read a batch of input features
+        apoBatch.clear();
+        apoBatchRaw.clear();
+        while (apoBatch.size() < nBatchSize) {
+            OGRFeature* x = GetNextFeature();
+            if (!x) {
+                bEOF = true;
+                break;
+            }
+            apoBatch.emplace_back(x);
+            apoBatchRaw.push_back(x);
+        }
+        if (apoBatch.empty())
+            break;
+
+        // evaluate the predicates
+        if (hTree) {
+            const size_t nPerJob = (apoBatch.size() + nThreads - 1) / nThreads;
+            size_t nStart = 0;
+            for( int i = 0; i < nThreads; i++ ) {
+                SpatialJoinJob& sJob = asJobs[i];
+                sJob.paoMethod = &aoMethod;
+                sJob.hTree = hTree;
+                sJob.poCache = &aoCaches[i];
+                sJob.bUsePreparedGeometries = bUsePreparedGeometries;
+                sJob.bWithin = bWithin;
+                sJob.papoInput = apoBatchRaw.data() + nStart;
+                sJob.panMatches = aanMatches.data() + nStart;
+                sJob.nInputCount = std::min(nPerJob, apoBatch.size() - nStart);
+                sJob.nFailures = 0;
+                nStart += sJob.nInputCount;
+                if (poPool)
+                    poPool->SubmitJob(SpatialJoinJobFunc, &sJob);
+                else
+                    SpatialJoinJobFunc(&sJob);
+            }
+            if (poPool)
+                poPool->WaitCompletion();
+            for( const auto& sJob: asJobs ) {
+                if (sJob.nFailures > 0 && !bSkipFailures) {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "Failed to evaluate spatial predicate");
+                    ret = OGRERR_FAILURE;
+                    break;
+                }
+            }
+            if (ret != OGRERR_NONE)
+                break;
+        }
+
+        // write the result features
+        for( size_t i = 0; i < apoBatch.size(); i++ ) {
+            if (pfnProgress) {
+                if (!pfnProgress(progress_counter/progress_max, "", pProgressArg)) {
+                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+                    ret = OGRERR_FAILURE;
+                    break;
+                }
+                progress_counter += 1.0;
+            }
+
+            OGRFeature* x = apoBatch[i].get();
+            OGRGeometry *x_geom = x->GetGeometryRef();
+            if (aanMatches[i].empty()) {
+                if (!bKeepUnmatched) continue;
+                // -1 stands for "no method feature"
+                aanMatches[i].push_back(-1);
+            }
+            for( const int iMethod: aanMatches[i] ) {
+                OGRFeatureUniquePtr z(new OGRFeature(poDefnResult));
+                z->SetFieldsFrom(x, mapInput);
+                if (iMethod >= 0)
+                    z->SetFieldsFrom(aoMethod[iMethod].poFeature.get(), mapMethod);
+                if (x_geom) {
+                    OGRGeometry* z_geom = x_geom->clone();
+                    if (bPromoteToMulti)
+                        z_geom = promote_to_multi(z_geom);
+                    z->SetGeometryDirectly(z_geom);
+                }
+                ret = pLayerResult->CreateFeature(z.get());
+                if (ret != OGRERR_NONE) {
+                    if (!bSkipFailures) {
+                        break;
+                    } else {
+                        CPLErrorReset();
+                        ret = OGRERR_NONE;
+                    }
+                }
+            }
+            if (ret != OGRERR_NONE)
+                break;
+        }
+    }
+    if (ret == OGRERR_NONE && pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
+        CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+        ret = OGRERR_FAILURE;
+    }
+
+    // release resources
+    poPool.reset();
+    if (hTree) CPLQuadTreeDestroy(hTree);
+    VSIFree(mapInput);
+    VSIFree(mapMethod);
+    return ret;
+}
+
+/************************************************************************/
+/*                        OGR_L_SpatialJoin()                           */
+/************************************************************************/
+/**
+ * \brief Spatial join of two layers.
+ *
+ * The result layer contains, for each pair made of a feature of the input
+ * layer and a feature of the method layer whose geometries satisfy the
+ * spatial predicate, a feature with the geometry of the input feature
+ * and the attributes of both features. This is typically used to assign
+ * a large number of points to the polygons containing them. The schema
+ * of the result layer can be set by the user or, if it is empty, is
+ * initialized to contain all fields in the input and method layers.
+ *
+ * \note If the schema of the result is set by user and contains
+ * fields that have the same name as a field in input and in method
+ * layer, then the attribute in the result feature will get the value
+ * from the feature of the method layer.
+ *
+ * \note For best performance use the smallest layer as the method layer.
+ *
+ * \note This method relies on GEOS support. Do not use unless the
+ * GEOS support is compiled in.
+ *
+ * The recognized list of options is :
+ * <ul>
+ * <li>SKIP_FAILURES=YES/NO. Set it to YES to go on, even when a
+ *     feature could not be inserted or a GEOS call failed.
+ * <li>PROMOTE_TO_MULTI=YES/NO. Set it to YES to convert Polygons
+ *     into MultiPolygons, or LineStrings to MultiLineStrings.
+ * <li>INPUT_PREFIX=string. Set a prefix for the field names that
+ *     will be created from the fields of the input layer.
+ * <li>METHOD_PREFIX=string. Set a prefix for the field names that
+ *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries for the features of the method layer.
+ * <li>PREDICATE=INTERSECTS/WITHIN. Spatial relationship that features of
+ *     the input layer must have with features of the method layer.
+ *     Defaults to INTERSECTS.
+ * <li>KEEP_UNMATCHED=YES/NO. Set to YES to also add the features of the
+ *     input layer that match no feature of the method layer, with
+ *     unset method fields. Defaults to NO.
+ * <li>NUM_THREADS=number/ALL_CPUS. Number of threads used to evaluate
+ *     the predicates. Defaults to the value of the GDAL_NUM_THREADS
+ *     configuration option, or ALL_CPUS if it is not set.
+ * </ul>
+ *
+ * This function is the same as the C++ method OGRLayer::SpatialJoin().
+ *
+ * @param pLayerInput the input layer. Should not be NULL.
+ *
+ * @param pLayerMethod the method layer. Should not be NULL.
+ *
+ * @param pLayerResult the layer where the features resulting from the
+ * operation are inserted. Should not be NULL. See above the note
+ * about the schema.
+ *
+ * @param papszOptions NULL terminated list of options (may be NULL).
+ *
+ * @param pfnProgress a GDALProgressFunc() compatible callback function for
+ * reporting progress or NULL.
+ *
+ * @param pProgressArg argument to be passed to pfnProgress. May be NULL.
+ *
+ * @return an error code if there was an error or the execution was
+ * interrupted, OGRERR_NONE otherwise.
+ *
+ * @note The first geometry field is always used.
+ *
+ * @since GDAL 3.1
+ */
+
+OGRErr OGR_L_SpatialJoin( OGRLayerH pLayerInput,
+                          OGRLayerH pLayerMethod,
+                          OGRLayerH pLayerResult,
+                          char** papszOptions,
+                          GDALProgressFunc pfnProgress,
+                          void * pProgressArg )
+
+{
+    VALIDATE_POINTER1( pLayerInput, "OGR_L_SpatialJoin", OGRERR_INVALID_HANDLE );
+    VALIDATE_POINTER1( pLayerMethod, "OGR_L_SpatialJoin", OGRERR_INVALID_HANDLE );
+    VALIDATE_POINTER1( pLayerResult, "OGR_L_SpatialJoin", OGRERR_INVALID_HANDLE );
+
+    return OGRLayer::FromHandle(pLayerInput)->SpatialJoin(
+        OGRLayer::FromHandle(pLayerMethod),
+        OGRLayer::FromHandle(pLayerResult),
+        papszOptions, pfnProgress, pProgressArg );
+}
+
 /************************************************************************/
 /*                  OGRLayer::FeatureIterator::Private                  */
 /************************************************************************/
@@ -204,6 +204,14 @@ int OGRGeoJSONDataSource::Open( GDALOpenInfo* poOpenInfo,
         return FALSE;
     }
 
+    // Attach the attribute indexes created by CREATE INDEX, if any.
+    if( eGeoJSONSourceFile == nSrcType && !bUpdatable_ && nLayers_ == 1 &&
+        EQUAL(pszJSonFlavor, "GeoJSON") &&
+        !STARTS_WITH(pszUnprefixed, "/vsistdin/") )
+    {
+        papoLayers_[0]->InitializeSidecarIndexSupport(pszUnprefixed);
+    }
+
     return TRUE;
 }
 
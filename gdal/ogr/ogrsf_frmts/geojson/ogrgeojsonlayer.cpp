@@ -129,6 +129,7 @@ void OGRGeoJSONLayer::SetFIDColumn( const char* pszFIDColumn )
 void OGRGeoJSONLayer::ResetReading()
 {
     nFeatureReadSinceReset_ = 0;
+    ResetAttrIndexReading();
     if( poReader_ )
     {
         TerminateAppendSession();
@@ -145,6 +146,16 @@ void OGRGeoJSONLayer::ResetReading()
 
 OGRFeature* OGRGeoJSONLayer::GetNextFeature()
 {
+    // Fetch directly the matching features if the attribute filter
+    // can be resolved with the attribute indexes.
+    OGRFeature *poIndexedFeature = nullptr;
+    if( GetNextFeatureFromAttrIndex(poIndexedFeature) )
+    {
+        if( poIndexedFeature )
+            nFeatureReadSinceReset_ ++;
+        return poIndexedFeature;
+    }
+
     if( poReader_ )
     {
         if( bHasAppendedFeatures_ )
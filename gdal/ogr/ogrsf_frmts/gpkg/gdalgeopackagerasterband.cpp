@@ -29,10 +29,14 @@
 #include "ogr_geopackage.h"
 #include "memdataset.h"
 #include "gdal_alg_priv.h"
+#include "cpl_worker_thread_pool.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <limits>
+#include <map>
+#include <vector>
 
 CPL_CVSID("$Id$")
 
@@ -40,6 +44,29 @@ CPL_CVSID("$Id$")
 #define DEBUG_VERBOSE
 #endif
 
+/************************************************************************/
+/*                          GPKGTileEncodeJob                           */
+/************************************************************************/
+
+// Tile compressed by a worker thread, whose resulting blob is inserted
+// afterwards in the database by the main thread.
+struct GPKGTileEncodeJob
+{
+    GDALGPKGMBTilesLikePseudoDataset* poDS = nullptr;
+    int                 nRow = 0;
+    int                 nCol = 0;
+    std::vector<GByte>  abyTileData{};
+    GDALDriver*         poDriver = nullptr;
+    std::unique_ptr<GDALDataset> poMEMDS{};
+    CPLStringList       aosCreationOptions{};
+    CPLString           osMemFileName{};
+    GByte*              pabyBlob = nullptr;
+    vsi_l_offset        nBlobSize = 0;
+    std::atomic<bool>   bDone{false};
+
+    ~GPKGTileEncodeJob() { CPLFree(pabyBlob); }
+};
+
 /************************************************************************/
 /*                    GDALGPKGMBTilesLikePseudoDataset()                */
 /************************************************************************/
@@ -98,6 +125,11 @@ GDALGPKGMBTilesLikePseudoDataset::GDALGPKGMBTilesLikePseudoDataset() :
 
 GDALGPKGMBTilesLikePseudoDataset::~GDALGPKGMBTilesLikePseudoDataset()
 {
+    // Normally already done by FlushTiles(), unless an error occurred.
+    if( m_poWorkerThreadPool )
+        m_poWorkerThreadPool->WaitCompletion();
+    m_apoTileEncodeJobs.clear();
+
     if( m_poParentDS == nullptr && m_hTempDB != nullptr )
     {
         sqlite3_close(m_hTempDB);
@@ -192,6 +224,9 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::FlushTiles()
         }
     }
 
+    if( poMainDS->FlushTileEncodeJobs(0) != CE_None )
+        eErr = CE_Failure;
+
     if( poMainDS->m_nTileInsertionCount > 0 )
     {
         if( poMainDS->ICommitTransaction() != OGRERR_NONE )
@@ -896,6 +931,10 @@ GByte* GDALGPKGMBTilesLikePseudoDataset::ReadTile( int nRow, int nCol, GByte *pa
     CPLDebug( "GPKG", "ReadTile(row=%d, col=%d)", nRow, nCol );
 #endif
 
+    // Make sure tiles still being compressed are in the database
+    GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
+    poMainDS->FlushTileEncodeJobs(0);
+
     char *pszSQL = sqlite3_mprintf( "SELECT tile_data%s FROM \"%w\" "
         "WHERE zoom_level = %d AND tile_row = %d AND tile_column = %d%s",
         m_eDT != GDT_Byte ? ", id" : "", // MBTiles do not have an id
@@ -1227,6 +1266,242 @@ retry:
     return CE_None;
 }
 
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr GDALGPKGMBTilesLikeRasterBand::IRasterIO( GDALRWFlag eRWFlag,
+                                          int nXOff, int nYOff,
+                                          int nXSize, int nYSize,
+                                          void * pData,
+                                          int nBufXSize, int nBufYSize,
+                                          GDALDataType eBufType,
+                                          GSpacing nPixelSpace,
+                                          GSpacing nLineSpace,
+                                          GDALRasterIOExtraArg* psExtraArg )
+{
+    if( eRWFlag == GF_Read )
+    {
+        m_poTPD->DecodeTilesConcurrently(nXOff, nYOff, nXSize, nYSize,
+                                         nBufXSize, nBufYSize);
+    }
+    return GDALPamRasterBand::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                        pData, nBufXSize, nBufYSize, eBufType,
+                                        nPixelSpace, nLineSpace, psExtraArg);
+}
+
+/************************************************************************/
+/*                          GPKGTileDecodeJob                           */
+/************************************************************************/
+
+namespace {
+struct GPKGTileDecodeJob
+{
+    GDALGPKGMBTilesLikePseudoDataset* poDS = nullptr;
+    int                 nBlockXOff = 0;
+    int                 nBlockYOff = 0;
+    std::vector<GByte>  abyBlob{};
+    double              dfTileOffset = 0.0;
+    double              dfTileScale = 1.0;
+    std::vector<GByte>  abyTileData{};
+    bool                bOK = false;
+};
+} // namespace
+
+/************************************************************************/
+/*                         GPKGDecodeTileJob()                          */
+/************************************************************************/
+
+static void GPKGDecodeTileJob(void* pData)
+{
+    GPKGTileDecodeJob* psJob = static_cast<GPKGTileDecodeJob*>(pData);
+    CPLString osMemFileName;
+    osMemFileName.Printf("/vsimem/gpkg_read_tile_%p", psJob);
+    VSILFILE * fp = VSIFileFromMemBuffer(
+        osMemFileName.c_str(), psJob->abyBlob.data(),
+        psJob->abyBlob.size(), FALSE );
+    VSIFCloseL(fp);
+    // Errors are reported when the tile is read again by IReadBlock()
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    psJob->bOK = psJob->poDS->ReadTile(osMemFileName,
+                                       psJob->abyTileData.data(),
+                                       psJob->dfTileOffset,
+                                       psJob->dfTileScale) == CE_None;
+    CPLPopErrorHandler();
+    VSIUnlink(osMemFileName);
+}
+
+/************************************************************************/
+/*                      DecodeTilesConcurrently()                       */
+/************************************************************************/
+
+/* Decode with the worker thread pool the tiles intersecting the window */
+/* of a RasterIO() request, and put them in the block cache. */
+void GDALGPKGMBTilesLikePseudoDataset::DecodeTilesConcurrently(
+                                        int nXOff, int nYOff,
+                                        int nXSize, int nYSize,
+                                        int nBufXSize, int nBufYSize)
+{
+    CPLWorkerThreadPool* poPool = GetWorkerThreadPool();
+    if( poPool == nullptr || m_pabyCachedTiles == nullptr ||
+        m_nShiftXPixelsMod != 0 || m_nShiftYPixelsMod != 0 ||
+        nXSize <= 0 || nYSize <= 0 )
+    {
+        return;
+    }
+
+    // Sub-sampled requests are likely to be served by an overview
+    const int nBands = IGetRasterCount();
+    GDALRasterBand* poFirstBand = IGetRasterBand(1);
+    if( (nBufXSize < nXSize || nBufYSize < nYSize) &&
+        poFirstBand->GetOverviewCount() > 0 )
+    {
+        return;
+    }
+
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    poFirstBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+    const int nBlockXStart = nXOff / nBlockXSize;
+    const int nBlockXEnd = (nXOff + nXSize - 1) / nBlockXSize;
+    const int nBlockYStart = nYOff / nBlockYSize;
+    const int nBlockYEnd = (nYOff + nYSize - 1) / nBlockYSize;
+    const size_t nBandBlockSize =
+        static_cast<size_t>(nBlockXSize) * nBlockYSize * m_nDTSize;
+    const int nTileBands = m_eDT == GDT_Byte ? 4 : 1;
+
+    // Collect blocks none of whose bands is in the block cache, without
+    // exceeding half of the cache.
+    const GIntBig nMaxBlocks = std::max(static_cast<GIntBig>(1),
+        GDALGetCacheMax64() / 2 / static_cast<GIntBig>(nBands * nBandBlockSize));
+    std::vector<std::pair<int, int>> anMissingBlocks;
+    for( int nBlockYOff = nBlockYStart; nBlockYOff <= nBlockYEnd; nBlockYOff++ )
+    {
+        for( int nBlockXOff = nBlockXStart; nBlockXOff <= nBlockXEnd &&
+                static_cast<GIntBig>(anMissingBlocks.size()) < nMaxBlocks;
+             nBlockXOff++ )
+        {
+            bool bCached = false;
+            for( int iBand = 1; iBand <= nBands && !bCached; iBand++ )
+            {
+                GDALRasterBlock* poBlock =
+                    static_cast<GDALGPKGMBTilesLikeRasterBand*>(
+                        IGetRasterBand(iBand))->
+                            AccessibleTryGetLockedBlockRef(nBlockXOff,
+                                                           nBlockYOff);
+                if( poBlock )
+                {
+                    bCached = true;
+                    poBlock->DropLock();
+                }
+            }
+            if( !bCached )
+                anMissingBlocks.emplace_back(nBlockXOff, nBlockYOff);
+        }
+    }
+    if( anMissingBlocks.size() < 2 )
+        return;
+
+    // The tile being written and the ones being compressed may not be
+    // in the database yet.
+    if( IGetUpdate() && WriteTile() != CE_None )
+        return;
+    GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
+    poMainDS->FlushTileEncodeJobs(0);
+
+    // Must be established before the worker threads call ReadTile()
+    poFirstBand->GetColorTable();
+    poFirstBand->GetNoDataValue(nullptr);
+
+    std::map<std::pair<int, int>, size_t> oMapBlockToJob;
+    std::vector<GPKGTileDecodeJob> asJobs(anMissingBlocks.size());
+    for( size_t i = 0; i < anMissingBlocks.size(); i++ )
+    {
+        asJobs[i].poDS = this;
+        asJobs[i].nBlockXOff = anMissingBlocks[i].first;
+        asJobs[i].nBlockYOff = anMissingBlocks[i].second;
+        oMapBlockToJob[anMissingBlocks[i]] = i;
+    }
+
+    const int nTileRow1 =
+        GetRowFromIntoTopConvention(anMissingBlocks.front().second + m_nShiftYTiles);
+    const int nTileRow2 =
+        GetRowFromIntoTopConvention(anMissingBlocks.back().second + m_nShiftYTiles);
+    char *pszSQL = sqlite3_mprintf( "SELECT tile_row, tile_column, tile_data%s "
+        "FROM \"%w\" WHERE zoom_level = %d AND "
+        "tile_row BETWEEN %d AND %d AND tile_column BETWEEN %d AND %d%s",
+        m_eDT != GDT_Byte ? ", id" : "", // MBTiles do not have an id
+        m_osRasterTable.c_str(), m_nZoomLevel,
+        std::min(nTileRow1, nTileRow2), std::max(nTileRow1, nTileRow2),
+        nBlockXStart + m_nShiftXTiles, nBlockXEnd + m_nShiftXTiles,
+        !m_osWHERE.empty() ? CPLSPrintf(" AND (%s)", m_osWHERE.c_str()): "");
+#ifdef DEBUG_VERBOSE
+    CPLDebug("GPKG", "%s", pszSQL);
+#endif
+    sqlite3_stmt *hStmt = nullptr;
+    int rc = sqlite3_prepare_v2( IGetDB(), pszSQL, -1, &hStmt, nullptr );
+    sqlite3_free(pszSQL);
+    if ( rc != SQLITE_OK )
+        return;
+
+    std::vector<void*> apJobs;
+    while( sqlite3_step(hStmt) == SQLITE_ROW )
+    {
+        // GetRowFromIntoTopConvention() is its own inverse
+        const int nBlockYOff = GetRowFromIntoTopConvention(
+            sqlite3_column_int(hStmt, 0)) - m_nShiftYTiles;
+        const int nBlockXOff = sqlite3_column_int(hStmt, 1) - m_nShiftXTiles;
+        const auto oIter =
+            oMapBlockToJob.find(std::pair<int, int>(nBlockXOff, nBlockYOff));
+        if( oIter == oMapBlockToJob.end() ||
+            sqlite3_column_type(hStmt, 2) != SQLITE_BLOB )
+        {
+            continue;
+        }
+        GPKGTileDecodeJob& sJob = asJobs[oIter->second];
+        const GByte* pabyRawData = static_cast<const GByte*>(
+            sqlite3_column_blob(hStmt, 2));
+        sJob.abyBlob.assign(pabyRawData,
+                            pabyRawData + sqlite3_column_bytes(hStmt, 2));
+        if( m_eDT != GDT_Byte )
+        {
+            GetTileOffsetAndScale(sqlite3_column_int64(hStmt, 3),
+                                  sJob.dfTileOffset, sJob.dfTileScale);
+        }
+        sJob.abyTileData.resize(nTileBands * nBandBlockSize);
+        apJobs.push_back(&sJob);
+    }
+    sqlite3_finalize(hStmt);
+
+    if( apJobs.size() < 2 )
+        return;
+    poPool->SubmitJobs(GPKGDecodeTileJob, apJobs);
+    poPool->WaitCompletion();
+
+    for( void* pJob : apJobs )
+    {
+        const GPKGTileDecodeJob* psJob =
+            static_cast<const GPKGTileDecodeJob*>(pJob);
+        if( !psJob->bOK )
+            continue;
+        for( int iBand = 1; iBand <= nBands; iBand++ )
+        {
+            GDALRasterBlock* poBlock =
+                IGetRasterBand(iBand)->GetLockedBlockRef(
+                    psJob->nBlockXOff, psJob->nBlockYOff, TRUE);
+            if( poBlock == nullptr )
+                continue;
+            if( !poBlock->GetDirty() )
+            {
+                memcpy( poBlock->GetDataRef(),
+                        psJob->abyTileData.data() + (iBand - 1) * nBandBlockSize,
+                        nBandBlockSize );
+            }
+            poBlock->DropLock();
+        }
+    }
+}
+
 /************************************************************************/
 /*                       WEBPSupports4Bands()                           */
 /************************************************************************/
@@ -1275,6 +1550,10 @@ GIntBig GDALGPKGMBTilesLikePseudoDataset::GetTileId(int nRow, int nCol)
 
 bool GDALGPKGMBTilesLikePseudoDataset::DeleteTile(int nRow, int nCol)
 {
+    // A pending insertion of that tile must not be done after its deletion
+    GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
+    poMainDS->FlushTileEncodeJobs(0);
+
     char* pszSQL = sqlite3_mprintf("DELETE FROM \"%w\" "
         "WHERE zoom_level = %d AND tile_row = %d AND "
         "tile_column = %d",
@@ -1780,14 +2059,30 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
         else if( nBands == 1 && m_poCT == nullptr && !bTileDriverSupports1Band )
             nTileBands = 3;
 
+        // Byte tiles can be compressed by a worker thread, on a copy of the
+        // tile data. PNG8 tiles are not, since the computation of their
+        // palette uses a buffer shared by all tiles.
+        GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
+        std::unique_ptr<GPKGTileEncodeJob> poJob;
+        GByte* pabyTileData = m_pabyCachedTiles;
+        if( poMainDS->GetWorkerThreadPool() != nullptr &&
+            m_eDT == GDT_Byte &&
+            !(m_eTF == GPKG_TF_PNG8 && nTileBands == 1 && nBands >= 3) )
+        {
+            poJob.reset(new GPKGTileEncodeJob());
+            poJob->abyTileData.assign(m_pabyCachedTiles,
+                                      m_pabyCachedTiles + 4 * nBandBlockSize);
+            pabyTileData = poJob->abyTileData.data();
+        }
+
         if( bPartialTile && (nTileBands == 2 || nTileBands == 4) )
         {
             int nTargetAlphaBand = nTileBands;
-            memset(m_pabyCachedTiles + (nTargetAlphaBand-1) * nBandBlockSize, 0,
+            memset(pabyTileData + (nTargetAlphaBand-1) * nBandBlockSize, 0,
                    nBandBlockSize);
             for(GPtrDiff_t iY = iYOff; iY < iYOff + iYCount; iY ++)
             {
-                memset(m_pabyCachedTiles + (static_cast<size_t>(nTargetAlphaBand-1) * nBlockYSize + iY) * nBlockXSize + iXOff,
+                memset(pabyTileData + (static_cast<size_t>(nTargetAlphaBand-1) * nBlockYSize + iY) * nBlockXSize + iXOff,
                        255, iXCount);
             }
         }
@@ -2021,7 +2316,7 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
                 else if( nBands == 2 && nTileBands >= 3 )
                     iSrc = (i < 3) ? 0 : 1;
                 int nRet = CPLPrintPointer(szDataPointer,
-                        m_pabyCachedTiles + iSrc * nBlockXSize * nBlockYSize,
+                        pabyTileData + iSrc * nBlockXSize * nBlockYSize,
                         sizeof(szDataPointer));
                 szDataPointer[nRet] = '\0';
                 papszOptions = CSLSetNameValue(papszOptions,
@@ -2126,10 +2421,10 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
             }
             if( iYOff > 0 )
             {
-                memset(m_pabyCachedTiles + 0 * nBandBlockSize, 0, nBlockXSize * iYOff);
-                memset(m_pabyCachedTiles + 1 * nBandBlockSize, 0, nBlockXSize * iYOff);
-                memset(m_pabyCachedTiles + 2 * nBandBlockSize, 0, nBlockXSize * iYOff);
-                memset(m_pabyCachedTiles + 3 * nBandBlockSize, 0, nBlockXSize * iYOff);
+                memset(pabyTileData + 0 * nBandBlockSize, 0, nBlockXSize * iYOff);
+                memset(pabyTileData + 1 * nBandBlockSize, 0, nBlockXSize * iYOff);
+                memset(pabyTileData + 2 * nBandBlockSize, 0, nBlockXSize * iYOff);
+                memset(pabyTileData + 3 * nBandBlockSize, 0, nBlockXSize * iYOff);
             }
             GPtrDiff_t i = 0;  // TODO: Rename variable to make it clear what it is.
             for(GPtrDiff_t iY = iYOff; iY < iYOff + iYCount; iY ++)
@@ -2137,36 +2432,36 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
                 if( iXOff > 0 )
                 {
                     i = iY * nBlockXSize;
-                    memset(m_pabyCachedTiles + 0 * nBandBlockSize + i, 0, iXOff);
-                    memset(m_pabyCachedTiles + 1 * nBandBlockSize + i, 0, iXOff);
-                    memset(m_pabyCachedTiles + 2 * nBandBlockSize + i, 0, iXOff);
-                    memset(m_pabyCachedTiles + 3 * nBandBlockSize + i, 0, iXOff);
+                    memset(pabyTileData + 0 * nBandBlockSize + i, 0, iXOff);
+                    memset(pabyTileData + 1 * nBandBlockSize + i, 0, iXOff);
+                    memset(pabyTileData + 2 * nBandBlockSize + i, 0, iXOff);
+                    memset(pabyTileData + 3 * nBandBlockSize + i, 0, iXOff);
                 }
                 for(int iX = iXOff; iX < iXOff + iXCount; iX ++)
                 {
                     i = iY * nBlockXSize + iX;
-                    GByte byVal = m_pabyCachedTiles[i];
-                    m_pabyCachedTiles[i] = abyCT[4*byVal];
-                    m_pabyCachedTiles[i + 1 * nBandBlockSize] = abyCT[4*byVal+1];
-                    m_pabyCachedTiles[i + 2 * nBandBlockSize] = abyCT[4*byVal+2];
-                    m_pabyCachedTiles[i + 3 * nBandBlockSize] = abyCT[4*byVal+3];
+                    GByte byVal = pabyTileData[i];
+                    pabyTileData[i] = abyCT[4*byVal];
+                    pabyTileData[i + 1 * nBandBlockSize] = abyCT[4*byVal+1];
+                    pabyTileData[i + 2 * nBandBlockSize] = abyCT[4*byVal+2];
+                    pabyTileData[i + 3 * nBandBlockSize] = abyCT[4*byVal+3];
                 }
                 if( iXOff + iXCount < nBlockXSize )
                 {
                     i = iY * nBlockXSize + iXOff + iXCount;
-                    memset(m_pabyCachedTiles + 0 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
-                    memset(m_pabyCachedTiles + 1 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
-                    memset(m_pabyCachedTiles + 2 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
-                    memset(m_pabyCachedTiles + 3 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
+                    memset(pabyTileData + 0 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
+                    memset(pabyTileData + 1 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
+                    memset(pabyTileData + 2 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
+                    memset(pabyTileData + 3 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
                 }
             }
             if( iYOff + iYCount < nBlockYSize )
             {
                 i = (iYOff + iYCount) * nBlockXSize;
-                memset(m_pabyCachedTiles + 0 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
-                memset(m_pabyCachedTiles + 1 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
-                memset(m_pabyCachedTiles + 2 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
-                memset(m_pabyCachedTiles + 3 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
+                memset(pabyTileData + 0 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
+                memset(pabyTileData + 1 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
+                memset(pabyTileData + 2 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
+                memset(pabyTileData + 3 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
             }
         }
 
@@ -2193,6 +2488,20 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
                     CPLSPrintf("%d", nBlockYSize));
             }
         }
+
+        if( poJob )
+        {
+            poJob->poDS = this;
+            poJob->nRow = nRow;
+            poJob->nCol = nCol;
+            poJob->poDriver = l_poDriver;
+            poJob->poMEMDS.reset(poMEMDS);
+            poJob->aosCreationOptions.Assign(papszDriverOptions, TRUE);
+            poJob->osMemFileName.Printf("/vsimem/gpkg_write_tile_%p",
+                                        poJob.get());
+            return poMainDS->SubmitTileEncodeJob(std::move(poJob));
+        }
+
 #ifdef DEBUG
         VSIStatBufL sStat;
         CPLAssert(VSIStatL(osMemFileName, &sStat) != 0);
@@ -2209,57 +2518,13 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
             GByte* pabyBlob =
                 VSIGetMemFileBuffer(osMemFileName, &nBlobSize, TRUE);
 
-            /* Create or commit and recreate transaction */
-            GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
-            if( poMainDS->m_nTileInsertionCount == 0 )
+            eErr = WriteTileBlob(nRow, nCol, pabyBlob, nBlobSize);
+            if( poMainDS->m_nTileInsertionCount < 0 )
             {
-                poMainDS->IStartTransaction();
-            }
-            else if( poMainDS->m_nTileInsertionCount == 1000 )
-            {
-                if( poMainDS->ICommitTransaction() != OGRERR_NONE )
-                {
-                    poMainDS->m_nTileInsertionCount = -1;
-                    CPLFree(pabyBlob);
-                    VSIUnlink(osMemFileName);
-                    delete poMEMDS;
-                    return CE_Failure;
-                }
-                poMainDS->IStartTransaction();
-                poMainDS->m_nTileInsertionCount = 0;
-            }
-            poMainDS->m_nTileInsertionCount ++;
-
-            char* pszSQL = sqlite3_mprintf("INSERT OR REPLACE INTO \"%w\" "
-                "(zoom_level, tile_row, tile_column, tile_data) VALUES (%d, %d, %d, ?)",
-                m_osRasterTable.c_str(), m_nZoomLevel, GetRowFromIntoTopConvention(nRow), nCol);
-#ifdef DEBUG_VERBOSE
-            CPLDebug("GPKG", "%s", pszSQL);
-#endif
-            sqlite3_stmt* hStmt = nullptr;
-            int rc = sqlite3_prepare_v2(IGetDB(), pszSQL, -1, &hStmt, nullptr);
-            if ( rc != SQLITE_OK )
-            {
-                CPLError( CE_Failure, CPLE_AppDefined,
-                          "failed to prepare SQL %s: %s",
-                          pszSQL, sqlite3_errmsg(IGetDB()) );
-                CPLFree(pabyBlob);
-            }
-            else
-            {
-                sqlite3_bind_blob( hStmt, 1, pabyBlob, (int)nBlobSize, CPLFree);
-                rc = sqlite3_step( hStmt );
-                if( rc == SQLITE_DONE )
-                    eErr = CE_None;
-                else
-                {
-                    CPLError(CE_Failure, CPLE_AppDefined,
-                             "Failure when inserting tile (row=%d,col=%d) at zoom_level=%d : %s",
-                             GetRowFromIntoTopConvention(nRow), nCol, m_nZoomLevel, sqlite3_errmsg(IGetDB()));
-                }
+                VSIUnlink(osMemFileName);
+                delete poMEMDS;
+                return CE_Failure;
             }
-            sqlite3_finalize(hStmt);
-            sqlite3_free(pszSQL);
 
             if( m_eTF == GPKG_TF_PNG_16BIT ||
                 m_eTF == GPKG_TF_TIFF_32BIT_FLOAT )
@@ -2271,7 +2536,7 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
                 {
                     DeleteFromGriddedTileAncillary(nTileId);
 
-                    pszSQL = sqlite3_mprintf(
+                    char* pszSQL = sqlite3_mprintf(
                         "INSERT INTO gpkg_2d_gridded_tile_ancillary "
                         "(tpudt_name, tpudt_id, scale, offset, min, max, "
                         "mean, std_dev) VALUES "
@@ -2280,8 +2545,8 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
 #ifdef DEBUG_VERBOSE
                     CPLDebug("GPKG", "%s", pszSQL);
 #endif
-                    hStmt = nullptr;
-                    rc = sqlite3_prepare_v2(IGetDB(), pszSQL, -1, &hStmt, nullptr);
+                    sqlite3_stmt* hStmt = nullptr;
+                    int rc = sqlite3_prepare_v2(IGetDB(), pszSQL, -1, &hStmt, nullptr);
                     if ( rc != SQLITE_OK )
                     {
                         eErr = CE_Failure;
@@ -2327,6 +2592,199 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
     return eErr;
 }
 
+/************************************************************************/
+/*                           WriteTileBlob()                            */
+/************************************************************************/
+
+/* Insert the compressed tile data. Takes ownership of pabyBlob */
+CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileBlob(int nRow, int nCol,
+                                                       GByte* pabyBlob,
+                                                       vsi_l_offset nBlobSize)
+{
+    /* Create or commit and recreate transaction */
+    GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
+    if( poMainDS->m_nTileInsertionCount < 0 )
+    {
+        CPLFree(pabyBlob);
+        return CE_Failure;
+    }
+    if( poMainDS->m_nTileInsertionCount == 0 )
+    {
+        poMainDS->IStartTransaction();
+    }
+    else if( poMainDS->m_nTileInsertionCount == 1000 )
+    {
+        if( poMainDS->ICommitTransaction() != OGRERR_NONE )
+        {
+            poMainDS->m_nTileInsertionCount = -1;
+            CPLFree(pabyBlob);
+            return CE_Failure;
+        }
+        poMainDS->IStartTransaction();
+        poMainDS->m_nTileInsertionCount = 0;
+    }
+    poMainDS->m_nTileInsertionCount ++;
+
+    CPLErr eErr = CE_Failure;
+    char* pszSQL = sqlite3_mprintf("INSERT OR REPLACE INTO \"%w\" "
+        "(zoom_level, tile_row, tile_column, tile_data) VALUES (%d, %d, %d, ?)",
+        m_osRasterTable.c_str(), m_nZoomLevel, GetRowFromIntoTopConvention(nRow), nCol);
+#ifdef DEBUG_VERBOSE
+    CPLDebug("GPKG", "%s", pszSQL);
+#endif
+    sqlite3_stmt* hStmt = nullptr;
+    int rc = sqlite3_prepare_v2(IGetDB(), pszSQL, -1, &hStmt, nullptr);
+    if ( rc != SQLITE_OK )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "failed to prepare SQL %s: %s",
+                  pszSQL, sqlite3_errmsg(IGetDB()) );
+        CPLFree(pabyBlob);
+    }
+    else
+    {
+        sqlite3_bind_blob( hStmt, 1, pabyBlob, (int)nBlobSize, CPLFree);
+        rc = sqlite3_step( hStmt );
+        if( rc == SQLITE_DONE )
+            eErr = CE_None;
+        else
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Failure when inserting tile (row=%d,col=%d) at zoom_level=%d : %s",
+                     GetRowFromIntoTopConvention(nRow), nCol, m_nZoomLevel, sqlite3_errmsg(IGetDB()));
+        }
+    }
+    sqlite3_finalize(hStmt);
+    sqlite3_free(pszSQL);
+    return eErr;
+}
+
+/************************************************************************/
+/*                         GPKGEncodeTileJob()                          */
+/************************************************************************/
+
+static void GPKGEncodeTileJob(void* pData)
+{
+    GPKGTileEncodeJob* psJob = static_cast<GPKGTileEncodeJob*>(pData);
+    GDALDataset* poOutDS = psJob->poDriver->CreateCopy(
+        psJob->osMemFileName, psJob->poMEMDS.get(), FALSE,
+        psJob->aosCreationOptions.List(), nullptr, nullptr);
+    if( poOutDS )
+    {
+        GDALClose( poOutDS );
+        psJob->pabyBlob = VSIGetMemFileBuffer(psJob->osMemFileName,
+                                              &psJob->nBlobSize, TRUE);
+    }
+    VSIUnlink(psJob->osMemFileName);
+    psJob->bDone = true;
+}
+
+/************************************************************************/
+/*                        SubmitTileEncodeJob()                         */
+/************************************************************************/
+
+/* Should only be called on the main dataset */
+CPLErr GDALGPKGMBTilesLikePseudoDataset::SubmitTileEncodeJob(
+                                std::unique_ptr<GPKGTileEncodeJob>&& poJob)
+{
+    CPLAssert( m_poParentDS == nullptr );
+    GPKGTileEncodeJob* psJob = poJob.get();
+    m_apoTileEncodeJobs.emplace_back(std::move(poJob));
+    if( !m_poWorkerThreadPool->SubmitJob(GPKGEncodeTileJob, psJob) )
+        GPKGEncodeTileJob(psJob);
+
+    // Keep at most two jobs per thread in flight, so that the main thread
+    // inserts the oldest tiles while the workers compress the next ones.
+    return FlushTileEncodeJobs(
+        2 * static_cast<size_t>(m_poWorkerThreadPool->GetThreadCount()));
+}
+
+/************************************************************************/
+/*                        FlushTileEncodeJobs()                         */
+/************************************************************************/
+
+/* Should only be called on the main dataset */
+CPLErr GDALGPKGMBTilesLikePseudoDataset::FlushTileEncodeJobs(
+                                                size_t nMaxRemainingJobs)
+{
+    CPLErr eErr = CE_None;
+    // Tiles are inserted in the order they were submitted, so that a tile
+    // written several times ends up with its last content.
+    while( m_apoTileEncodeJobs.size() > nMaxRemainingJobs )
+    {
+        GPKGTileEncodeJob* psJob = m_apoTileEncodeJobs.front().get();
+        while( !psJob->bDone )
+            m_poWorkerThreadPool->WaitEvent();
+        if( psJob->pabyBlob == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Cannot compress tile (row=%d,col=%d) at zoom_level=%d",
+                     psJob->poDS->GetRowFromIntoTopConvention(psJob->nRow),
+                     psJob->nCol, psJob->poDS->m_nZoomLevel);
+            eErr = CE_Failure;
+        }
+        else
+        {
+            GByte* pabyBlob = psJob->pabyBlob;
+            psJob->pabyBlob = nullptr;
+            if( psJob->poDS->WriteTileBlob(psJob->nRow, psJob->nCol,
+                                           pabyBlob,
+                                           psJob->nBlobSize) != CE_None )
+            {
+                eErr = CE_Failure;
+            }
+        }
+        m_apoTileEncodeJobs.pop_front();
+    }
+    return eErr;
+}
+
+/************************************************************************/
+/*                        GetWorkerThreadPool()                         */
+/************************************************************************/
+
+CPLWorkerThreadPool* GDALGPKGMBTilesLikePseudoDataset::GetWorkerThreadPool()
+{
+    GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
+    return poMainDS->m_poWorkerThreadPool.get();
+}
+
+/************************************************************************/
+/*                       InitWorkerThreadPool()                         */
+/************************************************************************/
+
+/* Handles the NUM_THREADS open/creation option */
+void GDALGPKGMBTilesLikePseudoDataset::InitWorkerThreadPool(char** papszOptions)
+{
+    if( m_poParentDS != nullptr || m_poWorkerThreadPool != nullptr )
+        return;
+
+    const char* pszValue = CSLFetchNameValue( papszOptions, "NUM_THREADS" );
+    if( pszValue == nullptr )
+        pszValue = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    if( pszValue == nullptr )
+        return;
+
+    const int nThreads =
+        EQUAL(pszValue, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(pszValue);
+    if( nThreads > 1 )
+    {
+        CPLDebug("GPKG", "Using %d threads for tile compression/decompression",
+                 nThreads);
+        m_poWorkerThreadPool.reset(new CPLWorkerThreadPool());
+        if( !m_poWorkerThreadPool->Setup(nThreads, nullptr, nullptr) )
+            m_poWorkerThreadPool.reset();
+    }
+    else if( nThreads < 0 ||
+             (!EQUAL(pszValue, "0") &&
+              !EQUAL(pszValue, "1") &&
+              !EQUAL(pszValue, "ALL_CPUS")) )
+    {
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "Invalid value for NUM_THREADS: %s", pszValue);
+    }
+}
+
 /************************************************************************/
 /*                     FlushRemainingShiftedTiles()                     */
 /************************************************************************/
@@ -34,6 +34,12 @@
 #include "gdal_pam.h"
 #include "ogr_sqlite.h" // for sqlite3*
 
+#include <deque>
+#include <memory>
+
+class CPLWorkerThreadPool;
+struct GPKGTileEncodeJob;
+
 typedef struct
 {
     int     nRow;
@@ -104,9 +110,20 @@ class GDALGPKGMBTilesLikePseudoDataset
 
     GDALGPKGMBTilesLikePseudoDataset* m_poParentDS;
 
+    // Only set on the main dataset (i.e. m_poParentDS == nullptr)
+    std::unique_ptr<CPLWorkerThreadPool> m_poWorkerThreadPool;
+    std::deque<std::unique_ptr<GPKGTileEncodeJob>> m_apoTileEncodeJobs;
+
   private:
         bool                    m_bInWriteTile;
         CPLErr                  WriteTileInternal(); /* should only be called by WriteTile() */
+        CPLErr                  WriteTileBlob(int nRow, int nCol,
+                                              GByte* pabyBlob,
+                                              vsi_l_offset nBlobSize);
+        CPLErr                  SubmitTileEncodeJob(
+                                    std::unique_ptr<GPKGTileEncodeJob>&& poJob);
+        CPLErr                  FlushTileEncodeJobs(size_t nMaxRemainingJobs);
+        CPLWorkerThreadPool*    GetWorkerThreadPool();
         GIntBig                 GetTileId(int nRow, int nCol);
         bool                    DeleteTile(int nRow, int nCol);
         bool                    DeleteFromGriddedTileAncillary(GIntBig nTileId);
@@ -143,6 +160,12 @@ class GDALGPKGMBTilesLikePseudoDataset
                                                  int nDstXSize, int nDstYSize);
         CPLErr                  DoPartialFlushOfPartialTilesIfNecessary();
 
+        void                    InitWorkerThreadPool(char** papszOptions);
+        void                    DecodeTilesConcurrently(int nXOff, int nYOff,
+                                                        int nXSize, int nYSize,
+                                                        int nBufXSize,
+                                                        int nBufYSize);
+
         virtual CPLErr                  IFlushCacheWithErrCode() = 0;
         virtual int                     IGetRasterCount() = 0;
         virtual GDALRasterBand*         IGetRasterBand(int nBand) = 0;
@@ -173,6 +196,10 @@ class GDALGPKGMBTilesLikeRasterBand: public GDALPamRasterBand
         virtual CPLErr          IWriteBlock(int nBlockXOff, int nBlockYOff,
                                            void* pData) override;
         virtual CPLErr          FlushCache() override;
+        virtual CPLErr          IRasterIO( GDALRWFlag, int, int, int, int,
+                                           void *, int, int, GDALDataType,
+                                           GSpacing, GSpacing,
+                                           GDALRasterIOExtraArg* psExtraArg ) override;
 
         virtual GDALColorTable* GetColorTable() override;
         virtual CPLErr          SetColorTable(GDALColorTable* poCT) override;
@@ -253,6 +253,11 @@ class GDALGeoPackageDataset final : public OGRSQLiteBaseDataSource, public GDALG
         virtual void        FlushCache() override;
         virtual CPLErr      IBuildOverviews( const char *, int, int *,
                                              int, int *, GDALProgressFunc, void * ) override;
+        virtual CPLErr      IRasterIO( GDALRWFlag, int, int, int, int,
+                                       void *, int, int, GDALDataType,
+                                       int, int *,
+                                       GSpacing, GSpacing, GSpacing,
+                                       GDALRasterIOExtraArg* psExtraArg ) override;
 
         virtual int         GetLayerCount() override { return m_nLayers; }
         int                 Open( GDALOpenInfo* poOpenInfo );
@@ -373,6 +378,8 @@ class OGRGeoPackageLayer CPL_NON_FINAL: public OGRLayer, public IOGRSQLiteGetSpa
     int                 iGeomCol;
     int                *panFieldOrdinals;
 
+    bool                m_bUseLazyGeometries;
+
     void                ClearStatement();
     virtual OGRErr      ResetStatement() = 0;
 
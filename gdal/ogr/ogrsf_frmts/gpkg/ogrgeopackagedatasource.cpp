@@ -2203,6 +2203,7 @@ bool GDALGeoPackageDataset::OpenRaster( const char* pszTableName,
     }
 
     ParseCompressionOptions(papszOpenOptionsIn);
+    InitWorkerThreadPool(papszOpenOptionsIn);
 
     m_osWHERE = CSLFetchNameValueDef(papszOpenOptionsIn, "WHERE", "");
 
@@ -2636,6 +2637,31 @@ OGRErr GDALGeoPackageDataset::UpdateGpkgContentsLastChange(
     return eErr;
 }
 
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr GDALGeoPackageDataset::IRasterIO( GDALRWFlag eRWFlag,
+                                  int nXOff, int nYOff, int nXSize, int nYSize,
+                                  void * pData, int nBufXSize, int nBufYSize,
+                                  GDALDataType eBufType,
+                                  int nBandCount, int *panBandMap,
+                                  GSpacing nPixelSpace, GSpacing nLineSpace,
+                                  GSpacing nBandSpace,
+                                  GDALRasterIOExtraArg* psExtraArg )
+{
+    if( eRWFlag == GF_Read )
+    {
+        DecodeTilesConcurrently(nXOff, nYOff, nXSize, nYSize,
+                                nBufXSize, nBufYSize);
+    }
+    return OGRSQLiteBaseDataSource::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                  pData, nBufXSize, nBufYSize, eBufType,
+                                  nBandCount, panBandMap,
+                                  nPixelSpace, nLineSpace, nBandSpace,
+                                  psExtraArg);
+}
+
 /************************************************************************/
 /*                          IBuildOverviews()                           */
 /************************************************************************/
@@ -4310,6 +4336,7 @@ int GDALGeoPackageDataset::Create( const char * pszFilename,
             GDALPamDataset::SetMetadataItem("DESCRIPTION", m_osDescription);
 
         ParseCompressionOptions(papszOptions);
+        InitWorkerThreadPool(papszOptions);
 
         if( m_eTF == GPKG_TF_WEBP )
         {
@@ -47,7 +47,9 @@ OGRGeoPackageLayer::OGRGeoPackageLayer(GDALGeoPackageDataset *poDS) :
     m_pszFidColumn(nullptr),
     iFIDCol(-1),
     iGeomCol(-1),
-    panFieldOrdinals(nullptr)
+    panFieldOrdinals(nullptr),
+    m_bUseLazyGeometries(CPLTestBool(
+        CPLGetConfigOption("OGR_GPKG_LAZY_GEOMETRY", "YES")))
 {}
 
 /************************************************************************/
@@ -192,19 +194,44 @@ OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
             int iGpkgSize = sqlite3_column_bytes(hStmt, iGeomCol);
             // coverity[tainted_data_return]
             GByte *pabyGpkg = (GByte *)sqlite3_column_blob(hStmt, iGeomCol);
-            OGRGeometry *poGeom = GPkgGeometryToOGR(pabyGpkg, iGpkgSize, nullptr);
-            if ( poGeom == nullptr )
+            GPkgHeader oHeader;
+            if( m_bUseLazyGeometries &&
+                GPkgHeaderFromWKB(pabyGpkg, iGpkgSize, &oHeader) == OGRERR_NONE &&
+                !oHeader.bExtended &&
+                static_cast<size_t>(iGpkgSize) > oHeader.nHeaderLen )
             {
-                // Try also spatialite geometry blobs
-                if( OGRSQLiteLayer::ImportSpatiaLiteGeometry( pabyGpkg, iGpkgSize,
-                                                              &poGeom ) != OGRERR_NONE )
+                // Defer the instantiation of the geometry until it is
+                // actually requested: it might just be copied to another
+                // WKB-based layer, or only its envelope needed.
+                OGREnvelope sEnvelope;
+                if( oHeader.bExtentHasXY )
                 {
-                    CPLError( CE_Failure, CPLE_AppDefined, "Unable to read geometry");
+                    sEnvelope.MinX = oHeader.MinX;
+                    sEnvelope.MaxX = oHeader.MaxX;
+                    sEnvelope.MinY = oHeader.MinY;
+                    sEnvelope.MaxY = oHeader.MaxY;
                 }
+                poFeature->SetGeomFieldLazyWKB(0,
+                    pabyGpkg + oHeader.nHeaderLen,
+                    iGpkgSize - oHeader.nHeaderLen,
+                    oHeader.bExtentHasXY ? &sEnvelope : nullptr);
+            }
+            else
+            {
+                OGRGeometry *poGeom = GPkgGeometryToOGR(pabyGpkg, iGpkgSize, nullptr);
+                if ( poGeom == nullptr )
+                {
+                    // Try also spatialite geometry blobs
+                    if( OGRSQLiteLayer::ImportSpatiaLiteGeometry( pabyGpkg, iGpkgSize,
+                                                                  &poGeom ) != OGRERR_NONE )
+                    {
+                        CPLError( CE_Failure, CPLE_AppDefined, "Unable to read geometry");
+                    }
+                }
+                if( poGeom != nullptr )
+                    poGeom->assignSpatialReference(poSrs);
+                poFeature->SetGeometryDirectly( poGeom );
             }
-            if( poGeom != nullptr )
-                poGeom->assignSpatialReference(poSrs);
-            poFeature->SetGeometryDirectly( poGeom );
         }
     }
 
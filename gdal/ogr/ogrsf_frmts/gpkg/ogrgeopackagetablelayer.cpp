@@ -31,8 +31,16 @@
 #include "ogrgeopackageutility.h"
 #include "ogrsqliteutility.h"
 #include "cpl_time.h"
+#include "cpl_worker_thread_pool.h"
 #include "ogr_p.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
 CPL_CVSID("$Id$")
 
 static const char UNSUPPORTED_OP_READ_ONLY[] =
@@ -176,7 +184,28 @@ bool OGRGeoPackageTableLayer::IsGeomFieldSet( OGRFeature *poFeature )
 {
     return
         poFeature->GetDefnRef()->GetGeomFieldCount() &&
-        poFeature->GetGeomFieldRef(0);
+        (poFeature->GetGeomFieldLazyWKB(0, nullptr) != nullptr ||
+         poFeature->GetGeomFieldRef(0));
+}
+
+// GetFeatureGeometryType()
+//
+// Geometry type of the first geometry field of a feature, or wkbNone if
+// it is NULL, that does not instantiate a lazy WKB geometry.
+//
+static OGRwkbGeometryType GetFeatureGeometryType( OGRFeature *poFeature )
+{
+    size_t nWKBSize = 0;
+    const GByte* pabyWKB = poFeature->GetGeomFieldLazyWKB(0, &nWKBSize);
+    OGRwkbGeometryType eGeomType = wkbUnknown;
+    if( pabyWKB != nullptr && nWKBSize >= 5 &&
+        OGRReadWKBGeometryType(pabyWKB, wkbVariantIso,
+                               &eGeomType) == OGRERR_NONE )
+    {
+        return eGeomType;
+    }
+    OGRGeometry* poGeom = poFeature->GetGeomFieldRef(0);
+    return poGeom ? poGeom->getGeometryType() : wkbNone;
 }
 
 #define MY_CPLAssert CPLAssert
@@ -200,12 +229,21 @@ OGRErr OGRGeoPackageTableLayer::FeatureBindParameters( OGRFeature *poFeature,
     /* Bind data values to the statement, here bind the blob for geometry */
     if ( err == SQLITE_OK && poFeatureDefn->GetGeomFieldCount() )
     {
+        // Lazy geometry whose WKB can be copied as it is.
+        size_t szWkb = 0;
+        GByte* pabyWkb = GPkgGeometryFromLazyWKB(poFeature, 0, m_iSrs, &szWkb);
+        OGRGeometry* poGeom =
+            pabyWkb ? nullptr : poFeature->GetGeomFieldRef(0);
+        if ( pabyWkb )
+        {
+            err = sqlite3_bind_blob(poStmt, nColCount++, pabyWkb,
+                                    static_cast<int>(szWkb), CPLFree);
+            MY_CPLAssert( err == SQLITE_OK );
+        }
         // Non-NULL geometry.
-        OGRGeometry* poGeom = poFeature->GetGeomFieldRef(0);
-        if ( poGeom )
+        else if ( poGeom )
         {
-            size_t szWkb = 0;
-            GByte* pabyWkb = GPkgGeometryFromOGR(poGeom, m_iSrs, &szWkb);
+            pabyWkb = GPkgGeometryFromOGR(poGeom, m_iSrs, &szWkb);
             err = sqlite3_bind_blob(poStmt, nColCount++, pabyWkb,
                                     static_cast<int>(szWkb), CPLFree);
             MY_CPLAssert( err == SQLITE_OK );
@@ -1662,11 +1700,10 @@ void OGRGeoPackageTableLayer::CheckGeometryType( OGRFeature *poFeature )
     OGRwkbGeometryType eLayerGeomType = wkbFlatten(GetGeomType());
     if( eLayerGeomType != wkbNone && eLayerGeomType != wkbUnknown )
     {
-        OGRGeometry* poGeom = poFeature->GetGeometryRef();
-        if( poGeom != nullptr )
+        OGRwkbGeometryType eGeomType =
+            wkbFlatten(GetFeatureGeometryType(poFeature));
+        if( eGeomType != wkbNone )
         {
-            OGRwkbGeometryType eGeomType =
-                wkbFlatten(poGeom->getGeometryType());
             if( !OGR_GT_IsSubClassOf(eGeomType, eLayerGeomType) &&
                 m_eSetBadGeomTypeWarned.find(eGeomType) ==
                                         m_eSetBadGeomTypeWarned.end() )
@@ -1694,11 +1731,10 @@ void OGRGeoPackageTableLayer::CheckGeometryType( OGRFeature *poFeature )
     // with Z and M components
     if( GetGeomType() == wkbUnknown && (m_nZFlag == 0 || m_nMFlag == 0) )
     {
-        OGRGeometry* poGeom = poFeature->GetGeometryRef();
-        if( poGeom != nullptr )
+        const OGRwkbGeometryType eGeomType = GetFeatureGeometryType(poFeature);
+        if( eGeomType != wkbNone )
         {
             bool bUpdateGpkgGeometryColumnsTable = false;
-            OGRwkbGeometryType eGeomType = poGeom->getGeometryType();
             if( m_nZFlag == 0 && wkbHasZ(eGeomType) )
             {
                 m_nZFlag = 2;
@@ -1855,15 +1891,10 @@ OGRErr OGRGeoPackageTableLayer::ICreateFeature( OGRFeature *poFeature )
     }
 
     /* Update the layer extents with this new object */
-    if( IsGeomFieldSet(poFeature) )
+    OGREnvelope oEnv;
+    if( poFeature->GetGeomFieldEnvelope(0, &oEnv) == OGRERR_NONE )
     {
-        OGRGeometry* poGeom = poFeature->GetGeomFieldRef(0);
-        if( !poGeom->IsEmpty() )
-        {
-            OGREnvelope oEnv;
-            poGeom->getEnvelope(&oEnv);
-            UpdateExtent(&oEnv);
-        }
+        UpdateExtent(&oEnv);
     }
 
     /* Read the latest FID value */
@@ -2025,15 +2056,10 @@ OGRErr OGRGeoPackageTableLayer::ISetFeature( OGRFeature *poFeature )
     if (eErr == OGRERR_NONE)
     {
         /* Update the layer extents with this new object */
-        if( IsGeomFieldSet(poFeature) )
+        OGREnvelope oEnv;
+        if( poFeature->GetGeomFieldEnvelope(0, &oEnv) == OGRERR_NONE )
         {
-            OGRGeometry* poGeom = poFeature->GetGeomFieldRef(0);
-            if( !poGeom->IsEmpty() )
-            {
-                OGREnvelope oEnv;
-                poGeom->getEnvelope(&oEnv);
-                UpdateExtent(&oEnv);
-            }
+            UpdateExtent(&oEnv);
         }
 
         m_bContentChanged = true;
@@ -2712,7 +2738,7 @@ void OGRGeoPackageTableLayer::CreateSpatialIndexIfNecessary()
 }
 
 /************************************************************************/
-/*                       CreateSpatialIndex()                           */
+/*                           GPKGRTreeEntry                             */
 /************************************************************************/
 
 typedef struct
@@ -2724,6 +2750,489 @@ typedef struct
     double  dfMaxY;
 } GPKGRTreeEntry;
 
+// Geometry whose envelope is not in the GeoPackage header, and must be
+// computed from the WKB
+typedef struct
+{
+    size_t  nEntryIdx;
+    size_t  nOffset;
+    size_t  nLen;
+    size_t  nHeaderLen;
+} GPKGRTreePendingGeometry;
+
+/************************************************************************/
+/*                    GPKGComputeEnvelopeFromWKB()                      */
+/************************************************************************/
+
+// Returns false for empty or invalid geometries.
+static bool GPKGComputeEnvelopeFromWKB( const GByte* pabyBlob, size_t nBlobLen,
+                                        size_t nHeaderLen,
+                                        GPKGRTreeEntry& sEntry )
+{
+    // Fast path for points, that are written without envelope in the header.
+    const GByte* pabyWKB = pabyBlob + nHeaderLen;
+    const size_t nWKBLen = nBlobLen - nHeaderLen;
+    OGRwkbGeometryType eGeomType = wkbUnknown;
+    if( nWKBLen >= 21 &&
+        OGRReadWKBGeometryType(pabyWKB, wkbVariantIso, &eGeomType)
+                                                            == OGRERR_NONE &&
+        wkbFlatten(eGeomType) == wkbPoint )
+    {
+        double dfX = 0.0;
+        double dfY = 0.0;
+        memcpy(&dfX, pabyWKB + 5, sizeof(double));
+        memcpy(&dfY, pabyWKB + 5 + sizeof(double), sizeof(double));
+        if( OGR_SWAP(static_cast<OGRwkbByteOrder>(pabyWKB[0])) )
+        {
+            CPL_SWAPDOUBLE(&dfX);
+            CPL_SWAPDOUBLE(&dfY);
+        }
+        if( CPLIsNan(dfX) || CPLIsNan(dfY) )
+            return false;
+        sEntry.dfMinX = dfX;
+        sEntry.dfMaxX = dfX;
+        sEntry.dfMinY = dfY;
+        sEntry.dfMaxY = dfY;
+        return true;
+    }
+
+    OGRGeometry *poGeom = GPkgGeometryToOGR(pabyBlob, nBlobLen, nullptr);
+    if( poGeom == nullptr || poGeom->IsEmpty() )
+    {
+        delete poGeom;
+        return false;
+    }
+    OGREnvelope sEnvelope;
+    poGeom->getEnvelope(&sEnvelope);
+    delete poGeom;
+    sEntry.dfMinX = sEnvelope.MinX;
+    sEntry.dfMaxX = sEnvelope.MaxX;
+    sEntry.dfMinY = sEnvelope.MinY;
+    sEntry.dfMaxY = sEnvelope.MaxY;
+    return true;
+}
+
+/************************************************************************/
+/*                   GPKGComputePendingEnvelopes()                      */
+/************************************************************************/
+
+namespace {
+struct GPKGComputeEnvelopesJob
+{
+    std::vector<GPKGRTreeEntry>* paoEntries = nullptr;
+    const GByte* pabyData = nullptr;
+    const GPKGRTreePendingGeometry* pasPending = nullptr;
+    size_t nCount = 0;
+};
+} // namespace
+
+static void GPKGComputeEnvelopesJobFunc( void* pData )
+{
+    GPKGComputeEnvelopesJob* psJob = static_cast<GPKGComputeEnvelopesJob*>(pData);
+    for( size_t i = 0; i < psJob->nCount; i++ )
+    {
+        const GPKGRTreePendingGeometry& sPending = psJob->pasPending[i];
+        GPKGRTreeEntry& sEntry = (*psJob->paoEntries)[sPending.nEntryIdx];
+        if( !GPKGComputeEnvelopeFromWKB(psJob->pabyData + sPending.nOffset,
+                                        sPending.nLen, sPending.nHeaderLen,
+                                        sEntry) )
+        {
+            // Marker for entries to be discarded
+            sEntry.dfMinX = std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+}
+
+// Compute the envelopes of the pending geometries, using the thread pool if
+// available, and remove the empty ones from the entries.
+static void GPKGComputePendingEnvelopes(
+                        std::vector<GPKGRTreeEntry>& aoEntries,
+                        std::vector<GByte>& abyPendingData,
+                        std::vector<GPKGRTreePendingGeometry>& asPending,
+                        CPLWorkerThreadPool* poPool )
+{
+    if( asPending.empty() )
+        return;
+
+    const size_t nThreads = poPool ? poPool->GetThreadCount() : 1;
+    const size_t nPerJob = (asPending.size() + nThreads - 1) / nThreads;
+    std::vector<GPKGComputeEnvelopesJob> asJobs;
+    for( size_t i = 0; i < asPending.size(); i += nPerJob )
+    {
+        GPKGComputeEnvelopesJob sJob;
+        sJob.paoEntries = &aoEntries;
+        sJob.pabyData = abyPendingData.data();
+        sJob.pasPending = asPending.data() + i;
+        sJob.nCount = std::min(nPerJob, asPending.size() - i);
+        asJobs.push_back(sJob);
+    }
+    if( asJobs.size() == 1 )
+    {
+        GPKGComputeEnvelopesJobFunc(&asJobs[0]);
+    }
+    else
+    {
+        for( auto& sJob: asJobs )
+            poPool->SubmitJob(GPKGComputeEnvelopesJobFunc, &sJob);
+        poPool->WaitCompletion();
+    }
+
+    aoEntries.erase(
+        std::remove_if(aoEntries.begin(), aoEntries.end(),
+            [](const GPKGRTreeEntry& sEntry)
+            { return CPLIsNan(sEntry.dfMinX); }),
+        aoEntries.end());
+    abyPendingData.clear();
+    asPending.clear();
+}
+
+/************************************************************************/
+/*                       GPKGCanBulkLoadRTree()                         */
+/************************************************************************/
+
+// Whether the shadow tables of the RTree can be written directly.
+static bool GPKGCanBulkLoadRTree( sqlite3* hDB )
+{
+    if( !CPLTestBool(CPLGetConfigOption("OGR_GPKG_RTREE_BULK_LOAD", "YES")) )
+        return false;
+#ifdef SQLITE_DBCONFIG_DEFENSIVE
+    // In defensive mode, shadow tables are read-only.
+    int bDefensive = FALSE;
+    if( sqlite3_db_config(hDB, SQLITE_DBCONFIG_DEFENSIVE, -1,
+                          &bDefensive) == SQLITE_OK && bDefensive )
+    {
+        CPLDebug("GPKG", "Defensive mode enabled: cannot bulk load RTree");
+        return false;
+    }
+#else
+    CPL_IGNORE_RET_VAL(hDB);
+#endif
+    return true;
+}
+
+/************************************************************************/
+/*                         GPKGBulkLoadRTree()                          */
+/************************************************************************/
+
+namespace {
+// Cell of a node of the SQLite RTree: rowid (leaves) or child node number,
+// and bounding box stored as single precision floats.
+struct GPKGRTreeCell
+{
+    GIntBig nId;
+    float   fMinX;
+    float   fMaxX;
+    float   fMinY;
+    float   fMaxY;
+};
+
+struct GPKGSortSliceJob
+{
+    GPKGRTreeCell* pasStart = nullptr;
+    GPKGRTreeCell* pasEnd = nullptr;
+};
+} // namespace
+
+// Same rounding as done by the SQLite RTree, so that the float box contains
+// the double precision one.
+static float GPKGRTreeValueDown( double dfVal )
+{
+    if( dfVal < -std::numeric_limits<float>::max() )
+        return -std::numeric_limits<float>::infinity();
+    if( dfVal > std::numeric_limits<float>::max() )
+        return std::numeric_limits<float>::max();
+    float fVal = static_cast<float>(dfVal);
+    if( fVal > dfVal )
+        fVal = std::nextafter(fVal, -std::numeric_limits<float>::infinity());
+    return fVal;
+}
+
+static float GPKGRTreeValueUp( double dfVal )
+{
+    if( dfVal < -std::numeric_limits<float>::max() )
+        return -std::numeric_limits<float>::max();
+    if( dfVal > std::numeric_limits<float>::max() )
+        return std::numeric_limits<float>::infinity();
+    float fVal = static_cast<float>(dfVal);
+    if( fVal < dfVal )
+        fVal = std::nextafter(fVal, std::numeric_limits<float>::infinity());
+    return fVal;
+}
+
+static void GPKGSortSliceJobFunc( void* pData )
+{
+    GPKGSortSliceJob* psJob = static_cast<GPKGSortSliceJob*>(pData);
+    std::sort(psJob->pasStart, psJob->pasEnd,
+              [](const GPKGRTreeCell& a, const GPKGRTreeCell& b)
+              { return static_cast<double>(a.fMinY) + a.fMaxY <
+                       static_cast<double>(b.fMinY) + b.fMaxY; });
+}
+
+// Sort-Tile-Recursive ordering: sort by X the cells, split them in vertical
+// slices of sqrt(number of nodes) nodes, and sort each slice by Y.
+static void GPKGSortSTR( std::vector<GPKGRTreeCell>& asCells,
+                         size_t nMaxCells, CPLWorkerThreadPool* poPool )
+{
+    const size_t nNodes = (asCells.size() + nMaxCells - 1) / nMaxCells;
+    if( nNodes <= 1 )
+        return;
+    const size_t nSlices = static_cast<size_t>(
+                    std::ceil(std::sqrt(static_cast<double>(nNodes))));
+    const size_t nSliceSize = nSlices * nMaxCells;
+
+    std::sort(asCells.begin(), asCells.end(),
+              [](const GPKGRTreeCell& a, const GPKGRTreeCell& b)
+              { return static_cast<double>(a.fMinX) + a.fMaxX <
+                       static_cast<double>(b.fMinX) + b.fMaxX; });
+
+    std::vector<GPKGSortSliceJob> asJobs;
+    for( size_t i = 0; i < asCells.size(); i += nSliceSize )
+    {
+        GPKGSortSliceJob sJob;
+        sJob.pasStart = asCells.data() + i;
+        sJob.pasEnd = asCells.data() + std::min(i + nSliceSize, asCells.size());
+        asJobs.push_back(sJob);
+    }
+    if( poPool == nullptr || asJobs.size() == 1 )
+    {
+        for( auto& sJob: asJobs )
+            GPKGSortSliceJobFunc(&sJob);
+    }
+    else
+    {
+        for( auto& sJob: asJobs )
+            poPool->SubmitJob(GPKGSortSliceJobFunc, &sJob);
+        poPool->WaitCompletion();
+    }
+}
+
+// Write a fully packed RTree from the entries, directly into the _node,
+// _parent and _rowid shadow tables of the SQLite RTree virtual table,
+// instead of inserting entries one at a time.
+static bool GPKGBulkLoadRTree( sqlite3* hDB, const char* pszRTreeName,
+                               const std::vector<GPKGRTreeEntry>& aoEntries,
+                               CPLWorkerThreadPool* poPool )
+{
+    std::vector<GPKGRTreeCell> asCells;
+    asCells.reserve(aoEntries.size());
+    for( const auto& sEntry: aoEntries )
+    {
+        if( CPLIsNan(sEntry.dfMinX) || CPLIsNan(sEntry.dfMinY) ||
+            CPLIsNan(sEntry.dfMaxX) || CPLIsNan(sEntry.dfMaxY) ||
+            sEntry.dfMinX > sEntry.dfMaxX || sEntry.dfMinY > sEntry.dfMaxY )
+        {
+            CPLDebug("GPKG", "Invalid bounding box for feature " CPL_FRMT_GIB
+                     ". Not inserted in RTree", sEntry.nId);
+            continue;
+        }
+        GPKGRTreeCell sCell;
+        sCell.nId = sEntry.nId;
+        sCell.fMinX = GPKGRTreeValueDown(sEntry.dfMinX);
+        sCell.fMaxX = GPKGRTreeValueUp(sEntry.dfMaxX);
+        sCell.fMinY = GPKGRTreeValueDown(sEntry.dfMinY);
+        sCell.fMaxY = GPKGRTreeValueUp(sEntry.dfMaxY);
+        asCells.push_back(sCell);
+    }
+    if( asCells.empty() )
+        return true;
+
+    // The node size depends on the page size, and has been set when the
+    // RTree was created.
+    OGRErr eErr = OGRERR_NONE;
+    char* pszSQL = sqlite3_mprintf(
+        "SELECT length(data) FROM \"%w_node\" WHERE nodeno = 1", pszRTreeName);
+    const int nNodeSize = SQLGetInteger(hDB, pszSQL, &eErr);
+    sqlite3_free(pszSQL);
+    constexpr int CELL_SIZE = 8 + 4 * static_cast<int>(sizeof(float));
+    if( eErr != OGRERR_NONE || nNodeSize < 4 + 2 * CELL_SIZE )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Cannot determine node size of %s", pszRTreeName);
+        return false;
+    }
+    const size_t nMaxCells = static_cast<size_t>((nNodeSize - 4) / CELL_SIZE);
+
+    // Start from an empty tree, in case the RTree was emptied but not
+    // recreated.
+    pszSQL = sqlite3_mprintf(
+        "DELETE FROM \"%w_rowid\"; DELETE FROM \"%w_parent\"; "
+        "DELETE FROM \"%w_node\" WHERE nodeno <> 1",
+        pszRTreeName, pszRTreeName, pszRTreeName);
+    eErr = SQLCommand(hDB, pszSQL);
+    sqlite3_free(pszSQL);
+    if( eErr != OGRERR_NONE )
+        return false;
+
+    const char* const apszStmts[] = {
+        "INSERT OR REPLACE INTO \"%w_node\" (nodeno, data) VALUES (?, ?)",
+        "INSERT INTO \"%w_parent\" (nodeno, parentnode) VALUES (?, ?)",
+        "INSERT INTO \"%w_rowid\" (rowid, nodeno) VALUES (?, ?)" };
+    sqlite3_stmt* ahStmt[3] = { nullptr, nullptr, nullptr };
+    const auto FinalizeStatements = [&ahStmt]()
+    {
+        for( auto& hStmt: ahStmt )
+        {
+            sqlite3_finalize(hStmt);
+            hStmt = nullptr;
+        }
+    };
+    for( int i = 0; i < 3; i++ )
+    {
+        pszSQL = sqlite3_mprintf(apszStmts[i], pszRTreeName);
+        if( sqlite3_prepare_v2(hDB, pszSQL, -1, &ahStmt[i], nullptr)
+                                                            != SQLITE_OK )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "failed to prepare SQL: %s", pszSQL);
+            sqlite3_free(pszSQL);
+            FinalizeStatements();
+            return false;
+        }
+        sqlite3_free(pszSQL);
+    }
+    sqlite3_stmt* hNodeStmt = ahStmt[0];
+    sqlite3_stmt* hParentStmt = ahStmt[1];
+    sqlite3_stmt* hRowIdStmt = ahStmt[2];
+    const auto InsertPair = [hDB](sqlite3_stmt* hStmt,
+                                  GIntBig nVal1, GIntBig nVal2)
+    {
+        sqlite3_reset(hStmt);
+        sqlite3_bind_int64(hStmt, 1, nVal1);
+        sqlite3_bind_int64(hStmt, 2, nVal2);
+        if( sqlite3_step(hStmt) != SQLITE_DONE )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "failed to execute insertion in RTree : %s",
+                      sqlite3_errmsg(hDB) );
+            return false;
+        }
+        return true;
+    };
+
+    // Number of nodes of each level, from the leaves to the root.
+    std::vector<size_t> anLevelNodes;
+    size_t nItems = asCells.size();
+    do
+    {
+        nItems = (nItems + nMaxCells - 1) / nMaxCells;
+        anLevelNodes.push_back(nItems);
+    } while( nItems > 1 );
+    const int nDepth = static_cast<int>(anLevelNodes.size()) - 1;
+
+    // The root is node 1, followed by the nodes of the other levels, from
+    // the top one to the leaves.
+    std::vector<GIntBig> anFirstNodeNo(anLevelNodes.size());
+    anFirstNodeNo[nDepth] = 1;
+    GIntBig nNextNodeNo = 2;
+    for( int iLevel = nDepth - 1; iLevel >= 0; iLevel-- )
+    {
+        anFirstNodeNo[iLevel] = nNextNodeNo;
+        nNextNodeNo += static_cast<GIntBig>(anLevelNodes[iLevel]);
+    }
+
+    std::vector<std::pair<GIntBig, GIntBig>> aoRowIdToNodeNo;
+    aoRowIdToNodeNo.reserve(asCells.size());
+    std::vector<GByte> abyNode(nNodeSize);
+    for( int iLevel = 0; iLevel <= nDepth; iLevel++ )
+    {
+        GPKGSortSTR(asCells, nMaxCells, poPool);
+
+        std::vector<GPKGRTreeCell> asParentCells;
+        asParentCells.reserve(anLevelNodes[iLevel]);
+        for( size_t iNode = 0; iNode < anLevelNodes[iLevel]; iNode++ )
+        {
+            const GIntBig nNodeNo =
+                anFirstNodeNo[iLevel] + static_cast<GIntBig>(iNode);
+            const size_t nStart = iNode * nMaxCells;
+            const size_t nEnd = std::min(nStart + nMaxCells, asCells.size());
+
+            // Node header: depth of the tree (root node only), and number
+            // of cells. Integers and floats are big-endian.
+            std::fill(abyNode.begin(), abyNode.end(), static_cast<GByte>(0));
+            GUInt16 nVal16 = static_cast<GUInt16>(iLevel == nDepth ? nDepth : 0);
+            CPL_MSBPTR16(&nVal16);
+            memcpy(&abyNode[0], &nVal16, 2);
+            nVal16 = static_cast<GUInt16>(nEnd - nStart);
+            CPL_MSBPTR16(&nVal16);
+            memcpy(&abyNode[2], &nVal16, 2);
+
+            GPKGRTreeCell sParentCell;
+            sParentCell.nId = nNodeNo;
+            sParentCell.fMinX = std::numeric_limits<float>::infinity();
+            sParentCell.fMinY = std::numeric_limits<float>::infinity();
+            sParentCell.fMaxX = -std::numeric_limits<float>::infinity();
+            sParentCell.fMaxY = -std::numeric_limits<float>::infinity();
+            GByte* pabyCell = &abyNode[4];
+            for( size_t i = nStart; i < nEnd; i++ )
+            {
+                const GPKGRTreeCell& sCell = asCells[i];
+                GIntBig nId = sCell.nId;
+                CPL_MSBPTR64(&nId);
+                memcpy(pabyCell, &nId, 8);
+                const float afCoords[] = { sCell.fMinX, sCell.fMaxX,
+                                           sCell.fMinY, sCell.fMaxY };
+                for( int j = 0; j < 4; j++ )
+                {
+                    GUInt32 nVal32;
+                    memcpy(&nVal32, &afCoords[j], 4);
+                    CPL_MSBPTR32(&nVal32);
+                    memcpy(pabyCell + 8 + 4 * j, &nVal32, 4);
+                }
+                pabyCell += CELL_SIZE;
+
+                sParentCell.fMinX = std::min(sParentCell.fMinX, sCell.fMinX);
+                sParentCell.fMaxX = std::max(sParentCell.fMaxX, sCell.fMaxX);
+                sParentCell.fMinY = std::min(sParentCell.fMinY, sCell.fMinY);
+                sParentCell.fMaxY = std::max(sParentCell.fMaxY, sCell.fMaxY);
+
+                if( iLevel == 0 )
+                {
+                    aoRowIdToNodeNo.emplace_back(sCell.nId, nNodeNo);
+                }
+                else if( !InsertPair(hParentStmt, sCell.nId, nNodeNo) )
+                {
+                    FinalizeStatements();
+                    return false;
+                }
+            }
+
+            sqlite3_reset(hNodeStmt);
+            sqlite3_bind_int64(hNodeStmt, 1, nNodeNo);
+            sqlite3_bind_blob(hNodeStmt, 2, abyNode.data(), nNodeSize,
+                              SQLITE_STATIC);
+            if( sqlite3_step(hNodeStmt) != SQLITE_DONE )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "failed to execute insertion in RTree : %s",
+                          sqlite3_errmsg(hDB) );
+                FinalizeStatements();
+                return false;
+            }
+
+            asParentCells.push_back(sParentCell);
+        }
+        asCells = std::move(asParentCells);
+    }
+
+    // Insert in rowid order, which is the fastest for SQLite.
+    std::sort(aoRowIdToNodeNo.begin(), aoRowIdToNodeNo.end());
+    for( const auto& oPair: aoRowIdToNodeNo )
+    {
+        if( !InsertPair(hRowIdStmt, oPair.first, oPair.second) )
+        {
+            FinalizeStatements();
+            return false;
+        }
+    }
+
+    FinalizeStatements();
+    return true;
+}
+
+/************************************************************************/
+/*                       CreateSpatialIndex()                           */
+/************************************************************************/
+
 bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
 {
     OGRErr err;
@@ -2802,10 +3311,8 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
     }
 #else
     pszSQL = sqlite3_mprintf(
-        "SELECT \"%w\", ST_MinX(\"%w\"), ST_MaxX(\"%w\"), "
-        "ST_MinY(\"%w\"), ST_MaxY(\"%w\") FROM \"%w\" "
-        "WHERE \"%w\" NOT NULL AND NOT ST_IsEmpty(\"%w\")",
-            pszI, pszC, pszC, pszC, pszC, pszT, pszC, pszC );
+        "SELECT \"%w\", \"%w\" FROM \"%w\" WHERE \"%w\" NOT NULL",
+            pszI, pszC, pszT, pszC );
     sqlite3_stmt* hIterStmt = nullptr;
     if ( sqlite3_prepare_v2(m_poDS->GetDB(), pszSQL, -1, &hIterStmt, nullptr)
                                                             != SQLITE_OK )
@@ -2834,10 +3341,45 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
     }
     sqlite3_free(pszSQL);
 
-    // Insert entries in RTree by chunks of 100000
+    // Geometries without envelope in their header (typically points) are
+    // parsed by batches, in parallel if the NUM_THREADS open option or the
+    // GDAL_NUM_THREADS configuration option is set.
+    const char* pszNumThreads =
+        CSLFetchNameValue(m_poDS->GetOpenOptions(), "NUM_THREADS");
+    if( pszNumThreads == nullptr )
+        pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    const int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+        CPLGetNumCPUs() : std::max(1, std::min(128, atoi(pszNumThreads)));
+    std::unique_ptr<CPLWorkerThreadPool> poPool;
+    if( nThreads > 1 )
+    {
+        poPool.reset(new CPLWorkerThreadPool());
+        if( !poPool->Setup(nThreads, nullptr, nullptr) )
+            poPool.reset();
+    }
+    std::vector<GByte> abyPendingData;
+    std::vector<GPKGRTreePendingGeometry> asPending;
+
+    // The first entries, up to a memory limit, are bulk loaded in the
+    // RTree. Remaining entries, if any, are inserted by chunks of 100000.
+    const size_t nChunkSize = 100000;
+    bool bBulkLoad = GPKGCanBulkLoadRTree(m_poDS->GetDB());
+    size_t nMaxBulkLoadEntries = 0;
+    if( bBulkLoad )
+    {
+        GIntBig nMaxMemory = CPLGetUsablePhysicalRAM() / 4;
+        if( nMaxMemory <= 0 )
+            nMaxMemory = 1024 * 1024 * 1024;
+        // Entry, RTree cell, and rowid to node number pair.
+        const size_t nBytesPerEntry = sizeof(GPKGRTreeEntry) + 24 + 16;
+        nMaxBulkLoadEntries = static_cast<size_t>(std::min(
+            static_cast<GIntBig>(std::numeric_limits<size_t>::max()),
+            std::max(static_cast<GIntBig>(nChunkSize),
+                     nMaxMemory / static_cast<GIntBig>(nBytesPerEntry))));
+    }
+
     std::vector<GPKGRTreeEntry> aoEntries;
     GUIntBig nEntryCount = 0;
-    const size_t nChunkSize = 100000;
     while( true )
     {
         int sqlite_err = sqlite3_step(hIterStmt);
@@ -2846,11 +3388,56 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
         {
             GPKGRTreeEntry sEntry;
             sEntry.nId = sqlite3_column_int64(hIterStmt, 0);
-            sEntry.dfMinX = sqlite3_column_double(hIterStmt, 1);
-            sEntry.dfMaxX = sqlite3_column_double(hIterStmt, 2);
-            sEntry.dfMinY = sqlite3_column_double(hIterStmt, 3);
-            sEntry.dfMaxY = sqlite3_column_double(hIterStmt, 4);
-            aoEntries.push_back(sEntry);
+            const GByte* pabyBLOB = static_cast<const GByte*>(
+                                        sqlite3_column_blob(hIterStmt, 1));
+            const int nBLOBLen = sqlite3_column_bytes(hIterStmt, 1);
+            GPkgHeader sHeader;
+            if( sqlite3_column_type(hIterStmt, 1) != SQLITE_BLOB )
+            {
+                // Ignored
+            }
+            else if( nBLOBLen >= 8 &&
+                     GPkgHeaderFromWKB(pabyBLOB, nBLOBLen, &sHeader)
+                                                            == OGRERR_NONE )
+            {
+                if( sHeader.bEmpty )
+                {
+                    // Ignored
+                }
+                else if( sHeader.bExtentHasXY )
+                {
+                    sEntry.dfMinX = sHeader.MinX;
+                    sEntry.dfMaxX = sHeader.MaxX;
+                    sEntry.dfMinY = sHeader.MinY;
+                    sEntry.dfMaxY = sHeader.MaxY;
+                    aoEntries.push_back(sEntry);
+                }
+                else
+                {
+                    GPKGRTreePendingGeometry sPending;
+                    sPending.nEntryIdx = aoEntries.size();
+                    sPending.nOffset = abyPendingData.size();
+                    sPending.nLen = static_cast<size_t>(nBLOBLen);
+                    sPending.nHeaderLen = sHeader.nHeaderLen;
+                    asPending.push_back(sPending);
+                    abyPendingData.insert(abyPendingData.end(),
+                                          pabyBLOB, pabyBLOB + nBLOBLen);
+                    aoEntries.push_back(sEntry);
+                }
+            }
+            else
+            {
+                int nSRSId = 0;
+                bool bEmpty = false;
+                if( OGRSQLiteLayer::GetSpatialiteGeometryHeader(
+                        pabyBLOB, nBLOBLen, &nSRSId, nullptr, &bEmpty,
+                        &sEntry.dfMinX, &sEntry.dfMinY,
+                        &sEntry.dfMaxX, &sEntry.dfMaxY) == OGRERR_NONE &&
+                    !bEmpty )
+                {
+                    aoEntries.push_back(sEntry);
+                }
+            }
         }
         else if( sqlite_err == SQLITE_DONE )
         {
@@ -2868,7 +3455,27 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
             return false;
         }
 
-        if( aoEntries.size() == nChunkSize || bFinished )
+        const bool bFlush = bFinished ||
+            aoEntries.size() >= (bBulkLoad ? nMaxBulkLoadEntries : nChunkSize);
+        if( bFlush || asPending.size() == nChunkSize )
+        {
+            GPKGComputePendingEnvelopes(aoEntries, abyPendingData, asPending,
+                                        poPool.get());
+        }
+
+        if( bFlush && bBulkLoad )
+        {
+            if( !GPKGBulkLoadRTree(m_poDS->GetDB(), m_osRTreeName,
+                                   aoEntries, poPool.get()) )
+            {
+                sqlite3_finalize(hIterStmt);
+                sqlite3_finalize(hInsertStmt);
+                m_poDS->SoftRollbackTransaction();
+                return false;
+            }
+            bBulkLoad = false;
+        }
+        else if( bFlush )
         {
             for( size_t i = 0; i < aoEntries.size(); ++i )
             {
@@ -2891,7 +3498,10 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
                     return false;
                 }
             }
+        }
 
+        if( bFlush )
+        {
             nEntryCount += aoEntries.size();
             CPLDebug("GPKG", CPL_FRMT_GUIB " rows inserted into %s",
                      nEntryCount, m_osRTreeName.c_str());
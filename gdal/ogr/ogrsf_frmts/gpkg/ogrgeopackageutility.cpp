@@ -230,33 +230,24 @@ const char* GPkgFieldFromOGR(OGRFieldType eType, OGRFieldSubType eSubType,
 *
 */
 
-GByte* GPkgGeometryFromOGR(const OGRGeometry *poGeometry, int iSrsId,
-                           size_t *pnWkbLen)
+static size_t GPkgHeaderSize(bool bPoint, bool bEmpty, int iDims)
 {
-    CPLAssert( poGeometry != nullptr );
-
-    GByte byFlags = 0;
-    GByte byEnv = 1;
-    OGRwkbByteOrder eByteOrder = (OGRwkbByteOrder)CPL_IS_LSB;
-    OGRErr err;
-    OGRBoolean bPoint = (wkbFlatten(poGeometry->getGeometryType()) == wkbPoint);
-    OGRBoolean bEmpty = poGeometry->IsEmpty();
-    /* We voluntarily use getCoordinateDimension() so as to get only 2 for XY/XYM */
-    /* and 3 for XYZ/XYZM as we currently don't write envelopes with M extent. */
-    int iDims = poGeometry->getCoordinateDimension();
-
     /* Header has 8 bytes for sure, and optional extra space for bounds */
     size_t nHeaderLen = 2+1+1+4;
     if ( ! bPoint && ! bEmpty )
     {
         nHeaderLen += 8*2*iDims;
     }
+    return nHeaderLen;
+}
 
-    /* Total BLOB size is header + WKB size */
-    size_t nWkbLen = nHeaderLen + poGeometry->WkbSize();
-    GByte *pabyWkb = (GByte *)CPLMalloc(nWkbLen);
-    if (pnWkbLen)
-        *pnWkbLen = nWkbLen;
+static void GPkgWriteHeader(GByte *pabyWkb, int iSrsId,
+                            bool bPoint, bool bEmpty, int iDims,
+                            const OGREnvelope3D& oEnv)
+{
+    GByte byFlags = 0;
+    GByte byEnv = 1;
+    OGRwkbByteOrder eByteOrder = (OGRwkbByteOrder)CPL_IS_LSB;
 
     /* Header Magic */
     pabyWkb[0] = 0x47;
@@ -305,27 +296,46 @@ GByte* GPkgGeometryFromOGR(const OGRGeometry *poGeometry, int iSrsId,
     if ( ! bEmpty && ! bPoint )
     {
         double *padPtr = (double*)(pabyWkb+8);
+        padPtr[0] = oEnv.MinX;
+        padPtr[1] = oEnv.MaxX;
+        padPtr[2] = oEnv.MinY;
+        padPtr[3] = oEnv.MaxY;
         if ( iDims == 3 )
         {
-            OGREnvelope3D oEnv3d;
-            poGeometry->getEnvelope(&oEnv3d);
-            padPtr[0] = oEnv3d.MinX;
-            padPtr[1] = oEnv3d.MaxX;
-            padPtr[2] = oEnv3d.MinY;
-            padPtr[3] = oEnv3d.MaxY;
-            padPtr[4] = oEnv3d.MinZ;
-            padPtr[5] = oEnv3d.MaxZ;
-        }
-        else
-        {
-            OGREnvelope oEnv;
-            poGeometry->getEnvelope(&oEnv);
-            padPtr[0] = oEnv.MinX;
-            padPtr[1] = oEnv.MaxX;
-            padPtr[2] = oEnv.MinY;
-            padPtr[3] = oEnv.MaxY;
+            padPtr[4] = oEnv.MinZ;
+            padPtr[5] = oEnv.MaxZ;
         }
     }
+}
+
+GByte* GPkgGeometryFromOGR(const OGRGeometry *poGeometry, int iSrsId,
+                           size_t *pnWkbLen)
+{
+    CPLAssert( poGeometry != nullptr );
+
+    OGRwkbByteOrder eByteOrder = (OGRwkbByteOrder)CPL_IS_LSB;
+    OGRErr err;
+    const bool bPoint = (wkbFlatten(poGeometry->getGeometryType()) == wkbPoint);
+    const bool bEmpty = CPL_TO_BOOL(poGeometry->IsEmpty());
+    /* We voluntarily use getCoordinateDimension() so as to get only 2 for XY/XYM */
+    /* and 3 for XYZ/XYZM as we currently don't write envelopes with M extent. */
+    int iDims = poGeometry->getCoordinateDimension();
+
+    size_t nHeaderLen = GPkgHeaderSize(bPoint, bEmpty, iDims);
+
+    /* Total BLOB size is header + WKB size */
+    size_t nWkbLen = nHeaderLen + poGeometry->WkbSize();
+    GByte *pabyWkb = (GByte *)CPLMalloc(nWkbLen);
+    if (pnWkbLen)
+        *pnWkbLen = nWkbLen;
+
+    OGREnvelope3D oEnv;
+    if ( ! bEmpty && ! bPoint )
+    {
+        /* Only the XY part is written for 2D geometries */
+        poGeometry->getEnvelope(&oEnv);
+    }
+    GPkgWriteHeader(pabyWkb, iSrsId, bPoint, bEmpty, iDims, oEnv);
 
     GByte *pabyPtr = pabyWkb + nHeaderLen;
 
@@ -340,6 +350,68 @@ GByte* GPkgGeometryFromOGR(const OGRGeometry *poGeometry, int iSrsId,
     return pabyWkb;
 }
 
+/* Build a GeoPackage geometry blob from the WKB of a lazy geometry field */
+/* (see OGRFeature::SetGeomFieldLazyWKB()), without instantiating it. */
+/* Returns NULL if the field is not lazy, or if its WKB cannot be copied */
+/* as it is: only ISO WKB of simple features (no curve or geometry */
+/* collection that could require a geometry type extension) is accepted. */
+/* The caller must then use GPkgGeometryFromOGR(). */
+
+GByte* GPkgGeometryFromLazyWKB(const OGRFeature *poFeature, int iGeomField,
+                               int iSrsId, size_t *pnWkbLen)
+{
+    size_t nWKBSize = 0;
+    const GByte* pabyWKB = poFeature->GetGeomFieldLazyWKB(iGeomField, &nWKBSize);
+    if ( pabyWKB == nullptr || nWKBSize < 5 )
+        return nullptr;
+
+    OGRwkbGeometryType eGeomType = wkbUnknown;
+    if ( OGRReadWKBGeometryType(pabyWKB, wkbVariantIso, &eGeomType) != OGRERR_NONE )
+        return nullptr;
+    const OGRwkbGeometryType eFlatType = wkbFlatten(eGeomType);
+    if ( eFlatType < wkbPoint || eFlatType > wkbMultiPolygon )
+        return nullptr;
+
+    /* Reject old-style OGC and PostGIS dimension flags */
+    GUInt32 nRawType = 0;
+    memcpy(&nRawType, pabyWKB + 1, 4);
+    if ( OGR_SWAP(static_cast<OGRwkbByteOrder>(pabyWKB[0] & 0x01)) )
+        CPL_SWAP32PTR(&nRawType);
+    if ( nRawType > 4000 )
+        return nullptr;
+
+    const bool bPoint = (eFlatType == wkbPoint);
+    const int iDims = OGR_GT_HasZ(eGeomType) ? 3 : 2;
+    OGREnvelope3D oEnv;
+    OGREnvelope oEnv2D;
+    bool bEmpty = false;
+    if ( iDims == 2 &&
+         poFeature->GetGeomFieldEnvelope(iGeomField, &oEnv2D) == OGRERR_NONE )
+    {
+        oEnv.MinX = oEnv2D.MinX;
+        oEnv.MaxX = oEnv2D.MaxX;
+        oEnv.MinY = oEnv2D.MinY;
+        oEnv.MaxY = oEnv2D.MaxY;
+    }
+    else
+    {
+        if ( !OGRWKBGetEnvelope(pabyWKB, nWKBSize, oEnv) )
+            return nullptr;
+        bEmpty = !oEnv.IsInit();
+    }
+
+    size_t nHeaderLen = GPkgHeaderSize(bPoint, bEmpty, iDims);
+    size_t nWkbLen = nHeaderLen + nWKBSize;
+    GByte *pabyWkb = (GByte *)CPLMalloc(nWkbLen);
+    if (pnWkbLen)
+        *pnWkbLen = nWkbLen;
+
+    GPkgWriteHeader(pabyWkb, iSrsId, bPoint, bEmpty, iDims, oEnv);
+    memcpy(pabyWkb + nHeaderLen, pabyWKB, nWKBSize);
+
+    return pabyWkb;
+}
+
 OGRErr GPkgHeaderFromWKB(const GByte *pabyGpkg, size_t nGpkgLen, GPkgHeader *poHeader)
 {
     CPLAssert( pabyGpkg != nullptr );
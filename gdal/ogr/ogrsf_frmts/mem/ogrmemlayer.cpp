@@ -501,7 +501,9 @@ OGRErr OGRMemLayer::DeleteFeature( GIntBig nFID )
 /************************************************************************/
 /*                          GetFeatureCount()                           */
 /*                                                                      */
-/*      If a spatial filter is in effect, we turn control over to       */
+/*      If an attribute filter is in effect, we evaluate it on          */
+/*      blocks of the internal features, without cloning them.  If      */
+/*      only a spatial filter is in effect, we turn control over to     */
 /*      the generic counter.  Otherwise we return the total count.      */
 /*      Eventually we should consider implementing a more efficient     */
 /*      way of counting features matching a spatial query.              */
@@ -510,7 +512,41 @@ OGRErr OGRMemLayer::DeleteFeature( GIntBig nFID )
 GIntBig OGRMemLayer::GetFeatureCount( int bForce )
 
 {
-    if( m_poFilterGeom != nullptr || m_poAttrQuery != nullptr )
+    if( m_poAttrQuery != nullptr )
+    {
+        constexpr int knBatchSize = 256;
+        OGRFeature *apoFeatures[knBatchSize];
+        int abResults[knBatchSize];
+        int nBatchCount = 0;
+        GIntBig nCount = 0;
+
+        IOGRMemLayerFeatureIterator *poIter = GetIterator();
+        while( true )
+        {
+            OGRFeature *poFeature = poIter->Next();
+            if( poFeature != nullptr &&
+                (m_poFilterGeom == nullptr ||
+                 FilterGeometry(
+                     poFeature->GetGeomFieldRef(m_iGeomFieldFilter))) )
+            {
+                apoFeatures[nBatchCount++] = poFeature;
+            }
+            if( nBatchCount == knBatchSize ||
+                (poFeature == nullptr && nBatchCount > 0) )
+            {
+                nCount += m_poAttrQuery->EvaluateBatch(
+                    apoFeatures, nBatchCount, abResults);
+                nBatchCount = 0;
+            }
+            if( poFeature == nullptr )
+                break;
+        }
+        delete poIter;
+
+        return nCount;
+    }
+
+    if( m_poFilterGeom != nullptr )
         return OGRLayer::GetFeatureCount(bForce);
 
     return m_nFeatureCount;
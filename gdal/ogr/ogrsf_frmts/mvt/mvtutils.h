@@ -61,7 +61,8 @@
 "  <Option name='COMPRESS' scope='vector' type='boolean' description=" \
         "'Whether to deflate-compress tiles' default='YES'/>" \
 "  <Option name='TEMPORARY_DB' scope='vector' type='string' description='" \
-        "Filename with path for the temporary database'/>" \
+        "Filename with path for a temporary database to use instead of " \
+        "the default external sort'/>" \
 "  <Option name='MAX_SIZE' scope='vector' type='unsigned int' min='100' default='500000' " \
         "description='Maximum size of a tile in bytes'/>" \
 "  <Option name='MAX_FEATURES' scope='vector' type='unsigned int' min='1' default='200000' " \
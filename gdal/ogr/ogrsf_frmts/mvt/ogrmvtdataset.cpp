@@ -43,6 +43,7 @@
 #include "gpb.h"
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <vector>
 #include <set>
@@ -66,6 +67,9 @@ constexpr int knMAX_FILES_PER_DIR = 10000;
 
 #include "cpl_worker_thread_pool.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
 
 // Limitations from https://github.com/mapbox/mapbox-geostats
@@ -79,6 +83,12 @@ constexpr size_t knMAX_STRING_VALUE_LENGTH = 256;
 constexpr size_t knMAX_LAYER_NAME_LENGTH = 256;
 constexpr size_t knMAX_FIELD_NAME_LENGTH = 256;
 
+// Default size of the pre-generated features sorted in memory before being
+// written as a run in the temporary file
+constexpr size_t knDEFAULT_SORT_RUN_SIZE = 100 * 1024 * 1024;
+// Maximum size of the features of the tiles queued for encoding
+constexpr size_t knMAX_PENDING_TILES_SIZE = 100 * 1024 * 1024;
+
 #undef SQLITE_STATIC
 #define SQLITE_STATIC      ((sqlite3_destructor_type)nullptr)
 
@@ -3183,6 +3193,444 @@ GDALDataset *OGRMVTDataset::Open( GDALOpenInfo* poOpenInfo )
 
 #ifdef HAVE_MVT_WRITE_SUPPORT
 
+/************************************************************************/
+/*                            MVTTempFeature                            */
+/************************************************************************/
+
+// Pre-generated feature of a tile, as stored in the temporary store
+class MVTTempFeature
+{
+    public:
+        int         nZ = 0;
+        int         nX = 0;
+        int         nY = 0;
+        int         nLayer = 0;     // index in the temporary layer names
+        GIntBig     nSerial = 0;
+        GIntBig     nSeq = 0;       // insertion order
+        double      dfAreaOrLength = 0.0;
+        std::string osFeature{};    // compressed single feature MVT layer
+};
+
+/************************************************************************/
+/*                         MVTTempFeatureSorter                         */
+/************************************************************************/
+
+// External merge sort of the pre-generated features by tile, layer name,
+// serial number and insertion order. Features are accumulated in memory, and
+// when their size exceeds the run size, they are sorted and appended as a run
+// to a temporary file. The runs are eventually merged.
+// Add() must be serialized by the caller, but the runs it hands over can be
+// sorted and written by several threads at once, so that up to one run per
+// thread, plus the one being filled, can be in memory.
+class MVTTempFeatureSorter
+{
+        class RunReader
+        {
+            public:
+                vsi_l_offset nOffset = 0;
+                vsi_l_offset nEnd = 0;
+                std::vector<GByte> abyBuffer{};
+                size_t nPos = 0;
+                size_t nSize = 0;
+                MVTTempFeature oFeature{};
+        };
+
+    public:
+        // Features moved out of memory by Add(), with the layer names they
+        // refer to, to be written by WriteRun()
+        class Run
+        {
+            public:
+                std::vector<MVTTempFeature> aoFeatures{};
+                std::vector<CPLString>      aosLayerNames{};
+        };
+
+    private:
+        const std::vector<CPLString>& m_aosLayerNames;
+        CPLString                     m_osFilename;
+        size_t                        m_nRunSize;
+        std::mutex                    m_oFileMutex{}; // for m_fp and runs
+        VSILFILE                     *m_fp = nullptr;
+        std::vector<MVTTempFeature>   m_aoFeatures{};
+        size_t                        m_nFeaturesSize = 0;
+        size_t                        m_nNextFeature = 0;
+        GIntBig                       m_nSeq = 0;
+        std::vector<vsi_l_offset>     m_anRunOffsets{};
+        std::vector<RunReader>        m_aoRuns{};
+        std::vector<size_t>           m_anHeap{};
+        std::atomic<bool>             m_bError{false};
+
+        CPL_DISALLOW_COPY_ASSIGN(MVTTempFeatureSorter)
+
+        static bool Less(const std::vector<CPLString>& aosLayerNames,
+                         const MVTTempFeature& a, const MVTTempFeature& b);
+        bool FillBuffer(RunReader& oRun, size_t nNeeded);
+        bool ReadFeature(RunReader& oRun);
+
+    public:
+        MVTTempFeatureSorter(const std::vector<CPLString>& aosLayerNames,
+                             const CPLString& osFilename,
+                             size_t nRunSize);
+        ~MVTTempFeatureSorter();
+
+        bool Add(MVTTempFeature&& oFeature, Run& oRun);
+        bool WriteRun(Run& oRun);
+        bool StartReading();
+        bool GetNext(MVTTempFeature& oFeature);
+        bool HasError() const { return m_bError; }
+};
+
+// z, x, y, layer, serial, seq, area_or_length, feature size
+constexpr size_t knTEMP_FEATURE_HEADER_SIZE = 4 * 4 + 2 * 8 + 8 + 4;
+
+/************************************************************************/
+/*                        MVTTempFeatureSorter()                        */
+/************************************************************************/
+
+MVTTempFeatureSorter::MVTTempFeatureSorter(
+                                const std::vector<CPLString>& aosLayerNames,
+                                const CPLString& osFilename,
+                                size_t nRunSize) :
+    m_aosLayerNames(aosLayerNames),
+    m_osFilename(osFilename),
+    m_nRunSize(nRunSize)
+{
+}
+
+/************************************************************************/
+/*                       ~MVTTempFeatureSorter()                        */
+/************************************************************************/
+
+MVTTempFeatureSorter::~MVTTempFeatureSorter()
+{
+    if( m_fp )
+    {
+        VSIFCloseL(m_fp);
+        VSIUnlink(m_osFilename);
+    }
+}
+
+/************************************************************************/
+/*                                Less()                                */
+/************************************************************************/
+
+bool MVTTempFeatureSorter::Less(const std::vector<CPLString>& aosLayerNames,
+                                const MVTTempFeature& a,
+                                const MVTTempFeature& b)
+{
+    if( a.nZ != b.nZ )
+        return a.nZ < b.nZ;
+    if( a.nX != b.nX )
+        return a.nX < b.nX;
+    if( a.nY != b.nY )
+        return a.nY < b.nY;
+    if( a.nLayer != b.nLayer )
+    {
+        // Same order as the layer TEXT column of the temporary database
+        return strcmp(aosLayerNames[a.nLayer].c_str(),
+                      aosLayerNames[b.nLayer].c_str()) < 0;
+    }
+    if( a.nSerial != b.nSerial )
+        return a.nSerial < b.nSerial;
+    return a.nSeq < b.nSeq;
+}
+
+/************************************************************************/
+/*                                 Add()                                */
+/************************************************************************/
+
+// When the features in memory reach the run size, they are moved to oRun,
+// which must then be passed to WriteRun(), that does not need to be
+// serialized with Add().
+bool MVTTempFeatureSorter::Add(MVTTempFeature&& oFeature, Run& oRun)
+{
+    if( m_bError )
+        return false;
+    oFeature.nSeq = m_nSeq ++;
+    m_nFeaturesSize += sizeof(MVTTempFeature) + oFeature.osFeature.size();
+    m_aoFeatures.emplace_back(std::move(oFeature));
+    if( m_nFeaturesSize >= m_nRunSize )
+    {
+        oRun.aoFeatures.swap(m_aoFeatures);
+        // The layer names may grow while the run is sorted
+        oRun.aosLayerNames = m_aosLayerNames;
+        m_nFeaturesSize = 0;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                              WriteRun()                              */
+/************************************************************************/
+
+// Sort the features of oRun and append them as a new run to the temporary
+// file. Runs can be appended in any order, as the insertion order is part of
+// the sort key.
+bool MVTTempFeatureSorter::WriteRun(Run& oRun)
+{
+    auto& aoFeatures = oRun.aoFeatures;
+    const auto& aosLayerNames = oRun.aosLayerNames;
+    std::sort(aoFeatures.begin(), aoFeatures.end(),
+              [&aosLayerNames](const MVTTempFeature& a, const MVTTempFeature& b)
+              { return Less(aosLayerNames, a, b); });
+
+    std::lock_guard<std::mutex> oLock(m_oFileMutex);
+    if( m_bError )
+        return false;
+    if( m_fp == nullptr )
+    {
+        m_fp = VSIFOpenL(m_osFilename, "wb+");
+        if( m_fp == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s",
+                     m_osFilename.c_str());
+            m_bError = true;
+            return false;
+        }
+        // For Unix
+        if( CPLTestBool(CPLGetConfigOption("OGR_MVT_REMOVE_TEMP_FILE", "YES")) )
+        {
+            VSIUnlink(m_osFilename);
+        }
+        m_anRunOffsets.push_back(0);
+    }
+
+    constexpr size_t knWRITE_BUFFER_SIZE = 1024 * 1024;
+    std::vector<GByte> abyBuffer;
+    vsi_l_offset nOffset = m_anRunOffsets.back();
+    for( size_t i = 0; i < aoFeatures.size(); i++ )
+    {
+        const auto& oFeature = aoFeatures[i];
+        const GUInt32 nFeatureSize =
+            static_cast<GUInt32>(oFeature.osFeature.size());
+        const size_t nPos = abyBuffer.size();
+        abyBuffer.resize(nPos + knTEMP_FEATURE_HEADER_SIZE + nFeatureSize);
+        GByte* pabyData = abyBuffer.data() + nPos;
+        memcpy(pabyData, &oFeature.nZ, 4);
+        memcpy(pabyData + 4, &oFeature.nX, 4);
+        memcpy(pabyData + 8, &oFeature.nY, 4);
+        memcpy(pabyData + 12, &oFeature.nLayer, 4);
+        memcpy(pabyData + 16, &oFeature.nSerial, 8);
+        memcpy(pabyData + 24, &oFeature.nSeq, 8);
+        memcpy(pabyData + 32, &oFeature.dfAreaOrLength, 8);
+        memcpy(pabyData + 40, &nFeatureSize, 4);
+        memcpy(pabyData + knTEMP_FEATURE_HEADER_SIZE,
+               oFeature.osFeature.data(), nFeatureSize);
+
+        if( abyBuffer.size() >= knWRITE_BUFFER_SIZE ||
+            i + 1 == aoFeatures.size() )
+        {
+            if( VSIFWriteL(abyBuffer.data(), 1, abyBuffer.size(), m_fp) !=
+                                                            abyBuffer.size() )
+            {
+                CPLError(CE_Failure, CPLE_FileIO, "Failure writing in %s",
+                         m_osFilename.c_str());
+                m_bError = true;
+                return false;
+            }
+            nOffset += abyBuffer.size();
+            abyBuffer.clear();
+        }
+    }
+    m_anRunOffsets.push_back(nOffset);
+
+    std::vector<MVTTempFeature>().swap(aoFeatures);
+    return true;
+}
+
+/************************************************************************/
+/*                            StartReading()                            */
+/************************************************************************/
+
+bool MVTTempFeatureSorter::StartReading()
+{
+    if( m_bError )
+        return false;
+
+    if( m_fp == nullptr )
+    {
+        // Everything fits in memory
+        std::sort(m_aoFeatures.begin(), m_aoFeatures.end(),
+                  [this](const MVTTempFeature& a, const MVTTempFeature& b)
+                  { return Less(m_aosLayerNames, a, b); });
+        m_nNextFeature = 0;
+        return true;
+    }
+
+    if( !m_aoFeatures.empty() )
+    {
+        Run oRun;
+        oRun.aoFeatures.swap(m_aoFeatures);
+        oRun.aosLayerNames = m_aosLayerNames;
+        if( !WriteRun(oRun) )
+            return false;
+    }
+
+    const size_t nRuns = m_anRunOffsets.size() - 1;
+    CPLDebug("MVT", "Merging %u runs of sorted features",
+             static_cast<unsigned>(nRuns));
+    const size_t nBufferSize = std::max(static_cast<size_t>(65536),
+                                        m_nRunSize / nRuns);
+    m_aoRuns.resize(nRuns);
+    for( size_t i = 0; i < nRuns; i++ )
+    {
+        auto& oRun = m_aoRuns[i];
+        oRun.nOffset = m_anRunOffsets[i];
+        oRun.nEnd = m_anRunOffsets[i + 1];
+        oRun.abyBuffer.resize(nBufferSize);
+        if( !ReadFeature(oRun) )
+            return false;
+        m_anHeap.push_back(i);
+    }
+    std::make_heap(m_anHeap.begin(), m_anHeap.end(),
+                   [this](size_t i, size_t j)
+                   { return Less(m_aosLayerNames, m_aoRuns[j].oFeature,
+                                 m_aoRuns[i].oFeature); });
+    return true;
+}
+
+/************************************************************************/
+/*                             FillBuffer()                             */
+/************************************************************************/
+
+// Make sure that at least nNeeded bytes are available in the buffer of the run
+bool MVTTempFeatureSorter::FillBuffer(RunReader& oRun, size_t nNeeded)
+{
+    const size_t nRemaining = oRun.nSize - oRun.nPos;
+    if( nRemaining >= nNeeded )
+        return true;
+
+    // Check against the end of the run before growing the buffer, in case
+    // of a corrupted feature size
+    if( nNeeded - nRemaining > oRun.nEnd - oRun.nOffset )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Failure reading in %s",
+                 m_osFilename.c_str());
+        m_bError = true;
+        return false;
+    }
+    if( oRun.abyBuffer.size() < nNeeded )
+        oRun.abyBuffer.resize(nNeeded);
+    memmove(oRun.abyBuffer.data(), oRun.abyBuffer.data() + oRun.nPos,
+            nRemaining);
+    const size_t nToRead = static_cast<size_t>(
+        std::min(static_cast<vsi_l_offset>(oRun.abyBuffer.size() - nRemaining),
+                 oRun.nEnd - oRun.nOffset));
+    if( VSIFSeekL(m_fp, oRun.nOffset, SEEK_SET) != 0 ||
+        VSIFReadL(oRun.abyBuffer.data() + nRemaining, 1, nToRead, m_fp) !=
+                                                                    nToRead )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Failure reading in %s",
+                 m_osFilename.c_str());
+        m_bError = true;
+        return false;
+    }
+    oRun.nOffset += nToRead;
+    oRun.nPos = 0;
+    oRun.nSize = nRemaining + nToRead;
+    return true;
+}
+
+/************************************************************************/
+/*                            ReadFeature()                             */
+/************************************************************************/
+
+// Read the next feature of the run in oRun.oFeature
+bool MVTTempFeatureSorter::ReadFeature(RunReader& oRun)
+{
+    if( !FillBuffer(oRun, knTEMP_FEATURE_HEADER_SIZE) )
+        return false;
+    const GByte* pabyData = oRun.abyBuffer.data() + oRun.nPos;
+    auto& oFeature = oRun.oFeature;
+    GUInt32 nFeatureSize = 0;
+    memcpy(&oFeature.nZ, pabyData, 4);
+    memcpy(&oFeature.nX, pabyData + 4, 4);
+    memcpy(&oFeature.nY, pabyData + 8, 4);
+    memcpy(&oFeature.nLayer, pabyData + 12, 4);
+    memcpy(&oFeature.nSerial, pabyData + 16, 8);
+    memcpy(&oFeature.nSeq, pabyData + 24, 8);
+    memcpy(&oFeature.dfAreaOrLength, pabyData + 32, 8);
+    memcpy(&nFeatureSize, pabyData + 40, 4);
+    oRun.nPos += knTEMP_FEATURE_HEADER_SIZE;
+
+    if( !FillBuffer(oRun, nFeatureSize) )
+        return false;
+    oFeature.osFeature.assign(
+        reinterpret_cast<const char*>(oRun.abyBuffer.data() + oRun.nPos),
+        nFeatureSize);
+    oRun.nPos += nFeatureSize;
+    return true;
+}
+
+/************************************************************************/
+/*                              GetNext()                               */
+/************************************************************************/
+
+// Return the features by increasing tile, layer name and serial number
+bool MVTTempFeatureSorter::GetNext(MVTTempFeature& oFeature)
+{
+    if( m_fp == nullptr )
+    {
+        if( m_nNextFeature == m_aoFeatures.size() )
+            return false;
+        oFeature = std::move(m_aoFeatures[m_nNextFeature]);
+        m_nNextFeature ++;
+        return true;
+    }
+
+    if( m_bError || m_anHeap.empty() )
+        return false;
+    const auto oCmp = [this](size_t i, size_t j)
+                      { return Less(m_aosLayerNames, m_aoRuns[j].oFeature,
+                                    m_aoRuns[i].oFeature); };
+    std::pop_heap(m_anHeap.begin(), m_anHeap.end(), oCmp);
+    auto& oRun = m_aoRuns[m_anHeap.back()];
+    oFeature = std::move(oRun.oFeature);
+    if( oRun.nPos == oRun.nSize && oRun.nOffset == oRun.nEnd )
+    {
+        m_anHeap.pop_back();
+        std::vector<GByte>().swap(oRun.abyBuffer);
+    }
+    else if( ReadFeature(oRun) )
+    {
+        std::push_heap(m_anHeap.begin(), m_anHeap.end(), oCmp);
+    }
+    else
+    {
+        m_anHeap.clear();
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                           MVTEncodeTileJob                           */
+/************************************************************************/
+
+class OGRMVTWriterDataset;
+
+// Encoding of a tile by a worker thread
+class MVTEncodeTileJob
+{
+    public:
+        const OGRMVTWriterDataset* poDS = nullptr;
+        int nZ = 0;
+        int nX = 0;
+        int nY = 0;
+        // At most MAX_FEATURES features, by layer name and serial number
+        std::vector<MVTTempFeature> aoFeatures{};
+        // If the tile has more than MAX_FEATURES features, the MAX_FEATURES
+        // ones with the largest area/length (heap ordered)
+        std::vector<MVTTempFeature> aoLargestFeatures{};
+        GIntBig nFeatureCount = 0;
+        size_t nFeaturesSize = 0;
+        // Layers of the tile encoded at full resolution, for the statistics
+        std::vector<std::shared_ptr<MVTTileLayer>> apoLayers{};
+        std::string osTileBuffer{};
+        bool bDone = false;
+        std::mutex* poMutex = nullptr;
+        std::condition_variable* poCond = nullptr;
+};
+
 /************************************************************************/
 /*                           OGRMVTWriterDataset                        */
 /************************************************************************/
@@ -3223,6 +3671,9 @@ class OGRMVTWriterDataset final: public GDALDataset
         sqlite3_vfs                           *m_pMyVFS = nullptr;
         sqlite3                               *m_hDB = nullptr;
         sqlite3_stmt                          *m_hInsertStmt = nullptr;
+        mutable std::vector<CPLString>         m_aosTempLayerNames{};
+        mutable std::map<CPLString, int>       m_oMapTempLayerNameToIdx{};
+        std::unique_ptr<MVTTempFeatureSorter>  m_poTempSorter{};
         int                                    m_nMinZoom = 0;
         int                                    m_nMaxZoom = 5;
         double                                 m_dfSimplification = 0.0;
@@ -3307,34 +3758,43 @@ class OGRMVTWriterDataset final: public GDALDataset
                                             int& nLastY) const;
 #endif
 
+        int                 GetTempLayerIdx(const CPLString& osLayerName) const;
+
         static
         void UpdateLayerProperties(MVTLayerProperties* poLayerProperties,
                                     const std::string& osKey,
                                     const MVTTileLayerValue& oValue);
 
+        static
+        void UpdateTileLayerProperties(
+                        int nZ,
+                        const std::vector<std::shared_ptr<MVTTileLayer>>& apoLayers,
+                        std::map<CPLString, MVTLayerProperties>& oMapLayerProps,
+                        std::set<CPLString>& oSetLayers);
+
         void EncodeFeature(
                         const void* pabyBlob,
                         int nBlobSize,
                         std::shared_ptr<MVTTileLayer> poTargetLayer,
                         std::map<CPLString, GUInt32>& oMapKeyToIdx,
                         std::map<MVTTileLayerValue, GUInt32>& oMapValueToIdx,
-                        MVTLayerProperties* poLayerProperties,
                         GUInt32 nExtent,
-                        unsigned& nFeaturesInTile);
+                        unsigned& nFeaturesInTile) const;
 
-        std::string EncodeTile(
-                        int nZ, int nX, int nY,
-                        sqlite3_stmt* hStmtLayer,
-                        sqlite3_stmt* hStmtRows,
-                        std::map<CPLString, MVTLayerProperties>& oMapLayerProps,
-                        std::set<CPLString>& oSetLayers,
-                        GIntBig& nTempTilesRead);
+        unsigned EncodeTileLayers(
+                        const std::vector<MVTTempFeature>& aoFeatures,
+                        GUInt32 nExtent,
+                        MVTTile& oTargetTile) const;
 
-        std::string RecodeTileLowerResolution(
-                                int nZ, int nX, int nY,
-                                int nExtent,
-                                sqlite3_stmt* hStmtLayer,
-                                sqlite3_stmt* hStmtRows);
+        void EncodeTile(MVTEncodeTileJob* poJob) const;
+
+        static void         EncodeTileJobFunc(void* pParam);
+
+        bool                ReadTempFeature(sqlite3_stmt* hStmtFeatures,
+                                            MVTTempFeature& oFeature) const;
+
+        void                AddFeatureToTileJob(MVTEncodeTileJob* poJob,
+                                                MVTTempFeature&& oFeature) const;
 
         bool                CreateOutput();
 
@@ -4278,6 +4738,34 @@ OGRErr OGRMVTWriterDataset::PreGenerateForTileReal(
     oBuffer.assign( static_cast<char*>(pCompressed), nCompressedSize );
     CPLFree(pCompressed);
 
+    if( m_poTempSorter )
+    {
+        MVTTempFeature oTempFeature;
+        oTempFeature.nZ = nZ;
+        oTempFeature.nX = nTileX;
+        oTempFeature.nY = nTileY;
+        oTempFeature.nSerial = nSerial;
+        oTempFeature.dfAreaOrLength = dfAreaOrLength;
+        oTempFeature.osFeature = std::move(oBuffer);
+
+        MVTTempFeatureSorter::Run oRun;
+        if( m_bThreadPoolOK )
+            m_oDBMutex.lock();
+
+        m_nTempTiles ++;
+        oTempFeature.nLayer = GetTempLayerIdx(osTargetName);
+        bool bOK = m_poTempSorter->Add(std::move(oTempFeature), oRun);
+
+        if( m_bThreadPoolOK )
+            m_oDBMutex.unlock();
+
+        // Sort and write a full run without blocking the other threads
+        if( bOK && !oRun.aoFeatures.empty() )
+            bOK = m_poTempSorter->WriteRun(oRun);
+
+        return bOK ? OGRERR_NONE : OGRERR_FAILURE;
+    }
+
     if( m_bThreadPoolOK )
         m_oDBMutex.lock();
 
@@ -4307,6 +4795,22 @@ OGRErr OGRMVTWriterDataset::PreGenerateForTileReal(
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                          GetTempLayerIdx()                           */
+/************************************************************************/
+
+// Must be called with m_oDBMutex held when the thread pool is used
+int OGRMVTWriterDataset::GetTempLayerIdx(const CPLString& osLayerName) const
+{
+    auto oIter = m_oMapTempLayerNameToIdx.find(osLayerName);
+    if( oIter != m_oMapTempLayerNameToIdx.end() )
+        return oIter->second;
+    const int nIdx = static_cast<int>(m_aosTempLayerNames.size());
+    m_aosTempLayerNames.push_back(osLayerName);
+    m_oMapTempLayerNameToIdx[osLayerName] = nIdx;
+    return nIdx;
+}
+
 /************************************************************************/
 /*                           MVTWriterTask()                            */
 /************************************************************************/
@@ -4782,9 +5286,8 @@ void OGRMVTWriterDataset::EncodeFeature(
                         std::shared_ptr<MVTTileLayer> poTargetLayer,
                         std::map<CPLString, GUInt32>& oMapKeyToIdx,
                         std::map<MVTTileLayerValue, GUInt32>& oMapValueToIdx,
-                        MVTLayerProperties* poLayerProperties,
                         GUInt32 nExtent,
-                        unsigned& nFeaturesInTile)
+                        unsigned& nFeaturesInTile) const
 {
     size_t nUncompressedSize = 0;
     void* pCompressed = CPLZLibInflate( pabyBlob, nBlobSize,
@@ -4807,11 +5310,6 @@ void OGRMVTWriterDataset::EncodeFeature(
             if( poSrcFeature->hasId() )
                 poFeature->setId(poSrcFeature->getId());
             poFeature->setType(poSrcFeature->getType());
-            if( poLayerProperties )
-            {
-                poLayerProperties->
-                    m_oCountGeomType[poSrcFeature->getType()] ++;
-            }
             bool bOK = true;
             if( nExtent < m_nExtent )
             {
@@ -4885,13 +5383,6 @@ void OGRMVTWriterDataset::EncodeFeature(
                         auto& osKey = srcKeys[nSrcIdxKey];
                         auto& oValue = srcValues[nSrcIdxValue];
 
-                        if( poLayerProperties )
-                        {
-                            UpdateLayerProperties(poLayerProperties,
-                                                    osKey,
-                                                    oValue);
-                        }
-
                         poFeature->addTag(oMapKeyToIdx[osKey]);
                         poFeature->addTag(oMapValueToIdx[oValue]);
                     }
@@ -4913,51 +5404,34 @@ void OGRMVTWriterDataset::EncodeFeature(
 }
 
 /************************************************************************/
-/*                            EncodeTile()                              */
+/*                     UpdateTileLayerProperties()                      */
 /************************************************************************/
 
-std::string OGRMVTWriterDataset::EncodeTile(
-                        int nZ, int nX, int nY,
-                        sqlite3_stmt* hStmtLayer,
-                        sqlite3_stmt* hStmtRows,
-                        std::map<CPLString, MVTLayerProperties>& oMapLayerProps,
-                        std::set<CPLString>& oSetLayers,
-                        GIntBig& nTempTilesRead)
+// Update the layer statistics from the layers of a tile encoded at full
+// resolution, in the same order as they were encoded.
+void OGRMVTWriterDataset::UpdateTileLayerProperties(
+                int nZ,
+                const std::vector<std::shared_ptr<MVTTileLayer>>& apoLayers,
+                std::map<CPLString, MVTLayerProperties>& oMapLayerProps,
+                std::set<CPLString>& oSetLayers)
 {
-    MVTTile oTargetTile;
-
-    sqlite3_bind_int(hStmtLayer, 1, nZ);
-    sqlite3_bind_int(hStmtLayer, 2, nX);
-    sqlite3_bind_int(hStmtLayer, 3, nY);
-
-    unsigned nFeaturesInTile = 0;
-    const GIntBig nProgressStep = std::max( static_cast<GIntBig>(1),
-                                            m_nTempTiles / 10 );
-
-    while( nFeaturesInTile < m_nMaxFeatures &&
-           sqlite3_step(hStmtLayer) == SQLITE_ROW )
+    for( const auto& poLayer: apoLayers )
     {
-        const char* pszLayerName = reinterpret_cast<const char*>(
-            sqlite3_column_text(hStmtLayer, 0));
-        sqlite3_bind_int(hStmtRows, 1, nZ);
-        sqlite3_bind_int(hStmtRows, 2, nX);
-        sqlite3_bind_int(hStmtRows, 3, nY); 
-        sqlite3_bind_text(hStmtRows, 4, pszLayerName, -1, SQLITE_STATIC);
-
-        auto oIterMapLayerProps = oMapLayerProps.find(pszLayerName);
+        const CPLString osLayerName(poLayer->getName());
+        auto oIterMapLayerProps = oMapLayerProps.find(osLayerName);
         MVTLayerProperties* poLayerProperties = nullptr;
         if( oIterMapLayerProps == oMapLayerProps.end() )
         {
             if( oSetLayers.size() < knMAX_COUNT_LAYERS )
             {
-                oSetLayers.insert(pszLayerName);
+                oSetLayers.insert(osLayerName);
                 if( oMapLayerProps.size() < knMAX_REPORT_LAYERS )
                 {
                     MVTLayerProperties props;
                     props.m_nMinZoom = nZ;
                     props.m_nMaxZoom = nZ;
-                    oMapLayerProps[pszLayerName] = props;
-                    poLayerProperties = &(oMapLayerProps[pszLayerName]);
+                    oMapLayerProps[osLayerName] = props;
+                    poLayerProperties = &(oMapLayerProps[osLayerName]);
                 }
             }
         }
@@ -4965,46 +5439,87 @@ std::string OGRMVTWriterDataset::EncodeTile(
         {
             poLayerProperties = &(oIterMapLayerProps->second);
         }
-        if( poLayerProperties )
+        if( poLayerProperties == nullptr )
+            continue;
+
+        poLayerProperties->m_nMinZoom =
+            std::min(nZ, poLayerProperties->m_nMinZoom);
+        poLayerProperties->m_nMaxZoom =
+            std::max(nZ, poLayerProperties->m_nMaxZoom);
+
+        const auto& aosKeys = poLayer->getKeys();
+        const auto& aoValues = poLayer->getValues();
+        for( const auto& poFeature: poLayer->getFeatures() )
         {
-            poLayerProperties->m_nMinZoom =
-                std::min(nZ, poLayerProperties->m_nMinZoom);
-            poLayerProperties->m_nMaxZoom =
-                std::max(nZ, poLayerProperties->m_nMaxZoom);
+            poLayerProperties->m_oCountGeomType[poFeature->getType()] ++;
+            const auto& anTags = poFeature->getTags();
+            for( size_t i = 0; i + 1 < anTags.size(); i += 2 )
+            {
+                UpdateLayerProperties(poLayerProperties,
+                                      aosKeys[anTags[i]],
+                                      aoValues[anTags[i+1]]);
+            }
         }
+    }
+}
 
-        std::shared_ptr<MVTTileLayer> poTargetLayer(new MVTTileLayer());
-        oTargetTile.addLayer(poTargetLayer);
-        poTargetLayer->setName(pszLayerName);
-        poTargetLayer->setVersion(m_nMVTVersion);
-        poTargetLayer->setExtent(m_nExtent);
+/************************************************************************/
+/*                          EncodeTileLayers()                          */
+/************************************************************************/
 
-        std::map<CPLString, GUInt32> oMapKeyToIdx;
-        std::map<MVTTileLayerValue, GUInt32> oMapValueToIdx;
+// Encode features ordered by layer name, with one target layer per source
+// layer. Returns the number of encoded features.
+unsigned OGRMVTWriterDataset::EncodeTileLayers(
+                            const std::vector<MVTTempFeature>& aoFeatures,
+                            GUInt32 nExtent,
+                            MVTTile& oTargetTile) const
+{
+    unsigned nFeaturesInTile = 0;
+    int nCurLayer = -1;
+    std::shared_ptr<MVTTileLayer> poTargetLayer;
+    std::map<CPLString, GUInt32> oMapKeyToIdx;
+    std::map<MVTTileLayerValue, GUInt32> oMapValueToIdx;
 
-        while( nFeaturesInTile < m_nMaxFeatures &&
-               sqlite3_step(hStmtRows) == SQLITE_ROW )
+    for( const auto& oFeature: aoFeatures )
+    {
+        if( nFeaturesInTile >= m_nMaxFeatures )
+            break;
+        if( oFeature.nLayer != nCurLayer )
         {
-            int nBlobSize = sqlite3_column_bytes(hStmtRows, 0);
-            const void* pabyBlob = sqlite3_column_blob(hStmtRows, 0);
-
-            EncodeFeature(pabyBlob, nBlobSize, poTargetLayer,
-                          oMapKeyToIdx, oMapValueToIdx,
-                          poLayerProperties, m_nExtent, nFeaturesInTile);
-
-            nTempTilesRead ++;
-            if( nTempTilesRead == m_nTempTiles||
-                (nTempTilesRead % nProgressStep) == 0 )
-            {
-                const int nPct = static_cast<int>(
-                                    (100 * nTempTilesRead) / m_nTempTiles);
-                CPLDebug("MVT", "%d%%...", nPct);
-            }
+            nCurLayer = oFeature.nLayer;
+            poTargetLayer = std::shared_ptr<MVTTileLayer>(new MVTTileLayer());
+            oTargetTile.addLayer(poTargetLayer);
+            poTargetLayer->setName(m_aosTempLayerNames[nCurLayer]);
+            poTargetLayer->setVersion(m_nMVTVersion);
+            poTargetLayer->setExtent(nExtent);
+            oMapKeyToIdx.clear();
+            oMapValueToIdx.clear();
         }
-        sqlite3_reset(hStmtRows);
+
+        EncodeFeature(oFeature.osFeature.data(),
+                      static_cast<int>(oFeature.osFeature.size()),
+                      poTargetLayer,
+                      oMapKeyToIdx, oMapValueToIdx,
+                      nExtent, nFeaturesInTile);
     }
 
-    sqlite3_reset(hStmtLayer);
+    return nFeaturesInTile;
+}
+
+/************************************************************************/
+/*                            EncodeTile()                              */
+/************************************************************************/
+
+void OGRMVTWriterDataset::EncodeTile(MVTEncodeTileJob* poJob) const
+{
+    const int nZ = poJob->nZ;
+    const int nX = poJob->nX;
+    const int nY = poJob->nY;
+
+    MVTTile oTargetTile;
+    unsigned nFeaturesInTile =
+        EncodeTileLayers(poJob->aoFeatures, m_nExtent, oTargetTile);
+    poJob->apoLayers = oTargetTile.getLayers();
 
     std::string oTileBuffer(oTargetTile.write());
     size_t nSizeBefore = oTileBuffer.size();
@@ -5025,8 +5540,11 @@ std::string OGRMVTWriterDataset::EncodeTile(
     {
         nExtent /= 2;
         nSizeBefore = oTileBuffer.size();
-        oTileBuffer = RecodeTileLowerResolution(nZ, nX, nY, nExtent,
-                                                hStmtLayer, hStmtRows);
+        MVTTile oRecodedTile;
+        EncodeTileLayers(poJob->aoFeatures, nExtent, oRecodedTile);
+        oTileBuffer = oRecodedTile.write();
+        if( m_bGZip) 
+            GZIPCompress(oTileBuffer);
         bTooBigTile = oTileBuffer.size() > m_nMaxTileSize;
         CPLDebug("MVT", "Recoding tile %d/%d/%d with extent = %u. "
                  "From %u to %u bytes",
@@ -5056,17 +5574,24 @@ std::string OGRMVTWriterDataset::EncodeTile(
 
         const unsigned nTotalFeaturesInTile =
                                 std::min(m_nMaxFeatures, nFeaturesInTile);
-        char* pszSQL = sqlite3_mprintf(
-            "SELECT layer, feature FROM temp "
-            "WHERE z = %d AND x = %d AND y = %d ORDER BY "
-            "area_or_length DESC LIMIT %d",
-            nZ, nX, nY, nTotalFeaturesInTile);
-        sqlite3_stmt* hTmpStmt = nullptr;
-        CPL_IGNORE_RET_VAL(
-            sqlite3_prepare_v2( m_hDB, pszSQL, -1, &hTmpStmt, nullptr) );
-        sqlite3_free(pszSQL);
-        if( !hTmpStmt )
-            return std::string();
+
+        // Order the candidate features by descending area / length, and
+        // by insertion order for equal values
+        const std::vector<MVTTempFeature>& aoCandidates =
+            poJob->aoLargestFeatures.empty() ? poJob->aoFeatures :
+                                               poJob->aoLargestFeatures;
+        std::vector<size_t> anOrder(aoCandidates.size());
+        for( size_t i = 0; i < anOrder.size(); i++ )
+            anOrder[i] = i;
+        std::sort(anOrder.begin(), anOrder.end(),
+                  [&aoCandidates](size_t i, size_t j)
+                  { return aoCandidates[i].dfAreaOrLength >
+                                        aoCandidates[j].dfAreaOrLength ||
+                           (aoCandidates[i].dfAreaOrLength ==
+                                        aoCandidates[j].dfAreaOrLength &&
+                            aoCandidates[i].nSeq < aoCandidates[j].nSeq); });
+        if( anOrder.size() > nTotalFeaturesInTile )
+            anOrder.resize(nTotalFeaturesInTile);
 
         class TargetTileLayerProps
         {
@@ -5076,48 +5601,36 @@ std::string OGRMVTWriterDataset::EncodeTile(
                 std::map<MVTTileLayerValue, GUInt32> m_oMapValueToIdx;
         };
 
-        std::map<std::string, TargetTileLayerProps>
-                                        oMapLayerNameToTargetLayer;
+        std::map<int, TargetTileLayerProps> oMapLayerToTargetLayer;
 
         nFeaturesInTile = 0;
         const unsigned nCheckStep = std::max(1U, nTotalFeaturesInTile / 100);
-        while( sqlite3_step(hTmpStmt) == SQLITE_ROW )
+        for( const size_t iFeature: anOrder )
         {
-            const char* pszLayerName = reinterpret_cast<const char*>(
-                sqlite3_column_text(hTmpStmt, 0));
-            int nBlobSize = sqlite3_column_bytes(hTmpStmt, 1);
-            const void* pabyBlob = sqlite3_column_blob(hTmpStmt, 1);
-
-            std::shared_ptr<MVTTileLayer> poTargetLayer;
-            std::map<CPLString, GUInt32>* poMapKeyToIdx;
-            std::map<MVTTileLayerValue, GUInt32>* poMapValueToIdx;
-            auto oIter = oMapLayerNameToTargetLayer.find(pszLayerName);
-            if( oIter == oMapLayerNameToTargetLayer.end() )
+            const auto& oFeature = aoCandidates[iFeature];
+
+            auto oIter = oMapLayerToTargetLayer.find(oFeature.nLayer);
+            if( oIter == oMapLayerToTargetLayer.end() )
             {
-                poTargetLayer =
-                    std::shared_ptr<MVTTileLayer>(new MVTTileLayer());
-                TargetTileLayerProps props;
-                props.m_poLayer = poTargetLayer;
+                std::shared_ptr<MVTTileLayer> poTargetLayer(
+                                                        new MVTTileLayer());
                 oTargetTile.addLayer(poTargetLayer);
-                poTargetLayer->setName(pszLayerName);
+                poTargetLayer->setName(m_aosTempLayerNames[oFeature.nLayer]);
                 poTargetLayer->setVersion(m_nMVTVersion);
                 poTargetLayer->setExtent(nExtent);
-                oMapLayerNameToTargetLayer[pszLayerName] = props;
-                poMapKeyToIdx =
-                    &oMapLayerNameToTargetLayer[pszLayerName].m_oMapKeyToIdx;
-                poMapValueToIdx =
-                    &oMapLayerNameToTargetLayer[pszLayerName].m_oMapValueToIdx;
-            }
-            else
-            {
-                poTargetLayer = oIter->second.m_poLayer;
-                poMapKeyToIdx = &oIter->second.m_oMapKeyToIdx;
-                poMapValueToIdx = &oIter->second.m_oMapValueToIdx;
+                TargetTileLayerProps props;
+                props.m_poLayer = poTargetLayer;
+                oIter = oMapLayerToTargetLayer.insert(
+                    std::pair<int, TargetTileLayerProps>(oFeature.nLayer,
+                                                         props)).first;
             }
 
-            EncodeFeature(pabyBlob, nBlobSize, poTargetLayer,
-                          *poMapKeyToIdx, *poMapValueToIdx,
-                          nullptr, nExtent, nFeaturesInTile);
+            EncodeFeature(oFeature.osFeature.data(),
+                          static_cast<int>(oFeature.osFeature.size()),
+                          oIter->second.m_poLayer,
+                          oIter->second.m_oMapKeyToIdx,
+                          oIter->second.m_oMapValueToIdx,
+                          nExtent, nFeaturesInTile);
 
             if( nFeaturesInTile == nTotalFeaturesInTile ||
                 (bTooBigTile && (nFeaturesInTile % nCheckStep == 0)) )
@@ -5140,70 +5653,101 @@ std::string OGRMVTWriterDataset::EncodeTile(
                      nZ, nX, nY,
                      static_cast<unsigned>(oTileBuffer.size()));
         }
-
-        sqlite3_finalize(hTmpStmt);
     }
 
-    return oTileBuffer;
+    poJob->osTileBuffer = std::move(oTileBuffer);
 }
 
 /************************************************************************/
-/*                    RecodeTileLowerResolution()                       */
+/*                         EncodeTileJobFunc()                          */
 /************************************************************************/
 
-std::string OGRMVTWriterDataset::RecodeTileLowerResolution(
-                                            int nZ, int nX, int nY,
-                                            int nExtent,
-                                            sqlite3_stmt* hStmtLayer,
-                                            sqlite3_stmt* hStmtRows)
+void OGRMVTWriterDataset::EncodeTileJobFunc(void* pParam)
 {
-    MVTTile oTargetTile;
-
-    sqlite3_bind_int(hStmtLayer, 1, nZ);
-    sqlite3_bind_int(hStmtLayer, 2, nX);
-    sqlite3_bind_int(hStmtLayer, 3, nY);
-
-    unsigned nFeaturesInTile = 0;
-    while( nFeaturesInTile < m_nMaxFeatures &&
-           sqlite3_step(hStmtLayer) == SQLITE_ROW )
-    {
-        const char* pszLayerName = reinterpret_cast<const char*>(
-            sqlite3_column_text(hStmtLayer, 0));
-        sqlite3_bind_int(hStmtRows, 1, nZ);
-        sqlite3_bind_int(hStmtRows, 2, nX);
-        sqlite3_bind_int(hStmtRows, 3, nY); 
-        sqlite3_bind_text(hStmtRows, 4, pszLayerName, -1, SQLITE_STATIC);
+    MVTEncodeTileJob* poJob = static_cast<MVTEncodeTileJob*>(pParam);
+    poJob->poDS->EncodeTile(poJob);
+    std::vector<MVTTempFeature>().swap(poJob->aoFeatures);
+    std::vector<MVTTempFeature>().swap(poJob->aoLargestFeatures);
+
+    std::lock_guard<std::mutex> oLock(*(poJob->poMutex));
+    poJob->bDone = true;
+    poJob->poCond->notify_all();
+}
 
-        std::shared_ptr<MVTTileLayer> poTargetLayer(new MVTTileLayer());
-        oTargetTile.addLayer(poTargetLayer);
-        poTargetLayer->setName(pszLayerName);
-        poTargetLayer->setVersion(m_nMVTVersion);
-        poTargetLayer->setExtent(nExtent);
+/************************************************************************/
+/*                          ReadTempFeature()                           */
+/************************************************************************/
 
-        std::map<CPLString, GUInt32> oMapKeyToIdx;
-        std::map<MVTTileLayerValue, GUInt32> oMapValueToIdx;
+// Read the next pre-generated feature, by increasing tile, layer name and
+// serial number
+bool OGRMVTWriterDataset::ReadTempFeature(sqlite3_stmt* hStmtFeatures,
+                                          MVTTempFeature& oFeature) const
+{
+    if( m_poTempSorter )
+        return m_poTempSorter->GetNext(oFeature);
 
-        while( nFeaturesInTile < m_nMaxFeatures &&
-               sqlite3_step(hStmtRows) == SQLITE_ROW )
-        {
-            int nBlobSize = sqlite3_column_bytes(hStmtRows, 0);
-            const void* pabyBlob = sqlite3_column_blob(hStmtRows, 0);
+    if( sqlite3_step(hStmtFeatures) != SQLITE_ROW )
+        return false;
+    oFeature.nZ = sqlite3_column_int(hStmtFeatures, 0);
+    oFeature.nX = sqlite3_column_int(hStmtFeatures, 1);
+    oFeature.nY = sqlite3_column_int(hStmtFeatures, 2);
+    const char* pszLayerName = reinterpret_cast<const char*>(
+        sqlite3_column_text(hStmtFeatures, 3));
+    auto oIter = m_oMapTempLayerNameToIdx.find(pszLayerName ? pszLayerName : "");
+    oFeature.nLayer =
+        oIter != m_oMapTempLayerNameToIdx.end() ? oIter->second : 0;
+    oFeature.nSerial = sqlite3_column_int64(hStmtFeatures, 4);
+    const int nBlobSize = sqlite3_column_bytes(hStmtFeatures, 5);
+    const char* pabyBlob = static_cast<const char*>(
+        sqlite3_column_blob(hStmtFeatures, 5));
+    oFeature.osFeature.assign(pabyBlob ? pabyBlob : "", nBlobSize);
+    oFeature.dfAreaOrLength = sqlite3_column_double(hStmtFeatures, 6);
+    return true;
+}
 
-            EncodeFeature(pabyBlob, nBlobSize, poTargetLayer,
-                          oMapKeyToIdx, oMapValueToIdx,
-                          nullptr, nExtent, nFeaturesInTile);
+/************************************************************************/
+/*                        AddFeatureToTileJob()                         */
+/************************************************************************/
 
-        }
-        sqlite3_reset(hStmtRows);
+// Add a feature, read in layer name and serial number order, to the job
+// encoding its tile
+void OGRMVTWriterDataset::AddFeatureToTileJob(MVTEncodeTileJob* poJob,
+                                              MVTTempFeature&& oFeature) const
+{
+    const size_t nFeatureSize = sizeof(MVTTempFeature) +
+                                oFeature.osFeature.size();
+    oFeature.nSeq = poJob->nFeatureCount ++;
+    if( poJob->aoFeatures.size() < m_nMaxFeatures )
+    {
+        poJob->nFeaturesSize += nFeatureSize;
+        poJob->aoFeatures.emplace_back(std::move(oFeature));
+        return;
     }
 
-    sqlite3_reset(hStmtLayer);
-
-    std::string oTileBuffer(oTargetTile.write());
-    if( m_bGZip) 
-        GZIPCompress(oTileBuffer);
-
-    return oTileBuffer;
+    // Only the first MAX_FEATURES features of the tile are encoded, unless
+    // the feature count limit is reached, in which case the MAX_FEATURES
+    // ones with the largest area / length are. Keep track of them with a heap
+    // whose top is the smallest one.
+    auto& aoLargest = poJob->aoLargestFeatures;
+    const auto oCmp = [](const MVTTempFeature& a, const MVTTempFeature& b)
+                      { return a.dfAreaOrLength > b.dfAreaOrLength ||
+                               (a.dfAreaOrLength == b.dfAreaOrLength &&
+                                a.nSeq < b.nSeq); };
+    if( aoLargest.empty() )
+    {
+        aoLargest = poJob->aoFeatures;
+        poJob->nFeaturesSize *= 2;
+        std::make_heap(aoLargest.begin(), aoLargest.end(), oCmp);
+    }
+    if( oCmp(oFeature, aoLargest.front()) )
+    {
+        std::pop_heap(aoLargest.begin(), aoLargest.end(), oCmp);
+        poJob->nFeaturesSize -= sizeof(MVTTempFeature) +
+                                aoLargest.back().osFeature.size();
+        poJob->nFeaturesSize += nFeatureSize;
+        aoLargest.back() = std::move(oFeature);
+        std::push_heap(aoLargest.begin(), aoLargest.end(), oCmp);
+    }
 }
 
 /************************************************************************/
@@ -5223,43 +5767,45 @@ bool OGRMVTWriterDataset::CreateOutput()
         return GenerateMetadata(0, oMapLayerProps);
     }
 
-    CPLDebug("MVT", "Building output file from temporary database...");
-
-    sqlite3_stmt* hStmtZXY = nullptr;
-    CPL_IGNORE_RET_VAL(
-        sqlite3_prepare_v2( m_hDB,
-            "SELECT DISTINCT z, x, y FROM temp ORDER BY z, x, y",
-            -1, &hStmtZXY, nullptr) );
-    if( hStmtZXY == nullptr )
-    {
-        CPLError(CE_Failure, CPLE_AppDefined, "Prepared statement failed");
-        return false;
-    }
-
-    sqlite3_stmt* hStmtLayer = nullptr;
-    CPL_IGNORE_RET_VAL(
-        sqlite3_prepare_v2( m_hDB,
-            "SELECT DISTINCT layer FROM temp "
-            "WHERE z = ? AND x = ? AND y = ? ORDER BY layer",
-            -1, &hStmtLayer, nullptr) );
-    if( hStmtLayer == nullptr )
+    sqlite3_stmt* hStmtFeatures = nullptr;
+    if( m_poTempSorter )
     {
-        CPLError(CE_Failure, CPLE_AppDefined, "Prepared statement failed");
-        sqlite3_finalize(hStmtZXY);
-        return false;
+        CPLDebug("MVT", "Building output file from temporary sorted features...");
+        if( !m_poTempSorter->StartReading() )
+            return false;
     }
-    sqlite3_stmt* hStmtRows = nullptr;
-    CPL_IGNORE_RET_VAL(
-        sqlite3_prepare_v2( m_hDB,
-            "SELECT feature FROM temp "
-            "WHERE z = ? AND x = ? AND y = ? AND layer = ? ORDER BY idx",
-            -1, &hStmtRows, nullptr) );
-    if( hStmtRows == nullptr )
+    else
     {
-        CPLError(CE_Failure, CPLE_AppDefined, "Prepared statement failed");
-        sqlite3_finalize(hStmtZXY);
+        CPLDebug("MVT", "Building output file from temporary database...");
+
+        sqlite3_stmt* hStmtLayer = nullptr;
+        CPL_IGNORE_RET_VAL(
+            sqlite3_prepare_v2( m_hDB,
+                "SELECT DISTINCT layer FROM temp",
+                -1, &hStmtLayer, nullptr) );
+        if( hStmtLayer == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "Prepared statement failed");
+            return false;
+        }
+        while( sqlite3_step(hStmtLayer) == SQLITE_ROW )
+        {
+            const char* pszLayerName = reinterpret_cast<const char*>(
+                sqlite3_column_text(hStmtLayer, 0));
+            GetTempLayerIdx(pszLayerName ? pszLayerName : "");
+        }
         sqlite3_finalize(hStmtLayer);
-        return false;
+
+        CPL_IGNORE_RET_VAL(
+            sqlite3_prepare_v2( m_hDB,
+                "SELECT z, x, y, layer, idx, feature, area_or_length "
+                "FROM temp ORDER BY z, x, y, layer, idx",
+                -1, &hStmtFeatures, nullptr) );
+        if( hStmtFeatures == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "Prepared statement failed");
+            return false;
+        }
     }
 
     sqlite3_stmt* hInsertStmt = nullptr;
@@ -5273,9 +5819,8 @@ bool OGRMVTWriterDataset::CreateOutput()
         if( hInsertStmt == nullptr )
         {
             CPLError(CE_Failure, CPLE_AppDefined, "Prepared statement failed");
-            sqlite3_finalize(hStmtZXY);
-            sqlite3_finalize(hStmtLayer);
-            sqlite3_finalize(hStmtRows);
+            if( hStmtFeatures )
+                sqlite3_finalize(hStmtFeatures);
             return false;
         }
     }
@@ -5284,20 +5829,78 @@ bool OGRMVTWriterDataset::CreateOutput()
     int nLastX = -1;
     bool bRet = true;
     GIntBig nTempTilesRead = 0;
+    const GIntBig nProgressStep = std::max( static_cast<GIntBig>(1),
+                                            m_nTempTiles / 10 );
 
-    while( sqlite3_step(hStmtZXY) == SQLITE_ROW )
+    // Tiles are encoded by worker threads, and written in order by this
+    // thread, which also updates the layer statistics.
+    std::mutex oJobMutex;
+    std::condition_variable oJobCond;
+    std::deque<std::unique_ptr<MVTEncodeTileJob>> apoJobs;
+    size_t nPendingSize = 0;
+    const size_t nMaxPendingJobs = m_bThreadPoolOK ?
+        4 * static_cast<size_t>(m_oThreadPool.GetThreadCount()) : 1;
+
+    MVTTempFeature oNextFeature;
+    bool bHasNextFeature = ReadTempFeature(hStmtFeatures, oNextFeature);
+    while( true )
     {
-        int nZ = sqlite3_column_int(hStmtZXY, 0);
-        int nX = sqlite3_column_int(hStmtZXY, 1);
-        int nY = sqlite3_column_int(hStmtZXY, 2);
+        while( bHasNextFeature && apoJobs.size() < nMaxPendingJobs &&
+               (apoJobs.empty() || nPendingSize < knMAX_PENDING_TILES_SIZE) )
+        {
+            std::unique_ptr<MVTEncodeTileJob> poJob(new MVTEncodeTileJob());
+            poJob->poDS = this;
+            poJob->nZ = oNextFeature.nZ;
+            poJob->nX = oNextFeature.nX;
+            poJob->nY = oNextFeature.nY;
+            poJob->poMutex = &oJobMutex;
+            poJob->poCond = &oJobCond;
+            do
+            {
+                AddFeatureToTileJob(poJob.get(), std::move(oNextFeature));
 
-        std::string oTileBuffer(
-            EncodeTile(nZ, nX, nY,
-                       hStmtLayer,
-                       hStmtRows,
-                       oMapLayerProps,
-                       oSetLayers,
-                       nTempTilesRead));
+                nTempTilesRead ++;
+                if( nTempTilesRead == m_nTempTiles||
+                    (nTempTilesRead % nProgressStep) == 0 )
+                {
+                    const int nPct = static_cast<int>(
+                                        (100 * nTempTilesRead) / m_nTempTiles);
+                    CPLDebug("MVT", "%d%%...", nPct);
+                }
+
+                bHasNextFeature = ReadTempFeature(hStmtFeatures, oNextFeature);
+            }
+            while( bHasNextFeature &&
+                   oNextFeature.nZ == poJob->nZ &&
+                   oNextFeature.nX == poJob->nX &&
+                   oNextFeature.nY == poJob->nY );
+
+            nPendingSize += poJob->nFeaturesSize;
+            MVTEncodeTileJob* poJobRaw = poJob.get();
+            apoJobs.push_back(std::move(poJob));
+            if( !m_bThreadPoolOK ||
+                !m_oThreadPool.SubmitJob(EncodeTileJobFunc, poJobRaw) )
+            {
+                EncodeTileJobFunc(poJobRaw);
+            }
+        }
+        if( apoJobs.empty() )
+            break;
+
+        MVTEncodeTileJob* poJob = apoJobs.front().get();
+        {
+            std::unique_lock<std::mutex> oLock(oJobMutex);
+            while( !poJob->bDone )
+                oJobCond.wait(oLock);
+        }
+        nPendingSize -= poJob->nFeaturesSize;
+
+        const int nZ = poJob->nZ;
+        const int nX = poJob->nX;
+        const int nY = poJob->nY;
+        UpdateTileLayerProperties(nZ, poJob->apoLayers,
+                                  oMapLayerProps, oSetLayers);
+        const std::string& oTileBuffer = poJob->osTileBuffer;
 
         if( oTileBuffer.empty() )
         {
@@ -5349,6 +5952,7 @@ bool OGRMVTWriterDataset::CreateOutput()
                 bRet = false;
             }
         }
+        apoJobs.pop_front();
 
         if( !bRet )
         {
@@ -5357,9 +5961,15 @@ bool OGRMVTWriterDataset::CreateOutput()
             break;
         }
     }
-    sqlite3_finalize(hStmtZXY);
-    sqlite3_finalize(hStmtLayer);
-    sqlite3_finalize(hStmtRows);
+    // Wait for the jobs still running in case of error
+    if( m_bThreadPoolOK )
+        m_oThreadPool.WaitCompletion();
+    apoJobs.clear();
+
+    if( m_poTempSorter && m_poTempSorter->HasError() )
+        bRet = false;
+    if( hStmtFeatures )
+        sqlite3_finalize(hStmtFeatures);
     if( hInsertStmt )
         sqlite3_finalize(hInsertStmt);
 
@@ -5773,7 +6383,8 @@ OGRErr OGRMVTWriterDataset::WriteFeature(OGRMVTWriterLayer* poLayer,
 
     if( !m_oEnvelope.IsInit() )
     {
-        CPLDebug("MVT", "Creating temporary database...");
+        CPLDebug("MVT", m_poTempSorter ? "Pre-generating tile features..." :
+                                         "Creating temporary database...");
     }
 
     m_oEnvelope.Merge(sExtent);
@@ -5990,69 +6601,94 @@ GDALDataset* OGRMVTWriterDataset::Create( const char * pszFilename,
     poDS->m_pMyVFS = OGRSQLiteCreateVFS(nullptr, poDS);
     sqlite3_vfs_register(poDS->m_pMyVFS, 0);
 
-    CPLString osTempDBDefault = CPLString(pszFilename) + ".temp.db";
-    if( STARTS_WITH(osTempDBDefault, "/vsizip/") )
-    {
-        osTempDBDefault = CPLString(pszFilename + strlen("/vsizip/")) + ".temp.db";
+    CPLString osTempPrefix(pszFilename);
+    if( STARTS_WITH(osTempPrefix, "/vsizip/") )
+    {
+        osTempPrefix = pszFilename + strlen("/vsizip/");
+    }
+
+    // Unless a temporary database is explicitly requested (or must be
+    // reused), pre-generated features are sorted with an external merge sort
+    const char* pszTempDB = CSLFetchNameValue(papszOptions, "TEMPORARY_DB");
+    if( pszTempDB == nullptr && !bReuseTempFile )
+    {
+        const size_t nRunSize = static_cast<size_t>(std::max(
+            static_cast<GUIntBig>(1),
+            std::min(CPLScanUIntBig(CPLGetConfigOption(
+                            "OGR_MVT_SORT_RUN_SIZE",
+                            CPLSPrintf(CPL_FRMT_GUIB,
+                                static_cast<GUIntBig>(knDEFAULT_SORT_RUN_SIZE))),
+                                    20),
+                     static_cast<GUIntBig>(
+                         std::numeric_limits<size_t>::max() / 4))));
+        // The config option is only useful for testing
+        CPLString osTempSort(CPLGetConfigOption("OGR_MVT_SORT_TEMP_FILE",
+                                (osTempPrefix + ".temp.sort").c_str()));
+        VSIUnlink(osTempSort);
+        poDS->m_poTempSorter.reset(
+            new MVTTempFeatureSorter(poDS->m_aosTempLayerNames,
+                                     osTempSort, nRunSize));
     }
-    CPLString osTempDB =
-        CSLFetchNameValueDef(papszOptions, "TEMPORARY_DB",
-                             osTempDBDefault.c_str());
-    if( !bReuseTempFile )
-        VSIUnlink(osTempDB);
-
-    sqlite3* hDB = nullptr;
-    CPL_IGNORE_RET_VAL(sqlite3_open_v2(osTempDB, &hDB,
-                    SQLITE_OPEN_READWRITE |
-                    (bReuseTempFile ? 0 : SQLITE_OPEN_CREATE) |
-                    SQLITE_OPEN_NOMUTEX,
-                    poDS->m_pMyVFS->zName));
-    if( hDB == nullptr )
+    else
     {
-        CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s",
-                 osTempDB.c_str());
-        delete poDS;
-        return nullptr;
-    }
-    poDS->m_osTempDB = osTempDB;
-    poDS->m_hDB = hDB;
-    poDS->m_bReuseTempFile = bReuseTempFile;
+        CPLString osTempDB =
+            pszTempDB ? CPLString(pszTempDB) : osTempPrefix + ".temp.db";
+        if( !bReuseTempFile )
+            VSIUnlink(osTempDB);
 
-    // For Unix
-    if( !poDS->m_bReuseTempFile &&
-        CPLTestBool(CPLGetConfigOption("OGR_MVT_REMOVE_TEMP_FILE", "YES")) )
-    {
-        VSIUnlink(osTempDB);
-    }
+        sqlite3* hDB = nullptr;
+        CPL_IGNORE_RET_VAL(sqlite3_open_v2(osTempDB, &hDB,
+                        SQLITE_OPEN_READWRITE |
+                        (bReuseTempFile ? 0 : SQLITE_OPEN_CREATE) |
+                        SQLITE_OPEN_NOMUTEX,
+                        poDS->m_pMyVFS->zName));
+        if( hDB == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s",
+                     osTempDB.c_str());
+            delete poDS;
+            return nullptr;
+        }
+        poDS->m_osTempDB = osTempDB;
+        poDS->m_hDB = hDB;
+        poDS->m_bReuseTempFile = bReuseTempFile;
 
-    if( poDS->m_bReuseTempFile )
-    {
-        poDS->m_nTempTiles = SQLGetInteger64(
-            hDB, "SELECT COUNT(*) FROM temp", nullptr );
-    }
-    else
-    {
-        CPL_IGNORE_RET_VAL(SQLCommand(hDB,
-            "PRAGMA page_size = 4096;" // 4096: default since sqlite 3.12
-            "PRAGMA synchronous = OFF;"
-            "PRAGMA journal_mode = OFF;"
-            "PRAGMA temp_store = MEMORY;"
-            "CREATE TABLE temp(z INTEGER, x INTEGER, y INTEGER, layer TEXT, "
-            "idx INTEGER, feature BLOB, geomtype INTEGER, area_or_length DOUBLE);"
-            "CREATE INDEX temp_index ON temp (z, x, y, layer, idx);"));
-    }
+        // For Unix
+        if( !poDS->m_bReuseTempFile &&
+            CPLTestBool(CPLGetConfigOption("OGR_MVT_REMOVE_TEMP_FILE", "YES")) )
+        {
+            VSIUnlink(osTempDB);
+        }
 
-    sqlite3_stmt* hInsertStmt = nullptr;
-    CPL_IGNORE_RET_VAL(sqlite3_prepare_v2( hDB,
-        "INSERT INTO temp (z,x,y,layer,idx,feature,geomtype,area_or_length) "
-        "VALUES (?,?,?,?,?,?,?,?)",
-        -1, &hInsertStmt, nullptr) );
-    if( hInsertStmt == nullptr )
-    {
-        delete poDS;
-        return nullptr;
+        if( poDS->m_bReuseTempFile )
+        {
+            poDS->m_nTempTiles = SQLGetInteger64(
+                hDB, "SELECT COUNT(*) FROM temp", nullptr );
+        }
+        else
+        {
+            CPL_IGNORE_RET_VAL(SQLCommand(hDB,
+                "PRAGMA page_size = 4096;" // 4096: default since sqlite 3.12
+                "PRAGMA synchronous = OFF;"
+                "PRAGMA journal_mode = OFF;"
+                "PRAGMA temp_store = MEMORY;"
+                "CREATE TABLE temp(z INTEGER, x INTEGER, y INTEGER, layer TEXT, "
+                "idx INTEGER, feature BLOB, geomtype INTEGER, area_or_length DOUBLE);"
+                "CREATE INDEX temp_index ON temp (z, x, y, layer, idx);"));
+        }
+
+        sqlite3_stmt* hInsertStmt = nullptr;
+        CPL_IGNORE_RET_VAL(sqlite3_prepare_v2( hDB,
+            "INSERT INTO temp (z,x,y,layer,idx,feature,geomtype,area_or_length) "
+            "VALUES (?,?,?,?,?,?,?,?)",
+            -1, &hInsertStmt, nullptr) );
+        if( hInsertStmt == nullptr )
+        {
+            delete poDS;
+            return nullptr;
+        }
+        poDS->m_hInsertStmt = hInsertStmt;
     }
-    poDS->m_hInsertStmt = hInsertStmt;
 
     poDS->m_nMinZoom = atoi(CSLFetchNameValueDef(papszOptions, "MINZOOM",
                                         CPLSPrintf("%d",poDS->m_nMinZoom)));
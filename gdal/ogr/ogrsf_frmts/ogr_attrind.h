@@ -56,6 +56,11 @@ public:
     virtual OGRErr RemoveEntry( OGRField *psKey, GIntBig nFID ) = 0;
 
     virtual OGRErr Clear() = 0;
+
+    virtual bool      SupportsRangeQueries() const;
+    virtual GIntBig  *GetRangeMatches( const OGRField *psMin, bool bMinIncluded,
+                                       const OGRField *psMax, bool bMaxIncluded,
+                                       GIntBig &nFIDCount );
 };
 
 /************************************************************************/
@@ -90,6 +95,7 @@ public:
 };
 
 OGRLayerAttrIndex CPL_DLL *OGRCreateDefaultLayerIndex();
+OGRLayerAttrIndex CPL_DLL *OGRCreateSidecarLayerIndex();
 
 //! @endcond
 
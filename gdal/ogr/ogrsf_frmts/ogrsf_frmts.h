@@ -107,6 +107,9 @@ class CPL_DLL OGRLayer : public GDALMajorObject
     int          InstallFilter( OGRGeometry * );
 
     OGRErr       GetExtentInternal(int iGeomField, OGREnvelope *psExtent, int bForce );
+
+    bool         GetNextFeatureFromAttrIndex( OGRFeature *&poFeature );
+    void         ResetAttrIndexReading();
 //! @endcond
 
     virtual OGRErr      ISetFeature( OGRFeature *poFeature ) CPL_WARN_UNUSED_RESULT;
@@ -227,6 +230,11 @@ class CPL_DLL OGRLayer : public GDALMajorObject
                                char** papszOptions = nullptr,
                                GDALProgressFunc pfnProgress = nullptr,
                                void * pProgressArg = nullptr );
+    OGRErr              SpatialJoin( OGRLayer *pLayerMethod,
+                                     OGRLayer *pLayerResult,
+                                     char** papszOptions = nullptr,
+                                     GDALProgressFunc pfnProgress = nullptr,
+                                     void * pProgressArg = nullptr );
 
     int                 Reference();
     int                 Dereference();
@@ -243,6 +251,7 @@ class CPL_DLL OGRLayer : public GDALMajorObject
 
     /* consider these private */
     OGRErr               InitializeIndexSupport( const char * );
+    OGRErr               InitializeSidecarIndexSupport( const char * );
     OGRLayerAttrIndex   *GetIndex() { return m_poAttrIndex; }
     int                 GetGeomFieldFilter() const { return m_iGeomFieldFilter; }
     const char          *GetAttrQueryString() const { return m_pszAttrQueryString; }
@@ -46,6 +46,8 @@
 #define DO_NOT_INCLUDE_SQLITE_CLASSES
 #include "ogr_sqlite.h"
 
+class CPLWorkerThreadPool;
+
 class ConstCharComp
 {
     public:
@@ -329,6 +331,10 @@ class OGROSMDataSource final: public OGRDataSource
 
     LonLat             *pasLonLatCache;
 
+    // Minimum number of ways in a batch to resolve their nodes with the
+    // worker threads of the parser in ProcessWaysBatch()
+    int                 nMinWaysForThreadedResolution;
+
     bool                bReportAllNodes;
     bool                bReportAllWays;
 
@@ -439,7 +445,10 @@ class OGROSMDataSource final: public OGRDataSource
     bool                StartTransactionCacheDB();
     bool                CommitTransactionCacheDB();
 
-    int                 FindNode(GIntBig nID);
+    int                 FindNode(GIntBig nID) const;
+    unsigned int        ResolveWayNodes(const WayFeaturePair* psWayFeaturePairs,
+                                        LonLat* pasLonLat) const;
+    static void         ResolveWayNodesJob(void* pData);
     void                ProcessWaysBatch();
 
     void                ProcessPolygonsStandalone();
@@ -55,6 +55,7 @@
 #include "cpl_string.h"
 #include "cpl_time.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "ogr_api.h"
 #include "ogr_core.h"
 #include "ogr_feature.h"
@@ -257,6 +258,7 @@ OGROSMDataSource::OGROSMDataSource() :
     nMinSizeKeysInSetClosedWaysArePolygons(0),
     nMaxSizeKeysInSetClosedWaysArePolygons(0),
     pasLonLatCache(nullptr),
+    nMinWaysForThreadedResolution(1000),
     bReportAllNodes(false),
     bReportAllWays(false),
     bFeatureAdded(false),
@@ -1660,7 +1662,7 @@ void OGROSMDataSource::IndexWay(GIntBig nWayID, bool bIsArea,
 /*                              FindNode()                              */
 /************************************************************************/
 
-int OGROSMDataSource::FindNode(GIntBig nID)
+int OGROSMDataSource::FindNode(GIntBig nID) const
 {
     if( nReqIds == 0 )
         return -1;
@@ -1680,93 +1682,229 @@ int OGROSMDataSource::FindNode(GIntBig nID)
 }
 
 /************************************************************************/
-/*                         ProcessWaysBatch()                           */
+/*                          ResolveWayNodes()                           */
 /************************************************************************/
 
-void OGROSMDataSource::ProcessWaysBatch()
+// Fill pasLonLat with the coordinates of the nodes of the way that could
+// be found by LookupNodes(), and return their number. pasLonLat must be
+// able to hold psWayFeaturePairs->nRefs + 1 elements.
+unsigned int OGROSMDataSource::ResolveWayNodes(
+                                    const WayFeaturePair* psWayFeaturePairs,
+                                    LonLat* pasLonLat) const
 {
-    if( nWayFeaturePairs == 0 ) return;
-
-    //printf("nodes = %d, features = %d\n", nUnsortedReqIds, nWayFeaturePairs);
-    LookupNodes();
+    const EMULATED_BOOL bIsArea = psWayFeaturePairs->bIsArea;
 
-    for( int iPair = 0; iPair < nWayFeaturePairs; iPair ++)
-    {
-        WayFeaturePair* psWayFeaturePairs = &pasWayFeaturePairs[iPair];
-
-        const EMULATED_BOOL bIsArea = psWayFeaturePairs->bIsArea;
-
-        unsigned int nFound = 0;
+    unsigned int nFound = 0;
 
 #ifdef ENABLE_NODE_LOOKUP_BY_HASHING
-        if( bHashedIndexValid )
+    if( bHashedIndexValid )
+    {
+        for( unsigned int i=0;i<psWayFeaturePairs->nRefs;i++)
         {
-            for( unsigned int i=0;i<psWayFeaturePairs->nRefs;i++)
+            int nIndInHashArray = static_cast<int>(
+                HASH_ID_FUNC(psWayFeaturePairs->panNodeRefs[i]) %
+                    HASHED_INDEXES_ARRAY_SIZE);
+            int nIdx = panHashedIndexes[nIndInHashArray];
+            if( nIdx < -1 )
             {
-                int nIndInHashArray = static_cast<int>(
-                    HASH_ID_FUNC(psWayFeaturePairs->panNodeRefs[i]) %
-                        HASHED_INDEXES_ARRAY_SIZE);
-                int nIdx = panHashedIndexes[nIndInHashArray];
-                if( nIdx < -1 )
+                int iBucket = -nIdx - 2;
+                while( true )
                 {
-                    int iBucket = -nIdx - 2;
-                    while( true )
+                    nIdx = psCollisionBuckets[iBucket].nInd;
+                    if( panReqIds[nIdx] ==
+                        psWayFeaturePairs->panNodeRefs[i] )
+                        break;
+                    iBucket = psCollisionBuckets[iBucket].nNext;
+                    if( iBucket < 0 )
                     {
-                        nIdx = psCollisionBuckets[iBucket].nInd;
-                        if( panReqIds[nIdx] ==
-                            psWayFeaturePairs->panNodeRefs[i] )
-                            break;
-                        iBucket = psCollisionBuckets[iBucket].nNext;
-                        if( iBucket < 0 )
-                        {
-                            nIdx = -1;
-                            break;
-                        }
+                        nIdx = -1;
+                        break;
                     }
                 }
-                else if( nIdx >= 0 &&
-                         panReqIds[nIdx] != psWayFeaturePairs->panNodeRefs[i] )
-                    nIdx = -1;
+            }
+            else if( nIdx >= 0 &&
+                     panReqIds[nIdx] != psWayFeaturePairs->panNodeRefs[i] )
+                nIdx = -1;
 
-                if( nIdx >= 0 )
-                {
-                    pasLonLatCache[nFound].nLon = pasLonLatArray[nIdx].nLon;
-                    pasLonLatCache[nFound].nLat = pasLonLatArray[nIdx].nLat;
-                    nFound ++;
-                }
+            if( nIdx >= 0 )
+            {
+                pasLonLat[nFound].nLon = pasLonLatArray[nIdx].nLon;
+                pasLonLat[nFound].nLat = pasLonLatArray[nIdx].nLat;
+                nFound ++;
             }
         }
-        else
+    }
+    else
 #endif // ENABLE_NODE_LOOKUP_BY_HASHING
+    {
+        int nIdx = -1;
+        for( unsigned int i=0;i<psWayFeaturePairs->nRefs;i++)
         {
-            int nIdx = -1;
-            for( unsigned int i=0;i<psWayFeaturePairs->nRefs;i++)
+            if( nIdx >= 0 && psWayFeaturePairs->panNodeRefs[i] ==
+                             psWayFeaturePairs->panNodeRefs[i-1] + 1 )
             {
-                if( nIdx >= 0 && psWayFeaturePairs->panNodeRefs[i] ==
-                                 psWayFeaturePairs->panNodeRefs[i-1] + 1 )
-                {
-                    if( nIdx+1 < (int)nReqIds && panReqIds[nIdx+1] ==
-                                        psWayFeaturePairs->panNodeRefs[i] )
-                        nIdx ++;
-                    else
-                        nIdx = -1;
-                }
+                if( nIdx+1 < (int)nReqIds && panReqIds[nIdx+1] ==
+                                    psWayFeaturePairs->panNodeRefs[i] )
+                    nIdx ++;
                 else
-                    nIdx = FindNode( psWayFeaturePairs->panNodeRefs[i] );
-                if( nIdx >= 0 )
-                {
-                    pasLonLatCache[nFound].nLon = pasLonLatArray[nIdx].nLon;
-                    pasLonLatCache[nFound].nLat = pasLonLatArray[nIdx].nLat;
-                    nFound ++;
-                }
+                    nIdx = -1;
+            }
+            else
+                nIdx = FindNode( psWayFeaturePairs->panNodeRefs[i] );
+            if( nIdx >= 0 )
+            {
+                pasLonLat[nFound].nLon = pasLonLatArray[nIdx].nLon;
+                pasLonLat[nFound].nLat = pasLonLatArray[nIdx].nLat;
+                nFound ++;
+            }
+        }
+    }
+
+    if( nFound > 0 && bIsArea )
+    {
+        pasLonLat[nFound].nLon = pasLonLat[0].nLon;
+        pasLonLat[nFound].nLat = pasLonLat[0].nLat;
+        nFound ++;
+    }
+
+    return nFound;
+}
+
+/************************************************************************/
+/*                        ResolveWayNodesJob()                          */
+/************************************************************************/
+
+namespace {
+struct WayResolutionJob
+{
+    const OGROSMDataSource* poDS;
+    const WayFeaturePair*   pasWayFeaturePairs;
+    int                     iStart;
+    int                     iEnd;
+    LonLat*                 pasLonLat;
+    const size_t*           panLonLatOffsets;
+    unsigned int*           panFound;
+    OGRLineString**         papoLineStrings;
+};
+}
+
+void OGROSMDataSource::ResolveWayNodesJob(void* pData)
+{
+    const WayResolutionJob* psJob = static_cast<WayResolutionJob*>(pData);
+    for( int iPair = psJob->iStart; iPair < psJob->iEnd; iPair++ )
+    {
+        const WayFeaturePair* psWayFeaturePairs =
+            &psJob->pasWayFeaturePairs[iPair];
+        LonLat* pasLonLat = psJob->pasLonLat + psJob->panLonLatOffsets[iPair];
+        const unsigned int nFound =
+            psJob->poDS->ResolveWayNodes(psWayFeaturePairs, pasLonLat);
+        psJob->panFound[iPair] = nFound;
+        psJob->papoLineStrings[iPair] = nullptr;
+        if( nFound < 2 || psWayFeaturePairs->poFeature == nullptr )
+            continue;
+
+        OGRLineString* poLS = new OGRLineString();
+        poLS->setNumPoints(static_cast<int>(nFound));
+        for( unsigned int i=0;i<nFound;i++)
+        {
+            poLS->setPoint(i,
+                        INT_TO_DBL(pasLonLat[i].nLon),
+                        INT_TO_DBL(pasLonLat[i].nLat));
+        }
+        psJob->papoLineStrings[iPair] = poLS;
+    }
+}
+
+/************************************************************************/
+/*                         ProcessWaysBatch()                           */
+/************************************************************************/
+
+void OGROSMDataSource::ProcessWaysBatch()
+{
+    if( nWayFeaturePairs == 0 ) return;
+
+    //printf("nodes = %d, features = %d\n", nUnsortedReqIds, nWayFeaturePairs);
+    LookupNodes();
+
+    // Resolve the coordinates of the nodes of the ways, and build their
+    // geometries, with worker threads. Indexing and feature insertion are
+    // then done in the order of the ways.
+    std::vector<LonLat> asLonLatBatch;
+    std::vector<size_t> anLonLatOffsets;
+    std::vector<unsigned int> anFound;
+    std::vector<OGRLineString*> apoLineStrings;
+    // The pool of the parser is idle at that point, or busy decoding the
+    // next blocks, that we will also wait for.
+    CPLWorkerThreadPool* poWTP = OSM_GetWorkerThreadPool(psParser);
+    if( poWTP != nullptr &&
+        nWayFeaturePairs >= nMinWaysForThreadedResolution )
+    {
+        try
+        {
+            anLonLatOffsets.resize(nWayFeaturePairs);
+            size_t nTotal = 0;
+            for( int iPair = 0; iPair < nWayFeaturePairs; iPair ++)
+            {
+                anLonLatOffsets[iPair] = nTotal;
+                nTotal += pasWayFeaturePairs[iPair].nRefs + 1;
             }
+            asLonLatBatch.resize(nTotal);
+            anFound.resize(nWayFeaturePairs);
+            apoLineStrings.resize(nWayFeaturePairs);
         }
+        catch( const std::bad_alloc& )
+        {
+            anFound.clear();
+        }
+    }
+    if( !anFound.empty() )
+    {
+        const int nJobs = 4 * poWTP->GetThreadCount();
+        std::vector<WayResolutionJob> asJobs(nJobs);
+        std::vector<void*> ahJobs;
+        for( int i = 0; i < nJobs; i++ )
+        {
+            asJobs[i].poDS = this;
+            asJobs[i].pasWayFeaturePairs = pasWayFeaturePairs;
+            asJobs[i].iStart = static_cast<int>(
+                static_cast<GIntBig>(nWayFeaturePairs) * i / nJobs);
+            asJobs[i].iEnd = static_cast<int>(
+                static_cast<GIntBig>(nWayFeaturePairs) * (i + 1) / nJobs);
+            asJobs[i].pasLonLat = asLonLatBatch.data();
+            asJobs[i].panLonLatOffsets = anLonLatOffsets.data();
+            asJobs[i].panFound = anFound.data();
+            asJobs[i].papoLineStrings = apoLineStrings.data();
+            ahJobs.push_back(&asJobs[i]);
+        }
+        if( poWTP->SubmitJobs(ResolveWayNodesJob, ahJobs) )
+        {
+            poWTP->WaitCompletion();
+        }
+        else
+        {
+            for( int i = 0; i < nJobs; i++ )
+                ResolveWayNodesJob(&asJobs[i]);
+        }
+    }
+
+    for( int iPair = 0; iPair < nWayFeaturePairs; iPair ++)
+    {
+        WayFeaturePair* psWayFeaturePairs = &pasWayFeaturePairs[iPair];
+
+        const EMULATED_BOOL bIsArea = psWayFeaturePairs->bIsArea;
 
-        if( nFound > 0 && bIsArea )
+        LonLat* pasLonLat = pasLonLatCache;
+        unsigned int nFound = 0;
+        OGRLineString* poLS = nullptr;
+        if( !anFound.empty() )
+        {
+            pasLonLat = asLonLatBatch.data() + anLonLatOffsets[iPair];
+            nFound = anFound[iPair];
+            poLS = apoLineStrings[iPair];
+        }
+        else
         {
-            pasLonLatCache[nFound].nLon = pasLonLatCache[0].nLon;
-            pasLonLatCache[nFound].nLat = pasLonLatCache[0].nLat;
-            nFound ++;
+            nFound = ResolveWayNodes(psWayFeaturePairs, pasLonLat);
         }
 
         if( nFound < 2 )
@@ -1785,30 +1923,31 @@ void OGROSMDataSource::ProcessWaysBatch()
                      bIsArea != 0,
                      psWayFeaturePairs->nTags,
                      psWayFeaturePairs->pasTags,
-                     pasLonLatCache, (int)nFound,
+                     pasLonLat, (int)nFound,
                      &psWayFeaturePairs->sInfo);
         }
         else
             IndexWay(psWayFeaturePairs->nWayID, bIsArea != 0, 0, nullptr,
-                     pasLonLatCache, (int)nFound, nullptr);
+                     pasLonLat, (int)nFound, nullptr);
 
         if( psWayFeaturePairs->poFeature == nullptr )
         {
             continue;
         }
 
-        OGRLineString* poLS = new OGRLineString();
-        OGRGeometry* poGeom = poLS;
-
-        poLS->setNumPoints((int)nFound);
-        for( unsigned int i=0;i<nFound;i++)
+        if( poLS == nullptr )
         {
-            poLS->setPoint(i,
-                        INT_TO_DBL(pasLonLatCache[i].nLon),
-                        INT_TO_DBL(pasLonLatCache[i].nLat));
+            poLS = new OGRLineString();
+            poLS->setNumPoints((int)nFound);
+            for( unsigned int i=0;i<nFound;i++)
+            {
+                poLS->setPoint(i,
+                            INT_TO_DBL(pasLonLat[i].nLon),
+                            INT_TO_DBL(pasLonLat[i].nLat));
+            }
         }
 
-        psWayFeaturePairs->poFeature->SetGeometryDirectly(poGeom);
+        psWayFeaturePairs->poFeature->SetGeometryDirectly(poLS);
 
         if( nFound != psWayFeaturePairs->nRefs )
             CPLDebug("OSM", "For way " CPL_FRMT_GIB ", got only %d nodes instead of %d",
@@ -2841,6 +2980,10 @@ int OGROSMDataSource::Open( const char * pszFilename,
     if( bCompressNodes )
         CPLDebug("OSM", "Using compression for nodes DB");
 
+    // Only useful for testing
+    nMinWaysForThreadedResolution = std::max(1, atoi(CPLGetConfigOption(
+        "OSM_MIN_WAYS_FOR_THREADED_RESOLUTION", "1000")));
+
     nLayers = 5;
     papoLayers = static_cast<OGROSMLayer **>(
         CPLMalloc(nLayers * sizeof(OGROSMLayer*)) );
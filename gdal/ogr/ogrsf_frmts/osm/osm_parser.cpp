@@ -36,6 +36,7 @@
 #include <cstring>
 #include <algorithm>
 #include <exception>
+#include <new>
 #include <string>
 #include <vector>
 
@@ -122,6 +123,58 @@ typedef struct
     bool         bStatus;
 } DecompressionJob;
 
+typedef enum
+{
+    DECODED_NODES,
+    DECODED_WAY,
+    DECODED_RELATION
+} DecodedEventType;
+
+typedef struct
+{
+    DecodedEventType eType;
+    size_t           nIdx;
+    unsigned int     nCount;
+} DecodedEvent;
+
+// Offsets of the variable size arrays of an entity in the arrays of
+// DecodedBlock, while those are being filled.
+typedef struct
+{
+    size_t nTagsIdx;
+    size_t nItemsIdx; // node references or members
+} DecodedOffsets;
+
+typedef struct
+{
+    CPLErr      eErrClass;
+    CPLErrorNum nErrNo;
+    std::string osMsg;
+} DecodedError;
+
+// Result of the decoding of a BLOB_OSMDATA block by a worker thread, that is
+// replayed to the user callbacks in the order of the file.
+struct DecodedBlock
+{
+    OSMContext                 *psCtxt = nullptr; // decoding context
+    const DecompressionJob     *psJob = nullptr;
+    bool                        bStatus = false;
+
+    std::vector<DecodedEvent>   asEvents{};
+    std::vector<OSMNode>        asNodes{};
+    std::vector<OSMWay>         asWays{};
+    std::vector<OSMRelation>    asRelations{};
+    std::vector<OSMTag>         asTags{};
+    std::vector<GIntBig>        anNodeRefs{};
+    std::vector<OSMMember>      asMembers{};
+    std::vector<DecodedOffsets> asNodeOffsets{};
+    std::vector<DecodedOffsets> asWayOffsets{};
+    std::vector<DecodedOffsets> asRelationOffsets{};
+    std::vector<DecodedError>   aoErrors{};
+
+    void Clear();
+};
+
 struct _OSMContext
 {
     char          *pszStrBuf;
@@ -164,6 +217,14 @@ struct _OSMContext
     int              nJobs;
     int              iNextJob;
 
+    // Parallel decoding of BLOB_OSMDATA blocks, by waves of nDecodeWave
+    // jobs. 2 * nDecodeWave blocks so that a wave can be decoded while the
+    // previous one is replayed.
+    DecodedBlock    *pasDecodedBlocks;
+    int              nDecodeWave;
+    int              nDecodeSubmittedEnd;
+    int              nDecodeCompletedEnd;
+
 #ifdef HAVE_EXPAT
     XML_Parser     hXMLParser;
     bool           bEOF;
@@ -1640,6 +1701,8 @@ static void DecompressFunction(void* pDataIn)
 static bool RunDecompressionJobs(OSMContext* psCtxt)
 {
     psCtxt->nTotalUncompressedSize = 0;
+    psCtxt->nDecodeSubmittedEnd = 0;
+    psCtxt->nDecodeCompletedEnd = 0;
 
     GByte* pabyDstBase = psCtxt->pabyUncompressed;
     std::vector<void*> ahJobs;
@@ -1712,6 +1775,248 @@ static bool RunDecompressionJobsAndProcessAll(OSMContext* psCtxt,
     return true;
 }
 
+/************************************************************************/
+/*                        DecodedBlock::Clear()                         */
+/************************************************************************/
+
+void DecodedBlock::Clear()
+{
+    psJob = nullptr;
+    bStatus = false;
+    asEvents.clear();
+    asNodes.clear();
+    asWays.clear();
+    asRelations.clear();
+    asTags.clear();
+    anNodeRefs.clear();
+    asMembers.clear();
+    asNodeOffsets.clear();
+    asWayOffsets.clear();
+    asRelationOffsets.clear();
+    aoErrors.clear();
+}
+
+/************************************************************************/
+/*                          RecordNodesFunc()                           */
+/************************************************************************/
+
+static void RecordNodesFunc( unsigned int nNodes, OSMNode* pasNodes,
+                             OSMContext* /* psCtxt */, void* user_data )
+{
+    DecodedBlock* psBlock = static_cast<DecodedBlock*>(user_data);
+    DecodedEvent sEvent;
+    sEvent.eType = DECODED_NODES;
+    sEvent.nIdx = psBlock->asNodes.size();
+    sEvent.nCount = nNodes;
+    psBlock->asEvents.push_back(sEvent);
+    for( unsigned int i = 0; i < nNodes; i++ )
+    {
+        DecodedOffsets sOffsets;
+        sOffsets.nTagsIdx = psBlock->asTags.size();
+        sOffsets.nItemsIdx = 0;
+        psBlock->asNodeOffsets.push_back(sOffsets);
+        psBlock->asNodes.push_back(pasNodes[i]);
+        psBlock->asTags.insert(psBlock->asTags.end(), pasNodes[i].pasTags,
+                               pasNodes[i].pasTags + pasNodes[i].nTags);
+    }
+}
+
+/************************************************************************/
+/*                           RecordWayFunc()                            */
+/************************************************************************/
+
+static void RecordWayFunc( OSMWay* psWay,
+                           OSMContext* /* psCtxt */, void* user_data )
+{
+    DecodedBlock* psBlock = static_cast<DecodedBlock*>(user_data);
+    DecodedEvent sEvent;
+    sEvent.eType = DECODED_WAY;
+    sEvent.nIdx = psBlock->asWays.size();
+    sEvent.nCount = 1;
+    psBlock->asEvents.push_back(sEvent);
+    DecodedOffsets sOffsets;
+    sOffsets.nTagsIdx = psBlock->asTags.size();
+    sOffsets.nItemsIdx = psBlock->anNodeRefs.size();
+    psBlock->asWayOffsets.push_back(sOffsets);
+    psBlock->asWays.push_back(*psWay);
+    psBlock->asTags.insert(psBlock->asTags.end(), psWay->pasTags,
+                           psWay->pasTags + psWay->nTags);
+    psBlock->anNodeRefs.insert(psBlock->anNodeRefs.end(), psWay->panNodeRefs,
+                               psWay->panNodeRefs + psWay->nRefs);
+}
+
+/************************************************************************/
+/*                         RecordRelationFunc()                         */
+/************************************************************************/
+
+static void RecordRelationFunc( OSMRelation* psRelation,
+                                OSMContext* /* psCtxt */, void* user_data )
+{
+    DecodedBlock* psBlock = static_cast<DecodedBlock*>(user_data);
+    DecodedEvent sEvent;
+    sEvent.eType = DECODED_RELATION;
+    sEvent.nIdx = psBlock->asRelations.size();
+    sEvent.nCount = 1;
+    psBlock->asEvents.push_back(sEvent);
+    DecodedOffsets sOffsets;
+    sOffsets.nTagsIdx = psBlock->asTags.size();
+    sOffsets.nItemsIdx = psBlock->asMembers.size();
+    psBlock->asRelationOffsets.push_back(sOffsets);
+    psBlock->asRelations.push_back(*psRelation);
+    psBlock->asTags.insert(psBlock->asTags.end(), psRelation->pasTags,
+                           psRelation->pasTags + psRelation->nTags);
+    psBlock->asMembers.insert(psBlock->asMembers.end(),
+                              psRelation->pasMembers,
+                              psRelation->pasMembers + psRelation->nMembers);
+}
+
+/************************************************************************/
+/*                       DecodeErrorHandler()                           */
+/************************************************************************/
+
+static void CPL_STDCALL DecodeErrorHandler( CPLErr eErrClass,
+                                            CPLErrorNum nErrNo,
+                                            const char* pszMsg )
+{
+    if( eErrClass == CE_Debug )
+        return;
+    DecodedBlock* psBlock = static_cast<DecodedBlock*>(CPLGetErrorHandlerUserData());
+    DecodedError sError;
+    sError.eErrClass = eErrClass;
+    sError.nErrNo = nErrNo;
+    sError.osMsg = pszMsg;
+    psBlock->aoErrors.push_back(sError);
+}
+
+/************************************************************************/
+/*                           DecodeFunction()                           */
+/************************************************************************/
+
+static void DecodeFunction( void* pDataIn )
+{
+    DecodedBlock* psBlock = static_cast<DecodedBlock*>(pDataIn);
+
+    // Errors are emitted again by the main thread when the block is replayed
+    CPLPushErrorHandlerEx(DecodeErrorHandler, psBlock);
+    try
+    {
+        psBlock->bStatus = ReadPrimitiveBlock(
+            psBlock->psJob->pabyDstBase + psBlock->psJob->nDstOffset,
+            psBlock->psJob->pabyDstBase + psBlock->psJob->nDstOffset +
+                psBlock->psJob->nDstSize,
+            psBlock->psCtxt);
+    }
+    catch( const std::exception& e )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "%s", e.what());
+        psBlock->bStatus = false;
+    }
+    CPLPopErrorHandler();
+
+    // The arrays are not resized any more: turn offsets into pointers
+    for( size_t i = 0; i < psBlock->asNodes.size(); i++ )
+    {
+        psBlock->asNodes[i].pasTags =
+            psBlock->asTags.data() + psBlock->asNodeOffsets[i].nTagsIdx;
+    }
+    for( size_t i = 0; i < psBlock->asWays.size(); i++ )
+    {
+        psBlock->asWays[i].pasTags =
+            psBlock->asTags.data() + psBlock->asWayOffsets[i].nTagsIdx;
+        psBlock->asWays[i].panNodeRefs =
+            psBlock->anNodeRefs.data() + psBlock->asWayOffsets[i].nItemsIdx;
+    }
+    for( size_t i = 0; i < psBlock->asRelations.size(); i++ )
+    {
+        psBlock->asRelations[i].pasTags =
+            psBlock->asTags.data() + psBlock->asRelationOffsets[i].nTagsIdx;
+        psBlock->asRelations[i].pasMembers =
+            psBlock->asMembers.data() +
+                psBlock->asRelationOffsets[i].nItemsIdx;
+    }
+}
+
+/************************************************************************/
+/*                         SubmitDecodingWave()                         */
+/************************************************************************/
+
+static void SubmitDecodingWave( OSMContext* psCtxt, int iFirstJob )
+{
+    const int iEnd = std::min(psCtxt->nJobs, iFirstJob + psCtxt->nDecodeWave);
+    std::vector<void*> ahBlocks;
+    for( int i = iFirstJob; i < iEnd; i++ )
+    {
+        DecodedBlock* psBlock =
+            &psCtxt->pasDecodedBlocks[i % (2 * psCtxt->nDecodeWave)];
+        psBlock->Clear();
+        psBlock->psJob = &psCtxt->asJobs[i];
+        ahBlocks.push_back(psBlock);
+    }
+    if( !psCtxt->poWTP->SubmitJobs(DecodeFunction, ahBlocks) )
+    {
+        for( size_t i = 0; i < ahBlocks.size(); i++ )
+            DecodeFunction(ahBlocks[i]);
+    }
+    psCtxt->nDecodeSubmittedEnd = iEnd;
+}
+
+/************************************************************************/
+/*                          ProcessJobBlob()                            */
+/************************************************************************/
+
+// Process the blob of job iJob, that must be called in increasing order of
+// iJob. In the multi-threaded case, blobs are decoded by waves ahead of
+// their processing, and the result of the decoding is then forwarded to
+// the user callbacks in the order of the file.
+static bool ProcessJobBlob( OSMContext* psCtxt, int iJob, BlobType eType )
+{
+    if( eType != BLOB_OSMDATA || psCtxt->pasDecodedBlocks == nullptr )
+        return ProcessSingleBlob(psCtxt, psCtxt->asJobs[iJob], eType);
+
+    if( iJob >= psCtxt->nDecodeSubmittedEnd )
+        SubmitDecodingWave(psCtxt, iJob);
+    if( iJob >= psCtxt->nDecodeCompletedEnd )
+    {
+        psCtxt->poWTP->WaitCompletion();
+        psCtxt->nDecodeCompletedEnd = psCtxt->nDecodeSubmittedEnd;
+        if( psCtxt->nDecodeSubmittedEnd < psCtxt->nJobs )
+            SubmitDecodingWave(psCtxt, psCtxt->nDecodeSubmittedEnd);
+    }
+
+    DecodedBlock* psBlock =
+        &psCtxt->pasDecodedBlocks[iJob % (2 * psCtxt->nDecodeWave)];
+    CPLAssert( psBlock->psJob == &psCtxt->asJobs[iJob] );
+    for( size_t i = 0; i < psBlock->asEvents.size(); i++ )
+    {
+        const DecodedEvent& sEvent = psBlock->asEvents[i];
+        if( sEvent.eType == DECODED_NODES )
+        {
+            psCtxt->pfnNotifyNodes(sEvent.nCount,
+                                   psBlock->asNodes.data() + sEvent.nIdx,
+                                   psCtxt, psCtxt->user_data);
+        }
+        else if( sEvent.eType == DECODED_WAY )
+        {
+            psCtxt->pfnNotifyWay(&psBlock->asWays[sEvent.nIdx],
+                                 psCtxt, psCtxt->user_data);
+        }
+        else
+        {
+            psCtxt->pfnNotifyRelation(&psBlock->asRelations[sEvent.nIdx],
+                                      psCtxt, psCtxt->user_data);
+        }
+    }
+    for( size_t i = 0; i < psBlock->aoErrors.size(); i++ )
+    {
+        CPLError(psBlock->aoErrors[i].eErrClass,
+                 psBlock->aoErrors[i].nErrNo, "%s",
+                 psBlock->aoErrors[i].osMsg.c_str());
+    }
+    const bool bRet = psBlock->bStatus;
+    psBlock->Clear();
+    return bRet;
+}
+
 /************************************************************************/
 /*                              ReadBlob()                              */
 /************************************************************************/
@@ -1872,7 +2177,7 @@ bool ReadBlob( OSMContext* psCtxt, BlobType eType )
                 THROW_OSM_PARSING_EXCEPTION;
             }
             // Just process one blob at a time
-            if( !ProcessSingleBlob(psCtxt, psCtxt->asJobs[0], eType) )
+            if( !ProcessJobBlob(psCtxt, 0, eType) )
             {
                 THROW_OSM_PARSING_EXCEPTION;
             }
@@ -1898,9 +2203,7 @@ static OSMRetCode PBF_ProcessBlock(OSMContext* psCtxt)
     // Process any remaining queued jobs one by one
     if (psCtxt->iNextJob < psCtxt->nJobs)
     {
-        if( !(ProcessSingleBlob(psCtxt,
-                                psCtxt->asJobs[psCtxt->iNextJob],
-                                BLOB_OSMDATA)) )
+        if( !ProcessJobBlob(psCtxt, psCtxt->iNextJob, BLOB_OSMDATA) )
         {
             return OSM_ERROR;
         }
@@ -2615,6 +2918,61 @@ static OSMRetCode XML_ProcessBlock(OSMContext* psCtxt)
 
 #endif
 
+/************************************************************************/
+/*                       DestroyDecodedBlocks()                         */
+/************************************************************************/
+
+static void DestroyDecodedBlocks( OSMContext* psCtxt )
+{
+    if( psCtxt->pasDecodedBlocks == nullptr )
+        return;
+    for( int i = 0; i < 2 * psCtxt->nDecodeWave; i++ )
+    {
+        OSMContext* psDecodeCtxt = psCtxt->pasDecodedBlocks[i].psCtxt;
+        if( psDecodeCtxt == nullptr )
+            continue;
+        VSIFree(psDecodeCtxt->panStrOff);
+        VSIFree(psDecodeCtxt->pasNodes);
+        VSIFree(psDecodeCtxt->pasTags);
+        VSIFree(psDecodeCtxt->pasMembers);
+        VSIFree(psDecodeCtxt->panNodeRefs);
+        VSIFree(psDecodeCtxt);
+    }
+    delete[] psCtxt->pasDecodedBlocks;
+    psCtxt->pasDecodedBlocks = nullptr;
+    psCtxt->nDecodeWave = 0;
+}
+
+/************************************************************************/
+/*                        CreateDecodedBlocks()                         */
+/************************************************************************/
+
+static void CreateDecodedBlocks( OSMContext* psCtxt )
+{
+    const int nBlocks = 2 * psCtxt->poWTP->GetThreadCount();
+    psCtxt->pasDecodedBlocks = new (std::nothrow) DecodedBlock[nBlocks];
+    if( psCtxt->pasDecodedBlocks == nullptr )
+        return;
+    psCtxt->nDecodeWave = nBlocks / 2;
+    for( int i = 0; i < nBlocks; i++ )
+    {
+        OSMContext* psDecodeCtxt = static_cast<OSMContext *>(
+            VSI_CALLOC_VERBOSE(1, sizeof(OSMContext)) );
+        if( psDecodeCtxt == nullptr )
+        {
+            DestroyDecodedBlocks(psCtxt);
+            return;
+        }
+        psDecodeCtxt->bPBF = true;
+        psDecodeCtxt->pfnNotifyNodes = RecordNodesFunc;
+        psDecodeCtxt->pfnNotifyWay = RecordWayFunc;
+        psDecodeCtxt->pfnNotifyRelation = RecordRelationFunc;
+        psDecodeCtxt->pfnNotifyBounds = EmptyNotifyBoundsFunc;
+        psDecodeCtxt->user_data = &psCtxt->pasDecodedBlocks[i];
+        psCtxt->pasDecodedBlocks[i].psCtxt = psDecodeCtxt;
+    }
+}
+
 /************************************************************************/
 /*                              OSM_Open()                              */
 /************************************************************************/
@@ -2768,6 +3126,10 @@ OSMContext* OSM_Open( const char* pszFilename,
             delete psCtxt->poWTP;
             psCtxt->poWTP = nullptr;
         }
+        else if( bPBF )
+        {
+            CreateDecodedBlocks(psCtxt);
+        }
     }
 
     return psCtxt;
@@ -2782,6 +3144,10 @@ void OSM_Close(OSMContext* psCtxt)
     if( psCtxt == nullptr )
         return;
 
+    // Wait for pending decoding jobs, that use the uncompressed buffer
+    if( psCtxt->poWTP )
+        psCtxt->poWTP->WaitCompletion();
+
 #ifdef HAVE_EXPAT
     if( !psCtxt->bPBF )
     {
@@ -2800,6 +3166,7 @@ void OSM_Close(OSMContext* psCtxt)
     VSIFree(psCtxt->pasTags);
     VSIFree(psCtxt->pasMembers);
     VSIFree(psCtxt->panNodeRefs);
+    DestroyDecodedBlocks(psCtxt);
     delete psCtxt->poWTP;
 
     VSIFCloseL(psCtxt->fp);
@@ -2813,9 +3180,16 @@ void OSM_ResetReading( OSMContext* psCtxt )
 {
     VSIFSeekL(psCtxt->fp, 0, SEEK_SET);
 
+    // Wait for the decoding of blobs of the current batch that might be
+    // in progress
+    if( psCtxt->poWTP )
+        psCtxt->poWTP->WaitCompletion();
+
     psCtxt->nBytesRead = 0;
     psCtxt->nJobs = 0;
     psCtxt->iNextJob = 0;
+    psCtxt->nDecodeSubmittedEnd = 0;
+    psCtxt->nDecodeCompletedEnd = 0;
     psCtxt->nBlobOffset = 0;
     psCtxt->nBlobSize = 0;
     psCtxt->nTotalUncompressedSize = 0;
@@ -2868,3 +3242,12 @@ GUIntBig OSM_GetBytesRead( OSMContext* psCtxt )
 {
     return psCtxt->nBytesRead;
 }
+
+/************************************************************************/
+/*                      OSM_GetWorkerThreadPool()                       */
+/************************************************************************/
+
+CPLWorkerThreadPool* OSM_GetWorkerThreadPool( OSMContext* psCtxt )
+{
+    return psCtxt->poWTP;
+}
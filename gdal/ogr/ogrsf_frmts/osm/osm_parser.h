@@ -33,6 +33,8 @@
 #include "cpl_port.h"
 /* typedef long long GIntBig; */
 
+class CPLWorkerThreadPool;
+
 CPL_C_START
 
 typedef struct
@@ -128,6 +130,8 @@ OSMRetCode OSM_ProcessBlock( OSMContext* psOSMContext );
 
 void OSM_Close( OSMContext* psOSMContext );
 
+CPLWorkerThreadPool* OSM_GetWorkerThreadPool( OSMContext* psOSMContext );
+
 CPL_C_END
 
 #endif /*  OSM_PARSER_H_INCLUDED */
@@ -40,9 +40,12 @@
 #include "shapefil.h"
 #include "shp_vsi.h"
 #include "ogrlayerpool.h"
+#include <memory>
 #include <set>
 #include <vector>
 
+class CPLWorkerThreadPool;
+
 /* Was limited to 255 until OGR 1.10, but 254 seems to be a more */
 /* conventional limit (http://en.wikipedia.org/wiki/Shapefile, */
 /* http://www.clicketyclick.dk/databases/xbase/format/data_types.html, */
@@ -64,7 +67,8 @@ OGRErr SHPWriteOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
                            OGRFeatureDefn *poFeatureDefn,
                            OGRFeature *poFeature, const char *pszSHPEncoding,
                            bool* pbTruncationWarningEmitted,
-                           bool bRewind );
+                           bool bRewind,
+                           bool bWholeRecord );
 
 /************************************************************************/
 /*                         OGRShapeGeomFieldDefn                        */
@@ -104,6 +108,7 @@ class OGRShapeGeomFieldDefn final: public OGRGeomFieldDefn
 /************************************************************************/
 
 class OGRShapeDataSource;
+struct OGRShapeReadBatch;
 
 class OGRShapeLayer final: public OGRAbstractProxiedLayer
 {
@@ -174,6 +179,7 @@ class OGRShapeLayer final: public OGRAbstractProxiedLayer
 
     bool                bCreateSpatialIndexAtClose;
     bool                bRewindOnWrite;
+    bool                m_bWriteWholeDBFRecord;
 
     bool                m_bAutoRepack;
     typedef enum
@@ -189,6 +195,20 @@ class OGRShapeLayer final: public OGRAbstractProxiedLayer
 
     bool                StartUpdate( const char* pszOperation );
 
+    // Batched reading of sequential scans.
+    GIntBig             m_nReadChunkSize;
+    int                 m_nNumThreads = 1;
+    std::unique_ptr<CPLWorkerThreadPool> m_poWorkerThreadPool{};
+    std::unique_ptr<OGRShapeReadBatch> m_poReadBatch{};
+    std::unique_ptr<OGRShapeReadBatch> m_poPrefetchedBatch{};
+
+    GIntBig             GetFIDAtReadingPosition( int iPos ) const;
+    OGRShapeReadBatch  *ReadBatch( int iStartPos );
+    void                DecodeBatch( OGRShapeReadBatch *poBatch,
+                                     bool bWait );
+    bool                FetchBatchedFeature( OGRFeature **ppoFeature );
+    void                ClearReadBatches();
+
   protected:
 
     virtual void        CloseUnderlyingLayer() override;
@@ -211,6 +231,10 @@ class OGRShapeLayer final: public OGRAbstractProxiedLayer
     void                UpdateFollowingDeOrRecompression();
 
     OGRFeature *        FetchShape( int iShapeId );
+    static OGRFeature  *FetchShape( SHPHandle hSHPIn, DBFHandle hDBFIn,
+                                    OGRFeatureDefn *poDefn, int iShapeId,
+                                    const OGREnvelope *psFilterEnvelope,
+                                    const char *pszEncoding );
     int                 GetFeatureCountWithSpatialFilterOnly();
 
   public:
@@ -255,6 +279,7 @@ class OGRShapeLayer final: public OGRAbstractProxiedLayer
                 { OGRLayer::SetSpatialFilter(iGeomField, poGeom); }
 
     virtual OGRErr      SetAttributeFilter( const char * ) override;
+    virtual OGRErr      SetIgnoredFields( const char **papszFields ) override;
 
     void                AddToFileList( CPLStringList& oFileList );
     void                CreateSpatialIndexAtClose( int bFlag )
@@ -262,6 +287,8 @@ class OGRShapeLayer final: public OGRAbstractProxiedLayer
     void                SetModificationDate( const char* pszStr );
     void                SetAutoRepack(bool b) { m_bAutoRepack = b; }
     void                SetWriteDBFEOFChar(bool b);
+    void                SetNumThreads( int nNumThreads )
+        { m_nNumThreads = nNumThreads; }
 };
 
 /************************************************************************/
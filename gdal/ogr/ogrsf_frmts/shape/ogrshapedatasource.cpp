@@ -47,6 +47,7 @@
 #include "gdal_priv.h"
 #include "ogr_core.h"
 #include "ogr_geometry.h"
+#include "ogr_p.h"
 #include "ogr_spatialref.h"
 #include "ogrlayerpool.h"
 #include "ogrsf_frmts.h"
@@ -534,6 +535,7 @@ bool OGRShapeDataSource::OpenFile( const char *pszNewName, bool bUpdate )
         CPLFetchBool( papszOpenOptions, "AUTO_REPACK", true ) );
     poLayer->SetWriteDBFEOFChar(
         CPLFetchBool( papszOpenOptions, "DBF_EOF_CHAR", true ) );
+    poLayer->SetNumThreads( OGRGetNumThreads( papszOpenOptions ) );
 
 /* -------------------------------------------------------------------- */
 /*      Add layer to data source layer list.                            */
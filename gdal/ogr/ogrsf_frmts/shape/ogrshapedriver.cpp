@@ -347,6 +347,7 @@ void RegisterOGRShape()
 "  </Option>"
 "  <Option name='AUTO_REPACK' type='boolean' description='Whether the shapefile should be automatically repacked when needed' default='YES'/>"
 "  <Option name='DBF_EOF_CHAR' type='boolean' description='Whether to write the 0x1A end-of-file character in DBF files' default='YES'/>"
+"  <Option name='NUM_THREADS' type='string' description='Number of worker threads used to decode features when reading. Integer value or ALL_CPUS'/>"
 "</OpenOptionList>");
 
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
@@ -37,7 +37,10 @@
 #include <cstring>
 #include <ctime>
 #include <algorithm>
+#include <memory>
+#include <new>
 #include <string>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -46,6 +49,7 @@
 #include "cpl_string.h"
 #include "cpl_time.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "ogr_core.h"
 #include "ogr_feature.h"
 #include "ogr_geometry.h"
@@ -99,8 +103,11 @@ OGRShapeLayer::OGRShapeLayer( OGRShapeDataSource* poDSIn,
     bResizeAtClose(false),
     bCreateSpatialIndexAtClose(false),
     bRewindOnWrite(false),
+    m_bWriteWholeDBFRecord(true),
     m_bAutoRepack(false),
-    m_eNeedRepack(MAYBE)
+    m_eNeedRepack(MAYBE),
+    m_nReadChunkSize(CPLAtoGIntBig(
+        CPLGetConfigOption("SHAPE_READ_CHUNK_SIZE", "1048576")))
 {
     if( hSHP != nullptr )
     {
@@ -254,6 +261,9 @@ OGRShapeLayer::OGRShapeLayer( OGRShapeDataSource* poDSIn,
     SetDescription( poFeatureDefn->GetName() );
     bRewindOnWrite =
         CPLTestBool(CPLGetConfigOption( "SHAPE_REWIND_ON_WRITE", "YES" ));
+    // Only useful for testing the per-field path
+    m_bWriteWholeDBFRecord =
+        CPLTestBool(CPLGetConfigOption( "SHAPE_WRITE_WHOLE_DBF_RECORD", "YES" ));
 }
 
 /************************************************************************/
@@ -282,6 +292,7 @@ OGRShapeLayer::~OGRShapeLayer()
                   poFeatureDefn->GetName() );
     }
 
+    ClearReadBatches();
     ClearMatchingFIDs();
     ClearSpatialFIDs();
 
@@ -694,6 +705,8 @@ void OGRShapeLayer::ResetReading()
 
     iNextShapeId = 0;
 
+    ClearReadBatches();
+
     if( bHeaderDirty && bUpdateAccess )
         SyncToDisk();
 }
@@ -736,6 +749,7 @@ void OGRShapeLayer::ClearSpatialFIDs()
 void OGRShapeLayer::SetSpatialFilter( OGRGeometry * poGeomIn )
 {
     ClearMatchingFIDs();
+    ClearReadBatches();
 
     if( poGeomIn == nullptr )
     {
@@ -767,10 +781,24 @@ void OGRShapeLayer::SetSpatialFilter( OGRGeometry * poGeomIn )
 OGRErr OGRShapeLayer::SetAttributeFilter( const char * pszAttributeFilter )
 {
     ClearMatchingFIDs();
+    ClearReadBatches();
 
     return OGRLayer::SetAttributeFilter(pszAttributeFilter);
 }
 
+/************************************************************************/
+/*                          SetIgnoredFields()                          */
+/************************************************************************/
+
+OGRErr OGRShapeLayer::SetIgnoredFields( const char **papszFields )
+{
+    // Features of the read batches have been decoded with the previous
+    // set of ignored fields.
+    ClearReadBatches();
+
+    return OGRLayer::SetIgnoredFields(papszFields);
+}
+
 /************************************************************************/
 /*                           SetNextByIndex()                           */
 /*                                                                      */
@@ -793,6 +821,7 @@ OGRErr OGRShapeLayer::SetNextByIndex( GIntBig nIndex )
         return OGRLayer::SetNextByIndex( nIndex );
 
     iNextShapeId = static_cast<int>(nIndex);
+    ClearReadBatches();
 
     return OGRERR_NONE;
 }
@@ -806,12 +835,23 @@ OGRErr OGRShapeLayer::SetNextByIndex( GIntBig nIndex )
 
 OGRFeature *OGRShapeLayer::FetchShape( int iShapeId )
 
+{
+    return FetchShape( hSHP, hDBF, poFeatureDefn, iShapeId,
+                       m_poFilterGeom != nullptr ? &m_sFilterEnvelope : nullptr,
+                       osEncoding );
+}
+
+OGRFeature *OGRShapeLayer::FetchShape( SHPHandle hSHPIn, DBFHandle hDBFIn,
+                                       OGRFeatureDefn *poDefn, int iShapeId,
+                                       const OGREnvelope *psFilterEnvelope,
+                                       const char *pszEncoding )
+
 {
     OGRFeature *poFeature = nullptr;
 
-    if( m_poFilterGeom != nullptr && hSHP != nullptr )
+    if( psFilterEnvelope != nullptr && hSHPIn != nullptr )
     {
-        SHPObject *psShape = SHPReadObject( hSHP, iShapeId );
+        SHPObject *psShape = SHPReadObject( hSHPIn, iShapeId );
 
         // do not trust degenerate bounds on non-point geometries
         // or bounds on null shapes.
@@ -823,32 +863,515 @@ OGRFeature *OGRShapeLayer::FetchShape( int iShapeId )
                     || psShape->dfYMin == psShape->dfYMax))
             || psShape->nSHPType == SHPT_NULL )
         {
-            poFeature = SHPReadOGRFeature( hSHP, hDBF, poFeatureDefn,
-                                           iShapeId, psShape, osEncoding );
+            poFeature = SHPReadOGRFeature( hSHPIn, hDBFIn, poDefn,
+                                           iShapeId, psShape, pszEncoding );
         }
-        else if( m_sFilterEnvelope.MaxX < psShape->dfXMin
-                 || m_sFilterEnvelope.MaxY < psShape->dfYMin
-                 || psShape->dfXMax  < m_sFilterEnvelope.MinX
-                 || psShape->dfYMax < m_sFilterEnvelope.MinY )
+        else if( psFilterEnvelope->MaxX < psShape->dfXMin
+                 || psFilterEnvelope->MaxY < psShape->dfYMin
+                 || psShape->dfXMax  < psFilterEnvelope->MinX
+                 || psShape->dfYMax < psFilterEnvelope->MinY )
         {
             SHPDestroyObject(psShape);
             poFeature = nullptr;
         }
         else
         {
-            poFeature = SHPReadOGRFeature( hSHP, hDBF, poFeatureDefn,
-                                           iShapeId, psShape, osEncoding );
+            poFeature = SHPReadOGRFeature( hSHPIn, hDBFIn, poDefn,
+                                           iShapeId, psShape, pszEncoding );
         }
     }
     else
     {
-        poFeature = SHPReadOGRFeature( hSHP, hDBF, poFeatureDefn,
-                                       iShapeId, nullptr, osEncoding );
+        poFeature = SHPReadOGRFeature( hSHPIn, hDBFIn, poDefn,
+                                       iShapeId, nullptr, pszEncoding );
     }
 
     return poFeature;
 }
 
+/************************************************************************/
+/* ==================================================================== */
+/*      Batched reading.                                                */
+/*                                                                      */
+/*      Sequential scans, and scans of the FIDs returned by the         */
+/*      spatial or attribute indices, read the .shp and .dbf bytes of   */
+/*      many records at once with a few large reads, and decode them    */
+/*      into features (on worker threads with NUM_THREADS, while the    */
+/*      features of the previous batch are returned). Decoding works    */
+/*      on copies of the SHPInfo/DBFInfo handles whose I/O hooks serve  */
+/*      the in-memory bytes. Records that cannot be decoded from the    */
+/*      batch, or whose decoding emits any error or warning, are read   */
+/*      again through the regular code path when reached, so that      */
+/*      errors are reported as without batching.                        */
+/* ==================================================================== */
+/************************************************************************/
+
+// Maximum number of features decoded by a job.
+constexpr size_t knMAX_FEATURES_PER_JOB = 10000;
+
+// Records further away than that from the current range of a batch
+// start a new batch.
+constexpr SAOffset knMAX_GAP_IN_BATCH = 65536;
+
+namespace {
+
+enum
+{
+    BATCH_FEATURE_DECODED,   // Feature, or nullptr if skipped.
+    BATCH_FEATURE_FALLBACK   // Must be read through FetchShape().
+};
+
+struct ShapeDecodeJob
+{
+    OGRShapeReadBatch *poBatch = nullptr;
+    size_t             iStart = 0;
+    size_t             iEnd = 0;
+};
+
+} // namespace
+
+struct OGRShapeReadBatch
+{
+    int                       iStartPos = 0;
+    std::vector<int>          anFIDs{};
+    std::vector<GByte>        abyStatus{};
+    std::vector<OGRFeature *> apoFeatures{};
+
+    // Handles as of when the batch was read.
+    bool                      bHasSHP = false;
+    SHPInfo                   sSHPInfo{};
+    bool                      bHasDBF = false;
+    DBFInfo                   sDBFInfo{};
+    OGRFeatureDefn           *poDefn = nullptr;
+    bool                      bHasFilterEnvelope = false;
+    OGREnvelope               sFilterEnvelope{};
+    bool                      bSkipDeleted = false;
+    CPLString                 osEncoding{};
+
+    std::vector<GByte>        abySHPData{};
+    SAOffset                  nSHPDataOffset = 0;
+    std::vector<GByte>        abyDBFData{};
+    SAOffset                  nDBFDataOffset = 0;
+
+    std::vector<ShapeDecodeJob> asJobs{};
+
+    OGRShapeReadBatch() = default;
+    ~OGRShapeReadBatch()
+    {
+        for( auto poFeature: apoFeatures )
+            delete poFeature;
+    }
+
+    OGRShapeReadBatch(const OGRShapeReadBatch&) = delete;
+    OGRShapeReadBatch& operator=(const OGRShapeReadBatch&) = delete;
+};
+
+/************************************************************************/
+/*                       ShapeDecodeErrorHandler()                      */
+/************************************************************************/
+
+static void CPL_STDCALL ShapeDecodeErrorHandler( CPLErr eErr, CPLErrorNum,
+                                                 const char * )
+{
+    if( eErr != CE_Debug )
+        (*static_cast<int *>(CPLGetErrorHandlerUserData()))++;
+}
+
+/************************************************************************/
+/*                          ShapeDecodeFunc()                           */
+/************************************************************************/
+
+static void ShapeDecodeFunc( void *pData )
+{
+    ShapeDecodeJob *psJob = static_cast<ShapeDecodeJob *>(pData);
+    OGRShapeReadBatch *poBatch = psJob->poBatch;
+
+    // Private copies of the handles, reading from the batch bytes.
+    SHPInfo sSHPInfo;
+    SHPHandle hSHPJob = nullptr;
+    if( poBatch->bHasSHP )
+    {
+        sSHPInfo = poBatch->sSHPInfo;
+        sSHPInfo.sHooks = *VSI_SHP_GetBufferHook();
+        sSHPInfo.fpSHP = VSI_SHP_OpenBufferFile(
+            poBatch->abySHPData.data(), poBatch->nSHPDataOffset,
+            poBatch->abySHPData.size() );
+        sSHPInfo.fpSHX = nullptr;
+        sSHPInfo.pabyRec = nullptr;
+        sSHPInfo.nBufSize = 0;
+        sSHPInfo.pabyObjectBuf = nullptr;
+        sSHPInfo.nObjectBufSize = 0;
+        sSHPInfo.psCachedObject = nullptr;
+        hSHPJob = &sSHPInfo;
+        SHPSetFastModeReadObject( hSHPJob, TRUE );
+    }
+
+    DBFInfo sDBFInfo;
+    DBFHandle hDBFJob = nullptr;
+    if( poBatch->bHasDBF )
+    {
+        sDBFInfo = poBatch->sDBFInfo;
+        sDBFInfo.sHooks = *VSI_SHP_GetBufferHook();
+        sDBFInfo.fp = VSI_SHP_OpenBufferFile(
+            poBatch->abyDBFData.data(), poBatch->nDBFDataOffset,
+            poBatch->abyDBFData.size() );
+        sDBFInfo.nCurrentRecord = -1;
+        sDBFInfo.bCurrentRecordModified = FALSE;
+        sDBFInfo.pszCurrentRecord =
+            static_cast<char *>(malloc(sDBFInfo.nRecordLength));
+        sDBFInfo.nWorkFieldLength = 0;
+        sDBFInfo.pszWorkField = nullptr;
+        hDBFJob = &sDBFInfo;
+    }
+
+    {
+        CPLErrorStateBackuper oErrorStateBackuper;
+        int nErrors = 0;
+        CPLErrorHandlerPusher oErrorHandler(ShapeDecodeErrorHandler,
+                                            &nErrors);
+
+        for( size_t i = psJob->iStart; i < psJob->iEnd; i++ )
+        {
+            if( poBatch->abyStatus[i] != BATCH_FEATURE_DECODED )
+                continue;
+
+            const int iShape = poBatch->anFIDs[i];
+            const int nErrorsBefore = nErrors;
+            OGRFeature *poFeature = nullptr;
+            if( !(poBatch->bSkipDeleted && hDBFJob != nullptr &&
+                  DBFIsRecordDeleted(hDBFJob, iShape)) )
+            {
+                poFeature = OGRShapeLayer::FetchShape(
+                    hSHPJob, hDBFJob, poBatch->poDefn, iShape,
+                    poBatch->bHasFilterEnvelope ?
+                        &poBatch->sFilterEnvelope : nullptr,
+                    poBatch->osEncoding );
+            }
+            if( nErrors != nErrorsBefore )
+            {
+                delete poFeature;
+                poBatch->abyStatus[i] = BATCH_FEATURE_FALLBACK;
+            }
+            else
+            {
+                poBatch->apoFeatures[i] = poFeature;
+            }
+        }
+    }
+
+    if( hSHPJob != nullptr )
+    {
+        free(sSHPInfo.pabyRec);
+        free(sSHPInfo.pabyObjectBuf);
+        free(sSHPInfo.psCachedObject);
+        sSHPInfo.sHooks.FClose(sSHPInfo.fpSHP);
+    }
+    if( hDBFJob != nullptr )
+    {
+        free(sDBFInfo.pszCurrentRecord);
+        free(sDBFInfo.pszWorkField);
+        sDBFInfo.sHooks.FClose(sDBFInfo.fp);
+    }
+}
+
+/************************************************************************/
+/*                      GetFIDAtReadingPosition()                       */
+/*                                                                      */
+/*      Return the FID read at a given position of iMatchingFID or      */
+/*      iNextShapeId, or OGRNullFID past the end.                       */
+/************************************************************************/
+
+GIntBig OGRShapeLayer::GetFIDAtReadingPosition( int iPos ) const
+{
+    if( panMatchingFIDs != nullptr )
+        return panMatchingFIDs[iPos];
+    return iPos < nTotalShapeCount ? iPos : OGRNullFID;
+}
+
+/************************************************************************/
+/*                             ReadBatch()                              */
+/*                                                                      */
+/*      Read the .shp and .dbf bytes of the records starting at a       */
+/*      reading position, with one read per file. Returns nullptr if    */
+/*      no batch can be read.                                           */
+/************************************************************************/
+
+OGRShapeReadBatch *OGRShapeLayer::ReadBatch( int iStartPos )
+{
+    // Two jobs per thread, so that threads do not remain idle when
+    // records take uneven times to decode.
+    const size_t nJobs = m_poWorkerThreadPool != nullptr ?
+        2 * static_cast<size_t>(m_poWorkerThreadPool->GetThreadCount()) : 1;
+    const SAOffset nMaxSize = static_cast<SAOffset>(m_nReadChunkSize) * nJobs;
+    const size_t nMaxFeatures = knMAX_FEATURES_PER_JOB * nJobs;
+
+    std::unique_ptr<OGRShapeReadBatch> poBatch(new OGRShapeReadBatch());
+    poBatch->iStartPos = iStartPos;
+
+    SAOffset nSHPStart = 0;
+    SAOffset nSHPEnd = 0;
+    SAOffset nDBFStart = 0;
+    SAOffset nDBFEnd = 0;
+    for( int iPos = iStartPos;
+         poBatch->anFIDs.size() < nMaxFeatures; iPos++ )
+    {
+        const GIntBig nFID = GetFIDAtReadingPosition(iPos);
+        if( nFID == OGRNullFID )
+            break;
+
+        bool bDecodable = nFID >= 0 && nFID < nTotalShapeCount;
+        const int iShape = bDecodable ? static_cast<int>(nFID) : 0;
+
+        SAOffset nNewSHPStart = nSHPStart;
+        SAOffset nNewSHPEnd = nSHPEnd;
+        if( bDecodable && hSHP != nullptr )
+        {
+            const SAOffset nOffset = hSHP->panRecOffset[iShape];
+            const SAOffset nSize =
+                static_cast<SAOffset>(hSHP->panRecSize[iShape]) + 8;
+            if( iShape >= hSHP->nRecords || nOffset < 100 ||
+                nSize > nMaxSize )
+            {
+                bDecodable = false;
+            }
+            else if( nSHPEnd == 0 )
+            {
+                nNewSHPStart = nOffset;
+                nNewSHPEnd = nOffset + nSize;
+            }
+            else
+            {
+                if( nOffset > nSHPEnd + knMAX_GAP_IN_BATCH ||
+                    nOffset + nSize + knMAX_GAP_IN_BATCH < nSHPStart )
+                    break;
+                nNewSHPStart = std::min(nSHPStart, nOffset);
+                nNewSHPEnd = std::max(nSHPEnd, nOffset + nSize);
+                if( nNewSHPEnd - nNewSHPStart > nMaxSize )
+                    break;
+            }
+        }
+
+        SAOffset nNewDBFStart = nDBFStart;
+        SAOffset nNewDBFEnd = nDBFEnd;
+        if( bDecodable && hDBF != nullptr )
+        {
+            const SAOffset nOffset = hDBF->nHeaderLength +
+                static_cast<SAOffset>(hDBF->nRecordLength) * iShape;
+            const SAOffset nSize = hDBF->nRecordLength;
+            if( iShape >= hDBF->nRecords )
+            {
+                bDecodable = false;
+            }
+            else if( nDBFEnd == 0 )
+            {
+                nNewDBFStart = nOffset;
+                nNewDBFEnd = nOffset + nSize;
+            }
+            else
+            {
+                if( nOffset > nDBFEnd + knMAX_GAP_IN_BATCH ||
+                    nOffset + nSize + knMAX_GAP_IN_BATCH < nDBFStart )
+                    break;
+                nNewDBFStart = std::min(nDBFStart, nOffset);
+                nNewDBFEnd = std::max(nDBFEnd, nOffset + nSize);
+                if( nNewDBFEnd - nNewDBFStart > nMaxSize )
+                    break;
+            }
+        }
+
+        if( bDecodable )
+        {
+            nSHPStart = nNewSHPStart;
+            nSHPEnd = nNewSHPEnd;
+            nDBFStart = nNewDBFStart;
+            nDBFEnd = nNewDBFEnd;
+        }
+        poBatch->anFIDs.push_back(iShape);
+        poBatch->abyStatus.push_back(static_cast<GByte>(
+            bDecodable ? BATCH_FEATURE_DECODED : BATCH_FEATURE_FALLBACK));
+    }
+    if( poBatch->anFIDs.empty() )
+        return nullptr;
+
+    try
+    {
+        poBatch->apoFeatures.resize(poBatch->anFIDs.size());
+        poBatch->abySHPData.resize(static_cast<size_t>(nSHPEnd - nSHPStart));
+        poBatch->abyDBFData.resize(static_cast<size_t>(nDBFEnd - nDBFStart));
+    }
+    catch( const std::bad_alloc& )
+    {
+        return nullptr;
+    }
+
+    // Records that have not been read entirely (truncated files) are not
+    // decoded from the batch. After a short read, the file is seeked again
+    // so that its end-of-file indicator, that the regular code path
+    // checks, is cleared.
+    if( nSHPEnd > nSHPStart )
+    {
+        SAOffset nRead = 0;
+        if( hSHP->sHooks.FSeek(hSHP->fpSHP, nSHPStart, SEEK_SET) == 0 )
+            nRead = hSHP->sHooks.FRead(poBatch->abySHPData.data(), 1,
+                                       poBatch->abySHPData.size(),
+                                       hSHP->fpSHP);
+        hSHP->sHooks.FSeek(hSHP->fpSHP, nSHPStart, SEEK_SET);
+        poBatch->abySHPData.resize(static_cast<size_t>(nRead));
+        poBatch->nSHPDataOffset = nSHPStart;
+    }
+    if( nDBFEnd > nDBFStart )
+    {
+        SAOffset nRead = 0;
+        if( hDBF->sHooks.FSeek(hDBF->fp, nDBFStart, SEEK_SET) == 0 )
+            nRead = hDBF->sHooks.FRead(poBatch->abyDBFData.data(), 1,
+                                       poBatch->abyDBFData.size(),
+                                       hDBF->fp);
+        hDBF->sHooks.FSeek(hDBF->fp, nDBFStart, SEEK_SET);
+        poBatch->abyDBFData.resize(static_cast<size_t>(nRead));
+        poBatch->nDBFDataOffset = nDBFStart;
+    }
+
+    poBatch->bHasSHP = hSHP != nullptr;
+    if( hSHP != nullptr )
+        poBatch->sSHPInfo = *hSHP;
+    poBatch->bHasDBF = hDBF != nullptr;
+    if( hDBF != nullptr )
+        poBatch->sDBFInfo = *hDBF;
+    poBatch->poDefn = poFeatureDefn;
+    poBatch->bHasFilterEnvelope = m_poFilterGeom != nullptr;
+    poBatch->sFilterEnvelope = m_sFilterEnvelope;
+    poBatch->bSkipDeleted = panMatchingFIDs == nullptr;
+    poBatch->osEncoding = osEncoding;
+
+    return poBatch.release();
+}
+
+/************************************************************************/
+/*                            DecodeBatch()                             */
+/*                                                                      */
+/*      Decode the features of a batch, on worker threads if            */
+/*      possible, in which case bWait tells whether to wait for         */
+/*      completion.                                                     */
+/************************************************************************/
+
+void OGRShapeLayer::DecodeBatch( OGRShapeReadBatch *poBatch, bool bWait )
+{
+    const size_t nFeatures = poBatch->anFIDs.size();
+    const size_t nJobs = m_poWorkerThreadPool == nullptr ? 1 :
+        std::min(nFeatures,
+                 2 * static_cast<size_t>(
+                     m_poWorkerThreadPool->GetThreadCount()));
+
+    poBatch->asJobs.resize(nJobs);
+    std::vector<void *> apData;
+    for( size_t i = 0; i < nJobs; i++ )
+    {
+        poBatch->asJobs[i].poBatch = poBatch;
+        poBatch->asJobs[i].iStart = nFeatures * i / nJobs;
+        poBatch->asJobs[i].iEnd = nFeatures * (i + 1) / nJobs;
+        apData.push_back(&poBatch->asJobs[i]);
+    }
+
+    if( nJobs > 1 &&
+        m_poWorkerThreadPool->SubmitJobs(ShapeDecodeFunc, apData) )
+    {
+        if( bWait )
+            m_poWorkerThreadPool->WaitCompletion();
+        return;
+    }
+
+    for( auto pData: apData )
+        ShapeDecodeFunc(pData);
+}
+
+/************************************************************************/
+/*                        FetchBatchedFeature()                         */
+/*                                                                      */
+/*      Get the feature at the current reading position from the        */
+/*      read batches, reading new batches as needed. *ppoFeature is     */
+/*      set to nullptr if the record is skipped. Returns false if the   */
+/*      feature must be read by FetchShape().                           */
+/************************************************************************/
+
+bool OGRShapeLayer::FetchBatchedFeature( OGRFeature **ppoFeature )
+{
+    *ppoFeature = nullptr;
+
+    // Modifications are not reflected in batches, and lazily loaded .shx
+    // record offsets (/vsicurl/) are not known in advance.
+    if( m_nReadChunkSize <= 0 || bUpdateAccess ||
+        (hSHP != nullptr && hSHP->fpSHX != nullptr) )
+        return false;
+
+    const int iPos = panMatchingFIDs != nullptr ? iMatchingFID : iNextShapeId;
+    if( m_poReadBatch == nullptr ||
+        iPos < m_poReadBatch->iStartPos ||
+        iPos - m_poReadBatch->iStartPos >=
+            static_cast<int>(m_poReadBatch->anFIDs.size()) )
+    {
+        m_poReadBatch.reset();
+        if( m_poPrefetchedBatch != nullptr &&
+            m_poPrefetchedBatch->iStartPos == iPos )
+        {
+            m_poWorkerThreadPool->WaitCompletion();
+            m_poReadBatch = std::move(m_poPrefetchedBatch);
+        }
+        else
+        {
+            ClearReadBatches();
+            if( m_nNumThreads > 1 && m_poWorkerThreadPool == nullptr )
+            {
+                m_poWorkerThreadPool.reset(new CPLWorkerThreadPool());
+                if( !m_poWorkerThreadPool->Setup(m_nNumThreads,
+                                                 nullptr, nullptr) )
+                {
+                    m_poWorkerThreadPool.reset();
+                    m_nNumThreads = 1;
+                }
+            }
+            m_poReadBatch.reset(ReadBatch(iPos));
+            if( m_poReadBatch == nullptr )
+                return false;
+            DecodeBatch(m_poReadBatch.get(), true);
+        }
+
+        // Decode the next batch while the features of this one are
+        // consumed.
+        if( m_poWorkerThreadPool != nullptr )
+        {
+            const int iNextPos = m_poReadBatch->iStartPos +
+                static_cast<int>(m_poReadBatch->anFIDs.size());
+            if( GetFIDAtReadingPosition(iNextPos) != OGRNullFID )
+            {
+                m_poPrefetchedBatch.reset(ReadBatch(iNextPos));
+                if( m_poPrefetchedBatch != nullptr )
+                    DecodeBatch(m_poPrefetchedBatch.get(), false);
+            }
+        }
+    }
+
+    const size_t i = static_cast<size_t>(iPos - m_poReadBatch->iStartPos);
+    if( m_poReadBatch->abyStatus[i] != BATCH_FEATURE_DECODED )
+        return false;
+
+    *ppoFeature = m_poReadBatch->apoFeatures[i];
+    m_poReadBatch->apoFeatures[i] = nullptr;
+    m_poReadBatch->abyStatus[i] = BATCH_FEATURE_FALLBACK;
+    return true;
+}
+
+/************************************************************************/
+/*                          ClearReadBatches()                          */
+/************************************************************************/
+
+void OGRShapeLayer::ClearReadBatches()
+{
+    if( m_poPrefetchedBatch != nullptr )
+        m_poWorkerThreadPool->WaitCompletion();
+    m_poPrefetchedBatch.reset();
+    m_poReadBatch.reset();
+}
+
 /************************************************************************/
 /*                           GetNextFeature()                           */
 /************************************************************************/
@@ -886,8 +1409,9 @@ OGRFeature *OGRShapeLayer::GetNextFeature()
 
             // Check the shape object's geometry, and if it matches
             // any spatial filter, return it.
-            poFeature =
-                FetchShape(static_cast<int>(panMatchingFIDs[iMatchingFID]));
+            if( !FetchBatchedFeature(&poFeature) )
+                poFeature = FetchShape(
+                    static_cast<int>(panMatchingFIDs[iMatchingFID]));
 
             iMatchingFID++;
         }
@@ -898,7 +1422,11 @@ OGRFeature *OGRShapeLayer::GetNextFeature()
                 return nullptr;
             }
 
-            if( hDBF )
+            if( FetchBatchedFeature(&poFeature) )
+            {
+                // Deleted records have been skipped when decoding.
+            }
+            else if( hDBF )
             {
                 if( DBFIsRecordDeleted( hDBF, iNextShapeId ) )
                     poFeature = nullptr;
@@ -1022,7 +1550,7 @@ OGRErr OGRShapeLayer::ISetFeature( OGRFeature *poFeature )
 
     OGRErr eErr = SHPWriteOGRFeature( hSHP, hDBF, poFeatureDefn, poFeature,
                                       osEncoding, &bTruncationWarningEmitted,
-                                      bRewindOnWrite );
+                                      bRewindOnWrite, m_bWriteWholeDBFRecord );
 
     if( hSHP != nullptr )
     {
@@ -1263,7 +1791,7 @@ OGRErr OGRShapeLayer::ICreateFeature( OGRFeature *poFeature )
     const OGRErr eErr =
         SHPWriteOGRFeature( hSHP, hDBF, poFeatureDefn, poFeature,
                             osEncoding, &bTruncationWarningEmitted,
-                            bRewindOnWrite );
+                            bRewindOnWrite, m_bWriteWholeDBFRecord );
 
     if( hSHP != nullptr )
         nTotalShapeCount = hSHP->nRecords;
@@ -3387,6 +3915,10 @@ void OGRShapeLayer::CloseUnderlyingLayer()
 {
     CPLDebug("SHAPE", "CloseUnderlyingLayer(%s)", pszFullName);
 
+    // The prefetched batch is decoded with the record offsets of hSHP.
+    if( m_poPrefetchedBatch != nullptr )
+        m_poWorkerThreadPool->WaitCompletion();
+
     if( hDBF != nullptr )
         DBFClose( hDBF );
     hDBF = nullptr;
@@ -38,6 +38,7 @@
 #include <algorithm>
 #include <limits>
 #include <memory>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -1354,6 +1355,176 @@ static OGRErr GrowField( DBFHandle hDBF, int iField, OGRFieldDefn* poFieldDefn,
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                         FormatDBFNumber()                            */
+/*                                                                      */
+/*      Format a numeric value as DBFWriteDoubleAttribute() does.       */
+/*      Returns false if it does not fit in the field.                  */
+/************************************************************************/
+
+static bool FormatDBFNumber( DBFHandle hDBF, int iField, double dfVal,
+                             char* pszRecordField )
+{
+    const int nFieldSize = hDBF->panFieldSize[iField];
+    char szFormat[20] = {};
+    char szSField[XBASE_FLD_MAX_WIDTH+1] = {};
+    snprintf( szFormat, sizeof(szFormat), "%%%d.%df",
+              std::min(nFieldSize, static_cast<int>(sizeof(szSField)) - 2),
+              hDBF->panFieldDecimals[iField] );
+    CPLsnprintf( szSField, sizeof(szSField), szFormat, dfVal );
+    const size_t nLen = strlen(szSField);
+    if( nLen > static_cast<size_t>(nFieldSize) )
+        return false;
+    memcpy( pszRecordField, szSField, nLen );
+    return true;
+}
+
+/************************************************************************/
+/*                       SHPFormatOGRFeatureRecord()                    */
+/*                                                                      */
+/*      Serialize the attributes of a new feature into a complete DBF   */
+/*      record, producing the same bytes as the per-field               */
+/*      DBFWriteXXXAttribute() calls of SHPWriteOGRFeature().  Returns  */
+/*      false, without any side effect, for the less common cases that  */
+/*      require growing a field or emitting a warning, which are left   */
+/*      to the per-field path.                                          */
+/************************************************************************/
+
+static bool SHPFormatOGRFeatureRecord( DBFHandle hDBF,
+                                       OGRFeatureDefn * poDefn,
+                                       OGRFeature * poFeature,
+                                       const char *pszSHPEncoding,
+                                       std::vector<char>& abyRecord )
+{
+    abyRecord.assign( hDBF->nRecordLength, ' ' );
+
+    for( int iField = 0; iField < poDefn->GetFieldCount(); iField++ )
+    {
+        char* const pszRecordField =
+            abyRecord.data() + hDBF->panFieldOffset[iField];
+        const int nFieldSize = hDBF->panFieldSize[iField];
+        const char chType = hDBF->pachFieldType[iField];
+        const bool bNumericType = chType == 'N' || chType == 'F' ||
+                                  chType == 'D';
+
+        if( !poFeature->IsFieldSetAndNotNull( iField ) )
+        {
+            // Same as DBFWriteNULLAttribute().
+            const char chNull = (chType == 'N' || chType == 'F') ? '*' :
+                                chType == 'D' ? '0' :
+                                chType == 'L' ? '?' : ' ';
+            memset( pszRecordField, chNull, nFieldSize );
+            continue;
+        }
+
+        OGRFieldDefn * const poFieldDefn = poDefn->GetFieldDefn(iField);
+
+        switch( poFieldDefn->GetType() )
+        {
+          case OFTString:
+          {
+              if( bNumericType || chType == 'L' )
+                  return false;
+
+              const size_t nMaxLen = static_cast<size_t>(
+                  std::min(std::min(OGR_DBF_MAX_FIELD_WIDTH, nFieldSize),
+                           std::max(0, poFieldDefn->GetWidth())));
+              const char *pszStr = poFeature->GetFieldAsString(iField);
+              char *pszEncoded = nullptr;
+              if( pszSHPEncoding[0] != '\0' )
+              {
+                  // Each character takes at least one byte once recoded,
+                  // so do not recode a value that the per-field path will
+                  // have to recode again anyway.
+                  if( static_cast<size_t>(CPLStrlenUTF8(pszStr)) > nMaxLen )
+                      return false;
+                  pszEncoded =
+                      CPLRecode( pszStr, CPL_ENC_UTF8, pszSHPEncoding );
+                  pszStr = pszEncoded;
+              }
+
+              const size_t nStrLen = strlen(pszStr);
+              const bool bFits = nStrLen <= nMaxLen;
+              if( bFits )
+                  memcpy( pszRecordField, pszStr, nStrLen );
+              CPLFree( pszEncoded );
+              if( !bFits )
+                  return false;
+              break;
+          }
+
+          case OFTInteger:
+          case OFTInteger64:
+          {
+              // Right-aligned on min(width, 31) characters, as done with
+              // snprintf() in SHPWriteOGRFeature().
+              const GIntBig nVal = poFeature->GetFieldAsInteger64(iField);
+              GUIntBig nAbsVal = nVal < 0 ?
+                  static_cast<GUIntBig>(0) - static_cast<GUIntBig>(nVal) :
+                  static_cast<GUIntBig>(nVal);
+              char szValue[32] = {};
+              int iPos = static_cast<int>(sizeof(szValue));
+              do
+              {
+                  szValue[--iPos] = static_cast<char>('0' + nAbsVal % 10);
+                  nAbsVal /= 10;
+              } while( nAbsVal != 0 );
+              if( nVal < 0 )
+                  szValue[--iPos] = '-';
+
+              const int nLen = static_cast<int>(sizeof(szValue)) - iPos;
+              const int nFieldWidth = poFieldDefn->GetWidth();
+              if( nLen > nFieldWidth || nLen > nFieldSize )
+                  return false;
+              const int nPad =
+                  std::max(0, std::min(nFieldWidth,
+                                       static_cast<int>(sizeof(szValue)) - 1)
+                                  - nLen);
+              memcpy( pszRecordField + nPad, szValue + iPos, nLen );
+              break;
+          }
+
+          case OFTReal:
+          {
+              const double dfVal = poFeature->GetFieldAsDouble(iField);
+              if( !bNumericType ||
+                  (poFieldDefn->GetPrecision() == 0 &&
+                   fabs(dfVal) > (static_cast<GIntBig>(1) << 53)) ||
+                  !FormatDBFNumber( hDBF, iField, dfVal, pszRecordField ) )
+              {
+                  return false;
+              }
+              break;
+          }
+
+          case OFTDate:
+          {
+              const OGRField * const psField =
+                  poFeature->GetRawFieldRef(iField);
+              if( !bNumericType ||
+                  psField->Date.Year < 0 || psField->Date.Year > 9999 ||
+                  !FormatDBFNumber( hDBF, iField,
+                                    psField->Date.Year*10000 +
+                                    psField->Date.Month*100 +
+                                    psField->Date.Day,
+                                    pszRecordField ) )
+              {
+                  return false;
+              }
+              break;
+          }
+
+          default:
+          {
+              // Ignore fields of other types.
+              break;
+          }
+        }
+    }
+
+    return true;
+}
+
 /************************************************************************/
 /*                         SHPWriteOGRFeature()                         */
 /*                                                                      */
@@ -1366,7 +1537,8 @@ OGRErr SHPWriteOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
                            OGRFeature * poFeature,
                            const char *pszSHPEncoding,
                            bool* pbTruncationWarningEmitted,
-                           bool bRewind )
+                           bool bRewind,
+                           bool bWholeRecord )
 
 {
 /* -------------------------------------------------------------------- */
@@ -1417,6 +1589,24 @@ OGRErr SHPWriteOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
         DBFAddField( hDBF, "FID", FTInteger, 11, 0 );
     }
 
+/* -------------------------------------------------------------------- */
+/*      New records are serialized at once, when possible.              */
+/* -------------------------------------------------------------------- */
+    if( bWholeRecord &&
+        poFeature->GetFID() == DBFGetRecordCount( hDBF ) &&
+        DBFGetFieldCount( hDBF ) == poDefn->GetFieldCount() )
+    {
+        std::vector<char> abyRecord;
+        if( SHPFormatOGRFeatureRecord( hDBF, poDefn, poFeature,
+                                       pszSHPEncoding, abyRecord ) )
+        {
+            if( !DBFWriteTuple( hDBF, static_cast<int>(poFeature->GetFID()),
+                                abyRecord.data() ) )
+                return OGRERR_FAILURE;
+            return OGRERR_NONE;
+        }
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Write out dummy field value if it exists.                       */
 /* -------------------------------------------------------------------- */
@@ -43,8 +43,61 @@ typedef struct
     int       bEnforce2GBLimit;
     int       bHasWarned2GB;
     SAOffset  nCurOffset;
+
+    /* Write buffering, used when the file is opened for writing. */
+    /* Consecutive writes are accumulated in pabyWriteBuffer, that */
+    /* holds the nWriteBufferSize bytes starting at file offset    */
+    /* nWriteBufferOffset, and are written to fp when the file is  */
+    /* read, flushed or closed, or when a write is not contiguous. */
+    size_t    nWriteBufferMax;
+    size_t    nWriteBufferAlloc;
+    size_t    nWriteBufferSize;
+    SAOffset  nWriteBufferOffset;
+    GByte    *pabyWriteBuffer;
 } OGRSHPDBFFile;
 
+/************************************************************************/
+/*                      VSI_SHP_FlushWriteBuffer()                      */
+/************************************************************************/
+
+static int VSI_SHP_FlushWriteBuffer( OGRSHPDBFFile* pFile )
+{
+    size_t nSize = pFile->nWriteBufferSize;
+    if( nSize == 0 )
+        return TRUE;
+    pFile->nWriteBufferSize = 0;
+
+    if( (VSIFTellL( pFile->fp ) != (vsi_l_offset) pFile->nWriteBufferOffset &&
+         VSIFSeekL( pFile->fp, (vsi_l_offset) pFile->nWriteBufferOffset,
+                    SEEK_SET ) != 0) ||
+        VSIFWriteL( pFile->pabyWriteBuffer, 1, nSize, pFile->fp ) != nSize )
+    {
+        CPLError( CE_Failure, CPLE_FileIO,
+                  "Failure writing %d bytes at offset " CPL_FRMT_GUIB
+                  " of %s", (int) nSize,
+                  (GUIntBig) pFile->nWriteBufferOffset, pFile->pszFilename );
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                       VSI_SHP_SyncPosition()                         */
+/*                                                                      */
+/*      Flush pending writes and move the position of fp to the         */
+/*      logical position of the file, before a direct access to fp.     */
+/************************************************************************/
+
+static int VSI_SHP_SyncPosition( OGRSHPDBFFile* pFile )
+{
+    if( !VSI_SHP_FlushWriteBuffer( pFile ) )
+        return FALSE;
+    if( VSIFTellL( pFile->fp ) != (vsi_l_offset) pFile->nCurOffset )
+        return VSIFSeekL( pFile->fp, (vsi_l_offset) pFile->nCurOffset,
+                          SEEK_SET ) == 0;
+    return TRUE;
+}
+
 /************************************************************************/
 /*                         VSI_SHP_GetVSIL()                            */
 /************************************************************************/
@@ -52,6 +105,8 @@ typedef struct
 VSILFILE* VSI_SHP_GetVSIL( SAFile file )
 {
     OGRSHPDBFFile* pFile = (OGRSHPDBFFile*) file;
+    /* The caller is going to access the file directly. */
+    VSI_SHP_FlushWriteBuffer( pFile );
     return pFile->fp;
 }
 
@@ -83,6 +138,14 @@ SAFile VSI_SHP_OpenInternal( const char *pszFilename, const char *pszAccess,
     pFile->pszFilename = CPLStrdup(pszFilename);
     pFile->bEnforce2GBLimit = bEnforce2GBLimit;
     pFile->nCurOffset = 0;
+    if( strchr(pszAccess, 'w') != NULL || strchr(pszAccess, '+') != NULL )
+    {
+        GIntBig nBufferSize = CPLAtoGIntBig(
+            CPLGetConfigOption("SHAPE_WRITE_BUFFER_SIZE", "1048576") );
+        if( nBufferSize > 0 )
+            pFile->nWriteBufferMax =
+                (size_t) MIN( nBufferSize, (GIntBig) INT_MAX );
+    }
     return (SAFile) pFile;
 }
 
@@ -117,7 +180,10 @@ SAOffset VSI_SHP_Read( void *p, SAOffset size, SAOffset nmemb, SAFile file )
 
 {
     OGRSHPDBFFile* pFile = (OGRSHPDBFFile*) file;
-    SAOffset ret = (SAOffset) VSIFReadL( p, (size_t) size, (size_t) nmemb,
+    SAOffset ret;
+    if( pFile->nWriteBufferMax > 0 && !VSI_SHP_SyncPosition( pFile ) )
+        return 0;
+    ret = (SAOffset) VSIFReadL( p, (size_t) size, (size_t) nmemb,
                                  pFile->fp );
     pFile->nCurOffset += ret * size;
     return ret;
@@ -162,6 +228,56 @@ SAOffset VSI_SHP_Write( void *p, SAOffset size, SAOffset nmemb, SAFile file )
     SAOffset ret;
     if( !VSI_SHP_WriteMoreDataOK( file, size * nmemb ) )
         return 0;
+    if( pFile->nWriteBufferMax > 0 )
+    {
+        const size_t nBytes = (size_t) (size * nmemb);
+
+        /* Flush the pending writes if this one does not extend them. */
+        if( pFile->nWriteBufferSize > 0 &&
+            (pFile->nCurOffset < pFile->nWriteBufferOffset ||
+             pFile->nCurOffset > pFile->nWriteBufferOffset +
+                                    (SAOffset) pFile->nWriteBufferSize ||
+             (size_t) (pFile->nCurOffset - pFile->nWriteBufferOffset) +
+                                    nBytes > pFile->nWriteBufferMax) &&
+            !VSI_SHP_FlushWriteBuffer( pFile ) )
+        {
+            return 0;
+        }
+
+        if( nBytes <= pFile->nWriteBufferMax )
+        {
+            size_t nEnd;
+            if( pFile->nWriteBufferSize == 0 )
+                pFile->nWriteBufferOffset = pFile->nCurOffset;
+            nEnd = (size_t) (pFile->nCurOffset - pFile->nWriteBufferOffset)
+                   + nBytes;
+            if( nEnd > pFile->nWriteBufferAlloc )
+            {
+                /* Grow geometrically, so that files that are hardly */
+                /* written to do not hold a full size buffer. */
+                size_t nNewAlloc = MAX( nEnd, pFile->nWriteBufferAlloc * 2 );
+                GByte* pabyNew;
+                nNewAlloc = MIN( MAX( nNewAlloc, 65536 ),
+                                 pFile->nWriteBufferMax );
+                pabyNew = (GByte*) VSI_REALLOC_VERBOSE(
+                    pFile->pabyWriteBuffer, nNewAlloc );
+                if( pabyNew == NULL )
+                    return 0;
+                pFile->pabyWriteBuffer = pabyNew;
+                pFile->nWriteBufferAlloc = nNewAlloc;
+            }
+            memcpy( pFile->pabyWriteBuffer +
+                        (pFile->nCurOffset - pFile->nWriteBufferOffset),
+                    p, nBytes );
+            if( nEnd > pFile->nWriteBufferSize )
+                pFile->nWriteBufferSize = nEnd;
+            pFile->nCurOffset += (SAOffset) nBytes;
+            return nmemb;
+        }
+
+        if( !VSI_SHP_SyncPosition( pFile ) )
+            return 0;
+    }
     ret = (SAOffset) VSIFWriteL( p, (size_t) size, (size_t) nmemb,
                                   pFile->fp );
     pFile->nCurOffset += ret * size;
@@ -177,7 +293,21 @@ SAOffset VSI_SHP_Seek( SAFile file, SAOffset offset, int whence )
 
 {
     OGRSHPDBFFile* pFile = (OGRSHPDBFFile*) file;
-    SAOffset ret = (SAOffset) VSIFSeekL( pFile->fp, (vsi_l_offset) offset, whence );
+    SAOffset ret;
+    if( pFile->nWriteBufferMax > 0 )
+    {
+        /* Absolute seeks are deferred to the next read or flush of */
+        /* the write buffer, so that rewriting a few bytes of the   */
+        /* pending writes does not cost any I/O. */
+        if( whence == SEEK_SET )
+        {
+            pFile->nCurOffset = offset;
+            return 0;
+        }
+        if( !VSI_SHP_SyncPosition( pFile ) )
+            return -1;
+    }
+    ret = (SAOffset) VSIFSeekL( pFile->fp, (vsi_l_offset) offset, whence );
     if( whence == 0 && ret == 0)
         pFile->nCurOffset = offset;
     else
@@ -206,6 +336,8 @@ int VSI_SHP_Flush( SAFile file )
 
 {
     OGRSHPDBFFile* pFile = (OGRSHPDBFFile*) file;
+    if( !VSI_SHP_FlushWriteBuffer( pFile ) )
+        return -1;
     return VSIFFlushL( pFile->fp );
 }
 
@@ -218,7 +350,11 @@ int VSI_SHP_Close( SAFile file )
 
 {
     OGRSHPDBFFile* pFile = (OGRSHPDBFFile*) file;
+    int bFlushOK = VSI_SHP_FlushWriteBuffer( pFile );
     int ret = VSIFCloseL( pFile->fp );
+    if( !bFlushOK )
+        ret = -1;
+    CPLFree(pFile->pabyWriteBuffer);
     CPLFree(pFile->pszFilename);
     CPLFree(pFile);
     return ret;
@@ -302,3 +438,172 @@ const SAHooks* VSI_SHP_GetHook(int b2GBLimit)
 {
     return (b2GBLimit) ? &sOGRHook2GBLimit : &sOGRHook;
 }
+
+/************************************************************************/
+/* ==================================================================== */
+/*      Read-only access to a range of a .shp/.dbf file that has        */
+/*      already been loaded in memory. Offsets are those of the         */
+/*      original file, so that a copy of a SHPInfo/DBFInfo using those  */
+/*      hooks reads its records from memory, and reads outside of the   */
+/*      range behave as reads past the end of file.                     */
+/* ==================================================================== */
+/************************************************************************/
+
+typedef struct
+{
+    const GByte *pabyData;
+    SAOffset     nStartOffset;
+    SAOffset     nSize;
+    SAOffset     nCurOffset;
+} OGRSHPDBFBufferFile;
+
+/************************************************************************/
+/*                      VSI_SHP_OpenBufferFile()                        */
+/************************************************************************/
+
+SAFile VSI_SHP_OpenBufferFile( const GByte* pabyData, SAOffset nStartOffset,
+                               SAOffset nSize )
+{
+    OGRSHPDBFBufferFile* pFile =
+        (OGRSHPDBFBufferFile*) CPLCalloc(1, sizeof(OGRSHPDBFBufferFile));
+    pFile->pabyData = pabyData;
+    pFile->nStartOffset = nStartOffset;
+    pFile->nSize = nSize;
+    pFile->nCurOffset = nStartOffset;
+    return (SAFile) pFile;
+}
+
+/************************************************************************/
+/*                        VSI_SHP_BufferOpen()                          */
+/************************************************************************/
+
+static
+SAFile VSI_SHP_BufferOpen( const char * pszFilename,
+                           const char * pszAccess )
+{
+    (void)pszFilename;
+    (void)pszAccess;
+    return NULL;
+}
+
+/************************************************************************/
+/*                        VSI_SHP_BufferRead()                          */
+/************************************************************************/
+
+static
+SAOffset VSI_SHP_BufferRead( void *p, SAOffset size, SAOffset nmemb,
+                             SAFile file )
+{
+    OGRSHPDBFBufferFile* pFile = (OGRSHPDBFBufferFile*) file;
+    const SAOffset nEnd = pFile->nStartOffset + pFile->nSize;
+    SAOffset nToRead;
+    if( size == 0 || pFile->nCurOffset < pFile->nStartOffset ||
+        pFile->nCurOffset >= nEnd )
+        return 0;
+    nToRead = nmemb;
+    if( nToRead > (nEnd - pFile->nCurOffset) / size )
+        nToRead = (nEnd - pFile->nCurOffset) / size;
+    memcpy( p, pFile->pabyData + (pFile->nCurOffset - pFile->nStartOffset),
+            (size_t)(nToRead * size) );
+    pFile->nCurOffset += nToRead * size;
+    return nToRead;
+}
+
+/************************************************************************/
+/*                        VSI_SHP_BufferWrite()                         */
+/************************************************************************/
+
+static
+SAOffset VSI_SHP_BufferWrite( void *p, SAOffset size, SAOffset nmemb,
+                              SAFile file )
+{
+    (void)p;
+    (void)size;
+    (void)nmemb;
+    (void)file;
+    return 0;
+}
+
+/************************************************************************/
+/*                        VSI_SHP_BufferSeek()                          */
+/************************************************************************/
+
+static
+SAOffset VSI_SHP_BufferSeek( SAFile file, SAOffset offset, int whence )
+{
+    OGRSHPDBFBufferFile* pFile = (OGRSHPDBFBufferFile*) file;
+    if( whence == SEEK_SET )
+        pFile->nCurOffset = offset;
+    else if( whence == SEEK_CUR )
+        pFile->nCurOffset += offset;
+    else
+        pFile->nCurOffset = pFile->nStartOffset + pFile->nSize + offset;
+    return 0;
+}
+
+/************************************************************************/
+/*                        VSI_SHP_BufferTell()                          */
+/************************************************************************/
+
+static
+SAOffset VSI_SHP_BufferTell( SAFile file )
+{
+    OGRSHPDBFBufferFile* pFile = (OGRSHPDBFBufferFile*) file;
+    return pFile->nCurOffset;
+}
+
+/************************************************************************/
+/*                        VSI_SHP_BufferFlush()                         */
+/************************************************************************/
+
+static
+int VSI_SHP_BufferFlush( SAFile file )
+{
+    (void)file;
+    return 0;
+}
+
+/************************************************************************/
+/*                        VSI_SHP_BufferClose()                         */
+/************************************************************************/
+
+static
+int VSI_SHP_BufferClose( SAFile file )
+{
+    CPLFree(file);
+    return 0;
+}
+
+/************************************************************************/
+/*                        VSI_SHP_BufferRemove()                        */
+/************************************************************************/
+
+static
+int VSI_SHP_BufferRemove( const char *pszFilename )
+{
+    (void)pszFilename;
+    return -1;
+}
+
+/************************************************************************/
+/*                      VSI_SHP_GetBufferHook()                         */
+/************************************************************************/
+
+static const SAHooks sOGRBufferHook =
+{
+    VSI_SHP_BufferOpen,
+    VSI_SHP_BufferRead,
+    VSI_SHP_BufferWrite,
+    VSI_SHP_BufferSeek,
+    VSI_SHP_BufferTell,
+    VSI_SHP_BufferFlush,
+    VSI_SHP_BufferClose,
+    VSI_SHP_BufferRemove,
+    VSI_SHP_Error,
+    CPLAtof
+};
+
+const SAHooks* VSI_SHP_GetBufferHook(void)
+{
+    return &sOGRBufferHook;
+}
@@ -42,6 +42,10 @@ VSILFILE* VSI_SHP_GetVSIL( SAFile file );
 const char* VSI_SHP_GetFilename( SAFile file );
 int VSI_SHP_WriteMoreDataOK( SAFile file, SAOffset nExtraBytes );
 
+const SAHooks* VSI_SHP_GetBufferHook(void);
+SAFile VSI_SHP_OpenBufferFile( const GByte* pabyData, SAOffset nStartOffset,
+                               SAOffset nSize );
+
 CPL_C_END
 
 #endif /* SHP_VSI_H_INCLUDED */
@@ -31,6 +31,7 @@
 #include "cpl_port.h"
 #include "ogr_p.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
@@ -41,9 +42,11 @@
 #include <limits>
 #include <sstream>
 #include <iomanip>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_md5.h"
 #include "cpl_string.h"
 #include "cpl_time.h"
 #include "cpl_vsi.h"
@@ -1762,3 +1765,277 @@ OGRErr OGRReadWKBGeometryType( const unsigned char * pabyData,
 
     return OGRERR_NONE;
 }
+
+/************************************************************************/
+/*                          OGRWKBGetEnvelope()                         */
+/************************************************************************/
+
+static bool OGRWKBGetEnvelopeInternal( const GByte*& pabyData,
+                                       size_t& nRemaining,
+                                       OGREnvelope3D& sEnvelope,
+                                       bool& bHasZ,
+                                       int nRecLevel )
+{
+    // Arbitrary value, but certainly large enough for reasonable usages.
+    if( nRecLevel == 32 || nRemaining < 5 )
+        return false;
+
+    OGRwkbGeometryType eGeomType = wkbUnknown;
+    if( OGRReadWKBGeometryType( pabyData, wkbVariantIso,
+                                &eGeomType ) != OGRERR_NONE )
+        return false;
+    const bool bSwap = OGR_SWAP(
+        static_cast<OGRwkbByteOrder>(DB2_V72_FIX_BYTE_ORDER(*pabyData)));
+    pabyData += 5;
+    nRemaining -= 5;
+
+    const bool bGeomHasZ = CPL_TO_BOOL(OGR_GT_HasZ(eGeomType));
+    const size_t nDim = 2 + (bGeomHasZ ? 1 : 0) +
+                        (OGR_GT_HasM(eGeomType) ? 1 : 0);
+    bHasZ |= bGeomHasZ;
+
+    const auto ReadUInt32 = [&pabyData, &nRemaining, bSwap](GUInt32& nVal)
+    {
+        if( nRemaining < 4 )
+            return false;
+        memcpy(&nVal, pabyData, 4);
+        if( bSwap )
+            CPL_SWAP32PTR(&nVal);
+        pabyData += 4;
+        nRemaining -= 4;
+        return true;
+    };
+
+    const auto ReadPoints = [&pabyData, &nRemaining, &sEnvelope,
+                             bSwap, bGeomHasZ, nDim](GUInt32 nPoints)
+    {
+        if( nPoints > nRemaining / (8 * nDim) )
+            return false;
+        for( GUInt32 i = 0; i < nPoints; i++ )
+        {
+            double adfXYZ[3] = { 0.0, 0.0, 0.0 };
+            memcpy(adfXYZ, pabyData, 8 * (bGeomHasZ ? 3 : 2));
+            if( bSwap )
+            {
+                CPL_SWAPDOUBLE(&adfXYZ[0]);
+                CPL_SWAPDOUBLE(&adfXYZ[1]);
+                CPL_SWAPDOUBLE(&adfXYZ[2]);
+            }
+            pabyData += 8 * nDim;
+            nRemaining -= 8 * nDim;
+            // POINT EMPTY is encoded with NaN coordinates.
+            if( CPLIsNan(adfXYZ[0]) || CPLIsNan(adfXYZ[1]) )
+                continue;
+            if( !sEnvelope.IsInit() )
+            {
+                sEnvelope.MinX = sEnvelope.MaxX = adfXYZ[0];
+                sEnvelope.MinY = sEnvelope.MaxY = adfXYZ[1];
+                if( bGeomHasZ )
+                    sEnvelope.MinZ = sEnvelope.MaxZ = adfXYZ[2];
+                else
+                    sEnvelope.MinZ = sEnvelope.MaxZ = 0.0;
+            }
+            else
+            {
+                sEnvelope.MinX = std::min(sEnvelope.MinX, adfXYZ[0]);
+                sEnvelope.MaxX = std::max(sEnvelope.MaxX, adfXYZ[0]);
+                sEnvelope.MinY = std::min(sEnvelope.MinY, adfXYZ[1]);
+                sEnvelope.MaxY = std::max(sEnvelope.MaxY, adfXYZ[1]);
+                if( bGeomHasZ )
+                {
+                    sEnvelope.MinZ = std::min(sEnvelope.MinZ, adfXYZ[2]);
+                    sEnvelope.MaxZ = std::max(sEnvelope.MaxZ, adfXYZ[2]);
+                }
+            }
+        }
+        return true;
+    };
+
+    switch( wkbFlatten(eGeomType) )
+    {
+        case wkbPoint:
+            return ReadPoints(1);
+
+        case wkbLineString:
+        {
+            GUInt32 nPoints = 0;
+            return ReadUInt32(nPoints) && ReadPoints(nPoints);
+        }
+
+        case wkbPolygon:
+        case wkbTriangle:
+        {
+            GUInt32 nRings = 0;
+            if( !ReadUInt32(nRings) || nRings > nRemaining / 4 )
+                return false;
+            for( GUInt32 i = 0; i < nRings; i++ )
+            {
+                GUInt32 nPoints = 0;
+                if( !ReadUInt32(nPoints) || !ReadPoints(nPoints) )
+                    return false;
+            }
+            return true;
+        }
+
+        case wkbMultiPoint:
+        case wkbMultiLineString:
+        case wkbMultiPolygon:
+        case wkbGeometryCollection:
+        case wkbCompoundCurve:
+        case wkbCurvePolygon:
+        case wkbMultiCurve:
+        case wkbMultiSurface:
+        case wkbPolyhedralSurface:
+        case wkbTIN:
+        {
+            GUInt32 nParts = 0;
+            if( !ReadUInt32(nParts) || nParts > nRemaining / 5 )
+                return false;
+            for( GUInt32 i = 0; i < nParts; i++ )
+            {
+                if( !OGRWKBGetEnvelopeInternal(pabyData, nRemaining,
+                                               sEnvelope, bHasZ,
+                                               nRecLevel + 1) )
+                    return false;
+            }
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * Compute the envelope of a WKB geometry.
+ *
+ * The coordinates are read directly from the binary representation, without
+ * instantiating a OGRGeometry. Empty geometries leave the envelope
+ * uninitialized (see OGREnvelope3D::IsInit()).
+ *
+ * @param pabyWKB WKB geometry (ISO, or old-style OGC for 2.5D).
+ * @param nWKBSize size in bytes of pabyWKB.
+ * @param sEnvelope output envelope.
+ * @param pbHasZ if not NULL, set to whether the geometry has a Z dimension,
+ * in which case the Z range of sEnvelope is set.
+ * @return false if the WKB is corrupted or of an unhandled type. Geometries
+ * with circular arcs are not handled, since their extent is not the one of
+ * their control points.
+ */
+
+bool OGRWKBGetEnvelope( const GByte* pabyWKB, size_t nWKBSize,
+                        OGREnvelope3D& sEnvelope, bool* pbHasZ )
+{
+    sEnvelope = OGREnvelope3D();
+    bool bHasZ = false;
+    const bool bRet = OGRWKBGetEnvelopeInternal(pabyWKB, nWKBSize,
+                                                sEnvelope, bHasZ, 0);
+    if( pbHasZ )
+        *pbHasZ = bHasZ;
+    return bRet;
+}
+
+/************************************************************************/
+/*                          OGRGetFileStamp()                           */
+/************************************************************************/
+
+/**
+ * Compute a stamp of a file, used to detect that it has changed since an
+ * index of it was built.
+ *
+ * The stamp is made of the size and modification time of the file, and of
+ * a checksum of its first and last 64 KB, so that a rewrite of the file
+ * that keeps its size within the resolution of the modification time is
+ * still detected.
+ *
+ * @param pszFilename file name.
+ * @param nSize output file size.
+ * @param nMTime output modification time.
+ * @param nChecksum output checksum.
+ * @return false if the file cannot be accessed.
+ */
+
+bool OGRGetFileStamp( const char* pszFilename, GUInt64& nSize,
+                      GInt64& nMTime, GUInt32& nChecksum )
+{
+    VSIStatBufL sStat;
+    if( VSIStatL(pszFilename, &sStat) != 0 )
+        return false;
+    nSize = static_cast<GUInt64>(sStat.st_size);
+    nMTime = static_cast<GInt64>(sStat.st_mtime);
+
+    VSILFILE* fp = VSIFOpenL(pszFilename, "rb");
+    if( fp == nullptr )
+        return false;
+
+    constexpr GUInt64 BLOCK_SIZE = 65536;
+    std::vector<GByte> abyBuffer(static_cast<size_t>(BLOCK_SIZE));
+    CPLMD5Context sContext;
+    CPLMD5Init(&sContext);
+    bool bOK = true;
+    for( int iBlock = 0; iBlock < 2 && bOK; iBlock++ )
+    {
+        GUInt64 nOffset = 0;
+        if( iBlock == 1 )
+        {
+            if( nSize <= BLOCK_SIZE )
+                break;
+            nOffset = std::max(BLOCK_SIZE, nSize - BLOCK_SIZE);
+        }
+        const size_t nToRead = static_cast<size_t>(
+            std::min(BLOCK_SIZE, nSize - nOffset));
+        bOK = VSIFSeekL(fp, nOffset, SEEK_SET) == 0 &&
+              VSIFReadL(abyBuffer.data(), 1, nToRead, fp) == nToRead;
+        if( bOK )
+            CPLMD5Update(&sContext, abyBuffer.data(),
+                         static_cast<unsigned>(nToRead));
+    }
+    VSIFCloseL(fp);
+    if( !bOK )
+        return false;
+
+    unsigned char abyDigest[16];
+    CPLMD5Final(abyDigest, &sContext);
+    nChecksum = static_cast<GUInt32>(abyDigest[0]) |
+                (static_cast<GUInt32>(abyDigest[1]) << 8) |
+                (static_cast<GUInt32>(abyDigest[2]) << 16) |
+                (static_cast<GUInt32>(abyDigest[3]) << 24);
+    return true;
+}
+
+/************************************************************************/
+/*                          OGRGetNumThreads()                          */
+/************************************************************************/
+
+/**
+ * Return the number of worker threads a driver should use, from the
+ * NUM_THREADS option, or the GDAL_NUM_THREADS configuration option.
+ *
+ * Both accept an integer or ALL_CPUS. The default is 1, and the result is
+ * capped to 128.
+ *
+ * @param papszOptions open or creation options (may be NULL).
+ * @return the number of threads. 0 or 1 means no worker thread.
+ */
+
+int OGRGetNumThreads( CSLConstList papszOptions )
+{
+    int nNumThreads = 1;
+    const char *pszNumThreads =
+        CSLFetchNameValue(papszOptions, "NUM_THREADS");
+    if( pszNumThreads == nullptr )
+        pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    if( pszNumThreads != nullptr )
+    {
+        nNumThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs()
+                                                       : atoi(pszNumThreads);
+        if( nNumThreads < 0 ||
+            (nNumThreads == 0 && !EQUAL(pszNumThreads, "0")) )
+        {
+            CPLError(CE_Warning, CPLE_AppDefined,
+                     "Invalid value for NUM_THREADS: %s", pszNumThreads);
+            nNumThreads = 1;
+        }
+    }
+    return std::min(128, nNumThreads);
+}
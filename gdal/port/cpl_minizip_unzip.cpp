@@ -1,5 +1,6 @@
 /* Modified version by Even Rouault. :
      - Addition of cpl_unzGetCurrentFileZStreamPos
+     - Addition of cpl_unzGetCurrentFileLocalHeaderPos
      - Decoration of symbol names unz* -> cpl_unz*
      - Undef EXPORT so that we are sure the symbols are not exported
      - Remove old C style function prototypes
@@ -1520,6 +1521,18 @@ extern uLong64 ZEXPORT cpl_unzGetCurrentFileZStreamPos( unzFile file)
                          pfile_in_zip_read_info->byte_before_the_zipfile;
 }
 
+extern uLong64 ZEXPORT cpl_unzGetCurrentFileLocalHeaderPos( unzFile file)
+{
+    unz_s* s;
+    s=reinterpret_cast<unz_s*>(file);
+    if (file==nullptr)
+        return 0;  // UNZ_PARAMERROR;
+    if (!s->current_file_ok)
+        return 0;  // UNZ_END_OF_LIST_OF_FILE;
+    return s->cur_file_info_internal.offset_curfile +
+                         s->byte_before_the_zipfile;
+}
+
 /** Addition for GDAL : END */
 
 /*
@@ -1,6 +1,7 @@
 /* $Id$ */
 /* Modified version by Even Rouault. :
      - Addition of cpl_unzGetCurrentFileZStreamPos
+     - Addition of cpl_unzGetCurrentFileLocalHeaderPos
      - Decoration of symbol names unz* -> cpl_unz*
      - Undef EXPORT so that we are sure the symbols are not exported
      - Add support for ZIP64
@@ -261,6 +262,10 @@ extern int ZEXPORT cpl_unzGetCurrentFileInfo (unzFile file,
 
 extern uLong64 ZEXPORT cpl_unzGetCurrentFileZStreamPos (unzFile file);
 
+/* Offset of the local header of the current file, without needing to open
+   it. Returns 0 on error. */
+extern uLong64 ZEXPORT cpl_unzGetCurrentFileLocalHeaderPos (unzFile file);
+
 /** Addition for GDAL : END */
 
 /***************************************************************************/
@@ -181,6 +181,27 @@ typedef enum
 
 VSIRangeStatus CPL_DLL VSIFGetRangeStatusL( VSILFILE * fp, vsi_l_offset nStart, vsi_l_offset nLength );
 
+/** Opaque type for a read-only view of a file region returned by VSIFMapRegionL() */
+typedef struct VSIMappedRegion VSIMappedRegion;
+
+/** Flag provided to VSIFMapRegionL() to only return a region if it can be
+ * obtained without copying file content (e.g. memory mapping) */
+#define VSI_MAP_REGION_ZERO_COPY_ONLY 0x1
+
+VSIMappedRegion CPL_DLL *VSIFMapRegionL( VSILFILE * fp, vsi_l_offset nOffset, size_t nSize, int nFlags ) CPL_WARN_UNUSED_RESULT;
+const void CPL_DLL *VSIMappedRegionGetData( const VSIMappedRegion* psRegion );
+size_t CPL_DLL  VSIMappedRegionGetSize( const VSIMappedRegion* psRegion );
+int CPL_DLL     VSIMappedRegionIsZeroCopy( const VSIMappedRegion* psRegion );
+void CPL_DLL    VSIMappedRegionFree( VSIMappedRegion* psRegion );
+
+/** Opaque type for an asynchronous read request returned by VSIFReadMultiRangeAsyncL() */
+typedef struct VSIAsyncRead VSIAsyncRead;
+
+VSIAsyncRead CPL_DLL *VSIFReadMultiRangeAsyncL( int nRanges, void ** ppData, const vsi_l_offset* panOffsets, const size_t* panSizes, VSILFILE * ) CPL_WARN_UNUSED_RESULT;
+int CPL_DLL     VSIAsyncReadIsDone( VSIAsyncRead* psRequest );
+int CPL_DLL     VSIAsyncReadWait( VSIAsyncRead* psRequest );
+void CPL_DLL    VSIAsyncReadFree( VSIAsyncRead* psRequest );
+
 int CPL_DLL     VSIIngestFile( VSILFILE* fp,
                                const char* pszFilename,
                                GByte** ppabyRet,
@@ -405,6 +426,9 @@ void CPL_DLL VSIInstallSparseFileHandler(void);
 void VSIInstallTarFileHandler(void); /* No reason to export that */
 void CPL_DLL VSIInstallCryptFileHandler(void);
 void CPL_DLL VSISetCryptKey(const GByte* pabyKey, int nKeySize);
+void VSIInstallTraceFileHandler(void); /* No reason to export that */
+char CPL_DLL *VSITraceGetStatistics( const char* pszFilename );
+void CPL_DLL VSITraceResetStatistics( void );
 /*! @cond Doxygen_Suppress */
 void CPL_DLL VSICleanupFileManager(void);
 /*! @endcond */
@@ -97,6 +97,9 @@ class VSIMemFile
 public:
     CPLString     osFilename{};
     volatile int  nRefCount = 0;
+    // Number of VSIMemMappedRegion pointing to pabyData, which must not be
+    // reallocated or seized while it is not zero.
+    volatile int  nMappedRegionCount = 0;
 
     bool          bIsDirectory = false;
 
@@ -143,6 +146,7 @@ class VSIMemHandle final : public VSIVirtualHandle
     int Eof() override;
     int Close() override;
     int Truncate( vsi_l_offset nNewSize ) override;
+    VSIMappedRegion *MapRegion( vsi_l_offset nOffset, size_t nSize ) override;
 };
 
 /************************************************************************/
@@ -246,6 +250,14 @@ bool VSIMemFile::SetLength( vsi_l_offset nNewLength )
                 "transferred" );
             return false;
         }
+        if( nMappedRegionCount > 0 )
+        {
+            CPLError(
+                CE_Failure, CPLE_NotSupported,
+                "Cannot extend in-memory file %s while regions of it "
+                "are mapped", osFilename.c_str() );
+            return false;
+        }
 
         const vsi_l_offset nNewAlloc = (nNewLength + nNewLength / 10) + 5000;
         GByte *pabyNewData = nullptr;
@@ -461,6 +473,53 @@ int VSIMemHandle::Truncate( vsi_l_offset nNewSize )
     return -1;
 }
 
+/************************************************************************/
+/*                         VSIMemMappedRegion                           */
+/************************************************************************/
+
+namespace {
+class VSIMemMappedRegion final : public VSIMappedRegion
+{
+    VSIMemFile *m_poFile = nullptr;
+
+  public:
+    VSIMemMappedRegion( VSIMemFile* poFile, const GByte* pabyData,
+                        size_t nSizeIn ) :
+        m_poFile(poFile)
+    {
+        CPLAtomicInc(&(m_poFile->nRefCount));
+        CPLAtomicInc(&(m_poFile->nMappedRegionCount));
+        pData = pabyData;
+        nSize = nSizeIn;
+        bZeroCopy = true;
+    }
+
+    ~VSIMemMappedRegion() override
+    {
+        CPLAtomicDec(&(m_poFile->nMappedRegionCount));
+        if( CPLAtomicDec(&(m_poFile->nRefCount)) == 0 )
+            delete m_poFile;
+    }
+};
+} // namespace
+
+/************************************************************************/
+/*                             MapRegion()                              */
+/************************************************************************/
+
+VSIMappedRegion *VSIMemHandle::MapRegion( vsi_l_offset nOffset, size_t nSize )
+{
+    if( nOffset >= poFile->nLength )
+        return nullptr;
+    if( nSize == 0 )
+        nSize = static_cast<size_t>(poFile->nLength - nOffset);
+    else if( nSize > poFile->nLength - nOffset )
+        return nullptr;
+
+    return new VSIMemMappedRegion(
+        poFile, poFile->pabyData + static_cast<size_t>(nOffset), nSize);
+}
+
 /************************************************************************/
 /* ==================================================================== */
 /*                       VSIMemFilesystemHandler                        */
@@ -985,6 +1044,13 @@ GByte *VSIGetMemFileBuffer( const char *pszFilename,
 
     if( bUnlinkAndSeize )
     {
+        if( poFile->nMappedRegionCount > 0 )
+        {
+            CPLError(CE_Failure, CPLE_NotSupported,
+                     "Cannot seize buffer of %s while regions of it "
+                     "are mapped", osFilename.c_str());
+            return nullptr;
+        }
         if( !poFile->bOwnData )
             CPLDebug( "VSIMemFile",
                       "File doesn't own data in VSIGetMemFileBuffer!" );
@@ -39,7 +39,9 @@
 #include "cpl_string.h"
 #include "cpl_multiproc.h"
 
+#include <functional>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
 
@@ -48,6 +50,52 @@
 #undef GetDiskFreeSpace
 #endif
 
+/************************************************************************/
+/*                           VSIMappedRegion                            */
+/************************************************************************/
+
+/** Read-only view of a file region, returned by VSIFMapRegionL() */
+struct CPL_DLL VSIMappedRegion
+{
+    const void   *pData = nullptr;
+    size_t        nSize = 0;
+    bool          bZeroCopy = false;
+
+    VSIMappedRegion() = default;
+    virtual ~VSIMappedRegion();
+
+  private:
+    CPL_DISALLOW_COPY_ASSIGN(VSIMappedRegion)
+};
+
+/************************************************************************/
+/*                             VSIAsyncRead                             */
+/************************************************************************/
+
+/** Asynchronous read request, returned by VSIFReadMultiRangeAsyncL() */
+struct CPL_DLL VSIAsyncRead
+{
+    VSIAsyncRead() = default;
+    virtual ~VSIAsyncRead();
+
+    /** Return whether the request has completed, without blocking */
+    virtual bool IsDone() = 0;
+    /** Wait for the completion of the request.
+     * @return 0 on success, -1 on failure */
+    virtual int  Wait() = 0;
+
+  private:
+    CPL_DISALLOW_COPY_ASSIGN(VSIAsyncRead)
+};
+
+#ifndef DOXYGEN_SKIP
+// Run the jobs on the thread pool dedicated to asynchronous I/O. A job
+// returns false and sets its argument to an error message on failure.
+typedef std::function<bool(std::string&)> VSIAsyncReadJob;
+VSIAsyncRead CPL_DLL *VSICreateAsyncReadFromJobs(
+                                    std::vector<VSIAsyncReadJob>&& aoJobs );
+#endif
+
 /************************************************************************/
 /*                           VSIVirtualHandle                           */
 /************************************************************************/
@@ -68,6 +116,10 @@ class CPL_DLL VSIVirtualHandle {
     // Base implementation that only supports file extension.
     virtual int       Truncate( vsi_l_offset nNewSize );
     virtual void     *GetNativeFileDescriptor() { return nullptr; }
+    virtual VSIMappedRegion *MapRegion( vsi_l_offset nOffset, size_t nSize );
+    virtual VSIAsyncRead *ReadMultiRangeAsync( int nRanges, void ** ppData,
+                                               const vsi_l_offset* panOffsets,
+                                               const size_t* panSizes );
     virtual VSIRangeStatus GetRangeStatus( CPL_UNUSED vsi_l_offset nOffset,
                                            CPL_UNUSED vsi_l_offset nLength )
                                           { return VSI_RANGE_STATUS_UNKNOWN; }
@@ -194,6 +246,9 @@ public:
     vsi_l_offset nFileSize = 0;
     int nEntries = 0;
     VSIArchiveEntry* entries = nullptr;
+    // Index in entries[] of each file name, for fast lookups in archives
+    // with many members.
+    std::unordered_map<std::string, int> oMapFileNameToIndex{};
 
     ~VSIArchiveContent();
 };
@@ -40,9 +40,11 @@
 #endif
 
 #include <algorithm>
+#include <condition_variable>
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <utility>
@@ -52,7 +54,9 @@
 #include "cpl_error.h"
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
+#include "cpl_virtualmem.h"
 #include "cpl_vsi_virtual.h"
+#include "cpl_worker_thread_pool.h"
 
 
 CPL_CVSID("$Id$")
@@ -630,8 +634,12 @@ int VSIRename( const char * oldpath, const char * newpath )
  *     PUT operation (so smaller than 50 MB given the default used by GDAL).
  *     Only to be used for /vsis3/, /vsigs/ or other filesystems using a
  *     MD5Sum as ETAG.</li>
- * <li>NUM_THREADS=integer. Number of threads to use for parallel file copying.
+ * <li>NUM_THREADS=integer or ALL_CPUS. Number of threads to use for parallel
+ *     file copying.
  *     Only use for when /vsis3/, /vsigs/ or /vsiaz/ is in source or target.
+ *     When synchronizing directories, it is also used to create missing
+ *     directories on the network filesystem, and to compute the MD5 of local
+ *     files with SYNC_STRATEGY=ETAG, concurrently.
  *     Since GDAL 3.1</li>
  * <li>CHUNK_SIZE=integer. Maximum size of chunk (in bytes) to use to split
  *     large objects when downloading them from /vsis3/, /vsigs/ or /vsiaz/ to
@@ -1951,6 +1959,104 @@ int VSIFReadMultiRangeL( int nRanges, void ** ppData,
     return poFileHandle->ReadMultiRange(nRanges, ppData, panOffsets, panSizes);
 }
 
+/************************************************************************/
+/*                     VSIFReadMultiRangeAsyncL()                       */
+/************************************************************************/
+
+/**
+ * \brief Start reading several ranges of bytes from file, without waiting
+ * for the data.
+ *
+ * This is the asynchronous version of VSIFReadMultiRangeL(). The returned
+ * request must be passed to VSIAsyncReadWait() to get the status of the
+ * read, or polled with VSIAsyncReadIsDone(), and freed with
+ * VSIAsyncReadFree(). Until the request has completed, the content of the
+ * ppData buffers is undefined, and the buffers must be kept alive. Several
+ * requests may be in flight at the same time, and the file handle may be
+ * used for other operations while requests are pending, but it must not be
+ * closed before they have been freed.
+ *
+ * Local files are read by worker threads, whose number is controlled by the
+ * CPL_VSIL_ASYNC_IO_THREADS configuration option (8 by default). /vsicurl/
+ * and derived file systems issue all the range requests at once from a
+ * worker thread. Other file systems perform the read synchronously when the
+ * request is submitted.
+ *
+ * @param nRanges number of ranges to read.
+ * @param ppData array of nRanges buffer into which the data should be read
+ *               (ppData[i] must be at list panSizes[i] bytes).
+ * @param panOffsets array of nRanges offsets at which the data should be read.
+ * @param panSizes array of nRanges sizes of objects to read (in bytes).
+ * @param fp file handle opened with VSIFOpenL().
+ *
+ * @return a request to free with VSIAsyncReadFree(), or NULL.
+ * @since GDAL 3.1
+ */
+
+VSIAsyncRead *VSIFReadMultiRangeAsyncL( int nRanges, void ** ppData,
+                                        const vsi_l_offset* panOffsets,
+                                        const size_t* panSizes,
+                                        VSILFILE * fp )
+{
+    VSIVirtualHandle *poFileHandle = reinterpret_cast<VSIVirtualHandle *>(fp);
+
+    return poFileHandle->ReadMultiRangeAsync(nRanges, ppData,
+                                             panOffsets, panSizes);
+}
+
+/************************************************************************/
+/*                         VSIAsyncReadIsDone()                         */
+/************************************************************************/
+
+/**
+ * \brief Return whether a request returned by VSIFReadMultiRangeAsyncL()
+ * has completed, without blocking.
+ *
+ * @return TRUE if the request has completed (successfully or not).
+ * @since GDAL 3.1
+ */
+
+int VSIAsyncReadIsDone( VSIAsyncRead* psRequest )
+{
+    return psRequest->IsDone();
+}
+
+/************************************************************************/
+/*                          VSIAsyncReadWait()                          */
+/************************************************************************/
+
+/**
+ * \brief Wait for the completion of a request returned by
+ * VSIFReadMultiRangeAsyncL().
+ *
+ * An error is emitted if the read failed.
+ *
+ * @return 0 in case of success, -1 otherwise.
+ * @since GDAL 3.1
+ */
+
+int VSIAsyncReadWait( VSIAsyncRead* psRequest )
+{
+    return psRequest->Wait();
+}
+
+/************************************************************************/
+/*                          VSIAsyncReadFree()                          */
+/************************************************************************/
+
+/**
+ * \brief Free a request returned by VSIFReadMultiRangeAsyncL().
+ *
+ * This waits for the completion of the request if it is still pending.
+ *
+ * @since GDAL 3.1
+ */
+
+void VSIAsyncReadFree( VSIAsyncRead* psRequest )
+{
+    delete psRequest;
+}
+
 /************************************************************************/
 /*                             VSIFWriteL()                             */
 /************************************************************************/
@@ -2498,6 +2604,183 @@ void *VSIFGetNativeFileDescriptorL( VSILFILE* fp )
     return poFileHandle->GetNativeFileDescriptor();
 }
 
+/************************************************************************/
+/*                        VSIMappedRegionBuffer                         */
+/************************************************************************/
+
+#ifndef DOXYGEN_SKIP
+namespace {
+class VSIMappedRegionBuffer final : public VSIMappedRegion
+{
+    void *m_pBuffer = nullptr;
+
+  public:
+    VSIMappedRegionBuffer( void* pBuffer, size_t nSizeIn ) :
+        m_pBuffer(pBuffer)
+    {
+        pData = m_pBuffer;
+        nSize = nSizeIn;
+    }
+
+    ~VSIMappedRegionBuffer() override
+    {
+        VSIFree(m_pBuffer);
+    }
+};
+} // namespace
+#endif  // #ifndef DOXYGEN_SKIP
+
+/************************************************************************/
+/*                          VSIFMapRegionL()                            */
+/************************************************************************/
+
+/**
+ * \brief Return a read-only view of a region of a file.
+ *
+ * For local files on systems with mmap() support, and for /vsimem/ files,
+ * the returned region directly points to the file content (memory mapping
+ * for local files), which avoids copying it into a user buffer. For other
+ * file systems, the region is read into a newly allocated buffer, unless
+ * VSI_MAP_REGION_ZERO_COPY_ONLY is set in nFlags, in which case NULL is
+ * returned.
+ *
+ * The content of a zero-copy region is undefined if the file is modified or
+ * truncated while the region is in use. For /vsimem/ files, extending the
+ * file beyond its allocated size, or seizing its buffer with
+ * VSIGetMemFileBuffer(), fails while regions of it are mapped.
+ *
+ * Zero-copy regions can be disabled by setting the CPL_VSIL_MMAP_READ
+ * configuration option to NO.
+ *
+ * The current position of the file handle is left unchanged.
+ *
+ * @param fp file handle opened with VSIFOpenL().
+ * @param nOffset offset of the start of the region.
+ * @param nSize size of the region in bytes, or 0 to extend it up to the end
+ * of the file.
+ * @param nFlags 0 or VSI_MAP_REGION_ZERO_COPY_ONLY.
+ *
+ * @return a region to free with VSIMappedRegionFree(), or NULL.
+ * @since GDAL 3.1
+ */
+
+VSIMappedRegion *VSIFMapRegionL( VSILFILE* fp, vsi_l_offset nOffset,
+                                 size_t nSize, int nFlags )
+{
+    VSIVirtualHandle *poFileHandle = reinterpret_cast<VSIVirtualHandle *>( fp );
+
+    if( CPLTestBool(CPLGetConfigOption("CPL_VSIL_MMAP_READ", "YES")) )
+    {
+        VSIMappedRegion* psRegion = poFileHandle->MapRegion(nOffset, nSize);
+        if( psRegion != nullptr )
+            return psRegion;
+    }
+    if( (nFlags & VSI_MAP_REGION_ZERO_COPY_ONLY) != 0 )
+        return nullptr;
+
+/* -------------------------------------------------------------------- */
+/*      Fallback: read the region into a buffer.                        */
+/* -------------------------------------------------------------------- */
+    const vsi_l_offset nCurPos = poFileHandle->Tell();
+    if( nSize == 0 )
+    {
+        if( poFileHandle->Seek(0, SEEK_END) != 0 )
+            return nullptr;
+        const vsi_l_offset nFileSize = poFileHandle->Tell();
+        if( nFileSize <= nOffset ||
+            nFileSize - nOffset >
+                static_cast<vsi_l_offset>(std::numeric_limits<size_t>::max()) )
+        {
+            poFileHandle->Seek(nCurPos, SEEK_SET);
+            return nullptr;
+        }
+        nSize = static_cast<size_t>(nFileSize - nOffset);
+    }
+
+    void* pBuffer = VSI_MALLOC_VERBOSE(nSize);
+    if( pBuffer == nullptr )
+    {
+        poFileHandle->Seek(nCurPos, SEEK_SET);
+        return nullptr;
+    }
+    if( poFileHandle->Seek(nOffset, SEEK_SET) != 0 ||
+        poFileHandle->Read(pBuffer, 1, nSize) != nSize )
+    {
+        CPLError(CE_Failure, CPLE_FileIO,
+                 "Cannot read " CPL_FRMT_GUIB " bytes at offset "
+                 CPL_FRMT_GUIB,
+                 static_cast<GUIntBig>(nSize), nOffset);
+        VSIFree(pBuffer);
+        poFileHandle->Seek(nCurPos, SEEK_SET);
+        return nullptr;
+    }
+    poFileHandle->Seek(nCurPos, SEEK_SET);
+
+    return new VSIMappedRegionBuffer(pBuffer, nSize);
+}
+
+/************************************************************************/
+/*                       VSIMappedRegionGetData()                       */
+/************************************************************************/
+
+/**
+ * \brief Return the start of the data of a region returned by
+ * VSIFMapRegionL().
+ *
+ * @since GDAL 3.1
+ */
+
+const void *VSIMappedRegionGetData( const VSIMappedRegion* psRegion )
+{
+    return psRegion->pData;
+}
+
+/************************************************************************/
+/*                       VSIMappedRegionGetSize()                       */
+/************************************************************************/
+
+/**
+ * \brief Return the size in bytes of a region returned by VSIFMapRegionL().
+ *
+ * @since GDAL 3.1
+ */
+
+size_t VSIMappedRegionGetSize( const VSIMappedRegion* psRegion )
+{
+    return psRegion->nSize;
+}
+
+/************************************************************************/
+/*                      VSIMappedRegionIsZeroCopy()                     */
+/************************************************************************/
+
+/**
+ * \brief Return whether a region returned by VSIFMapRegionL() directly
+ * points to the file content, or is a copy of it.
+ *
+ * @since GDAL 3.1
+ */
+
+int VSIMappedRegionIsZeroCopy( const VSIMappedRegion* psRegion )
+{
+    return psRegion->bZeroCopy;
+}
+
+/************************************************************************/
+/*                        VSIMappedRegionFree()                         */
+/************************************************************************/
+
+/**
+ * \brief Free a region returned by VSIFMapRegionL().
+ *
+ * @since GDAL 3.1
+ */
+
+void VSIMappedRegionFree( VSIMappedRegion* psRegion )
+{
+    delete psRegion;
+}
+
 /************************************************************************/
 /*                      VSIGetDiskFreeSpace()                           */
 /************************************************************************/
@@ -2650,6 +2933,7 @@ VSIFileManager *VSIFileManager::Get()
       VSIInstallSparseFileHandler();
       VSIInstallTarFileHandler();
       VSIInstallCryptFileHandler();
+      VSIInstallTraceFileHandler();
 
       return poManager;
 
@@ -2723,6 +3007,8 @@ void VSIFileManager::InstallHandler( const std::string& osPrefix,
         Get()->oHandlers[osPrefix] = poHandler;
 }
 
+static void VSICleanupAsyncIOThreadPool();
+
 /************************************************************************/
 /*                       VSICleanupFileManager()                        */
 /************************************************************************/
@@ -2730,6 +3016,8 @@ void VSIFileManager::InstallHandler( const std::string& osPrefix,
 void VSICleanupFileManager()
 
 {
+    VSICleanupAsyncIOThreadPool();
+
     if( poManager )
     {
         delete poManager;
@@ -2809,4 +3097,279 @@ int VSIVirtualHandle::ReadMultiRange( int nRanges, void ** ppData,
     return nRet;
 }
 
+/************************************************************************/
+/*                          ~VSIMappedRegion()                          */
+/************************************************************************/
+
+VSIMappedRegion::~VSIMappedRegion() = default;
+
+/************************************************************************/
+/*                     VSIMappedRegionFileMapping                       */
+/************************************************************************/
+
+namespace {
+class VSIMappedRegionFileMapping final : public VSIMappedRegion
+{
+    CPLVirtualMem *m_psMapping = nullptr;
+
+  public:
+    explicit VSIMappedRegionFileMapping( CPLVirtualMem *psMapping ) :
+        m_psMapping(psMapping)
+    {
+        pData = CPLVirtualMemGetAddr(m_psMapping);
+        nSize = CPLVirtualMemGetSize(m_psMapping);
+        bZeroCopy = true;
+    }
+
+    ~VSIMappedRegionFileMapping() override
+    {
+        CPLVirtualMemFree(m_psMapping);
+    }
+};
+} // namespace
+
+/************************************************************************/
+/*                             MapRegion()                              */
+/************************************************************************/
+
+VSIMappedRegion *VSIVirtualHandle::MapRegion( vsi_l_offset nOffset,
+                                              size_t nSize )
+{
+    if( !CPLIsVirtualMemFileMapAvailable() ||
+        GetNativeFileDescriptor() == nullptr )
+    {
+        return nullptr;
+    }
+
+    // Make pending writes visible through the mapping.
+    Flush();
+
+    // Mapping beyond the end of file would cause SIGBUS on access.
+    const vsi_l_offset nCurPos = Tell();
+    if( Seek(0, SEEK_END) != 0 )
+        return nullptr;
+    const vsi_l_offset nFileSize = Tell();
+    if( Seek(nCurPos, SEEK_SET) != 0 || nFileSize <= nOffset )
+        return nullptr;
+    if( nSize == 0 )
+    {
+        if( nFileSize - nOffset >
+                static_cast<vsi_l_offset>(std::numeric_limits<size_t>::max()) )
+            return nullptr;
+        nSize = static_cast<size_t>(nFileSize - nOffset);
+    }
+    else if( nSize > nFileSize - nOffset )
+    {
+        return nullptr;
+    }
+
+    CPLVirtualMem* psMapping;
+    {
+        CPLErrorStateBackuper oErrorStateBackuper;
+        CPLErrorHandlerPusher oErrorHandler(CPLQuietErrorHandler);
+        psMapping = CPLVirtualMemFileMapNew(
+            reinterpret_cast<VSILFILE*>(this), nOffset, nSize,
+            VIRTUALMEM_READONLY, nullptr, nullptr);
+    }
+    if( psMapping == nullptr )
+        return nullptr;
+    return new VSIMappedRegionFileMapping(psMapping);
+}
+
+/************************************************************************/
+/*                           ~VSIAsyncRead()                            */
+/************************************************************************/
+
+VSIAsyncRead::~VSIAsyncRead() = default;
+
+namespace {
+
+/************************************************************************/
+/*                        VSIAsyncReadCompleted                         */
+/************************************************************************/
+
+// Request whose status is known at creation, used when the read is done
+// synchronously.
+class VSIAsyncReadCompleted final : public VSIAsyncRead
+{
+    int m_nRet;
+
+  public:
+    explicit VSIAsyncReadCompleted( int nRet ) : m_nRet(nRet) {}
+
+    bool IsDone() override { return true; }
+    int Wait() override { return m_nRet; }
+};
+
+/************************************************************************/
+/*                         VSIAsyncReadFromJobs                         */
+/************************************************************************/
+
+struct VSIAsyncReadState
+{
+    std::mutex              oMutex{};
+    std::condition_variable oCV{};
+    int                     nPendingJobs = 0;
+    bool                    bError = false;
+    std::string             osErrorMsg{};
+};
+
+struct VSIAsyncReadJobData
+{
+    std::shared_ptr<VSIAsyncReadState> poState{};
+    VSIAsyncReadJob                    oJob{};
+};
+
+static void VSIAsyncReadRunJob( void* pData )
+{
+    VSIAsyncReadJobData* psJobData = static_cast<VSIAsyncReadJobData*>(pData);
+    std::string osErrorMsg;
+    const bool bOK = psJobData->oJob(osErrorMsg);
+    {
+        std::lock_guard<std::mutex> oLock(psJobData->poState->oMutex);
+        if( !bOK && !psJobData->poState->bError )
+        {
+            psJobData->poState->bError = true;
+            psJobData->poState->osErrorMsg = osErrorMsg;
+        }
+        psJobData->poState->nPendingJobs --;
+    }
+    psJobData->poState->oCV.notify_all();
+    delete psJobData;
+}
+
+class VSIAsyncReadFromJobs final : public VSIAsyncRead
+{
+    std::shared_ptr<VSIAsyncReadState> m_poState;
+    bool m_bErrorReported = false;
+
+  public:
+    explicit VSIAsyncReadFromJobs(
+                        const std::shared_ptr<VSIAsyncReadState>& poState ) :
+        m_poState(poState) {}
+
+    ~VSIAsyncReadFromJobs() override
+    {
+        std::unique_lock<std::mutex> oLock(m_poState->oMutex);
+        m_poState->oCV.wait(oLock, [this]
+                            { return m_poState->nPendingJobs == 0; });
+    }
+
+    bool IsDone() override
+    {
+        std::lock_guard<std::mutex> oLock(m_poState->oMutex);
+        return m_poState->nPendingJobs == 0;
+    }
+
+    int Wait() override
+    {
+        std::unique_lock<std::mutex> oLock(m_poState->oMutex);
+        m_poState->oCV.wait(oLock, [this]
+                            { return m_poState->nPendingJobs == 0; });
+        if( !m_poState->bError )
+            return 0;
+        if( !m_bErrorReported )
+        {
+            m_bErrorReported = true;
+            CPLError(CE_Failure, CPLE_FileIO, "%s",
+                     m_poState->osErrorMsg.c_str());
+        }
+        return -1;
+    }
+};
+
+} // namespace
+
+/************************************************************************/
+/*                      VSIGetAsyncIOThreadPool()                       */
+/************************************************************************/
+
+static std::mutex gAsyncIOThreadPoolMutex;
+static CPLWorkerThreadPool* gpoAsyncIOThreadPool = nullptr;
+static bool gbAsyncIOThreadPoolFailed = false;
+
+static CPLWorkerThreadPool* VSIGetAsyncIOThreadPool()
+{
+    std::lock_guard<std::mutex> oLock(gAsyncIOThreadPoolMutex);
+    if( gpoAsyncIOThreadPool == nullptr && !gbAsyncIOThreadPoolFailed )
+    {
+        const int nThreads = std::max(1, std::min(128, atoi(
+            CPLGetConfigOption("CPL_VSIL_ASYNC_IO_THREADS", "8"))));
+        gpoAsyncIOThreadPool = new CPLWorkerThreadPool();
+        if( !gpoAsyncIOThreadPool->Setup(nThreads, nullptr, nullptr) )
+        {
+            delete gpoAsyncIOThreadPool;
+            gpoAsyncIOThreadPool = nullptr;
+            gbAsyncIOThreadPoolFailed = true;
+        }
+    }
+    return gpoAsyncIOThreadPool;
+}
+
+/************************************************************************/
+/*                    VSICleanupAsyncIOThreadPool()                     */
+/************************************************************************/
+
+static void VSICleanupAsyncIOThreadPool()
+{
+    std::lock_guard<std::mutex> oLock(gAsyncIOThreadPoolMutex);
+    delete gpoAsyncIOThreadPool;
+    gpoAsyncIOThreadPool = nullptr;
+    gbAsyncIOThreadPoolFailed = false;
+}
+
+/************************************************************************/
+/*                     VSICreateAsyncReadFromJobs()                     */
+/************************************************************************/
+
+VSIAsyncRead* VSICreateAsyncReadFromJobs( std::vector<VSIAsyncReadJob>&& aoJobs )
+{
+    auto poState = std::make_shared<VSIAsyncReadState>();
+    CPLWorkerThreadPool* poPool =
+        aoJobs.empty() ? nullptr : VSIGetAsyncIOThreadPool();
+    if( poPool == nullptr )
+    {
+        // Run the jobs synchronously.
+        for( auto& oJob: aoJobs )
+        {
+            std::string osErrorMsg;
+            if( !oJob(osErrorMsg) )
+            {
+                CPLError(CE_Failure, CPLE_FileIO, "%s", osErrorMsg.c_str());
+                return new VSIAsyncReadCompleted(-1);
+            }
+        }
+        return new VSIAsyncReadCompleted(0);
+    }
+
+    poState->nPendingJobs = static_cast<int>(aoJobs.size());
+    for( auto& oJob: aoJobs )
+    {
+        VSIAsyncReadJobData* psJobData = new VSIAsyncReadJobData();
+        psJobData->poState = poState;
+        psJobData->oJob = std::move(oJob);
+        if( !poPool->SubmitJob(VSIAsyncReadRunJob, psJobData) )
+        {
+            // Should not happen with a valid pool: run it in this thread.
+            VSIAsyncReadRunJob(psJobData);
+        }
+    }
+    return new VSIAsyncReadFromJobs(poState);
+}
+
+/************************************************************************/
+/*                        ReadMultiRangeAsync()                         */
+/************************************************************************/
+
+// Default emulation: read synchronously, since the handle cannot be used
+// from another thread while the caller may still use it.
+VSIAsyncRead *VSIVirtualHandle::ReadMultiRangeAsync(
+                                        int nRanges, void ** ppData,
+                                        const vsi_l_offset* panOffsets,
+                                        const size_t* panSizes )
+{
+    return new VSIAsyncReadCompleted(
+                    ReadMultiRange(nRanges, ppData, panOffsets, panSizes));
+}
+
 #endif  // #ifndef DOXYGEN_SKIP
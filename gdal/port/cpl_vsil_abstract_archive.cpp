@@ -29,13 +29,13 @@
 #include "cpl_port.h"
 #include "cpl_vsi_virtual.h"
 
+#include <algorithm>
 #include <cstring>
 #if HAVE_SYS_STAT_H
 #  include <sys/stat.h>
 #endif
 #include <ctime>
 #include <map>
-#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -199,7 +199,24 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
     content->entries = nullptr;
     oFileList[archiveFilename] = content;
 
-    std::set<CPLString> oSet;
+    // Grow the entries array geometrically, as archives may have tens of
+    // thousands of members.
+    int nEntriesAlloc = 0;
+    const auto AddEntry = [content, &nEntriesAlloc](char* pszFileName)
+    {
+        if( content->nEntries == nEntriesAlloc )
+        {
+            nEntriesAlloc = std::max(16, nEntriesAlloc + nEntriesAlloc / 2);
+            content->entries = static_cast<VSIArchiveEntry *>(
+                CPLRealloc(content->entries,
+                           sizeof(VSIArchiveEntry) * nEntriesAlloc));
+        }
+        content->oMapFileNameToIndex[pszFileName] = content->nEntries;
+        VSIArchiveEntry* psEntry = &content->entries[content->nEntries];
+        psEntry->fileName = pszFileName;
+        content->nEntries++;
+        return psEntry;
+    };
 
     do
     {
@@ -210,71 +227,48 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
         if( osStrippedFilename.empty() )
             continue;
 
-        if( oSet.find(osStrippedFilename) == oSet.end() )
+        if( content->oMapFileNameToIndex.find(osStrippedFilename) ==
+                content->oMapFileNameToIndex.end() )
         {
-            oSet.insert(osStrippedFilename);
-
             // Add intermediate directory structure.
             const char* pszBegin = osStrippedFilename.c_str();
             for( const char* pszIter = pszBegin; *pszIter; pszIter++ )
             {
                 if( *pszIter == '/' )
                 {
-                    char* pszStrippedFileName2 = CPLStrdup(osStrippedFilename);
-                    pszStrippedFileName2[pszIter - pszBegin] = 0;
-                    if( oSet.find(pszStrippedFileName2) == oSet.end() )
+                    const std::string osDir(pszBegin, pszIter - pszBegin);
+                    if( content->oMapFileNameToIndex.find(osDir) ==
+                            content->oMapFileNameToIndex.end() )
                     {
-                        oSet.insert(pszStrippedFileName2);
-
-                        content->entries = static_cast<VSIArchiveEntry *>(
-                            CPLRealloc(
-                                content->entries,
-                                sizeof(VSIArchiveEntry) *
-                                (content->nEntries + 1)));
-                        content->entries[content->nEntries].fileName =
-                            pszStrippedFileName2;
-                        content->entries[content->nEntries].nModifiedTime =
-                            poReader->GetModifiedTime();
-                        content->entries[content->nEntries].uncompressed_size =
-                            0;
-                        content->entries[content->nEntries].bIsDir = TRUE;
-                        content->entries[content->nEntries].file_pos = nullptr;
+                        VSIArchiveEntry* psEntry =
+                            AddEntry(CPLStrdup(osDir.c_str()));
+                        psEntry->nModifiedTime = poReader->GetModifiedTime();
+                        psEntry->uncompressed_size = 0;
+                        psEntry->bIsDir = TRUE;
+                        psEntry->file_pos = nullptr;
 #ifdef DEBUG_VERBOSE
-                        const int nEntries = content->nEntries;
                         CPLDebug(
                             "VSIArchive", "[%d] %s : " CPL_FRMT_GUIB " bytes",
-                            content->nEntries + 1,
-                            content->entries[nEntries].fileName,
-                            content->entries[nEntries].uncompressed_size);
+                            content->nEntries,
+                            psEntry->fileName,
+                            psEntry->uncompressed_size);
 #endif
-                        content->nEntries++;
-                    }
-                    else
-                    {
-                        CPLFree(pszStrippedFileName2);
                     }
                 }
             }
 
-            content->entries = static_cast<VSIArchiveEntry *>(
-                CPLRealloc(content->entries,
-                           sizeof(VSIArchiveEntry) * (content->nEntries + 1)));
-            content->entries[content->nEntries].fileName =
-                CPLStrdup(osStrippedFilename);
-            content->entries[content->nEntries].nModifiedTime =
-                poReader->GetModifiedTime();
-            content->entries[content->nEntries].uncompressed_size =
-                poReader->GetFileSize();
-            content->entries[content->nEntries].bIsDir = bIsDir;
-            content->entries[content->nEntries].file_pos =
-                poReader->GetFileOffset();
+            VSIArchiveEntry* psEntry =
+                AddEntry(CPLStrdup(osStrippedFilename));
+            psEntry->nModifiedTime = poReader->GetModifiedTime();
+            psEntry->uncompressed_size = poReader->GetFileSize();
+            psEntry->bIsDir = bIsDir;
+            psEntry->file_pos = poReader->GetFileOffset();
 #ifdef DEBUG_VERBOSE
             CPLDebug("VSIArchive", "[%d] %s : " CPL_FRMT_GUIB " bytes",
-                     content->nEntries+1,
-                     content->entries[content->nEntries].fileName,
-                     content->entries[content->nEntries].uncompressed_size);
+                     content->nEntries,
+                     psEntry->fileName,
+                     psEntry->uncompressed_size);
 #endif
-            content->nEntries++;
         }
 
     } while( poReader->GotoNextFile() );
@@ -301,14 +295,13 @@ VSIArchiveFilesystemHandler::FindFileInArchive(
     const VSIArchiveContent* content = GetContentOfArchive(archiveFilename);
     if( content )
     {
-        for( int i = 0; i < content->nEntries; i++ )
+        const auto oIter =
+            content->oMapFileNameToIndex.find(fileInArchiveName);
+        if( oIter != content->oMapFileNameToIndex.end() )
         {
-            if( strcmp(fileInArchiveName, content->entries[i].fileName) == 0)
-            {
-                if( archiveEntry )
-                    *archiveEntry = &content->entries[i];
-                return TRUE;
-            }
+            if( archiveEntry )
+                *archiveEntry = &content->entries[oIter->second];
+            return TRUE;
         }
     }
     return FALSE;
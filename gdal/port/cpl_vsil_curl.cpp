@@ -35,10 +35,13 @@
 #include <set>
 #include <map>
 #include <memory>
+#include <vector>
 
+#include "cpl_atomic_ops.h"
 #include "cpl_aws.h"
 #include "cpl_minixml.h"
 #include "cpl_multiproc.h"
+#include "cpl_sha256.h"
 #include "cpl_string.h"
 #include "cpl_time.h"
 #include "cpl_vsi.h"
@@ -1050,7 +1053,8 @@ retry:
                         poFS->AddRegion(m_pszURL,
                                         nOffset,
                                         DOWNLOAD_CHUNK_SIZE,
-                                        sWriteFuncData.pBuffer + nOffset);
+                                        sWriteFuncData.pBuffer + nOffset,
+                                        m_bCached ? &oFileProp : nullptr);
                     }
                 }
             }
@@ -1603,7 +1607,8 @@ void VSICurlHandle::DownloadRegionPostProcess( const vsi_l_offset startOffset,
 #endif
         const size_t nChunkSize =
             std::min(static_cast<size_t>(DOWNLOAD_CHUNK_SIZE), nSize);
-        poFS->AddRegion(m_pszURL, l_startOffset, nChunkSize, pBuffer);
+        poFS->AddRegion(m_pszURL, l_startOffset, nChunkSize, pBuffer,
+                        m_bCached ? &oFileProp : nullptr);
         l_startOffset += nChunkSize;
         pBuffer += nChunkSize;
         nSize -= nChunkSize;
@@ -1611,6 +1616,78 @@ void VSICurlHandle::DownloadRegionPostProcess( const vsi_l_offset startOffset,
 
 }
 
+/************************************************************************/
+/*                      DownloadRegionsInParallel()                     */
+/************************************************************************/
+
+// Download, with concurrent range requests, CPL_VSIL_CURL_READ_AHEAD_REQUESTS
+// consecutive windows of nBlocksPerRequest blocks from startOffset, and put
+// them in the region cache. Returns the content of the first window, or an
+// empty string if the caller must use DownloadRegion() instead.
+std::string VSICurlHandle::DownloadRegionsInParallel(
+                                            const vsi_l_offset startOffset,
+                                            const int nBlocksPerRequest )
+{
+    // Windows must all fit in the region cache, otherwise the last ones
+    // would evict the first ones before they are read.
+    const int nRequests = std::min(
+        atoi(CPLGetConfigOption("CPL_VSIL_CURL_READ_AHEAD_REQUESTS", "4")),
+        N_MAX_REGIONS / 2 / nBlocksPerRequest);
+    if( nRequests <= 1 || pfnReadCbk != nullptr ||
+        !oFileProp.bHasComputedFileSize || !AllowParallelReadAhead() )
+    {
+        return std::string();
+    }
+
+    const vsi_l_offset nRequestSize =
+        static_cast<vsi_l_offset>(nBlocksPerRequest) * DOWNLOAD_CHUNK_SIZE;
+    std::vector<vsi_l_offset> anOffsets;
+    std::vector<size_t> anSizes;
+    for( int i = 0; i < nRequests; i++ )
+    {
+        const vsi_l_offset nOffset = startOffset + i * nRequestSize;
+        if( nOffset >= oFileProp.fileSize )
+            break;
+        anOffsets.push_back(nOffset);
+        anSizes.push_back(static_cast<size_t>(
+            std::min(nRequestSize, oFileProp.fileSize - nOffset)));
+    }
+    const int nRanges = static_cast<int>(anOffsets.size());
+    if( nRanges <= 1 )
+        return std::string();
+
+    std::vector<std::string> aosBuffers(nRanges);
+    std::vector<void*> apData(nRanges);
+    for( int i = 0; i < nRanges; i++ )
+    {
+        aosBuffers[i].resize(anSizes[i]);
+        apData[i] = &aosBuffers[i][0];
+    }
+
+    int nRet;
+    {
+        // A failure is not fatal, since the caller falls back to a regular
+        // download, which knows how to retry.
+        CPLErrorStateBackuper oErrorStateBackuper;
+        CPLErrorHandlerPusher oErrorHandler(CPLQuietErrorHandler);
+        nRet = ReadMultiRangeParallel(nRanges, &apData[0], &anOffsets[0],
+                                      &anSizes[0], false);
+    }
+    if( nRet != 0 )
+    {
+        CPLDebug("VSICURL", "Parallel read-ahead failed. "
+                 "Falling back to sequential download");
+        return std::string();
+    }
+
+    for( int i = 0; i < nRanges; i++ )
+    {
+        DownloadRegionPostProcess(anOffsets[i], nBlocksPerRequest,
+                                  aosBuffers[i].data(), aosBuffers[i].size());
+    }
+    return aosBuffers[0];
+}
+
 /************************************************************************/
 /*                                Read()                                */
 /************************************************************************/
@@ -1648,14 +1725,16 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
         const vsi_l_offset nOffsetToDownload =
                 (iterOffset / DOWNLOAD_CHUNK_SIZE) * DOWNLOAD_CHUNK_SIZE;
         std::string osRegion;
-        std::shared_ptr<std::string> psRegion = poFS->GetRegion(m_pszURL, nOffsetToDownload);
+        std::shared_ptr<std::string> psRegion = poFS->GetRegion(
+            m_pszURL, nOffsetToDownload, m_bCached ? &oFileProp : nullptr);
         if( psRegion != nullptr )
         {
             osRegion = *psRegion;
         }
         else
         {
-            if( nOffsetToDownload == lastDownloadedOffset )
+            const bool bSequential = nOffsetToDownload == lastDownloadedOffset;
+            if( bSequential )
             {
                 // In case of consecutive reads (of small size), we use a
                 // heuristic that we will read the file sequentially, so
@@ -1689,7 +1768,8 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
             {
                 if( poFS->GetRegion(
                         m_pszURL,
-                        nOffsetToDownload + i * DOWNLOAD_CHUNK_SIZE) != nullptr )
+                        nOffsetToDownload + i * DOWNLOAD_CHUNK_SIZE,
+                        m_bCached ? &oFileProp : nullptr) != nullptr )
                 {
                     nBlocksToDownload = i;
                     break;
@@ -1699,7 +1779,15 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
             if( nBlocksToDownload > N_MAX_REGIONS )
                 nBlocksToDownload = N_MAX_REGIONS;
 
-            osRegion = DownloadRegion(nOffsetToDownload, nBlocksToDownload);
+            // Once the sequential window has stopped growing, fetch several
+            // windows ahead of the reader with parallel range requests.
+            if( bSequential && nBlocksToDownload >= 100 )
+            {
+                osRegion = DownloadRegionsInParallel(nOffsetToDownload,
+                                                     nBlocksToDownload);
+            }
+            if( osRegion.empty() )
+                osRegion = DownloadRegion(nOffsetToDownload, nBlocksToDownload);
             if( osRegion.empty() )
             {
                 if( !bInterrupted )
@@ -1733,6 +1821,80 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
     return ret;
 }
 
+/************************************************************************/
+/*                       VSICurlMultiRangeRequest                       */
+/************************************************************************/
+
+// State of range requests issued in parallel on a multi handle.
+struct VSICurlMultiRangeRequest
+{
+    struct CurlErrBuffer
+    {
+        std::array<char,CURL_ERROR_SIZE+1> szCurlErrBuf;
+    };
+
+    CPLString                       osURL;
+    bool                            bMergeConsecutiveRanges;
+    std::vector<void*>              apData;
+    std::vector<vsi_l_offset>       anOffsets;
+    std::vector<size_t>             anSizes;
+    CURLM                          *hMultiHandle = nullptr;
+    bool                            bOwnMultiHandle = false;
+    std::vector<CURL*>              aHandles{};
+    std::vector<WriteFuncStruct>    asWriteFuncData;
+    std::vector<WriteFuncStruct>    asWriteFuncHeaderData;
+    std::vector<char*>              apszRanges{};
+    std::vector<struct curl_slist*> aHeaders{};
+    std::vector<CurlErrBuffer>      asCurlErrors;
+
+    VSICurlMultiRangeRequest( const CPLString& osURLIn, int nRanges,
+                              void ** ppData,
+                              const vsi_l_offset* panOffsets,
+                              const size_t* panSizes,
+                              bool bMergeConsecutiveRangesIn ) :
+        osURL(osURLIn),
+        bMergeConsecutiveRanges(bMergeConsecutiveRangesIn),
+        apData(ppData, ppData + nRanges),
+        anOffsets(panOffsets, panOffsets + nRanges),
+        anSizes(panSizes, panSizes + nRanges),
+        asWriteFuncData(nRanges),
+        asWriteFuncHeaderData(nRanges),
+        asCurlErrors(nRanges)
+    {}
+
+    ~VSICurlMultiRangeRequest()
+    {
+        ReleaseHandles();
+        if( bOwnMultiHandle )
+            curl_multi_cleanup(hMultiHandle);
+    }
+
+    void ReleaseHandles()
+    {
+        for( size_t i = 0; i < aHandles.size(); i++ )
+        {
+            curl_multi_remove_handle(hMultiHandle, aHandles[i]);
+            VSICURLResetHeaderAndWriterFunctions(aHandles[i]);
+            curl_easy_cleanup(aHandles[i]);
+            CPLFree(apszRanges[i]);
+            CPLFree(asWriteFuncData[i].pBuffer);
+            asWriteFuncData[i].pBuffer = nullptr;
+            CPLFree(asWriteFuncHeaderData[i].pBuffer);
+            asWriteFuncHeaderData[i].pBuffer = nullptr;
+            curl_slist_free_all(aHeaders[i]);
+        }
+        aHandles.clear();
+        apszRanges.clear();
+        aHeaders.clear();
+    }
+
+  private:
+    CPL_DISALLOW_COPY_ASSIGN(VSICurlMultiRangeRequest)
+};
+
+static int FinishMultiRangeParallel( VSICurlMultiRangeRequest& oRequest,
+                                     std::vector<CPLString>& aosErrors );
+
 /************************************************************************/
 /*                           ReadMultiRange()                           */
 /************************************************************************/
@@ -1762,6 +1924,91 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
                                     nRanges, ppData, panOffsets, panSizes);
     }
 
+    const bool bMergeConsecutiveRanges = CPLTestBool(CPLGetConfigOption(
+        "GDAL_HTTP_MERGE_CONSECUTIVE_RANGES", "TRUE"));
+
+    return ReadMultiRangeParallel(nRanges, ppData, panOffsets, panSizes,
+                                  bMergeConsecutiveRanges);
+}
+
+/************************************************************************/
+/*                       ReadMultiRangeAsync()                          */
+/************************************************************************/
+
+VSIAsyncRead *VSICurlHandle::ReadMultiRangeAsync(
+                                        int const nRanges,
+                                        void ** const ppData,
+                                        const vsi_l_offset* const panOffsets,
+                                        const size_t* const panSizes )
+{
+    // Cases that need the synchronous machinery (interruption, read
+    // callback, redirect renewal, alternate strategies) are not emulated.
+    if( (bInterrupted && bStopOnInterruptUntilUninstall) ||
+        pfnReadCbk != nullptr )
+    {
+        return VSIVirtualHandle::ReadMultiRangeAsync(
+                                    nRanges, ppData, panOffsets, panSizes);
+    }
+
+    poFS->GetCachedFileProp(m_pszURL, oFileProp);
+    const char* pszMultiRangeStrategy =
+        CPLGetConfigOption("GDAL_HTTP_MULTIRANGE", "");
+    if( oFileProp.eExists == EXIST_NO ||
+        EQUAL(pszMultiRangeStrategy, "SINGLE_GET") ||
+        EQUAL(pszMultiRangeStrategy, "SERIAL") )
+    {
+        return VSIVirtualHandle::ReadMultiRangeAsync(
+                                    nRanges, ppData, panOffsets, panSizes);
+    }
+
+    bool bHasExpired = false;
+    CPLString osURL(GetRedirectURLIfValid(bHasExpired));
+    if( bHasExpired )
+    {
+        return VSIVirtualHandle::ReadMultiRangeAsync(
+                                    nRanges, ppData, panOffsets, panSizes);
+    }
+
+    auto poRequest = std::make_shared<VSICurlMultiRangeRequest>(
+        osURL, nRanges, ppData, panOffsets, panSizes,
+        CPLTestBool(CPLGetConfigOption(
+            "GDAL_HTTP_MERGE_CONSECUTIVE_RANGES", "TRUE")));
+    // The connection cache of the file system is per-thread, so the request
+    // gets its own multi handle to be driven from the worker thread.
+    poRequest->hMultiHandle = curl_multi_init();
+    poRequest->bOwnMultiHandle = true;
+    PrepareMultiRangeParallel(*poRequest, false);
+
+    std::vector<VSIAsyncReadJob> aoJobs;
+    if( !poRequest->aHandles.empty() )
+    {
+        aoJobs.emplace_back([poRequest](std::string& osErrorMsg)
+        {
+            MultiPerform(poRequest->hMultiHandle);
+            std::vector<CPLString> aosErrors;
+            if( FinishMultiRangeParallel(*poRequest, aosErrors) == 0 )
+                return true;
+            osErrorMsg = aosErrors.empty() ?
+                std::string("Multi-range request failed") :
+                std::string(aosErrors[0]);
+            return false;
+        });
+    }
+    return VSICreateAsyncReadFromJobs(std::move(aoJobs));
+}
+
+/************************************************************************/
+/*                       ReadMultiRangeParallel()                       */
+/************************************************************************/
+
+// Issue one range request per range (or group of consecutive ranges if
+// bMergeConsecutiveRanges), all in flight at the same time.
+int VSICurlHandle::ReadMultiRangeParallel( int const nRanges,
+                                           void ** const ppData,
+                                           const vsi_l_offset* const panOffsets,
+                                           const size_t* const panSizes,
+                                           bool bMergeConsecutiveRanges )
+{
     bool bHasExpired = false;
     CPLString osURL(GetRedirectURLIfValid(bHasExpired));
     if( bHasExpired )
@@ -1770,7 +2017,36 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
                                     nRanges, ppData, panOffsets, panSizes);
     }
 
-    CURLM * hMultiHandle = poFS->GetCurlMultiHandleFor(osURL);
+    VSICurlMultiRangeRequest oRequest(osURL, nRanges, ppData, panOffsets,
+                                      panSizes, bMergeConsecutiveRanges);
+    oRequest.hMultiHandle = poFS->GetCurlMultiHandleFor(osURL);
+    PrepareMultiRangeParallel(oRequest, true);
+
+    if( !oRequest.aHandles.empty() )
+    {
+        MultiPerform(oRequest.hMultiHandle);
+    }
+
+    std::vector<CPLString> aosErrors;
+    const int nRet = FinishMultiRangeParallel(oRequest, aosErrors);
+    for( const auto& osError: aosErrors )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "%s", osError.c_str());
+    }
+    return nRet;
+}
+
+/************************************************************************/
+/*                     PrepareMultiRangeParallel()                      */
+/************************************************************************/
+
+// Create the easy handles of the range requests and add them to the multi
+// handle of oRequest, without performing them.
+void VSICurlHandle::PrepareMultiRangeParallel(
+                                        VSICurlMultiRangeRequest& oRequest,
+                                        bool bWithReadCbk )
+{
+    CURLM* hMultiHandle = oRequest.hMultiHandle;
 #ifdef CURLPIPE_MULTIPLEX
     // Enable HTTP/2 multiplexing (ignored if an older version of HTTP is
     // used)
@@ -1785,27 +2061,17 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
     }
 #endif
 
-    std::vector<CURL*> aHandles;
-    std::vector<WriteFuncStruct> asWriteFuncData(nRanges);
-    std::vector<WriteFuncStruct> asWriteFuncHeaderData(nRanges);
-    std::vector<char*> apszRanges;
-    std::vector<struct curl_slist*> aHeaders;
-
-    struct CurlErrBuffer
-    {
-        std::array<char,CURL_ERROR_SIZE+1> szCurlErrBuf;
-    };
-    std::vector<CurlErrBuffer> asCurlErrors(nRanges);
-
-    const bool bMergeConsecutiveRanges = CPLTestBool(CPLGetConfigOption(
-        "GDAL_HTTP_MERGE_CONSECUTIVE_RANGES", "TRUE"));
+    const CPLString& osURL = oRequest.osURL;
+    const int nRanges = static_cast<int>(oRequest.anSizes.size());
+    const vsi_l_offset* const panOffsets = oRequest.anOffsets.data();
+    const size_t* const panSizes = oRequest.anSizes.data();
 
     for( int i = 0, iRequest = 0; i < nRanges; )
     {
         size_t nSize = 0;
         int iNext = i;
         // Identify consecutive ranges
-        while( bMergeConsecutiveRanges &&
+        while( oRequest.bMergeConsecutiveRanges &&
                iNext + 1 < nRanges &&
                panOffsets[iNext] + panSizes[iNext] == panOffsets[iNext+1] )
         {
@@ -1814,10 +2080,13 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
         }
         nSize += panSizes[iNext];
         if( nSize == 0 )
+        {
+            i = iNext + 1;
             continue;
+        }
 
         CURL* hCurlHandle = curl_easy_init();
-        aHandles.push_back(hCurlHandle);
+        oRequest.aHandles.push_back(hCurlHandle);
 
         // As the multi-range request is likely not the first one, we don't
         // need to wait as we already know if pipelining is possible
@@ -1826,67 +2095,92 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
         struct curl_slist* headers =
             VSICurlSetOptions(hCurlHandle, osURL, m_papszHTTPOptions);
 
-        VSICURLInitWriteFuncStruct(&asWriteFuncData[iRequest],
-                                reinterpret_cast<VSILFILE *>(this),
-                                pfnReadCbk, pReadCbkUserData);
-        curl_easy_setopt(hCurlHandle, CURLOPT_WRITEDATA,
-                         &asWriteFuncData[iRequest]);
+        WriteFuncStruct& sWriteFuncData = oRequest.asWriteFuncData[iRequest];
+        WriteFuncStruct& sWriteFuncHeaderData =
+            oRequest.asWriteFuncHeaderData[iRequest];
+        if( bWithReadCbk )
+        {
+            VSICURLInitWriteFuncStruct(&sWriteFuncData,
+                                       reinterpret_cast<VSILFILE *>(this),
+                                       pfnReadCbk, pReadCbkUserData);
+        }
+        else
+        {
+            VSICURLInitWriteFuncStruct(&sWriteFuncData,
+                                       nullptr, nullptr, nullptr);
+        }
+        curl_easy_setopt(hCurlHandle, CURLOPT_WRITEDATA, &sWriteFuncData);
         curl_easy_setopt(hCurlHandle, CURLOPT_WRITEFUNCTION,
                         VSICurlHandleWriteFunc);
 
-        VSICURLInitWriteFuncStruct(&asWriteFuncHeaderData[iRequest],
+        VSICURLInitWriteFuncStruct(&sWriteFuncHeaderData,
                                    nullptr, nullptr, nullptr);
         curl_easy_setopt(hCurlHandle, CURLOPT_HEADERDATA,
-                         &asWriteFuncHeaderData[iRequest]);
+                         &sWriteFuncHeaderData);
         curl_easy_setopt(hCurlHandle, CURLOPT_HEADERFUNCTION,
                          VSICurlHandleWriteFunc);
-        asWriteFuncHeaderData[iRequest].bIsHTTP = STARTS_WITH(m_pszURL, "http");
-        asWriteFuncHeaderData[iRequest].nStartOffset = panOffsets[i];
+        sWriteFuncHeaderData.bIsHTTP = STARTS_WITH(m_pszURL, "http");
+        sWriteFuncHeaderData.nStartOffset = panOffsets[i];
 
-        asWriteFuncHeaderData[iRequest].nEndOffset = panOffsets[i] + nSize-1;
+        sWriteFuncHeaderData.nEndOffset = panOffsets[i] + nSize-1;
 
         char rangeStr[512] = {};
         snprintf(rangeStr, sizeof(rangeStr),
                 CPL_FRMT_GUIB "-" CPL_FRMT_GUIB,
-                asWriteFuncHeaderData[iRequest].nStartOffset,
-                asWriteFuncHeaderData[iRequest].nEndOffset);
+                sWriteFuncHeaderData.nStartOffset,
+                sWriteFuncHeaderData.nEndOffset);
 
         if( ENABLE_DEBUG )
             CPLDebug("VSICURL", "Downloading %s (%s)...", rangeStr, osURL.c_str());
 
-        if( asWriteFuncHeaderData[iRequest].bIsHTTP )
+        if( sWriteFuncHeaderData.bIsHTTP )
         {
             CPLString osHeaderRange;
             osHeaderRange.Printf("Range: bytes=%s", rangeStr);
             // So it gets included in Azure signature
             char* pszRange = CPLStrdup(osHeaderRange);
-            apszRanges.push_back(pszRange);
+            oRequest.apszRanges.push_back(pszRange);
             headers = curl_slist_append(headers, pszRange);
             curl_easy_setopt(hCurlHandle, CURLOPT_RANGE, nullptr);
         }
         else
         {
-            apszRanges.push_back(nullptr);
+            oRequest.apszRanges.push_back(nullptr);
             curl_easy_setopt(hCurlHandle, CURLOPT_RANGE, rangeStr);
         }
 
-        asCurlErrors[iRequest].szCurlErrBuf[0] = '\0';
+        oRequest.asCurlErrors[iRequest].szCurlErrBuf[0] = '\0';
         curl_easy_setopt(hCurlHandle, CURLOPT_ERRORBUFFER,
-                         &asCurlErrors[iRequest].szCurlErrBuf[0] );
+                         &oRequest.asCurlErrors[iRequest].szCurlErrBuf[0] );
 
         headers = VSICurlMergeHeaders(headers, GetCurlHeaders("GET", headers));
         curl_easy_setopt(hCurlHandle, CURLOPT_HTTPHEADER, headers);
-        aHeaders.push_back(headers);
+        oRequest.aHeaders.push_back(headers);
         curl_multi_add_handle(hMultiHandle, hCurlHandle);
 
         i = iNext + 1;
         iRequest ++;
     }
+}
 
-    if( !aHandles.empty() )
-    {
-        MultiPerform(hMultiHandle);
-    }
+/************************************************************************/
+/*                      FinishMultiRangeParallel()                      */
+/************************************************************************/
+
+// Collect the result of the range requests performed on the multi handle
+// of oRequest into the destination buffers, and release the easy handles.
+// Errors are appended to aosErrors rather than emitted, since this may run
+// in a worker thread.
+static int FinishMultiRangeParallel( VSICurlMultiRangeRequest& oRequest,
+                                     std::vector<CPLString>& aosErrors )
+{
+    const int nRanges = static_cast<int>(oRequest.anSizes.size());
+    const vsi_l_offset* const panOffsets = oRequest.anOffsets.data();
+    const size_t* const panSizes = oRequest.anSizes.data();
+    void* const* ppData = oRequest.apData.data();
+    auto& aHandles = oRequest.aHandles;
+    auto& asWriteFuncData = oRequest.asWriteFuncData;
+    auto& asWriteFuncHeaderData = oRequest.asWriteFuncHeaderData;
 
     int nRet = 0;
     size_t iReq = 0;
@@ -1903,7 +2197,7 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
         long response_code = 0;
         curl_easy_getinfo(aHandles[iReq], CURLINFO_HTTP_CODE, &response_code);
 
-        if( ENABLE_DEBUG && asCurlErrors[iRange].szCurlErrBuf[0] != '\0' )
+        if( ENABLE_DEBUG && oRequest.asCurlErrors[iReq].szCurlErrBuf[0] != '\0' )
         {
             char rangeStr[512] = {};
             snprintf(rangeStr, sizeof(rangeStr),
@@ -1911,9 +2205,9 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
                     asWriteFuncHeaderData[iReq].nStartOffset,
                     asWriteFuncHeaderData[iReq].nEndOffset);
 
-            const char* pszErrorMsg = &asCurlErrors[iRange].szCurlErrBuf[0];
+            const char* pszErrorMsg = &oRequest.asCurlErrors[iReq].szCurlErrBuf[0];
             CPLDebug("VSICURL", "ReadMultiRange(%s), %s: response_code=%d, msg=%s",
-                     osURL.c_str(),
+                     oRequest.osURL.c_str(),
                      rangeStr,
                      static_cast<int>(response_code),
                      pszErrorMsg);
@@ -1930,8 +2224,7 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
                     asWriteFuncHeaderData[iReq].nStartOffset,
                     asWriteFuncHeaderData[iReq].nEndOffset);
 
-            CPLError(CE_Failure, CPLE_AppDefined,
-                     "Request for %s failed", rangeStr);
+            aosErrors.push_back(CPLSPrintf("Request for %s failed", rangeStr));
             nRet = -1;
         }
         else if( nRet == 0 )
@@ -1954,7 +2247,7 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
                             panSizes[iRange] );
                 }
 
-                if( bMergeConsecutiveRanges &&
+                if( oRequest.bMergeConsecutiveRanges &&
                     iRange + 1 < nRanges &&
                     panOffsets[iRange] + panSizes[iRange] ==
                                                     panOffsets[iRange + 1] )
@@ -1969,16 +2262,10 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
                 }
             }
         }
-
-        curl_multi_remove_handle(hMultiHandle, aHandles[iReq]);
-        VSICURLResetHeaderAndWriterFunctions(aHandles[iReq]);
-        curl_easy_cleanup(aHandles[iReq]);
-        CPLFree(apszRanges[iReq]);
-        CPLFree(asWriteFuncData[iReq].pBuffer);
-        CPLFree(asWriteFuncHeaderData[iReq].pBuffer);
-        curl_slist_free_all(aHeaders[iReq]);
     }
 
+    oRequest.ReleaseHandles();
+
     if( ENABLE_DEBUG )
         CPLDebug("VSICURL", "Download completed");
 
@@ -2531,27 +2818,346 @@ CURLM* VSICurlFilesystemHandler::GetCurlMultiHandleFor(const CPLString& /*osURL*
     return conn.hCurlMultiHandle;
 }
 
+/************************************************************************/
+/*                    VSICurlGetDiskCacheFilename()                     */
+/************************************************************************/
+
+// Files of the persistent disk cache start with this signature, followed
+// by the content of the region.
+static const char DISK_CACHE_SIGNATURE[] = "GDALVCC1";
+constexpr size_t DISK_CACHE_SIGNATURE_SIZE = sizeof(DISK_CACHE_SIGNATURE) - 1;
+
+// Return the name of the file of the persistent disk cache that stores the
+// region starting at nFileOffsetStart, or an empty string if the disk cache
+// is disabled or if the remote file has no ETag or modification time that
+// would let us detect it has changed.
+static CPLString VSICurlGetDiskCacheFilename( const char* pszURL,
+                                              const FileProp& oFileProp,
+                                              vsi_l_offset nFileOffsetStart )
+{
+    const char* pszCacheDir =
+        CPLGetConfigOption("CPL_VSIL_CURL_DISK_CACHE_DIR", nullptr);
+    if( pszCacheDir == nullptr || pszCacheDir[0] == '\0' )
+        return CPLString();
+
+    CPLString osKey(pszURL);
+    if( !oFileProp.ETag.empty() )
+        osKey += "\nETag:" + oFileProp.ETag;
+    else if( oFileProp.mTime > 0 )
+        osKey += CPLSPrintf("\nmtime:" CPL_FRMT_GIB,
+                            static_cast<GIntBig>(oFileProp.mTime));
+    else
+        return CPLString();
+    osKey += CPLSPrintf("\n%d\n" CPL_FRMT_GUIB,
+                        DOWNLOAD_CHUNK_SIZE, nFileOffsetStart);
+
+    // The key is hashed, so that credentials that might be in the URL do
+    // not end up on disk.
+    GByte abyHash[CPL_SHA256_HASH_SIZE];
+    CPL_SHA256(osKey.data(), osKey.size(), abyHash);
+    char* pszHex = CPLBinaryToHex(CPL_SHA256_HASH_SIZE, abyHash);
+    CPLString osHex(pszHex);
+    CPLFree(pszHex);
+
+    return CPLFormFilename(CPLFormFilename(pszCacheDir,
+                                           osHex.substr(0, 2).c_str(),
+                                           nullptr),
+                           osHex.substr(2).c_str(), nullptr);
+}
+
+/************************************************************************/
+/*                     VSICurlReadDiskCacheFile()                       */
+/************************************************************************/
+
+// The modification time of a cache file is its last access time, which
+// VSICurlTrimDiskCache() uses to evict the least recently used files. It is
+// refreshed on cache hits at most once per this number of seconds.
+constexpr GIntBig DISK_CACHE_ACCESS_TIME_RESOLUTION = 60;
+
+static std::shared_ptr<std::string>
+VSICurlReadDiskCacheFile( const CPLString& osCacheFilename )
+{
+    VSIStatBufL sStat;
+    if( VSIStatL(osCacheFilename, &sStat) != 0 )
+        return nullptr;
+    const vsi_l_offset nFileSize = static_cast<vsi_l_offset>(sStat.st_size);
+    if( nFileSize <= DISK_CACHE_SIGNATURE_SIZE ||
+        nFileSize > DISK_CACHE_SIGNATURE_SIZE + DOWNLOAD_CHUNK_SIZE )
+        return nullptr;
+    const bool bTouch = static_cast<GIntBig>(time(nullptr)) -
+        static_cast<GIntBig>(sStat.st_mtime) >= DISK_CACHE_ACCESS_TIME_RESOLUTION;
+
+    // Open in update mode if the access time must be refreshed, falling
+    // back to read-only mode if the cache is not writable.
+    VSILFILE* fp = bTouch ? VSIFOpenL(osCacheFilename, "r+b") : nullptr;
+    const bool bUpdate = fp != nullptr;
+    if( fp == nullptr )
+        fp = VSIFOpenL(osCacheFilename, "rb");
+    if( fp == nullptr )
+        return nullptr;
+
+    std::shared_ptr<std::string> value;
+    char szSignature[DISK_CACHE_SIGNATURE_SIZE] = {};
+    if( VSIFReadL(szSignature, DISK_CACHE_SIGNATURE_SIZE, 1, fp) == 1 &&
+        memcmp(szSignature, DISK_CACHE_SIGNATURE,
+               DISK_CACHE_SIGNATURE_SIZE) == 0 )
+    {
+        const size_t nSize =
+            static_cast<size_t>(nFileSize - DISK_CACHE_SIGNATURE_SIZE);
+        value.reset(new std::string());
+        value->resize(nSize);
+        if( VSIFReadL(&(*value)[0], nSize, 1, fp) != 1 )
+            value.reset();
+        // Rewriting the signature in place updates the modification time
+        // through the VSI API, without changing the content seen by
+        // concurrent readers.
+        else if( bUpdate )
+        {
+            CPL_IGNORE_RET_VAL(VSIFSeekL(fp, 0, SEEK_SET));
+            CPL_IGNORE_RET_VAL(VSIFWriteL(DISK_CACHE_SIGNATURE,
+                                          DISK_CACHE_SIGNATURE_SIZE, 1, fp));
+        }
+    }
+    VSIFCloseL(fp);
+    return value;
+}
+
+/************************************************************************/
+/*                      VSICurlTrimDiskCache()                          */
+/************************************************************************/
+
+// Remove the least recently used files of the disk cache until its size is
+// reasonably below nMaxSize. Only files whose name matches the ones created by
+// VSICurlGetDiskCacheFilename() are considered, so that a badly chosen
+// cache directory does not get wiped out.
+static void VSICurlTrimDiskCache( const char* pszCacheDir, GIntBig nMaxSize )
+{
+    struct CacheFile
+    {
+        CPLString osFilename{};
+        GIntBig   nSize = 0;
+        GIntBig   nMTime = 0;
+    };
+    std::vector<CacheFile> aoFiles;
+    GIntBig nTotalSize = 0;
+    const GIntBig nNow = static_cast<GIntBig>(time(nullptr));
+
+    const auto IsHex = [](const char* pszStr, size_t nLen)
+    {
+        for( size_t i = 0; i < nLen; i++ )
+        {
+            const char ch = pszStr[i];
+            if( !((ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'F')) )
+                return false;
+        }
+        return true;
+    };
+    constexpr size_t FILENAME_LEN = 2 * CPL_SHA256_HASH_SIZE - 2;
+
+    CPLStringList aosSubDirs(VSIReadDir(pszCacheDir));
+    for( int i = 0; i < aosSubDirs.size(); i++ )
+    {
+        if( strlen(aosSubDirs[i]) != 2 || !IsHex(aosSubDirs[i], 2) )
+            continue;
+        const CPLString osSubDir(
+            CPLFormFilename(pszCacheDir, aosSubDirs[i], nullptr));
+        CPLStringList aosFiles(VSIReadDir(osSubDir));
+        for( int j = 0; j < aosFiles.size(); j++ )
+        {
+            const char* pszName = aosFiles[j];
+            if( strlen(pszName) < FILENAME_LEN ||
+                !IsHex(pszName, FILENAME_LEN) )
+                continue;
+            CacheFile oFile;
+            oFile.osFilename = CPLFormFilename(osSubDir, pszName, nullptr);
+            VSIStatBufL sStat;
+            if( VSIStatL(oFile.osFilename, &sStat) != 0 )
+                continue;
+            if( pszName[FILENAME_LEN] != '\0' )
+            {
+                // Temporary file of a writer that has presumably crashed.
+                if( EQUAL(CPLGetExtension(pszName), "tmp") &&
+                    nNow - static_cast<GIntBig>(sStat.st_mtime) > 3600 )
+                {
+                    VSIUnlink(oFile.osFilename);
+                }
+                continue;
+            }
+            oFile.nSize = static_cast<GIntBig>(sStat.st_size);
+            oFile.nMTime = static_cast<GIntBig>(sStat.st_mtime);
+            nTotalSize += oFile.nSize;
+            aoFiles.push_back(oFile);
+        }
+    }
+    if( nTotalSize <= nMaxSize )
+        return;
+
+    std::sort(aoFiles.begin(), aoFiles.end(),
+              [](const CacheFile& a, const CacheFile& b)
+              { return a.nMTime < b.nMTime; });
+    const GIntBig nTargetSize = nMaxSize - nMaxSize / 10;
+    for( const auto& oFile: aoFiles )
+    {
+        if( nTotalSize <= nTargetSize )
+            break;
+        // Another process might have removed it in the meantime
+        if( VSIUnlink(oFile.osFilename) == 0 )
+            nTotalSize -= oFile.nSize;
+    }
+}
+
+/************************************************************************/
+/*                       AddRegionToDiskCache()                         */
+/************************************************************************/
+
+void VSICurlFilesystemHandler::AddRegionToDiskCache(
+                                            const CPLString& osCacheFilename,
+                                            size_t nSize,
+                                            const char *pData )
+{
+    VSIStatBufL sStat;
+    if( nSize == 0 || VSIStatL(osCacheFilename, &sStat) == 0 )
+        return;
+
+    const CPLString osSubDir(CPLGetPath(osCacheFilename));
+    const CPLString osCacheDir(CPLGetPath(osSubDir));
+    if( VSIStatL(osSubDir, &sStat) != 0 )
+    {
+        VSIMkdir(osCacheDir, 0755);
+        VSIMkdir(osSubDir, 0755);
+    }
+
+    // Write in a temporary file that is then renamed, so that concurrent
+    // readers, possibly from other processes, never see a partial file.
+    static volatile int nCounter = 0;
+    const CPLString osTmpFilename(osCacheFilename +
+        CPLSPrintf(".%d.%d.tmp", CPLGetCurrentProcessID(),
+                   CPLAtomicInc(&nCounter)));
+    VSILFILE* fp = VSIFOpenL(osTmpFilename, "wb");
+    if( fp == nullptr )
+    {
+        CPLDebug("VSICURL", "Cannot create %s", osTmpFilename.c_str());
+        return;
+    }
+    bool bOK =
+        VSIFWriteL(DISK_CACHE_SIGNATURE, DISK_CACHE_SIGNATURE_SIZE, 1, fp) == 1 &&
+        VSIFWriteL(pData, nSize, 1, fp) == 1;
+    if( VSIFCloseL(fp) != 0 )
+        bOK = false;
+    if( !bOK || VSIRename(osTmpFilename, osCacheFilename) != 0 )
+    {
+        VSIUnlink(osTmpFilename);
+        return;
+    }
+
+    const GIntBig nMaxSize = std::max(static_cast<GIntBig>(DOWNLOAD_CHUNK_SIZE),
+        CPLAtoGIntBig(CPLGetConfigOption("CPL_VSIL_CURL_DISK_CACHE_SIZE",
+                                         "1073741824")));
+    CPLJoinableThread* hPreviousThread = nullptr;
+    {
+        CPLMutexHolder oHolder( &hMutex );
+        m_nDiskCacheBytesWritten += static_cast<GIntBig>(nSize);
+        // Check the size of the cache when the first region is written,
+        // and then each time a sixteenth of its maximum size has been
+        // written by this process, unless the previous check is still
+        // running.
+        if( m_bDiskCacheTrimRunning ||
+            (m_bDiskCacheTrimmed && m_nDiskCacheBytesWritten <= nMaxSize / 16) )
+        {
+            return;
+        }
+        m_bDiskCacheTrimmed = true;
+        m_nDiskCacheBytesWritten = 0;
+        m_bDiskCacheTrimRunning = true;
+        m_osDiskCacheTrimDir = osCacheDir;
+        m_nDiskCacheTrimMaxSize = nMaxSize;
+        hPreviousThread = m_hDiskCacheTrimThread;
+        m_hDiskCacheTrimThread = nullptr;
+    }
+    // Already finished, since m_bDiskCacheTrimRunning was false.
+    if( hPreviousThread )
+        CPLJoinThread(hPreviousThread);
+
+    // Scanning the cache directory can be slow, so do it in the background
+    // rather than on the thread that is waiting for data.
+    CPLJoinableThread* hThread =
+        CPLCreateJoinableThread(DiskCacheTrimThread, this);
+    if( hThread == nullptr )
+    {
+        DiskCacheTrimThread(this);
+        return;
+    }
+    CPLMutexHolder oHolder( &hMutex );
+    m_hDiskCacheTrimThread = hThread;
+}
+
+/************************************************************************/
+/*                        DiskCacheTrimThread()                         */
+/************************************************************************/
+
+void VSICurlFilesystemHandler::DiskCacheTrimThread( void* pData )
+{
+    VSICurlFilesystemHandler* poThis =
+        static_cast<VSICurlFilesystemHandler*>(pData);
+    // Those members are not modified while m_bDiskCacheTrimRunning is set.
+    VSICurlTrimDiskCache(poThis->m_osDiskCacheTrimDir,
+                         poThis->m_nDiskCacheTrimMaxSize);
+    CPLMutexHolder oHolder( &poThis->hMutex );
+    poThis->m_bDiskCacheTrimRunning = false;
+}
+
+/************************************************************************/
+/*                        WaitForDiskCacheTrim()                        */
+/************************************************************************/
+
+void VSICurlFilesystemHandler::WaitForDiskCacheTrim()
+{
+    CPLJoinableThread* hThread = nullptr;
+    {
+        CPLMutexHolder oHolder( &hMutex );
+        hThread = m_hDiskCacheTrimThread;
+        m_hDiskCacheTrimThread = nullptr;
+    }
+    if( hThread )
+        CPLJoinThread(hThread);
+}
+
 /************************************************************************/
 /*                          GetRegion()                                 */
 /************************************************************************/
 
 std::shared_ptr<std::string>
 VSICurlFilesystemHandler::GetRegion( const char* pszURL,
-                                     vsi_l_offset nFileOffsetStart )
+                                     vsi_l_offset nFileOffsetStart,
+                                     const FileProp* poFileProp )
 {
-    CPLMutexHolder oHolder( &hMutex );
-
     nFileOffsetStart =
         (nFileOffsetStart / DOWNLOAD_CHUNK_SIZE) * DOWNLOAD_CHUNK_SIZE;
+    const FilenameOffsetPair oKey(std::string(pszURL), nFileOffsetStart);
 
     std::shared_ptr<std::string> out;
-    if( oRegionCache.tryGet(
-        FilenameOffsetPair(std::string(pszURL), nFileOffsetStart), out) )
     {
-        return out;
+        CPLMutexHolder oHolder( &hMutex );
+
+        if( oRegionCache.tryGet(oKey, out) )
+        {
+            return out;
+        }
     }
 
-    return nullptr;
+    if( poFileProp == nullptr )
+        return nullptr;
+    const CPLString osCacheFilename(
+        VSICurlGetDiskCacheFilename(pszURL, *poFileProp, nFileOffsetStart));
+    if( osCacheFilename.empty() )
+        return nullptr;
+    out = VSICurlReadDiskCacheFile(osCacheFilename);
+    if( out != nullptr )
+    {
+        CPLMutexHolder oHolder( &hMutex );
+        oRegionCache.insert(oKey, out);
+    }
+    return out;
 }
 
 /************************************************************************/
@@ -2561,15 +3167,26 @@ VSICurlFilesystemHandler::GetRegion( const char* pszURL,
 void VSICurlFilesystemHandler::AddRegion( const char* pszURL,
                                           vsi_l_offset nFileOffsetStart,
                                           size_t nSize,
-                                          const char *pData )
+                                          const char *pData,
+                                          const FileProp* poFileProp )
 {
-    CPLMutexHolder oHolder( &hMutex );
+    {
+        CPLMutexHolder oHolder( &hMutex );
+
+        std::shared_ptr<std::string> value(new std::string());
+        value->assign(pData, nSize);
+        oRegionCache.insert(
+            FilenameOffsetPair(std::string(pszURL), nFileOffsetStart),
+            value);
+    }
 
-    std::shared_ptr<std::string> value(new std::string());
-    value->assign(pData, nSize);
-    oRegionCache.insert(
-        FilenameOffsetPair(std::string(pszURL), nFileOffsetStart),
-        value);
+    if( poFileProp != nullptr )
+    {
+        const CPLString osCacheFilename(
+            VSICurlGetDiskCacheFilename(pszURL, *poFileProp, nFileOffsetStart));
+        if( !osCacheFilename.empty() )
+            AddRegionToDiskCache(osCacheFilename, nSize, pData);
+    }
 }
 
 /************************************************************************/
@@ -2703,6 +3320,8 @@ void VSICurlFilesystemHandler::InvalidateCachedData( const char* pszURL )
 
 void VSICurlFilesystemHandler::ClearCache()
 {
+    WaitForDiskCacheTrim();
+
     CPLMutexHolder oHolder( &hMutex );
 
     oRegionCache.clear();
@@ -2846,6 +3465,15 @@ const char* VSICurlFilesystemHandler::GetActualURL(const char* pszFilename)
     "  <Option name='CPL_VSIL_CURL_CACHE_SIZE' type='integer' " \
         "description='Size in bytes of the global /vsicurl/ cache' " \
         "default='16384000'/>" \
+    "  <Option name='CPL_VSIL_CURL_READ_AHEAD_REQUESTS' type='integer' " \
+        "description='Number of parallel range requests issued when " \
+        "sequential reading is detected' default='4'/>" \
+    "  <Option name='CPL_VSIL_CURL_DISK_CACHE_DIR' type='string' " \
+        "description='Directory of a persistent cache of downloaded " \
+        "content, shared by processes'/>" \
+    "  <Option name='CPL_VSIL_CURL_DISK_CACHE_SIZE' type='integer' " \
+        "description='Size in bytes of the persistent cache' " \
+        "default='1073741824'/>" \
     "  <Option name='CPL_VSIL_CURL_IGNORE_GLACIER_STORAGE' type='boolean' " \
         "description='Whether to skip files with Glacier storage class in " \
         "directory listing.' default='YES'/>"
@@ -36,6 +36,7 @@
 #include "cpl_string.h"
 #include "cpl_vsil_curl_priv.h"
 #include "cpl_mem_cache.h"
+#include "cpl_worker_thread_pool.h"
 
 #include <curl/curl.h>
 
@@ -123,6 +124,7 @@ typedef struct
 /************************************************************************/
 
 class VSICurlHandle;
+struct VSICurlMultiRangeRequest;
 
 class VSICurlFilesystemHandler : public VSIFilesystemHandler
 {
@@ -168,6 +170,20 @@ class VSICurlFilesystemHandler : public VSIFilesystemHandler
     int                                       nCachedFilesInDirList = 0;
     lru11::Cache<std::string, CachedDirList>  oCacheDirList;
 
+    // Persistent disk cache (CPL_VSIL_CURL_DISK_CACHE_DIR)
+    bool                m_bDiskCacheTrimmed = false;
+    GIntBig             m_nDiskCacheBytesWritten = 0;
+    CPLJoinableThread  *m_hDiskCacheTrimThread = nullptr;
+    bool                m_bDiskCacheTrimRunning = false;
+    CPLString           m_osDiskCacheTrimDir{};
+    GIntBig             m_nDiskCacheTrimMaxSize = 0;
+
+    void                AddRegionToDiskCache( const CPLString& osCacheFilename,
+                                              size_t nSize,
+                                              const char *pData );
+    static void         DiskCacheTrimThread( void* pData );
+    void                WaitForDiskCacheTrim();
+
     char**              ParseHTMLFileList(const char* pszFilename,
                                           int nMaxFiles,
                                           char* pszData,
@@ -239,12 +255,14 @@ public:
     virtual bool      AllowCachedDataFor(const char* pszFilename);
 
     std::shared_ptr<std::string> GetRegion( const char* pszURL,
-                                   vsi_l_offset nFileOffsetStart );
+                                   vsi_l_offset nFileOffsetStart,
+                                   const FileProp* poFileProp = nullptr );
 
     void                AddRegion( const char* pszURL,
                                    vsi_l_offset nFileOffsetStart,
                                    size_t nSize,
-                                   const char *pData );
+                                   const char *pData,
+                                   const FileProp* poFileProp = nullptr );
 
     bool                GetCachedFileProp( const char* pszURL,
                                            FileProp& oFileProp );
@@ -318,6 +336,14 @@ class VSICurlHandle : public VSIVirtualHandle
     int          ReadMultiRangeSingleGet( int nRanges, void ** ppData,
                                          const vsi_l_offset* panOffsets,
                                          const size_t* panSizes );
+    int          ReadMultiRangeParallel( int nRanges, void ** ppData,
+                                         const vsi_l_offset* panOffsets,
+                                         const size_t* panSizes,
+                                         bool bMergeConsecutiveRanges );
+    void         PrepareMultiRangeParallel( VSICurlMultiRangeRequest& oRequest,
+                                            bool bWithReadCbk );
+    std::string  DownloadRegionsInParallel( vsi_l_offset startOffset,
+                                            int nBlocksPerRequest );
     CPLString    GetRedirectURLIfValid(bool& bHasExpired);
 
   protected:
@@ -327,6 +353,7 @@ class VSICurlHandle : public VSIVirtualHandle
     virtual bool AllowAutomaticRedirection() { return true; }
     virtual bool CanRestartOnError( const char*, const char*, bool ) { return false; }
     virtual bool UseLimitRangeGetInsteadOfHead() { return false; }
+    virtual bool AllowParallelReadAhead() { return true; }
     virtual bool IsDirectoryFromExists( const char* /*pszVerb*/, int /*response_code*/ ) { return false; }
     virtual void ProcessGetFileSizeResult(const char* /* pszContent */ ) {}
     void SetURL(const char* pszURL);
@@ -345,6 +372,9 @@ class VSICurlHandle : public VSIVirtualHandle
     int ReadMultiRange( int nRanges, void ** ppData,
                         const vsi_l_offset* panOffsets,
                         const size_t* panSizes ) override;
+    VSIAsyncRead *ReadMultiRangeAsync( int nRanges, void ** ppData,
+                                       const vsi_l_offset* panOffsets,
+                                       const size_t* panSizes ) override;
     size_t Write( const void *pBuffer, size_t nSize, size_t nMemb ) override;
     int Eof() override;
     int Flush() override;
@@ -374,6 +404,8 @@ class IVSIS3LikeFSHandler: public VSICurlFilesystemHandler
 {
     CPL_DISALLOW_COPY_ASSIGN(IVSIS3LikeFSHandler)
 
+    friend class VSIS3WriteHandle;
+
     bool CopyFile(VSILFILE* fpIn,
                      vsi_l_offset nSourceSize,
                      const char* pszSource,
@@ -510,7 +542,20 @@ class VSIS3WriteHandle final : public VSIVirtualHandle
     double              m_dfRetryDelay = 0.0;
     WriteFuncStruct     m_sWriteFuncHeaderData{};
 
+    // Asynchronous upload of parts (VSIS3_UPLOAD_NUM_THREADS)
+    struct PendingPart;
+    std::unique_ptr<CPLWorkerThreadPool> m_poUploadPool{};
+    std::vector<std::unique_ptr<PendingPart>> m_apoPendingParts{};
+    std::vector<GByte*> m_apabyFreeBuffers{};
+    int                 m_nMaxPendingParts = 0;
+
     bool                UploadPart();
+    bool                SubmitPart();
+    static void         UploadPartJob( void* pData );
+    static void CPL_STDCALL UploadPartErrorHandler( CPLErr eErrClass,
+                                                    CPLErrorNum nErrNo,
+                                                    const char* pszMsg );
+    bool                CollectFinishedParts( int nMaxPendingParts );
     bool                DoSinglePartPUT();
 
     static size_t       ReadCallBackBufferChunked( char *buffer, size_t size,
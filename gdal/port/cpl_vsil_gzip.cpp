@@ -65,6 +65,14 @@
    of the gzip state.  Later we can seek directly in the compressed data to the
    closest snapshot in order to reduce the amount of data to uncompress again.
 
+   For .gz files, a persistent "seek index" can also be used. It is a list of
+   access points, recorded at deflate block boundaries (with the 32 KB of
+   uncompressed data preceding them needed to prime the decompressor, as in
+   zlib's examples/zran.c) or at gzip member boundaries (no priming needed).
+   It is stored in a .gz.idx side-car file so that later opening of the file
+   can seek directly to any location. For BGZF files, the index is built
+   without decompression, by walking the headers of the blocks.
+
    For .gz files, an effort is done to cache the size of the uncompressed data
    in a .gz.properties file, so that we don't need to seek at the end of the
    file each time a Stat() is done.
@@ -94,6 +102,8 @@
 #include <zlib.h>
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <list>
 #include <map>
 #include <memory>
@@ -149,6 +159,22 @@ typedef struct
     vsi_l_offset  out;
 } GZipSnapshot;
 
+typedef struct
+{
+    vsi_l_offset  nCompressedOffset;    /* in base handle */
+    int           nBits;    /* unused bits of byte at nCompressedOffset-1 */
+    vsi_l_offset  nUncompressedOffset;
+    std::vector<GByte> abyWindow; /* zlib compressed. Empty at member start */
+} GZipSeekPoint;
+
+typedef struct
+{
+    vsi_l_offset  nUncompressedSize;
+    std::vector<GZipSeekPoint> aoPoints;
+} GZipSeekIndex;
+
+constexpr int GZIP_WINDOW_SIZE = 32768;
+
 class VSIGZipHandle final : public VSIVirtualHandle
 {
     VSIVirtualHandle* m_poBaseHandle = nullptr;
@@ -179,12 +205,34 @@ class VSIGZipHandle final : public VSIVirtualHandle
     GZipSnapshot* snapshots = nullptr;
     vsi_l_offset snapshot_byte_interval = 0; /* number of compressed bytes at which we create a "snapshot" */
 
+    // Complete seek index, read from the side-car file or built from a
+    // full read of the file.
+    std::shared_ptr<GZipSeekIndex> m_poSeekIndex{};
+    // Seek index being built while the file is read sequentially.
+    std::unique_ptr<GZipSeekIndex> m_poSeekIndexBuilder{};
+    vsi_l_offset m_nSeekIndexSpacing = 0;
+    // Uncompressed offset up to which m_poSeekIndexBuilder has seen data.
+    vsi_l_offset m_nSeekIndexOut = 0;
+    // Last uncompressed bytes before m_nSeekIndexOut.
+    std::vector<GByte> m_abySeekIndexWindow{};
+    // Set after jumping to a seek point in the middle of a gzip member.
+    bool     m_bSkipCRCCheck = false;
+
     void check_header();
     int get_byte();
     bool gzseek( vsi_l_offset nOffset, int nWhence );
     int gzrewind ();
     uLong getLong ();
 
+    CPLString GetSeekIndexFilename() const;
+    bool ReadSeekIndexStamp( GIntBig& nMTime, GByte abyTrailer[8] );
+    bool ReadSeekIndex();
+    bool BuildBGZFSeekIndex();
+    void WriteSeekIndex();
+    void RecordSeekIndex( const GByte* pabyOut, vsi_l_offset nOutBefore );
+    void AddSeekPoint( int nBits, bool bWithWindow );
+    bool RestoreSeekPoint( const GZipSeekPoint& oPoint );
+
     CPL_DISALLOW_COPY_ASSIGN(VSIGZipHandle)
 
   public:
@@ -217,9 +265,13 @@ class VSIGZipHandle final : public VSIVirtualHandle
     void              SetUncompressedSize( vsi_l_offset nUncompressedSize )
         { m_uncompressed_size = nUncompressedSize; }
     vsi_l_offset      GetUncompressedSize() { return m_uncompressed_size; }
+    std::shared_ptr<GZipSeekIndex> GetSeekIndex() const
+        { return m_poSeekIndex; }
 
     void              SaveInfo_unlocked();
     void              UnsetCanSaveInfo() { m_bCanSaveInfo = false; }
+
+    void              InitSeekIndex();
 };
 
 class VSIGZipFilesystemHandler final : public VSIFilesystemHandler
@@ -284,6 +336,7 @@ VSIGZipHandle* VSIGZipHandle::Duplicate()
     }
 
     poHandle->m_nLastReadOffset = m_nLastReadOffset;
+    poHandle->m_poSeekIndex = m_poSeekIndex;
 
     // Most important: duplicate the snapshots!
 
@@ -598,6 +651,31 @@ int VSIGZipHandle::get_byte()
     return *(stream.next_in)++;
 }
 
+/************************************************************************/
+/*                        IsNetworkFileSystem()                         */
+/************************************************************************/
+
+// Returns whether the file is (or is nested into) a network file system,
+// for which probing side-car files or reading ahead costs round-trips.
+static bool IsNetworkFileSystem( const char* pszFilename )
+{
+    const char* const apszNetworkFS[] = { "/vsicurl", "/vsis3", "/vsigs",
+                                          "/vsiaz", "/vsioss", "/vsiswift",
+                                          "/vsiwebhdfs", "/vsihdfs" };
+    for( const char* pszFS: apszNetworkFS )
+    {
+        // Also matches the _streaming variants, and paths nested into
+        // /vsisubfile/, /vsitar/, etc.
+        const char* pszIter = strstr(pszFilename, pszFS);
+        if( pszIter != nullptr &&
+            (pszIter[strlen(pszFS)] == '/' || pszIter[strlen(pszFS)] == '_') )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 /************************************************************************/
 /*                            gzrewind()                                */
 /************************************************************************/
@@ -609,6 +687,7 @@ int VSIGZipHandle::gzrewind ()
     stream.avail_in = 0;
     stream.next_in = inbuf;
     crc = 0;
+    m_bSkipCRCCheck = false;
     if( !m_transparent )
         CPL_IGNORE_RET_VAL(inflateReset(&stream));
     in = 0;
@@ -776,6 +855,7 @@ bool VSIGZipHandle::gzseek( vsi_l_offset offset, int whence )
             inflateEnd(&stream);
             inflateCopy(&stream, &snapshots[i].stream);
             crc = snapshots[i].crc;
+            m_bSkipCRCCheck = false;
             m_transparent = snapshots[i].transparent;
             in = snapshots[i].in;
             out = snapshots[i].out;
@@ -783,6 +863,45 @@ bool VSIGZipHandle::gzseek( vsi_l_offset offset, int whence )
         }
     }
 
+    // Jump to the closest seek point, if it is closer than where we are.
+    if( m_poSeekIndex )
+    {
+        const auto& aoPoints = m_poSeekIndex->aoPoints;
+        const vsi_l_offset nTarget = out + offset;
+        auto oIter = std::upper_bound(aoPoints.begin(), aoPoints.end(),
+            nTarget,
+            [](vsi_l_offset nVal, const GZipSeekPoint& oPoint)
+            { return nVal < oPoint.nUncompressedOffset; });
+        if( oIter != aoPoints.begin() )
+        {
+            --oIter;
+            if( oIter->nUncompressedOffset > out )
+            {
+                if( RestoreSeekPoint(*oIter) )
+                {
+                    offset = nTarget - out;
+                }
+                else
+                {
+                    // RestoreSeekPoint() may have reset the inflate state
+                    // and moved the base file position: the only safe
+                    // thing is to restart from the beginning of the
+                    // stream, and stop trusting the index.
+                    CPLDebug("GZIP", "Cannot use seek point at "
+                             CPL_FRMT_GUIB ". Ignoring seek index",
+                             static_cast<GUIntBig>(oIter->nUncompressedOffset));
+                    m_poSeekIndex.reset();
+                    if( gzrewind() < 0 )
+                    {
+                        CPL_VSIL_GZ_RETURN(FALSE);
+                        return false;
+                    }
+                    offset = nTarget;
+                }
+            }
+        }
+    }
+
     // Offset is now the number of bytes to skip.
 
     if( offset != 0 && outbuf == nullptr )
@@ -832,7 +951,7 @@ bool VSIGZipHandle::gzseek( vsi_l_offset offset, int whence )
         m_uncompressed_size = out;
 
         if( m_pszBaseFileName &&
-            !STARTS_WITH_CI(m_pszBaseFileName, "/vsicurl/") &&
+            !IsNetworkFileSystem(m_pszBaseFileName) &&
             m_bWriteProperties )
         {
             CPLString osCacheFilename (m_pszBaseFileName);
@@ -969,7 +1088,7 @@ size_t VSIGZipHandle::Read( void * const buf, size_t const nSize,
             GZipSnapshot* snapshot =
                 &snapshots[(posInBaseHandle - startOff) /
                            snapshot_byte_interval];
-            if( snapshot->posInBaseHandle == 0 )
+            if( snapshot->posInBaseHandle == 0 && !m_bSkipCRCCheck )
             {
                 snapshot->crc =
                     crc32(crc, pStart,
@@ -1020,159 +1139,1530 @@ size_t VSIGZipHandle::Read( void * const buf, size_t const nSize,
                 CPLDebug("GZIP", "avail_in after = %d", stream.avail_in);
 #endif
             }
-            if( stream.avail_in == 0 )
+            if( stream.avail_in == 0 )
+            {
+                z_eof = 1;
+                if( VSIFTellL(reinterpret_cast<VSILFILE*>(m_poBaseHandle)) !=
+                    offsetEndCompressedData )
+                {
+                    z_err = Z_ERRNO;
+                    break;
+                }
+            }
+            stream.next_in = inbuf;
+        }
+        const vsi_l_offset nOutBefore = out;
+        const Byte* pabyOutBefore = stream.next_out;
+        in += stream.avail_in;
+        out += stream.avail_out;
+        // When building a seek index, stop at each deflate block boundary
+        // to be able to record it.
+        z_err = inflate(& (stream),
+                        m_poSeekIndexBuilder ? Z_BLOCK : Z_NO_FLUSH);
+        in -= stream.avail_in;
+        out -= stream.avail_out;
+        if( m_poSeekIndexBuilder )
+            RecordSeekIndex(pabyOutBefore, nOutBefore);
+
+        if( z_err == Z_STREAM_END && m_compressed_size != 2 )
+        {
+            // Check CRC and original size.
+            crc = crc32(crc, pStart,
+                        static_cast<uInt>(stream.next_out - pStart));
+            pStart = stream.next_out;
+            if( m_expected_crc )
+            {
+#ifdef ENABLE_DEBUG
+                CPLDebug(
+                    "GZIP",
+                    "Computed CRC = %X. Expected CRC = %X",
+                    static_cast<unsigned int>(crc),
+                    static_cast<unsigned int>(m_expected_crc));
+#endif
+            }
+            if( m_expected_crc != 0 && m_expected_crc != crc )
+            {
+                CPLError(CE_Failure, CPLE_FileIO,
+                         "CRC error. Got %X instead of %X",
+                         static_cast<unsigned int>(crc),
+                         static_cast<unsigned int>(m_expected_crc));
+                z_err = Z_DATA_ERROR;
+            }
+            else if( m_expected_crc == 0 )
+            {
+                const uLong read_crc =
+                    static_cast<unsigned long>(getLong());
+                if( read_crc != crc && !m_bSkipCRCCheck )
+                {
+                    CPLError(CE_Failure, CPLE_FileIO,
+                             "CRC error. Got %X instead of %X",
+                             static_cast<unsigned int>(crc),
+                             static_cast<unsigned int>(read_crc));
+                    z_err = Z_DATA_ERROR;
+                }
+                else
+                {
+                    CPL_IGNORE_RET_VAL(getLong());
+                    // The uncompressed length returned by above getlong() may
+                    // be different from out in case of concatenated .gz files.
+                    // Check for such files:
+                    check_header();
+                    if( z_err == Z_OK )
+                    {
+                        inflateReset(& (stream));
+                        crc = 0;
+                        m_bSkipCRCCheck = false;
+                        if( m_poSeekIndexBuilder && m_nSeekIndexOut == out )
+                            AddSeekPoint(0, false);
+                    }
+                }
+            }
+        }
+        if( z_err != Z_OK || z_eof )
+            break;
+    }
+    crc = crc32(crc, pStart, static_cast<uInt>(stream.next_out - pStart));
+
+    if( m_poSeekIndexBuilder && z_err == Z_STREAM_END &&
+        m_nSeekIndexOut == out )
+    {
+        // The whole file has been seen: the index is complete.
+        m_poSeekIndexBuilder->nUncompressedSize = out;
+        m_poSeekIndex.reset(m_poSeekIndexBuilder.release());
+        if( m_uncompressed_size == 0 )
+            m_uncompressed_size = out;
+        WriteSeekIndex();
+    }
+
+    size_t ret = (len - stream.avail_out) / nSize;
+    if( z_err != Z_OK && z_err != Z_STREAM_END )
+    {
+        z_eof = 1;
+        in = 0;
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "In file %s, at line %d, decompression failed with "
+                 "z_err = %d, return = %d",
+                 __FILE__, __LINE__, z_err, static_cast<int>(ret));
+    }
+
+#ifdef ENABLE_DEBUG
+    CPLDebug("GZIP", "Read return %d (z_err=%d, z_eof=%d)",
+             static_cast<int>(ret), z_err, z_eof);
+#endif
+    return ret;
+}
+
+/************************************************************************/
+/*                              getLong()                               */
+/************************************************************************/
+
+uLong VSIGZipHandle::getLong ()
+{
+    uLong x = static_cast<uLong>(get_byte()) & 0xFF;
+
+    x += (static_cast<uLong>(get_byte()) & 0xFF) << 8;
+    x += (static_cast<uLong>(get_byte()) & 0xFF) << 16;
+    const int c = get_byte();
+    if( c == EOF )
+    {
+        z_err = Z_DATA_ERROR;
+        return 0;
+    }
+    x += static_cast<uLong>(c) << 24;
+    // coverity[overflow_sink]
+    return x;
+}
+
+/************************************************************************/
+/*                        GetSeekIndexFilename()                        */
+/************************************************************************/
+
+CPLString VSIGZipHandle::GetSeekIndexFilename() const
+{
+    return CPLString(m_pszBaseFileName) + ".idx";
+}
+
+/************************************************************************/
+/*                          ReadSeekIndexStamp()                        */
+/************************************************************************/
+
+// Fetches what identifies the current content of the base file, beyond its
+// size: its modification time and its last 8 bytes, that is the CRC32 and
+// the uncompressed size of the last gzip member.
+bool VSIGZipHandle::ReadSeekIndexStamp( GIntBig& nMTime,
+                                        GByte abyTrailer[8] )
+{
+    VSIStatBufL sStat;
+    if( VSIStatL(m_pszBaseFileName, &sStat) != 0 ||
+        offsetEndCompressedData < 8 )
+    {
+        return false;
+    }
+    nMTime = static_cast<GIntBig>(sStat.st_mtime);
+
+    VSILFILE* fp = reinterpret_cast<VSILFILE*>(m_poBaseHandle);
+    const vsi_l_offset nSavedPos = VSIFTellL(fp);
+    bool bOK = VSIFSeekL(fp, offsetEndCompressedData - 8, SEEK_SET) == 0 &&
+               VSIFReadL(abyTrailer, 1, 8, fp) == 8;
+    if( VSIFSeekL(fp, nSavedPos, SEEK_SET) != 0 )
+        bOK = false;
+    return bOK;
+}
+
+/************************************************************************/
+/*                           InitSeekIndex()                            */
+/************************************************************************/
+
+// Called on handles of standalone .gz files just after their opening.
+// Reads the seek index side-car if there is a valid one, or prepare for
+// building it if CPL_VSIL_GZIP_WRITE_SEEK_INDEX is set.
+void VSIGZipHandle::InitSeekIndex()
+{
+    if( m_transparent || m_pszBaseFileName == nullptr || m_poSeekIndex )
+        return;
+
+    // Avoid network accesses for each opening of remote files.
+    const bool bRemote = IsNetworkFileSystem(m_pszBaseFileName);
+    if( !bRemote && ReadSeekIndex() )
+        return;
+
+    if( bRemote ||
+        !CPLTestBool(CPLGetConfigOption("CPL_VSIL_GZIP_WRITE_SEEK_INDEX",
+                                        "NO")) )
+    {
+        return;
+    }
+
+    m_nSeekIndexSpacing = static_cast<vsi_l_offset>(std::max(1,
+        atoi(CPLGetConfigOption("CPL_VSIL_GZIP_SEEK_INDEX_SPACING",
+                                "4")))) * 1024 * 1024;
+
+    if( BuildBGZFSeekIndex() )
+    {
+        WriteSeekIndex();
+        return;
+    }
+
+    // Otherwise the index will be built by the next read of the whole file,
+    // which happens for example on the first VSIStatL().
+    m_poSeekIndexBuilder.reset(new GZipSeekIndex());
+    m_poSeekIndexBuilder->nUncompressedSize = 0;
+    m_nSeekIndexOut = 0;
+    m_abySeekIndexWindow.clear();
+}
+
+/************************************************************************/
+/*                           ReadSeekIndex()                            */
+/************************************************************************/
+
+bool VSIGZipHandle::ReadSeekIndex()
+{
+    const CPLString osIndexFilename(GetSeekIndexFilename());
+    VSILFILE* fp = VSIFOpenL(osIndexFilename, "rb");
+    if( fp == nullptr )
+        return false;
+
+    std::shared_ptr<GZipSeekIndex> poIndex = std::make_shared<GZipSeekIndex>();
+    bool bOK = false;
+    GByte abyHeader[44] = {};
+    GIntBig nCurMTime = 0;
+    GByte abyCurTrailer[8] = {};
+    if( VSIFReadL(abyHeader, 1, sizeof(abyHeader), fp) == sizeof(abyHeader) &&
+        memcmp(abyHeader, "GDALGZI2", 8) == 0 &&
+        ReadSeekIndexStamp(nCurMTime, abyCurTrailer) )
+    {
+        GUIntBig nCompressedSize = 0;
+        memcpy(&nCompressedSize, abyHeader + 8, 8);
+        CPL_LSBPTR64(&nCompressedSize);
+        GUIntBig nUncompressedSize = 0;
+        memcpy(&nUncompressedSize, abyHeader + 16, 8);
+        CPL_LSBPTR64(&nUncompressedSize);
+        GIntBig nMTime = 0;
+        memcpy(&nMTime, abyHeader + 24, 8);
+        CPL_LSBPTR64(&nMTime);
+        GUInt32 nPoints = 0;
+        memcpy(&nPoints, abyHeader + 40, 4);
+        CPL_LSBPTR32(&nPoints);
+
+        // The index is invalidated by any change of the size,
+        // modification time or trailer of the file, or if it disagrees
+        // with an already known uncompressed size (from .properties).
+        bOK = nCompressedSize == m_compressed_size &&
+              nMTime == nCurMTime &&
+              memcmp(abyHeader + 32, abyCurTrailer, 8) == 0 &&
+              (m_uncompressed_size == 0 ||
+               nUncompressedSize == m_uncompressed_size) &&
+              nPoints < m_compressed_size;
+        poIndex->nUncompressedSize = nUncompressedSize;
+        for( GUInt32 i = 0; bOK && i < nPoints; i++ )
+        {
+            GByte abyPoint[21] = {};
+            if( VSIFReadL(abyPoint, 1, sizeof(abyPoint), fp) !=
+                                                        sizeof(abyPoint) )
+            {
+                bOK = false;
+                break;
+            }
+            GZipSeekPoint oPoint;
+            GUIntBig nVal = 0;
+            memcpy(&nVal, abyPoint, 8);
+            CPL_LSBPTR64(&nVal);
+            oPoint.nCompressedOffset = nVal;
+            memcpy(&nVal, abyPoint + 8, 8);
+            CPL_LSBPTR64(&nVal);
+            oPoint.nUncompressedOffset = nVal;
+            oPoint.nBits = abyPoint[16];
+            GUInt32 nWindowSize = 0;
+            memcpy(&nWindowSize, abyPoint + 17, 4);
+            CPL_LSBPTR32(&nWindowSize);
+            if( oPoint.nCompressedOffset <= startOff ||
+                oPoint.nCompressedOffset >= offsetEndCompressedData ||
+                oPoint.nUncompressedOffset > nUncompressedSize ||
+                oPoint.nBits > 7 ||
+                nWindowSize > 2 * GZIP_WINDOW_SIZE ||
+                (!poIndex->aoPoints.empty() &&
+                 oPoint.nUncompressedOffset <=
+                    poIndex->aoPoints.back().nUncompressedOffset) )
+            {
+                bOK = false;
+                break;
+            }
+            oPoint.abyWindow.resize(nWindowSize);
+            if( nWindowSize &&
+                VSIFReadL(oPoint.abyWindow.data(), 1, nWindowSize, fp) !=
+                                                                nWindowSize )
+            {
+                bOK = false;
+                break;
+            }
+            poIndex->aoPoints.emplace_back(std::move(oPoint));
+        }
+    }
+    CPL_IGNORE_RET_VAL(VSIFCloseL(fp));
+
+    if( !bOK )
+    {
+        CPLDebug("GZIP", "Ignoring invalid or outdated %s",
+                 osIndexFilename.c_str());
+        return false;
+    }
+    m_poSeekIndex = poIndex;
+    if( m_uncompressed_size == 0 )
+        m_uncompressed_size = poIndex->nUncompressedSize;
+    return true;
+}
+
+/************************************************************************/
+/*                          WriteSeekIndex()                            */
+/************************************************************************/
+
+void VSIGZipHandle::WriteSeekIndex()
+{
+    GIntBig nMTime = 0;
+    GByte abyHeader[44] = {};
+    if( !ReadSeekIndexStamp(nMTime, abyHeader + 32) )
+    {
+        CPLDebug("GZIP", "Cannot stat %s", m_pszBaseFileName);
+        return;
+    }
+
+    const CPLString osIndexFilename(GetSeekIndexFilename());
+    VSILFILE* fp = VSIFOpenL(osIndexFilename, "wb");
+    if( fp == nullptr )
+    {
+        CPLDebug("GZIP", "Cannot create %s", osIndexFilename.c_str());
+        return;
+    }
+    memcpy(abyHeader, "GDALGZI2", 8);
+    GUIntBig nVal = m_compressed_size;
+    CPL_LSBPTR64(&nVal);
+    memcpy(abyHeader + 8, &nVal, 8);
+    nVal = m_poSeekIndex->nUncompressedSize;
+    CPL_LSBPTR64(&nVal);
+    memcpy(abyHeader + 16, &nVal, 8);
+    CPL_LSBPTR64(&nMTime);
+    memcpy(abyHeader + 24, &nMTime, 8);
+    GUInt32 nPoints = static_cast<GUInt32>(m_poSeekIndex->aoPoints.size());
+    CPL_LSBPTR32(&nPoints);
+    memcpy(abyHeader + 40, &nPoints, 4);
+    bool bOK = VSIFWriteL(abyHeader, 1, sizeof(abyHeader), fp) ==
+                                                        sizeof(abyHeader);
+
+    for( const auto& oPoint: m_poSeekIndex->aoPoints )
+    {
+        if( !bOK )
+            break;
+        GByte abyPoint[21] = {};
+        nVal = oPoint.nCompressedOffset;
+        CPL_LSBPTR64(&nVal);
+        memcpy(abyPoint, &nVal, 8);
+        nVal = oPoint.nUncompressedOffset;
+        CPL_LSBPTR64(&nVal);
+        memcpy(abyPoint + 8, &nVal, 8);
+        abyPoint[16] = static_cast<GByte>(oPoint.nBits);
+        GUInt32 nWindowSize = static_cast<GUInt32>(oPoint.abyWindow.size());
+        CPL_LSBPTR32(&nWindowSize);
+        memcpy(abyPoint + 17, &nWindowSize, 4);
+        bOK = VSIFWriteL(abyPoint, 1, sizeof(abyPoint), fp) ==
+                                                        sizeof(abyPoint) &&
+              (oPoint.abyWindow.empty() ||
+               VSIFWriteL(oPoint.abyWindow.data(), 1,
+                          oPoint.abyWindow.size(), fp) ==
+                                                    oPoint.abyWindow.size());
+    }
+
+    if( VSIFCloseL(fp) != 0 || !bOK )
+    {
+        CPLDebug("GZIP", "Cannot write %s", osIndexFilename.c_str());
+        VSIUnlink(osIndexFilename);
+    }
+}
+
+/************************************************************************/
+/*                        BuildBGZFSeekIndex()                          */
+/************************************************************************/
+
+// BGZF files (as produced by bgzip) are a concatenation of gzip members
+// of at most 64 KB, whose header records the compressed size of the
+// member. The uncompressed size is in the member trailer. So the index can
+// be built by reading only those headers and trailers.
+bool VSIGZipHandle::BuildBGZFSeekIndex()
+{
+    VSILFILE* fp = reinterpret_cast<VSILFILE*>(m_poBaseHandle);
+    const vsi_l_offset nSavedPos = VSIFTellL(fp);
+
+    std::unique_ptr<GZipSeekIndex> poIndex(new GZipSeekIndex());
+    vsi_l_offset nPos = 0;
+    vsi_l_offset nOut = 0;
+    bool bOK = true;
+    while( nPos < offsetEndCompressedData )
+    {
+        GByte abyHeader[18] = {};
+        GByte abyISize[4] = {};
+        if( VSIFSeekL(fp, nPos, SEEK_SET) != 0 ||
+            VSIFReadL(abyHeader, 1, sizeof(abyHeader), fp) !=
+                                                    sizeof(abyHeader) ||
+            abyHeader[0] != gz_magic[0] || abyHeader[1] != gz_magic[1] ||
+            abyHeader[2] != Z_DEFLATED || abyHeader[3] != EXTRA_FIELD ||
+            abyHeader[10] != 6 || abyHeader[11] != 0 ||
+            abyHeader[12] != 'B' || abyHeader[13] != 'C' ||
+            abyHeader[14] != 2 || abyHeader[15] != 0 )
+        {
+            bOK = false;
+            break;
+        }
+        const int nBlockSize = (abyHeader[16] | (abyHeader[17] << 8)) + 1;
+        if( nBlockSize < 18 + 8 ||
+            VSIFSeekL(fp, nPos + nBlockSize - 4, SEEK_SET) != 0 ||
+            VSIFReadL(abyISize, 1, sizeof(abyISize), fp) != sizeof(abyISize) )
+        {
+            bOK = false;
+            break;
+        }
+        if( nOut > 0 &&
+            (poIndex->aoPoints.empty() ?
+                nOut >= m_nSeekIndexSpacing :
+                nOut - poIndex->aoPoints.back().nUncompressedOffset >=
+                                                    m_nSeekIndexSpacing) )
+        {
+            GZipSeekPoint oPoint;
+            oPoint.nCompressedOffset = nPos + sizeof(abyHeader);
+            oPoint.nBits = 0;
+            oPoint.nUncompressedOffset = nOut;
+            poIndex->aoPoints.emplace_back(std::move(oPoint));
+        }
+        nOut += static_cast<GUInt32>(abyISize[0] | (abyISize[1] << 8) |
+                                     (abyISize[2] << 16)) |
+                (static_cast<GUInt32>(abyISize[3]) << 24);
+        nPos += nBlockSize;
+    }
+    bOK = bOK && nPos == offsetEndCompressedData;
+
+    if( VSIFSeekL(fp, nSavedPos, SEEK_SET) != 0 )
+        bOK = false;
+    if( !bOK )
+        return false;
+
+    CPLDebug("GZIP", "Built seek index of BGZF file %s with %d points",
+             m_pszBaseFileName, static_cast<int>(poIndex->aoPoints.size()));
+    poIndex->nUncompressedSize = nOut;
+    m_poSeekIndex.reset(poIndex.release());
+    if( m_uncompressed_size == 0 )
+        m_uncompressed_size = nOut;
+    return true;
+}
+
+/************************************************************************/
+/*                          RecordSeekIndex()                           */
+/************************************************************************/
+
+// Called after each inflate() call while building the seek index.
+// pabyOut points to the data produced by that call, starting at the
+// nOutBefore uncompressed offset.
+void VSIGZipHandle::RecordSeekIndex( const GByte* pabyOut,
+                                     vsi_l_offset nOutBefore )
+{
+    if( nOutBefore > m_nSeekIndexOut )
+    {
+        // We have jumped forward (through a snapshot): the data in between
+        // has not been seen.
+        CPLDebug("GZIP", "Non-sequential read: giving up building seek index");
+        m_poSeekIndexBuilder.reset();
+        m_abySeekIndexWindow.clear();
+        return;
+    }
+
+    if( out > m_nSeekIndexOut )
+    {
+        const size_t nSkip = static_cast<size_t>(m_nSeekIndexOut - nOutBefore);
+        const size_t nNew = static_cast<size_t>(out - m_nSeekIndexOut);
+        pabyOut += nSkip;
+        // Keep the last GZIP_WINDOW_SIZE bytes.
+        if( nNew >= static_cast<size_t>(GZIP_WINDOW_SIZE) )
+        {
+            m_abySeekIndexWindow.assign(pabyOut + nNew - GZIP_WINDOW_SIZE,
+                                        pabyOut + nNew);
+        }
+        else
+        {
+            const size_t nOld = m_abySeekIndexWindow.size();
+            if( nOld + nNew > static_cast<size_t>(GZIP_WINDOW_SIZE) )
+            {
+                m_abySeekIndexWindow.erase(
+                    m_abySeekIndexWindow.begin(),
+                    m_abySeekIndexWindow.begin() +
+                        (nOld + nNew - GZIP_WINDOW_SIZE));
+            }
+            m_abySeekIndexWindow.insert(m_abySeekIndexWindow.end(),
+                                        pabyOut, pabyOut + nNew);
+        }
+        m_nSeekIndexOut = out;
+    }
+
+    // At the start of a deflate block that is not the first one of the
+    // member ?
+    if( out == m_nSeekIndexOut && (stream.data_type & 128) != 0 &&
+        (stream.data_type & 64) == 0 )
+    {
+        AddSeekPoint(stream.data_type & 7, true);
+    }
+}
+
+/************************************************************************/
+/*                           AddSeekPoint()                             */
+/************************************************************************/
+
+void VSIGZipHandle::AddSeekPoint( int nBits, bool bWithWindow )
+{
+    auto& aoPoints = m_poSeekIndexBuilder->aoPoints;
+    if( out == 0 ||
+        (aoPoints.empty() ? out < m_nSeekIndexSpacing :
+         out - aoPoints.back().nUncompressedOffset < m_nSeekIndexSpacing) )
+    {
+        return;
+    }
+
+    GZipSeekPoint oPoint;
+    oPoint.nCompressedOffset =
+        VSIFTellL(reinterpret_cast<VSILFILE*>(m_poBaseHandle)) -
+        stream.avail_in;
+    oPoint.nBits = nBits;
+    oPoint.nUncompressedOffset = out;
+    if( bWithWindow )
+    {
+        uLongf nCompressedSize = compressBound(
+            static_cast<uLong>(m_abySeekIndexWindow.size()));
+        oPoint.abyWindow.resize(nCompressedSize);
+        if( compress2(oPoint.abyWindow.data(), &nCompressedSize,
+                      m_abySeekIndexWindow.data(),
+                      static_cast<uLong>(m_abySeekIndexWindow.size()),
+                      Z_BEST_SPEED) != Z_OK )
+        {
+            return;
+        }
+        oPoint.abyWindow.resize(nCompressedSize);
+    }
+    aoPoints.emplace_back(std::move(oPoint));
+}
+
+/************************************************************************/
+/*                         RestoreSeekPoint()                           */
+/************************************************************************/
+
+bool VSIGZipHandle::RestoreSeekPoint( const GZipSeekPoint& oPoint )
+{
+    VSILFILE* fp = reinterpret_cast<VSILFILE*>(m_poBaseHandle);
+    if( inflateReset(&stream) != Z_OK )
+        return false;
+    if( oPoint.nBits )
+    {
+        GByte byVal = 0;
+        if( VSIFSeekL(fp, oPoint.nCompressedOffset - 1, SEEK_SET) != 0 ||
+            VSIFReadL(&byVal, 1, 1, fp) != 1 ||
+            inflatePrime(&stream, oPoint.nBits,
+                         byVal >> (8 - oPoint.nBits)) != Z_OK )
+        {
+            return false;
+        }
+    }
+    if( !oPoint.abyWindow.empty() )
+    {
+        std::vector<GByte> abyWindow(GZIP_WINDOW_SIZE);
+        uLongf nWindowSize = GZIP_WINDOW_SIZE;
+        if( uncompress(abyWindow.data(), &nWindowSize,
+                       oPoint.abyWindow.data(),
+                       static_cast<uLong>(oPoint.abyWindow.size())) != Z_OK ||
+            inflateSetDictionary(&stream, abyWindow.data(),
+                                 static_cast<uInt>(nWindowSize)) != Z_OK )
+        {
+            return false;
+        }
+    }
+    if( VSIFSeekL(fp, oPoint.nCompressedOffset, SEEK_SET) != 0 )
+        return false;
+
+#ifdef ENABLE_DEBUG
+    CPLDebug("GZIP", "Using seek point at " CPL_FRMT_GUIB,
+             oPoint.nUncompressedOffset);
+#endif
+    stream.avail_in = 0;
+    stream.next_in = inbuf;
+    z_err = Z_OK;
+    z_eof = 0;
+    crc = 0;
+    // The CRC of the current member cannot be checked, unless we are at
+    // its start.
+    m_bSkipCRCCheck = !oPoint.abyWindow.empty();
+    in = oPoint.nCompressedOffset - startOff;
+    out = oPoint.nUncompressedOffset;
+    return true;
+}
+
+/************************************************************************/
+/*                              Write()                                 */
+/************************************************************************/
+
+size_t VSIGZipHandle::Write( const void * /* pBuffer */,
+                             size_t /* nSize */,
+                             size_t /* nMemb */ )
+{
+    CPLError(CE_Failure, CPLE_NotSupported,
+             "VSIFWriteL is not supported on GZip streams");
+    return 0;
+}
+
+/************************************************************************/
+/*                               Eof()                                  */
+/************************************************************************/
+
+int VSIGZipHandle::Eof()
+{
+#ifdef ENABLE_DEBUG
+    CPLDebug("GZIP", "Eof()");
+#endif
+    return z_eof && in == 0;
+}
+
+/************************************************************************/
+/*                              Flush()                                 */
+/************************************************************************/
+
+int VSIGZipHandle::Flush()
+{
+    return 0;
+}
+
+/************************************************************************/
+/*                              Close()                                 */
+/************************************************************************/
+
+int VSIGZipHandle::Close()
+{
+    return 0;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                       VSIGZipReadHandleMT                            */
+/* ==================================================================== */
+/************************************************************************/
+
+// Reader that decompresses, in worker threads and ahead of the consumer,
+// pieces of the compressed stream that can be decoded independently:
+// - groups of members of BGZF files, whose compressed size is in their
+//   header,
+// - groups of chunks of single-member files written by VSIGZipWriteHandleMT
+//   (or "pigz --independent"), which are terminated by a full flush marker.
+//   Those markers are found by pattern matching, so each piece is checked
+//   to decode to a deflate block boundary, and the CRC of the whole stream
+//   is checked at the end.
+// On any inconsistency, reading goes on with a serial VSIGZipHandle, which
+// will report errors, if any.
+// The layout is only probed on the first large sequential read: until then,
+// and for the reads following a seek that is better served by the seek
+// index of a non-BGZF file, the serial handle is used.
+
+constexpr size_t GZIP_MT_JOB_SIZE = 512 * 1024;
+constexpr size_t GZIP_MT_MAX_PENDING_SIZE = 64 * 1024 * 1024;
+constexpr size_t GZIP_MT_MAX_JOB_OUTPUT = 1024 * 1024 * 1024;
+constexpr size_t BGZF_HEADER_SIZE = 18;
+constexpr char achFullFlushMarker[] =
+    { '\x00', '\x00', '\xFF', '\xFF', '\x00', '\x00', '\x00', '\xFF', '\xFF' };
+
+class VSIGZipReadHandleMT final : public VSIVirtualHandle
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSIGZipReadHandleMT)
+
+    struct Job
+    {
+        VSIGZipReadHandleMT *poParent = nullptr;
+        bool                bLast = false; // contains the end of the stream
+        vsi_l_offset        nCompressedOffset = 0;
+        std::string         osCompressed{};
+
+        bool                bDone = false;
+        bool                bOK = false;
+        std::string         osUncompressed{};
+        uLong               nCRC = 0;
+        uLong               nTrailerCRC = 0;
+        uLong               nTrailerSize = 0;
+    };
+
+    struct Checkpoint
+    {
+        vsi_l_offset nUncompressedOffset;
+        vsi_l_offset nCompressedOffset;
+        uLong        nCRC;
+    };
+
+    VSIGZipHandle      *m_poSerialHandle = nullptr;
+    // Buffered reader owning m_poSerialHandle.
+    VSIVirtualHandle   *m_poSerialReader = nullptr;
+    std::shared_ptr<GZipSeekIndex> m_poSeekIndex{};
+    VSILFILE           *m_fpBase = nullptr;
+    bool                m_bBGZF = false;
+    vsi_l_offset        m_nStartOff = 0;
+    int                 m_nThreads = 0;
+    CPLWorkerThreadPool m_oPool{};
+    std::mutex          m_oMutex{};
+    std::condition_variable m_oCond{};
+    std::deque<std::unique_ptr<Job>> m_apoJobs{};
+    int                 m_nMaxJobsInFlight = 1;
+
+    // Compressed data read, but not yet assigned to a job.
+    vsi_l_offset        m_nPendingOffset = 0;
+    std::string         m_osPending{};
+    size_t              m_nScanPos = 0;
+    bool                m_bPendingEOF = false;
+    bool                m_bProducerDone = false;
+
+    vsi_l_offset        m_nCurOffset = 0;
+    vsi_l_offset        m_nJobOffset = 0;  // uncompressed offset of front job
+    size_t              m_nPosInJob = 0;
+    uLong               m_nCRC = 0;  // of the data before the front job
+    bool                m_bFrontJobChecked = false;
+    bool                m_bEOF = false;
+    bool                m_bProbed = false;
+    bool                m_bSerial = true;  // reads done by m_poSerialReader
+    bool                m_bFallback = false;  // m_bSerial for good
+    size_t              m_nSequentialBytes = 0;  // read serially since seek
+    std::vector<Checkpoint> m_aoCheckpoints{};
+
+    static void DecodeJob( void* pData );
+    bool Probe();
+    void AddCheckpoint( const Checkpoint& oCheckpoint );
+    std::unique_ptr<Job> CreateNextJob();
+    bool FeedPending();
+    void FillPipeline();
+    void Restart( const Checkpoint& oCheckpoint );
+    bool StartFallback();
+    size_t ReadOrSkip( GByte* pabyBuffer, size_t nToRead );
+
+    VSIGZipReadHandleMT( VSIGZipHandle* poSerialHandle, int nThreads );
+
+  public:
+    ~VSIGZipReadHandleMT() override;
+
+    static VSIVirtualHandle* Create( VSIGZipHandle* poSerialHandle );
+
+    int Seek( vsi_l_offset nOffset, int nWhence ) override;
+    vsi_l_offset Tell() override;
+    size_t Read( void *pBuffer, size_t nSize, size_t nMemb ) override;
+    size_t Write( const void *pBuffer, size_t nSize, size_t nMemb ) override;
+    int Eof() override;
+    int Flush() override { return 0; }
+    int Close() override;
+};
+
+/************************************************************************/
+/*                         GetGZipHeaderSize()                          */
+/************************************************************************/
+
+// Returns the size of the gzip member header at the start of pabyData,
+// or 0 if it is invalid or incomplete.
+static size_t GetGZipHeaderSize( const GByte* pabyData, size_t nSize )
+{
+    if( nSize < 10 || pabyData[0] != gz_magic[0] ||
+        pabyData[1] != gz_magic[1] || pabyData[2] != Z_DEFLATED ||
+        (pabyData[3] & RESERVED) != 0 )
+    {
+        return 0;
+    }
+    const int nFlags = pabyData[3];
+    size_t nPos = 10;
+    if( nFlags & EXTRA_FIELD )
+    {
+        if( nPos + 2 > nSize )
+            return 0;
+        nPos += 2 + (pabyData[nPos] | (pabyData[nPos + 1] << 8));
+    }
+    for( const int nFlag : { ORIG_NAME, COMMENT } )
+    {
+        if( nFlags & nFlag )
+        {
+            while( nPos < nSize && pabyData[nPos] != 0 )
+                nPos++;
+            nPos++;
+        }
+    }
+    if( nFlags & HEAD_CRC )
+        nPos += 2;
+    return nPos <= nSize ? nPos : 0;
+}
+
+/************************************************************************/
+/*                             IsBGZFHeader()                           */
+/************************************************************************/
+
+static bool IsBGZFHeader( const GByte* pabyData )
+{
+    return pabyData[0] == gz_magic[0] && pabyData[1] == gz_magic[1] &&
+           pabyData[2] == Z_DEFLATED && pabyData[3] == EXTRA_FIELD &&
+           pabyData[10] == 6 && pabyData[11] == 0 &&
+           pabyData[12] == 'B' && pabyData[13] == 'C' &&
+           pabyData[14] == 2 && pabyData[15] == 0;
+}
+
+/************************************************************************/
+/*                        VSIGZipReadHandleMT()                         */
+/************************************************************************/
+
+VSIGZipReadHandleMT::VSIGZipReadHandleMT( VSIGZipHandle* poSerialHandle,
+                                          int nThreads ) :
+    m_poSerialHandle(poSerialHandle),
+    m_poSerialReader(VSICreateBufferedReaderHandle(poSerialHandle)),
+    m_nThreads(nThreads)
+{
+}
+
+/************************************************************************/
+/*                                Create()                              */
+/************************************************************************/
+
+// Returns a multi-threaded reader taking ownership of poSerialHandle, or
+// nullptr if GDAL_NUM_THREADS is not set, or if the file is on a network
+// file system, where reading ahead could be costly.
+VSIVirtualHandle* VSIGZipReadHandleMT::Create( VSIGZipHandle* poSerialHandle )
+{
+    const char* pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    if( pszThreads == nullptr || poSerialHandle->GetBaseFileName() == nullptr ||
+        IsNetworkFileSystem(poSerialHandle->GetBaseFileName()) )
+    {
+        return nullptr;
+    }
+    int nThreads = EQUAL(pszThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                   atoi(pszThreads);
+    nThreads = std::max(1, std::min(128, nThreads));
+    if( nThreads <= 1 )
+        return nullptr;
+
+    return new VSIGZipReadHandleMT(poSerialHandle, nThreads);
+}
+
+/************************************************************************/
+/*                                Probe()                               */
+/************************************************************************/
+
+// Detects the layout from the first bytes of the file, and sets up the
+// parallel decompression if it is possible.
+bool VSIGZipReadHandleMT::Probe()
+{
+    m_bProbed = true;
+    m_fpBase = VSIFOpenL(m_poSerialHandle->GetBaseFileName(), "rb");
+    if( m_fpBase == nullptr )
+        return false;
+
+    std::string osData;
+    osData.resize(4 * GZIP_MT_JOB_SIZE);
+    osData.resize(VSIFReadL(&osData[0], 1, osData.size(), m_fpBase));
+    m_bPendingEOF = osData.size() < 4 * GZIP_MT_JOB_SIZE;
+    const GByte* pabyData = reinterpret_cast<const GByte*>(osData.data());
+    const size_t nHeaderSize = GetGZipHeaderSize(pabyData, osData.size());
+
+    if( osData.size() >= BGZF_HEADER_SIZE && IsBGZFHeader(pabyData) )
+    {
+        m_bBGZF = true;
+    }
+    else if( nHeaderSize > 0 &&
+             std::search(osData.begin() + nHeaderSize, osData.end(),
+                         achFullFlushMarker,
+                         achFullFlushMarker + sizeof(achFullFlushMarker))
+                                                        != osData.end() )
+    {
+        m_nStartOff = nHeaderSize;
+        osData.erase(0, nHeaderSize);
+    }
+    else
+    {
+        CPL_IGNORE_RET_VAL(VSIFCloseL(m_fpBase));
+        m_fpBase = nullptr;
+        return false;
+    }
+
+    CPLDebug("GZIP", "Using %d threads to decompress %s (%s)",
+             m_nThreads, m_poSerialHandle->GetBaseFileName(),
+             m_bBGZF ? "BGZF" : "full flush markers");
+    m_osPending = std::move(osData);
+    m_nPendingOffset = m_nStartOff;
+    m_aoCheckpoints.push_back(Checkpoint{0, m_nStartOff, 0});
+
+    // The points of the seek index of BGZF files are at member starts,
+    // which are also valid starting points for the parallel decompression.
+    m_poSeekIndex = m_poSerialHandle->GetSeekIndex();
+    if( m_bBGZF && m_poSeekIndex )
+    {
+        for( const auto& oPoint: m_poSeekIndex->aoPoints )
+        {
+            if( oPoint.nBits == 0 && oPoint.abyWindow.empty() &&
+                oPoint.nCompressedOffset >= BGZF_HEADER_SIZE )
+            {
+                AddCheckpoint(Checkpoint{
+                    oPoint.nUncompressedOffset,
+                    oPoint.nCompressedOffset - BGZF_HEADER_SIZE, 0});
+            }
+        }
+    }
+    m_bSerial = false;
+    return true;
+}
+
+/************************************************************************/
+/*                            AddCheckpoint()                           */
+/************************************************************************/
+
+void VSIGZipReadHandleMT::AddCheckpoint( const Checkpoint& oCheckpoint )
+{
+    auto oIter = std::lower_bound(m_aoCheckpoints.begin(),
+        m_aoCheckpoints.end(), oCheckpoint.nUncompressedOffset,
+        [](const Checkpoint& oOther, vsi_l_offset nVal)
+        { return oOther.nUncompressedOffset < nVal; });
+    if( oIter == m_aoCheckpoints.end() ||
+        oIter->nUncompressedOffset != oCheckpoint.nUncompressedOffset )
+    {
+        m_aoCheckpoints.insert(oIter, oCheckpoint);
+    }
+}
+
+/************************************************************************/
+/*                       ~VSIGZipReadHandleMT()                         */
+/************************************************************************/
+
+VSIGZipReadHandleMT::~VSIGZipReadHandleMT()
+{
+    VSIGZipReadHandleMT::Close();
+}
+
+/************************************************************************/
+/*                                Close()                               */
+/************************************************************************/
+
+int VSIGZipReadHandleMT::Close()
+{
+    if( m_oPool.GetThreadCount() )
+        m_oPool.WaitCompletion(0);
+    m_apoJobs.clear();
+    if( m_fpBase )
+    {
+        CPL_IGNORE_RET_VAL(VSIFCloseL(m_fpBase));
+        m_fpBase = nullptr;
+    }
+    if( m_poSerialReader )
+    {
+        m_poSerialReader->Close();
+        delete m_poSerialReader;
+        m_poSerialReader = nullptr;
+        m_poSerialHandle = nullptr;
+    }
+    return 0;
+}
+
+/************************************************************************/
+/*                              DecodeJob()                             */
+/************************************************************************/
+
+void VSIGZipReadHandleMT::DecodeJob( void* pData )
+{
+    Job* psJob = static_cast<Job*>(pData);
+    const bool bBGZF = psJob->poParent->m_bBGZF;
+    const GByte* pabyIn =
+        reinterpret_cast<const GByte*>(psJob->osCompressed.data());
+    const size_t nInSize = psJob->osCompressed.size();
+    std::string& osOut = psJob->osUncompressed;
+
+    z_stream sStream;
+    memset(&sStream, 0, sizeof(sStream));
+    bool bOK = inflateInit2(&sStream, -MAX_WBITS) == Z_OK;
+    if( bOK && bBGZF )
+    {
+        // The producer has checked that this is a sequence of complete
+        // BGZF members.
+        size_t nOutSize = 0;
+        for( size_t nPos = 0; nPos < nInSize; )
+        {
+            const size_t nBlockSize =
+                (pabyIn[nPos + 16] | (pabyIn[nPos + 17] << 8)) + 1;
+            const GByte* pabyTrailer = pabyIn + nPos + nBlockSize - 8;
+            nOutSize += CPL_LSBUINT32PTR(pabyTrailer + 4);
+            nPos += nBlockSize;
+        }
+        // BGZF members are at most 64 KB large once uncompressed.
+        bOK = nOutSize <= nInSize / 26 * 65536;
+        if( bOK )
+            osOut.resize(nOutSize);
+        size_t nOutPos = 0;
+        for( size_t nPos = 0; bOK && nPos < nInSize; )
+        {
+            const size_t nBlockSize =
+                (pabyIn[nPos + 16] | (pabyIn[nPos + 17] << 8)) + 1;
+            const GByte* pabyTrailer = pabyIn + nPos + nBlockSize - 8;
+            const uInt nISize = CPL_LSBUINT32PTR(pabyTrailer + 4);
+            GByte* pabyOut = reinterpret_cast<GByte*>(&osOut[0]) + nOutPos;
+            inflateReset(&sStream);
+            sStream.next_in = const_cast<Bytef*>(pabyIn + nPos +
+                                                 BGZF_HEADER_SIZE);
+            sStream.avail_in =
+                static_cast<uInt>(nBlockSize - BGZF_HEADER_SIZE - 8);
+            sStream.next_out = pabyOut;
+            sStream.avail_out = nISize;
+            int nRet = inflate(&sStream, Z_FINISH);
+            uInt nExpectedAvailOut = 0;
+            if( nRet == Z_BUF_ERROR && sStream.avail_out == 0 )
+            {
+                // Extra byte of output space to detect too large members.
+                GByte byDummy = 0;
+                sStream.next_out = &byDummy;
+                sStream.avail_out = 1;
+                nExpectedAvailOut = 1;
+                nRet = inflate(&sStream, Z_FINISH);
+            }
+            bOK = nRet == Z_STREAM_END && sStream.avail_in == 0 &&
+                  sStream.avail_out == nExpectedAvailOut &&
+                  crc32(0, pabyOut, nISize) ==
+                        CPL_LSBUINT32PTR(pabyTrailer);
+            nOutPos += nISize;
+            nPos += nBlockSize;
+        }
+    }
+    else if( bOK )
+    {
+        sStream.next_in = const_cast<Bytef*>(pabyIn);
+        sStream.avail_in = static_cast<uInt>(nInSize);
+        size_t nOutPos = 0;
+        int nRet = Z_OK;
+        while( true )
+        {
+            if( nOutPos == osOut.size() )
+            {
+                if( osOut.size() >= GZIP_MT_MAX_JOB_OUTPUT )
+                {
+                    nRet = Z_MEM_ERROR;
+                    break;
+                }
+                osOut.resize(std::max(4 * nInSize, 2 * osOut.size()));
+            }
+            sStream.next_out = reinterpret_cast<Bytef*>(&osOut[0]) + nOutPos;
+            sStream.avail_out = static_cast<uInt>(osOut.size() - nOutPos);
+            nRet = inflate(&sStream, Z_NO_FLUSH);
+            nOutPos = osOut.size() - sStream.avail_out;
+            if( nRet == Z_BUF_ERROR && sStream.avail_in == 0 )
+                nRet = Z_OK;  // Output buffer was exactly full
+            if( nRet != Z_OK || (sStream.avail_in == 0 &&
+                                 sStream.avail_out != 0) )
+            {
+                break;
+            }
+        }
+        osOut.resize(nOutPos);
+        if( psJob->bLast )
+        {
+            // Must end with the end of the deflate stream and the trailer.
+            bOK = nRet == Z_STREAM_END && sStream.avail_in == 8;
+            if( bOK )
+            {
+                psJob->nTrailerCRC = CPL_LSBUINT32PTR(sStream.next_in);
+                psJob->nTrailerSize = CPL_LSBUINT32PTR(sStream.next_in + 4);
+            }
+        }
+        else
+        {
+            // Must end at a byte-aligned block boundary.
+            bOK = nRet == Z_OK && sStream.avail_in == 0 &&
+                  (sStream.data_type & 128) != 0 &&
+                  (sStream.data_type & 7) == 0;
+        }
+        if( bOK )
+        {
+            psJob->nCRC = crc32(0,
+                reinterpret_cast<const Bytef*>(osOut.data()),
+                static_cast<uInt>(osOut.size()));
+        }
+    }
+    inflateEnd(&sStream);
+
+    std::lock_guard<std::mutex> oLock(psJob->poParent->m_oMutex);
+    psJob->bOK = bOK;
+    psJob->bDone = true;
+    psJob->poParent->m_oCond.notify_all();
+}
+
+/************************************************************************/
+/*                            FeedPending()                             */
+/************************************************************************/
+
+bool VSIGZipReadHandleMT::FeedPending()
+{
+    if( m_bPendingEOF || m_osPending.size() > GZIP_MT_MAX_PENDING_SIZE )
+        return false;
+    const size_t nOldSize = m_osPending.size();
+    m_osPending.resize(nOldSize + GZIP_MT_JOB_SIZE);
+    size_t nRead = 0;
+    if( VSIFSeekL(m_fpBase, m_nPendingOffset + nOldSize, SEEK_SET) == 0 )
+        nRead = VSIFReadL(&m_osPending[nOldSize], 1, GZIP_MT_JOB_SIZE,
+                          m_fpBase);
+    m_osPending.resize(nOldSize + nRead);
+    if( nRead < GZIP_MT_JOB_SIZE )
+        m_bPendingEOF = true;
+    return nRead > 0;
+}
+
+/************************************************************************/
+/*                           CreateNextJob()                            */
+/************************************************************************/
+
+// Returns the next job, possibly already in failed state if the layout of
+// the compressed data is not the expected one, or nullptr at end of file.
+std::unique_ptr<VSIGZipReadHandleMT::Job> VSIGZipReadHandleMT::CreateNextJob()
+{
+    std::unique_ptr<Job> poJob(new Job());
+    poJob->poParent = this;
+    poJob->nCompressedOffset = m_nPendingOffset;
+
+    size_t nEnd = 0;
+    bool bValid = true;
+    if( m_bBGZF )
+    {
+        while( nEnd < GZIP_MT_JOB_SIZE )
+        {
+            while( m_osPending.size() < nEnd + BGZF_HEADER_SIZE &&
+                   FeedPending() ) {}
+            if( m_osPending.size() == nEnd )
+            {
+                m_bProducerDone = m_bPendingEOF;
+                break;
+            }
+            const GByte* pabyHeader =
+                reinterpret_cast<const GByte*>(m_osPending.data()) + nEnd;
+            if( m_osPending.size() < nEnd + BGZF_HEADER_SIZE ||
+                !IsBGZFHeader(pabyHeader) )
             {
-                z_eof = 1;
-                if( VSIFTellL(reinterpret_cast<VSILFILE*>(m_poBaseHandle)) !=
-                    offsetEndCompressedData )
-                {
-                    z_err = Z_ERRNO;
-                    break;
-                }
+                bValid = false;
+                break;
             }
-            stream.next_in = inbuf;
-        }
-        in += stream.avail_in;
-        out += stream.avail_out;
-        z_err = inflate(& (stream), Z_NO_FLUSH);
-        in -= stream.avail_in;
-        out -= stream.avail_out;
-
-        if( z_err == Z_STREAM_END && m_compressed_size != 2 )
-        {
-            // Check CRC and original size.
-            crc = crc32(crc, pStart,
-                        static_cast<uInt>(stream.next_out - pStart));
-            pStart = stream.next_out;
-            if( m_expected_crc )
+            const size_t nBlockSize =
+                (pabyHeader[16] | (pabyHeader[17] << 8)) + 1;
+            while( m_osPending.size() < nEnd + nBlockSize && FeedPending() ) {}
+            if( nBlockSize < BGZF_HEADER_SIZE + 8 ||
+                m_osPending.size() < nEnd + nBlockSize )
             {
-#ifdef ENABLE_DEBUG
-                CPLDebug(
-                    "GZIP",
-                    "Computed CRC = %X. Expected CRC = %X",
-                    static_cast<unsigned int>(crc),
-                    static_cast<unsigned int>(m_expected_crc));
-#endif
+                bValid = false;
+                break;
             }
-            if( m_expected_crc != 0 && m_expected_crc != crc )
+            nEnd += nBlockSize;
+        }
+    }
+    else
+    {
+        // Cut after the first full flush marker past GZIP_MT_JOB_SIZE.
+        while( true )
+        {
+            if( m_osPending.size() > GZIP_MT_JOB_SIZE )
             {
-                CPLError(CE_Failure, CPLE_FileIO,
-                         "CRC error. Got %X instead of %X",
-                         static_cast<unsigned int>(crc),
-                         static_cast<unsigned int>(m_expected_crc));
-                z_err = Z_DATA_ERROR;
+                auto oIter = std::search(
+                    m_osPending.begin() +
+                        std::max(m_nScanPos, GZIP_MT_JOB_SIZE -
+                                                sizeof(achFullFlushMarker)),
+                    m_osPending.end(),
+                    achFullFlushMarker,
+                    achFullFlushMarker + sizeof(achFullFlushMarker));
+                if( oIter != m_osPending.end() )
+                {
+                    nEnd = (oIter - m_osPending.begin()) +
+                           sizeof(achFullFlushMarker);
+                    break;
+                }
+                m_nScanPos = m_osPending.size() - sizeof(achFullFlushMarker);
             }
-            else if( m_expected_crc == 0 )
+            if( !FeedPending() )
             {
-                const uLong read_crc =
-                    static_cast<unsigned long>(getLong());
-                if( read_crc != crc )
+                // A valid stream ends with a non-empty piece containing
+                // the last deflate block and the trailer.
+                if( m_bPendingEOF && !m_osPending.empty() )
                 {
-                    CPLError(CE_Failure, CPLE_FileIO,
-                             "CRC error. Got %X instead of %X",
-                             static_cast<unsigned int>(crc),
-                             static_cast<unsigned int>(read_crc));
-                    z_err = Z_DATA_ERROR;
+                    nEnd = m_osPending.size();
+                    poJob->bLast = true;
+                    m_bProducerDone = true;
                 }
                 else
                 {
-                    CPL_IGNORE_RET_VAL(getLong());
-                    // The uncompressed length returned by above getlong() may
-                    // be different from out in case of concatenated .gz files.
-                    // Check for such files:
-                    check_header();
-                    if( z_err == Z_OK )
-                    {
-                        inflateReset(& (stream));
-                        crc = 0;
-                    }
+                    // Truncated stream, or no marker in a very long sequence
+                    bValid = false;
                 }
+                break;
             }
         }
-        if( z_err != Z_OK || z_eof )
-            break;
+        m_nScanPos = 0;
     }
-    crc = crc32(crc, pStart, static_cast<uInt>(stream.next_out - pStart));
 
-    size_t ret = (len - stream.avail_out) / nSize;
-    if( z_err != Z_OK && z_err != Z_STREAM_END )
+    if( !bValid )
     {
-        z_eof = 1;
-        in = 0;
-        CPLError(CE_Failure, CPLE_AppDefined,
-                 "In file %s, at line %d, decompression failed with "
-                 "z_err = %d, return = %d",
-                 __FILE__, __LINE__, z_err, static_cast<int>(ret));
+        poJob->bDone = true;
+        return poJob;
     }
+    if( nEnd == 0 )
+        return nullptr;
 
-#ifdef ENABLE_DEBUG
-    CPLDebug("GZIP", "Read return %d (z_err=%d, z_eof=%d)",
-             static_cast<int>(ret), z_err, z_eof);
-#endif
-    return ret;
+    poJob->osCompressed.assign(m_osPending, 0, nEnd);
+    m_osPending.erase(0, nEnd);
+    m_nPendingOffset += nEnd;
+    return poJob;
 }
 
 /************************************************************************/
-/*                              getLong()                               */
+/*                            FillPipeline()                            */
 /************************************************************************/
 
-uLong VSIGZipHandle::getLong ()
+void VSIGZipReadHandleMT::FillPipeline()
 {
-    uLong x = static_cast<uLong>(get_byte()) & 0xFF;
+    const bool bUsePool = m_oPool.GetThreadCount() != 0 ||
+                          m_oPool.Setup(m_nThreads, nullptr, nullptr);
+    while( static_cast<int>(m_apoJobs.size()) < m_nMaxJobsInFlight &&
+           !m_bProducerDone )
+    {
+        std::unique_ptr<Job> poJob = CreateNextJob();
+        if( poJob == nullptr )
+            break;
+        const bool bFailed = poJob->bDone;
+        if( !bFailed && bUsePool )
+            m_oPool.SubmitJob(DecodeJob, poJob.get());
+        else if( !bFailed )
+            DecodeJob(poJob.get());
+        m_apoJobs.emplace_back(std::move(poJob));
+        if( bFailed )
+            break;
+    }
+}
 
-    x += (static_cast<uLong>(get_byte()) & 0xFF) << 8;
-    x += (static_cast<uLong>(get_byte()) & 0xFF) << 16;
-    const int c = get_byte();
-    if( c == EOF )
+/************************************************************************/
+/*                               Restart()                              */
+/************************************************************************/
+
+void VSIGZipReadHandleMT::Restart( const Checkpoint& oCheckpoint )
+{
+    if( m_oPool.GetThreadCount() )
+        m_oPool.WaitCompletion(0);
+    m_apoJobs.clear();
+    m_nPendingOffset = oCheckpoint.nCompressedOffset;
+    m_osPending.clear();
+    m_nScanPos = 0;
+    m_bPendingEOF = false;
+    m_bProducerDone = false;
+    m_nCurOffset = oCheckpoint.nUncompressedOffset;
+    m_nJobOffset = oCheckpoint.nUncompressedOffset;
+    m_nCRC = oCheckpoint.nCRC;
+    m_nPosInJob = 0;
+    m_bFrontJobChecked = false;
+    // Random access: do not decompress too much ahead until we know
+    // the reading is sequential.
+    m_nMaxJobsInFlight = 1;
+}
+
+/************************************************************************/
+/*                            StartFallback()                           */
+/************************************************************************/
+
+bool VSIGZipReadHandleMT::StartFallback()
+{
+    CPLDebug("GZIP", "Unexpected content at offset " CPL_FRMT_GUIB
+             " of %s. Going on with serial decompression",
+             m_apoJobs.empty() ? m_nPendingOffset :
+                                 m_apoJobs.front()->nCompressedOffset,
+             m_poSerialHandle->GetBaseFileName());
+    if( m_oPool.GetThreadCount() )
+        m_oPool.WaitCompletion(0);
+    m_apoJobs.clear();
+    m_bFallback = true;
+    m_bSerial = true;
+    return m_poSerialReader->Seek(m_nCurOffset, SEEK_SET) == 0;
+}
+
+/************************************************************************/
+/*                             ReadOrSkip()                             */
+/************************************************************************/
+
+// Returns the number of bytes read (or skipped if pabyBuffer == nullptr).
+size_t VSIGZipReadHandleMT::ReadOrSkip( GByte* pabyBuffer, size_t nToRead )
+{
+    size_t nRead = 0;
+    while( nRead < nToRead )
     {
-        z_err = Z_DATA_ERROR;
+        if( m_bSerial )
+        {
+            if( pabyBuffer )
+                return nRead + m_poSerialReader->Read(pabyBuffer + nRead, 1,
+                                                      nToRead - nRead);
+            const vsi_l_offset nTarget =
+                m_poSerialReader->Tell() + (nToRead - nRead);
+            if( m_poSerialReader->Seek(nTarget, SEEK_SET) != 0 )
+                return nRead;
+            return nToRead;
+        }
+
+        FillPipeline();
+        if( m_apoJobs.empty() )
+        {
+            if( m_bProducerDone )
+                m_poSerialHandle->SetUncompressedSize(m_nCurOffset);
+            m_bEOF = true;
+            break;
+        }
+        Job* psJob = m_apoJobs.front().get();
+        {
+            std::unique_lock<std::mutex> oLock(m_oMutex);
+            m_oCond.wait(oLock, [psJob]{ return psJob->bDone; });
+        }
+        const size_t nJobSize = psJob->osUncompressed.size();
+        if( !m_bFrontJobChecked )
+        {
+            bool bOK = psJob->bOK;
+            if( bOK && psJob->bLast )
+            {
+                bOK = crc32_combine(m_nCRC, psJob->nCRC,
+                                    static_cast<z_off_t>(nJobSize)) ==
+                                                    psJob->nTrailerCRC &&
+                      static_cast<uLong>((m_nJobOffset + nJobSize) &
+                                         0xFFFFFFFFU) == psJob->nTrailerSize;
+            }
+            if( !bOK )
+            {
+                if( !StartFallback() )
+                    return nRead;
+                continue;
+            }
+            m_bFrontJobChecked = true;
+            AddCheckpoint(Checkpoint{
+                m_nJobOffset, psJob->nCompressedOffset, m_nCRC});
+        }
+
+        const size_t nToCopy =
+            std::min(nToRead - nRead, nJobSize - m_nPosInJob);
+        if( pabyBuffer )
+        {
+            memcpy(pabyBuffer + nRead,
+                   psJob->osUncompressed.data() + m_nPosInJob, nToCopy);
+        }
+        nRead += nToCopy;
+        m_nPosInJob += nToCopy;
+        m_nCurOffset += nToCopy;
+        if( m_nPosInJob == nJobSize )
+        {
+            if( !m_bBGZF )
+            {
+                m_nCRC = crc32_combine(m_nCRC, psJob->nCRC,
+                                       static_cast<z_off_t>(nJobSize));
+            }
+            m_nJobOffset += nJobSize;
+            m_nPosInJob = 0;
+            m_bFrontJobChecked = false;
+            m_apoJobs.pop_front();
+            m_nMaxJobsInFlight = std::min(2 * m_nThreads,
+                                          2 * m_nMaxJobsInFlight);
+        }
+    }
+    return nRead;
+}
+
+/************************************************************************/
+/*                                Read()                                */
+/************************************************************************/
+
+size_t VSIGZipReadHandleMT::Read( void *pBuffer, size_t nSize, size_t nMemb )
+{
+    if( nSize == 0 || nMemb == 0 )
         return 0;
+    const size_t nToRead = nSize * nMemb;
+    if( !m_bProbed )
+    {
+        // Only worth it for large sequential reads.
+        m_nSequentialBytes += nToRead;
+        if( m_nSequentialBytes >= GZIP_MT_JOB_SIZE )
+        {
+            const vsi_l_offset nCurOffset = m_poSerialReader->Tell();
+            if( !Probe() )
+                m_bFallback = true;
+            else if( Seek(nCurOffset, SEEK_SET) != 0 )
+                return 0;
+        }
     }
-    x += static_cast<uLong>(c) << 24;
-    // coverity[overflow_sink]
-    return x;
+    return ReadOrSkip(static_cast<GByte*>(pBuffer), nToRead) / nSize;
 }
 
 /************************************************************************/
-/*                              Write()                                 */
+/*                                Seek()                                */
 /************************************************************************/
 
-size_t VSIGZipHandle::Write( const void * /* pBuffer */,
-                             size_t /* nSize */,
-                             size_t /* nMemb */ )
+int VSIGZipReadHandleMT::Seek( vsi_l_offset nOffset, int nWhence )
 {
-    CPLError(CE_Failure, CPLE_NotSupported,
-             "VSIFWriteL is not supported on GZip streams");
-    return 0;
+    if( !m_bProbed &&
+        !(nWhence == SEEK_SET && nOffset == m_poSerialReader->Tell()) )
+    {
+        m_nSequentialBytes = 0;
+    }
+    if( !m_bProbed || m_bFallback )
+        return m_poSerialReader->Seek(nOffset, nWhence);
+
+    const bool bWasSerial = m_bSerial;
+    if( bWasSerial )
+    {
+        // Coming back from a serial read after a jump through the seek
+        // index: resume from the current position of the serial reader.
+        m_bSerial = false;
+        if( nWhence == SEEK_CUR )
+        {
+            nOffset += m_poSerialReader->Tell();
+            nWhence = SEEK_SET;
+        }
+    }
+
+    m_bEOF = false;
+    vsi_l_offset nTarget = nOffset;
+    if( nWhence == SEEK_CUR )
+    {
+        nTarget += m_nCurOffset;
+    }
+    else if( nWhence == SEEK_END )
+    {
+        if( nOffset != 0 )
+            return -1;
+        const vsi_l_offset nSize = m_poSerialHandle->GetUncompressedSize();
+        if( nSize == 0 )
+        {
+            // Decompress until the end.
+            if( bWasSerial )
+                Restart(m_aoCheckpoints.back());
+            while( ReadOrSkip(nullptr, 100 * 1024 * 1024) != 0 ) {}
+            m_bEOF = false;
+            return m_bSerial ? m_poSerialReader->Seek(0, SEEK_END) : 0;
+        }
+        nTarget = nSize;
+    }
+
+    // Within the current job ?
+    if( !bWasSerial && nTarget >= m_nJobOffset && nTarget <= m_nCurOffset )
+    {
+        m_nPosInJob -= static_cast<size_t>(m_nCurOffset - nTarget);
+        m_nCurOffset = nTarget;
+        return 0;
+    }
+
+    // Restart from the closest known position, if more appropriate than
+    // decompressing from the current position.
+    auto oIter = std::upper_bound(m_aoCheckpoints.begin(),
+        m_aoCheckpoints.end(), nTarget,
+        [](vsi_l_offset nVal, const Checkpoint& oCheckpoint)
+        { return nVal < oCheckpoint.nUncompressedOffset; });
+    --oIter;
+    const vsi_l_offset nFrom =
+        (bWasSerial || nTarget < m_nCurOffset ||
+         oIter->nUncompressedOffset > m_nCurOffset) ?
+            oIter->nUncompressedOffset : m_nCurOffset;
+
+    // For non-BGZF files, the points of the seek index cannot be used to
+    // start parallel decompression, but the serial handle can use them.
+    if( !m_bBGZF && m_poSeekIndex )
+    {
+        const auto& aoPoints = m_poSeekIndex->aoPoints;
+        auto oPointIter = std::upper_bound(aoPoints.begin(), aoPoints.end(),
+            nTarget,
+            [](vsi_l_offset nVal, const GZipSeekPoint& oPoint)
+            { return nVal < oPoint.nUncompressedOffset; });
+        if( oPointIter != aoPoints.begin() &&
+            (oPointIter - 1)->nUncompressedOffset > nFrom &&
+            (oPointIter - 1)->nUncompressedOffset - nFrom >=
+                                                        GZIP_MT_JOB_SIZE )
+        {
+            if( m_oPool.GetThreadCount() )
+                m_oPool.WaitCompletion(0);
+            m_apoJobs.clear();
+            m_bSerial = true;
+            return m_poSerialReader->Seek(nTarget, SEEK_SET);
+        }
+    }
+
+    if( nFrom != m_nCurOffset || bWasSerial )
+    {
+        Restart(*oIter);
+    }
+
+    const vsi_l_offset nToSkip = nTarget - m_nCurOffset;
+    if( nToSkip == 0 )
+        return 0;
+    const size_t nSkipped =
+        ReadOrSkip(nullptr, static_cast<size_t>(nToSkip));
+    return nSkipped == nToSkip ? 0 : -1;
 }
 
 /************************************************************************/
-/*                               Eof()                                  */
+/*                                Tell()                                */
 /************************************************************************/
 
-int VSIGZipHandle::Eof()
+vsi_l_offset VSIGZipReadHandleMT::Tell()
 {
-#ifdef ENABLE_DEBUG
-    CPLDebug("GZIP", "Eof()");
-#endif
-    return z_eof && in == 0;
+    if( m_bSerial )
+        return m_poSerialReader->Tell();
+    return m_nCurOffset;
 }
 
 /************************************************************************/
-/*                              Flush()                                 */
+/*                                Eof()                                 */
 /************************************************************************/
 
-int VSIGZipHandle::Flush()
+int VSIGZipReadHandleMT::Eof()
 {
-    return 0;
+    if( m_bSerial )
+        return m_poSerialReader->Eof();
+    return m_bEOF;
 }
 
 /************************************************************************/
-/*                              Close()                                 */
+/*                               Write()                                */
 /************************************************************************/
 
-int VSIGZipHandle::Close()
+size_t VSIGZipReadHandleMT::Write( const void * /* pBuffer */,
+                                   size_t /* nSize */,
+                                   size_t /* nMemb */ )
 {
+    CPLError(CE_Failure, CPLE_NotSupported,
+             "VSIFWriteL is not supported on GZip streams");
     return 0;
 }
 
@@ -2178,6 +3668,13 @@ VSIVirtualHandle* VSIGZipFilesystemHandler::Open( const char *pszFilename,
 /* -------------------------------------------------------------------- */
 
     VSIGZipHandle* poGZIPHandle = OpenGZipReadOnly(pszFilename, pszAccess);
+    if( poGZIPHandle )
+    {
+        VSIVirtualHandle* poMTHandle =
+            VSIGZipReadHandleMT::Create(poGZIPHandle);
+        if( poMTHandle )
+            return poMTHandle;
+    }
     if( poGZIPHandle )
         // Wrap the VSIGZipHandle inside a buffered reader that will
         // improve dramatically performance when doing small backward
@@ -2246,6 +3743,7 @@ VSIGZipHandle* VSIGZipFilesystemHandler::OpenGZipReadOnly(
         delete poHandle;
         return nullptr;
     }
+    poHandle->InitSeekIndex();
     return poHandle;
 }
 
@@ -2412,10 +3910,14 @@ const char* VSIGZipFilesystemHandler::GetOptions()
     return
     "<Options>"
     "  <Option name='GDAL_NUM_THREADS' type='string' "
-        "description='Number of threads for compression. Either a integer or ALL_CPUS'/>"
+        "description='Number of threads for compression and decompression. Either a integer or ALL_CPUS'/>"
     "  <Option name='CPL_VSIL_DEFLATE_CHUNK_SIZE' type='string' "
         "description='Chunk of uncompressed data for parallelization. "
         "Use K(ilobytes) or M(egabytes) suffix' default='1M'/>"
+    "  <Option name='CPL_VSIL_GZIP_WRITE_SEEK_INDEX' type='boolean' "
+        "description='Whether to create a .gz.idx seek index' default='NO'/>"
+    "  <Option name='CPL_VSIL_GZIP_SEEK_INDEX_SPACING' type='int' "
+        "description='Distance in MB between seek points' default='4'/>"
     "</Options>";
 }
 
@@ -2457,6 +3959,15 @@ class VSIZipEntryFileOffset final : public VSIArchiveEntryFileOffset
 public:
         unz_file_pos m_file_pos;
 
+        // Information from the central directory, so that the member can
+        // be opened without re-reading the central directory.
+        uLong64 m_nLocalHeaderPos = 0;
+        uLong64 m_nCompressedSize = 0;
+        uLong64 m_nUncompressedSize = 0;
+        uLong   m_nCRC = 0;
+        uLong   m_nCompressionMethod = 0;
+        uLong   m_nFlag = 0;
+
         explicit VSIZipEntryFileOffset( unz_file_pos file_pos ):
             m_file_pos()
         {
@@ -2481,6 +3992,8 @@ class VSIZipReader final : public VSIArchiveReader
     GUIntBig nNextFileSize = 0;
     CPLString osNextFileName{};
     GIntBig nModifiedTime = 0;
+    unz_file_info sFileInfo{};
+    uLong64 nLocalHeaderPos = 0;
 
     bool SetInfo();
 
@@ -2494,8 +4007,7 @@ class VSIZipReader final : public VSIArchiveReader
 
     int GotoFirstFile() override;
     int GotoNextFile() override;
-    VSIArchiveEntryFileOffset* GetFileOffset() override
-        { return new VSIZipEntryFileOffset(file_pos); }
+    VSIArchiveEntryFileOffset* GetFileOffset() override;
     GUIntBig GetFileSize() override { return nNextFileSize; }
     CPLString GetFileName() override { return osNextFileName; }
     GIntBig GetModifiedTime() override { return nModifiedTime; }
@@ -2544,6 +4056,8 @@ bool VSIZipReader::SetInfo()
     fileName[sizeof(fileName) - 1] = '\0';
     osNextFileName = fileName;
     nNextFileSize = file_info.uncompressed_size;
+    sFileInfo = file_info;
+    nLocalHeaderPos = cpl_unzGetCurrentFileLocalHeaderPos(unzF);
     struct tm brokendowntime;
     brokendowntime.tm_sec = file_info.tmu_date.tm_sec;
     brokendowntime.tm_min = file_info.tmu_date.tm_min;
@@ -2558,6 +4072,22 @@ bool VSIZipReader::SetInfo()
     return true;
 }
 
+/************************************************************************/
+/*                           GetFileOffset()                            */
+/************************************************************************/
+
+VSIArchiveEntryFileOffset* VSIZipReader::GetFileOffset()
+{
+    VSIZipEntryFileOffset* poOffset = new VSIZipEntryFileOffset(file_pos);
+    poOffset->m_nLocalHeaderPos = nLocalHeaderPos;
+    poOffset->m_nCompressedSize = sFileInfo.compressed_size;
+    poOffset->m_nUncompressedSize = sFileInfo.uncompressed_size;
+    poOffset->m_nCRC = sFileInfo.crc;
+    poOffset->m_nCompressionMethod = sFileInfo.compression_method;
+    poOffset->m_nFlag = sFileInfo.flag;
+    return poOffset;
+}
+
 /************************************************************************/
 /*                           GotoNextFile()                             */
 /************************************************************************/
@@ -2623,6 +4153,8 @@ class VSIZipFilesystemHandler final : public VSIArchiveFilesystemHandler
     std::map<CPLString, VSIZipWriteHandle*> oMapZipWriteHandles{};
     VSIVirtualHandle *OpenForWrite_unlocked( const char *pszFilename,
                                             const char *pszAccess );
+    VSIVirtualHandle *OpenFromIndex( const char* pszZipFilename,
+                                     const char* pszZipInFileName );
 
   public:
     VSIZipFilesystemHandler() = default;
@@ -2798,6 +4330,17 @@ VSIVirtualHandle* VSIZipFilesystemHandler::Open( const char *pszFilename,
         }
     }
 
+    if( !osZipInFileName.empty() )
+    {
+        VSIVirtualHandle* poHandle =
+            OpenFromIndex(zipFilename, osZipInFileName);
+        if( poHandle != nullptr )
+        {
+            CPLFree(zipFilename);
+            return poHandle;
+        }
+    }
+
     VSIArchiveReader* poReader = OpenArchiveFile(zipFilename, osZipInFileName);
     if( poReader == nullptr )
     {
@@ -2870,6 +4413,80 @@ VSIVirtualHandle* VSIZipFilesystemHandler::Open( const char *pszFilename,
     return VSICreateBufferedReaderHandle(poGZIPHandle);
 }
 
+/************************************************************************/
+/*                           OpenFromIndex()                            */
+/************************************************************************/
+
+// Open a member of an archive whose central directory has already been
+// read, using the information cached in the index, instead of scanning the
+// central directory again. Each handle uses its own handle on the archive,
+// so members can be read concurrently from several threads.
+// Returns nullptr if the regular way must be used.
+VSIVirtualHandle* VSIZipFilesystemHandler::OpenFromIndex(
+                                            const char* pszZipFilename,
+                                            const char* pszZipInFileName )
+{
+    {
+        CPLMutexHolder oHolder( &hMutex );
+        if( oFileList.find(pszZipFilename) == oFileList.end() )
+            return nullptr;
+    }
+
+    const VSIArchiveEntry* psEntry = nullptr;
+    if( !FindFileInArchive(pszZipFilename, pszZipInFileName, &psEntry) ||
+        psEntry->bIsDir || psEntry->file_pos == nullptr )
+    {
+        return nullptr;
+    }
+    const VSIZipEntryFileOffset* poOffset =
+        static_cast<const VSIZipEntryFileOffset*>(psEntry->file_pos);
+    // Only non-encrypted stored or deflated members, like the regular way.
+    if( (poOffset->m_nFlag & 1) != 0 ||
+        (poOffset->m_nCompressionMethod != 0 &&
+         poOffset->m_nCompressionMethod != Z_DEFLATED) )
+    {
+        return nullptr;
+    }
+
+    VSIFilesystemHandler *poFSHandler =
+        VSIFileManager::GetHandler( pszZipFilename );
+    VSIVirtualHandle* poVirtualHandle =
+        poFSHandler->Open( pszZipFilename, "rb" );
+    if( poVirtualHandle == nullptr )
+        return nullptr;
+
+    // Read the local file header to skip its variable-size part.
+    GByte abyLocalHeader[30];
+    if( poVirtualHandle->Seek(poOffset->m_nLocalHeaderPos, SEEK_SET) != 0 ||
+        poVirtualHandle->Read(abyLocalHeader, 1, sizeof(abyLocalHeader)) !=
+            sizeof(abyLocalHeader) ||
+        memcmp(abyLocalHeader, "PK\x03\x04", 4) != 0 )
+    {
+        delete poVirtualHandle;
+        return nullptr;
+    }
+    const int nFileNameLen = abyLocalHeader[26] | (abyLocalHeader[27] << 8);
+    const int nExtraFieldLen = abyLocalHeader[28] | (abyLocalHeader[29] << 8);
+    const vsi_l_offset nDataPos = poOffset->m_nLocalHeaderPos +
+        sizeof(abyLocalHeader) + nFileNameLen + nExtraFieldLen;
+
+    VSIGZipHandle* poGZIPHandle =
+        new VSIGZipHandle(poVirtualHandle,
+                          nullptr,
+                          nDataPos,
+                          poOffset->m_nCompressedSize,
+                          poOffset->m_nUncompressedSize,
+                          poOffset->m_nCRC,
+                          poOffset->m_nCompressionMethod == 0);
+    if( !(poGZIPHandle->IsInitOK()) )
+    {
+        delete poGZIPHandle;
+        return nullptr;
+    }
+
+    return VSICreateBufferedReaderHandle(poGZIPHandle);
+}
+
 /************************************************************************/
 /*                                Mkdir()                               */
 /************************************************************************/
@@ -197,7 +197,13 @@ const char* VSIOSSFSHandler::GetOptions()
     "  <Option name='VSIOSS_CHUNK_SIZE' type='int' "
         "description='Size in MB for chunks of files that are uploaded. The"
         "default value of 50 MB allows for files up to 500 GB each' "
-        "default='50' min='1' max='1000'/>" +
+        "default='50' min='1' max='1000'/>"
+    "  <Option name='VSIOSS_UPLOAD_NUM_THREADS' type='string' "
+        "description='Number of threads used to upload parts in parallel, "
+        "or ALL_CPUS' default='1'/>"
+    "  <Option name='VSIOSS_UPLOAD_MAX_MEMORY' type='int' "
+        "description='Maximum size in MB of the buffers of parts being "
+        "uploaded for a file'/>" +
         VSICurlFilesystemHandler::GetOptionsStatic() +
         "</Options>");
     return osOptions.c_str();
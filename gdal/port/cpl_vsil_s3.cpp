@@ -629,9 +629,26 @@ VSIS3WriteHandle::VSIS3WriteHandle( IVSIS3LikeFSHandler* poFS,
 
     if( !m_bUseChunked )
     {
-        const int nChunkSizeMB = atoi(
-            CPLGetConfigOption("VSIS3_CHUNK_SIZE",
-                    CPLGetConfigOption("VSIOSS_CHUNK_SIZE", "50")));
+        // VSIS3_xxx or VSIOSS_xxx options, depending on the file system.
+        const CPLString osOptionPrefix(
+            CPLString("VSI") + m_poFS->GetDebugKey() + "_");
+        // The chunk size options of /vsis3/ and /vsioss/ used to be
+        // interchangeable, so accept the ones of the other file system
+        // when those of this one are not set.
+        const auto GetChunkSizeOption = [&osOptionPrefix](const char* pszKey,
+                                                          const char* pszDefault)
+        {
+            const char* pszVal = CPLGetConfigOption(
+                (osOptionPrefix + pszKey).c_str(), nullptr);
+            if( pszVal == nullptr )
+                pszVal = CPLGetConfigOption(
+                    (CPLString("VSIS3_") + pszKey).c_str(), nullptr);
+            if( pszVal == nullptr )
+                pszVal = CPLGetConfigOption(
+                    (CPLString("VSIOSS_") + pszKey).c_str(), pszDefault);
+            return pszVal;
+        };
+        const int nChunkSizeMB = atoi(GetChunkSizeOption("CHUNK_SIZE", "50"));
         if( nChunkSizeMB <= 0 || nChunkSizeMB > 1000 )
             m_nBufferSize = 0;
         else
@@ -639,8 +656,7 @@ VSIS3WriteHandle::VSIS3WriteHandle( IVSIS3LikeFSHandler* poFS,
 
         // For testing only !
         const char* pszChunkSizeBytes =
-            CPLGetConfigOption("VSIS3_CHUNK_SIZE_BYTES",
-                CPLGetConfigOption("VSIOSS_CHUNK_SIZE_BYTES", nullptr));
+            GetChunkSizeOption("CHUNK_SIZE_BYTES", nullptr);
         if( pszChunkSizeBytes )
             m_nBufferSize = atoi(pszChunkSizeBytes);
         if( m_nBufferSize <= 0 || m_nBufferSize > 1000 * 1024 * 1024 )
@@ -653,6 +669,38 @@ VSIS3WriteHandle::VSIS3WriteHandle( IVSIS3LikeFSHandler* poFS,
                     "Cannot allocate working buffer for %s",
                      m_poFS->GetFSPrefix().c_str());
         }
+
+        // Parts can be uploaded by worker threads, while the caller fills
+        // the buffer of the next one.
+        const char* pszNumThreads =
+            CPLGetConfigOption((osOptionPrefix + "UPLOAD_NUM_THREADS").c_str(),
+                               "1");
+        const int nNumThreads = std::min(128,
+            EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                               atoi(pszNumThreads));
+        if( nNumThreads > 1 && m_pabyBuffer != nullptr )
+        {
+            // Maximum number of parts being uploaded, or waiting to be
+            // uploaded, which bounds the memory used by the handle.
+            m_nMaxPendingParts = nNumThreads;
+            const char* pszMaxMemory = CPLGetConfigOption(
+                (osOptionPrefix + "UPLOAD_MAX_MEMORY").c_str(), nullptr);
+            if( pszMaxMemory )
+            {
+                const GIntBig nMaxBuffers =
+                    CPLAtoGIntBig(pszMaxMemory) * 1024 * 1024 / m_nBufferSize;
+                m_nMaxPendingParts = static_cast<int>(
+                    std::max(static_cast<GIntBig>(1),
+                             std::min(static_cast<GIntBig>(knMAX_PART_NUMBER),
+                                      nMaxBuffers - 1)));
+            }
+            m_poUploadPool.reset(new CPLWorkerThreadPool());
+            if( !m_poUploadPool->Setup(
+                    std::min(nNumThreads, m_nMaxPendingParts), nullptr, nullptr) )
+            {
+                m_poUploadPool.reset();
+            }
+        }
     }
 }
 
@@ -665,6 +713,8 @@ VSIS3WriteHandle::~VSIS3WriteHandle()
     Close();
     delete m_poS3HandleHelper;
     CPLFree(m_pabyBuffer);
+    for( GByte* pabyBuffer: m_apabyFreeBuffers )
+        CPLFree(pabyBuffer);
     if( m_hCurlMulti )
     {
         if( m_hCurl )
@@ -835,11 +885,15 @@ bool VSIS3WriteHandle::UploadPart()
             CE_Failure, CPLE_AppDefined,
             "%d parts have been uploaded for %s failed. "
             "This is the maximum. "
-            "Increase VSIS3_CHUNK_SIZE to a higher value (e.g. 500 for 500 MB)",
+            "Increase VSI%s_CHUNK_SIZE to a higher value (e.g. 500 for 500 MB)",
             knMAX_PART_NUMBER,
-            m_osFilename.c_str());
+            m_osFilename.c_str(),
+            m_poFS->GetDebugKey());
         return false;
     }
+    if( m_poUploadPool )
+        return SubmitPart();
+
     const CPLString osEtag =
         m_poFS->UploadPart(m_osFilename, m_nPartNumber, m_osUploadID,
                            m_pabyBuffer, m_nBufferOff,
@@ -853,6 +907,171 @@ bool VSIS3WriteHandle::UploadPart()
     return !osEtag.empty();
 }
 
+/************************************************************************/
+/*                            PendingPart                               */
+/************************************************************************/
+
+struct VSIS3WriteHandle::PendingPart
+{
+    VSIS3WriteHandle   *poHandle = nullptr;
+    std::unique_ptr<IVSIS3LikeHandleHelper> poS3HandleHelper{};
+    int                 nPartNumber = 0;
+    GByte              *pabyData = nullptr;
+    size_t              nSize = 0;
+    CPLString           osEtag{};
+    volatile int        nDone = 0;
+
+    // Errors emitted by the worker thread, re-emitted on the thread that
+    // collects the part.
+    struct ErrorInfo
+    {
+        CPLErr          eErrClass = CE_None;
+        CPLErrorNum     nErrNo = CPLE_None;
+        CPLString       osMsg{};
+    };
+    std::vector<ErrorInfo> aoErrors{};
+};
+
+/************************************************************************/
+/*                       UploadPartErrorHandler()                       */
+/************************************************************************/
+
+void CPL_STDCALL VSIS3WriteHandle::UploadPartErrorHandler( CPLErr eErrClass,
+                                                          CPLErrorNum nErrNo,
+                                                          const char* pszMsg )
+{
+    PendingPart* psPart =
+        static_cast<PendingPart*>(CPLGetErrorHandlerUserData());
+    PendingPart::ErrorInfo oError;
+    oError.eErrClass = eErrClass;
+    oError.nErrNo = nErrNo;
+    oError.osMsg = pszMsg;
+    psPart->aoErrors.push_back(oError);
+}
+
+/************************************************************************/
+/*                           UploadPartJob()                            */
+/************************************************************************/
+
+void VSIS3WriteHandle::UploadPartJob( void* pData )
+{
+    PendingPart* psPart = static_cast<PendingPart*>(pData);
+    VSIS3WriteHandle* poHandle = psPart->poHandle;
+    CPLPushErrorHandlerEx(UploadPartErrorHandler, psPart);
+    CPLSetCurrentErrorHandlerCatchDebug(FALSE);
+    psPart->osEtag =
+        poHandle->m_poFS->UploadPart(poHandle->m_osFilename,
+                                     psPart->nPartNumber,
+                                     poHandle->m_osUploadID,
+                                     psPart->pabyData, psPart->nSize,
+                                     psPart->poS3HandleHelper.get(),
+                                     poHandle->m_nMaxRetry,
+                                     poHandle->m_dfRetryDelay);
+    CPLPopErrorHandler();
+    CPLAtomicInc(&(psPart->nDone));
+}
+
+/************************************************************************/
+/*                        CollectFinishedParts()                        */
+/************************************************************************/
+
+// Wait until there are at most nMaxPendingParts parts being uploaded, and
+// collect the ETag and the buffer of the finished ones.
+bool VSIS3WriteHandle::CollectFinishedParts( int nMaxPendingParts )
+{
+    if( static_cast<int>(m_apoPendingParts.size()) > nMaxPendingParts )
+        m_poUploadPool->WaitCompletion(nMaxPendingParts);
+
+    size_t j = 0;
+    for( size_t i = 0; i < m_apoPendingParts.size(); i++ )
+    {
+        auto& poPart = m_apoPendingParts[i];
+        if( CPLAtomicAdd(&(poPart->nDone), 0) == 0 )
+        {
+            if( i != j )
+                m_apoPendingParts[j] = std::move(poPart);
+            j++;
+            continue;
+        }
+        for( const auto& oError: poPart->aoErrors )
+        {
+            CPLError(oError.eErrClass, oError.nErrNo, "%s",
+                     oError.osMsg.c_str());
+        }
+        if( poPart->osEtag.empty() )
+        {
+            m_bError = true;
+        }
+        else
+        {
+            if( static_cast<int>(m_aosEtags.size()) < poPart->nPartNumber )
+                m_aosEtags.resize(poPart->nPartNumber);
+            m_aosEtags[poPart->nPartNumber - 1] = poPart->osEtag;
+        }
+        m_apabyFreeBuffers.push_back(poPart->pabyData);
+    }
+    m_apoPendingParts.resize(j);
+    return !m_bError;
+}
+
+/************************************************************************/
+/*                            SubmitPart()                              */
+/************************************************************************/
+
+// Queue the current buffer for upload by the worker threads, and get a new
+// buffer for the next part.
+bool VSIS3WriteHandle::SubmitPart()
+{
+    if( !CollectFinishedParts(m_nMaxPendingParts - 1) )
+        return false;
+
+    // Each request modifies the query parameters of the helper, so each
+    // part needs its own one.
+    std::unique_ptr<PendingPart> poPart(new PendingPart());
+    poPart->poS3HandleHelper.reset(m_poFS->CreateHandleHelper(
+        m_osFilename.c_str() + m_poFS->GetFSPrefix().size(), false));
+    if( poPart->poS3HandleHelper == nullptr )
+    {
+        m_bError = true;
+        return false;
+    }
+    m_poFS->UpdateHandleFromMap(poPart->poS3HandleHelper.get());
+
+    GByte* pabyNewBuffer = nullptr;
+    if( !m_apabyFreeBuffers.empty() )
+    {
+        pabyNewBuffer = m_apabyFreeBuffers.back();
+        m_apabyFreeBuffers.pop_back();
+    }
+    else
+    {
+        pabyNewBuffer = static_cast<GByte *>(VSIMalloc(m_nBufferSize));
+        if( pabyNewBuffer == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory,
+                     "Cannot allocate working buffer for %s",
+                     m_poFS->GetFSPrefix().c_str());
+            m_bError = true;
+            return false;
+        }
+    }
+
+    poPart->poHandle = this;
+    poPart->nPartNumber = m_nPartNumber;
+    poPart->pabyData = m_pabyBuffer;
+    poPart->nSize = m_nBufferOff;
+    if( !m_poUploadPool->SubmitJob(UploadPartJob, poPart.get()) )
+    {
+        CPLFree(pabyNewBuffer);
+        m_bError = true;
+        return false;
+    }
+    m_apoPendingParts.push_back(std::move(poPart));
+    m_pabyBuffer = pabyNewBuffer;
+    m_nBufferOff = 0;
+    return true;
+}
+
 namespace {
     struct PutData
     {
@@ -1595,12 +1814,22 @@ int VSIS3WriteHandle::Close()
         }
         else
         {
+            if( m_poUploadPool )
+            {
+                // Submit the last part, and wait for all of them to be
+                // uploaded.
+                if( !m_bError && m_nBufferOff > 0 )
+                    UploadPart();
+                CollectFinishedParts(0);
+            }
             if( m_bError )
             {
-                if( !m_poFS->AbortMultipart(m_osFilename, m_osUploadID,
-                                            m_poS3HandleHelper,
-                                            m_nMaxRetry, m_dfRetryDelay) )
-                    nRet = -1;
+                // The upload of a part has failed, possibly in a worker
+                // thread, so the file has not been written.
+                m_poFS->AbortMultipart(m_osFilename, m_osUploadID,
+                                       m_poS3HandleHelper,
+                                       m_nMaxRetry, m_dfRetryDelay);
+                nRet = -1;
             }
             else if( m_nBufferOff > 0 && !UploadPart() )
                 nRet = -1;
@@ -1719,7 +1948,13 @@ const char* VSIS3FSHandler::GetOptions()
     "  <Option name='VSIS3_CHUNK_SIZE' type='int' "
         "description='Size in MB for chunks of files that are uploaded. The"
         "default value of 50 MB allows for files up to 500 GB each' "
-        "default='50' min='5' max='1000'/>" +
+        "default='50' min='5' max='1000'/>"
+    "  <Option name='VSIS3_UPLOAD_NUM_THREADS' type='string' "
+        "description='Number of threads used to upload parts in parallel, "
+        "or ALL_CPUS' default='1'/>"
+    "  <Option name='VSIS3_UPLOAD_MAX_MEMORY' type='int' "
+        "description='Maximum size in MB of the buffers of parts being "
+        "uploaded for a file'/>" +
         VSICurlFilesystemHandler::GetOptionsStatic() +
         "</Options>");
     return osOptions.c_str();
@@ -3141,6 +3376,69 @@ static bool CopyChunk(const char* pszSource,
     return ret;
 }
 
+/************************************************************************/
+/*                        RunTasksInParallel()                          */
+/************************************************************************/
+
+// Run pfnTask(i) for each i in [0, nTasks[ with up to nThreads threads.
+// Tasks must be independent of each other. Once a task has returned false,
+// no new task is started, and false is returned.
+static bool RunTasksInParallel( int nThreads, size_t nTasks,
+                                const std::function<bool(size_t)>& pfnTask )
+{
+    struct TaskQueue
+    {
+        const std::function<bool(size_t)>& pfnTask;
+        size_t nTasks;
+        volatile int iCurIdx = 0;
+        volatile bool ret = true;
+
+        TaskQueue(const std::function<bool(size_t)>& pfnTaskIn,
+                  size_t nTasksIn):
+            pfnTask(pfnTaskIn), nTasks(nTasksIn) {}
+
+        TaskQueue(const TaskQueue&) = delete;
+        TaskQueue& operator=(const TaskQueue&) = delete;
+    };
+    const auto threadFunc = [](void* pDataIn)
+    {
+        TaskQueue* queue = static_cast<TaskQueue*>(pDataIn);
+        while( queue->ret )
+        {
+            const int idx = CPLAtomicInc(&(queue->iCurIdx)) - 1;
+            if( static_cast<size_t>(idx) >= queue->nTasks )
+                break;
+            if( !queue->pfnTask(static_cast<size_t>(idx)) )
+                queue->ret = false;
+        }
+    };
+
+    TaskQueue sTaskQueue(pfnTask, nTasks);
+    nThreads = static_cast<int>(
+        std::min(static_cast<size_t>(std::max(1, nThreads)), nTasks));
+    std::vector<CPLJoinableThread*> ahThreads;
+    if( nThreads > 1 &&
+        CPLTestBool(CPLGetConfigOption("VSIS3_SYNC_MULTITHREADING", "YES")) )
+    {
+        for( int i = 0; i < nThreads; i++ )
+        {
+            auto hThread = CPLCreateJoinableThread(threadFunc, &sTaskQueue);
+            if( !hThread )
+                break;
+            ahThreads.push_back(hThread);
+        }
+    }
+    if( ahThreads.empty() )
+    {
+        threadFunc(&sTaskQueue);
+    }
+    for( auto hThread: ahThreads )
+    {
+        CPLJoinThread(hThread);
+    }
+    return sTaskQueue.ret;
+}
+
 /************************************************************************/
 /*                               Sync()                                 */
 /************************************************************************/
@@ -3342,7 +3640,9 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
         std::vector<ChunkToCopy> aoChunksToCopy;
         std::set<CPLString> aoSetDirsToCreate;
         const char* pszChunkSize = CSLFetchNameValue(papszOptions, "CHUNK_SIZE");
-        const int nRequestedThreads = atoi(CSLFetchNameValueDef(papszOptions, "NUM_THREADS", "1"));
+        const char* pszNumThreads = CSLFetchNameValueDef(papszOptions, "NUM_THREADS", "1");
+        const int nRequestedThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+            CPLGetNumCPUs() : atoi(pszNumThreads);
         const bool bUploadToS3 = bUploadFromLocalToNetwork && STARTS_WITH(pszTarget, "/vsis3/");
         const bool bSimulateThreading = CPLTestBool(CPLGetConfigOption("VSIS3_SIMULATE_THREADING", "NO"));
         const int nMinSizeChunk = bUploadToS3 && !bSimulateThreading ? 5242880 : 1; // 5242880 defines by S3 API
@@ -3399,18 +3699,28 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
 
         // Create missing target directories, sorted in lexicographic order
         // so that upper-level directories are listed before subdirectories.
-        for( const auto& osTargetSubdir: aoSetDirsToCreate )
-        {
-            const bool ok =
-                (bTargetIsThisFS ? MkdirInternal(osTargetSubdir, false):
-                                   VSIMkdir(osTargetSubdir, 0755)) == 0;
-            if( !ok )
+        // On object storage, a directory is just a marker object that does
+        // not depend on its parents, so they can be created concurrently.
+        const std::vector<CPLString> aosDirsToCreate(aoSetDirsToCreate.begin(),
+                                                     aoSetDirsToCreate.end());
+        if( !RunTasksInParallel(bTargetIsThisFS ? nRequestedThreads : 1,
+                                aosDirsToCreate.size(),
+                                [this, &aosDirsToCreate, bTargetIsThisFS](size_t i)
             {
-                CPLError(CE_Failure, CPLE_FileIO,
-                        "Cannot create directory %s",
-                            osTargetSubdir.c_str());
-                return false;
-            }
+                const CPLString& osTargetSubdir = aosDirsToCreate[i];
+                const bool ok =
+                    (bTargetIsThisFS ? MkdirInternal(osTargetSubdir, false):
+                                       VSIMkdir(osTargetSubdir, 0755)) == 0;
+                if( !ok )
+                {
+                    CPLError(CE_Failure, CPLE_FileIO,
+                            "Cannot create directory %s",
+                                osTargetSubdir.c_str());
+                }
+                return ok;
+            }) )
+        {
+            return false;
         }
 
         // Collect source files to copy
@@ -3472,58 +3782,83 @@ bool IVSIS3LikeFSHandler::Sync( const char* pszSource, const char* pszTarget,
                                                           nMaxRetry,
                                                           dfRetryDelay);
 
+        // Determine which files already exist with the same content in the
+        // target. With the ETAG strategy this requires computing the MD5 of
+        // the local files, which is done concurrently.
+        std::vector<size_t> anIndexToCheck; // points to aoChunksToCopy
         for( size_t iChunk = 0; iChunk < nChunkCount; ++iChunk )
         {
             const auto& chunk = aoChunksToCopy[iChunk];
             if( chunk.nStartOffset != 0 )
                 continue;
+            const auto oIterExistingTarget = oMapExistingTargetFiles.find(chunk.osFilename);
+            if( oIterExistingTarget != oMapExistingTargetFiles.end() &&
+                oIterExistingTarget->second.nSize == chunk.nTotalSize &&
+                (bDownloadFromNetworkToLocal || bUploadFromLocalToNetwork) )
+            {
+                anIndexToCheck.push_back(iChunk);
+            }
+        }
+        std::vector<bool> abSkip(nChunkCount, false);
+        std::mutex oSkipMutex;
+        RunTasksInParallel(bETagStrategy ? nRequestedThreads : 1,
+                           anIndexToCheck.size(),
+                           [&](size_t i)
+        {
+            const size_t iChunk = anIndexToCheck[i];
+            const auto& chunk = aoChunksToCopy[iChunk];
             const CPLString osSubSource(
                 CPLFormFilename(osSourceWithoutSlash, chunk.osFilename, nullptr) );
             const CPLString osSubTarget(
                 CPLFormFilename(osTargetDir, chunk.osFilename, nullptr) );
-            bool bSkip = false;
             const auto oIterExistingTarget = oMapExistingTargetFiles.find(chunk.osFilename);
-            if( oIterExistingTarget != oMapExistingTargetFiles.end() &&
-                oIterExistingTarget->second.nSize == chunk.nTotalSize )
+            bool bSkip = false;
+            if( bDownloadFromNetworkToLocal )
             {
-                if( bDownloadFromNetworkToLocal )
-                {
-                    if( CanSkipDownloadFromNetworkToLocal(
-                        osSubSource,
-                        osSubTarget,
-                        chunk.nMTime,
-                        oIterExistingTarget->second.nMTime,
-                        [&chunk](const char*)
-                        {
-                            return chunk.osETag;
-                        }) )
+                bSkip = CanSkipDownloadFromNetworkToLocal(
+                    osSubSource,
+                    osSubTarget,
+                    chunk.nMTime,
+                    oIterExistingTarget->second.nMTime,
+                    [&chunk](const char*)
                     {
-                        bSkip = true;
-                    }
-                }
-                else if( bUploadFromLocalToNetwork )
-                {
-                    VSILFILE* fpIn = nullptr;
-                    if( CanSkipUploadFromLocalToNetwork(
-                        fpIn,
-                        osSubSource,
-                        osSubTarget,
-                        chunk.nMTime,
-                        oIterExistingTarget->second.nMTime,
-                        [&oIterExistingTarget](const char*)
-                        {
-                            return CPLString(CSLFetchNameValueDef(
-                                oIterExistingTarget->second.papszExtra, "ETag", ""));
-                        }) )
+                        return chunk.osETag;
+                    });
+            }
+            else
+            {
+                VSILFILE* fpIn = nullptr;
+                bSkip = CanSkipUploadFromLocalToNetwork(
+                    fpIn,
+                    osSubSource,
+                    osSubTarget,
+                    chunk.nMTime,
+                    oIterExistingTarget->second.nMTime,
+                    [&oIterExistingTarget](const char*)
                     {
-                        bSkip = true;
-                    }
-                    if( fpIn )
-                        VSIFCloseL(fpIn);
-                }
+                        return CPLString(CSLFetchNameValueDef(
+                            oIterExistingTarget->second.papszExtra, "ETag", ""));
+                    });
+                if( fpIn )
+                    VSIFCloseL(fpIn);
+            }
+            if( bSkip )
+            {
+                std::lock_guard<std::mutex> oLock(oSkipMutex);
+                abSkip[iChunk] = true;
             }
+            return true;
+        });
+
+        for( size_t iChunk = 0; iChunk < nChunkCount; ++iChunk )
+        {
+            const auto& chunk = aoChunksToCopy[iChunk];
+            if( chunk.nStartOffset != 0 )
+                continue;
+            const CPLString osSubTarget(
+                CPLFormFilename(osTargetDir, chunk.osFilename, nullptr) );
 
-            if( !bSkip )
+            if( !abSkip[iChunk] )
             {
                 anIndexToCopy.push_back(iChunk);
                 nTotalSize += chunk.nTotalSize;
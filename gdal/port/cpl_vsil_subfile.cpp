@@ -37,6 +37,7 @@
 #  include <fcntl.h>
 #endif
 #include <limits>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_multiproc.h"
@@ -70,6 +71,10 @@ class VSISubFileHandle : public VSIVirtualHandle
     size_t Write( const void *pBuffer, size_t nSize, size_t nMemb ) override;
     int Eof() override;
     int Close() override;
+    VSIMappedRegion *MapRegion( vsi_l_offset nOffset, size_t nSize ) override;
+    VSIAsyncRead *ReadMultiRangeAsync( int nRanges, void ** ppData,
+                                       const vsi_l_offset* panOffsets,
+                                       const size_t* panSizes ) override;
 };
 
 /************************************************************************/
@@ -261,6 +266,62 @@ int VSISubFileHandle::Eof()
     return bAtEOF;
 }
 
+/************************************************************************/
+/*                             MapRegion()                              */
+/************************************************************************/
+
+VSIMappedRegion *VSISubFileHandle::MapRegion( vsi_l_offset nOffset,
+                                              size_t nSize )
+{
+    if( nSubregionSize != 0 )
+    {
+        if( nOffset >= nSubregionSize )
+            return nullptr;
+        if( nSize == 0 )
+        {
+            if( nSubregionSize - nOffset >
+                static_cast<vsi_l_offset>(std::numeric_limits<size_t>::max()) )
+                return nullptr;
+            nSize = static_cast<size_t>(nSubregionSize - nOffset);
+        }
+        else if( nSize > nSubregionSize - nOffset )
+        {
+            return nullptr;
+        }
+    }
+
+    return reinterpret_cast<VSIVirtualHandle *>(fp)->MapRegion(
+        nSubregionOffset + nOffset, nSize);
+}
+
+/************************************************************************/
+/*                        ReadMultiRangeAsync()                         */
+/************************************************************************/
+
+VSIAsyncRead *VSISubFileHandle::ReadMultiRangeAsync(
+                                        int nRanges, void ** ppData,
+                                        const vsi_l_offset* panOffsets,
+                                        const size_t* panSizes )
+{
+    std::vector<vsi_l_offset> anOffsets(nRanges);
+    for( int i = 0; i < nRanges; i++ )
+    {
+        // Ranges that cross the end of the subfile are handled by the
+        // synchronous path, so that they fail the same way.
+        if( nSubregionSize != 0 &&
+            (panOffsets[i] > nSubregionSize ||
+             panSizes[i] > nSubregionSize - panOffsets[i]) )
+        {
+            return VSIVirtualHandle::ReadMultiRangeAsync(
+                                    nRanges, ppData, panOffsets, panSizes);
+        }
+        anOffsets[i] = nSubregionOffset + panOffsets[i];
+    }
+
+    return reinterpret_cast<VSIVirtualHandle *>(fp)->ReadMultiRangeAsync(
+        nRanges, ppData, anOffsets.data(), panSizes);
+}
+
 /************************************************************************/
 /* ==================================================================== */
 /*                       VSISubFileFilesystemHandler                    */
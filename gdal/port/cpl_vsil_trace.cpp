@@ -0,0 +1,865 @@
+/******************************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Implement VSI large file api for I/O tracing (/vsitrace/)
+ * Author:   GDAL project
+ *
+ ******************************************************************************
+ * Copyright (c) 2020, GDAL project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "cpl_vsi.h"
+
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <string>
+
+#include "cpl_conv.h"
+#include "cpl_json_streaming_writer.h"
+#include "cpl_multiproc.h"
+#include "cpl_string.h"
+#include "cpl_vsi_virtual.h"
+
+CPL_CVSID("$Id$")
+
+constexpr const char* TRACE_PREFIX = "/vsitrace/";
+
+// Request size histogram: bucket 0 is for sizes below 512 bytes, bucket i
+// for sizes in [512 * 2^(i-1), 512 * 2^i[, and the last one for all sizes
+// larger than 64 MB.
+constexpr int N_HISTOGRAM_BUCKETS = 19;
+
+/************************************************************************/
+/*                           VSITraceStats                              */
+/************************************************************************/
+
+namespace {
+
+struct VSITraceStats
+{
+    GUIntBig nOpens = 0;
+    GUIntBig nStats = 0;
+    GUIntBig nReads = 0;
+    GUIntBig nBytesRead = 0;
+    GUIntBig nSeeks = 0;
+    GUIntBig nReadMultiRange = 0;
+    GUIntBig nReadMultiRangeRanges = 0;
+    GUIntBig nReadMultiRangeBytes = 0;
+    GUIntBig nReadMultiRangeAsync = 0;
+    GUIntBig nReadMultiRangeAsyncRanges = 0;
+    GUIntBig nReadMultiRangeAsyncBytes = 0;
+    GUIntBig nMapRegions = 0;
+    GUIntBig nMapRegionBytes = 0;
+    GUIntBig nWrites = 0;
+    GUIntBig nBytesWritten = 0;
+    GUIntBig anRequestSizeHistogram[N_HISTOGRAM_BUCKETS] = {};
+    double   dfOpenTime = 0.0;
+    double   dfReadTime = 0.0;
+    double   dfSeekTime = 0.0;
+    double   dfWriteTime = 0.0;
+
+    void AddRequestSize( size_t nSize );
+    void Merge( const VSITraceStats& other );
+    void Serialize( CPLJSonStreamingWriter& oWriter ) const;
+};
+
+/************************************************************************/
+/*                          AddRequestSize()                            */
+/************************************************************************/
+
+void VSITraceStats::AddRequestSize( size_t nSize )
+{
+    int iBucket = 0;
+    for( size_t nMax = 512; nSize >= nMax &&
+                            iBucket < N_HISTOGRAM_BUCKETS - 1; nMax *= 2 )
+    {
+        iBucket ++;
+    }
+    anRequestSizeHistogram[iBucket] ++;
+}
+
+/************************************************************************/
+/*                               Merge()                                */
+/************************************************************************/
+
+void VSITraceStats::Merge( const VSITraceStats& other )
+{
+    nOpens += other.nOpens;
+    nStats += other.nStats;
+    nReads += other.nReads;
+    nBytesRead += other.nBytesRead;
+    nSeeks += other.nSeeks;
+    nReadMultiRange += other.nReadMultiRange;
+    nReadMultiRangeRanges += other.nReadMultiRangeRanges;
+    nReadMultiRangeBytes += other.nReadMultiRangeBytes;
+    nReadMultiRangeAsync += other.nReadMultiRangeAsync;
+    nReadMultiRangeAsyncRanges += other.nReadMultiRangeAsyncRanges;
+    nReadMultiRangeAsyncBytes += other.nReadMultiRangeAsyncBytes;
+    nMapRegions += other.nMapRegions;
+    nMapRegionBytes += other.nMapRegionBytes;
+    nWrites += other.nWrites;
+    nBytesWritten += other.nBytesWritten;
+    for( int i = 0; i < N_HISTOGRAM_BUCKETS; i++ )
+        anRequestSizeHistogram[i] += other.anRequestSizeHistogram[i];
+    dfOpenTime += other.dfOpenTime;
+    dfReadTime += other.dfReadTime;
+    dfSeekTime += other.dfSeekTime;
+    dfWriteTime += other.dfWriteTime;
+}
+
+/************************************************************************/
+/*                             Serialize()                              */
+/************************************************************************/
+
+void VSITraceStats::Serialize( CPLJSonStreamingWriter& oWriter ) const
+{
+    auto oObj = oWriter.MakeObjectContext();
+    oWriter.AddObjKey("opens");
+    oWriter.Add(static_cast<GUInt64>(nOpens));
+    oWriter.AddObjKey("stats");
+    oWriter.Add(static_cast<GUInt64>(nStats));
+    oWriter.AddObjKey("reads");
+    oWriter.Add(static_cast<GUInt64>(nReads));
+    oWriter.AddObjKey("bytes_read");
+    oWriter.Add(static_cast<GUInt64>(nBytesRead));
+    oWriter.AddObjKey("seeks");
+    oWriter.Add(static_cast<GUInt64>(nSeeks));
+    oWriter.AddObjKey("read_multi_range");
+    {
+        auto oSubObj = oWriter.MakeObjectContext();
+        oWriter.AddObjKey("calls");
+        oWriter.Add(static_cast<GUInt64>(nReadMultiRange));
+        oWriter.AddObjKey("ranges");
+        oWriter.Add(static_cast<GUInt64>(nReadMultiRangeRanges));
+        oWriter.AddObjKey("bytes");
+        oWriter.Add(static_cast<GUInt64>(nReadMultiRangeBytes));
+    }
+    oWriter.AddObjKey("read_multi_range_async");
+    {
+        auto oSubObj = oWriter.MakeObjectContext();
+        oWriter.AddObjKey("calls");
+        oWriter.Add(static_cast<GUInt64>(nReadMultiRangeAsync));
+        oWriter.AddObjKey("ranges");
+        oWriter.Add(static_cast<GUInt64>(nReadMultiRangeAsyncRanges));
+        oWriter.AddObjKey("bytes");
+        oWriter.Add(static_cast<GUInt64>(nReadMultiRangeAsyncBytes));
+    }
+    oWriter.AddObjKey("map_regions");
+    {
+        auto oSubObj = oWriter.MakeObjectContext();
+        oWriter.AddObjKey("calls");
+        oWriter.Add(static_cast<GUInt64>(nMapRegions));
+        oWriter.AddObjKey("bytes");
+        oWriter.Add(static_cast<GUInt64>(nMapRegionBytes));
+    }
+    oWriter.AddObjKey("writes");
+    oWriter.Add(static_cast<GUInt64>(nWrites));
+    oWriter.AddObjKey("bytes_written");
+    oWriter.Add(static_cast<GUInt64>(nBytesWritten));
+    oWriter.AddObjKey("request_size_histogram");
+    {
+        auto oSubObj = oWriter.MakeObjectContext();
+        for( int i = 0; i < N_HISTOGRAM_BUCKETS; i++ )
+        {
+            if( anRequestSizeHistogram[i] == 0 )
+                continue;
+            const GUIntBig nMin = i == 0 ? 0 :
+                static_cast<GUIntBig>(512) << (i - 1);
+            if( i == N_HISTOGRAM_BUCKETS - 1 )
+                oWriter.AddObjKey(CPLSPrintf(CPL_FRMT_GUIB "-", nMin));
+            else
+                oWriter.AddObjKey(CPLSPrintf(CPL_FRMT_GUIB "-" CPL_FRMT_GUIB,
+                    nMin, (static_cast<GUIntBig>(512) << i) - 1));
+            oWriter.Add(static_cast<GUInt64>(anRequestSizeHistogram[i]));
+        }
+    }
+    oWriter.AddObjKey("open_time_s");
+    oWriter.Add(dfOpenTime, 6);
+    oWriter.AddObjKey("read_time_s");
+    oWriter.Add(dfReadTime, 6);
+    oWriter.AddObjKey("seek_time_s");
+    oWriter.Add(dfSeekTime, 6);
+    oWriter.AddObjKey("write_time_s");
+    oWriter.Add(dfWriteTime, 6);
+}
+
+/************************************************************************/
+/*                             VSITraceTimer                            */
+/************************************************************************/
+
+// Accumulate the time elapsed during its lifetime into a counter.
+class VSITraceTimer
+{
+    double& m_dfAccumulator;
+    std::chrono::steady_clock::time_point m_oStart;
+
+    CPL_DISALLOW_COPY_ASSIGN(VSITraceTimer)
+
+  public:
+    explicit VSITraceTimer( double& dfAccumulator ):
+        m_dfAccumulator(dfAccumulator),
+        m_oStart(std::chrono::steady_clock::now()) {}
+
+    ~VSITraceTimer()
+    {
+        m_dfAccumulator += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - m_oStart).count();
+    }
+};
+
+} // namespace
+
+/************************************************************************/
+/* ==================================================================== */
+/*                       VSITraceFilesystemHandler                      */
+/* ==================================================================== */
+/************************************************************************/
+
+class VSITraceFilesystemHandler final : public VSIFilesystemHandler
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSITraceFilesystemHandler)
+
+    CPLMutex* m_hMutex = nullptr;
+    // Statistics of closed handles and of Stat() calls, per underlying
+    // filename.
+    std::map<std::string, VSITraceStats> m_oMapStats{};
+
+  public:
+    VSITraceFilesystemHandler() = default;
+    ~VSITraceFilesystemHandler() override;
+
+    static const char* GetUnderlyingFilename( const char* pszFilename );
+
+    void MergeStats( const std::string& osFilename,
+                     const VSITraceStats& oStats );
+    char* GetStatistics( const char* pszFilename );
+    void ResetStatistics();
+
+    VSIVirtualHandle *Open( const char *pszFilename,
+                            const char *pszAccess,
+                            bool bSetError ) override;
+    int Stat( const char *pszFilename, VSIStatBufL *pStatBuf,
+              int nFlags ) override;
+    int Unlink( const char *pszFilename ) override;
+    int Mkdir( const char *pszDirname, long nMode ) override;
+    int Rmdir( const char *pszDirname ) override;
+    char **ReadDirEx( const char *pszDirname, int nMaxFiles ) override;
+    int Rename( const char *oldpath, const char *newpath ) override;
+    int IsCaseSensitive( const char* pszFilename ) override;
+    int HasOptimizedReadMultiRange( const char* pszPath ) override;
+    const char* GetActualURL( const char* pszFilename ) override;
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                            VSITraceHandle                            */
+/* ==================================================================== */
+/************************************************************************/
+
+class VSITraceHandle final : public VSIVirtualHandle
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSITraceHandle)
+
+    VSITraceFilesystemHandler* m_poFS = nullptr;
+    std::string       m_osFilename;
+    VSIVirtualHandle* m_poBaseHandle = nullptr;
+    vsi_l_offset      m_nCurOffset = 0;
+    VSITraceStats     m_oStats{};
+
+    void              DumpStats();
+
+  public:
+    VSITraceHandle( VSITraceFilesystemHandler* poFS,
+                    const std::string& osFilename,
+                    VSIVirtualHandle* poBaseHandle,
+                    double dfOpenTime );
+    ~VSITraceHandle() override;
+
+    int Seek( vsi_l_offset nOffset, int nWhence ) override;
+    vsi_l_offset Tell() override;
+    size_t Read( void *pBuffer, size_t nSize, size_t nMemb ) override;
+    int ReadMultiRange( int nRanges, void ** ppData,
+                        const vsi_l_offset* panOffsets,
+                        const size_t* panSizes ) override;
+    size_t Write( const void *pBuffer, size_t nSize, size_t nMemb ) override;
+    int Eof() override;
+    int Flush() override;
+    int Close() override;
+    int Truncate( vsi_l_offset nNewSize ) override;
+    void *GetNativeFileDescriptor() override;
+    VSIMappedRegion *MapRegion( vsi_l_offset nOffset, size_t nSize ) override;
+    VSIAsyncRead *ReadMultiRangeAsync( int nRanges, void ** ppData,
+                                       const vsi_l_offset* panOffsets,
+                                       const size_t* panSizes ) override;
+    VSIRangeStatus GetRangeStatus( vsi_l_offset nOffset,
+                                   vsi_l_offset nLength ) override;
+};
+
+/************************************************************************/
+/*                          VSITraceHandle()                            */
+/************************************************************************/
+
+VSITraceHandle::VSITraceHandle( VSITraceFilesystemHandler* poFS,
+                                const std::string& osFilename,
+                                VSIVirtualHandle* poBaseHandle,
+                                double dfOpenTime ) :
+    m_poFS(poFS),
+    m_osFilename(osFilename),
+    m_poBaseHandle(poBaseHandle)
+{
+    m_oStats.nOpens = 1;
+    m_oStats.dfOpenTime = dfOpenTime;
+}
+
+/************************************************************************/
+/*                         ~VSITraceHandle()                            */
+/************************************************************************/
+
+VSITraceHandle::~VSITraceHandle()
+{
+    Close();
+}
+
+/************************************************************************/
+/*                              Seek()                                  */
+/************************************************************************/
+
+int VSITraceHandle::Seek( vsi_l_offset nOffset, int nWhence )
+{
+    VSITraceTimer oTimer(m_oStats.dfSeekTime);
+    const int nRet = m_poBaseHandle->Seek(nOffset, nWhence);
+    const vsi_l_offset nNewOffset =
+        nWhence == SEEK_SET && nRet == 0 ? nOffset : m_poBaseHandle->Tell();
+    // Only count seeks that actually change the position.
+    if( nNewOffset != m_nCurOffset )
+    {
+        m_oStats.nSeeks ++;
+        m_nCurOffset = nNewOffset;
+    }
+    return nRet;
+}
+
+/************************************************************************/
+/*                              Tell()                                  */
+/************************************************************************/
+
+vsi_l_offset VSITraceHandle::Tell()
+{
+    return m_poBaseHandle->Tell();
+}
+
+/************************************************************************/
+/*                              Read()                                  */
+/************************************************************************/
+
+size_t VSITraceHandle::Read( void *pBuffer, size_t nSize, size_t nMemb )
+{
+    size_t nRet;
+    {
+        VSITraceTimer oTimer(m_oStats.dfReadTime);
+        nRet = m_poBaseHandle->Read(pBuffer, nSize, nMemb);
+    }
+    m_oStats.nReads ++;
+    m_oStats.nBytesRead += static_cast<GUIntBig>(nRet) * nSize;
+    m_oStats.AddRequestSize(nSize * nMemb);
+    m_nCurOffset += static_cast<vsi_l_offset>(nRet) * nSize;
+    return nRet;
+}
+
+/************************************************************************/
+/*                         ReadMultiRange()                             */
+/************************************************************************/
+
+int VSITraceHandle::ReadMultiRange( int nRanges, void ** ppData,
+                                    const vsi_l_offset* panOffsets,
+                                    const size_t* panSizes )
+{
+    int nRet;
+    {
+        VSITraceTimer oTimer(m_oStats.dfReadTime);
+        nRet = m_poBaseHandle->ReadMultiRange(nRanges, ppData,
+                                              panOffsets, panSizes);
+    }
+    m_oStats.nReadMultiRange ++;
+    m_oStats.nReadMultiRangeRanges += nRanges;
+    for( int i = 0; i < nRanges; i++ )
+    {
+        m_oStats.nReadMultiRangeBytes += panSizes[i];
+        m_oStats.AddRequestSize(panSizes[i]);
+    }
+    m_nCurOffset = m_poBaseHandle->Tell();
+    return nRet;
+}
+
+/************************************************************************/
+/*                       ReadMultiRangeAsync()                          */
+/************************************************************************/
+
+VSIAsyncRead *VSITraceHandle::ReadMultiRangeAsync(
+                                            int nRanges, void ** ppData,
+                                            const vsi_l_offset* panOffsets,
+                                            const size_t* panSizes )
+{
+    // Only the submission time is accounted, as the request may complete
+    // while the caller does something else.
+    VSIAsyncRead* poRet;
+    {
+        VSITraceTimer oTimer(m_oStats.dfReadTime);
+        poRet = m_poBaseHandle->ReadMultiRangeAsync(nRanges, ppData,
+                                                    panOffsets, panSizes);
+    }
+    m_oStats.nReadMultiRangeAsync ++;
+    m_oStats.nReadMultiRangeAsyncRanges += nRanges;
+    for( int i = 0; i < nRanges; i++ )
+    {
+        m_oStats.nReadMultiRangeAsyncBytes += panSizes[i];
+        m_oStats.AddRequestSize(panSizes[i]);
+    }
+    return poRet;
+}
+
+/************************************************************************/
+/*                            MapRegion()                               */
+/************************************************************************/
+
+VSIMappedRegion *VSITraceHandle::MapRegion( vsi_l_offset nOffset,
+                                            size_t nSize )
+{
+    VSIMappedRegion* poRet;
+    {
+        VSITraceTimer oTimer(m_oStats.dfReadTime);
+        poRet = m_poBaseHandle->MapRegion(nOffset, nSize);
+    }
+    m_oStats.nMapRegions ++;
+    m_oStats.nMapRegionBytes += nSize;
+    m_oStats.AddRequestSize(nSize);
+    return poRet;
+}
+
+/************************************************************************/
+/*                              Write()                                 */
+/************************************************************************/
+
+size_t VSITraceHandle::Write( const void *pBuffer, size_t nSize,
+                              size_t nMemb )
+{
+    size_t nRet;
+    {
+        VSITraceTimer oTimer(m_oStats.dfWriteTime);
+        nRet = m_poBaseHandle->Write(pBuffer, nSize, nMemb);
+    }
+    m_oStats.nWrites ++;
+    m_oStats.nBytesWritten += static_cast<GUIntBig>(nRet) * nSize;
+    m_nCurOffset += static_cast<vsi_l_offset>(nRet) * nSize;
+    return nRet;
+}
+
+/************************************************************************/
+/*                               Eof()                                  */
+/************************************************************************/
+
+int VSITraceHandle::Eof()
+{
+    return m_poBaseHandle->Eof();
+}
+
+/************************************************************************/
+/*                              Flush()                                 */
+/************************************************************************/
+
+int VSITraceHandle::Flush()
+{
+    VSITraceTimer oTimer(m_oStats.dfWriteTime);
+    return m_poBaseHandle->Flush();
+}
+
+/************************************************************************/
+/*                            Truncate()                                */
+/************************************************************************/
+
+int VSITraceHandle::Truncate( vsi_l_offset nNewSize )
+{
+    VSITraceTimer oTimer(m_oStats.dfWriteTime);
+    return m_poBaseHandle->Truncate(nNewSize);
+}
+
+/************************************************************************/
+/*                      GetNativeFileDescriptor()                       */
+/************************************************************************/
+
+void *VSITraceHandle::GetNativeFileDescriptor()
+{
+    return m_poBaseHandle->GetNativeFileDescriptor();
+}
+
+/************************************************************************/
+/*                          GetRangeStatus()                            */
+/************************************************************************/
+
+VSIRangeStatus VSITraceHandle::GetRangeStatus( vsi_l_offset nOffset,
+                                               vsi_l_offset nLength )
+{
+    return m_poBaseHandle->GetRangeStatus(nOffset, nLength);
+}
+
+/************************************************************************/
+/*                             DumpStats()                              */
+/************************************************************************/
+
+void VSITraceHandle::DumpStats()
+{
+    CPLJSonStreamingWriter oWriter(nullptr, nullptr);
+    oWriter.SetPrettyFormatting(false);
+    {
+        auto oObj = oWriter.MakeObjectContext();
+        oWriter.AddObjKey("filename");
+        oWriter.Add(m_osFilename);
+        oWriter.AddObjKey("statistics");
+        m_oStats.Serialize(oWriter);
+    }
+
+    CPLDebug("VSITRACE", "%s", oWriter.GetString().c_str());
+
+    const char* pszOutput = CPLGetConfigOption("CPL_VSIL_TRACE_OUTPUT", nullptr);
+    if( pszOutput == nullptr || pszOutput[0] == '\0' )
+        return;
+    // Append one JSON object per line. Do not go through VSI, to avoid
+    // recursing into ourselves if the output is itself traced.
+    FILE* fp = EQUAL(pszOutput, "stderr") ? stderr :
+               EQUAL(pszOutput, "stdout") ? stdout :
+               fopen(pszOutput, "ab");
+    if( fp == nullptr )
+    {
+        CPLError(CE_Warning, CPLE_FileIO, "Cannot open %s", pszOutput);
+        return;
+    }
+    fprintf(fp, "%s\n", oWriter.GetString().c_str());
+    if( fp == stderr || fp == stdout )
+        fflush(fp);
+    else
+        fclose(fp);
+}
+
+/************************************************************************/
+/*                              Close()                                 */
+/************************************************************************/
+
+int VSITraceHandle::Close()
+{
+    if( m_poBaseHandle == nullptr )
+        return 0;
+
+    int nRet;
+    {
+        // Closing may flush pending writes.
+        VSITraceTimer oTimer(m_oStats.dfWriteTime);
+        nRet = m_poBaseHandle->Close();
+        delete m_poBaseHandle;
+        m_poBaseHandle = nullptr;
+    }
+
+    DumpStats();
+    m_poFS->MergeStats(m_osFilename, m_oStats);
+
+    return nRet;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                       VSITraceFilesystemHandler                      */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                      ~VSITraceFilesystemHandler()                    */
+/************************************************************************/
+
+VSITraceFilesystemHandler::~VSITraceFilesystemHandler()
+{
+    if( m_hMutex != nullptr )
+        CPLDestroyMutex(m_hMutex);
+}
+
+/************************************************************************/
+/*                       GetUnderlyingFilename()                        */
+/************************************************************************/
+
+const char* VSITraceFilesystemHandler::GetUnderlyingFilename(
+                                                    const char* pszFilename )
+{
+    if( STARTS_WITH(pszFilename, TRACE_PREFIX) )
+        return pszFilename + strlen(TRACE_PREFIX);
+    return pszFilename;
+}
+
+/************************************************************************/
+/*                             MergeStats()                             */
+/************************************************************************/
+
+void VSITraceFilesystemHandler::MergeStats( const std::string& osFilename,
+                                            const VSITraceStats& oStats )
+{
+    CPLMutexHolder oHolder(&m_hMutex);
+    m_oMapStats[osFilename].Merge(oStats);
+}
+
+/************************************************************************/
+/*                           GetStatistics()                            */
+/************************************************************************/
+
+char* VSITraceFilesystemHandler::GetStatistics( const char* pszFilename )
+{
+    CPLJSonStreamingWriter oWriter(nullptr, nullptr);
+    {
+        CPLMutexHolder oHolder(&m_hMutex);
+        if( pszFilename != nullptr )
+        {
+            const auto oIter =
+                m_oMapStats.find(GetUnderlyingFilename(pszFilename));
+            if( oIter == m_oMapStats.end() )
+                return nullptr;
+            oIter->second.Serialize(oWriter);
+        }
+        else
+        {
+            auto oObj = oWriter.MakeObjectContext();
+            for( const auto& oIter: m_oMapStats )
+            {
+                oWriter.AddObjKey(oIter.first);
+                oIter.second.Serialize(oWriter);
+            }
+        }
+    }
+    return CPLStrdup(oWriter.GetString().c_str());
+}
+
+/************************************************************************/
+/*                          ResetStatistics()                           */
+/************************************************************************/
+
+void VSITraceFilesystemHandler::ResetStatistics()
+{
+    CPLMutexHolder oHolder(&m_hMutex);
+    m_oMapStats.clear();
+}
+
+/************************************************************************/
+/*                                Open()                                */
+/************************************************************************/
+
+VSIVirtualHandle* VSITraceFilesystemHandler::Open( const char *pszFilename,
+                                                   const char *pszAccess,
+                                                   bool bSetError )
+{
+    if( !STARTS_WITH_CI(pszFilename, TRACE_PREFIX) )
+        return nullptr;
+
+    const std::string osFilename(GetUnderlyingFilename(pszFilename));
+    VSIFilesystemHandler* poFSHandler =
+        VSIFileManager::GetHandler(osFilename.c_str());
+
+    double dfOpenTime = 0.0;
+    VSIVirtualHandle* poBaseHandle;
+    {
+        VSITraceTimer oTimer(dfOpenTime);
+        poBaseHandle =
+            poFSHandler->Open(osFilename.c_str(), pszAccess, bSetError);
+    }
+    if( poBaseHandle == nullptr )
+        return nullptr;
+
+    return new VSITraceHandle(this, osFilename, poBaseHandle, dfOpenTime);
+}
+
+/************************************************************************/
+/*                                Stat()                                */
+/************************************************************************/
+
+int VSITraceFilesystemHandler::Stat( const char *pszFilename,
+                                     VSIStatBufL *pStatBuf,
+                                     int nFlags )
+{
+    if( !STARTS_WITH_CI(pszFilename, TRACE_PREFIX) )
+        return -1;
+
+    const std::string osFilename(GetUnderlyingFilename(pszFilename));
+    VSITraceStats oStats;
+    oStats.nStats = 1;
+    int nRet;
+    {
+        VSITraceTimer oTimer(oStats.dfOpenTime);
+        nRet = VSIStatExL(osFilename.c_str(), pStatBuf, nFlags);
+    }
+    MergeStats(osFilename, oStats);
+    return nRet;
+}
+
+/************************************************************************/
+/*                               Unlink()                               */
+/************************************************************************/
+
+int VSITraceFilesystemHandler::Unlink( const char *pszFilename )
+{
+    return VSIUnlink(GetUnderlyingFilename(pszFilename));
+}
+
+/************************************************************************/
+/*                               Mkdir()                                */
+/************************************************************************/
+
+int VSITraceFilesystemHandler::Mkdir( const char *pszDirname, long nMode )
+{
+    return VSIMkdir(GetUnderlyingFilename(pszDirname), nMode);
+}
+
+/************************************************************************/
+/*                               Rmdir()                                */
+/************************************************************************/
+
+int VSITraceFilesystemHandler::Rmdir( const char *pszDirname )
+{
+    return VSIRmdir(GetUnderlyingFilename(pszDirname));
+}
+
+/************************************************************************/
+/*                             ReadDirEx()                              */
+/************************************************************************/
+
+char** VSITraceFilesystemHandler::ReadDirEx( const char *pszDirname,
+                                             int nMaxFiles )
+{
+    return VSIReadDirEx(GetUnderlyingFilename(pszDirname), nMaxFiles);
+}
+
+/************************************************************************/
+/*                               Rename()                               */
+/************************************************************************/
+
+int VSITraceFilesystemHandler::Rename( const char *oldpath,
+                                       const char *newpath )
+{
+    return VSIRename(GetUnderlyingFilename(oldpath),
+                     GetUnderlyingFilename(newpath));
+}
+
+/************************************************************************/
+/*                          IsCaseSensitive()                           */
+/************************************************************************/
+
+int VSITraceFilesystemHandler::IsCaseSensitive( const char* pszFilename )
+{
+    const char* pszUnderlyingFilename = GetUnderlyingFilename(pszFilename);
+    return VSIFileManager::GetHandler(pszUnderlyingFilename)->
+                                    IsCaseSensitive(pszUnderlyingFilename);
+}
+
+/************************************************************************/
+/*                     HasOptimizedReadMultiRange()                     */
+/************************************************************************/
+
+int VSITraceFilesystemHandler::HasOptimizedReadMultiRange(
+                                                    const char* pszPath )
+{
+    return VSIHasOptimizedReadMultiRange(GetUnderlyingFilename(pszPath));
+}
+
+/************************************************************************/
+/*                           GetActualURL()                             */
+/************************************************************************/
+
+const char* VSITraceFilesystemHandler::GetActualURL(
+                                                const char* pszFilename )
+{
+    return VSIGetActualURL(GetUnderlyingFilename(pszFilename));
+}
+
+/************************************************************************/
+/*                        VSITraceGetStatistics()                       */
+/************************************************************************/
+
+/**
+ * \brief Return the I/O statistics collected by /vsitrace/
+ *
+ * Statistics are accumulated per underlying filename (that is to say without
+ * the /vsitrace/ prefix), over all the handles that have been closed, and all
+ * the VSIStatL() calls. They contain the number of opens, stats, reads,
+ * bytes read, seeks changing the position, ReadMultiRange() and
+ * asynchronous ReadMultiRange() calls, mapped regions, writes, bytes written,
+ * an histogram of request sizes, and the time spent in those operations.
+ *
+ * @param pszFilename Filename, with or without the /vsitrace/ prefix, or
+ *                    NULL to get the statistics of all files, as a JSON
+ *                    object whose keys are the filenames.
+ * @return a JSON string to free with CPLFree(), or NULL if there are no
+ *         statistics for the file.
+ * @since GDAL 3.1
+ */
+
+char* VSITraceGetStatistics( const char* pszFilename )
+{
+    auto poFSHandler = dynamic_cast<VSITraceFilesystemHandler*>(
+                            VSIFileManager::GetHandler(TRACE_PREFIX));
+    if( poFSHandler == nullptr )
+        return nullptr;
+    return poFSHandler->GetStatistics(pszFilename);
+}
+
+/************************************************************************/
+/*                       VSITraceResetStatistics()                      */
+/************************************************************************/
+
+/**
+ * \brief Reset the I/O statistics collected by /vsitrace/
+ *
+ * @since GDAL 3.1
+ */
+
+void VSITraceResetStatistics()
+{
+    auto poFSHandler = dynamic_cast<VSITraceFilesystemHandler*>(
+                            VSIFileManager::GetHandler(TRACE_PREFIX));
+    if( poFSHandler != nullptr )
+        poFSHandler->ResetStatistics();
+}
+
+/************************************************************************/
+/*                     VSIInstallTraceFileHandler()                     */
+/************************************************************************/
+
+/**
+ * \brief Install /vsitrace/ file system handler
+ *
+ * A special file handler is installed that records statistics about the
+ * I/O operations done on the files prefixed with /vsitrace/, and forwards
+ * them to the underlying file system.
+ *
+ * @see <a href="gdal_virtual_file_systems.html#gdal_virtual_file_systems_vsitrace">/vsitrace/ documentation</a>
+ *
+ * @since GDAL 3.1
+ */
+
+void VSIInstallTraceFileHandler()
+{
+    VSIFileManager::InstallHandler( TRACE_PREFIX,
+                                    new VSITraceFilesystemHandler );
+}
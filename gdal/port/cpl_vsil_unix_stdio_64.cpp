@@ -78,7 +78,10 @@
 #include <unistd.h>
 #endif
 
+#include <limits>
 #include <new>
+#include <string>
+#include <vector>
 
 #include "cpl_config.h"
 #include "cpl_conv.h"
@@ -214,6 +217,9 @@ class VSIUnixStdioHandle final : public VSIVirtualHandle
         return reinterpret_cast<void *>(static_cast<size_t>(fileno(fp))); }
     VSIRangeStatus GetRangeStatus( vsi_l_offset nOffset,
                                    vsi_l_offset nLength ) override;
+    VSIAsyncRead *ReadMultiRangeAsync( int nRanges, void ** ppData,
+                                       const vsi_l_offset* panOffsets,
+                                       const size_t* panSizes ) override;
 };
 
 /************************************************************************/
@@ -506,6 +512,66 @@ int VSIUnixStdioHandle::Truncate( vsi_l_offset nNewSize )
     return VSI_FTRUNCATE64( fileno(fp), nNewSize );
 }
 
+/************************************************************************/
+/*                        ReadMultiRangeAsync()                         */
+/************************************************************************/
+
+VSIAsyncRead *VSIUnixStdioHandle::ReadMultiRangeAsync(
+                                        int nRanges, void ** ppData,
+                                        const vsi_l_offset* panOffsets,
+                                        const size_t* panSizes )
+{
+    // Pending writes must reach the file descriptor before pread().
+    if( bLastOpWrite )
+    {
+        fflush(fp);
+        bLastOpWrite = false;
+    }
+
+    std::vector<VSIAsyncReadJob> aoJobs;
+    const int fd = fileno(fp);
+    for( int i = 0; i < nRanges; i++ )
+    {
+        if( panSizes[i] == 0 )
+            continue;
+        if( panOffsets[i] > static_cast<vsi_l_offset>(
+                std::numeric_limits<off_t>::max()) - panSizes[i] )
+        {
+            return VSIVirtualHandle::ReadMultiRangeAsync(
+                                    nRanges, ppData, panOffsets, panSizes);
+        }
+        GByte* pabyData = static_cast<GByte*>(ppData[i]);
+        const vsi_l_offset nOffset = panOffsets[i];
+        const size_t nSize = panSizes[i];
+        aoJobs.emplace_back([fd, pabyData, nOffset, nSize](std::string& osErr)
+        {
+            size_t nRead = 0;
+            while( nRead < nSize )
+            {
+                const ssize_t nRet = pread(fd, pabyData + nRead, nSize - nRead,
+                                           static_cast<off_t>(nOffset + nRead));
+                if( nRet < 0 && errno == EINTR )
+                    continue;
+                if( nRet <= 0 )
+                {
+                    osErr = CPLSPrintf("Cannot read " CPL_FRMT_GUIB
+                                       " bytes at offset " CPL_FRMT_GUIB,
+                                       static_cast<GUIntBig>(nSize),
+                                       static_cast<GUIntBig>(nOffset));
+                    return false;
+                }
+                nRead += static_cast<size_t>(nRet);
+            }
+            return true;
+        });
+    }
+#ifdef VSI_COUNT_BYTES_READ
+    for( int i = 0; i < nRanges; i++ )
+        nTotalBytesRead += panSizes[i];
+#endif
+    return VSICreateAsyncReadFromJobs(std::move(aoJobs));
+}
+
 /************************************************************************/
 /*                          GetRangeStatus()                            */
 /************************************************************************/
@@ -1194,6 +1194,17 @@ public:
     return OGR_L_Erase( self, method_layer, result_layer, options, callback, callback_data );
   }
 
+#ifndef SWIGJAVA
+  %feature( "kwargs" ) SpatialJoin;
+#endif
+  OGRErr SpatialJoin( OGRLayerShadow *method_layer,
+                      OGRLayerShadow *result_layer,
+                      char **options=NULL,
+                      GDALProgressFunc callback=NULL,
+                      void* callback_data=NULL ) {
+    return OGR_L_SpatialJoin( self, method_layer, result_layer, options, callback, callback_data );
+  }
+
   OGRStyleTableShadow *GetStyleTable() {
     return (OGRStyleTableShadow*) OGR_L_GetStyleTable(self);
   }
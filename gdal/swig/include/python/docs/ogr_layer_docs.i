@@ -1618,4 +1618,74 @@ The first geometry field is always used.
 
 OGR 1.10 ";
 
+%feature("docstring")  SpatialJoin "OGRErr OGR_L_SpatialJoin(OGRLayerH
+pLayerInput, OGRLayerH pLayerMethod, OGRLayerH pLayerResult, char
+**papszOptions, GDALProgressFunc pfnProgress, void *pProgressArg)
+
+Spatial join of two layers.
+
+The result layer contains, for each pair made of a feature of the
+input layer and a feature of the method layer whose geometries satisfy
+the spatial predicate, a feature with the geometry of the input feature
+and the attributes of both features. The schema of the result layer can
+be set by the user or, if it is empty, is initialized to contain all
+fields in the input and method layers.
+
+For best performance use the smallest layer as the method layer.
+
+This method relies on GEOS support. Do not use unless the GEOS support
+is compiled in.  The recognized list of options is :
+SKIP_FAILURES=YES/NO. Set it to YES to go on, even when a feature
+could not be inserted or a GEOS call failed.
+
+PROMOTE_TO_MULTI=YES/NO. Set it to YES to convert Polygons into
+MultiPolygons, or LineStrings to MultiLineStrings.
+
+INPUT_PREFIX=string. Set a prefix for the field names that will be
+created from the fields of the input layer.
+
+METHOD_PREFIX=string. Set a prefix for the field names that will be
+created from the fields of the method layer.
+
+USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+geometries for the features of the method layer.
+
+PREDICATE=INTERSECTS/WITHIN. Spatial relationship that features of the
+input layer must have with features of the method layer. Defaults to
+INTERSECTS.
+
+KEEP_UNMATCHED=YES/NO. Set to YES to also add the features of the input
+layer that match no feature of the method layer. Defaults to NO.
+
+NUM_THREADS=number/ALL_CPUS. Number of threads used to evaluate the
+predicates. Defaults to the GDAL_NUM_THREADS configuration option, or
+ALL_CPUS.
+
+This function is the same as the C++ method OGRLayer::SpatialJoin().
+
+Parameters:
+-----------
+
+pLayerInput:  the input layer. Should not be NULL.
+
+pLayerMethod:  the method layer. Should not be NULL.
+
+pLayerResult:  the layer where the features resulting from the
+operation are inserted. Should not be NULL. See above the note about
+the schema.
+
+papszOptions:  NULL terminated list of options (may be NULL).
+
+pfnProgress:  a GDALProgressFunc() compatible callback function for
+reporting progress or NULL.
+
+pProgressArg:  argument to be passed to pfnProgress. May be NULL.
+
+an error code if there was an error or the execution was interrupted,
+OGRERR_NONE otherwise.
+
+The first geometry field is always used.
+
+GDAL 3.1 ";
+
 }
\ No newline at end of file
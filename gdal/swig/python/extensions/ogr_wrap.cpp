@@ -4254,6 +4254,9 @@ SWIGINTERN OGRErr OGRLayerShadow_Clip(OGRLayerShadow *self,OGRLayerShadow *metho
 SWIGINTERN OGRErr OGRLayerShadow_Erase(OGRLayerShadow *self,OGRLayerShadow *method_layer,OGRLayerShadow *result_layer,char **options=NULL,GDALProgressFunc callback=NULL,void *callback_data=NULL){
     return OGR_L_Erase( self, method_layer, result_layer, options, callback, callback_data );
   }
+SWIGINTERN OGRErr OGRLayerShadow_SpatialJoin(OGRLayerShadow *self,OGRLayerShadow *method_layer,OGRLayerShadow *result_layer,char **options=NULL,GDALProgressFunc callback=NULL,void *callback_data=NULL){
+    return OGR_L_SpatialJoin( self, method_layer, result_layer, options, callback, callback_data );
+  }
 SWIGINTERN OGRStyleTableShadow *OGRLayerShadow_GetStyleTable(OGRLayerShadow *self){
     return (OGRStyleTableShadow*) OGR_L_GetStyleTable(self);
   }
@@ -11980,6 +11983,171 @@ fail:
 }
 
 
+SWIGINTERN PyObject *_wrap_Layer_SpatialJoin(PyObject *SWIGUNUSEDPARM(self), PyObject *args, PyObject *kwargs) {
+  PyObject *resultobj = 0; int bLocalUseExceptionsCode = bUseExceptions;
+  OGRLayerShadow *arg1 = (OGRLayerShadow *) 0 ;
+  OGRLayerShadow *arg2 = (OGRLayerShadow *) 0 ;
+  OGRLayerShadow *arg3 = (OGRLayerShadow *) 0 ;
+  char **arg4 = (char **) NULL ;
+  GDALProgressFunc arg5 = (GDALProgressFunc) NULL ;
+  void *arg6 = (void *) NULL ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  void *argp2 = 0 ;
+  int res2 = 0 ;
+  void *argp3 = 0 ;
+  int res3 = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  PyObject * obj4 = 0 ;
+  PyObject * obj5 = 0 ;
+  char *  kwnames[] = {
+    (char *) "self",(char *) "method_layer",(char *) "result_layer",(char *) "options",(char *) "callback",(char *) "callback_data", NULL 
+  };
+  OGRErr result;
+  
+  /* %typemap(arginit) ( const char* callback_data=NULL)  */
+  PyProgressData *psProgressInfo;
+  psProgressInfo = (PyProgressData *) CPLCalloc(1,sizeof(PyProgressData));
+  psProgressInfo->nLastReported = -1;
+  psProgressInfo->psPyCallback = NULL;
+  psProgressInfo->psPyCallbackData = NULL;
+  arg6 = psProgressInfo;
+  if (!PyArg_ParseTupleAndKeywords(args,kwargs,(char *)"OOO|OOO:Layer_SpatialJoin",kwnames,&obj0,&obj1,&obj2,&obj3,&obj4,&obj5)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_OGRLayerShadow, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "Layer_SpatialJoin" "', argument " "1"" of type '" "OGRLayerShadow *""'"); 
+  }
+  arg1 = reinterpret_cast< OGRLayerShadow * >(argp1);
+  res2 = SWIG_ConvertPtr(obj1, &argp2,SWIGTYPE_p_OGRLayerShadow, 0 |  0 );
+  if (!SWIG_IsOK(res2)) {
+    SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "Layer_SpatialJoin" "', argument " "2"" of type '" "OGRLayerShadow *""'"); 
+  }
+  arg2 = reinterpret_cast< OGRLayerShadow * >(argp2);
+  res3 = SWIG_ConvertPtr(obj2, &argp3,SWIGTYPE_p_OGRLayerShadow, 0 |  0 );
+  if (!SWIG_IsOK(res3)) {
+    SWIG_exception_fail(SWIG_ArgError(res3), "in method '" "Layer_SpatialJoin" "', argument " "3"" of type '" "OGRLayerShadow *""'"); 
+  }
+  arg3 = reinterpret_cast< OGRLayerShadow * >(argp3);
+  if (obj3) {
+    {
+      /* %typemap(in) char **options */
+      int bErr = FALSE;
+      arg4 = CSLFromPySequence(obj3, &bErr);
+      if( bErr )
+      {
+        SWIG_fail;
+      }
+    }
+  }
+  if (obj4) {
+    {
+      /* %typemap(in) (GDALProgressFunc callback = NULL) */
+      /* callback_func typemap */
+      
+      /* In some cases 0 is passed instead of None. */
+      /* See https://github.com/OSGeo/gdal/pull/219 */
+      if ( PyLong_Check(obj4) || PyInt_Check(obj4) )
+      {
+        if( PyLong_AsLong(obj4) == 0 )
+        {
+          obj4 = Py_None;
+        }
+      }
+      
+      if (obj4 && obj4 != Py_None ) {
+        void* cbfunction = NULL;
+        CPL_IGNORE_RET_VAL(SWIG_ConvertPtr( obj4,
+            (void**)&cbfunction,
+            SWIGTYPE_p_f_double_p_q_const__char_p_void__int,
+            SWIG_POINTER_EXCEPTION | 0 ));
+        
+        if ( cbfunction == GDALTermProgress ) {
+          arg5 = GDALTermProgress;
+        } else {
+          if (!PyCallable_Check(obj4)) {
+            PyErr_SetString( PyExc_RuntimeError,
+              "Object given is not a Python function" );
+            SWIG_fail;
+          }
+          psProgressInfo->psPyCallback = obj4;
+          arg5 = PyProgressProxy;
+        }
+        
+      }
+      
+    }
+  }
+  if (obj5) {
+    {
+      /* %typemap(in) ( void* callback_data=NULL)  */
+      psProgressInfo->psPyCallbackData = obj5 ;
+    }
+  }
+  {
+    if ( bUseExceptions ) {
+      ClearErrorState();
+    }
+    {
+      SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+      result = (OGRErr)OGRLayerShadow_SpatialJoin(arg1,arg2,arg3,arg4,arg5,arg6);
+      SWIG_PYTHON_THREAD_END_ALLOW;
+    }
+#ifndef SED_HACKS
+    if ( bUseExceptions ) {
+      CPLErr eclass = CPLGetLastErrorType();
+      if ( eclass == CE_Failure || eclass == CE_Fatal ) {
+        SWIG_exception( SWIG_RuntimeError, CPLGetLastErrorMsg() );
+      }
+    }
+#endif
+  }
+  {
+    /* %typemap(out) OGRErr */
+    if ( result != 0 && bUseExceptions) {
+      const char* pszMessage = CPLGetLastErrorMsg();
+      if( pszMessage[0] != '\0' )
+      PyErr_SetString( PyExc_RuntimeError, pszMessage );
+      else
+      PyErr_SetString( PyExc_RuntimeError, OGRErrMessages(result) );
+      SWIG_fail;
+    }
+  }
+  {
+    /* %typemap(freearg) char **options */
+    CSLDestroy( arg4 );
+  }
+  {
+    /* %typemap(freearg) ( void* callback_data=NULL)  */
+    
+    CPLFree(psProgressInfo);
+    
+  }
+  {
+    /* %typemap(ret) OGRErr */
+    if ( ReturnSame(resultobj == Py_None || resultobj == 0) ) {
+      resultobj = PyInt_FromLong( result );
+    }
+  }
+  if ( ReturnSame(bLocalUseExceptionsCode) ) { CPLErr eclass = CPLGetLastErrorType(); if ( eclass == CE_Failure || eclass == CE_Fatal ) { Py_XDECREF(resultobj); SWIG_Error( SWIG_RuntimeError, CPLGetLastErrorMsg() ); return NULL; } }
+  return resultobj;
+fail:
+  {
+    /* %typemap(freearg) char **options */
+    CSLDestroy( arg4 );
+  }
+  {
+    /* %typemap(freearg) ( void* callback_data=NULL)  */
+    
+    CPLFree(psProgressInfo);
+    
+  }
+  return NULL;
+}
+
+
 SWIGINTERN PyObject *_wrap_Layer_GetStyleTable(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *resultobj = 0; int bLocalUseExceptionsCode = bUseExceptions;
   OGRLayerShadow *arg1 = (OGRLayerShadow *) 0 ;
@@ -30484,6 +30652,79 @@ static PyMethodDef SwigMethods[] = {
 		"\n"
 		"OGR 1.10 \n"
 		""},
+	 { (char *)"Layer_SpatialJoin", (PyCFunction) _wrap_Layer_SpatialJoin, METH_VARARGS | METH_KEYWORDS, (char *)"\n"
+		"Layer_SpatialJoin(Layer self, Layer method_layer, Layer result_layer, char ** options=None, GDALProgressFunc callback=0, void * callback_data=None) -> OGRErr\n"
+		"\n"
+		"OGRErr OGR_L_SpatialJoin(OGRLayerH\n"
+		"pLayerInput, OGRLayerH pLayerMethod, OGRLayerH pLayerResult, char\n"
+		"**papszOptions, GDALProgressFunc pfnProgress, void *pProgressArg)\n"
+		"\n"
+		"Spatial join of two layers.\n"
+		"\n"
+		"The result layer contains, for each pair made of a feature of the\n"
+		"input layer and a feature of the method layer whose geometries satisfy\n"
+		"the spatial predicate, a feature with the geometry of the input feature\n"
+		"and the attributes of both features. The schema of the result layer can\n"
+		"be set by the user or, if it is empty, is initialized to contain all\n"
+		"fields in the input and method layers.\n"
+		"\n"
+		"For best performance use the smallest layer as the method layer.\n"
+		"\n"
+		"This method relies on GEOS support. Do not use unless the GEOS support\n"
+		"is compiled in.  The recognized list of options is :\n"
+		"SKIP_FAILURES=YES/NO. Set it to YES to go on, even when a feature\n"
+		"could not be inserted or a GEOS call failed.\n"
+		"\n"
+		"PROMOTE_TO_MULTI=YES/NO. Set it to YES to convert Polygons into\n"
+		"MultiPolygons, or LineStrings to MultiLineStrings.\n"
+		"\n"
+		"INPUT_PREFIX=string. Set a prefix for the field names that will be\n"
+		"created from the fields of the input layer.\n"
+		"\n"
+		"METHOD_PREFIX=string. Set a prefix for the field names that will be\n"
+		"created from the fields of the method layer.\n"
+		"\n"
+		"USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared\n"
+		"geometries for the features of the method layer.\n"
+		"\n"
+		"PREDICATE=INTERSECTS/WITHIN. Spatial relationship that features of the\n"
+		"input layer must have with features of the method layer. Defaults to\n"
+		"INTERSECTS.\n"
+		"\n"
+		"KEEP_UNMATCHED=YES/NO. Set to YES to also add the features of the input\n"
+		"layer that match no feature of the method layer. Defaults to NO.\n"
+		"\n"
+		"NUM_THREADS=number/ALL_CPUS. Number of threads used to evaluate the\n"
+		"predicates. Defaults to the GDAL_NUM_THREADS configuration option, or\n"
+		"ALL_CPUS.\n"
+		"\n"
+		"This function is the same as the C++ method OGRLayer::SpatialJoin().\n"
+		"\n"
+		"Parameters:\n"
+		"-----------\n"
+		"\n"
+		"pLayerInput:  the input layer. Should not be NULL.\n"
+		"\n"
+		"pLayerMethod:  the method layer. Should not be NULL.\n"
+		"\n"
+		"pLayerResult:  the layer where the features resulting from the\n"
+		"operation are inserted. Should not be NULL. See above the note about\n"
+		"the schema.\n"
+		"\n"
+		"papszOptions:  NULL terminated list of options (may be NULL).\n"
+		"\n"
+		"pfnProgress:  a GDALProgressFunc() compatible callback function for\n"
+		"reporting progress or NULL.\n"
+		"\n"
+		"pProgressArg:  argument to be passed to pfnProgress. May be NULL.\n"
+		"\n"
+		"an error code if there was an error or the execution was interrupted,\n"
+		"OGRERR_NONE otherwise.\n"
+		"\n"
+		"The first geometry field is always used.\n"
+		"\n"
+		"GDAL 3.1 \n"
+		""},
 	 { (char *)"Layer_GetStyleTable", _wrap_Layer_GetStyleTable, METH_VARARGS, (char *)"\n"
 		"Layer_GetStyleTable(Layer self) -> StyleTable\n"
 		"\n"
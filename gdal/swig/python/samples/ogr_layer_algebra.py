@@ -41,7 +41,7 @@ from osgeo import osr
 
 def Usage():
     print("""
-Usage: ogr_layer_algebra.py Union|Intersection|SymDifference|Identity|Update|Clip|Erase
+Usage: ogr_layer_algebra.py Union|Intersection|SymDifference|Identity|Update|Clip|Erase|SpatialJoin
                             -input_ds name [-input_lyr name]
                             -method_ds [-method_lyr name]
                             -output_ds name [-output_lyr name] [-overwrite]
@@ -277,6 +277,9 @@ def main(argv=None):
         elif EQUAL(arg, "Erase"):
             op_str = "Erase"
 
+        elif EQUAL(arg, "SpatialJoin"):
+            op_str = "SpatialJoin"
+
         elif arg == "-overwrite":
             overwrite = True
 